@@ -130,8 +130,8 @@ mmcli_bearer_shutdown (void)
     context_free ();
 }
 
-static void
-print_bearer_info (MMBearer *bearer)
+void
+mmcli_bearer_output_info (MMBearer *bearer)
 {
     g_autoptr(MMBearerIpConfig)    ipv4_config = NULL;
     g_autoptr(MMBearerIpConfig)    ipv6_config = NULL;
@@ -317,7 +317,12 @@ print_bearer_info (MMBearer *bearer)
         mmcli_output_string_take (MMC_F_BEARER_STATS_TOTAL_BYTES_RX,  total_bytes_rx);
         mmcli_output_string_take (MMC_F_BEARER_STATS_TOTAL_BYTES_TX,  total_bytes_tx);
     }
+}
 
+static void
+print_bearer_info (MMBearer *bearer)
+{
+    mmcli_bearer_output_info (bearer);
     mmcli_output_dump ();
 }
 
@@ -108,4 +108,14 @@ const gchar  *mmcli_get_common_call_string (void);
 gchar *mmcli_prefix_newlines (const gchar *prefix,
                               const gchar *str);
 
+/* Object info builders, adding the fields to the output without dumping it,
+ * so that several of them can be merged in a single dump */
+void mmcli_modem_output_info            (MMModem         *modem,
+                                         MMModem3gpp     *modem_3gpp,
+                                         MMModemCdma     *modem_cdma);
+void mmcli_modem_signal_output_info     (MMModemSignal   *modem_signal);
+void mmcli_modem_location_output_status (MMModemLocation *modem_location);
+void mmcli_bearer_output_info           (MMBearer        *bearer);
+void mmcli_sim_output_info              (MMSim           *sim);
+
 #endif /* _MMCLI_COMMON_H_ */
@@ -47,6 +47,11 @@ typedef struct {
 #if defined WITH_UDEV
     GUdevClient *udev;
 #endif
+    /* Modem path -> WatchedModem */
+    GHashTable *watched;
+    /* Objects with pending changes to report */
+    GHashTable *pending;
+    guint pending_id;
 } Context;
 static Context *ctx;
 
@@ -54,7 +59,11 @@ static Context *ctx;
 static gboolean get_daemon_version_flag;
 static gboolean list_modems_flag;
 static gboolean monitor_modems_flag;
+static gboolean dump_all_flag;
+static gboolean watch_flag;
 static gboolean scan_modems_flag;
+static gboolean dump_trace_flag;
+static gboolean clear_capability_cache_flag;
 static gchar *set_logging_str;
 static gchar *inhibit_device_str;
 static gchar *report_kernel_event_str;
@@ -72,6 +81,14 @@ static GOptionEntry entries[] = {
       "Set logging level in the ModemManager daemon",
       "[ERR,WARN,INFO,DEBUG]",
     },
+    { "dump-trace", 0, 0, G_OPTION_ARG_NONE, &dump_trace_flag,
+      "Dump the timeline of modem probing, initialization and connection steps",
+      NULL
+    },
+    { "clear-capability-cache", 0, 0, G_OPTION_ARG_NONE, &clear_capability_cache_flag,
+      "Remove the modem capabilities stored by the daemon",
+      NULL
+    },
     { "list-modems", 'L', 0, G_OPTION_ARG_NONE, &list_modems_flag,
       "List available modems",
       NULL
@@ -80,6 +97,14 @@ static GOptionEntry entries[] = {
       "List available modems and monitor additions and removals",
       NULL
     },
+    { "dump-all", 0, 0, G_OPTION_ARG_NONE, &dump_all_flag,
+      "Show the info of all modems, including their bearers and SIMs",
+      NULL
+    },
+    { "watch", 0, 0, G_OPTION_ARG_NONE, &watch_flag,
+      "Show the info of all modems, including their bearers and SIMs, and again whenever they change",
+      NULL
+    },
     { "scan-modems", 'S', 0, G_OPTION_ARG_NONE, &scan_modems_flag,
       "Request to re-scan looking for modems",
       NULL
@@ -129,7 +154,11 @@ mmcli_manager_options_enabled (void)
     n_actions = (get_daemon_version_flag +
                  list_modems_flag +
                  monitor_modems_flag +
+                 dump_all_flag +
+                 watch_flag +
                  scan_modems_flag +
+                 dump_trace_flag +
+                 clear_capability_cache_flag +
                  !!set_logging_str +
                  !!inhibit_device_str +
                  !!report_kernel_event_str);
@@ -151,7 +180,7 @@ mmcli_manager_options_enabled (void)
             exit (EXIT_FAILURE);
         }
         mmcli_force_async_operation ();
-    } else if (inhibit_device_str)
+    } else if (watch_flag || inhibit_device_str)
         mmcli_force_async_operation ();
 
 #if defined WITH_UDEV
@@ -174,6 +203,12 @@ context_free (void)
         g_object_unref (ctx->udev);
 #endif
 
+    if (ctx->pending_id)
+        g_source_remove (ctx->pending_id);
+    if (ctx->watched)
+        g_hash_table_unref (ctx->watched);
+    if (ctx->pending)
+        g_hash_table_unref (ctx->pending);
     if (ctx->manager)
         g_object_unref (ctx->manager);
     if (ctx->cancellable)
@@ -292,6 +327,62 @@ set_logging_ready (MMManager    *manager,
     mmcli_async_operation_done ();
 }
 
+static void
+dump_trace_process_reply (gchar        *trace,
+                          const GError *error)
+{
+    if (!trace) {
+        g_printerr ("error: couldn't dump trace: '%s'\n",
+                    error ? error->message : "unknown error");
+        exit (EXIT_FAILURE);
+    }
+
+    /* Printed as is, to be loaded in a trace viewer */
+    g_print ("%s", trace);
+    g_free (trace);
+}
+
+static void
+dump_trace_ready (MMManager    *manager,
+                  GAsyncResult *result,
+                  gpointer      nothing)
+{
+    gchar *trace;
+    GError *error = NULL;
+
+    trace = mm_manager_dump_trace_finish (manager, result, &error);
+    dump_trace_process_reply (trace, error);
+
+    mmcli_async_operation_done ();
+}
+
+static void
+clear_capability_cache_process_reply (gboolean      result,
+                                      const GError *error)
+{
+    if (!result) {
+        g_printerr ("error: couldn't clear capability cache: '%s'\n",
+                    error ? error->message : "unknown error");
+        exit (EXIT_FAILURE);
+    }
+
+    g_print ("successfully cleared capability cache\n");
+}
+
+static void
+clear_capability_cache_ready (MMManager    *manager,
+                              GAsyncResult *result,
+                              gpointer      nothing)
+{
+    gboolean operation_result;
+    GError *error = NULL;
+
+    operation_result = mm_manager_clear_capability_cache_finish (manager, result, &error);
+    clear_capability_cache_process_reply (operation_result, error);
+
+    mmcli_async_operation_done ();
+}
+
 static void
 scan_devices_process_reply (gboolean      result,
                             const GError *error)
@@ -384,6 +475,373 @@ cancelled (GCancellable *cancellable)
     mmcli_async_operation_done ();
 }
 
+/******************************************************************************/
+/* Dump all modems, and watch them */
+
+typedef struct {
+    MMObject   *object;
+    /* Object path -> MMBearer or MMSim */
+    GHashTable *secondary;
+} WatchedModem;
+
+static void schedule_dump (gpointer object);
+
+static void
+secondary_properties_changed (GDBusProxy *proxy)
+{
+    schedule_dump (proxy);
+}
+
+static void
+secondary_free (GDBusProxy *proxy)
+{
+    g_signal_handlers_disconnect_by_func (proxy, secondary_properties_changed, NULL);
+    if (ctx->pending)
+        g_hash_table_remove (ctx->pending, proxy);
+    g_object_unref (proxy);
+}
+
+static GHashTable *
+secondary_table_new (void)
+{
+    return g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) secondary_free);
+}
+
+static WatchedModem *
+watched_modem_new (MMObject *obj)
+{
+    WatchedModem *watched;
+
+    watched = g_slice_new0 (WatchedModem);
+    watched->object = g_object_ref (obj);
+    watched->secondary = secondary_table_new ();
+    return watched;
+}
+
+static void
+watched_modem_free (WatchedModem *watched)
+{
+    g_hash_table_unref (watched->secondary);
+    g_object_unref (watched->object);
+    g_slice_free (WatchedModem, watched);
+}
+
+static void
+dump_modem (MMObject *obj)
+{
+    MMModemSignal   *modem_signal;
+    MMModemLocation *modem_location;
+
+    mmcli_modem_output_info (mm_object_peek_modem (obj),
+                             mm_object_peek_modem_3gpp (obj),
+                             mm_object_peek_modem_cdma (obj));
+
+    modem_signal = mm_object_peek_modem_signal (obj);
+    if (modem_signal)
+        mmcli_modem_signal_output_info (modem_signal);
+
+    modem_location = mm_object_peek_modem_location (obj);
+    if (modem_location)
+        mmcli_modem_location_output_status (modem_location);
+
+    mmcli_output_dump ();
+}
+
+static void
+dump_secondary (GDBusProxy *proxy)
+{
+    if (MM_IS_BEARER (proxy))
+        mmcli_bearer_output_info (MM_BEARER (proxy));
+    else if (MM_IS_SIM (proxy))
+        mmcli_sim_output_info (MM_SIM (proxy));
+    else
+        g_assert_not_reached ();
+
+    mmcli_output_dump ();
+}
+
+static void
+dump_removed (const gchar *path)
+{
+    mmcli_output_listitem (MMC_F_REMOVED_LIST_DBUS_PATH, REMOVED_ACTION_PREFIX, path, "");
+    mmcli_output_list_dump (MMC_F_REMOVED_LIST_DBUS_PATH);
+}
+
+static gboolean
+secondary_up_to_date (WatchedModem *watched)
+{
+    MMModem             *modem;
+    const gchar * const *bearer_paths;
+    const gchar         *sim_path;
+    guint                n_expected = 0;
+    guint                i;
+
+    modem = mm_object_peek_modem (watched->object);
+
+    bearer_paths = (const gchar * const *) mm_modem_get_bearer_paths (modem);
+    for (i = 0; bearer_paths && bearer_paths[i]; i++, n_expected++) {
+        if (!g_hash_table_contains (watched->secondary, bearer_paths[i]))
+            return FALSE;
+    }
+
+    sim_path = mm_modem_get_sim_path (modem);
+    if (sim_path && !g_str_equal (sim_path, "/")) {
+        if (!g_hash_table_contains (watched->secondary, sim_path))
+            return FALSE;
+        n_expected++;
+    }
+
+    return (g_hash_table_size (watched->secondary) == n_expected);
+}
+
+static void
+secondary_table_add (GHashTable *table,
+                     GDBusProxy *proxy)
+{
+    g_hash_table_insert (table, g_strdup (g_dbus_proxy_get_object_path (proxy)), proxy);
+}
+
+static GHashTable *
+secondary_table_load (MMModem *modem)
+{
+    GHashTable *table;
+    GList      *bearers;
+    GList      *l;
+    GError     *error = NULL;
+
+    table = secondary_table_new ();
+
+    bearers = mm_modem_list_bearers_sync (modem, NULL, &error);
+    if (error) {
+        g_printerr ("warning: couldn't list bearers in modem '%s': '%s'\n",
+                    mm_modem_get_path (modem), error->message);
+        g_clear_error (&error);
+    }
+    for (l = bearers; l; l = g_list_next (l))
+        secondary_table_add (table, G_DBUS_PROXY (l->data));
+    g_list_free (bearers);
+
+    if (g_strcmp0 (mm_modem_get_sim_path (modem), "/") != 0) {
+        MMSim *sim;
+
+        sim = mm_modem_get_sim_sync (modem, NULL, &error);
+        if (sim)
+            secondary_table_add (table, G_DBUS_PROXY (sim));
+        else if (error) {
+            g_printerr ("warning: couldn't get SIM in modem '%s': '%s'\n",
+                        mm_modem_get_path (modem), error->message);
+            g_clear_error (&error);
+        }
+    }
+
+    return table;
+}
+
+static gint
+path_cmp (const gchar **a,
+          const gchar **b)
+{
+    return g_strcmp0 (*a, *b);
+}
+
+static gint
+object_path_cmp (MMObject *a,
+                 MMObject *b)
+{
+    return g_strcmp0 (mm_object_get_path (a), mm_object_get_path (b));
+}
+
+/* Reloads the bearers and SIM of the modem if they changed, and reports the
+ * added and removed ones */
+static void
+watched_modem_sync_secondary (WatchedModem *watched)
+{
+    g_autoptr(GHashTable)  previous = NULL;
+    g_autofree gpointer   *paths = NULL;
+    gpointer               previous_path;
+    guint                  n_paths;
+    guint                  i;
+
+    if (secondary_up_to_date (watched))
+        return;
+
+    previous = watched->secondary;
+    watched->secondary = secondary_table_load (mm_object_peek_modem (watched->object));
+
+    paths = g_hash_table_get_keys_as_array (previous, &n_paths);
+    qsort (paths, n_paths, sizeof (gpointer), (GCompareFunc) path_cmp);
+    for (i = 0; i < n_paths; i++) {
+        if (!g_hash_table_contains (watched->secondary, paths[i]))
+            dump_removed (paths[i]);
+    }
+    g_clear_pointer (&paths, g_free);
+
+    paths = g_hash_table_get_keys_as_array (watched->secondary, &n_paths);
+    qsort (paths, n_paths, sizeof (gpointer), (GCompareFunc) path_cmp);
+    for (i = 0; i < n_paths; i++) {
+        GDBusProxy *proxy;
+
+        /* Keep on using the proxies already known */
+        if (g_hash_table_lookup_extended (previous, paths[i], &previous_path, (gpointer *) &proxy)) {
+            g_hash_table_steal (previous, paths[i]);
+            g_hash_table_insert (watched->secondary, previous_path, proxy);
+            continue;
+        }
+
+        proxy = g_hash_table_lookup (watched->secondary, paths[i]);
+        dump_secondary (proxy);
+        if (watch_flag)
+            g_signal_connect (proxy,
+                              "g-properties-changed",
+                              G_CALLBACK (secondary_properties_changed),
+                              NULL);
+    }
+}
+
+static void
+dump_all (void)
+{
+    GList *objects;
+    GList *l;
+
+    objects = g_dbus_object_manager_get_objects (G_DBUS_OBJECT_MANAGER (ctx->manager));
+    objects = g_list_sort (objects, (GCompareFunc) object_path_cmp);
+    for (l = objects; l; l = g_list_next (l)) {
+        MMObject     *obj;
+        WatchedModem *watched;
+
+        obj = MM_OBJECT (l->data);
+        if (!mm_object_peek_modem (obj))
+            continue;
+
+        dump_modem (obj);
+        watched = watched_modem_new (obj);
+        watched_modem_sync_secondary (watched);
+        if (watch_flag)
+            g_hash_table_insert (ctx->watched, g_strdup (mm_object_get_path (obj)), watched);
+        else
+            watched_modem_free (watched);
+    }
+    g_list_free_full (objects, g_object_unref);
+}
+
+static void
+unwatch_modem (const gchar *path)
+{
+    WatchedModem *watched;
+
+    watched = g_hash_table_lookup (ctx->watched, path);
+    if (!watched)
+        return;
+
+    g_hash_table_remove (ctx->pending, watched->object);
+    dump_removed (path);
+    g_hash_table_remove (ctx->watched, path);
+}
+
+static gboolean
+pending_dump_cb (void)
+{
+    g_autoptr(GHashTable) pending = NULL;
+    GHashTableIter        iter;
+    gpointer              object;
+
+    ctx->pending_id = 0;
+    pending = g_steal_pointer (&ctx->pending);
+    ctx->pending = g_hash_table_new_full (g_direct_hash, g_direct_equal, g_object_unref, NULL);
+
+    /* Modems first, as reloading their bearers and SIM also reports the new ones */
+    g_hash_table_iter_init (&iter, pending);
+    while (g_hash_table_iter_next (&iter, &object, NULL)) {
+        WatchedModem *watched;
+        const gchar  *path;
+
+        if (!MM_IS_OBJECT (object))
+            continue;
+
+        path = mm_object_get_path (MM_OBJECT (object));
+        if (!mm_object_peek_modem (MM_OBJECT (object))) {
+            unwatch_modem (path);
+            continue;
+        }
+
+        watched = g_hash_table_lookup (ctx->watched, path);
+        if (!watched) {
+            watched = watched_modem_new (MM_OBJECT (object));
+            g_hash_table_insert (ctx->watched, g_strdup (path), watched);
+        }
+        dump_modem (watched->object);
+        watched_modem_sync_secondary (watched);
+    }
+
+    g_hash_table_iter_init (&iter, pending);
+    while (g_hash_table_iter_next (&iter, &object, NULL)) {
+        GHashTableIter  watched_iter;
+        WatchedModem   *watched;
+
+        if (MM_IS_OBJECT (object))
+            continue;
+
+        /* Only if still around */
+        g_hash_table_iter_init (&watched_iter, ctx->watched);
+        while (g_hash_table_iter_next (&watched_iter, NULL, (gpointer *) &watched)) {
+            if (g_hash_table_lookup (watched->secondary, g_dbus_proxy_get_object_path (object)) == object) {
+                dump_secondary (G_DBUS_PROXY (object));
+                break;
+            }
+        }
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+/* Changes are coalesced, so that each object is reported once per main loop
+ * iteration regardless of how many properties changed */
+static void
+schedule_dump (gpointer object)
+{
+    if (!g_hash_table_contains (ctx->pending, object))
+        g_hash_table_add (ctx->pending, g_object_ref (object));
+    if (!ctx->pending_id)
+        ctx->pending_id = g_idle_add ((GSourceFunc) pending_dump_cb, NULL);
+}
+
+static void
+watch_object_changed (GDBusObjectManager *manager,
+                      GDBusObject        *object)
+{
+    schedule_dump (object);
+}
+
+static void
+watch_object_removed (GDBusObjectManager *manager,
+                      GDBusObject        *object)
+{
+    unwatch_modem (g_dbus_object_get_object_path (object));
+}
+
+static void
+watch_properties_changed (GDBusObjectManagerClient *manager,
+                          GDBusObjectProxy         *object_proxy)
+{
+    schedule_dump (object_proxy);
+}
+
+static void
+watch_all (void)
+{
+    ctx->watched = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) watched_modem_free);
+    ctx->pending = g_hash_table_new_full (g_direct_hash, g_direct_equal, g_object_unref, NULL);
+
+    g_signal_connect (ctx->manager, "object-added",      G_CALLBACK (watch_object_changed), NULL);
+    g_signal_connect (ctx->manager, "interface-added",   G_CALLBACK (watch_object_changed), NULL);
+    g_signal_connect (ctx->manager, "interface-removed", G_CALLBACK (watch_object_changed), NULL);
+    g_signal_connect (ctx->manager, "object-removed",    G_CALLBACK (watch_object_removed), NULL);
+    g_signal_connect (ctx->manager, "interface-proxy-properties-changed", G_CALLBACK (watch_properties_changed), NULL);
+
+    dump_all ();
+}
+
 #if defined WITH_UDEV
 
 static void
@@ -424,6 +882,24 @@ get_manager_ready (GObject      *source,
         return;
     }
 
+    /* Request to dump trace? */
+    if (dump_trace_flag) {
+        mm_manager_dump_trace (ctx->manager,
+                               ctx->cancellable,
+                               (GAsyncReadyCallback)dump_trace_ready,
+                               NULL);
+        return;
+    }
+
+    /* Request to clear capability cache? */
+    if (clear_capability_cache_flag) {
+        mm_manager_clear_capability_cache (ctx->manager,
+                                           ctx->cancellable,
+                                           (GAsyncReadyCallback)clear_capability_cache_ready,
+                                           NULL);
+        return;
+    }
+
     /* Request to scan modems? */
     if (scan_modems_flag) {
         mm_manager_scan_devices (ctx->manager,
@@ -510,6 +986,25 @@ get_manager_ready (GObject      *source,
         return;
     }
 
+    /* Request to dump all modems? */
+    if (dump_all_flag) {
+        dump_all ();
+        mmcli_async_operation_done ();
+        return;
+    }
+
+    /* Request to watch all modems? */
+    if (watch_flag) {
+        watch_all ();
+
+        /* If we get cancelled, operation done */
+        g_cancellable_connect (ctx->cancellable,
+                               G_CALLBACK (cancelled),
+                               NULL,
+                               NULL);
+        return;
+    }
+
     /* Request to inhibit device? */
     if (inhibit_device_str) {
         mm_manager_inhibit_device (ctx->manager,
@@ -549,6 +1044,11 @@ mmcli_manager_run_synchronous (GDBusConnection *connection)
         exit (EXIT_FAILURE);
     }
 
+    if (watch_flag) {
+        g_printerr ("error: watching modems cannot be done synchronously\n");
+        exit (EXIT_FAILURE);
+    }
+
 #if defined WITH_UDEV
     if (report_kernel_event_auto_scan) {
         g_printerr ("error: monitoring udev events cannot be done synchronously\n");
@@ -581,6 +1081,24 @@ mmcli_manager_run_synchronous (GDBusConnection *connection)
         return;
     }
 
+    /* Request to dump trace? */
+    if (dump_trace_flag) {
+        gchar *trace;
+
+        trace = mm_manager_dump_trace_sync (ctx->manager, NULL, &error);
+        dump_trace_process_reply (trace, error);
+        return;
+    }
+
+    /* Request to clear capability cache? */
+    if (clear_capability_cache_flag) {
+        gboolean result;
+
+        result = mm_manager_clear_capability_cache_sync (ctx->manager, NULL, &error);
+        clear_capability_cache_process_reply (result, error);
+        return;
+    }
+
     /* Request to scan modems? */
     if (scan_modems_flag) {
         gboolean result;
@@ -612,5 +1130,11 @@ mmcli_manager_run_synchronous (GDBusConnection *connection)
         return;
     }
 
+    /* Request to dump all modems? */
+    if (dump_all_flag) {
+        dump_all ();
+        return;
+    }
+
     g_warn_if_reached ();
 }
@@ -273,8 +273,8 @@ mmcli_modem_location_shutdown (void)
     context_free ();
 }
 
-static void
-print_location_status (void)
+void
+mmcli_modem_location_output_status (MMModemLocation *modem_location)
 {
     gchar        *capabilities;
     gchar        *enabled;
@@ -284,37 +284,43 @@ print_location_status (void)
     const gchar **gps_assistance_servers = NULL;
 
     capabilities = (mm_modem_location_source_build_string_from_mask (
-                        mm_modem_location_get_capabilities (ctx->modem_location)));
+                        mm_modem_location_get_capabilities (modem_location)));
     enabled = (mm_modem_location_source_build_string_from_mask (
-                   mm_modem_location_get_enabled (ctx->modem_location)));
+                   mm_modem_location_get_enabled (modem_location)));
 
     /* If GPS supported, show GPS refresh rate and supported assistance data */
-    if (mm_modem_location_get_capabilities (ctx->modem_location) & (MM_MODEM_LOCATION_SOURCE_GPS_RAW | MM_MODEM_LOCATION_SOURCE_GPS_NMEA)) {
+    if (mm_modem_location_get_capabilities (modem_location) & (MM_MODEM_LOCATION_SOURCE_GPS_RAW | MM_MODEM_LOCATION_SOURCE_GPS_NMEA)) {
         guint                             rate;
         MMModemLocationAssistanceDataType mask;
 
-        rate = mm_modem_location_get_gps_refresh_rate (ctx->modem_location);
+        rate = mm_modem_location_get_gps_refresh_rate (modem_location);
         gps_refresh_rate = g_strdup_printf ("%u", rate);
 
         /* If A-GPS supported, show SUPL server setup */
-        if (mm_modem_location_get_capabilities (ctx->modem_location) & (MM_MODEM_LOCATION_SOURCE_AGPS_MSA | MM_MODEM_LOCATION_SOURCE_AGPS_MSB))
-            gps_supl_server = mm_modem_location_get_supl_server (ctx->modem_location);
+        if (mm_modem_location_get_capabilities (modem_location) & (MM_MODEM_LOCATION_SOURCE_AGPS_MSA | MM_MODEM_LOCATION_SOURCE_AGPS_MSB))
+            gps_supl_server = mm_modem_location_get_supl_server (modem_location);
 
-        mask = mm_modem_location_get_supported_assistance_data (ctx->modem_location);
+        mask = mm_modem_location_get_supported_assistance_data (modem_location);
         gps_assistance = mm_modem_location_assistance_data_type_build_string_from_mask (mask);
 
         /* If any assistance data supported, show server list */
         if (mask != MM_MODEM_LOCATION_ASSISTANCE_DATA_TYPE_NONE)
-            gps_assistance_servers = mm_modem_location_get_assistance_data_servers (ctx->modem_location);
+            gps_assistance_servers = mm_modem_location_get_assistance_data_servers (modem_location);
     }
 
     mmcli_output_string_list_take  (MMC_F_LOCATION_CAPABILITIES,           capabilities);
     mmcli_output_string_list_take  (MMC_F_LOCATION_ENABLED,                enabled);
-    mmcli_output_string            (MMC_F_LOCATION_SIGNALS,                mm_modem_location_signals_location (ctx->modem_location) ? "yes" : "no");
+    mmcli_output_string            (MMC_F_LOCATION_SIGNALS,                mm_modem_location_signals_location (modem_location) ? "yes" : "no");
     mmcli_output_string_take_typed (MMC_F_LOCATION_GPS_REFRESH_RATE,       gps_refresh_rate, "seconds");
     mmcli_output_string            (MMC_F_LOCATION_GPS_SUPL_SERVER,        gps_supl_server);
     mmcli_output_string_list_take  (MMC_F_LOCATION_GPS_ASSISTANCE,         gps_assistance);
     mmcli_output_string_array      (MMC_F_LOCATION_GPS_ASSISTANCE_SERVERS, gps_assistance_servers, TRUE);
+}
+
+static void
+print_location_status (void)
+{
+    mmcli_modem_location_output_status (ctx->modem_location);
     mmcli_output_dump ();
 }
 
@@ -0,0 +1,309 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * mmcli -- Control modem status & access information from the command line
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <locale.h>
+#include <string.h>
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#define _LIBMM_INSIDE_MMCLI
+#include <libmm-glib.h>
+
+#include "mmcli.h"
+#include "mmcli-common.h"
+#include "mmcli-output.h"
+
+/* Context */
+typedef struct {
+    MMManager *manager;
+    GCancellable *cancellable;
+    MMObject *object;
+    MmGdbusModemMetrics *modem_metrics;
+} Context;
+static Context *ctx;
+
+/* Options */
+static gboolean get_flag;
+
+static GOptionEntry entries[] = {
+    { "metrics", 0, 0, G_OPTION_ARG_NONE, &get_flag,
+      "Get the metrics of the requests sent through each port",
+      NULL
+    },
+    { NULL }
+};
+
+GOptionGroup *
+mmcli_modem_metrics_get_option_group (void)
+{
+    GOptionGroup *group;
+
+    group = g_option_group_new ("metrics",
+                                "Metrics options:",
+                                "Show Metrics options",
+                                NULL,
+                                NULL);
+    g_option_group_add_entries (group, entries);
+
+    return group;
+}
+
+gboolean
+mmcli_modem_metrics_options_enabled (void)
+{
+    static guint n_actions = 0;
+    static gboolean checked = FALSE;
+
+    if (checked)
+        return !!n_actions;
+
+    n_actions = get_flag;
+
+    if (get_flag)
+        mmcli_force_sync_operation ();
+
+    checked = TRUE;
+    return !!n_actions;
+}
+
+static void
+context_free (void)
+{
+    if (!ctx)
+        return;
+
+    if (ctx->cancellable)
+        g_object_unref (ctx->cancellable);
+    if (ctx->modem_metrics)
+        g_object_unref (ctx->modem_metrics);
+    if (ctx->object)
+        g_object_unref (ctx->object);
+    if (ctx->manager)
+        g_object_unref (ctx->manager);
+    g_free (ctx);
+}
+
+static void
+ensure_modem_metrics (void)
+{
+    if (!ctx->modem_metrics) {
+        g_printerr ("error: modem has no metrics capabilities\n");
+        exit (EXIT_FAILURE);
+    }
+
+    /* Success */
+}
+
+void
+mmcli_modem_metrics_shutdown (void)
+{
+    context_free ();
+}
+
+static gchar *
+build_histogram_string (GVariant *histogram)
+{
+    const guint64 *buckets;
+    gsize          n_buckets;
+    gsize          i;
+    GString       *str;
+
+    str = g_string_new (NULL);
+    buckets = g_variant_get_fixed_array (histogram, &n_buckets, sizeof (guint64));
+    for (i = 0; i < n_buckets; i++) {
+        if (!buckets[i])
+            continue;
+        if (str->len)
+            g_string_append (str, ", ");
+        if (i == n_buckets - 1)
+            g_string_append_printf (str, "slower: %" G_GUINT64_FORMAT, buckets[i]);
+        else
+            g_string_append_printf (str, "<%ums: %" G_GUINT64_FORMAT, 1u << (i + 1), buckets[i]);
+    }
+    return g_string_free (str, FALSE);
+}
+
+static void
+print_metrics_info (GVariant *metrics)
+{
+    GPtrArray    *ports;
+    GPtrArray    *commands;
+    GVariantIter  iter;
+    GVariant     *port_dict;
+
+    ports = g_ptr_array_new ();
+    commands = g_ptr_array_new ();
+
+    g_variant_iter_init (&iter, metrics);
+    while ((port_dict = g_variant_iter_next_value (&iter))) {
+        const gchar  *port = NULL;
+        guint         in_flight = 0;
+        guint         max_in_flight = 0;
+        guint64       requests = 0;
+        guint64       errors = 0;
+        guint64       timeouts = 0;
+        GVariant     *port_commands = NULL;
+
+        g_variant_lookup (port_dict, "port",          "&s", &port);
+        g_variant_lookup (port_dict, "in-flight",     "u",  &in_flight);
+        g_variant_lookup (port_dict, "max-in-flight", "u",  &max_in_flight);
+        g_variant_lookup (port_dict, "requests",      "t",  &requests);
+        g_variant_lookup (port_dict, "errors",        "t",  &errors);
+        g_variant_lookup (port_dict, "timeouts",      "t",  &timeouts);
+
+        g_ptr_array_add (ports, g_strdup_printf ("%s (requests: %" G_GUINT64_FORMAT ", errors: %" G_GUINT64_FORMAT
+                                                 ", timeouts: %" G_GUINT64_FORMAT ", in flight: %u, max in flight: %u)",
+                                                 port ? port : "unknown", requests, errors, timeouts, in_flight, max_in_flight));
+
+        port_commands = g_variant_lookup_value (port_dict, "commands", G_VARIANT_TYPE ("aa{sv}"));
+        if (port_commands) {
+            GVariantIter  commands_iter;
+            GVariant     *command_dict;
+
+            g_variant_iter_init (&commands_iter, port_commands);
+            while ((command_dict = g_variant_iter_next_value (&commands_iter))) {
+                const gchar *command = NULL;
+                guint64      command_requests = 0;
+                guint64      command_errors = 0;
+                guint64      command_timeouts = 0;
+                guint64      latency_total = 0;
+                guint        latency_max = 0;
+                GVariant    *histogram;
+                gchar       *histogram_str = NULL;
+
+                g_variant_lookup (command_dict, "command",       "&s", &command);
+                g_variant_lookup (command_dict, "requests",      "t",  &command_requests);
+                g_variant_lookup (command_dict, "errors",        "t",  &command_errors);
+                g_variant_lookup (command_dict, "timeouts",      "t",  &command_timeouts);
+                g_variant_lookup (command_dict, "latency-total", "t",  &latency_total);
+                g_variant_lookup (command_dict, "latency-max",   "u",  &latency_max);
+                histogram = g_variant_lookup_value (command_dict, "latency-histogram", G_VARIANT_TYPE ("at"));
+                if (histogram) {
+                    histogram_str = build_histogram_string (histogram);
+                    g_variant_unref (histogram);
+                }
+
+                g_ptr_array_add (commands, g_strdup_printf ("%s: %s (requests: %" G_GUINT64_FORMAT ", errors: %" G_GUINT64_FORMAT
+                                                            ", timeouts: %" G_GUINT64_FORMAT ", avg: %" G_GUINT64_FORMAT "ms, max: %ums%s%s%s)",
+                                                            port ? port : "unknown",
+                                                            command ? command : "unknown",
+                                                            command_requests, command_errors, command_timeouts,
+                                                            command_requests ? latency_total / command_requests : 0,
+                                                            latency_max,
+                                                            histogram_str && histogram_str[0] ? ", latencies: [" : "",
+                                                            histogram_str && histogram_str[0] ? histogram_str : "",
+                                                            histogram_str && histogram_str[0] ? "]" : ""));
+                g_free (histogram_str);
+                g_variant_unref (command_dict);
+            }
+            g_variant_unref (port_commands);
+        }
+
+        g_variant_unref (port_dict);
+    }
+
+    g_ptr_array_add (ports, NULL);
+    g_ptr_array_add (commands, NULL);
+
+    mmcli_output_string_array_take (MMC_F_METRICS_PORTS,    (gchar **) g_ptr_array_free (ports, FALSE),    TRUE);
+    mmcli_output_string_array_take (MMC_F_METRICS_COMMANDS, (gchar **) g_ptr_array_free (commands, FALSE), TRUE);
+    mmcli_output_dump ();
+}
+
+static void
+get_modem_ready (GObject      *source,
+                 GAsyncResult *result)
+{
+    ctx->object = mmcli_get_modem_finish (result, &ctx->manager);
+    ctx->modem_metrics = mm_gdbus_object_get_modem_metrics (MM_GDBUS_OBJECT (ctx->object));
+
+    /* Setup operation timeout */
+    if (ctx->modem_metrics)
+        mmcli_force_operation_timeout (G_DBUS_PROXY (ctx->modem_metrics));
+
+    ensure_modem_metrics ();
+
+    if (get_flag)
+        g_assert_not_reached ();
+
+    g_warn_if_reached ();
+}
+
+void
+mmcli_modem_metrics_run_asynchronous (GDBusConnection *connection,
+                                      GCancellable    *cancellable)
+{
+    /* Initialize context */
+    ctx = g_new0 (Context, 1);
+    if (cancellable)
+        ctx->cancellable = g_object_ref (cancellable);
+
+    /* Get proper modem */
+    mmcli_get_modem (connection,
+                     mmcli_get_common_modem_string (),
+                     cancellable,
+                     (GAsyncReadyCallback)get_modem_ready,
+                     NULL);
+}
+
+void
+mmcli_modem_metrics_run_synchronous (GDBusConnection *connection)
+{
+    GError *error = NULL;
+
+    /* Initialize context */
+    ctx = g_new0 (Context, 1);
+    ctx->object = mmcli_get_modem_sync (connection,
+                                        mmcli_get_common_modem_string (),
+                                        &ctx->manager);
+    ctx->modem_metrics = mm_gdbus_object_get_modem_metrics (MM_GDBUS_OBJECT (ctx->object));
+
+    /* Setup operation timeout */
+    if (ctx->modem_metrics)
+        mmcli_force_operation_timeout (G_DBUS_PROXY (ctx->modem_metrics));
+
+    ensure_modem_metrics ();
+
+    /* Request to get metrics? */
+    if (get_flag) {
+        GVariant *metrics = NULL;
+
+        g_debug ("Synchronously getting port metrics...");
+        if (!mm_gdbus_modem_metrics_call_get_metrics_sync (ctx->modem_metrics,
+                                                           &metrics,
+                                                           NULL,
+                                                           &error)) {
+            g_printerr ("error: couldn't get port metrics: '%s'\n",
+                        error ? error->message : "unknown error");
+            exit (EXIT_FAILURE);
+        }
+
+        print_metrics_info (metrics);
+        g_variant_unref (metrics);
+        return;
+    }
+
+    g_warn_if_reached ();
+}
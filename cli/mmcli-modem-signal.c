@@ -133,8 +133,8 @@ mmcli_modem_signal_shutdown (void)
     context_free ();
 }
 
-static void
-print_signal_info (void)
+void
+mmcli_modem_signal_output_info (MMModemSignal *modem_signal)
 {
     MMSignal *signal;
     gdouble   value;
@@ -157,9 +157,9 @@ print_signal_info (void)
     gchar    *nr5g_rsrq = NULL;
     gchar    *nr5g_snr = NULL;
 
-    refresh_rate = g_strdup_printf ("%u", mm_modem_signal_get_rate (ctx->modem_signal));
+    refresh_rate = g_strdup_printf ("%u", mm_modem_signal_get_rate (modem_signal));
 
-    signal = mm_modem_signal_peek_cdma (ctx->modem_signal);
+    signal = mm_modem_signal_peek_cdma (modem_signal);
     if (signal) {
         if ((value = mm_signal_get_rssi (signal)) != MM_SIGNAL_UNKNOWN)
             cdma1x_rssi = g_strdup_printf ("%.2lf", value);
@@ -167,7 +167,7 @@ print_signal_info (void)
             cdma1x_ecio = g_strdup_printf ("%.2lf", value);
     }
 
-    signal = mm_modem_signal_peek_evdo (ctx->modem_signal);
+    signal = mm_modem_signal_peek_evdo (modem_signal);
     if (signal) {
         if ((value = mm_signal_get_rssi (signal)) != MM_SIGNAL_UNKNOWN)
             evdo_rssi = g_strdup_printf ("%.2lf", value);
@@ -179,13 +179,13 @@ print_signal_info (void)
             evdo_io = g_strdup_printf ("%.2lf", value);
     }
 
-    signal = mm_modem_signal_peek_gsm (ctx->modem_signal);
+    signal = mm_modem_signal_peek_gsm (modem_signal);
     if (signal) {
         if ((value = mm_signal_get_rssi (signal)) != MM_SIGNAL_UNKNOWN)
             gsm_rssi = g_strdup_printf ("%.2lf", value);
     }
 
-    signal = mm_modem_signal_peek_umts (ctx->modem_signal);
+    signal = mm_modem_signal_peek_umts (modem_signal);
     if (signal) {
         if ((value = mm_signal_get_rssi (signal)) != MM_SIGNAL_UNKNOWN)
             umts_rssi = g_strdup_printf ("%.2lf", value);
@@ -195,7 +195,7 @@ print_signal_info (void)
             umts_ecio = g_strdup_printf ("%.2lf", value);
     }
 
-    signal = mm_modem_signal_peek_lte (ctx->modem_signal);
+    signal = mm_modem_signal_peek_lte (modem_signal);
     if (signal) {
         if ((value = mm_signal_get_rssi (signal)) != MM_SIGNAL_UNKNOWN)
             lte_rssi = g_strdup_printf ("%.2lf", value);
@@ -207,7 +207,7 @@ print_signal_info (void)
             lte_snr = g_strdup_printf ("%.2lf", value);
     }
 
-    signal = mm_modem_signal_peek_nr5g (ctx->modem_signal);
+    signal = mm_modem_signal_peek_nr5g (modem_signal);
     if (signal) {
         if ((value = mm_signal_get_rsrq (signal)) != MM_SIGNAL_UNKNOWN)
             nr5g_rsrq = g_strdup_printf ("%.2lf", value);
@@ -235,6 +235,12 @@ print_signal_info (void)
     mmcli_output_string_take_typed (MMC_F_SIGNAL_5G_RSRQ,      nr5g_rsrq,    "dB");
     mmcli_output_string_take_typed (MMC_F_SIGNAL_5G_RSRP,      nr5g_rsrp,    "dBm");
     mmcli_output_string_take_typed (MMC_F_SIGNAL_5G_SNR,       nr5g_snr,     "dB");
+}
+
+static void
+print_signal_info (void)
+{
+    mmcli_modem_signal_output_info (ctx->modem_signal);
     mmcli_output_dump ();
 }
 
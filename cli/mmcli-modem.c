@@ -288,8 +288,10 @@ print_bearer_short_info (MMBearer *bearer)
              mm_bearer_get_path (bearer));
 }
 
-static void
-print_modem_info (void)
+void
+mmcli_modem_output_info (MMModem     *modem,
+                         MMModem3gpp *modem_3gpp,
+                         MMModemCdma *modem_cdma)
 {
     gchar *supported_capabilities_string;
     MMModemCapability *capabilities = NULL;
@@ -319,63 +321,63 @@ print_modem_info (void)
     const gchar **bearer_paths;
 
     /* Strings in heap */
-    mm_modem_get_supported_capabilities (ctx->modem, &capabilities, &n_capabilities);
+    mm_modem_get_supported_capabilities (modem, &capabilities, &n_capabilities);
     supported_capabilities_string = mm_common_build_capabilities_string (capabilities, n_capabilities);
     g_free (capabilities);
     current_capabilities_string = mm_modem_capability_build_string_from_mask (
-        mm_modem_get_current_capabilities (ctx->modem));
+        mm_modem_get_current_capabilities (modem));
     access_technologies_string = mm_modem_access_technology_build_string_from_mask (
-        mm_modem_get_access_technologies (ctx->modem));
-    mm_modem_get_supported_modes (ctx->modem, &modes, &n_modes);
+        mm_modem_get_access_technologies (modem));
+    mm_modem_get_supported_modes (modem, &modes, &n_modes);
     supported_modes_string = mm_common_build_mode_combinations_string (modes, n_modes);
     g_free (modes);
-    mm_modem_get_current_bands (ctx->modem, &bands, &n_bands);
+    mm_modem_get_current_bands (modem, &bands, &n_bands);
     current_bands_string = mm_common_build_bands_string (bands, n_bands);
     g_free (bands);
-    mm_modem_get_supported_bands (ctx->modem, &bands, &n_bands);
+    mm_modem_get_supported_bands (modem, &bands, &n_bands);
     supported_bands_string = mm_common_build_bands_string (bands, n_bands);
     g_free (bands);
-    mm_modem_get_ports (ctx->modem, &ports, &n_ports);
+    mm_modem_get_ports (modem, &ports, &n_ports);
     ports_string = mm_common_build_ports_string (ports, n_ports);
     mm_modem_port_info_array_free (ports, n_ports);
-    if (mm_modem_get_current_modes (ctx->modem, &allowed_modes, &preferred_mode)) {
+    if (mm_modem_get_current_modes (modem, &allowed_modes, &preferred_mode)) {
         allowed_modes_string = mm_modem_mode_build_string_from_mask (allowed_modes);
         preferred_mode_string = mm_modem_mode_build_string_from_mask (preferred_mode);
     }
     supported_ip_families_string = mm_bearer_ip_family_build_string_from_mask (
-        mm_modem_get_supported_ip_families (ctx->modem));
+        mm_modem_get_supported_ip_families (modem));
 
-    unlock_retries = mm_modem_get_unlock_retries (ctx->modem);
+    unlock_retries = mm_modem_get_unlock_retries (modem);
     unlock_retries_string = mm_unlock_retries_build_string (unlock_retries);
     g_object_unref (unlock_retries);
 
-    signal_quality = mm_modem_get_signal_quality (ctx->modem, &signal_quality_recent);
+    signal_quality = mm_modem_get_signal_quality (modem, &signal_quality_recent);
 
-    mmcli_output_string           (MMC_F_GENERAL_DBUS_PATH,               mm_modem_get_path (ctx->modem));
-    mmcli_output_string           (MMC_F_GENERAL_DEVICE_ID,               mm_modem_get_device_identifier (ctx->modem));
+    mmcli_output_string           (MMC_F_GENERAL_DBUS_PATH,               mm_modem_get_path (modem));
+    mmcli_output_string           (MMC_F_GENERAL_DEVICE_ID,               mm_modem_get_device_identifier (modem));
 
-    mmcli_output_string           (MMC_F_HARDWARE_MANUFACTURER,           mm_modem_get_manufacturer (ctx->modem));
-    mmcli_output_string           (MMC_F_HARDWARE_MODEL,                  mm_modem_get_model (ctx->modem));
-    mmcli_output_string           (MMC_F_HARDWARE_REVISION,               mm_modem_get_revision (ctx->modem));
-    mmcli_output_string           (MMC_F_HARDWARE_CARRIER_CONF,           mm_modem_get_carrier_configuration (ctx->modem));
-    mmcli_output_string           (MMC_F_HARDWARE_CARRIER_CONF_REV,       mm_modem_get_carrier_configuration_revision (ctx->modem));
-    mmcli_output_string           (MMC_F_HARDWARE_HW_REVISION,            mm_modem_get_hardware_revision (ctx->modem));
+    mmcli_output_string           (MMC_F_HARDWARE_MANUFACTURER,           mm_modem_get_manufacturer (modem));
+    mmcli_output_string           (MMC_F_HARDWARE_MODEL,                  mm_modem_get_model (modem));
+    mmcli_output_string           (MMC_F_HARDWARE_REVISION,               mm_modem_get_revision (modem));
+    mmcli_output_string           (MMC_F_HARDWARE_CARRIER_CONF,           mm_modem_get_carrier_configuration (modem));
+    mmcli_output_string           (MMC_F_HARDWARE_CARRIER_CONF_REV,       mm_modem_get_carrier_configuration_revision (modem));
+    mmcli_output_string           (MMC_F_HARDWARE_HW_REVISION,            mm_modem_get_hardware_revision (modem));
     mmcli_output_string_multiline (MMC_F_HARDWARE_SUPPORTED_CAPABILITIES, supported_capabilities_string);
     mmcli_output_string_multiline (MMC_F_HARDWARE_CURRENT_CAPABILITIES,   current_capabilities_string);
-    mmcli_output_string           (MMC_F_HARDWARE_EQUIPMENT_ID,           mm_modem_get_equipment_identifier (ctx->modem));
+    mmcli_output_string           (MMC_F_HARDWARE_EQUIPMENT_ID,           mm_modem_get_equipment_identifier (modem));
 
-    mmcli_output_string           (MMC_F_SYSTEM_DEVICE,                   mm_modem_get_device (ctx->modem));
-    mmcli_output_string_array     (MMC_F_SYSTEM_DRIVERS,                  (const gchar **) mm_modem_get_drivers (ctx->modem), FALSE);
-    mmcli_output_string           (MMC_F_SYSTEM_PLUGIN,                   mm_modem_get_plugin (ctx->modem));
-    mmcli_output_string           (MMC_F_SYSTEM_PRIMARY_PORT,             mm_modem_get_primary_port (ctx->modem));
+    mmcli_output_string           (MMC_F_SYSTEM_DEVICE,                   mm_modem_get_device (modem));
+    mmcli_output_string_array     (MMC_F_SYSTEM_DRIVERS,                  (const gchar **) mm_modem_get_drivers (modem), FALSE);
+    mmcli_output_string           (MMC_F_SYSTEM_PLUGIN,                   mm_modem_get_plugin (modem));
+    mmcli_output_string           (MMC_F_SYSTEM_PRIMARY_PORT,             mm_modem_get_primary_port (modem));
     mmcli_output_string_list      (MMC_F_SYSTEM_PORTS,                    ports_string);
 
-    mmcli_output_string_array     (MMC_F_NUMBERS_OWN,                     (const gchar **) mm_modem_get_own_numbers (ctx->modem), FALSE);
+    mmcli_output_string_array     (MMC_F_NUMBERS_OWN,                     (const gchar **) mm_modem_get_own_numbers (modem), FALSE);
 
-    mmcli_output_string           (MMC_F_STATUS_LOCK,                     mm_modem_lock_get_string (mm_modem_get_unlock_required (ctx->modem)));
+    mmcli_output_string           (MMC_F_STATUS_LOCK,                     mm_modem_lock_get_string (mm_modem_get_unlock_required (modem)));
     mmcli_output_string_list      (MMC_F_STATUS_UNLOCK_RETRIES,           unlock_retries_string);
-    mmcli_output_state            (mm_modem_get_state (ctx->modem), mm_modem_get_state_failed_reason (ctx->modem));
-    mmcli_output_string           (MMC_F_STATUS_POWER_STATE,              mm_modem_power_state_get_string (mm_modem_get_power_state (ctx->modem)));
+    mmcli_output_state            (mm_modem_get_state (modem), mm_modem_get_state_failed_reason (modem));
+    mmcli_output_string           (MMC_F_STATUS_POWER_STATE,              mm_modem_power_state_get_string (mm_modem_get_power_state (modem)));
     mmcli_output_string_list      (MMC_F_STATUS_ACCESS_TECH,              access_technologies_string);
     mmcli_output_signal_quality   (signal_quality, signal_quality_recent);
 
@@ -403,20 +405,20 @@ print_modem_info (void)
         const gchar *initial_eps_bearer_user = NULL;
         const gchar *initial_eps_bearer_password = NULL;
 
-        if (ctx->modem_3gpp) {
-            imei = mm_modem_3gpp_get_imei (ctx->modem_3gpp);
-            facility_locks = mm_modem_3gpp_facility_build_string_from_mask (mm_modem_3gpp_get_enabled_facility_locks (ctx->modem_3gpp));
-            operator_code = mm_modem_3gpp_get_operator_code (ctx->modem_3gpp);
-            operator_name = mm_modem_3gpp_get_operator_name (ctx->modem_3gpp);
-            registration = mm_modem_3gpp_registration_state_get_string (mm_modem_3gpp_get_registration_state (ctx->modem_3gpp));
-            eps_ue_mode = mm_modem_3gpp_eps_ue_mode_operation_get_string (mm_modem_3gpp_get_eps_ue_mode_operation (ctx->modem_3gpp));
-            pco_list = mm_modem_3gpp_get_pco (ctx->modem_3gpp);
-            initial_eps_bearer_path = mm_modem_3gpp_get_initial_eps_bearer_path (ctx->modem_3gpp);
-
-            if (mm_modem_get_current_capabilities (ctx->modem) & (MM_MODEM_CAPABILITY_LTE)) {
+        if (modem_3gpp) {
+            imei = mm_modem_3gpp_get_imei (modem_3gpp);
+            facility_locks = mm_modem_3gpp_facility_build_string_from_mask (mm_modem_3gpp_get_enabled_facility_locks (modem_3gpp));
+            operator_code = mm_modem_3gpp_get_operator_code (modem_3gpp);
+            operator_name = mm_modem_3gpp_get_operator_name (modem_3gpp);
+            registration = mm_modem_3gpp_registration_state_get_string (mm_modem_3gpp_get_registration_state (modem_3gpp));
+            eps_ue_mode = mm_modem_3gpp_eps_ue_mode_operation_get_string (mm_modem_3gpp_get_eps_ue_mode_operation (modem_3gpp));
+            pco_list = mm_modem_3gpp_get_pco (modem_3gpp);
+            initial_eps_bearer_path = mm_modem_3gpp_get_initial_eps_bearer_path (modem_3gpp);
+
+            if (mm_modem_get_current_capabilities (modem) & (MM_MODEM_CAPABILITY_LTE)) {
                 MMBearerProperties *initial_eps_bearer_properties;
 
-                initial_eps_bearer_properties = mm_modem_3gpp_peek_initial_eps_bearer_settings (ctx->modem_3gpp);
+                initial_eps_bearer_properties = mm_modem_3gpp_peek_initial_eps_bearer_settings (modem_3gpp);
                 if (initial_eps_bearer_properties) {
                     initial_eps_bearer_apn           = mm_bearer_properties_get_apn (initial_eps_bearer_properties);
                     initial_eps_bearer_ip_family_str = mm_bearer_ip_family_build_string_from_mask (mm_bearer_properties_get_ip_type (initial_eps_bearer_properties));
@@ -453,21 +455,21 @@ print_modem_info (void)
         const gchar *registration_evdo = NULL;
         const gchar *activation = NULL;
 
-        if (ctx->modem_cdma) {
+        if (modem_cdma) {
             guint sid_n;
             guint nid_n;
 
-            meid = mm_modem_cdma_get_meid (ctx->modem_cdma);
-            esn  = mm_modem_cdma_get_esn (ctx->modem_cdma);
-            sid_n = mm_modem_cdma_get_sid (ctx->modem_cdma);
+            meid = mm_modem_cdma_get_meid (modem_cdma);
+            esn  = mm_modem_cdma_get_esn (modem_cdma);
+            sid_n = mm_modem_cdma_get_sid (modem_cdma);
             if (sid_n != MM_MODEM_CDMA_SID_UNKNOWN)
                 sid = g_strdup_printf ("%u", sid_n);
-            nid_n = mm_modem_cdma_get_nid (ctx->modem_cdma);
+            nid_n = mm_modem_cdma_get_nid (modem_cdma);
             if (nid_n != MM_MODEM_CDMA_NID_UNKNOWN)
                 nid = g_strdup_printf ("%u", nid_n);
-            registration_cdma1x = mm_modem_cdma_registration_state_get_string (mm_modem_cdma_get_cdma1x_registration_state (ctx->modem_cdma));
-            registration_evdo = mm_modem_cdma_registration_state_get_string (mm_modem_cdma_get_evdo_registration_state (ctx->modem_cdma));
-            activation = mm_modem_cdma_activation_state_get_string (mm_modem_cdma_get_activation_state (ctx->modem_cdma));
+            registration_cdma1x = mm_modem_cdma_registration_state_get_string (mm_modem_cdma_get_cdma1x_registration_state (modem_cdma));
+            registration_evdo = mm_modem_cdma_registration_state_get_string (mm_modem_cdma_get_evdo_registration_state (modem_cdma));
+            activation = mm_modem_cdma_activation_state_get_string (mm_modem_cdma_get_activation_state (modem_cdma));
         }
 
         mmcli_output_string      (MMC_F_CDMA_MEID,                meid);
@@ -479,16 +481,14 @@ print_modem_info (void)
         mmcli_output_string      (MMC_F_CDMA_ACTIVATION,          activation);
     }
 
-    sim_path = mm_modem_get_sim_path (ctx->modem);
+    sim_path = mm_modem_get_sim_path (modem);
     mmcli_output_string (MMC_F_SIM_PATH, g_strcmp0 (sim_path, "/") != 0 ? sim_path : NULL);
-    mmcli_output_sim_slots (mm_modem_dup_sim_slot_paths (ctx->modem),
-                            mm_modem_get_primary_sim_slot (ctx->modem));
+    mmcli_output_sim_slots (mm_modem_dup_sim_slot_paths (modem),
+                            mm_modem_get_primary_sim_slot (modem));
 
-    bearer_paths = (const gchar **) mm_modem_get_bearer_paths (ctx->modem);
+    bearer_paths = (const gchar **) mm_modem_get_bearer_paths (modem);
     mmcli_output_string_array (MMC_F_BEARER_PATHS, (bearer_paths && bearer_paths[0]) ? bearer_paths : NULL, TRUE);
 
-    mmcli_output_dump ();
-
     g_free (ports_string);
     g_free (supported_ip_families_string);
     g_free (current_bands_string);
@@ -502,6 +502,13 @@ print_modem_info (void)
     g_free (unlock_retries_string);
 }
 
+static void
+print_modem_info (void)
+{
+    mmcli_modem_output_info (ctx->modem, ctx->modem_3gpp, ctx->modem_cdma);
+    mmcli_output_dump ();
+}
+
 static void
 enable_process_reply (gboolean      result,
                       const GError *error)
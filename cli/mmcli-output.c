@@ -69,6 +69,7 @@ static SectionInfo section_infos[] = {
     [MMC_S_MODEM_FIRMWARE]             = { "Firmware"             },
     [MMC_S_MODEM_FIRMWARE_FASTBOOT]    = { "Fastboot settings"    },
     [MMC_S_MODEM_VOICE]                = { "Voice"                },
+    [MMC_S_MODEM_METRICS]              = { "Metrics"              },
     [MMC_S_BEARER_GENERAL]             = { "General"              },
     [MMC_S_BEARER_STATUS]              = { "Status"               },
     [MMC_S_BEARER_PROPERTIES]          = { "Properties"           },
@@ -207,6 +208,8 @@ static FieldInfo field_infos[] = {
     [MMC_F_FIRMWARE_VERSION]                       = { "modem.firmware.version",                          "version",                  MMC_S_MODEM_FIRMWARE,             },
     [MMC_F_FIRMWARE_FASTBOOT_AT]                   = { "modem.firmware.fastboot.at",                      "at command",               MMC_S_MODEM_FIRMWARE_FASTBOOT,    },
     [MMC_F_VOICE_EMERGENCY_ONLY]                   = { "modem.voice.emergency-only",                      "emergency only",           MMC_S_MODEM_VOICE,                },
+    [MMC_F_METRICS_PORTS]                          = { "modem.metrics.ports",                             "ports",                    MMC_S_MODEM_METRICS,              },
+    [MMC_F_METRICS_COMMANDS]                       = { "modem.metrics.commands",                          "commands",                 MMC_S_MODEM_METRICS,              },
     [MMC_F_BEARER_GENERAL_DBUS_PATH]               = { "bearer.dbus-path",                                "path",                     MMC_S_BEARER_GENERAL,             },
     [MMC_F_BEARER_GENERAL_TYPE]                    = { "bearer.type",                                     "type",                     MMC_S_BEARER_GENERAL,             },
     [MMC_F_BEARER_STATUS_CONNECTED]                = { "bearer.status.connected",                         "connected",                MMC_S_BEARER_STATUS,              },
@@ -286,6 +289,7 @@ static FieldInfo field_infos[] = {
     [MMC_F_MODEM_LIST_DBUS_PATH]                   = { "modem-list",                                      "modems",                   MMC_S_UNKNOWN,                    },
     [MMC_F_SMS_LIST_DBUS_PATH]                     = { "modem.messaging.sms",                             "sms messages",             MMC_S_UNKNOWN,                    },
     [MMC_F_CALL_LIST_DBUS_PATH]                    = { "modem.voice.call",                                "calls",                    MMC_S_UNKNOWN,                    },
+    [MMC_F_REMOVED_LIST_DBUS_PATH]                 = { "removed",                                         "removed objects",          MMC_S_UNKNOWN,                    },
 };
 
 /******************************************************************************/
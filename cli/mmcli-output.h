@@ -66,6 +66,7 @@ typedef enum {
     MMC_S_MODEM_FIRMWARE,
     MMC_S_MODEM_FIRMWARE_FASTBOOT,
     MMC_S_MODEM_VOICE,
+    MMC_S_MODEM_METRICS,
     MMC_S_BEARER_GENERAL,
     MMC_S_BEARER_STATUS,
     MMC_S_BEARER_PROPERTIES,
@@ -222,6 +223,9 @@ typedef enum {
     MMC_F_FIRMWARE_FASTBOOT_AT,
     /* Voice section */
     MMC_F_VOICE_EMERGENCY_ONLY,
+    /* Metrics section */
+    MMC_F_METRICS_PORTS,
+    MMC_F_METRICS_COMMANDS,
     /* Bearer general section */
     MMC_F_BEARER_GENERAL_DBUS_PATH,
     MMC_F_BEARER_GENERAL_TYPE,
@@ -305,6 +309,7 @@ typedef enum {
     MMC_F_MODEM_LIST_DBUS_PATH,
     MMC_F_SMS_LIST_DBUS_PATH,
     MMC_F_CALL_LIST_DBUS_PATH,
+    MMC_F_REMOVED_LIST_DBUS_PATH,
 } MmcF;
 
 /******************************************************************************/
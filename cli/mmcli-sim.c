@@ -161,8 +161,8 @@ mmcli_sim_shutdown (void)
     context_free ();
 }
 
-static void
-print_sim_info (MMSim *sim)
+void
+mmcli_sim_output_info (MMSim *sim)
 {
     GList *preferred_nets_list;
 
@@ -177,6 +177,12 @@ print_sim_info (MMSim *sim)
     preferred_nets_list = mm_sim_get_preferred_networks (sim);
     mmcli_output_preferred_networks (preferred_nets_list);
     g_list_free_full (preferred_nets_list, (GDestroyNotify) mm_sim_preferred_network_free);
+}
+
+static void
+print_sim_info (MMSim *sim)
+{
+    mmcli_sim_output_info (sim);
     mmcli_output_dump ();
 }
 
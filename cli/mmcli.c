@@ -233,6 +233,8 @@ main (gint argc, gchar **argv)
                                 mmcli_modem_signal_get_option_group ());
     g_option_context_add_group (context,
                                 mmcli_modem_oma_get_option_group ());
+    g_option_context_add_group (context,
+                                mmcli_modem_metrics_get_option_group ());
     g_option_context_add_group (context,
                                 mmcli_sim_get_option_group ());
     g_option_context_add_group (context,
@@ -416,6 +418,13 @@ main (gint argc, gchar **argv)
         else
             mmcli_modem_oma_run_synchronous (connection);
     }
+    /* Modem Metrics options? */
+    else if (mmcli_modem_metrics_options_enabled ()) {
+        if (async_flag)
+            mmcli_modem_metrics_run_asynchronous (connection, cancellable);
+        else
+            mmcli_modem_metrics_run_synchronous (connection);
+    }
     /* Modem options?
      * NOTE: let this check be always the last one, as other groups also need
      * having a modem specified, and therefore if -m is set, modem options
@@ -462,6 +471,8 @@ main (gint argc, gchar **argv)
         mmcli_modem_signal_shutdown ();
     } else if (mmcli_modem_oma_options_enabled ()) {
         mmcli_modem_oma_shutdown ();
+    } else if (mmcli_modem_metrics_options_enabled ()) {
+        mmcli_modem_metrics_shutdown ();
     }  else if (mmcli_sim_options_enabled ()) {
         mmcli_sim_shutdown ();
     } else if (mmcli_bearer_options_enabled ()) {
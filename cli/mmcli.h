@@ -133,6 +133,14 @@ void          mmcli_modem_signal_run_asynchronous   (GDBusConnection *connection
 void          mmcli_modem_signal_run_synchronous    (GDBusConnection *connection);
 void          mmcli_modem_signal_shutdown           (void);
 
+/* Metrics group */
+GOptionGroup *mmcli_modem_metrics_get_option_group   (void);
+gboolean      mmcli_modem_metrics_options_enabled    (void);
+void          mmcli_modem_metrics_run_asynchronous   (GDBusConnection *connection,
+                                                      GCancellable    *cancellable);
+void          mmcli_modem_metrics_run_synchronous    (GDBusConnection *connection);
+void          mmcli_modem_metrics_shutdown           (void);
+
 /* Oma group */
 GOptionGroup *mmcli_modem_oma_get_option_group   (void);
 gboolean      mmcli_modem_oma_options_enabled    (void);
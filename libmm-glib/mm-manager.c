@@ -29,6 +29,7 @@
 #include "mm-gdbus-manager.h"
 #include "mm-manager.h"
 #include "mm-object.h"
+#include "mm-modem-snapshot.h"
 
 /**
  * SECTION: mm-manager
@@ -79,6 +80,7 @@ get_proxy_type (GDBusObjectManagerClient *manager,
         g_hash_table_insert (lookup_hash, "org.freedesktop.ModemManager1.Modem.Modem3gpp.ProfileManager", GSIZE_TO_POINTER (MM_TYPE_MODEM_3GPP_PROFILE_MANAGER));
         g_hash_table_insert (lookup_hash, "org.freedesktop.ModemManager1.Modem.Modem3gpp.Ussd",           GSIZE_TO_POINTER (MM_TYPE_MODEM_3GPP_USSD));
         g_hash_table_insert (lookup_hash, "org.freedesktop.ModemManager1.Modem.Simple",                   GSIZE_TO_POINTER (MM_TYPE_MODEM_SIMPLE));
+        g_hash_table_insert (lookup_hash, "org.freedesktop.ModemManager1.Modem.Metrics",                  GSIZE_TO_POINTER (MM_GDBUS_TYPE_MODEM_METRICS_PROXY));
         /* g_hash_table_insert (lookup_hash, "org.freedesktop.ModemManager1.Modem.Contacts",              GSIZE_TO_POINTER (MM_GDBUS_TYPE_MODEM_CONTACTS_PROXY)); */
         g_once_init_leave (&once_init_value, 1);
     }
@@ -961,6 +963,396 @@ mm_manager_uninhibit_device_sync (MMManager     *manager,
 
 /*****************************************************************************/
 
+/**
+ * mm_manager_dump_trace_finish:
+ * @manager: A #MMManager.
+ * @res: The #GAsyncResult obtained from the #GAsyncReadyCallback passed to
+ *  mm_manager_dump_trace().
+ * @error: Return location for error or %NULL.
+ *
+ * Finishes an operation started with mm_manager_dump_trace().
+ *
+ * Returns: (transfer full): the trace in the Chrome trace event JSON format,
+ * or %NULL if @error is set. The returned value should be freed with g_free().
+ *
+ * Since: 1.18
+ */
+gchar *
+mm_manager_dump_trace_finish (MMManager     *manager,
+                              GAsyncResult  *res,
+                              GError       **error)
+{
+    return g_task_propagate_pointer (G_TASK (res), error);
+}
+
+static void
+dump_trace_ready (MmGdbusOrgFreedesktopModemManager1 *manager_iface_proxy,
+                  GAsyncResult                       *res,
+                  GTask                              *task)
+{
+    GError *error = NULL;
+    gchar  *trace = NULL;
+
+    if (!mm_gdbus_org_freedesktop_modem_manager1_call_dump_trace_finish (
+            manager_iface_proxy,
+            &trace,
+            res,
+            &error))
+        g_task_return_error (task, error);
+    else
+        g_task_return_pointer (task, trace, g_free);
+
+    g_object_unref (task);
+}
+
+/**
+ * mm_manager_dump_trace:
+ * @manager: A #MMManager.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @callback: A #GAsyncReadyCallback to call when the request is satisfied or
+ *  %NULL.
+ * @user_data: User data to pass to @callback.
+ *
+ * Asynchronously requests the timeline of device probing, modem
+ * initialization, enabling and connection steps recorded by the daemon.
+ *
+ * The daemon only records the timeline when started with the
+ * <literal>--log-trace</literal> option.
+ *
+ * When the operation is finished, @callback will be invoked in the
+ * <link linkend="g-main-context-push-thread-default">thread-default main loop</link>
+ * of the thread you are calling this method from. You can then call
+ * mm_manager_dump_trace_finish() to get the result of the operation.
+ *
+ * See mm_manager_dump_trace_sync() for the synchronous, blocking version of
+ * this method.
+ *
+ * Since: 1.18
+ */
+void
+mm_manager_dump_trace (MMManager           *manager,
+                       GCancellable        *cancellable,
+                       GAsyncReadyCallback  callback,
+                       gpointer             user_data)
+{
+    GTask *task;
+    GError *inner_error = NULL;
+
+    g_return_if_fail (MM_IS_MANAGER (manager));
+
+    task = g_task_new (manager, cancellable, callback, user_data);
+
+    if (!ensure_modem_manager1_proxy (manager, &inner_error)) {
+        g_task_return_error (task, inner_error);
+        g_object_unref (task);
+        return;
+    }
+
+    mm_gdbus_org_freedesktop_modem_manager1_call_dump_trace (
+        manager->priv->manager_iface_proxy,
+        cancellable,
+        (GAsyncReadyCallback)dump_trace_ready,
+        task);
+}
+
+/**
+ * mm_manager_dump_trace_sync:
+ * @manager: A #MMManager.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @error: Return location for error or %NULL.
+ *
+ * Synchronously requests the timeline of device probing, modem
+ * initialization, enabling and connection steps recorded by the daemon.
+ *
+ * The calling thread is blocked until a reply is received.
+ *
+ * See mm_manager_dump_trace() for the asynchronous version of this method.
+ *
+ * Returns: (transfer full): the trace in the Chrome trace event JSON format,
+ * or %NULL if @error is set. The returned value should be freed with g_free().
+ *
+ * Since: 1.18
+ */
+gchar *
+mm_manager_dump_trace_sync (MMManager     *manager,
+                            GCancellable  *cancellable,
+                            GError       **error)
+{
+    gchar *trace = NULL;
+
+    g_return_val_if_fail (MM_IS_MANAGER (manager), NULL);
+
+    if (!ensure_modem_manager1_proxy (manager, error))
+        return NULL;
+
+    if (!mm_gdbus_org_freedesktop_modem_manager1_call_dump_trace_sync (
+            manager->priv->manager_iface_proxy,
+            &trace,
+            cancellable,
+            error))
+        return NULL;
+
+    return trace;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_manager_clear_capability_cache_finish:
+ * @manager: A #MMManager.
+ * @res: The #GAsyncResult obtained from the #GAsyncReadyCallback passed to
+ *  mm_manager_clear_capability_cache().
+ * @error: Return location for error or %NULL.
+ *
+ * Finishes an operation started with mm_manager_clear_capability_cache().
+ *
+ * Returns: %TRUE if the cache was cleared, %FALSE if @error is set.
+ *
+ * Since: 1.18
+ */
+gboolean
+mm_manager_clear_capability_cache_finish (MMManager     *manager,
+                                          GAsyncResult  *res,
+                                          GError       **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+static void
+clear_capability_cache_ready (MmGdbusOrgFreedesktopModemManager1 *manager_iface_proxy,
+                              GAsyncResult                       *res,
+                              GTask                              *task)
+{
+    GError *error = NULL;
+
+    if (!mm_gdbus_org_freedesktop_modem_manager1_call_clear_capability_cache_finish (
+            manager_iface_proxy,
+            res,
+            &error))
+        g_task_return_error (task, error);
+    else
+        g_task_return_boolean (task, TRUE);
+
+    g_object_unref (task);
+}
+
+/**
+ * mm_manager_clear_capability_cache:
+ * @manager: A #MMManager.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @callback: A #GAsyncReadyCallback to call when the request is satisfied or
+ *  %NULL.
+ * @user_data: User data to pass to @callback.
+ *
+ * Asynchronously requests to remove the modem capabilities stored on disk by
+ * the daemon, so that they are loaded again from the device the next time
+ * each modem is initialized.
+ *
+ * When the operation is finished, @callback will be invoked in the
+ * <link linkend="g-main-context-push-thread-default">thread-default main loop</link>
+ * of the thread you are calling this method from. You can then call
+ * mm_manager_clear_capability_cache_finish() to get the result of the
+ * operation.
+ *
+ * See mm_manager_clear_capability_cache_sync() for the synchronous, blocking
+ * version of this method.
+ *
+ * Since: 1.18
+ */
+void
+mm_manager_clear_capability_cache (MMManager           *manager,
+                                   GCancellable        *cancellable,
+                                   GAsyncReadyCallback  callback,
+                                   gpointer             user_data)
+{
+    GTask *task;
+    GError *inner_error = NULL;
+
+    g_return_if_fail (MM_IS_MANAGER (manager));
+
+    task = g_task_new (manager, cancellable, callback, user_data);
+
+    if (!ensure_modem_manager1_proxy (manager, &inner_error)) {
+        g_task_return_error (task, inner_error);
+        g_object_unref (task);
+        return;
+    }
+
+    mm_gdbus_org_freedesktop_modem_manager1_call_clear_capability_cache (
+        manager->priv->manager_iface_proxy,
+        cancellable,
+        (GAsyncReadyCallback)clear_capability_cache_ready,
+        task);
+}
+
+/**
+ * mm_manager_clear_capability_cache_sync:
+ * @manager: A #MMManager.
+ * @cancellable: (allow-none): A #GCancellable or %NULL.
+ * @error: Return location for error or %NULL.
+ *
+ * Synchronously requests to remove the modem capabilities stored on disk by
+ * the daemon.
+ *
+ * The calling thread is blocked until a reply is received.
+ *
+ * See mm_manager_clear_capability_cache() for the asynchronous version of
+ * this method.
+ *
+ * Returns: %TRUE if the cache was cleared, %FALSE if @error is set.
+ *
+ * Since: 1.18
+ */
+gboolean
+mm_manager_clear_capability_cache_sync (MMManager     *manager,
+                                        GCancellable  *cancellable,
+                                        GError       **error)
+{
+    g_return_val_if_fail (MM_IS_MANAGER (manager), FALSE);
+
+    if (!ensure_modem_manager1_proxy (manager, error))
+        return FALSE;
+
+    return mm_gdbus_org_freedesktop_modem_manager1_call_clear_capability_cache_sync (
+               manager->priv->manager_iface_proxy,
+               cancellable,
+               error);
+}
+
+/*****************************************************************************/
+/* Snapshots */
+
+/* The last snapshot built for each modem object is kept in the object itself,
+ * and dropped as soon as any of the interfaces it reads from changes */
+
+static GQuark snapshot_quark;
+static GQuark snapshot_watched_quark;
+
+static void
+snapshot_invalidate (MMObject *object)
+{
+    g_object_set_qdata (G_OBJECT (object), snapshot_quark, NULL);
+}
+
+static void
+snapshot_properties_changed_cb (GDBusProxy *proxy,
+                                GVariant   *changed_properties,
+                                GStrv       invalidated_properties,
+                                MMObject   *object)
+{
+    snapshot_invalidate (object);
+}
+
+static void
+snapshot_watch_interface (MMObject       *object,
+                          GDBusInterface *interface)
+{
+    if (!MM_IS_MODEM (interface) && !MM_IS_MODEM_3GPP (interface))
+        return;
+
+    g_signal_connect_object (interface,
+                             "g-properties-changed",
+                             G_CALLBACK (snapshot_properties_changed_cb),
+                             object,
+                             0);
+}
+
+static void
+snapshot_interface_added_cb (MMObject       *object,
+                             GDBusInterface *interface)
+{
+    snapshot_watch_interface (object, interface);
+    snapshot_invalidate (object);
+}
+
+static void
+snapshot_interface_removed_cb (MMObject       *object,
+                               GDBusInterface *interface)
+{
+    snapshot_invalidate (object);
+}
+
+static MMModemSnapshot *
+snapshot_ref_for_object (MMObject *object)
+{
+    MMModemSnapshot *snapshot;
+
+    snapshot = g_object_get_qdata (G_OBJECT (object), snapshot_quark);
+    if (snapshot)
+        return g_object_ref (snapshot);
+
+    snapshot = mm_modem_snapshot_new_from_object (object);
+    if (!snapshot)
+        return NULL;
+
+    /* Watch for changes the first time a snapshot is built for the object */
+    if (!g_object_get_qdata (G_OBJECT (object), snapshot_watched_quark)) {
+        GDBusInterface *interface;
+
+        if ((interface = G_DBUS_INTERFACE (mm_object_peek_modem (object))) != NULL)
+            snapshot_watch_interface (object, interface);
+        if ((interface = G_DBUS_INTERFACE (mm_object_peek_modem_3gpp (object))) != NULL)
+            snapshot_watch_interface (object, interface);
+        g_signal_connect (object, "interface-added",   G_CALLBACK (snapshot_interface_added_cb),   NULL);
+        g_signal_connect (object, "interface-removed", G_CALLBACK (snapshot_interface_removed_cb), NULL);
+        g_object_set_qdata (G_OBJECT (object), snapshot_watched_quark, GUINT_TO_POINTER (TRUE));
+    }
+
+    g_object_set_qdata_full (G_OBJECT (object), snapshot_quark, g_object_ref (snapshot), g_object_unref);
+    return snapshot;
+}
+
+static gint
+snapshot_path_cmp (MMModemSnapshot *a,
+                   MMModemSnapshot *b)
+{
+    return g_strcmp0 (mm_modem_snapshot_get_path (a), mm_modem_snapshot_get_path (b));
+}
+
+/**
+ * mm_manager_snapshot:
+ * @manager: A #MMManager.
+ *
+ * Gets an immutable view of the status of all the modems currently managed.
+ *
+ * Each #MMModemSnapshot is built once and kept until the next change in the
+ * properties of the modem, so clients polling periodically get back the very
+ * same #MMModemSnapshot objects for modems that did not change since the
+ * previous call, and can compare them by pointer to skip any further
+ * processing.
+ *
+ * The method must be called from the thread where @manager was created.
+ *
+ * Returns: (transfer full) (element-type ModemManager.ModemSnapshot): A list of
+ * #MMModemSnapshot objects, sorted by modem path. The returned value should be
+ * freed with g_list_free_full() using g_object_unref() as #GDestroyNotify.
+ *
+ * Since: 1.18
+ */
+GList *
+mm_manager_snapshot (MMManager *manager)
+{
+    GList *objects;
+    GList *l;
+    GList *snapshots = NULL;
+
+    g_return_val_if_fail (MM_IS_MANAGER (manager), NULL);
+
+    objects = g_dbus_object_manager_get_objects (G_DBUS_OBJECT_MANAGER (manager));
+    for (l = objects; l; l = g_list_next (l)) {
+        MMModemSnapshot *snapshot;
+
+        snapshot = snapshot_ref_for_object (MM_OBJECT (l->data));
+        if (snapshot)
+            snapshots = g_list_prepend (snapshots, snapshot);
+    }
+    g_list_free_full (objects, g_object_unref);
+
+    return g_list_sort (snapshots, (GCompareFunc) snapshot_path_cmp);
+}
+
+/*****************************************************************************/
+
 static void
 mm_manager_init (MMManager *manager)
 {
@@ -989,6 +1381,9 @@ mm_manager_class_init (MMManagerClass *manager_class)
 
     g_type_class_add_private (object_class, sizeof (MMManagerPrivate));
 
+    snapshot_quark = g_quark_from_static_string ("mm-manager-snapshot");
+    snapshot_watched_quark = g_quark_from_static_string ("mm-manager-snapshot-watched");
+
     /* Virtual methods */
     object_class->dispose = dispose;
 }
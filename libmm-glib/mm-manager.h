@@ -88,6 +88,8 @@ GDBusProxy *mm_manager_get_proxy  (MMManager *manager);
 
 const gchar *mm_manager_get_version (MMManager *manager);
 
+GList *mm_manager_snapshot (MMManager *manager);
+
 void mm_manager_set_logging (MMManager           *manager,
                              const gchar         *level,
                              GCancellable        *cancellable,
@@ -151,6 +153,28 @@ gboolean mm_manager_uninhibit_device_sync   (MMManager           *manager,
                                              GCancellable        *cancellable,
                                              GError             **error);
 
+void   mm_manager_dump_trace        (MMManager           *manager,
+                                     GCancellable        *cancellable,
+                                     GAsyncReadyCallback  callback,
+                                     gpointer             user_data);
+gchar *mm_manager_dump_trace_finish (MMManager           *manager,
+                                     GAsyncResult        *res,
+                                     GError             **error);
+gchar *mm_manager_dump_trace_sync   (MMManager           *manager,
+                                     GCancellable        *cancellable,
+                                     GError             **error);
+
+void     mm_manager_clear_capability_cache        (MMManager           *manager,
+                                                   GCancellable        *cancellable,
+                                                   GAsyncReadyCallback  callback,
+                                                   gpointer             user_data);
+gboolean mm_manager_clear_capability_cache_finish (MMManager           *manager,
+                                                   GAsyncResult        *res,
+                                                   GError             **error);
+gboolean mm_manager_clear_capability_cache_sync   (MMManager           *manager,
+                                                   GCancellable        *cancellable,
+                                                   GError             **error);
+
 G_END_DECLS
 
 #endif /* _MM_MANAGER_H_ */
@@ -0,0 +1,492 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include "mm-modem-snapshot.h"
+
+/**
+ * SECTION: mm-modem-snapshot
+ * @title: MMModemSnapshot
+ * @short_description: Immutable view of the status of a modem.
+ *
+ * The #MMModemSnapshot is an object holding a copy of the most relevant
+ * status properties of a modem, all of them read at the same time.
+ *
+ * Unlike the #MMModem and #MMModem3gpp objects, a #MMModemSnapshot never
+ * changes once created, so the values returned by its getters are always
+ * consistent with each other, and they stay valid for as long as the
+ * snapshot is alive.
+ *
+ * This object is retrieved with mm_manager_snapshot().
+ */
+
+G_DEFINE_TYPE (MMModemSnapshot, mm_modem_snapshot, G_TYPE_OBJECT)
+
+struct _MMModemSnapshotPrivate {
+    gchar                        *path;
+    MMModemState                  state;
+    MMModemStateFailedReason      state_failed_reason;
+    MMModemPowerState             power_state;
+    MMModemAccessTechnology       access_technologies;
+    guint                         signal_quality;
+    gboolean                      signal_quality_recent;
+    MMModemLock                   unlock_required;
+    gchar                        *manufacturer;
+    gchar                        *model;
+    gchar                        *revision;
+    gchar                        *equipment_identifier;
+    gchar                        *sim_path;
+    gchar                       **bearer_paths;
+    gboolean                      has_3gpp;
+    MMModem3gppRegistrationState  registration_state;
+    gchar                        *operator_code;
+    gchar                        *operator_name;
+    gchar                        *imei;
+};
+
+/*****************************************************************************/
+
+/**
+ * mm_modem_snapshot_get_path:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the DBus path of the modem.
+ *
+ * Returns: (transfer none): The DBus path of the modem. Do not free the
+ * returned value, it belongs to @self.
+ *
+ * Since: 1.18
+ */
+const gchar *
+mm_modem_snapshot_get_path (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->path;
+}
+
+/**
+ * mm_modem_snapshot_get_state:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the state of the modem.
+ *
+ * Returns: A #MMModemState value.
+ *
+ * Since: 1.18
+ */
+MMModemState
+mm_modem_snapshot_get_state (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), MM_MODEM_STATE_UNKNOWN);
+
+    return self->priv->state;
+}
+
+/**
+ * mm_modem_snapshot_get_state_failed_reason:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the reason specifying why the modem is in #MM_MODEM_STATE_FAILED state.
+ *
+ * Returns: A #MMModemStateFailedReason value.
+ *
+ * Since: 1.18
+ */
+MMModemStateFailedReason
+mm_modem_snapshot_get_state_failed_reason (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), MM_MODEM_STATE_FAILED_REASON_NONE);
+
+    return self->priv->state_failed_reason;
+}
+
+/**
+ * mm_modem_snapshot_get_power_state:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the power state of the modem.
+ *
+ * Returns: A #MMModemPowerState value.
+ *
+ * Since: 1.18
+ */
+MMModemPowerState
+mm_modem_snapshot_get_power_state (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), MM_MODEM_POWER_STATE_UNKNOWN);
+
+    return self->priv->power_state;
+}
+
+/**
+ * mm_modem_snapshot_get_access_technologies:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the current network access technologies used by the modem to
+ * communicate with the network.
+ *
+ * Returns: A ORed mask of #MMModemAccessTechnology values.
+ *
+ * Since: 1.18
+ */
+MMModemAccessTechnology
+mm_modem_snapshot_get_access_technologies (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN);
+
+    return self->priv->access_technologies;
+}
+
+/**
+ * mm_modem_snapshot_get_signal_quality:
+ * @self: A #MMModemSnapshot.
+ * @recent: (out) (allow-none): Return location for the flag specifying if the
+ *  signal quality value was recent or not.
+ *
+ * Gets the signal quality value in percent (0 - 100) of the dominant access
+ * technology the modem is using to communicate with the network.
+ *
+ * Returns: The signal quality.
+ *
+ * Since: 1.18
+ */
+guint
+mm_modem_snapshot_get_signal_quality (MMModemSnapshot *self,
+                                      gboolean        *recent)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), 0);
+
+    if (recent)
+        *recent = self->priv->signal_quality_recent;
+    return self->priv->signal_quality;
+}
+
+/**
+ * mm_modem_snapshot_get_unlock_required:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the type of lock which is currently blocking the modem.
+ *
+ * Returns: A #MMModemLock value.
+ *
+ * Since: 1.18
+ */
+MMModemLock
+mm_modem_snapshot_get_unlock_required (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), MM_MODEM_LOCK_UNKNOWN);
+
+    return self->priv->unlock_required;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_modem_snapshot_get_manufacturer:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the equipment manufacturer, as reported by the modem.
+ *
+ * Returns: (transfer none): The equipment manufacturer, or %NULL if none
+ * available. Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.18
+ */
+const gchar *
+mm_modem_snapshot_get_manufacturer (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->manufacturer;
+}
+
+/**
+ * mm_modem_snapshot_get_model:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the equipment model, as reported by the modem.
+ *
+ * Returns: (transfer none): The equipment model, or %NULL if none available.
+ * Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.18
+ */
+const gchar *
+mm_modem_snapshot_get_model (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->model;
+}
+
+/**
+ * mm_modem_snapshot_get_revision:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the equipment revision, as reported by the modem.
+ *
+ * Returns: (transfer none): The equipment revision, or %NULL if none
+ * available. Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.18
+ */
+const gchar *
+mm_modem_snapshot_get_revision (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->revision;
+}
+
+/**
+ * mm_modem_snapshot_get_equipment_identifier:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the identity of the modem, e.g. the IMEI or the ESN.
+ *
+ * Returns: (transfer none): The equipment identifier, or %NULL if none
+ * available. Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.18
+ */
+const gchar *
+mm_modem_snapshot_get_equipment_identifier (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->equipment_identifier;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_modem_snapshot_get_sim_path:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the DBus path of the primary SIM object available in the modem.
+ *
+ * Returns: (transfer none): The DBus path of the SIM, or %NULL if none
+ * available. Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.18
+ */
+const gchar *
+mm_modem_snapshot_get_sim_path (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->sim_path;
+}
+
+/**
+ * mm_modem_snapshot_get_bearer_paths:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the DBus paths of the bearer objects available in the modem.
+ *
+ * Returns: (transfer none): The DBus paths of the bearers, or %NULL if none
+ * available. Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.18
+ */
+const gchar * const *
+mm_modem_snapshot_get_bearer_paths (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return (const gchar * const *) self->priv->bearer_paths;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_modem_snapshot_has_3gpp:
+ * @self: A #MMModemSnapshot.
+ *
+ * Checks whether the modem exposed the 3GPP interface when the snapshot was
+ * taken. If not, all the 3GPP specific getters return the default values.
+ *
+ * Returns: %TRUE if the 3GPP interface was available, %FALSE otherwise.
+ *
+ * Since: 1.18
+ */
+gboolean
+mm_modem_snapshot_has_3gpp (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), FALSE);
+
+    return self->priv->has_3gpp;
+}
+
+/**
+ * mm_modem_snapshot_get_registration_state:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the registration state of the modem in the 3GPP network.
+ *
+ * Returns: A #MMModem3gppRegistrationState value.
+ *
+ * Since: 1.18
+ */
+MMModem3gppRegistrationState
+mm_modem_snapshot_get_registration_state (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), MM_MODEM_3GPP_REGISTRATION_STATE_UNKNOWN);
+
+    return self->priv->registration_state;
+}
+
+/**
+ * mm_modem_snapshot_get_operator_code:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the code of the operator to which the modem is connected, in
+ * MCCMNC format.
+ *
+ * Returns: (transfer none): The operator code, or %NULL if none available.
+ * Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.18
+ */
+const gchar *
+mm_modem_snapshot_get_operator_code (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->operator_code;
+}
+
+/**
+ * mm_modem_snapshot_get_operator_name:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the name of the operator to which the modem is connected.
+ *
+ * Returns: (transfer none): The operator name, or %NULL if none available.
+ * Do not free the returned value, it belongs to @self.
+ *
+ * Since: 1.18
+ */
+const gchar *
+mm_modem_snapshot_get_operator_name (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->operator_name;
+}
+
+/**
+ * mm_modem_snapshot_get_imei:
+ * @self: A #MMModemSnapshot.
+ *
+ * Gets the IMEI, as reported by the 3GPP modem.
+ *
+ * Returns: (transfer none): The IMEI, or %NULL if none available. Do not
+ * free the returned value, it belongs to @self.
+ *
+ * Since: 1.18
+ */
+const gchar *
+mm_modem_snapshot_get_imei (MMModemSnapshot *self)
+{
+    g_return_val_if_fail (MM_IS_MODEM_SNAPSHOT (self), NULL);
+
+    return self->priv->imei;
+}
+
+/*****************************************************************************/
+
+/**
+ * mm_modem_snapshot_new_from_object: (skip)
+ */
+MMModemSnapshot *
+mm_modem_snapshot_new_from_object (MMObject *object)
+{
+    MMModemSnapshot *self;
+    MMModem         *modem;
+    MMModem3gpp     *modem_3gpp;
+
+    g_return_val_if_fail (MM_IS_OBJECT (object), NULL);
+
+    modem = mm_object_peek_modem (object);
+    if (!modem)
+        return NULL;
+
+    self = g_object_new (MM_TYPE_MODEM_SNAPSHOT, NULL);
+    self->priv->path = mm_object_dup_path (object);
+    self->priv->state = mm_modem_get_state (modem);
+    self->priv->state_failed_reason = mm_modem_get_state_failed_reason (modem);
+    self->priv->power_state = mm_modem_get_power_state (modem);
+    self->priv->access_technologies = mm_modem_get_access_technologies (modem);
+    self->priv->signal_quality = mm_modem_get_signal_quality (modem, &self->priv->signal_quality_recent);
+    self->priv->unlock_required = mm_modem_get_unlock_required (modem);
+    self->priv->manufacturer = mm_modem_dup_manufacturer (modem);
+    self->priv->model = mm_modem_dup_model (modem);
+    self->priv->revision = mm_modem_dup_revision (modem);
+    self->priv->equipment_identifier = mm_modem_dup_equipment_identifier (modem);
+    self->priv->sim_path = mm_modem_dup_sim_path (modem);
+    self->priv->bearer_paths = mm_modem_dup_bearer_paths (modem);
+
+    self->priv->registration_state = MM_MODEM_3GPP_REGISTRATION_STATE_UNKNOWN;
+    modem_3gpp = mm_object_peek_modem_3gpp (object);
+    if (modem_3gpp) {
+        self->priv->has_3gpp = TRUE;
+        self->priv->registration_state = mm_modem_3gpp_get_registration_state (modem_3gpp);
+        self->priv->operator_code = mm_modem_3gpp_dup_operator_code (modem_3gpp);
+        self->priv->operator_name = mm_modem_3gpp_dup_operator_name (modem_3gpp);
+        self->priv->imei = mm_modem_3gpp_dup_imei (modem_3gpp);
+    }
+
+    return self;
+}
+
+/*****************************************************************************/
+
+static void
+mm_modem_snapshot_init (MMModemSnapshot *self)
+{
+    self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
+                                              MM_TYPE_MODEM_SNAPSHOT,
+                                              MMModemSnapshotPrivate);
+}
+
+static void
+finalize (GObject *object)
+{
+    MMModemSnapshot *self = MM_MODEM_SNAPSHOT (object);
+
+    g_free (self->priv->path);
+    g_free (self->priv->manufacturer);
+    g_free (self->priv->model);
+    g_free (self->priv->revision);
+    g_free (self->priv->equipment_identifier);
+    g_free (self->priv->sim_path);
+    g_strfreev (self->priv->bearer_paths);
+    g_free (self->priv->operator_code);
+    g_free (self->priv->operator_name);
+    g_free (self->priv->imei);
+
+    G_OBJECT_CLASS (mm_modem_snapshot_parent_class)->finalize (object);
+}
+
+static void
+mm_modem_snapshot_class_init (MMModemSnapshotClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    g_type_class_add_private (object_class, sizeof (MMModemSnapshotPrivate));
+
+    object_class->finalize = finalize;
+}
@@ -0,0 +1,98 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#ifndef MM_MODEM_SNAPSHOT_H
+#define MM_MODEM_SNAPSHOT_H
+
+#if !defined (__LIBMM_GLIB_H_INSIDE__) && !defined (LIBMM_GLIB_COMPILATION)
+#error "Only <libmm-glib.h> can be included directly."
+#endif
+
+#include <ModemManager.h>
+#include <glib-object.h>
+
+#include "mm-object.h"
+
+G_BEGIN_DECLS
+
+#define MM_TYPE_MODEM_SNAPSHOT            (mm_modem_snapshot_get_type ())
+#define MM_MODEM_SNAPSHOT(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), MM_TYPE_MODEM_SNAPSHOT, MMModemSnapshot))
+#define MM_MODEM_SNAPSHOT_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass),  MM_TYPE_MODEM_SNAPSHOT, MMModemSnapshotClass))
+#define MM_IS_MODEM_SNAPSHOT(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), MM_TYPE_MODEM_SNAPSHOT))
+#define MM_IS_MODEM_SNAPSHOT_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass),  MM_TYPE_MODEM_SNAPSHOT))
+#define MM_MODEM_SNAPSHOT_GET_CLASS(obj)  (G_TYPE_INSTANCE_GET_CLASS ((obj),  MM_TYPE_MODEM_SNAPSHOT, MMModemSnapshotClass))
+
+typedef struct _MMModemSnapshot MMModemSnapshot;
+typedef struct _MMModemSnapshotClass MMModemSnapshotClass;
+typedef struct _MMModemSnapshotPrivate MMModemSnapshotPrivate;
+
+/**
+ * MMModemSnapshot:
+ *
+ * The #MMModemSnapshot structure contains private data and should
+ * only be accessed using the provided API.
+ */
+struct _MMModemSnapshot {
+    /*< private >*/
+    GObject parent;
+    MMModemSnapshotPrivate *priv;
+};
+
+struct _MMModemSnapshotClass {
+    /*< private >*/
+    GObjectClass parent;
+};
+
+GType mm_modem_snapshot_get_type (void);
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMModemSnapshot, g_object_unref)
+
+const gchar              *mm_modem_snapshot_get_path                 (MMModemSnapshot *self);
+
+MMModemState              mm_modem_snapshot_get_state                (MMModemSnapshot *self);
+MMModemStateFailedReason  mm_modem_snapshot_get_state_failed_reason  (MMModemSnapshot *self);
+MMModemPowerState         mm_modem_snapshot_get_power_state          (MMModemSnapshot *self);
+MMModemAccessTechnology   mm_modem_snapshot_get_access_technologies  (MMModemSnapshot *self);
+guint                     mm_modem_snapshot_get_signal_quality       (MMModemSnapshot *self,
+                                                                      gboolean        *recent);
+MMModemLock               mm_modem_snapshot_get_unlock_required      (MMModemSnapshot *self);
+
+const gchar              *mm_modem_snapshot_get_manufacturer         (MMModemSnapshot *self);
+const gchar              *mm_modem_snapshot_get_model                (MMModemSnapshot *self);
+const gchar              *mm_modem_snapshot_get_revision             (MMModemSnapshot *self);
+const gchar              *mm_modem_snapshot_get_equipment_identifier (MMModemSnapshot *self);
+
+const gchar              *mm_modem_snapshot_get_sim_path             (MMModemSnapshot *self);
+const gchar * const      *mm_modem_snapshot_get_bearer_paths         (MMModemSnapshot *self);
+
+gboolean                  mm_modem_snapshot_has_3gpp                 (MMModemSnapshot *self);
+MMModem3gppRegistrationState mm_modem_snapshot_get_registration_state (MMModemSnapshot *self);
+const gchar              *mm_modem_snapshot_get_operator_code        (MMModemSnapshot *self);
+const gchar              *mm_modem_snapshot_get_operator_name        (MMModemSnapshot *self);
+const gchar              *mm_modem_snapshot_get_imei                 (MMModemSnapshot *self);
+
+/*****************************************************************************/
+/* ModemManager/libmm-glib/mmcli specific methods */
+
+#if defined (_LIBMM_INSIDE_MM) ||    \
+    defined (_LIBMM_INSIDE_MMCLI) || \
+    defined (LIBMM_GLIB_COMPILATION)
+
+MMModemSnapshot *mm_modem_snapshot_new_from_object (MMObject *object);
+
+#endif
+
+G_END_DECLS
+
+#endif /* MM_MODEM_SNAPSHOT_H */
@@ -0,0 +1,374 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <glib.h>
+#include <gio/gio.h>
+#include <locale.h>
+#include <string.h>
+
+#include <libmm-glib.h>
+
+#define N_MODEMS 32
+
+/*****************************************************************************/
+/* Mock daemon exposing N_MODEMS modems in a private bus, and a client
+ * manager for it, all running in the main thread over separate
+ * connections */
+
+typedef struct {
+    GTestDBus                *dbus;
+    GDBusConnection          *server_connection;
+    GDBusConnection          *client_connection;
+    GDBusObjectManagerServer *object_manager;
+    MmGdbusModem             *modems[N_MODEMS];
+    MmGdbusModem3gpp         *modems_3gpp[N_MODEMS];
+    guint                     name_id;
+    gboolean                  name_acquired;
+    MMManager                *manager;
+} Fixture;
+
+static GDBusConnection *
+connection_new (Fixture *fixture)
+{
+    GDBusConnection *connection;
+    GError          *error = NULL;
+
+    connection = g_dbus_connection_new_for_address_sync (g_test_dbus_get_bus_address (fixture->dbus),
+                                                         (G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+                                                          G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION),
+                                                         NULL, NULL, &error);
+    g_assert_no_error (error);
+    g_assert (connection);
+    return connection;
+}
+
+static void
+name_acquired_cb (GDBusConnection *connection,
+                  const gchar     *name,
+                  Fixture         *fixture)
+{
+    fixture->name_acquired = TRUE;
+}
+
+static void
+manager_new_ready (GObject      *source,
+                   GAsyncResult *res,
+                   Fixture      *fixture)
+{
+    GError *error = NULL;
+
+    fixture->manager = mm_manager_new_finish (res, &error);
+    g_assert_no_error (error);
+    g_assert (fixture->manager);
+}
+
+static void
+fixture_setup (Fixture *fixture)
+{
+    guint i;
+
+    fixture->dbus = g_test_dbus_new (G_TEST_DBUS_NONE);
+    g_test_dbus_up (fixture->dbus);
+
+    fixture->server_connection = connection_new (fixture);
+    fixture->object_manager = g_dbus_object_manager_server_new (MM_DBUS_PATH);
+
+    for (i = 0; i < N_MODEMS; i++) {
+        MmGdbusObjectSkeleton *object;
+        g_autofree gchar      *path = NULL;
+        g_autofree gchar      *imei = NULL;
+
+        path = g_strdup_printf (MM_DBUS_MODEM_PREFIX "/%u", i);
+        imei = g_strdup_printf ("3589230000%05u", i);
+        object = mm_gdbus_object_skeleton_new (path);
+
+        fixture->modems[i] = mm_gdbus_modem_skeleton_new ();
+        mm_gdbus_modem_set_state (fixture->modems[i], MM_MODEM_STATE_REGISTERED);
+        mm_gdbus_modem_set_power_state (fixture->modems[i], MM_MODEM_POWER_STATE_ON);
+        mm_gdbus_modem_set_access_technologies (fixture->modems[i], MM_MODEM_ACCESS_TECHNOLOGY_LTE);
+        mm_gdbus_modem_set_signal_quality (fixture->modems[i], g_variant_new ("(ub)", 50, TRUE));
+        mm_gdbus_modem_set_manufacturer (fixture->modems[i], "Mock");
+        mm_gdbus_modem_set_model (fixture->modems[i], "Mock modem");
+        mm_gdbus_modem_set_equipment_identifier (fixture->modems[i], imei);
+        mm_gdbus_object_skeleton_set_modem (object, fixture->modems[i]);
+
+        fixture->modems_3gpp[i] = mm_gdbus_modem3gpp_skeleton_new ();
+        mm_gdbus_modem3gpp_set_imei (fixture->modems_3gpp[i], imei);
+        mm_gdbus_modem3gpp_set_registration_state (fixture->modems_3gpp[i], MM_MODEM_3GPP_REGISTRATION_STATE_HOME);
+        mm_gdbus_modem3gpp_set_operator_code (fixture->modems_3gpp[i], "21403");
+        mm_gdbus_modem3gpp_set_operator_name (fixture->modems_3gpp[i], "Mock operator");
+        mm_gdbus_object_skeleton_set_modem3gpp (object, fixture->modems_3gpp[i]);
+
+        g_dbus_object_manager_server_export (fixture->object_manager, G_DBUS_OBJECT_SKELETON (object));
+        g_object_unref (object);
+    }
+    g_dbus_object_manager_server_set_connection (fixture->object_manager, fixture->server_connection);
+
+    fixture->name_id = g_bus_own_name_on_connection (fixture->server_connection,
+                                                     MM_DBUS_SERVICE,
+                                                     G_BUS_NAME_OWNER_FLAGS_NONE,
+                                                     (GBusNameAcquiredCallback) name_acquired_cb,
+                                                     NULL,
+                                                     fixture,
+                                                     NULL);
+    while (!fixture->name_acquired)
+        g_main_context_iteration (NULL, TRUE);
+
+    fixture->client_connection = connection_new (fixture);
+    mm_manager_new (fixture->client_connection,
+                    G_DBUS_OBJECT_MANAGER_CLIENT_FLAGS_DO_NOT_AUTO_START,
+                    NULL,
+                    (GAsyncReadyCallback) manager_new_ready,
+                    fixture);
+    while (!fixture->manager)
+        g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+fixture_teardown (Fixture *fixture)
+{
+    guint i;
+
+    g_object_unref (fixture->manager);
+    g_bus_unown_name (fixture->name_id);
+    for (i = 0; i < N_MODEMS; i++) {
+        g_object_unref (fixture->modems[i]);
+        g_object_unref (fixture->modems_3gpp[i]);
+    }
+    g_object_unref (fixture->object_manager);
+    g_dbus_connection_close_sync (fixture->client_connection, NULL, NULL);
+    g_object_unref (fixture->client_connection);
+    g_dbus_connection_close_sync (fixture->server_connection, NULL, NULL);
+    g_object_unref (fixture->server_connection);
+
+    g_test_dbus_down (fixture->dbus);
+    g_object_unref (fixture->dbus);
+}
+
+/* Runs the main context until the client has seen the last change done in
+ * the mock modem */
+static void
+wait_operator_name (Fixture     *fixture,
+                    guint        i,
+                    const gchar *operator_name)
+{
+    g_autofree gchar *path = NULL;
+    g_autoptr(MMObject) object = NULL;
+
+    path = g_strdup_printf (MM_DBUS_MODEM_PREFIX "/%u", i);
+    object = MM_OBJECT (g_dbus_object_manager_get_object (G_DBUS_OBJECT_MANAGER (fixture->manager), path));
+    g_assert (object);
+
+    while (g_strcmp0 (mm_modem_3gpp_get_operator_name (mm_object_peek_modem_3gpp (object)), operator_name) != 0)
+        g_main_context_iteration (NULL, TRUE);
+}
+
+/*****************************************************************************/
+
+static void
+test_snapshot_contents (void)
+{
+    Fixture          fixture = { 0 };
+    GList           *snapshots;
+    MMModemSnapshot *snapshot;
+    gboolean         recent = FALSE;
+
+    fixture_setup (&fixture);
+
+    snapshots = mm_manager_snapshot (fixture.manager);
+    g_assert_cmpuint (g_list_length (snapshots), ==, N_MODEMS);
+
+    /* Sorted by path */
+    snapshot = snapshots->data;
+    g_assert_cmpstr (mm_modem_snapshot_get_path (snapshot), ==, MM_DBUS_MODEM_PREFIX "/0");
+    g_assert_cmpstr (mm_modem_snapshot_get_path (snapshots->next->data), ==, MM_DBUS_MODEM_PREFIX "/1");
+
+    g_assert_cmpuint (mm_modem_snapshot_get_state (snapshot), ==, MM_MODEM_STATE_REGISTERED);
+    g_assert_cmpuint (mm_modem_snapshot_get_power_state (snapshot), ==, MM_MODEM_POWER_STATE_ON);
+    g_assert_cmpuint (mm_modem_snapshot_get_access_technologies (snapshot), ==, MM_MODEM_ACCESS_TECHNOLOGY_LTE);
+    g_assert_cmpuint (mm_modem_snapshot_get_signal_quality (snapshot, &recent), ==, 50);
+    g_assert (recent);
+    g_assert_cmpstr (mm_modem_snapshot_get_manufacturer (snapshot), ==, "Mock");
+    g_assert_cmpstr (mm_modem_snapshot_get_model (snapshot), ==, "Mock modem");
+    g_assert_cmpstr (mm_modem_snapshot_get_equipment_identifier (snapshot), ==, "358923000000000");
+    g_assert (mm_modem_snapshot_has_3gpp (snapshot));
+    g_assert_cmpuint (mm_modem_snapshot_get_registration_state (snapshot), ==, MM_MODEM_3GPP_REGISTRATION_STATE_HOME);
+    g_assert_cmpstr (mm_modem_snapshot_get_operator_code (snapshot), ==, "21403");
+    g_assert_cmpstr (mm_modem_snapshot_get_operator_name (snapshot), ==, "Mock operator");
+    g_assert_cmpstr (mm_modem_snapshot_get_imei (snapshot), ==, "358923000000000");
+
+    g_list_free_full (snapshots, g_object_unref);
+    fixture_teardown (&fixture);
+}
+
+static void
+test_snapshot_reuse (void)
+{
+    Fixture  fixture = { 0 };
+    GList   *first;
+    GList   *second;
+    GList   *third;
+    GList   *l1;
+    GList   *l2;
+    guint    n_changed;
+
+    fixture_setup (&fixture);
+
+    /* Nothing changed, same snapshots */
+    first = mm_manager_snapshot (fixture.manager);
+    second = mm_manager_snapshot (fixture.manager);
+    for (l1 = first, l2 = second; l1 && l2; l1 = g_list_next (l1), l2 = g_list_next (l2))
+        g_assert (l1->data == l2->data);
+    g_assert (!l1 && !l2);
+
+    /* Only the modified modem gets a new snapshot, and the previous one
+     * is left untouched */
+    mm_gdbus_modem3gpp_set_operator_name (fixture.modems_3gpp[3], "Other operator");
+    wait_operator_name (&fixture, 3, "Other operator");
+
+    third = mm_manager_snapshot (fixture.manager);
+    for (n_changed = 0, l1 = second, l2 = third; l1 && l2; l1 = g_list_next (l1), l2 = g_list_next (l2)) {
+        if (l1->data == l2->data)
+            continue;
+        n_changed++;
+        g_assert_cmpstr (mm_modem_snapshot_get_path (l2->data), ==, MM_DBUS_MODEM_PREFIX "/3");
+        g_assert_cmpstr (mm_modem_snapshot_get_operator_name (l1->data), ==, "Mock operator");
+        g_assert_cmpstr (mm_modem_snapshot_get_operator_name (l2->data), ==, "Other operator");
+    }
+    g_assert_cmpuint (n_changed, ==, 1);
+
+    g_list_free_full (first, g_object_unref);
+    g_list_free_full (second, g_object_unref);
+    g_list_free_full (third, g_object_unref);
+    fixture_teardown (&fixture);
+}
+
+/*****************************************************************************/
+/* Benchmark: client polling the status of all modems at 1Hz, while one of
+ * them keeps changing */
+
+#define BENCHMARK_POLLS 1000
+
+static guint
+poll_with_getters (MMManager *manager)
+{
+    GList *objects;
+    GList *l;
+    guint  total = 0;
+
+    objects = g_dbus_object_manager_get_objects (G_DBUS_OBJECT_MANAGER (manager));
+    for (l = objects; l; l = g_list_next (l)) {
+        g_autoptr(MMModem)     modem = NULL;
+        g_autoptr(MMModem3gpp) modem_3gpp = NULL;
+        g_autofree gchar      *model = NULL;
+        g_autofree gchar      *operator_name = NULL;
+
+        modem = mm_object_get_modem (MM_OBJECT (l->data));
+        modem_3gpp = mm_object_get_modem_3gpp (MM_OBJECT (l->data));
+        model = mm_modem_dup_model (modem);
+        operator_name = mm_modem_3gpp_dup_operator_name (modem_3gpp);
+        total += mm_modem_get_state (modem);
+        total += mm_modem_get_signal_quality (modem, NULL);
+        total += mm_modem_3gpp_get_registration_state (modem_3gpp);
+        total += strlen (model) + strlen (operator_name);
+    }
+    g_list_free_full (objects, g_object_unref);
+    return total;
+}
+
+static guint
+poll_with_snapshot (MMManager *manager)
+{
+    GList *snapshots;
+    GList *l;
+    guint  total = 0;
+
+    snapshots = mm_manager_snapshot (manager);
+    for (l = snapshots; l; l = g_list_next (l)) {
+        MMModemSnapshot *snapshot = l->data;
+
+        total += mm_modem_snapshot_get_state (snapshot);
+        total += mm_modem_snapshot_get_signal_quality (snapshot, NULL);
+        total += mm_modem_snapshot_get_registration_state (snapshot);
+        total += strlen (mm_modem_snapshot_get_model (snapshot));
+        total += strlen (mm_modem_snapshot_get_operator_name (snapshot));
+    }
+    g_list_free_full (snapshots, g_object_unref);
+    return total;
+}
+
+static gdouble
+run_polls (Fixture *fixture,
+           guint  (*poll) (MMManager *))
+{
+    GTimer *timer;
+    gdouble elapsed = 0;
+    guint   i;
+
+    timer = g_timer_new ();
+    for (i = 0; i < BENCHMARK_POLLS; i++) {
+        /* The change in the modem is not accounted, only the polling */
+        mm_gdbus_modem_set_signal_quality (fixture->modems[0], g_variant_new ("(ub)", i % 100, TRUE));
+        while (g_main_context_iteration (NULL, FALSE));
+
+        g_timer_start (timer);
+        g_assert_cmpuint (poll (fixture->manager), >, 0);
+        elapsed += g_timer_elapsed (timer, NULL);
+    }
+    g_timer_destroy (timer);
+    return elapsed;
+}
+
+static void
+test_snapshot_benchmark (void)
+{
+    Fixture fixture = { 0 };
+    gdouble getters;
+    gdouble snapshot;
+
+    if (!g_test_perf ()) {
+        g_test_skip ("Benchmark only run in perf mode");
+        return;
+    }
+
+    fixture_setup (&fixture);
+
+    getters = run_polls (&fixture, poll_with_getters);
+    snapshot = run_polls (&fixture, poll_with_snapshot);
+
+    g_test_message ("%u polls of %u modems: %.3lf ms per poll with getters, %.3lf ms per poll with snapshots",
+                    BENCHMARK_POLLS, N_MODEMS,
+                    1000.0 * getters / BENCHMARK_POLLS,
+                    1000.0 * snapshot / BENCHMARK_POLLS);
+    g_test_minimized_result (1000.0 * snapshot / BENCHMARK_POLLS, "%.3lf ms per snapshot poll",
+                             1000.0 * snapshot / BENCHMARK_POLLS);
+
+    fixture_teardown (&fixture);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/manager/snapshot/contents",  test_snapshot_contents);
+    g_test_add_func ("/MM/manager/snapshot/reuse",     test_snapshot_reuse);
+    g_test_add_func ("/MM/manager/snapshot/benchmark", test_snapshot_benchmark);
+
+    return g_test_run ();
+}
@@ -858,9 +858,9 @@ modem_3gpp_cleanup_unsolicited_events (MMIfaceModem3gpp *self,
 /* Enabling unsolicited events (3GPP interface) */
 
 static const MMBaseModemAtCommand unsolicited_events_enable_sequence[] = {
-    { "%STATCM=1",                  10, FALSE, mm_base_modem_response_processor_no_result_continue },
-    { "%NOTIFYEV=\"SIMREFRESH\",1", 10, FALSE, NULL },
-    { "%PCOINFO=1",                 10, FALSE, NULL },
+    { "%STATCM=1",                  10, FALSE, mm_base_modem_response_processor_no_result_continue, TRUE },
+    { "%NOTIFYEV=\"SIMREFRESH\",1", 10, FALSE, NULL,                                                TRUE },
+    { "%PCOINFO=1",                 10, FALSE, NULL,                                                TRUE },
     { NULL }
 };
 
@@ -930,9 +930,9 @@ modem_3gpp_enable_unsolicited_events (MMIfaceModem3gpp *self,
 /* Disabling unsolicited events (3GPP interface) */
 
 static const MMBaseModemAtCommand unsolicited_events_disable_sequence[] = {
-  { "%STATCM=0", 10, FALSE, NULL },
-  { "%NOTIFYEV=\"SIMREFRESH\",0", 10, FALSE, NULL },
-  { "%PCOINFO=0", 10, FALSE, NULL },
+  { "%STATCM=0", 10, FALSE, NULL, TRUE },
+  { "%NOTIFYEV=\"SIMREFRESH\",0", 10, FALSE, NULL, TRUE },
+  { "%PCOINFO=0", 10, FALSE, NULL, TRUE },
   { NULL }
 };
 
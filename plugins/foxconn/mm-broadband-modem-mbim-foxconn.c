@@ -112,12 +112,13 @@ fcc_unlock (MMIfaceModem        *self,
 
     input = qmi_message_dms_foxconn_set_fcc_authentication_input_new ();
     qmi_message_dms_foxconn_set_fcc_authentication_input_set_value (input, 0x00, NULL);
-    qmi_client_dms_foxconn_set_fcc_authentication (QMI_CLIENT_DMS (client),
-                                                   input,
-                                                   5,
-                                                   NULL,
-                                                   (GAsyncReadyCallback)dms_foxconn_set_fcc_authentication_ready,
-                                                   task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_foxconn_set_fcc_authentication,
+                                QMI_CLIENT_DMS (client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)dms_foxconn_set_fcc_authentication_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -213,13 +214,13 @@ firmware_load_update_settings (MMIfaceModemFirmware *self,
             input,
             QMI_DMS_FOXCONN_FIRMWARE_VERSION_TYPE_FIRMWARE_MCFG,
             NULL);
-    qmi_client_dms_foxconn_get_firmware_version (
-        QMI_CLIENT_DMS (client),
-        input,
-        10,
-        NULL,
-        (GAsyncReadyCallback)foxconn_get_firmware_version_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_foxconn_get_firmware_version,
+                                QMI_CLIENT_DMS (client),
+                                input,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback)foxconn_get_firmware_version_ready,
+                                task);
     qmi_message_dms_foxconn_get_firmware_version_input_unref (input);
 }
 
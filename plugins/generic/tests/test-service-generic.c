@@ -13,11 +13,13 @@
  * Copyright (C) 2016 Aleksander Morgado <aleksander@gnu.org>
  */
 
+#include <config.h>
 #include <sys/types.h>
 #include <unistd.h>
 
 #include <glib.h>
 #include <glib-object.h>
+#include <glib/gstdio.h>
 
 #include <libmm-glib.h>
 
@@ -79,12 +81,834 @@ test_enable_disable (TestFixture *fixture)
 
 /*****************************************************************************/
 
+static gboolean
+wait_timeout_cb (GMainLoop *loop)
+{
+    g_main_loop_quit (loop);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+wait_seconds (guint seconds)
+{
+    GMainLoop *loop;
+
+    loop = g_main_loop_new (NULL, FALSE);
+    g_timeout_add_seconds (seconds, (GSourceFunc) wait_timeout_cb, loop);
+    g_main_loop_run (loop);
+    g_main_loop_unref (loop);
+}
+
+static void
+wait_ms (guint ms)
+{
+    GMainLoop *loop;
+
+    loop = g_main_loop_new (NULL, FALSE);
+    g_timeout_add (ms, (GSourceFunc) wait_timeout_cb, loop);
+    g_main_loop_run (loop);
+    g_main_loop_unref (loop);
+}
+
+#define N_RINGS 6
+
+static void
+test_voice_incoming_call_urcs (TestFixture *fixture)
+{
+    GError *error = NULL;
+    MMObject *obj;
+    MMModem *modem;
+    MMModemVoice *voice;
+    GList *calls;
+    TestPortContext *port0;
+    gchar *ports [] = { NULL, NULL };
+    guint i;
+
+    ports[0] = g_strdup_printf ("abstract:port0:%ld", (glong) getpid ());
+    g_debug ("test service generic: using abstract port at '%s'", ports[0]);
+
+    /* Setup new port context, with voice support and a single incoming
+     * call reported in +CLCC */
+    port0 = test_port_context_new (ports[0]);
+    test_port_context_load_commands (port0, COMMON_GSM_PORT_CONF);
+    test_port_context_set_command (port0, "ATH",       "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CLCC=?", "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CLIP=1", "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CRC=1",  "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CCWA=1", "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CLCC",   "\r\n+CLCC: 1,1,4,0,0,\"600000000\",129\r\n\r\nOK\r\n");
+    test_port_context_start (port0);
+
+    test_fixture_no_modem (fixture);
+    test_fixture_set_profile (fixture,
+                              "test-voice-incoming-call-urcs",
+                              "generic",
+                              (const gchar *const *)ports);
+
+    obj = test_fixture_get_modem (fixture);
+    modem = mm_object_get_modem (obj);
+    g_assert (modem != NULL);
+    mm_modem_enable_sync (modem, NULL, &error);
+    g_assert_no_error (error);
+
+    voice = mm_object_get_modem_voice (obj);
+    g_assert (voice != NULL);
+
+    /* Replay a ringing incoming call: the RING URCs are not call state
+     * updates, so the periodic +CLCC polling must keep running. */
+    for (i = 0; i < N_RINGS; i++) {
+        test_port_context_send_unsolicited (port0, "\r\nRING\r\n");
+        wait_seconds (1);
+    }
+
+    calls = mm_modem_voice_list_calls_sync (voice, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpuint (g_list_length (calls), ==, 1);
+    g_assert_cmpuint (mm_call_get_state (MM_CALL (calls->data)), ==, MM_CALL_STATE_RINGING_IN);
+    g_list_free_full (calls, g_object_unref);
+
+    /* Periodic polling every 2s runs N_RINGS/2 times */
+    g_debug ("call list polled %u times", test_port_context_get_command_count (port0, "AT+CLCC"));
+    g_assert_cmpuint (test_port_context_get_command_count (port0, "AT+CLCC"), >=, (N_RINGS / 2) - 1);
+
+    mm_modem_disable_sync (modem, NULL, &error);
+    g_assert_no_error (error);
+
+    g_object_unref (voice);
+    g_object_unref (modem);
+    g_object_unref (obj);
+
+    test_port_context_stop (port0);
+    test_port_context_free (port0);
+
+    g_free (ports[0]);
+}
+
+#define OUTGOING_CALL_TIMEOUT_SECS 10
+
+static void
+test_voice_outgoing_call_polling (TestFixture *fixture)
+{
+    GError *error = NULL;
+    MMObject *obj;
+    MMModem *modem;
+    MMModemVoice *voice;
+    MMCall *call;
+    MMCallProperties *properties;
+    TestPortContext *port0;
+    gchar *ports [] = { NULL, NULL };
+    guint i;
+
+    ports[0] = g_strdup_printf ("abstract:port0:%ld", (glong) getpid ());
+    g_debug ("test service generic: using abstract port at '%s'", ports[0]);
+
+    /* Setup new port context, with voice support and a single outgoing
+     * active call reported in +CLCC; the port never sends call progress
+     * URCs, so the call can only become active via call list polling */
+    port0 = test_port_context_new (ports[0]);
+    test_port_context_load_commands (port0, COMMON_GSM_PORT_CONF);
+    test_port_context_set_command (port0, "AT+CHUP",       "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CLCC=?",     "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CLIP=1",     "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CRC=1",      "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CCWA=1",     "\r\nOK\r\n");
+    test_port_context_set_command (port0, "ATD600000001;", "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CLCC",       "\r\n+CLCC: 1,0,0,0,0,\"600000001\",129\r\n\r\nOK\r\n");
+    test_port_context_start (port0);
+
+    test_fixture_no_modem (fixture);
+    test_fixture_set_profile (fixture,
+                              "test-voice-outgoing-call-polling",
+                              "generic",
+                              (const gchar *const *)ports);
+
+    obj = test_fixture_get_modem (fixture);
+    modem = mm_object_get_modem (obj);
+    g_assert (modem != NULL);
+    mm_modem_enable_sync (modem, NULL, &error);
+    g_assert_no_error (error);
+
+    voice = mm_object_get_modem_voice (obj);
+    g_assert (voice != NULL);
+
+    properties = mm_call_properties_new ();
+    mm_call_properties_set_number (properties, "600000001");
+    call = mm_modem_voice_create_call_sync (voice, properties, NULL, &error);
+    g_assert_no_error (error);
+    g_assert (call != NULL);
+    g_object_unref (properties);
+
+    mm_call_start_sync (call, NULL, &error);
+    g_assert_no_error (error);
+
+    /* The call must become active with the short polling interval, not with
+     * the long one used when the modem reports call state URCs */
+    for (i = 0; i < OUTGOING_CALL_TIMEOUT_SECS && mm_call_get_state (call) != MM_CALL_STATE_ACTIVE; i++)
+        wait_seconds (1);
+    g_debug ("call list polled %u times", test_port_context_get_command_count (port0, "AT+CLCC"));
+    g_assert_cmpuint (mm_call_get_state (call), ==, MM_CALL_STATE_ACTIVE);
+    g_assert_cmpuint (test_port_context_get_command_count (port0, "AT+CLCC"), >=, 1);
+
+    mm_call_hangup_sync (call, NULL, &error);
+    g_assert_no_error (error);
+
+    mm_modem_disable_sync (modem, NULL, &error);
+    g_assert_no_error (error);
+
+    g_object_unref (call);
+    g_object_unref (voice);
+    g_object_unref (modem);
+    g_object_unref (obj);
+
+    test_port_context_stop (port0);
+    test_port_context_free (port0);
+
+    g_free (ports[0]);
+}
+
+/*****************************************************************************/
+
+#if defined ENABLE_PLUGIN_HUAWEI
+
+#define CALL_PROGRESS_TIMEOUT_SECS 5
+
+static void
+wait_call_state (MMCall      *call,
+                 MMCallState  state)
+{
+    guint i;
+
+    for (i = 0; i < CALL_PROGRESS_TIMEOUT_SECS && mm_call_get_state (call) != state; i++)
+        wait_seconds (1);
+    g_assert_cmpuint (mm_call_get_state (call), ==, state);
+}
+
+static void
+test_voice_call_progress_urcs (TestFixture *fixture)
+{
+    GError *error = NULL;
+    MMObject *obj;
+    MMModem *modem;
+    MMModemVoice *voice;
+    MMCall *call;
+    MMCallProperties *properties;
+    TestPortContext *port0;
+    gchar *ports [] = { NULL, NULL };
+
+    ports[0] = g_strdup_printf ("abstract:port0:%ld", (glong) getpid ());
+    g_debug ("test service generic: using abstract port at '%s'", ports[0]);
+
+    /* Setup new port context, with voice support; the generic modem doesn't
+     * parse any indexed call progress URC, so the Huawei one is used, which
+     * reports the call state updates with ^ORIG/^CONF/^CONN/^CEND */
+    port0 = test_port_context_new (ports[0]);
+    test_port_context_load_commands (port0, COMMON_GSM_PORT_CONF);
+    test_port_context_set_command (port0, "AT+CHUP",       "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CLCC=?",     "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CLIP=1",     "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CRC=1",      "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CCWA=1",     "\r\nOK\r\n");
+    test_port_context_set_command (port0, "ATD600000002;", "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CLCC",       "\r\n+CLCC: 1,0,2,0,0,\"600000002\",129\r\n\r\nOK\r\n");
+    test_port_context_start (port0);
+
+    test_fixture_no_modem (fixture);
+    test_fixture_set_profile (fixture,
+                              "test-voice-call-progress-urcs",
+                              "huawei",
+                              (const gchar *const *)ports);
+
+    obj = test_fixture_get_modem (fixture);
+    modem = mm_object_get_modem (obj);
+    g_assert (modem != NULL);
+    mm_modem_enable_sync (modem, NULL, &error);
+    g_assert_no_error (error);
+
+    voice = mm_object_get_modem_voice (obj);
+    g_assert (voice != NULL);
+
+    properties = mm_call_properties_new ();
+    mm_call_properties_set_number (properties, "600000002");
+    call = mm_modem_voice_create_call_sync (voice, properties, NULL, &error);
+    g_assert_no_error (error);
+    g_assert (call != NULL);
+    g_object_unref (properties);
+
+    mm_call_start_sync (call, NULL, &error);
+    g_assert_no_error (error);
+
+    /* Replay the full call progress; each step takes longer than the short
+     * call list polling interval, so the call list would be polled in
+     * between if the URCs weren't taken into account */
+    test_port_context_send_unsolicited (port0, "\r\n^ORIG: 1,0\r\n");
+    wait_call_state (call, MM_CALL_STATE_DIALING);
+    wait_seconds (3);
+
+    test_port_context_send_unsolicited (port0, "\r\n^CONF: 1\r\n");
+    wait_call_state (call, MM_CALL_STATE_RINGING_OUT);
+    wait_seconds (3);
+
+    test_port_context_send_unsolicited (port0, "\r\n^CONN: 1,0\r\n");
+    wait_call_state (call, MM_CALL_STATE_ACTIVE);
+    wait_seconds (3);
+
+    test_port_context_send_unsolicited (port0, "\r\n^CEND: 1,9,104,16\r\n");
+    wait_call_state (call, MM_CALL_STATE_TERMINATED);
+    wait_seconds (3);
+
+    /* At most a single poll, if it was scheduled before the first URC */
+    g_debug ("call list polled %u times", test_port_context_get_command_count (port0, "AT+CLCC"));
+    g_assert_cmpuint (test_port_context_get_command_count (port0, "AT+CLCC"), <=, 1);
+
+    mm_modem_disable_sync (modem, NULL, &error);
+    g_assert_no_error (error);
+
+    g_object_unref (call);
+    g_object_unref (voice);
+    g_object_unref (modem);
+    g_object_unref (obj);
+
+    test_port_context_stop (port0);
+    test_port_context_free (port0);
+
+    g_free (ports[0]);
+}
+
+#endif /* ENABLE_PLUGIN_HUAWEI */
+
+/*****************************************************************************/
+
+/* Maximum time to wait for a modem to reach a given state */
+#define WAIT_STATE_TIMEOUT_MS 10000
+
+static void
+wait_modem_state (MMModem      *modem,
+                  MMModemState  state)
+{
+    guint elapsed_ms;
+
+    for (elapsed_ms = 0;
+         mm_modem_get_state (modem) != state && elapsed_ms < WAIT_STATE_TIMEOUT_MS;
+         elapsed_ms += 100)
+        wait_ms (100);
+    g_assert_cmpint (mm_modem_get_state (modem), ==, state);
+}
+
+/* Number of modems to simulate, also when running in perf mode (-m perf) */
+#define N_MODEMS            4
+#define N_MODEMS_PERF       64
+#define COMMAND_LATENCY_MS  10
+
+static void
+test_multiple_modems (TestFixture *fixture)
+{
+    GError           *error = NULL;
+    TestPortContext **port_contexts;
+    gchar           **port_names;
+    GList            *objs;
+    GList            *l;
+    GTimer           *timer;
+    guint             n_modems;
+    guint             i;
+
+    n_modems = g_test_perf () ? N_MODEMS_PERF : N_MODEMS;
+
+    /* One single-port modem per port context, all of them replying with
+     * some latency */
+    port_contexts = g_new0 (TestPortContext *, n_modems);
+    port_names = g_new0 (gchar *, n_modems);
+    for (i = 0; i < n_modems; i++) {
+        port_names[i] = g_strdup_printf ("abstract:port%u:%ld", i, (glong) getpid ());
+        port_contexts[i] = test_port_context_new (port_names[i]);
+        test_port_context_load_commands (port_contexts[i], COMMON_GSM_PORT_CONF);
+        test_port_context_set_latency (port_contexts[i], COMMAND_LATENCY_MS);
+        test_port_context_start (port_contexts[i]);
+    }
+
+    test_fixture_no_modem (fixture);
+
+    timer = g_timer_new ();
+    for (i = 0; i < n_modems; i++) {
+        g_autofree gchar *profile_name = NULL;
+        const gchar      *ports[] = { port_names[i], NULL };
+
+        profile_name = g_strdup_printf ("test-multiple-modems-%u", i);
+        test_fixture_set_profile (fixture, profile_name, "generic", ports);
+    }
+    objs = test_fixture_get_modems (fixture, n_modems);
+    g_test_minimized_result (g_timer_elapsed (timer, NULL),
+                             "%u modems exposed in %.2lfs", n_modems, g_timer_elapsed (timer, NULL));
+
+    g_timer_start (timer);
+    for (l = objs; l; l = g_list_next (l)) {
+        g_autoptr(MMModem) modem = NULL;
+
+        modem = mm_object_get_modem (MM_OBJECT (l->data));
+        g_assert (modem != NULL);
+        mm_modem_enable_sync (modem, NULL, &error);
+        g_assert_no_error (error);
+    }
+    g_test_minimized_result (g_timer_elapsed (timer, NULL),
+                             "%u modems enabled in %.2lfs", n_modems, g_timer_elapsed (timer, NULL));
+
+    /* Keep them busy with registration URCs, all of them must end up
+     * registered */
+    for (i = 0; i < n_modems; i++)
+        test_port_context_schedule_unsolicited (port_contexts[i], "\r\n+CREG: 1\r\n", 1000);
+    for (l = objs; l; l = g_list_next (l)) {
+        g_autoptr(MMModem)     modem = NULL;
+        g_autoptr(MMModem3gpp) modem_3gpp = NULL;
+
+        modem = mm_object_get_modem (MM_OBJECT (l->data));
+        wait_modem_state (modem, MM_MODEM_STATE_REGISTERED);
+        modem_3gpp = mm_object_get_modem_3gpp (MM_OBJECT (l->data));
+        g_assert (modem_3gpp != NULL);
+        g_assert_cmpuint (mm_modem_3gpp_get_registration_state (modem_3gpp), ==, MM_MODEM_3GPP_REGISTRATION_STATE_HOME);
+    }
+
+    for (l = objs; l; l = g_list_next (l)) {
+        g_autoptr(MMModem) modem = NULL;
+
+        modem = mm_object_get_modem (MM_OBJECT (l->data));
+        mm_modem_disable_sync (modem, NULL, &error);
+        g_assert_no_error (error);
+    }
+
+    g_timer_destroy (timer);
+    g_list_free_full (objs, g_object_unref);
+
+    for (i = 0; i < n_modems; i++) {
+        test_port_context_stop (port_contexts[i]);
+        test_port_context_free (port_contexts[i]);
+        g_free (port_names[i]);
+    }
+    g_free (port_contexts);
+    g_free (port_names);
+}
+
+/*****************************************************************************/
+
+static guint
+capability_cache_count_entries (gboolean remove)
+{
+    GDir        *dir;
+    const gchar *name;
+    guint        n_entries = 0;
+
+    dir = g_dir_open (TEST_CAPABILITY_CACHE_DIR, 0, NULL);
+    if (!dir)
+        return 0;
+
+    while ((name = g_dir_read_name (dir)) != NULL) {
+        g_autofree gchar *path = NULL;
+
+        if (!g_str_has_suffix (name, ".keyfile"))
+            continue;
+        n_entries++;
+        if (remove) {
+            path = g_build_filename (TEST_CAPABILITY_CACHE_DIR, name, NULL);
+            g_unlink (path);
+        }
+    }
+    g_dir_close (dir);
+
+    return n_entries;
+}
+
+static GHashTable *
+capability_cache_run (TestFixture *fixture,
+                      const gchar *port_name,
+                      gboolean     with_cache)
+{
+    TestPortContext  *port0;
+    MMObject         *obj;
+    MMModem          *modem;
+    GHashTable       *properties;
+    gchar           **names;
+    const gchar      *ports[] = { port_name, NULL };
+    guint             i;
+
+    port0 = test_port_context_new (port_name);
+    test_port_context_load_commands (port0, COMMON_GSM_PORT_CONF);
+    /* When loaded from the cache, these are never sent to the device */
+    if (with_cache) {
+        test_port_context_set_command (port0, "AT+CGMI", "\r\nERROR\r\n");
+        test_port_context_set_command (port0, "AT+CGMM", "\r\nERROR\r\n");
+    }
+    test_port_context_start (port0);
+
+    test_fixture_no_modem (fixture);
+    test_fixture_set_profile (fixture, "test-capability-cache", "generic", ports);
+
+    obj = test_fixture_get_modem (fixture);
+    modem = mm_object_get_modem (obj);
+    g_assert (modem != NULL);
+
+    properties = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_variant_unref);
+    names = g_dbus_proxy_get_cached_property_names (G_DBUS_PROXY (modem));
+    for (i = 0; names && names[i]; i++)
+        g_hash_table_insert (properties,
+                             g_strdup (names[i]),
+                             g_dbus_proxy_get_cached_property (G_DBUS_PROXY (modem), names[i]));
+    g_strfreev (names);
+
+    g_object_unref (modem);
+    g_object_unref (obj);
+
+    test_port_context_stop (port0);
+    test_port_context_free (port0);
+
+    return properties;
+}
+
+static void
+test_capability_cache (TestFixture *fixture)
+{
+    GHashTable     *properties;
+    GHashTable     *cached_properties;
+    GHashTableIter  iter;
+    gpointer        name;
+    gpointer        value;
+    gchar          *port_name;
+
+    port_name = g_strdup_printf ("abstract:port0:%ld", (glong) getpid ());
+
+    /* The fixture setup starts without cache */
+    g_assert_cmpuint (capability_cache_count_entries (FALSE), ==, 0);
+    properties = capability_cache_run (fixture, port_name, FALSE);
+    g_assert_cmpuint (capability_cache_count_entries (FALSE), ==, 1);
+
+    /* Restart the daemon keeping the cache, so that the same modem is
+     * initialized again */
+    test_fixture_restart (fixture);
+
+    cached_properties = capability_cache_run (fixture, port_name, TRUE);
+
+    /* Exactly the same exported properties */
+    g_assert_cmpuint (g_hash_table_size (cached_properties), ==, g_hash_table_size (properties));
+    g_hash_table_iter_init (&iter, properties);
+    while (g_hash_table_iter_next (&iter, &name, &value)) {
+        GVariant *cached_value;
+
+        cached_value = g_hash_table_lookup (cached_properties, name);
+        g_assert (cached_value != NULL);
+        if (!g_variant_equal (value, cached_value)) {
+            g_autofree gchar *str = NULL;
+            g_autofree gchar *cached_str = NULL;
+
+            str = g_variant_print (value, FALSE);
+            cached_str = g_variant_print (cached_value, FALSE);
+            g_error ("property '%s' differs with cache: '%s' vs '%s'", (const gchar *)name, str, cached_str);
+        }
+    }
+
+    g_hash_table_unref (cached_properties);
+    g_hash_table_unref (properties);
+    capability_cache_count_entries (TRUE);
+    g_free (port_name);
+}
+
+/*****************************************************************************/
+
+#define CGDCONT_PROFILE_1 "+CGDCONT: 1,\"IP\",\"internet\",\"0.0.0.0\",0,0\r\n"
+#define CGDCONT_PROFILE_2 "+CGDCONT: 2,\"IP\",\"test\",\"0.0.0.0\",0,0\r\n"
+#define CGDCONT_PROFILE_3 "+CGDCONT: 3,\"IP\",\"network\",\"0.0.0.0\",0,0\r\n"
+
+/* Lists the profiles, and returns how many times the modem was queried */
+static guint
+profile_list (MMModem3gppProfileManager  *manager,
+              TestPortContext            *port,
+              GList                     **out_profiles)
+{
+    GError *error = NULL;
+    GList  *profiles = NULL;
+    guint   n_queries;
+
+    n_queries = test_port_context_get_command_count (port, "AT+CGDCONT?");
+    mm_modem_3gpp_profile_manager_list_sync (manager, NULL, &profiles, &error);
+    g_assert_no_error (error);
+    n_queries = test_port_context_get_command_count (port, "AT+CGDCONT?") - n_queries;
+
+    if (out_profiles)
+        *out_profiles = profiles;
+    else
+        g_list_free_full (profiles, g_object_unref);
+    return n_queries;
+}
+
+static const gchar *
+profile_list_find_apn (GList *profiles,
+                       gint   profile_id)
+{
+    GList *l;
+
+    for (l = profiles; l; l = g_list_next (l)) {
+        if (mm_3gpp_profile_get_profile_id (MM_3GPP_PROFILE (l->data)) == profile_id)
+            return mm_3gpp_profile_get_apn (MM_3GPP_PROFILE (l->data));
+    }
+    return NULL;
+}
+
+static void
+profile_list_ready (MMModem3gppProfileManager  *manager,
+                    GAsyncResult               *res,
+                    GList                     **out_profiles)
+{
+    GError *error = NULL;
+
+    mm_modem_3gpp_profile_manager_list_finish (manager, res, out_profiles, &error);
+    g_assert_no_error (error);
+}
+
+static void
+test_profile_cache (TestFixture *fixture)
+{
+    GError                    *error = NULL;
+    MMObject                  *obj;
+    MMModem                   *modem;
+    MMModem3gppProfileManager *manager;
+    MM3gppProfile             *profile;
+    MM3gppProfile             *stored;
+    GList                     *profiles = NULL;
+    TestPortContext           *port0;
+    gchar                     *ports [] = { NULL, NULL };
+    guint                      n_queries;
+    guint                      i;
+
+    ports[0] = g_strdup_printf ("abstract:port0:%ld", (glong) getpid ());
+
+    /* A single profile defined, and +CGEV reporting support */
+    port0 = test_port_context_new (ports[0]);
+    test_port_context_load_commands (port0, COMMON_GSM_PORT_CONF);
+    test_port_context_set_command (port0, "AT+CGDCONT?", "\r\n" CGDCONT_PROFILE_1 "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CGACT?",   "\r\n+CGACT: 1,0\r\n+CGACT: 2,0\r\n\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CGEREP=?", "\r\n+CGEREP: (0-2),(0-1)\r\n\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CGEREP=2", "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CGEREP=0", "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CGDCONT=2,\"IP\",\"test\"", "\r\nOK\r\n");
+    test_port_context_set_command (port0, "AT+CGDEL=2", "\r\nOK\r\n");
+    test_port_context_start (port0);
+
+    test_fixture_no_modem (fixture);
+    test_fixture_set_profile (fixture, "test-profile-cache", "generic", (const gchar *const *)ports);
+
+    obj = test_fixture_get_modem (fixture);
+    modem = mm_object_get_modem (obj);
+    g_assert (modem != NULL);
+    mm_modem_enable_sync (modem, NULL, &error);
+    g_assert_no_error (error);
+    manager = mm_object_get_modem_3gpp_profile_manager (obj);
+    g_assert (manager != NULL);
+
+    /* Only the first list queries the modem */
+    g_assert_cmpuint (profile_list (manager, port0, &profiles), ==, 1);
+    g_assert_cmpuint (g_list_length (profiles), ==, 1);
+    g_assert_cmpstr (profile_list_find_apn (profiles, 1), ==, "internet");
+    g_list_free_full (profiles, g_object_unref);
+    g_assert_cmpuint (profile_list (manager, port0, NULL), ==, 0);
+
+    /* A set selects the profile with the cached list; there is no single
+     * profile query in AT modems, so reading it back lists all of them */
+    test_port_context_set_command (port0, "AT+CGDCONT?", "\r\n" CGDCONT_PROFILE_1 CGDCONT_PROFILE_2 "\r\nOK\r\n");
+    profile = mm_3gpp_profile_new ();
+    mm_3gpp_profile_set_profile_id (profile, 2);
+    mm_3gpp_profile_set_apn (profile, "test");
+    mm_3gpp_profile_set_ip_type (profile, MM_BEARER_IP_FAMILY_IPV4);
+    n_queries = test_port_context_get_command_count (port0, "AT+CGDCONT?");
+    stored = mm_modem_3gpp_profile_manager_set_sync (manager, profile, NULL, &error);
+    g_assert_no_error (error);
+    g_assert (stored != NULL);
+    g_assert_cmpuint (test_port_context_get_command_count (port0, "AT+CGDCONT?") - n_queries, ==, 1);
+    g_assert_cmpuint (test_port_context_get_command_count (port0, "AT+CGDCONT=2,\"IP\",\"test\""), ==, 1);
+    g_object_unref (stored);
+
+    /* And the stored profile is served from the cache afterwards */
+    g_assert_cmpuint (profile_list (manager, port0, &profiles), ==, 0);
+    g_assert_cmpuint (g_list_length (profiles), ==, 2);
+    g_assert_cmpstr (profile_list_find_apn (profiles, 2), ==, "test");
+    g_list_free_full (profiles, g_object_unref);
+
+    /* A delete removes the profile from the cache */
+    test_port_context_set_command (port0, "AT+CGDCONT?", "\r\n" CGDCONT_PROFILE_1 "\r\nOK\r\n");
+    mm_modem_3gpp_profile_manager_delete_sync (manager, profile, NULL, &error);
+    g_assert_no_error (error);
+    g_assert_cmpuint (test_port_context_get_command_count (port0, "AT+CGDEL=2"), ==, 1);
+    g_assert_cmpuint (profile_list (manager, port0, &profiles), ==, 0);
+    g_assert_cmpuint (g_list_length (profiles), ==, 1);
+    g_assert (!profile_list_find_apn (profiles, 2));
+    g_list_free_full (profiles, g_object_unref);
+    g_object_unref (profile);
+
+    /* A context defined by the network invalidates the cache */
+    test_port_context_set_command (port0, "AT+CGDCONT?", "\r\n" CGDCONT_PROFILE_1 CGDCONT_PROFILE_3 "\r\nOK\r\n");
+    test_port_context_send_unsolicited (port0, "\r\n+CGEV: NW PDN ACT 3\r\n");
+    for (i = 0; i < 50; i++) {
+        if (profile_list (manager, port0, &profiles) > 0)
+            break;
+        g_list_free_full (profiles, g_object_unref);
+        profiles = NULL;
+        wait_ms (100);
+    }
+    g_assert_cmpuint (i, <, 50);
+    g_assert_cmpuint (g_list_length (profiles), ==, 2);
+    g_assert_cmpstr (profile_list_find_apn (profiles, 3), ==, "network");
+    g_list_free_full (profiles, g_object_unref);
+    profiles = NULL;
+    g_assert_cmpuint (profile_list (manager, port0, NULL), ==, 0);
+
+    /* A list in flight when the profiles change doesn't fill the cache:
+     * invalidate it, and start a slow list, changed while waiting for the
+     * reply */
+    test_port_context_send_unsolicited (port0, "\r\n+CGEV: NW PDN ACT 3\r\n");
+    wait_ms (500);
+    test_port_context_set_command_latency (port0, "AT+CGDCONT?", 1500);
+    n_queries = test_port_context_get_command_count (port0, "AT+CGDCONT?");
+    mm_modem_3gpp_profile_manager_list (manager, NULL, (GAsyncReadyCallback) profile_list_ready, &profiles);
+    wait_ms (500);
+    test_port_context_send_unsolicited (port0, "\r\n+CGEV: NW PDN ACT 3\r\n");
+    while (!profiles)
+        g_main_context_iteration (NULL, TRUE);
+    g_assert_cmpuint (test_port_context_get_command_count (port0, "AT+CGDCONT?") - n_queries, ==, 1);
+    g_list_free_full (profiles, g_object_unref);
+
+    test_port_context_set_command_latency (port0, "AT+CGDCONT?", 0);
+    g_assert_cmpuint (profile_list (manager, port0, NULL), ==, 1);
+    g_assert_cmpuint (profile_list (manager, port0, NULL), ==, 0);
+
+    mm_modem_disable_sync (modem, NULL, &error);
+    g_assert_no_error (error);
+
+    g_object_unref (manager);
+    g_object_unref (modem);
+    g_object_unref (obj);
+
+    test_port_context_stop (port0);
+    test_port_context_free (port0);
+    g_free (ports[0]);
+}
+
+/*****************************************************************************/
+
+#define FAULT_COMMAND_TIMEOUT_S 2
+
+static void
+test_port_faults (TestFixture *fixture)
+{
+    GError          *error = NULL;
+    MMObject        *obj;
+    MMModem         *modem;
+    TestPortContext *port0;
+    GTimer          *timer;
+    gchar           *result;
+    guint            n_commands;
+    gchar           *ports [] = { NULL, NULL };
+
+    ports[0] = g_strdup_printf ("abstract:port0:%ld", (glong) getpid ());
+
+    port0 = test_port_context_new (ports[0]);
+    test_port_context_load_commands (port0, COMMON_GSM_PORT_CONF);
+    test_port_context_set_command (port0, "AT+TEST", "\r\nOK\r\n");
+    test_port_context_start (port0);
+
+    test_fixture_no_modem (fixture);
+    test_fixture_set_profile (fixture,
+                              "test-port-faults",
+                              "generic",
+                              (const gchar *const *)ports);
+
+    obj = test_fixture_get_modem (fixture);
+    modem = mm_object_get_modem (obj);
+    g_assert (modem != NULL);
+    mm_modem_enable_sync (modem, NULL, &error);
+    g_assert_no_error (error);
+
+    /* A reply slower than the command timeout makes the command time out */
+    test_port_context_set_command_latency (port0, "AT+TEST", (FAULT_COMMAND_TIMEOUT_S + 1) * 1000);
+    result = mm_modem_command_sync (modem, "+TEST", FAULT_COMMAND_TIMEOUT_S, NULL, &error);
+    g_assert_error (error, MM_SERIAL_ERROR, MM_SERIAL_ERROR_RESPONSE_TIMEOUT);
+    g_assert (!result);
+    g_clear_error (&error);
+    /* Let the late reply arrive before going on */
+    wait_ms (1500);
+
+    /* A slow reply within the command timeout is waited for */
+    test_port_context_set_command_latency (port0, "AT+TEST", 1000);
+    timer = g_timer_new ();
+    result = mm_modem_command_sync (modem, "+TEST", FAULT_COMMAND_TIMEOUT_S, NULL, &error);
+    g_assert_no_error (error);
+    g_assert (result);
+    g_assert_cmpfloat (g_timer_elapsed (timer, NULL), >=, 1.0);
+    g_timer_destroy (timer);
+    g_free (result);
+    test_port_context_set_command_latency (port0, "AT+TEST", 0);
+
+    /* No response at all, the command times out and the port keeps on
+     * working afterwards */
+    test_port_context_set_command_fault (port0, "AT+TEST", TEST_PORT_FAULT_NO_RESPONSE);
+    result = mm_modem_command_sync (modem, "+TEST", FAULT_COMMAND_TIMEOUT_S, NULL, &error);
+    g_assert_error (error, MM_SERIAL_ERROR, MM_SERIAL_ERROR_RESPONSE_TIMEOUT);
+    g_assert (!result);
+    g_clear_error (&error);
+    test_port_context_set_command_fault (port0, "AT+TEST", TEST_PORT_FAULT_NONE);
+    result = mm_modem_command_sync (modem, "+TEST", FAULT_COMMAND_TIMEOUT_S, NULL, &error);
+    g_assert_no_error (error);
+    g_assert (result);
+    g_free (result);
+
+    /* Garbage without a final result code also times out, and doesn't break
+     * the parsing of the replies that follow */
+    test_port_context_set_command_fault (port0, "AT+TEST", TEST_PORT_FAULT_GARBAGE);
+    result = mm_modem_command_sync (modem, "+TEST", FAULT_COMMAND_TIMEOUT_S, NULL, &error);
+    g_assert_error (error, MM_SERIAL_ERROR, MM_SERIAL_ERROR_RESPONSE_TIMEOUT);
+    g_assert (!result);
+    g_clear_error (&error);
+    test_port_context_set_command_fault (port0, "AT+TEST", TEST_PORT_FAULT_NONE);
+    result = mm_modem_command_sync (modem, "+TEST", FAULT_COMMAND_TIMEOUT_S, NULL, &error);
+    g_assert_no_error (error);
+    g_assert (result);
+    g_free (result);
+
+    /* A hangup forces the port closed: the command in flight fails right
+     * away, and the port is not reopened, so the commands that follow fail
+     * without reaching the device */
+    test_port_context_set_command_fault (port0, "AT+TEST", TEST_PORT_FAULT_HANGUP);
+    result = mm_modem_command_sync (modem, "+TEST", FAULT_COMMAND_TIMEOUT_S, NULL, &error);
+    g_assert_error (error, MM_SERIAL_ERROR, MM_SERIAL_ERROR_SEND_FAILED);
+    g_assert (!result);
+    g_clear_error (&error);
+    n_commands = test_port_context_get_command_count (port0, "AT+TEST");
+    test_port_context_set_command_fault (port0, "AT+TEST", TEST_PORT_FAULT_NONE);
+    result = mm_modem_command_sync (modem, "+TEST", FAULT_COMMAND_TIMEOUT_S, NULL, &error);
+    g_assert_error (error, MM_SERIAL_ERROR, MM_SERIAL_ERROR_SEND_FAILED);
+    g_assert (!result);
+    g_clear_error (&error);
+    g_assert_cmpuint (test_port_context_get_command_count (port0, "AT+TEST"), ==, n_commands);
+
+    g_object_unref (modem);
+    g_object_unref (obj);
+
+    test_port_context_stop (port0);
+    test_port_context_free (port0);
+    g_free (ports[0]);
+}
+
+/*****************************************************************************/
+
 int main (int   argc,
           char *argv[])
 {
     g_test_init (&argc, &argv, NULL);
 
-    TEST_ADD ("/MM/Service/Generic/enable-disable", test_enable_disable);
+    TEST_ADD ("/MM/Service/Generic/enable-disable",             test_enable_disable);
+    TEST_ADD ("/MM/Service/Generic/voice-incoming-call-urcs",   test_voice_incoming_call_urcs);
+    TEST_ADD ("/MM/Service/Generic/voice-outgoing-call-polling", test_voice_outgoing_call_polling);
+#if defined ENABLE_PLUGIN_HUAWEI
+    TEST_ADD ("/MM/Service/Generic/voice-call-progress-urcs",   test_voice_call_progress_urcs);
+#endif
+    TEST_ADD ("/MM/Service/Generic/multiple-modems",            test_multiple_modems);
+    TEST_ADD ("/MM/Service/Generic/capability-cache",           test_capability_cache);
+    TEST_ADD ("/MM/Service/Generic/profile-cache",              test_profile_cache);
+    TEST_ADD ("/MM/Service/Generic/port-faults",                test_port_faults);
 
     return g_test_run ();
 }
@@ -64,6 +64,7 @@ static MMIfaceModem3gpp *iface_modem_3gpp_parent;
 static MMIfaceModemLocation *iface_modem_location_parent;
 static MMIfaceModemCdma *iface_modem_cdma_parent;
 static MMIfaceModemVoice *iface_modem_voice_parent;
+static MMIfaceModemTime *iface_modem_time_parent;
 
 G_DEFINE_TYPE_EXTENDED (MMBroadbandModemHuawei, mm_broadband_modem_huawei, MM_TYPE_BROADBAND_MODEM, 0,
                         G_IMPLEMENT_INTERFACE (MM_TYPE_IFACE_MODEM, iface_modem_init)
@@ -110,6 +111,9 @@ struct _MMBroadbandModemHuaweiPrivate {
     GRegex *cend_regex;
     GRegex *ddtmf_regex;
 
+    /* Regex for network time notifications */
+    GRegex *nwtime_regex;
+
     /* Regex to ignore */
     GRegex *boot_regex;
     GRegex *connect_regex;
@@ -1994,8 +1998,8 @@ own_enable_unsolicited_events_ready (MMBaseModem *self,
 static const MMBaseModemAtCommand unsolicited_enable_sequence[] = {
     /* With ^PORTSEL we specify whether we want the PCUI port (0) or the
      * modem port (1) to receive the unsolicited messages */
-    { "^PORTSEL=0", 5, FALSE, NULL },
-    { "^CURC=1",    3, FALSE, NULL },
+    { "^PORTSEL=0", 5, FALSE, NULL, TRUE },
+    { "^CURC=1",    3, FALSE, NULL, TRUE },
     { NULL }
 };
 
@@ -3551,6 +3555,131 @@ modem_time_load_network_time_or_zone (MMIfaceModemTime *_self,
                               user_data);
 }
 
+/*****************************************************************************/
+/* Setup/Cleanup unsolicited events (Time interface) */
+
+static void
+huawei_nwtime_changed (MMPortSerialAt         *port,
+                       GMatchInfo             *match_info,
+                       MMBroadbandModemHuawei *self)
+{
+    g_autofree gchar             *str = NULL;
+    g_autofree gchar             *iso8601 = NULL;
+    g_autoptr(MMNetworkTimezone)  tz = NULL;
+    g_autoptr(GError)             error = NULL;
+
+    str = g_match_info_fetch (match_info, 1);
+    if (!mm_huawei_parse_nwtime_response (str, &iso8601, &tz, &error)) {
+        mm_obj_dbg (self, "couldn't process ^NWTIME URC: %s", error->message);
+        return;
+    }
+
+    mm_obj_dbg (self, "^NWTIME URC received: %s", iso8601);
+    mm_iface_modem_time_update_network_time (MM_IFACE_MODEM_TIME (self), iso8601);
+    mm_iface_modem_time_update_network_timezone (MM_IFACE_MODEM_TIME (self), tz);
+}
+
+static void
+set_time_unsolicited_events_handlers (MMBroadbandModemHuawei *self,
+                                      gboolean                enable)
+{
+    GList *ports, *l;
+
+    ports = mm_broadband_modem_huawei_get_at_port_list (self);
+
+    /* Enable/disable unsolicited events in given port */
+    for (l = ports; l; l = g_list_next (l)) {
+        MMPortSerialAt *port = MM_PORT_SERIAL_AT (l->data);
+
+        mm_port_serial_at_add_unsolicited_msg_handler (
+            port,
+            self->priv->nwtime_regex,
+            enable ? (MMPortSerialAtUnsolicitedMsgFn)huawei_nwtime_changed : NULL,
+            enable ? self : NULL,
+            NULL);
+    }
+
+    g_list_free_full (ports, g_object_unref);
+}
+
+static gboolean
+modem_time_setup_cleanup_unsolicited_events_finish (MMIfaceModemTime  *self,
+                                                    GAsyncResult      *res,
+                                                    GError           **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+static void
+parent_time_setup_unsolicited_events_ready (MMIfaceModemTime *self,
+                                            GAsyncResult     *res,
+                                            GTask            *task)
+{
+    GError *error = NULL;
+
+    if (!iface_modem_time_parent->setup_unsolicited_events_finish (self, res, &error)) {
+        g_task_return_error (task, error);
+        g_object_unref (task);
+        return;
+    }
+
+    /* Our own setup now */
+    if (MM_BROADBAND_MODEM_HUAWEI (self)->priv->nwtime_support == FEATURE_SUPPORTED)
+        set_time_unsolicited_events_handlers (MM_BROADBAND_MODEM_HUAWEI (self), TRUE);
+
+    g_task_return_boolean (task, TRUE);
+    g_object_unref (task);
+}
+
+static void
+modem_time_setup_unsolicited_events (MMIfaceModemTime    *self,
+                                     GAsyncReadyCallback  callback,
+                                     gpointer             user_data)
+{
+    GTask *task;
+
+    task = g_task_new (self, NULL, callback, user_data);
+
+    /* Chain up parent's setup */
+    iface_modem_time_parent->setup_unsolicited_events (
+        self,
+        (GAsyncReadyCallback)parent_time_setup_unsolicited_events_ready,
+        task);
+}
+
+static void
+parent_time_cleanup_unsolicited_events_ready (MMIfaceModemTime *self,
+                                              GAsyncResult     *res,
+                                              GTask            *task)
+{
+    GError *error = NULL;
+
+    if (!iface_modem_time_parent->cleanup_unsolicited_events_finish (self, res, &error))
+        g_task_return_error (task, error);
+    else
+        g_task_return_boolean (task, TRUE);
+    g_object_unref (task);
+}
+
+static void
+modem_time_cleanup_unsolicited_events (MMIfaceModemTime    *self,
+                                       GAsyncReadyCallback  callback,
+                                       gpointer             user_data)
+{
+    GTask *task;
+
+    task = g_task_new (self, NULL, callback, user_data);
+
+    /* Cleanup our own */
+    set_time_unsolicited_events_handlers (MM_BROADBAND_MODEM_HUAWEI (self), FALSE);
+
+    /* Chain up parent's cleanup */
+    iface_modem_time_parent->cleanup_unsolicited_events (
+        self,
+        (GAsyncReadyCallback)parent_time_cleanup_unsolicited_events_ready,
+        task);
+}
+
 /*****************************************************************************/
 /* Power state loading (Modem interface) */
 
@@ -4474,6 +4603,9 @@ mm_broadband_modem_huawei_init (MMBroadbandModemHuawei *self)
     self->priv->ddtmf_regex = g_regex_new ("\\r\\n\\^DDTMF:\\s*([0-9A-D\\*\\#])\\r\\n",
                                            G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
 
+    self->priv->nwtime_regex = g_regex_new ("\\r\\n(\\^NWTIME:.+)\\r\\n",
+                                            G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
+
     self->priv->boot_regex = g_regex_new ("\\r\\n\\^BOOT:.+\\r\\n",
                                           G_REGEX_RAW | G_REGEX_OPTIMIZE, 0, NULL);
     self->priv->connect_regex = g_regex_new ("\\r\\n\\^CONNECT .+\\r\\n",
@@ -4553,6 +4685,7 @@ finalize (GObject *object)
     g_regex_unref (self->priv->cend_regex);
     g_regex_unref (self->priv->ddtmf_regex);
 
+    g_regex_unref (self->priv->nwtime_regex);
     g_regex_unref (self->priv->boot_regex);
     g_regex_unref (self->priv->connect_regex);
     g_regex_unref (self->priv->csnr_regex);
@@ -4674,12 +4807,18 @@ iface_modem_location_init (MMIfaceModemLocation *iface)
 static void
 iface_modem_time_init (MMIfaceModemTime *iface)
 {
+    iface_modem_time_parent = g_type_interface_peek_parent (iface);
+
     iface->check_support = modem_time_check_support;
     iface->check_support_finish = modem_time_check_support_finish;
     iface->load_network_time = modem_time_load_network_time_or_zone;
     iface->load_network_time_finish = modem_time_load_network_time_finish;
     iface->load_network_timezone = modem_time_load_network_time_or_zone;
     iface->load_network_timezone_finish = modem_time_load_network_timezone_finish;
+    iface->setup_unsolicited_events = modem_time_setup_unsolicited_events;
+    iface->setup_unsolicited_events_finish = modem_time_setup_cleanup_unsolicited_events_finish;
+    iface->cleanup_unsolicited_events = modem_time_cleanup_unsolicited_events;
+    iface->cleanup_unsolicited_events_finish = modem_time_setup_cleanup_unsolicited_events_finish;
 }
 
 static void
@@ -942,8 +942,8 @@ own_enable_unsolicited_events_ready (MMBaseModem *self,
 }
 
 static const MMBaseModemAtCommand unsolicited_enable_sequence[] = {
-    { "*ERINFO=1", 5, FALSE, NULL },
-    { "*E2NAP=1",  5, FALSE, NULL },
+    { "*ERINFO=1", 5, FALSE, NULL, TRUE },
+    { "*E2NAP=1",  5, FALSE, NULL, TRUE },
     { NULL }
 };
 
@@ -1032,8 +1032,8 @@ own_disable_unsolicited_events_ready (MMBaseModem *self,
 }
 
 static const MMBaseModemAtCommand unsolicited_disable_sequence[] = {
-    { "*ERINFO=0", 5, FALSE, NULL },
-    { "*E2NAP=0",  5, FALSE, NULL },
+    { "*ERINFO=0", 5, FALSE, NULL, TRUE },
+    { "*E2NAP=0",  5, FALSE, NULL, TRUE },
     { NULL }
 };
 
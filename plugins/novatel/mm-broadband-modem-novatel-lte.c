@@ -599,6 +599,7 @@ parent_scan_networks_ready (MMIfaceModem3gpp *self,
 
 static void
 scan_networks (MMIfaceModem3gpp *self,
+               GCancellable *cancellable,
                GAsyncReadyCallback callback,
                gpointer user_data)
 {
@@ -607,7 +608,7 @@ scan_networks (MMIfaceModem3gpp *self,
 
     mm_obj_dbg (self, "scanning for networks (Novatel LTE)...");
 
-    task = g_task_new (self, NULL, callback, user_data);
+    task = g_task_new (self, cancellable, callback, user_data);
 
     /* The Novatel LTE modem does not properly support AT+COPS=? in LTE mode.
      * Thus, do not try to scan networks when the current access technologies
@@ -630,6 +631,7 @@ scan_networks (MMIfaceModem3gpp *self,
 
     /* Otherwise, just fallback to the generic scan method */
     iface_modem_3gpp_parent->scan_networks (self,
+                                            cancellable,
                                             (GAsyncReadyCallback)parent_scan_networks_ready,
                                             task);
 }
@@ -973,10 +973,10 @@ own_enable_unsolicited_events_ready (MMBaseModem *self,
 }
 
 static const MMBaseModemAtCommand unsolicited_enable_sequence[] = {
-    { "_OSSYS=1",  3, FALSE, NULL },
-    { "_OCTI=1",   3, FALSE, NULL },
-    { "_OUWCTI=1", 3, FALSE, NULL },
-    { "_OSQI=1",   3, FALSE, NULL },
+    { "_OSSYS=1",  3, FALSE, NULL, TRUE },
+    { "_OCTI=1",   3, FALSE, NULL, TRUE },
+    { "_OUWCTI=1", 3, FALSE, NULL, TRUE },
+    { "_OSQI=1",   3, FALSE, NULL, TRUE },
     { NULL }
 };
 
@@ -1028,10 +1028,10 @@ modem_3gpp_disable_unsolicited_events_finish (MMIfaceModem3gpp *self,
 }
 
 static const MMBaseModemAtCommand unsolicited_disable_sequence[] = {
-    { "_OSSYS=0",  3, FALSE, NULL },
-    { "_OCTI=0",   3, FALSE, NULL },
-    { "_OUWCTI=0", 3, FALSE, NULL },
-    { "_OSQI=0",   3, FALSE, NULL },
+    { "_OSSYS=0",  3, FALSE, NULL, TRUE },
+    { "_OCTI=0",   3, FALSE, NULL, TRUE },
+    { "_OUWCTI=0", 3, FALSE, NULL, TRUE },
+    { "_OSQI=0",   3, FALSE, NULL, TRUE },
     { NULL }
 };
 
@@ -13,10 +13,33 @@
  * Copyright (C) 2013 Aleksander Morgado <aleksander@gnu.org>
  */
 
+#include <glib/gstdio.h>
+
 #include "test-fixture.h"
 
-void
-test_fixture_setup (TestFixture *fixture)
+/* The daemon shares the cache directories across runs, so remove all
+ * entries to avoid data cached by one test being used in another */
+static void
+cache_dir_wipe (const gchar *path)
+{
+    GDir        *dir;
+    const gchar *name;
+
+    dir = g_dir_open (path, 0, NULL);
+    if (!dir)
+        return;
+
+    while ((name = g_dir_read_name (dir)) != NULL) {
+        g_autofree gchar *entry_path = NULL;
+
+        entry_path = g_build_filename (path, name, NULL);
+        g_unlink (entry_path);
+    }
+    g_dir_close (dir);
+}
+
+static void
+fixture_setup (TestFixture *fixture)
 {
     GError *error = NULL;
     GVariant *result;
@@ -64,6 +87,21 @@ test_fixture_setup (TestFixture *fixture)
         g_error ("Error getting ModemManager test proxy: %s", error->message);
 }
 
+void
+test_fixture_setup (TestFixture *fixture)
+{
+    cache_dir_wipe (TEST_CAPABILITY_CACHE_DIR);
+    cache_dir_wipe (TEST_SIM_CACHE_DIR);
+    fixture_setup (fixture);
+}
+
+void
+test_fixture_restart (TestFixture *fixture)
+{
+    test_fixture_teardown (fixture);
+    fixture_setup (fixture);
+}
+
 void
 test_fixture_teardown (TestFixture *fixture)
 {
@@ -97,14 +135,14 @@ test_fixture_set_profile (TestFixture *fixture,
         g_error ("Error setting test profile: %s", error->message);
 }
 
-static MMObject *
-common_get_modem (TestFixture *fixture,
-                  gboolean     modem_expected)
+GList *
+test_fixture_get_modems (TestFixture *fixture,
+                         guint        n_expected)
 {
-    MMObject *found = NULL;
-    guint     wait_time = 0;
+    GList *found = NULL;
+    guint  wait_time = 0;
 
-    /* Find new modem object */
+    /* Find new modem objects */
     while (TRUE) {
         GError    *error = NULL;
         MMManager *manager;
@@ -125,13 +163,14 @@ common_get_modem (TestFixture *fixture,
 
         modems = g_dbus_object_manager_get_objects (G_DBUS_OBJECT_MANAGER (manager));
         n_modems = g_list_length (modems);
-        g_assert_cmpuint (n_modems, <=, 1);
+        g_assert_cmpuint (n_modems, <=, n_expected);
+
+        if (n_expected == n_modems) {
+            GList *l;
 
-        if ((guint)modem_expected == n_modems) {
-            if (modems) {
-                found = MM_OBJECT (g_object_ref (modems->data));
-                g_message ("Found modem at '%s'", mm_object_get_path (found));
-            }
+            for (l = modems; l; l = g_list_next (l))
+                g_message ("Found modem at '%s'", mm_object_get_path (MM_OBJECT (l->data)));
+            found = g_steal_pointer (&modems);
             ready = TRUE;
         }
 
@@ -141,8 +180,8 @@ common_get_modem (TestFixture *fixture,
         if (ready)
             break;
 
-        /* Blocking wait */
-        g_assert_cmpuint (wait_time, <=, 20);
+        /* Blocking wait, longer the more modems are expected */
+        g_assert_cmpuint (wait_time, <=, 20 + n_expected);
         wait_time++;
         sleep (1);
     }
@@ -153,11 +192,17 @@ common_get_modem (TestFixture *fixture,
 MMObject *
 test_fixture_get_modem (TestFixture *fixture)
 {
-    return common_get_modem (fixture, TRUE);
+    GList    *modems;
+    MMObject *found;
+
+    modems = test_fixture_get_modems (fixture, 1);
+    found = MM_OBJECT (modems->data);
+    g_list_free (modems);
+    return found;
 }
 
 void
 test_fixture_no_modem (TestFixture *fixture)
 {
-    common_get_modem (fixture, FALSE);
+    test_fixture_get_modems (fixture, 0);
 }
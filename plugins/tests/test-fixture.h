@@ -32,8 +32,11 @@ typedef struct {
     GDBusConnection *connection;
 } TestFixture;
 
+/* The setup removes the capability and SIM caches of previous tests */
 void test_fixture_setup    (TestFixture *fixture);
 void test_fixture_teardown (TestFixture *fixture);
+/* Restarts the daemon keeping the capability and SIM caches */
+void test_fixture_restart  (TestFixture *fixture);
 
 typedef void (*TCFunc) (TestFixture *, gconstpointer);
 #define TEST_ADD(path,method)                        \
@@ -50,5 +53,9 @@ void      test_fixture_set_profile (TestFixture *fixture,
                                     const gchar *const *ports);
 MMObject *test_fixture_get_modem   (TestFixture *fixture);
 void      test_fixture_no_modem    (TestFixture *fixture);
+/* Waits until exactly the given number of modems are exported, returns a
+ * list of full references */
+GList    *test_fixture_get_modems  (TestFixture *fixture,
+                                    guint        n_expected);
 
 #endif /* TEST_FIXTURE_H */
@@ -21,6 +21,17 @@
 
 #define BUFFER_SIZE 1024
 
+/* Written instead of the response with TEST_PORT_FAULT_GARBAGE; fixed, so
+ * that runs are reproducible */
+static const gchar garbage[] = "\xff\xfe\x01\r\n~~~\x7f\x80+CME\x1b[0m\r\n";
+
+typedef struct {
+    gchar         *response;
+    /* -1 to use the port default */
+    gint           latency_ms;
+    TestPortFault  fault;
+} Command;
+
 struct _TestPortContext {
     gchar *name;
     GThread *thread;
@@ -32,19 +43,85 @@ struct _TestPortContext {
     GSocket *socket;
     GSocketService *socket_service;
     GList *clients;
+    /* Commands may be configured while the port context runs */
+    GMutex commands_mutex;
     GHashTable *commands;
+    guint latency_ms;
+    GMutex counters_mutex;
+    GHashTable *counters;
+    GList *unsolicited_sources;
 };
 
 /*****************************************************************************/
 
+static void
+command_free (Command *command)
+{
+    g_free (command->response);
+    g_slice_free (Command, command);
+}
+
+/* Must be called with the commands mutex locked */
+static Command *
+lookup_or_create_command (TestPortContext *self,
+                          const gchar *command)
+{
+    Command *cmd;
+
+    if (G_UNLIKELY (!self->commands))
+        self->commands = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify)command_free);
+
+    cmd = g_hash_table_lookup (self->commands, command);
+    if (!cmd) {
+        cmd = g_slice_new0 (Command);
+        cmd->response = g_strdup ("\r\nERROR\r\n");
+        cmd->latency_ms = -1;
+        g_hash_table_insert (self->commands, g_strdup (command), cmd);
+    }
+    return cmd;
+}
+
 void
 test_port_context_set_command (TestPortContext *self,
                                const gchar *command,
                                const gchar *response)
 {
-    if (G_UNLIKELY (!self->commands))
-        self->commands = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
-    g_hash_table_replace (self->commands, g_strdup (command), g_strcompress (response));
+    Command *cmd;
+
+    g_mutex_lock (&self->commands_mutex);
+    cmd = lookup_or_create_command (self, command);
+    g_free (cmd->response);
+    cmd->response = g_strcompress (response);
+    g_mutex_unlock (&self->commands_mutex);
+}
+
+void
+test_port_context_set_latency (TestPortContext *self,
+                               guint latency_ms)
+{
+    g_mutex_lock (&self->commands_mutex);
+    self->latency_ms = latency_ms;
+    g_mutex_unlock (&self->commands_mutex);
+}
+
+void
+test_port_context_set_command_latency (TestPortContext *self,
+                                       const gchar *command,
+                                       guint latency_ms)
+{
+    g_mutex_lock (&self->commands_mutex);
+    lookup_or_create_command (self, command)->latency_ms = (gint) latency_ms;
+    g_mutex_unlock (&self->commands_mutex);
+}
+
+void
+test_port_context_set_command_fault (TestPortContext *self,
+                                     const gchar *command,
+                                     TestPortFault fault)
+{
+    g_mutex_lock (&self->commands_mutex);
+    lookup_or_create_command (self, command)->fault = fault;
+    g_mutex_unlock (&self->commands_mutex);
 }
 
 void
@@ -92,14 +169,17 @@ test_port_context_load_commands (TestPortContext *self,
     g_free (contents);
 }
 
-static const gchar *
+/* Returns a copy of the command configuration, as it may change once the
+ * mutex is released */
+static Command *
 process_next_command (TestPortContext *ctx,
                       GByteArray *buffer)
 {
     gsize i = 0;
     gchar *command;
-    const gchar *response;
-    static const gchar *error_response = "\r\nERROR\r\n";
+    const Command *found;
+    Command *response;
+    static const Command error_response = { "\r\nERROR\r\n", -1, TEST_PORT_FAULT_NONE };
 
     /* Find command end */
     while (i < buffer->len && buffer->data[i] != '\r' && buffer->data[i] != '\n')
@@ -113,27 +193,68 @@ process_next_command (TestPortContext *ctx,
 
     /* Setup command and lookup response */
     command = g_strndup ((gchar *)buffer->data, i);
-    response = g_hash_table_lookup (ctx->commands, command);
+    g_mutex_lock (&ctx->commands_mutex);
+    found = ctx->commands ? g_hash_table_lookup (ctx->commands, command) : NULL;
+    if (!found)
+        found = &error_response;
+    response = g_slice_dup (Command, found);
+    response->response = g_strdup (found->response);
+    if (response->latency_ms < 0)
+        response->latency_ms = (gint) ctx->latency_ms;
+    g_mutex_unlock (&ctx->commands_mutex);
+
+    /* Keep track of how many times each command is received */
+    g_mutex_lock (&ctx->counters_mutex);
+    if (G_UNLIKELY (!ctx->counters))
+        ctx->counters = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    g_hash_table_replace (ctx->counters,
+                          g_strdup (command),
+                          GUINT_TO_POINTER (GPOINTER_TO_UINT (g_hash_table_lookup (ctx->counters, command)) + 1));
+    g_mutex_unlock (&ctx->counters_mutex);
+
     g_free (command);
 
     /* Remove command from buffer */
     g_byte_array_remove_range (buffer, 0, i);
 
-    return response ? response : error_response;
+    return response;
+}
+
+guint
+test_port_context_get_command_count (TestPortContext *self,
+                                     const gchar *command)
+{
+    guint count = 0;
+
+    g_mutex_lock (&self->counters_mutex);
+    if (self->counters)
+        count = GPOINTER_TO_UINT (g_hash_table_lookup (self->counters, command));
+    g_mutex_unlock (&self->counters_mutex);
+    return count;
 }
 
 /*****************************************************************************/
 
+static void
+source_destroy (GSource *source)
+{
+    g_source_destroy (source);
+    g_source_unref (source);
+}
+
 typedef struct {
     TestPortContext *ctx;
     GSocketConnection *connection;
     GSource *connection_readable_source;
     GByteArray *buffer;
+    /* Responses waiting for their latency to elapse */
+    GList *pending_sources;
 } Client;
 
 static void
 client_free (Client *client)
 {
+    g_list_free_full (client->pending_sources, (GDestroyNotify)source_destroy);
     g_source_destroy (client->connection_readable_source);
     g_source_unref (client->connection_readable_source);
     g_output_stream_close (g_io_stream_get_output_stream (G_IO_STREAM (client->connection)), NULL, NULL);
@@ -150,28 +271,101 @@ connection_close (Client *client)
     client_free (client);
 }
 
+static void
+client_write (Client *client,
+              const gchar *data,
+              gsize len)
+{
+    GError *error = NULL;
+
+    if (!g_output_stream_write_all (g_io_stream_get_output_stream (G_IO_STREAM (client->connection)),
+                                    data,
+                                    len,
+                                    NULL, /* bytes_written */
+                                    NULL, /* cancellable */
+                                    &error)) {
+        g_warning ("Cannot send response to client: %s", error->message);
+        g_error_free (error);
+    }
+}
+
+typedef struct {
+    Client *client;
+    GSource *source;
+    gchar *response;
+} PendingResponse;
+
+static void
+pending_response_free (PendingResponse *pending)
+{
+    g_free (pending->response);
+    g_slice_free (PendingResponse, pending);
+}
+
+static gboolean
+pending_response_cb (PendingResponse *pending)
+{
+    Client *client = pending->client;
+
+    client->pending_sources = g_list_remove (client->pending_sources, pending->source);
+    g_source_unref (pending->source);
+    client_write (client, pending->response, strlen (pending->response));
+    return G_SOURCE_REMOVE;
+}
+
+static void
+client_send_response (Client *client,
+                      const gchar *response,
+                      guint latency_ms)
+{
+    PendingResponse *pending;
+
+    if (!latency_ms) {
+        client_write (client, response, strlen (response));
+        return;
+    }
+
+    pending = g_slice_new0 (PendingResponse);
+    pending->client = client;
+    pending->response = g_strdup (response);
+    pending->source = g_timeout_source_new (latency_ms);
+    g_source_set_callback (pending->source,
+                           (GSourceFunc)pending_response_cb,
+                           pending,
+                           (GDestroyNotify)pending_response_free);
+    client->pending_sources = g_list_append (client->pending_sources, pending->source);
+    g_source_attach (pending->source, client->ctx->context);
+}
+
 static void
 client_parse_request (Client *client)
 {
-    const gchar *response;
+    Command *response;
 
     do {
         response = process_next_command (client->ctx, client->buffer);
-        if (response) {
-            GError *error = NULL;
-
-            if (!g_output_stream_write_all (g_io_stream_get_output_stream (G_IO_STREAM (client->connection)),
-                                            response,
-                                            strlen (response),
-                                            NULL, /* bytes_written */
-                                            NULL, /* cancellable */
-                                            &error)) {
-                g_warning ("Cannot send response to client: %s", error->message);
-                g_error_free (error);
-            }
+        if (!response)
+            break;
+
+        switch (response->fault) {
+        case TEST_PORT_FAULT_NONE:
+            client_send_response (client, response->response, (guint) response->latency_ms);
+            break;
+        case TEST_PORT_FAULT_NO_RESPONSE:
+            break;
+        case TEST_PORT_FAULT_GARBAGE:
+            client_write (client, garbage, sizeof (garbage) - 1);
+            break;
+        case TEST_PORT_FAULT_HANGUP:
+            g_debug ("closing client connection (fault injected)");
+            command_free (response);
+            connection_close (client);
+            return;
+        default:
+            g_assert_not_reached ();
         }
-
-    } while (response);
+        command_free (response);
+    } while (TRUE);
 }
 
 static gboolean
@@ -316,6 +510,98 @@ create_socket_service (TestPortContext *self)
 
 /*****************************************************************************/
 
+typedef struct {
+    TestPortContext *ctx;
+    gchar *message;
+} UnsolicitedContext;
+
+static void
+unsolicited_context_free (UnsolicitedContext *unsolicited)
+{
+    g_free (unsolicited->message);
+    g_slice_free (UnsolicitedContext, unsolicited);
+}
+
+static void
+send_unsolicited (UnsolicitedContext *unsolicited)
+{
+    GList *l;
+
+    for (l = unsolicited->ctx->clients; l; l = g_list_next (l)) {
+        Client *client = (Client *)(l->data);
+        GError *error = NULL;
+
+        if (!g_output_stream_write_all (g_io_stream_get_output_stream (G_IO_STREAM (client->connection)),
+                                        unsolicited->message,
+                                        strlen (unsolicited->message),
+                                        NULL, /* bytes_written */
+                                        NULL, /* cancellable */
+                                        &error)) {
+            g_warning ("Cannot send unsolicited message to client: %s", error->message);
+            g_error_free (error);
+        }
+    }
+}
+
+static gboolean
+send_unsolicited_cb (UnsolicitedContext *unsolicited)
+{
+    send_unsolicited (unsolicited);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+send_scheduled_unsolicited_cb (UnsolicitedContext *unsolicited)
+{
+    send_unsolicited (unsolicited);
+    return G_SOURCE_CONTINUE;
+}
+
+void
+test_port_context_send_unsolicited (TestPortContext *self,
+                                    const gchar *message)
+{
+    UnsolicitedContext *unsolicited;
+
+    g_assert (self->context != NULL);
+
+    /* Messages are written to the clients from the port context thread */
+    unsolicited = g_slice_new0 (UnsolicitedContext);
+    unsolicited->ctx = self;
+    unsolicited->message = g_strcompress (message);
+    g_main_context_invoke_full (self->context,
+                                G_PRIORITY_DEFAULT,
+                                (GSourceFunc) send_unsolicited_cb,
+                                unsolicited,
+                                (GDestroyNotify) unsolicited_context_free);
+}
+
+void
+test_port_context_schedule_unsolicited (TestPortContext *self,
+                                        const gchar *message,
+                                        guint period_ms)
+{
+    UnsolicitedContext *unsolicited;
+    GSource *source;
+
+    g_assert (self->context != NULL);
+    g_assert (period_ms > 0);
+
+    unsolicited = g_slice_new0 (UnsolicitedContext);
+    unsolicited->ctx = self;
+    unsolicited->message = g_strcompress (message);
+
+    source = g_timeout_source_new (period_ms);
+    g_source_set_callback (source,
+                           (GSourceFunc) send_scheduled_unsolicited_cb,
+                           unsolicited,
+                           (GDestroyNotify) unsolicited_context_free);
+    g_source_attach (source, self->context);
+    self->unsolicited_sources = g_list_prepend (self->unsolicited_sources, source);
+}
+
+/*****************************************************************************/
+
 static gboolean
 cancel_loop_cb (TestPortContext *self)
 {
@@ -330,6 +616,10 @@ test_port_context_stop (TestPortContext *self)
     g_assert (self->loop != NULL);
     g_assert (self->context != NULL);
 
+    /* Stop sending scheduled unsolicited messages */
+    g_list_free_full (self->unsolicited_sources, (GDestroyNotify) source_destroy);
+    self->unsolicited_sources = NULL;
+
     /* Cancel main loop of the port context thread, by scheduling an idle task
      * in the thread-owned main context */
     g_main_context_invoke (self->context, (GSourceFunc) cancel_loop_cb, self);
@@ -387,9 +677,13 @@ test_port_context_free (TestPortContext *self)
 
     g_cond_clear (&self->ready_cond);
     g_mutex_clear (&self->ready_mutex);
+    g_mutex_clear (&self->counters_mutex);
+    g_mutex_clear (&self->commands_mutex);
 
     if (self->commands)
         g_hash_table_unref (self->commands);
+    if (self->counters)
+        g_hash_table_unref (self->counters);
     g_list_free_full (self->clients, (GDestroyNotify)client_free);
     if (self->socket) {
         GError *error = NULL;
@@ -418,5 +712,7 @@ test_port_context_new (const gchar *name)
     self->name = g_strdup (name);
     g_cond_init (&self->ready_cond);
     g_mutex_init (&self->ready_mutex);
+    g_mutex_init (&self->counters_mutex);
+    g_mutex_init (&self->commands_mutex);
     return self;
 }
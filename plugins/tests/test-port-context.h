@@ -21,6 +21,17 @@
 
 typedef struct _TestPortContext TestPortContext;
 
+/* Faults that may be injected when a given command is received */
+typedef enum {
+    TEST_PORT_FAULT_NONE,
+    /* No response at all, so the command times out */
+    TEST_PORT_FAULT_NO_RESPONSE,
+    /* Binary garbage instead of the response */
+    TEST_PORT_FAULT_GARBAGE,
+    /* The client connection is closed */
+    TEST_PORT_FAULT_HANGUP,
+} TestPortFault;
+
 TestPortContext *test_port_context_new           (const gchar *name);
 void             test_port_context_start         (TestPortContext *self);
 void             test_port_context_stop          (TestPortContext *self);
@@ -32,4 +43,31 @@ void             test_port_context_set_command   (TestPortContext *self,
 void             test_port_context_load_commands (TestPortContext *self,
                                                   const gchar *commands_file);
 
+/* Delay before sending responses, either to all commands or to a given
+ * one. Responses, latencies and faults may also be changed while the port
+ * context runs, and apply to the commands received afterwards. */
+void             test_port_context_set_latency         (TestPortContext *self,
+                                                        guint latency_ms);
+void             test_port_context_set_command_latency (TestPortContext *self,
+                                                        const gchar *command,
+                                                        guint latency_ms);
+void             test_port_context_set_command_fault   (TestPortContext *self,
+                                                        const gchar *command,
+                                                        TestPortFault fault);
+
+/* Number of times the given command was received */
+guint            test_port_context_get_command_count (TestPortContext *self,
+                                                      const gchar *command);
+
+/* Write an unsolicited message to all clients; escape sequences like
+ * the ones in the commands file are allowed */
+void             test_port_context_send_unsolicited  (TestPortContext *self,
+                                                      const gchar *message);
+
+/* Write an unsolicited message to all clients every period, until the port
+ * context is stopped */
+void             test_port_context_schedule_unsolicited (TestPortContext *self,
+                                                         const gchar *message,
+                                                         guint period_ms);
+
 #endif /* TEST_PORT_CONTEXT_H */
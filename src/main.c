@@ -28,6 +28,7 @@
 
 #define MM_LOG_NO_OBJECT
 #include "mm-log.h"
+#include "mm-trace.h"
 #include "mm-base-manager.h"
 #include "mm-context.h"
 
@@ -62,6 +63,7 @@ static void
 sleeping_cb (MMSleepMonitor *sleep_monitor)
 {
     mm_dbg ("removing devices... (sleeping)");
+    mm_base_manager_checkpoint (manager);
     mm_base_manager_shutdown (manager, FALSE);
 }
 
@@ -171,6 +173,8 @@ main (int argc, char *argv[])
         exit (1);
     }
 
+    mm_trace_setup (mm_context_get_log_trace ());
+
     g_unix_signal_add (SIGTERM, quit_cb, NULL);
     g_unix_signal_add (SIGINT, quit_cb, NULL);
 
@@ -251,6 +255,7 @@ main (int argc, char *argv[])
 
     mm_info ("ModemManager is shut down");
 
+    mm_trace_shutdown ();
     mm_log_shutdown ();
 
     return 0;
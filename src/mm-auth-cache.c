@@ -0,0 +1,145 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <config.h>
+
+#include "mm-auth-cache.h"
+
+struct _MMAuthCache {
+    /* Time to live of each entry, in microseconds */
+    gint64      ttl;
+    /* sender (gchar *) -> GHashTable of authorization (gchar *) -> expiration (gint64 *) */
+    GHashTable *senders;
+    /* Counters */
+    guint64     hits;
+    guint64     misses;
+};
+
+MMAuthCache *
+mm_auth_cache_new (guint ttl_secs)
+{
+    MMAuthCache *self;
+
+    self = g_slice_new0 (MMAuthCache);
+    self->ttl = (gint64) ttl_secs * G_USEC_PER_SEC;
+    self->senders = g_hash_table_new_full (g_str_hash,
+                                           g_str_equal,
+                                           g_free,
+                                           (GDestroyNotify) g_hash_table_unref);
+    return self;
+}
+
+void
+mm_auth_cache_free (MMAuthCache *self)
+{
+    g_hash_table_unref (self->senders);
+    g_slice_free (MMAuthCache, self);
+}
+
+gboolean
+mm_auth_cache_lookup (MMAuthCache *self,
+                      const gchar *sender,
+                      const gchar *authorization,
+                      gint64       now)
+{
+    GHashTable *authorizations;
+    gint64     *expiration;
+
+    authorizations = g_hash_table_lookup (self->senders, sender);
+    if (authorizations) {
+        expiration = g_hash_table_lookup (authorizations, authorization);
+        if (expiration) {
+            if (now < *expiration) {
+                self->hits++;
+                return TRUE;
+            }
+            /* expired */
+            g_hash_table_remove (authorizations, authorization);
+            if (!g_hash_table_size (authorizations))
+                g_hash_table_remove (self->senders, sender);
+        }
+    }
+
+    self->misses++;
+    return FALSE;
+}
+
+void
+mm_auth_cache_add (MMAuthCache *self,
+                   const gchar *sender,
+                   const gchar *authorization,
+                   gint64       now)
+{
+    GHashTable *authorizations;
+    gint64     *expiration;
+
+    if (!self->ttl)
+        return;
+
+    authorizations = g_hash_table_lookup (self->senders, sender);
+    if (!authorizations) {
+        authorizations = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+        g_hash_table_insert (self->senders, g_strdup (sender), authorizations);
+    }
+
+    expiration = g_new (gint64, 1);
+    *expiration = now + self->ttl;
+    g_hash_table_replace (authorizations, g_strdup (authorization), expiration);
+}
+
+gboolean
+mm_auth_cache_has_sender (MMAuthCache *self,
+                          const gchar *sender)
+{
+    return g_hash_table_contains (self->senders, sender);
+}
+
+void
+mm_auth_cache_remove_sender (MMAuthCache *self,
+                             const gchar *sender)
+{
+    g_hash_table_remove (self->senders, sender);
+}
+
+void
+mm_auth_cache_clear (MMAuthCache *self)
+{
+    g_hash_table_remove_all (self->senders);
+}
+
+guint
+mm_auth_cache_get_n_entries (MMAuthCache *self)
+{
+    GHashTableIter  iter;
+    GHashTable     *authorizations;
+    guint           n_entries = 0;
+
+    g_hash_table_iter_init (&iter, self->senders);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &authorizations))
+        n_entries += g_hash_table_size (authorizations);
+    return n_entries;
+}
+
+guint64
+mm_auth_cache_get_hits (MMAuthCache *self)
+{
+    return self->hits;
+}
+
+guint64
+mm_auth_cache_get_misses (MMAuthCache *self)
+{
+    return self->misses;
+}
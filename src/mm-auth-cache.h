@@ -0,0 +1,52 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#ifndef MM_AUTH_CACHE_H
+#define MM_AUTH_CACHE_H
+
+#include <glib.h>
+
+/* Cache of successful authorization results, keyed by the DBus unique name
+ * of the sender and the authorization action id. Entries expire after the
+ * given TTL, and must be explicitly removed when the sender goes away or
+ * when the authorization rules change. Timestamps are given by the caller,
+ * in monotonic time microseconds. */
+
+typedef struct _MMAuthCache MMAuthCache;
+
+MMAuthCache *mm_auth_cache_new            (guint         ttl_secs);
+void         mm_auth_cache_free           (MMAuthCache  *self);
+
+gboolean     mm_auth_cache_lookup         (MMAuthCache  *self,
+                                           const gchar  *sender,
+                                           const gchar  *authorization,
+                                           gint64        now);
+void         mm_auth_cache_add            (MMAuthCache  *self,
+                                           const gchar  *sender,
+                                           const gchar  *authorization,
+                                           gint64        now);
+gboolean     mm_auth_cache_has_sender     (MMAuthCache  *self,
+                                           const gchar  *sender);
+void         mm_auth_cache_remove_sender  (MMAuthCache  *self,
+                                           const gchar  *sender);
+void         mm_auth_cache_clear          (MMAuthCache  *self);
+
+guint        mm_auth_cache_get_n_entries  (MMAuthCache  *self);
+guint64      mm_auth_cache_get_hits       (MMAuthCache  *self);
+guint64      mm_auth_cache_get_misses     (MMAuthCache  *self);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMAuthCache, mm_auth_cache_free)
+
+#endif /* MM_AUTH_CACHE_H */
@@ -22,16 +22,27 @@
 #include "mm-log-object.h"
 #include "mm-utils.h"
 #include "mm-auth-provider.h"
+#include "mm-auth-cache.h"
 
 #if defined WITH_POLKIT
 # include <polkit/polkit.h>
 #endif
 
+/* Successful authorizations are cached for a limited time, so that clients
+ * running lots of privileged operations don't need a polkit round trip for
+ * each of them. */
+#define AUTHORIZATION_CACHE_TTL_SECS 30
+
 struct _MMAuthProvider {
     GObject parent;
-#if defined WITH_POLKIT
-    PolkitAuthority *authority;
-#endif
+    /* Authority and its checks; a PolkitAuthority unless given explicitly */
+    GObject                       *authority;
+    MMAuthProviderCheckFunc        check;
+    MMAuthProviderCheckFinishFunc  check_finish;
+    gulong                         authority_changed_id;
+    MMAuthCache                   *cache;
+    /* sender (gchar *) -> SenderWatch */
+    GHashTable                    *sender_watches;
 };
 
 struct _MMAuthProviderClass {
@@ -45,46 +56,118 @@ G_DEFINE_TYPE_EXTENDED (MMAuthProvider, mm_auth_provider, G_TYPE_OBJECT, 0,
 
 /*****************************************************************************/
 
-gboolean
-mm_auth_provider_authorize_finish (MMAuthProvider  *self,
-                                   GAsyncResult    *res,
-                                   GError        **error)
+/* A sender is watched while it has cached authorizations or checks in
+ * progress, so that an authorization granted after the sender vanished is
+ * never cached */
+typedef struct {
+    GDBusConnection *connection;
+    guint            subscription_id;
+    guint            n_pending;
+} SenderWatch;
+
+static void
+sender_watch_free (SenderWatch *watch)
 {
-    return g_task_propagate_boolean (G_TASK (res), error);
+    g_dbus_connection_signal_unsubscribe (watch->connection, watch->subscription_id);
+    g_object_unref (watch->connection);
+    g_slice_free (SenderWatch, watch);
 }
 
-#if defined WITH_POLKIT
+static void
+name_owner_changed (GDBusConnection *connection,
+                    const gchar     *sender_name,
+                    const gchar     *object_path,
+                    const gchar     *interface_name,
+                    const gchar     *signal_name,
+                    GVariant        *parameters,
+                    MMAuthProvider  *self)
+{
+    const gchar *name;
+    const gchar *old_owner;
+    const gchar *new_owner;
 
-typedef struct {
-    PolkitSubject         *subject;
-    gchar                 *authorization;
-    GDBusMethodInvocation *invocation;
-} AuthorizeContext;
+    g_variant_get (parameters, "(&s&s&s)", &name, &old_owner, &new_owner);
+    if (new_owner && new_owner[0])
+        return;
+
+    mm_obj_dbg (self, "sender %s vanished: removing cached authorizations", name);
+    mm_auth_cache_remove_sender (self->cache, name);
+    /* unsubscribes */
+    g_hash_table_remove (self->sender_watches, name);
+}
+
+static SenderWatch *
+sender_watch_ensure (MMAuthProvider        *self,
+                     GDBusMethodInvocation *invocation)
+{
+    const gchar *sender;
+    SenderWatch *watch;
+
+    sender = g_dbus_method_invocation_get_sender (invocation);
+    watch = g_hash_table_lookup (self->sender_watches, sender);
+    if (watch)
+        return watch;
+
+    /* Cached authorizations are removed as soon as the sender goes away, as
+     * unique names are never reused by the bus daemon. */
+    watch = g_slice_new0 (SenderWatch);
+    watch->connection = g_object_ref (g_dbus_method_invocation_get_connection (invocation));
+    watch->subscription_id = g_dbus_connection_signal_subscribe (watch->connection,
+                                                                 "org.freedesktop.DBus",
+                                                                 "org.freedesktop.DBus",
+                                                                 "NameOwnerChanged",
+                                                                 "/org/freedesktop/DBus",
+                                                                 sender,
+                                                                 G_DBUS_SIGNAL_FLAGS_NONE,
+                                                                 (GDBusSignalCallback) name_owner_changed,
+                                                                 self,
+                                                                 NULL);
+    g_hash_table_insert (self->sender_watches, g_strdup (sender), watch);
+    return watch;
+}
 
 static void
-authorize_context_free (AuthorizeContext *ctx)
+sender_watch_release_if_unused (MMAuthProvider *self,
+                                const gchar    *sender)
 {
-    g_object_unref (ctx->invocation);
-    g_object_unref (ctx->subject);
-    g_free (ctx->authorization);
-    g_free (ctx);
+    SenderWatch *watch;
+
+    watch = g_hash_table_lookup (self->sender_watches, sender);
+    if (watch && !watch->n_pending && !mm_auth_cache_has_sender (self->cache, sender))
+        g_hash_table_remove (self->sender_watches, sender);
+}
+
+static void
+authority_changed (GObject        *authority,
+                   MMAuthProvider *self)
+{
+    mm_obj_dbg (self, "authority changed: flushing cached authorizations");
+    mm_auth_cache_clear (self->cache);
+    g_hash_table_remove_all (self->sender_watches);
+}
+
+/*****************************************************************************/
+
+#if defined WITH_POLKIT
+
+static gboolean
+polkit_check_finish (GObject       *authority,
+                     GAsyncResult  *res,
+                     GError       **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
 }
 
 static void
-check_authorization_ready (PolkitAuthority *authority,
-                           GAsyncResult    *res,
-                           GTask           *task)
+polkit_check_authorization_ready (PolkitAuthority *authority,
+                                  GAsyncResult    *res,
+                                  GTask           *task)
 {
     PolkitAuthorizationResult *pk_result;
     GError                    *error = NULL;
-    AuthorizeContext          *ctx;
-
-    if (g_task_return_error_if_cancelled (task)) {
-        g_object_unref (task);
-        return;
-    }
+    const gchar               *authorization;
 
-    ctx = g_task_get_task_data (task);
+    authorization = g_task_get_task_data (task);
     pk_result = polkit_authority_check_authorization_finish (authority, res, &error);
     if (!pk_result) {
         g_task_return_new_error (task,
@@ -102,19 +185,104 @@ check_authorization_ready (PolkitAuthority *authority,
                                      MM_CORE_ERROR,
                                      MM_CORE_ERROR_UNAUTHORIZED,
                                      "PolicyKit authorization failed: challenge needed for '%s'",
-                                     ctx->authorization);
+                                     authorization);
         else
             g_task_return_new_error (task,
                                      MM_CORE_ERROR,
                                      MM_CORE_ERROR_UNAUTHORIZED,
                                      "PolicyKit authorization failed: not authorized for '%s'",
-                                     ctx->authorization);
+                                     authorization);
         g_object_unref (pk_result);
     }
 
     g_object_unref (task);
 }
-#endif
+
+static void
+polkit_check (GObject             *authority,
+              const gchar         *sender,
+              const gchar         *authorization,
+              GCancellable        *cancellable,
+              GAsyncReadyCallback  callback,
+              gpointer             user_data)
+{
+    PolkitSubject *subject;
+    GTask         *task;
+
+    task = g_task_new (authority, cancellable, callback, user_data);
+    g_task_set_task_data (task, g_strdup (authorization), g_free);
+
+    subject = polkit_system_bus_name_new (sender);
+    polkit_authority_check_authorization (POLKIT_AUTHORITY (authority),
+                                          subject,
+                                          authorization,
+                                          NULL, /* details */
+                                          POLKIT_CHECK_AUTHORIZATION_FLAGS_ALLOW_USER_INTERACTION,
+                                          cancellable,
+                                          (GAsyncReadyCallback)polkit_check_authorization_ready,
+                                          task);
+    g_object_unref (subject);
+}
+
+#endif /* WITH_POLKIT */
+
+/*****************************************************************************/
+
+typedef struct {
+    gchar                 *authorization;
+    GDBusMethodInvocation *invocation;
+} AuthorizeContext;
+
+static void
+authorize_context_free (AuthorizeContext *ctx)
+{
+    g_object_unref (ctx->invocation);
+    g_free (ctx->authorization);
+    g_free (ctx);
+}
+
+gboolean
+mm_auth_provider_authorize_finish (MMAuthProvider  *self,
+                                   GAsyncResult    *res,
+                                   GError        **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+static void
+check_ready (GObject      *authority,
+             GAsyncResult *res,
+             GTask        *task)
+{
+    MMAuthProvider   *self;
+    AuthorizeContext *ctx;
+    SenderWatch      *watch;
+    const gchar      *sender;
+    GError           *error = NULL;
+
+    self = g_task_get_source_object (task);
+    ctx = g_task_get_task_data (task);
+    sender = g_dbus_method_invocation_get_sender (ctx->invocation);
+
+    /* No watch if the sender vanished or the authority changed during the
+     * check; the result is not cached then */
+    watch = g_hash_table_lookup (self->sender_watches, sender);
+    if (watch)
+        watch->n_pending--;
+
+    if (!g_task_return_error_if_cancelled (task)) {
+        if (!self->check_finish (authority, res, &error))
+            g_task_return_error (task, error);
+        else {
+            if (watch)
+                mm_auth_cache_add (self->cache, sender, ctx->authorization, g_get_monotonic_time ());
+            g_task_return_boolean (task, TRUE);
+        }
+    }
+
+    sender_watch_release_if_unused (self, sender);
+    g_object_unref (task);
+}
 
 void
 mm_auth_provider_authorize (MMAuthProvider        *self,
@@ -124,44 +292,72 @@ mm_auth_provider_authorize (MMAuthProvider        *self,
                             GAsyncReadyCallback    callback,
                             gpointer               user_data)
 {
-    GTask *task;
+    AuthorizeContext *ctx;
+    GTask            *task;
 
     task = g_task_new (self, cancellable, callback, user_data);
 
+    if (!self->authority) {
 #if defined WITH_POLKIT
-    {
-        AuthorizeContext *ctx;
-
         /* When creating the object, we actually allowed errors when looking for the
          * authority. If that is the case, we'll just forbid any incoming
          * authentication request */
-        if (!self->authority) {
-            g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
-                                     "PolicyKit authorization error: 'authority not found'");
-            g_object_unref (task);
-            return;
-        }
-
-        ctx = g_new (AuthorizeContext, 1);
-        ctx->invocation = g_object_ref (invocation);
-        ctx->authorization = g_strdup (authorization);
-        ctx->subject = polkit_system_bus_name_new (g_dbus_method_invocation_get_sender (ctx->invocation));
-        g_task_set_task_data (task, ctx, (GDestroyNotify)authorize_context_free);
-
-        polkit_authority_check_authorization (self->authority,
-                                              ctx->subject,
-                                              authorization,
-                                              NULL, /* details */
-                                              POLKIT_CHECK_AUTHORIZATION_FLAGS_ALLOW_USER_INTERACTION,
-                                              cancellable,
-                                              (GAsyncReadyCallback)check_authorization_ready,
-                                              task);
-    }
+        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                                 "PolicyKit authorization error: 'authority not found'");
 #else
-    /* Just create the result and complete it */
-    g_task_return_boolean (task, TRUE);
-    g_object_unref (task);
+        /* Without polkit, everything is authorized */
+        g_task_return_boolean (task, TRUE);
 #endif
+        g_object_unref (task);
+        return;
+    }
+
+    if (mm_auth_cache_lookup (self->cache,
+                              g_dbus_method_invocation_get_sender (invocation),
+                              authorization,
+                              g_get_monotonic_time ())) {
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    /* Watch the sender before the check starts, so that it is known if it
+     * vanishes in the meantime; this also keeps the watch of a sender whose
+     * last cached authorization just expired until the check completes */
+    sender_watch_ensure (self, invocation)->n_pending++;
+
+    ctx = g_new (AuthorizeContext, 1);
+    ctx->invocation = g_object_ref (invocation);
+    ctx->authorization = g_strdup (authorization);
+    g_task_set_task_data (task, ctx, (GDestroyNotify)authorize_context_free);
+
+    self->check (self->authority,
+                 g_dbus_method_invocation_get_sender (invocation),
+                 authorization,
+                 cancellable,
+                 (GAsyncReadyCallback)check_ready,
+                 task);
+}
+
+guint
+mm_auth_provider_get_n_cached (MMAuthProvider *self)
+{
+    return mm_auth_cache_get_n_entries (self->cache);
+}
+
+guint
+mm_auth_provider_get_n_watched (MMAuthProvider *self)
+{
+    return g_hash_table_size (self->sender_watches);
+}
+
+void
+mm_auth_provider_add_metrics (MMAuthProvider *self,
+                              GVariantDict   *dict)
+{
+    g_variant_dict_insert (dict, "authorization-cache-hits",    "t", mm_auth_cache_get_hits (self->cache));
+    g_variant_dict_insert (dict, "authorization-cache-misses",  "t", mm_auth_cache_get_misses (self->cache));
+    g_variant_dict_insert (dict, "authorization-cache-entries", "u", mm_auth_cache_get_n_entries (self->cache));
 }
 
 /*****************************************************************************/
@@ -174,31 +370,64 @@ log_object_build_id (MMLogObject *_self)
 
 /*****************************************************************************/
 
+static void
+set_authority (MMAuthProvider                *self,
+               GObject                       *authority,
+               MMAuthProviderCheckFunc        check,
+               MMAuthProviderCheckFinishFunc  check_finish)
+{
+    self->authority = authority;
+    self->check = check;
+    self->check_finish = check_finish;
+    self->authority_changed_id = g_signal_connect (self->authority,
+                                                   "changed",
+                                                   G_CALLBACK (authority_changed),
+                                                   self);
+}
+
+MMAuthProvider *
+mm_auth_provider_new_with_authority (GObject                       *authority,
+                                     MMAuthProviderCheckFunc        check,
+                                     MMAuthProviderCheckFinishFunc  check_finish)
+{
+    MMAuthProvider *self;
+
+    g_return_val_if_fail (G_IS_OBJECT (authority), NULL);
+    g_return_val_if_fail (check && check_finish, NULL);
+
+    self = g_object_new (MM_TYPE_AUTH_PROVIDER, NULL);
+    set_authority (self, g_object_ref (authority), check, check_finish);
+    return self;
+}
+
 static void
 mm_auth_provider_init (MMAuthProvider *self)
 {
-#if defined WITH_POLKIT
-    {
-        GError *error = NULL;
-
-        self->authority = polkit_authority_get_sync (NULL, &error);
-        if (!self->authority) {
-            /* NOTE: we failed to create the polkit authority, but we still create
-             * our AuthProvider. Every request will fail, though. */
-            mm_obj_warn (self, "failed to create PolicyKit authority: '%s'",
-                         error ? error->message : "unknown");
-            g_clear_error (&error);
-        }
-    }
-#endif
+    self->cache = mm_auth_cache_new (AUTHORIZATION_CACHE_TTL_SECS);
+    self->sender_watches = g_hash_table_new_full (g_str_hash,
+                                                  g_str_equal,
+                                                  g_free,
+                                                  (GDestroyNotify) sender_watch_free);
 }
 
 static void
 dispose (GObject *object)
 {
-#if defined WITH_POLKIT
-    g_clear_object (&(MM_AUTH_PROVIDER (object)->authority));
-#endif
+    MMAuthProvider *self = MM_AUTH_PROVIDER (object);
+
+    if (self->cache)
+        mm_obj_dbg (self, "authorization cache: %" G_GUINT64_FORMAT " hits, %" G_GUINT64_FORMAT " misses, %u cached",
+                    mm_auth_cache_get_hits (self->cache),
+                    mm_auth_cache_get_misses (self->cache),
+                    mm_auth_provider_get_n_cached (self));
+
+    if (self->authority && self->authority_changed_id) {
+        g_signal_handler_disconnect (self->authority, self->authority_changed_id);
+        self->authority_changed_id = 0;
+    }
+    g_clear_pointer (&self->sender_watches, g_hash_table_unref);
+    g_clear_pointer (&self->cache, mm_auth_cache_free);
+    g_clear_object (&self->authority);
 
     G_OBJECT_CLASS (mm_auth_provider_parent_class)->dispose (object);
 }
@@ -217,4 +446,41 @@ mm_auth_provider_class_init (MMAuthProviderClass *class)
     object_class->dispose = dispose;
 }
 
-MM_DEFINE_SINGLETON_GETTER (MMAuthProvider, mm_auth_provider_get, MM_TYPE_AUTH_PROVIDER)
+/*****************************************************************************/
+
+MM_DEFINE_SINGLETON_INSTANCE (MMAuthProvider)
+MM_DEFINE_SINGLETON_WEAK_REF (MMAuthProvider)
+
+MMAuthProvider *
+mm_auth_provider_get (void)
+{
+    if (G_UNLIKELY (!singleton_instance)) {
+        static gboolean already_created = FALSE;
+
+        g_assert (!already_created);
+        already_created = TRUE;
+        singleton_instance = g_object_new (MM_TYPE_AUTH_PROVIDER, NULL);
+        mm_singleton_instance_weak_ref_register ();
+        mm_obj_dbg (singleton_instance, "singleton created");
+
+#if defined WITH_POLKIT
+        {
+            PolkitAuthority *authority;
+            GError          *error = NULL;
+
+            authority = polkit_authority_get_sync (NULL, &error);
+            if (!authority) {
+                /* NOTE: we failed to create the polkit authority, but we still create
+                 * our AuthProvider. Every request will fail, though. */
+                mm_obj_warn (singleton_instance, "failed to create PolicyKit authority: '%s'",
+                             error ? error->message : "unknown");
+                g_clear_error (&error);
+            } else
+                set_authority (singleton_instance, G_OBJECT (authority), polkit_check, polkit_check_finish);
+        }
+#endif
+    }
+    return singleton_instance;
+}
+
+MM_DEFINE_SINGLETON_DESTRUCTOR (MMAuthProvider)
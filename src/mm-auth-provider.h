@@ -42,8 +42,24 @@ typedef struct _MMAuthProvider        MMAuthProvider;
 typedef struct _MMAuthProviderClass   MMAuthProviderClass;
 typedef struct _MMAuthProviderPrivate MMAuthProviderPrivate;
 
-GType           mm_auth_provider_get_type (void);
-MMAuthProvider *mm_auth_provider_get      (void);
+/* Authorization checks are run against polkit by default. A different
+ * authority may be given (e.g. for testing); it must emit a "changed" signal
+ * whenever its rules change, just like a PolkitAuthority does. */
+typedef void     (* MMAuthProviderCheckFunc)       (GObject              *authority,
+                                                    const gchar          *sender,
+                                                    const gchar          *authorization,
+                                                    GCancellable         *cancellable,
+                                                    GAsyncReadyCallback   callback,
+                                                    gpointer              user_data);
+typedef gboolean (* MMAuthProviderCheckFinishFunc) (GObject              *authority,
+                                                    GAsyncResult         *res,
+                                                    GError              **error);
+
+GType           mm_auth_provider_get_type           (void);
+MMAuthProvider *mm_auth_provider_get                (void);
+MMAuthProvider *mm_auth_provider_new_with_authority (GObject                       *authority,
+                                                     MMAuthProviderCheckFunc        check,
+                                                     MMAuthProviderCheckFinishFunc  check_finish);
 
 void     mm_auth_provider_authorize        (MMAuthProvider         *self,
                                             GDBusMethodInvocation  *invocation,
@@ -55,4 +71,14 @@ gboolean mm_auth_provider_authorize_finish (MMAuthProvider         *self,
                                             GAsyncResult           *res,
                                             GError                **error);
 
+/* Number of authorizations currently cached */
+guint    mm_auth_provider_get_n_cached     (MMAuthProvider         *self);
+/* Number of senders watched, either with cached authorizations or with
+ * checks in progress */
+guint    mm_auth_provider_get_n_watched    (MMAuthProvider         *self);
+
+/* Adds the authorization cache counters to a metrics dictionary */
+void     mm_auth_provider_add_metrics      (MMAuthProvider         *self,
+                                            GVariantDict           *dict);
+
 #endif /* MM_AUTH_PROVIDER_H */
@@ -36,9 +36,11 @@
 #include "mm-base-modem-at.h"
 #include "mm-base-modem.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 #include "mm-modem-helpers.h"
 #include "mm-error-helpers.h"
 #include "mm-bearer-stats.h"
+#include "mm-netlink.h"
 
 /* We require up to 20s to get a proper IP when using PPP */
 #define BEARER_IP_TIMEOUT_DEFAULT 20
@@ -47,6 +49,12 @@
 
 #define BEARER_STATS_UPDATE_TIMEOUT 30
 
+/* When the kernel accounts the traffic of the data interface, stats are
+ * sampled more often (cheap, no modem involved), and updated in DBus either
+ * when the update timeout expires or when enough traffic has been seen. */
+#define BEARER_STATS_NETLINK_SAMPLE_TIMEOUT 5
+#define BEARER_STATS_UPDATE_THRESHOLD       (1024 * 1024)
+
 /* Initial connectivity check after 30s, then each 5s */
 #define BEARER_CONNECTION_MONITOR_INITIAL_TIMEOUT 30
 #define BEARER_CONNECTION_MONITOR_TIMEOUT          5
@@ -71,6 +79,8 @@ enum {
     PROP_MODEM,
     PROP_STATUS,
     PROP_CONFIG,
+    PROP_STATS_UPDATE_TIMEOUT,
+    PROP_STATS_UPDATE_THRESHOLD,
     PROP_LAST
 };
 
@@ -98,6 +108,9 @@ struct _MMBaseBearerPrivate {
     /* handler id for the disconnect + cancel connect request */
     gulong disconnect_signal_handler;
 
+    /* Scheduler of the periodic tasks, shared with the modem */
+    MMPollScheduler *poll_scheduler;
+
     /* Connection status monitoring */
     guint connection_monitor_id;
     /* Flag to specify whether connection monitoring is supported or not */
@@ -126,6 +139,21 @@ struct _MMBaseBearerPrivate {
     GTimer *duration_timer;
     /* Flag to specify whether reloading stats is supported or not */
     gboolean reload_stats_unsupported;
+    /* Seconds between stats updates, and traffic (in bytes) that triggers
+     * an early update when the kernel stats are sampled */
+    guint   stats_update_timeout;
+    guint64 stats_update_threshold;
+    /* Flag to specify whether the kernel accounts the data interface stats */
+    gboolean netlink_stats_unsupported;
+    /* Kernel link counters when the connection was established */
+    gboolean netlink_stats_baseline_set;
+    guint64  netlink_stats_rx_baseline;
+    guint64  netlink_stats_tx_baseline;
+    /* Traffic already reported when the kernel link counters were reset */
+    guint64  netlink_stats_rx_offset;
+    guint64  netlink_stats_tx_offset;
+    /* Duration when the stats were last updated in DBus */
+    guint    stats_last_update;
 };
 
 /*****************************************************************************/
@@ -157,7 +185,7 @@ static void
 connection_monitor_stop (MMBaseBearer *self)
 {
     if (self->priv->connection_monitor_id) {
-        g_source_remove (self->priv->connection_monitor_id);
+        mm_poll_scheduler_remove (self->priv->poll_scheduler, self->priv->connection_monitor_id);
         self->priv->connection_monitor_id = 0;
     }
 }
@@ -215,9 +243,11 @@ initial_connection_monitor_cb (MMBaseBearer *self)
             NULL);
 
     /* Add new monitor timeout at a higher rate */
-    self->priv->connection_monitor_id = g_timeout_add_seconds (BEARER_CONNECTION_MONITOR_TIMEOUT,
-                                                               (GSourceFunc) connection_monitor_cb,
-                                                               self);
+    self->priv->connection_monitor_id = mm_poll_scheduler_add_seconds (self->priv->poll_scheduler,
+                                                                       "bearer connection monitor",
+                                                                       BEARER_CONNECTION_MONITOR_TIMEOUT,
+                                                                       (GSourceFunc) connection_monitor_cb,
+                                                                       self);
 
     /* Remove the initial connection monitor timeout as we added a new one */
     return G_SOURCE_REMOVE;
@@ -236,9 +266,11 @@ connection_monitor_start (MMBaseBearer *self)
 
     /* Schedule initial check */
     g_assert (!self->priv->connection_monitor_id);
-    self->priv->connection_monitor_id = g_timeout_add_seconds (BEARER_CONNECTION_MONITOR_INITIAL_TIMEOUT,
-                                                               (GSourceFunc) initial_connection_monitor_cb,
-                                                               self);
+    self->priv->connection_monitor_id = mm_poll_scheduler_add_seconds (self->priv->poll_scheduler,
+                                                                       "bearer connection monitor",
+                                                                       BEARER_CONNECTION_MONITOR_INITIAL_TIMEOUT,
+                                                                       (GSourceFunc) initial_connection_monitor_cb,
+                                                                       self);
 }
 
 /*****************************************************************************/
@@ -381,7 +413,7 @@ bearer_stats_stop (MMBaseBearer *self)
     }
 
     if (self->priv->stats_update_id) {
-        g_source_remove (self->priv->stats_update_id);
+        mm_poll_scheduler_remove (self->priv->poll_scheduler, self->priv->stats_update_id);
         self->priv->stats_update_id = 0;
     }
 }
@@ -418,13 +450,24 @@ reload_stats_ready (MMBaseBearer *self,
                                         tx_bytes);
 }
 
-static gboolean
-stats_update_cb (MMBaseBearer *self)
+static gboolean stats_update_cb (MMBaseBearer *self);
+
+static void
+bearer_stats_schedule (MMBaseBearer *self,
+                       guint         timeout)
 {
-    /* Ignore stats update if we're not connected */
-    if (self->priv->status != MM_BEARER_STATUS_CONNECTED)
-        return G_SOURCE_CONTINUE;
+    if (self->priv->stats_update_id)
+        mm_poll_scheduler_remove (self->priv->poll_scheduler, self->priv->stats_update_id);
+    self->priv->stats_update_id = mm_poll_scheduler_add_seconds (self->priv->poll_scheduler,
+                                                                 "bearer stats",
+                                                                 timeout,
+                                                                 (GSourceFunc) stats_update_cb,
+                                                                 self);
+}
 
+static void
+modem_stats_update (MMBaseBearer *self)
+{
     /* If the implementation knows how to update stat values, run it */
     if (!self->priv->reload_stats_unsupported &&
         MM_BASE_BEARER_GET_CLASS (self)->reload_stats &&
@@ -433,7 +476,7 @@ stats_update_cb (MMBaseBearer *self)
             self,
             (GAsyncReadyCallback)reload_stats_ready,
             NULL);
-        return G_SOURCE_CONTINUE;
+        return;
     }
 
     /* Otherwise, just update duration and we're done */
@@ -441,6 +484,110 @@ stats_update_cb (MMBaseBearer *self)
                                         (guint32) g_timer_elapsed (self->priv->duration_timer, NULL),
                                         0,
                                         0);
+}
+
+static void
+netlink_stats_fallback (MMBaseBearer *self)
+{
+    self->priv->netlink_stats_unsupported = TRUE;
+    bearer_stats_schedule (self, self->priv->stats_update_timeout);
+    modem_stats_update (self);
+}
+
+static void
+netlink_get_link_stats_ready (MMNetlink    *netlink,
+                              GAsyncResult *res,
+                              MMBaseBearer *self)
+{
+    g_autoptr(GHashTable)  link_stats_table = NULL;
+    g_autoptr(GError)      error = NULL;
+    MMNetlinkLinkStats    *link_stats;
+    const gchar           *interface;
+    guint                  duration;
+    guint64                rx_bytes;
+    guint64                tx_bytes;
+
+    link_stats_table = mm_netlink_get_link_stats_finish (netlink, res, &error);
+
+    /* Stats may have been stopped while the request was ongoing */
+    if (!self->priv->duration_timer || self->priv->status != MM_BEARER_STATUS_CONNECTED)
+        goto out;
+
+    if (!link_stats_table) {
+        mm_obj_dbg (self, "couldn't load kernel link stats: %s", error->message);
+        netlink_stats_fallback (self);
+        goto out;
+    }
+
+    interface = mm_gdbus_bearer_get_interface (MM_GDBUS_BEARER (self));
+    link_stats = interface ? g_hash_table_lookup (link_stats_table, interface) : NULL;
+    if (!link_stats) {
+        /* e.g. PPP, where the interface exposed is the TTY */
+        mm_obj_dbg (self, "interface %s not accounted by the kernel, stats will be loaded from the modem",
+                    interface ? interface : "unknown");
+        netlink_stats_fallback (self);
+        goto out;
+    }
+
+    /* The kernel counters are not reset on each connection, so a baseline is
+     * taken when the connection is established. */
+    if (!self->priv->netlink_stats_baseline_set) {
+        self->priv->netlink_stats_rx_baseline = link_stats->rx_bytes;
+        self->priv->netlink_stats_tx_baseline = link_stats->tx_bytes;
+        self->priv->netlink_stats_rx_offset = 0;
+        self->priv->netlink_stats_tx_offset = 0;
+        self->priv->netlink_stats_baseline_set = TRUE;
+    } else if (link_stats->rx_bytes < self->priv->netlink_stats_rx_baseline ||
+               link_stats->tx_bytes < self->priv->netlink_stats_tx_baseline) {
+        /* The link may also have been recreated or its counters reset during
+         * the connection; keep on counting from the traffic already reported */
+        mm_obj_dbg (self, "interface %s counters reset", interface);
+        self->priv->netlink_stats_rx_baseline = link_stats->rx_bytes;
+        self->priv->netlink_stats_tx_baseline = link_stats->tx_bytes;
+        self->priv->netlink_stats_rx_offset = mm_bearer_stats_get_rx_bytes (self->priv->stats);
+        self->priv->netlink_stats_tx_offset = mm_bearer_stats_get_tx_bytes (self->priv->stats);
+    }
+
+    duration = (guint32) g_timer_elapsed (self->priv->duration_timer, NULL);
+    rx_bytes = self->priv->netlink_stats_rx_offset + (link_stats->rx_bytes - self->priv->netlink_stats_rx_baseline);
+    tx_bytes = self->priv->netlink_stats_tx_offset + (link_stats->tx_bytes - self->priv->netlink_stats_tx_baseline);
+
+    /* Update right away the first time, and then only when the update timeout
+     * expires or when the traffic seen goes over the threshold. The counters
+     * are never expected to go backwards, but don't underflow if they do. */
+    if (self->priv->stats_last_update &&
+        (duration - self->priv->stats_last_update) < self->priv->stats_update_timeout &&
+        (rx_bytes < mm_bearer_stats_get_rx_bytes (self->priv->stats) ||
+         (rx_bytes - mm_bearer_stats_get_rx_bytes (self->priv->stats)) < self->priv->stats_update_threshold) &&
+        (tx_bytes < mm_bearer_stats_get_tx_bytes (self->priv->stats) ||
+         (tx_bytes - mm_bearer_stats_get_tx_bytes (self->priv->stats)) < self->priv->stats_update_threshold))
+        goto out;
+
+    self->priv->stats_last_update = MAX (duration, 1);
+    bearer_set_ongoing_interface_stats (self, duration, rx_bytes, tx_bytes);
+
+out:
+    g_object_unref (self);
+}
+
+static gboolean
+stats_update_cb (MMBaseBearer *self)
+{
+    /* Ignore stats update if we're not connected */
+    if (self->priv->status != MM_BEARER_STATUS_CONNECTED)
+        return G_SOURCE_CONTINUE;
+
+    /* Prefer the kernel link stats, requested for all links at once, so that
+     * the control channel isn't used when there are multiple bearers. */
+    if (!self->priv->netlink_stats_unsupported) {
+        mm_netlink_get_link_stats (mm_netlink_get (), /* singleton */
+                                   NULL,
+                                   (GAsyncReadyCallback)netlink_get_link_stats_ready,
+                                   g_object_ref (self));
+        return G_SOURCE_CONTINUE;
+    }
+
+    modem_stats_update (self);
     return G_SOURCE_CONTINUE;
 }
 
@@ -451,11 +598,15 @@ bearer_stats_start (MMBaseBearer *self)
     g_assert (!self->priv->duration_timer);
     self->priv->duration_timer = g_timer_new ();
 
+    /* Kernel stats are retried on every new connection, as the data
+     * interface may be a different one */
+    self->priv->netlink_stats_unsupported = FALSE;
+    self->priv->netlink_stats_baseline_set = FALSE;
+    self->priv->stats_last_update = 0;
+
     /* Schedule */
     g_assert (!self->priv->stats_update_id);
-    self->priv->stats_update_id = g_timeout_add_seconds (BEARER_STATS_UPDATE_TIMEOUT,
-                                                         (GSourceFunc) stats_update_cb,
-                                                         self);
+    bearer_stats_schedule (self, MIN (BEARER_STATS_NETLINK_SAMPLE_TIMEOUT, self->priv->stats_update_timeout));
     /* Load initial values */
     stats_update_cb (self);
 }
@@ -912,6 +1063,7 @@ connect_ready (MMBaseBearer *self,
     }
 
     g_clear_object (&self->priv->connect_cancellable);
+    mm_trace_end (self, "connection", NULL);
 
     if (error)
         g_task_return_error (task, error);
@@ -1017,6 +1169,7 @@ mm_base_bearer_connect (MMBaseBearer *self,
 
     /* Connecting! */
     mm_obj_dbg (self, "connecting...");
+    mm_trace_begin (self, "connection", NULL);
     self->priv->connect_cancellable = g_cancellable_new ();
     bearer_update_status (self, MM_BEARER_STATUS_CONNECTING);
     MM_BASE_BEARER_GET_CLASS (self)->connect (
@@ -1654,8 +1807,10 @@ set_property (GObject *object,
         break;
     case PROP_MODEM:
         g_clear_object (&self->priv->modem);
+        g_clear_pointer (&self->priv->poll_scheduler, mm_poll_scheduler_unref);
         self->priv->modem = g_value_dup_object (value);
         if (self->priv->modem) {
+            self->priv->poll_scheduler = mm_poll_scheduler_ref (mm_base_modem_peek_poll_scheduler (self->priv->modem));
             /* Set owner ID */
             mm_log_object_set_owner_id (MM_LOG_OBJECT (self), mm_log_object_get_id (MM_LOG_OBJECT (self->priv->modem)));
             /* Bind the modem's connection (which is set when it is exported,
@@ -1691,6 +1846,12 @@ set_property (GObject *object,
             g_variant_unref (dictionary);
         break;
     }
+    case PROP_STATS_UPDATE_TIMEOUT:
+        self->priv->stats_update_timeout = g_value_get_uint (value);
+        break;
+    case PROP_STATS_UPDATE_THRESHOLD:
+        self->priv->stats_update_threshold = g_value_get_uint64 (value);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
         break;
@@ -1721,6 +1882,12 @@ get_property (GObject *object,
     case PROP_CONFIG:
         g_value_set_object (value, self->priv->config);
         break;
+    case PROP_STATS_UPDATE_TIMEOUT:
+        g_value_set_uint (value, self->priv->stats_update_timeout);
+        break;
+    case PROP_STATS_UPDATE_THRESHOLD:
+        g_value_set_uint64 (value, self->priv->stats_update_threshold);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
         break;
@@ -1744,6 +1911,8 @@ mm_base_bearer_init (MMBaseBearer *self)
     self->priv->reason_3gpp = CONNECTION_FORBIDDEN_REASON_NONE;
     self->priv->reason_cdma = CONNECTION_FORBIDDEN_REASON_NONE;
     self->priv->stats = mm_bearer_stats_new ();
+    self->priv->stats_update_timeout = BEARER_STATS_UPDATE_TIMEOUT;
+    self->priv->stats_update_threshold = BEARER_STATS_UPDATE_THRESHOLD;
 
     /* Set defaults */
     mm_gdbus_bearer_set_interface   (MM_GDBUS_BEARER (self), NULL);
@@ -1789,6 +1958,7 @@ dispose (GObject *object)
     reset_deferred_unregistration (self);
 
     g_clear_object (&self->priv->modem);
+    g_clear_pointer (&self->priv->poll_scheduler, mm_poll_scheduler_unref);
     g_clear_object (&self->priv->config);
 
     G_OBJECT_CLASS (mm_base_bearer_parent_class)->dispose (object);
@@ -1855,6 +2025,23 @@ mm_base_bearer_class_init (MMBaseBearerClass *klass)
                              MM_TYPE_BEARER_PROPERTIES,
                              G_PARAM_READWRITE);
     g_object_class_install_property (object_class, PROP_CONFIG, properties[PROP_CONFIG]);
+
+    properties[PROP_STATS_UPDATE_TIMEOUT] =
+        g_param_spec_uint (MM_BASE_BEARER_STATS_UPDATE_TIMEOUT,
+                           "Stats update timeout",
+                           "Maximum number of seconds between stats updates",
+                           1, G_MAXUINT, BEARER_STATS_UPDATE_TIMEOUT,
+                           G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
+    g_object_class_install_property (object_class, PROP_STATS_UPDATE_TIMEOUT, properties[PROP_STATS_UPDATE_TIMEOUT]);
+
+    properties[PROP_STATS_UPDATE_THRESHOLD] =
+        g_param_spec_uint64 (MM_BASE_BEARER_STATS_UPDATE_THRESHOLD,
+                             "Stats update threshold",
+                             "Number of bytes transferred that trigger a stats update before the timeout, "
+                             "only applicable when the stats are accounted by the kernel",
+                             1, G_MAXUINT64, BEARER_STATS_UPDATE_THRESHOLD,
+                             G_PARAM_READWRITE | G_PARAM_CONSTRUCT);
+    g_object_class_install_property (object_class, PROP_STATS_UPDATE_THRESHOLD, properties[PROP_STATS_UPDATE_THRESHOLD]);
 }
 
 /*****************************************************************************/
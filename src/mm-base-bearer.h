@@ -83,6 +83,8 @@ typedef struct _MMBaseBearerPrivate MMBaseBearerPrivate;
 #define MM_BASE_BEARER_MODEM      "bearer-modem"
 #define MM_BASE_BEARER_STATUS     "bearer-status"
 #define MM_BASE_BEARER_CONFIG     "bearer-config"
+#define MM_BASE_BEARER_STATS_UPDATE_TIMEOUT   "bearer-stats-update-timeout"
+#define MM_BASE_BEARER_STATS_UPDATE_THRESHOLD "bearer-stats-update-threshold"
 
 typedef enum { /*< underscore_name=mm_bearer_status >*/
     MM_BEARER_STATUS_DISCONNECTED,
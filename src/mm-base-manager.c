@@ -52,6 +52,8 @@
 #include "mm-plugin.h"
 #include "mm-filter.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
+#include "mm-capability-cache.h"
 #include "mm-base-modem.h"
 
 static void initable_iface_init   (GInitableIface       *iface);
@@ -98,6 +100,8 @@ struct _MMBaseManagerPrivate {
     GDBusObjectManagerServer *object_manager;
     /* The map of inhibited devices */
     GHashTable *inhibited_devices;
+    /* The map of device checkpoints taken before suspending */
+    GHashTable *checkpoints;
 
     /* The Test interface support */
     MmGdbusTest *test_skeleton;
@@ -283,6 +287,37 @@ device_removed (MMBaseManager *self,
     }
 }
 
+static void
+device_attach_checkpoint (MMBaseManager  *self,
+                          MMDevice       *device,
+                          MMKernelDevice *port)
+{
+    MMDeviceCheckpoint *checkpoint;
+    gpointer            key;
+
+    if (!g_hash_table_lookup_extended (self->priv->checkpoints,
+                                       mm_device_get_uid (device),
+                                       &key,
+                                       (gpointer *)&checkpoint))
+        return;
+
+    /* Checkpoints are only used once */
+    g_hash_table_steal (self->priv->checkpoints, key);
+    g_free (key);
+
+    if (!mm_device_checkpoint_matches (checkpoint,
+                                       mm_kernel_device_get_physdev_vid (port),
+                                       mm_kernel_device_get_physdev_pid (port),
+                                       g_get_monotonic_time ())) {
+        mm_obj_dbg (self, "ignoring checkpoint of device %s: expired or different device",
+                    mm_device_get_uid (device));
+        mm_device_checkpoint_free (checkpoint);
+        return;
+    }
+
+    mm_device_set_checkpoint (device, checkpoint);
+}
+
 static void
 device_added (MMBaseManager  *self,
               MMKernelDevice *port,
@@ -355,6 +390,9 @@ device_added (MMBaseManager  *self,
                              g_strdup (physdev_uid),
                              device);
 
+        /* Reuse the state of the device before suspending, if any */
+        device_attach_checkpoint (self, device, port);
+
         /* Launch device support check */
         ctx = g_slice_new (FindDeviceSupportContext);
         ctx->self = g_object_ref (self);
@@ -705,6 +743,29 @@ mm_base_manager_shutdown (MMBaseManager *self,
     g_hash_table_foreach_remove (self->priv->devices, (GHRFunc)foreach_remove, self);
 }
 
+void
+mm_base_manager_checkpoint (MMBaseManager *self)
+{
+    GHashTableIter iter;
+    gpointer       key, value;
+
+    g_return_if_fail (self != NULL);
+    g_return_if_fail (MM_IS_BASE_MANAGER (self));
+
+    g_hash_table_remove_all (self->priv->checkpoints);
+
+    g_hash_table_iter_init (&iter, self->priv->devices);
+    while (g_hash_table_iter_next (&iter, &key, &value)) {
+        MMDeviceCheckpoint *checkpoint;
+
+        checkpoint = mm_device_take_checkpoint (MM_DEVICE (value));
+        if (checkpoint)
+            g_hash_table_insert (self->priv->checkpoints, g_strdup ((const gchar *)key), checkpoint);
+    }
+
+    mm_obj_dbg (self, "checkpoint taken for %u devices", g_hash_table_size (self->priv->checkpoints));
+}
+
 guint32
 mm_base_manager_num_modems (MMBaseManager *self)
 {
@@ -828,6 +889,120 @@ handle_set_logging (MmGdbusOrgFreedesktopModemManager1 *manager,
     return TRUE;
 }
 
+/*****************************************************************************/
+/* Dump trace */
+
+typedef struct {
+    MMBaseManager *self;
+    GDBusMethodInvocation *invocation;
+} DumpTraceContext;
+
+static void
+dump_trace_context_free (DumpTraceContext *ctx)
+{
+    g_object_unref (ctx->invocation);
+    g_object_unref (ctx->self);
+    g_free (ctx);
+}
+
+static void
+dump_trace_auth_ready (MMAuthProvider   *authp,
+                       GAsyncResult     *res,
+                       DumpTraceContext *ctx)
+{
+    GError           *error = NULL;
+    g_autofree gchar *trace = NULL;
+
+    if (!mm_auth_provider_authorize_finish (authp, res, &error))
+        g_dbus_method_invocation_take_error (ctx->invocation, error);
+    else {
+        if (!mm_trace_enabled)
+            mm_obj_dbg (ctx->self, "trace requested but tracing is disabled");
+        trace = mm_trace_build_json ();
+        mm_gdbus_org_freedesktop_modem_manager1_complete_dump_trace (
+            MM_GDBUS_ORG_FREEDESKTOP_MODEM_MANAGER1 (ctx->self),
+            ctx->invocation,
+            trace);
+    }
+
+    dump_trace_context_free (ctx);
+}
+
+static gboolean
+handle_dump_trace (MmGdbusOrgFreedesktopModemManager1 *manager,
+                   GDBusMethodInvocation *invocation)
+{
+    DumpTraceContext *ctx;
+
+    ctx = g_new0 (DumpTraceContext, 1);
+    ctx->self = MM_BASE_MANAGER (g_object_ref (manager));
+    ctx->invocation = g_object_ref (invocation);
+
+    mm_auth_provider_authorize (ctx->self->priv->authp,
+                                invocation,
+                                MM_AUTHORIZATION_MANAGER_CONTROL,
+                                ctx->self->priv->authp_cancellable,
+                                (GAsyncReadyCallback)dump_trace_auth_ready,
+                                ctx);
+    return TRUE;
+}
+
+/*****************************************************************************/
+/* Clear capability cache */
+
+typedef struct {
+    MMBaseManager *self;
+    GDBusMethodInvocation *invocation;
+} ClearCapabilityCacheContext;
+
+static void
+clear_capability_cache_context_free (ClearCapabilityCacheContext *ctx)
+{
+    g_object_unref (ctx->invocation);
+    g_object_unref (ctx->self);
+    g_free (ctx);
+}
+
+static void
+clear_capability_cache_auth_ready (MMAuthProvider              *authp,
+                                   GAsyncResult                *res,
+                                   ClearCapabilityCacheContext *ctx)
+{
+    GError *error = NULL;
+
+    if (!mm_auth_provider_authorize_finish (authp, res, &error))
+        g_dbus_method_invocation_take_error (ctx->invocation, error);
+    else if (!mm_capability_cache_clear (mm_context_get_test_capability_cache_dir (), &error))
+        g_dbus_method_invocation_take_error (ctx->invocation, error);
+    else {
+        mm_obj_info (ctx->self, "capability cache cleared");
+        mm_gdbus_org_freedesktop_modem_manager1_complete_clear_capability_cache (
+            MM_GDBUS_ORG_FREEDESKTOP_MODEM_MANAGER1 (ctx->self),
+            ctx->invocation);
+    }
+
+    clear_capability_cache_context_free (ctx);
+}
+
+static gboolean
+handle_clear_capability_cache (MmGdbusOrgFreedesktopModemManager1 *manager,
+                               GDBusMethodInvocation *invocation)
+{
+    ClearCapabilityCacheContext *ctx;
+
+    ctx = g_new0 (ClearCapabilityCacheContext, 1);
+    ctx->self = MM_BASE_MANAGER (g_object_ref (manager));
+    ctx->invocation = g_object_ref (invocation);
+
+    mm_auth_provider_authorize (ctx->self->priv->authp,
+                                invocation,
+                                MM_AUTHORIZATION_MANAGER_CONTROL,
+                                ctx->self->priv->authp_cancellable,
+                                (GAsyncReadyCallback)clear_capability_cache_auth_ready,
+                                ctx);
+    return TRUE;
+}
+
 /*****************************************************************************/
 /* Manual scan */
 
@@ -1495,6 +1670,9 @@ mm_base_manager_init (MMBaseManager *self)
     /* Setup internal list of inhibited devices */
     self->priv->inhibited_devices = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify)inhibited_device_info_free);
 
+    /* Setup internal list of device checkpoints */
+    self->priv->checkpoints = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify)mm_device_checkpoint_free);
+
     /* By default, enable autoscan */
     self->priv->auto_scan = TRUE;
 
@@ -1510,6 +1688,8 @@ mm_base_manager_init (MMBaseManager *self)
                       "signal::handle-scan-devices",        G_CALLBACK (handle_scan_devices),        NULL,
                       "signal::handle-report-kernel-event", G_CALLBACK (handle_report_kernel_event), NULL,
                       "signal::handle-inhibit-device",      G_CALLBACK (handle_inhibit_device),      NULL,
+                      "signal::handle-dump-trace",          G_CALLBACK (handle_dump_trace),          NULL,
+                      "signal::handle-clear-capability-cache", G_CALLBACK (handle_clear_capability_cache), NULL,
                       NULL);
 }
 
@@ -1591,6 +1771,7 @@ finalize (GObject *object)
     g_free (self->priv->initial_kernel_events);
     g_free (self->priv->plugin_dir);
 
+    g_hash_table_destroy (self->priv->checkpoints);
     g_hash_table_destroy (self->priv->inhibited_devices);
     g_hash_table_destroy (self->priv->devices);
 
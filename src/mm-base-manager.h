@@ -66,6 +66,10 @@ void             mm_base_manager_start       (MMBaseManager *manager,
 void             mm_base_manager_shutdown    (MMBaseManager *manager,
                                               gboolean disable);
 
+/* Snapshot the state of the devices, to speed up their probing and
+ * initialization if they're exposed again right after resuming */
+void             mm_base_manager_checkpoint  (MMBaseManager *manager);
+
 #if defined WITH_SYSTEMD_SUSPEND_RESUME
 void             mm_base_manager_sync        (MMBaseManager *manager);
 #endif
@@ -13,6 +13,8 @@
  * Copyright (C) 2011 Aleksander Morgado <aleksander@gnu.org>
  */
 
+#include <string.h>
+
 #include <glib.h>
 #include <glib-object.h>
 
@@ -20,6 +22,8 @@
 
 #include "mm-base-modem-at.h"
 #include "mm-errors-types.h"
+#include "mm-modem-helpers.h"
+#include "mm-log.h"
 
 static gboolean
 abort_async_if_port_unusable (MMBaseModem *self,
@@ -89,6 +93,9 @@ modem_cancellable_cancelled (GCancellable *modem_cancellable,
 /*****************************************************************************/
 /* AT sequence handling */
 
+/* Maximum number of commands sent in a single compound command line */
+#define MAX_BATCH_COMMANDS 8
+
 typedef struct {
     MMBaseModem                *self;
     MMPortSerialAt             *port;
@@ -102,6 +109,8 @@ typedef struct {
     gpointer                    response_processor_context;
     GDestroyNotify              response_processor_context_free;
     GVariant                   *result;
+    /* Commands in the compound command line in flight */
+    guint                       batch_len;
 } AtSequenceContext;
 
 static void
@@ -152,27 +161,54 @@ mm_base_modem_at_sequence_full_finish (MMBaseModem   *self,
 }
 
 static void
-at_sequence_parse_response (MMPortSerialAt    *port,
-                            GAsyncResult      *res,
-                            AtSequenceContext *ctx)
+at_sequence_complete (AtSequenceContext *ctx,
+                      GVariant          *result)
+{
+    GSimpleAsyncResult *simple;
+
+    /* If we got a response, set it as result */
+    if (result)
+        /* transfer-full */
+        ctx->result = result;
+
+    /* Set the whole context as result, in order to pass the response
+     * processor context during finish(). We do remove the simple async result
+     * from the context as well, so that we control its last unref. */
+    simple = ctx->simple;
+    ctx->simple = NULL;
+    g_simple_async_result_set_op_res_gpointer (
+        simple,
+        ctx,
+        (GDestroyNotify)at_sequence_context_free);
+
+    /* And complete. The whole context is owned by the result, and it will
+     * be freed when completed. */
+    g_simple_async_result_complete (simple);
+    g_object_unref (simple);
+}
+
+static gboolean
+at_sequence_complete_if_cancelled (AtSequenceContext *ctx)
+{
+    if (!g_cancellable_is_cancelled (ctx->cancellable))
+        return FALSE;
+
+    g_simple_async_result_set_error (ctx->simple, G_IO_ERROR, G_IO_ERROR_CANCELLED, "AT sequence was cancelled");
+    g_simple_async_result_complete (ctx->simple);
+    at_sequence_context_free (ctx);
+    return TRUE;
+}
+
+/* Processes the response of the current command. Returns TRUE if the
+ * sequence goes on with the next command, FALSE if it got completed. */
+static gboolean
+at_sequence_process_response (AtSequenceContext *ctx,
+                              const gchar       *response,
+                              const GError      *error)
 {
     MMBaseModemAtResponseProcessorResult  processor_result;
     GVariant                             *result = NULL;
     GError                               *result_error = NULL;
-    GSimpleAsyncResult                   *simple;
-    const gchar                          *response;
-    GError                               *error = NULL;
-
-    response = mm_port_serial_at_command_finish (port, res, &error);
-
-    /* Cancelled? */
-    if (g_cancellable_is_cancelled (ctx->cancellable)) {
-        g_simple_async_result_set_error (ctx->simple, G_IO_ERROR, G_IO_ERROR_CANCELLED, "AT sequence was cancelled");
-        g_clear_error (&error);
-        g_simple_async_result_complete (ctx->simple);
-        at_sequence_context_free (ctx);
-        return;
-    }
 
     if (!ctx->current->response_processor)
         processor_result = MM_BASE_MODEM_AT_RESPONSE_PROCESSOR_RESULT_CONTINUE;
@@ -201,54 +237,152 @@ at_sequence_parse_response (MMPortSerialAt    *port,
                 g_simple_async_result_take_error (ctx->simple, result_error);
                 g_simple_async_result_complete (ctx->simple);
                 at_sequence_context_free (ctx);
-                if (error)
-                    g_error_free (error);
-                return;
+                return FALSE;
             default:
                 g_assert_not_reached ();
         }
     }
 
-    if (error)
-        g_error_free (error);
-
     if (processor_result == MM_BASE_MODEM_AT_RESPONSE_PROCESSOR_RESULT_CONTINUE) {
         ctx->current++;
-        if (ctx->current->command) {
-            /* Schedule the next command in the probing group */
-            mm_port_serial_at_command (
-                ctx->port,
-                ctx->current->command,
-                ctx->current->timeout,
-                FALSE,
-                ctx->current->allow_cached,
-                ctx->cancellable,
-                (GAsyncReadyCallback)at_sequence_parse_response,
-                ctx);
-            return;
-        }
+        if (ctx->current->command)
+            return TRUE;
         /* On last command, end. */
     }
 
-    /* If we got a response, set it as result */
-    if (result)
-        /* transfer-full */
-        ctx->result = result;
+    at_sequence_complete (ctx, result);
+    return FALSE;
+}
 
-    /* Set the whole context as result, in order to pass the response
-     * processor context during finish(). We do remove the simple async result
-     * from the context as well, so that we control its last unref. */
-    simple = ctx->simple;
-    ctx->simple = NULL;
-    g_simple_async_result_set_op_res_gpointer (
-        simple,
-        ctx,
-        (GDestroyNotify)at_sequence_context_free);
+static void at_sequence_run_next (AtSequenceContext *ctx);
 
-    /* And complete. The whole context is owned by the result, and it will
-     * be freed when completed. */
-    g_simple_async_result_complete (simple);
-    g_object_unref (simple);
+static void
+at_sequence_parse_response (MMPortSerialAt    *port,
+                            GAsyncResult      *res,
+                            AtSequenceContext *ctx)
+{
+    const gchar       *response;
+    g_autoptr(GError)  error = NULL;
+
+    response = mm_port_serial_at_command_finish (port, res, &error);
+
+    if (at_sequence_complete_if_cancelled (ctx))
+        return;
+
+    if (!at_sequence_process_response (ctx, response, error))
+        return;
+
+    at_sequence_run_next (ctx);
+}
+
+static void
+at_sequence_parse_compound_response (MMPortSerialAt    *port,
+                                     GAsyncResult      *res,
+                                     AtSequenceContext *ctx)
+{
+    const gchar       *response;
+    g_auto(GStrv)      responses = NULL;
+    g_autoptr(GError)  error = NULL;
+    guint              batch_len;
+    guint              i;
+
+    batch_len = ctx->batch_len;
+    ctx->batch_len = 0;
+
+    response = mm_port_serial_at_command_finish (port, res, &error);
+
+    if (at_sequence_complete_if_cancelled (ctx))
+        return;
+
+    if (!error) {
+        g_autoptr(GPtrArray) commands = NULL;
+
+        commands = g_ptr_array_new ();
+        for (i = 0; i < batch_len; i++)
+            g_ptr_array_add (commands, (gpointer) ctx->current[i].command);
+        g_ptr_array_add (commands, NULL);
+
+        responses = mm_split_compound_at_response (response, (const gchar * const *) commands->pdata, &error);
+    }
+
+    if (error) {
+        /* Whether it was one of the commands or the compound line itself
+         * what failed, batching would fail again on every run of the
+         * sequence, so it is disabled; nothing was processed yet, so all
+         * the commands are retried one by one */
+        mm_obj_dbg (ctx->self, "compound AT command line failed, running commands one by one: %s", error->message);
+        mm_base_modem_at_batching_report (ctx->self, FALSE);
+        at_sequence_run_next (ctx);
+        return;
+    }
+
+    mm_base_modem_at_batching_report (ctx->self, TRUE);
+    for (i = 0; i < batch_len; i++) {
+        if (!at_sequence_process_response (ctx, responses[i], NULL))
+            return;
+    }
+
+    at_sequence_run_next (ctx);
+}
+
+static gboolean
+command_is_batchable (const MMBaseModemAtCommand *command)
+{
+    /* Only extended commands (+, ^, _, $, %...), given without the AT
+     * prefix, can be joined in a compound command line */
+    return (command->command &&
+            command->batchable &&
+            command->command[0] &&
+            !g_ascii_isalnum (command->command[0]) &&
+            command->command[0] != '&' &&
+            !strchr (command->command, ';'));
+}
+
+static void
+at_sequence_run_next (AtSequenceContext *ctx)
+{
+    guint n = 0;
+
+    if (mm_base_modem_at_batching_allowed (ctx->self)) {
+        while (n < MAX_BATCH_COMMANDS && command_is_batchable (&ctx->current[n]))
+            n++;
+    }
+
+    if (n > 1) {
+        g_autoptr(GString) compound = NULL;
+        guint              timeout = 0;
+        gboolean           allow_cached = TRUE;
+        guint              i;
+
+        compound = g_string_new (NULL);
+        for (i = 0; i < n; i++) {
+            g_string_append_printf (compound, "%s%s", i ? ";" : "", ctx->current[i].command);
+            timeout += ctx->current[i].timeout;
+            allow_cached &= ctx->current[i].allow_cached;
+        }
+
+        ctx->batch_len = n;
+        mm_port_serial_at_command (
+            ctx->port,
+            compound->str,
+            timeout,
+            FALSE,
+            allow_cached,
+            ctx->cancellable,
+            (GAsyncReadyCallback)at_sequence_parse_compound_response,
+            ctx);
+        return;
+    }
+
+    mm_port_serial_at_command (
+        ctx->port,
+        ctx->current->command,
+        ctx->current->timeout,
+        FALSE,
+        ctx->current->allow_cached,
+        ctx->cancellable,
+        (GAsyncReadyCallback)at_sequence_parse_response,
+        ctx);
 }
 
 void
@@ -295,16 +429,8 @@ mm_base_modem_at_sequence_full (MMBaseModem                *self,
                                                    NULL);
     }
 
-    /* Go on with the first one in the sequence */
-    mm_port_serial_at_command (
-        ctx->port,
-        ctx->current->command,
-        ctx->current->timeout,
-        FALSE,
-        ctx->current->allow_cached,
-        ctx->cancellable,
-        (GAsyncReadyCallback)at_sequence_parse_response,
-        ctx);
+    /* Go on with the first one(s) in the sequence */
+    at_sequence_run_next (ctx);
 }
 
 GVariant *
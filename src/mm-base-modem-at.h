@@ -67,6 +67,13 @@ typedef struct {
     gboolean allow_cached;
     /* The response processor */
     MMBaseModemAtResponseProcessor response_processor;
+    /* Flag to allow sending the command together with the contiguous ones
+     * also flagged, as a single compound command line. Only for commands
+     * that are safe to run even if a previous one ends the sequence, and
+     * which never reply more than one line without the command prefix.
+     * Only commands within the same sequence are joined; single command
+     * operations (e.g. the identity loads) are never batched. */
+    gboolean batchable;
 } MMBaseModemAtCommand;
 
 /* Generic AT sequence handling, using the best AT port available and without
@@ -220,6 +227,7 @@ typedef struct {
     guint     timeout;
     gboolean  allow_cached;
     MMBaseModemAtResponseProcessor response_processor;
+    gboolean  batchable;
 } MMBaseModemAtCommandAlloc;
 
 G_STATIC_ASSERT (sizeof (MMBaseModemAtCommandAlloc) == sizeof (MMBaseModemAtCommand));
@@ -227,6 +235,7 @@ G_STATIC_ASSERT (G_STRUCT_OFFSET (MMBaseModemAtCommandAlloc, command)
 G_STATIC_ASSERT (G_STRUCT_OFFSET (MMBaseModemAtCommandAlloc, timeout)            == G_STRUCT_OFFSET (MMBaseModemAtCommand, timeout));
 G_STATIC_ASSERT (G_STRUCT_OFFSET (MMBaseModemAtCommandAlloc, allow_cached)       == G_STRUCT_OFFSET (MMBaseModemAtCommand, allow_cached));
 G_STATIC_ASSERT (G_STRUCT_OFFSET (MMBaseModemAtCommandAlloc, response_processor) == G_STRUCT_OFFSET (MMBaseModemAtCommand, response_processor));
+G_STATIC_ASSERT (G_STRUCT_OFFSET (MMBaseModemAtCommandAlloc, batchable)          == G_STRUCT_OFFSET (MMBaseModemAtCommand, batchable));
 
 void mm_base_modem_at_command_alloc_clear (MMBaseModemAtCommandAlloc *command);
 
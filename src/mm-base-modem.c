@@ -35,6 +35,8 @@
 #endif
 
 #include "mm-log-object.h"
+#include "mm-kernel-device-generic.h"
+#include "mm-netlink.h"
 #include "mm-port-enums-types.h"
 #include "mm-serial-parsers.h"
 #include "mm-modem-helpers.h"
@@ -48,6 +50,9 @@ G_DEFINE_ABSTRACT_TYPE_WITH_CODE (MMBaseModem, mm_base_modem, MM_GDBUS_TYPE_OBJE
  * invalid and we request re-probing. */
 #define DEFAULT_MAX_TIMEOUTS 10
 
+/* Property updates in the status interfaces are batched during 200ms */
+#define DEFAULT_PROPERTIES_BATCH_WINDOW 200
+
 enum {
     PROP_0,
     PROP_VALID,
@@ -61,6 +66,7 @@ enum {
     PROP_REPROBE,
     PROP_DATA_NET_SUPPORTED,
     PROP_DATA_TTY_SUPPORTED,
+    PROP_PROPERTIES_BATCH_WINDOW,
     PROP_LAST
 };
 
@@ -134,6 +140,22 @@ struct _MMBaseModemPrivate {
     /* Additional port links grabbed after having
      * organized ports */
     GHashTable *link_ports;
+
+    /* Port metrics interface */
+    MmGdbusModemMetrics *metrics_skeleton;
+
+    /* Batching of property updates, with the list of interface
+     * skeletons that have notifications frozen */
+    guint  properties_batch_window;
+    guint  properties_batch_id;
+    GList *properties_batch;
+
+    /* Periodic tasks of all interfaces and bearers */
+    MMPollScheduler *poll_scheduler;
+
+    /* Support of compound AT command lines, until known */
+    gboolean at_batching_checked;
+    gboolean at_batching_supported;
 };
 
 guint
@@ -432,9 +454,10 @@ mm_base_modem_grab_link_port (MMBaseModem     *self,
                               MMKernelDevice  *kernel_device,
                               GError         **error)
 {
-    const gchar *subsystem;
-    const gchar *name;
-    MMPort      *port;
+    const gchar      *subsystem;
+    const gchar      *name;
+    MMPort           *port;
+    g_autofree gchar *key = NULL;
 
     /* To simplify things, we only support NET link ports at this point */
     subsystem = mm_kernel_device_get_subsystem (kernel_device);
@@ -446,6 +469,18 @@ mm_base_modem_grab_link_port (MMBaseModem     *self,
         return FALSE;
     }
 
+    /* The link port may have already been grabbed as soon as the kernel
+     * reported the new link, before the kernel device event was processed;
+     * if so, just take the new kernel device, which is the one that will
+     * include all udev tags */
+    key  = g_strdup_printf ("%s%s", subsystem, name);
+    port = g_hash_table_lookup (self->priv->link_ports, key);
+    if (port) {
+        mm_port_update_kernel_device (port, kernel_device);
+        mm_obj_dbg (self, "link port '%s/%s' kernel device updated", subsystem, name);
+        return TRUE;
+    }
+
     /* all the newly added link ports will NOT be 'organized'; i.e. they won't
      * be available as 'data ports' in the modem, but they can be looked up
      * by name */
@@ -498,6 +533,8 @@ typedef struct {
     guint   timeout_id;
 } WaitLinkPortContext;
 
+#define WAIT_LINK_PORT_COMPLETED(ctx) (!(ctx)->timeout_id && !(ctx)->link_port_grabbed_id)
+
 static void
 wait_link_port_context_free (WaitLinkPortContext *ctx)
 {
@@ -571,10 +608,60 @@ wait_link_port_grabbed_cb (MMBaseModem *self,
     g_object_unref (task);
 }
 
+static void
+wait_link_port_netlink_ready (MMNetlink    *netlink,
+                              GAsyncResult *res,
+                              GTask        *task)
+{
+    MMBaseModem                        *self;
+    WaitLinkPortContext                *ctx;
+    guint                               ifindex;
+    g_autoptr(GError)                   error = NULL;
+    g_autoptr(MMKernelDevice)           kernel_device = NULL;
+    g_autoptr(MMKernelEventProperties)  props = NULL;
+
+    self = g_task_get_source_object (task);
+    ctx  = g_task_get_task_data     (task);
+
+    /* Errors here are not fatal, the link port may still be reported by the
+     * kernel device event path before the timeout */
+    ifindex = mm_netlink_wait_link_finish (netlink, res, &error);
+    if (!ifindex) {
+        if (!WAIT_LINK_PORT_COMPLETED (ctx))
+            mm_obj_dbg (self, "couldn't wait for link 'net/%s' via netlink: %s", ctx->name, error->message);
+        goto out;
+    }
+
+    /* Already reported by the kernel device event path */
+    if (WAIT_LINK_PORT_COMPLETED (ctx))
+        goto out;
+
+    /* The kernel created the link: grab it right away instead of waiting for
+     * udev to process the new device. The link port grabbed signal completes
+     * the wait. */
+    mm_obj_dbg (self, "link 'net/%s' created by the kernel (ifindex %u)", ctx->name, ifindex);
+    props = mm_kernel_event_properties_new ();
+    mm_kernel_event_properties_set_action    (props, "add");
+    mm_kernel_event_properties_set_subsystem (props, "net");
+    mm_kernel_event_properties_set_name      (props, ctx->name);
+    kernel_device = mm_kernel_device_generic_new_with_rules (props, NULL, &error);
+    if (!kernel_device) {
+        mm_obj_dbg (self, "couldn't create kernel device for link 'net/%s': %s", ctx->name, error->message);
+        goto out;
+    }
+
+    if (!mm_base_modem_grab_link_port (self, kernel_device, &error))
+        mm_obj_dbg (self, "couldn't grab link port 'net/%s': %s", ctx->name, error->message);
+
+out:
+    g_object_unref (task);
+}
+
 void
 mm_base_modem_wait_link_port (MMBaseModem         *self,
                               const gchar         *subsystem,
                               const gchar         *name,
+                              guint                mux_id,
                               guint                timeout_ms,
                               GAsyncReadyCallback  callback,
                               gpointer             user_data)
@@ -615,6 +702,15 @@ mm_base_modem_wait_link_port (MMBaseModem         *self,
                                                   G_CALLBACK (wait_link_port_grabbed_cb),
                                                   task);
 
+    /* Also wait for the kernel to report the new link via netlink, which is
+     * usually much sooner than the kernel device event being processed */
+    mm_netlink_wait_link (mm_netlink_get (), /* singleton */
+                          name,
+                          mux_id,
+                          timeout_ms,
+                          (GAsyncReadyCallback) wait_link_port_netlink_ready,
+                          g_object_ref (task));
+
     mm_obj_dbg (self, "waiting for port '%s/%s'...", subsystem, name);
 }
 
@@ -1625,6 +1721,210 @@ mm_base_modem_authorize (MMBaseModem *self,
                                 task);
 }
 
+/*****************************************************************************/
+/* Property update batching */
+
+static GList *
+get_status_interfaces (MMBaseModem *self)
+{
+    GList    *list = NULL;
+    gpointer  skeleton;
+
+    if ((skeleton = mm_gdbus_object_get_modem (MM_GDBUS_OBJECT (self))) != NULL)
+        list = g_list_prepend (list, skeleton);
+    if ((skeleton = mm_gdbus_object_get_modem3gpp (MM_GDBUS_OBJECT (self))) != NULL)
+        list = g_list_prepend (list, skeleton);
+    if ((skeleton = mm_gdbus_object_get_modem_cdma (MM_GDBUS_OBJECT (self))) != NULL)
+        list = g_list_prepend (list, skeleton);
+    if ((skeleton = mm_gdbus_object_get_modem_location (MM_GDBUS_OBJECT (self))) != NULL)
+        list = g_list_prepend (list, skeleton);
+    if ((skeleton = mm_gdbus_object_get_modem_signal (MM_GDBUS_OBJECT (self))) != NULL)
+        list = g_list_prepend (list, skeleton);
+    if ((skeleton = mm_gdbus_object_get_modem_time (MM_GDBUS_OBJECT (self))) != NULL)
+        list = g_list_prepend (list, skeleton);
+    return list;
+}
+
+static void
+properties_batch_release (MMBaseModem *self)
+{
+    GList *l;
+
+    if (self->priv->properties_batch_id) {
+        g_source_remove (self->priv->properties_batch_id);
+        self->priv->properties_batch_id = 0;
+    }
+
+    /* Thawing queues all the changes held in each skeleton, which are then
+     * emitted in a single PropertiesChanged signal per interface */
+    for (l = self->priv->properties_batch; l; l = g_list_next (l))
+        g_object_thaw_notify (G_OBJECT (l->data));
+    g_list_free_full (g_steal_pointer (&self->priv->properties_batch), g_object_unref);
+}
+
+static gboolean
+properties_batch_timeout_cb (MMBaseModem *self)
+{
+    self->priv->properties_batch_id = 0;
+    properties_batch_release (self);
+    return G_SOURCE_REMOVE;
+}
+
+void
+mm_base_modem_batch_properties (MMBaseModem *self)
+{
+    GList *l;
+
+    /* Already batching, or disabled */
+    if (self->priv->properties_batch_id || !self->priv->properties_batch_window)
+        return;
+
+    self->priv->properties_batch = get_status_interfaces (self);
+    for (l = self->priv->properties_batch; l; l = g_list_next (l))
+        g_object_freeze_notify (G_OBJECT (l->data));
+
+    self->priv->properties_batch_id = g_timeout_add (self->priv->properties_batch_window,
+                                                     (GSourceFunc) properties_batch_timeout_cb,
+                                                     self);
+}
+
+void
+mm_base_modem_flush_properties (MMBaseModem *self)
+{
+    GList *interfaces;
+    GList *l;
+
+    properties_batch_release (self);
+
+    interfaces = get_status_interfaces (self);
+    for (l = interfaces; l; l = g_list_next (l))
+        g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (l->data));
+    g_list_free_full (interfaces, g_object_unref);
+}
+
+/*****************************************************************************/
+
+MMPollScheduler *
+mm_base_modem_peek_poll_scheduler (MMBaseModem *self)
+{
+    return self->priv->poll_scheduler;
+}
+
+/*****************************************************************************/
+
+gboolean
+mm_base_modem_at_batching_allowed (MMBaseModem *self)
+{
+    /* Allowed until proven unsupported */
+    return !self->priv->at_batching_checked || self->priv->at_batching_supported;
+}
+
+void
+mm_base_modem_at_batching_report (MMBaseModem *self,
+                                  gboolean     supported)
+{
+    /* A failure disables batching even if a previous compound line
+     * succeeded; a success only enables it the first time */
+    if (self->priv->at_batching_checked &&
+        (supported || !self->priv->at_batching_supported))
+        return;
+
+    self->priv->at_batching_checked = TRUE;
+    self->priv->at_batching_supported = supported;
+    mm_obj_dbg (self, "compound AT command lines %s", supported ? "supported" : "unsupported, disabled");
+}
+
+/*****************************************************************************/
+/* Port metrics */
+
+typedef struct {
+    MMBaseModem           *self;
+    MmGdbusModemMetrics   *skeleton;
+    GDBusMethodInvocation *invocation;
+} HandleGetMetricsContext;
+
+static void
+handle_get_metrics_context_free (HandleGetMetricsContext *ctx)
+{
+    g_object_unref (ctx->invocation);
+    g_object_unref (ctx->skeleton);
+    g_object_unref (ctx->self);
+    g_slice_free (HandleGetMetricsContext, ctx);
+}
+
+static void
+add_ports_metrics (MMBaseModem     *self,
+                   GVariantBuilder *builder,
+                   GHashTable      *ports)
+{
+    GHashTableIter  iter;
+    MMPort         *port;
+
+    if (!ports)
+        return;
+
+    g_hash_table_iter_init (&iter, ports);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&port)) {
+        GVariant     *metrics;
+        GVariantDict  dict;
+
+        metrics = mm_port_metrics_build_dictionary (mm_port_peek_metrics (port),
+                                                    mm_port_get_device (port));
+        if (!MM_BASE_MODEM_GET_CLASS (self)->add_port_metrics) {
+            g_variant_builder_add_value (builder, metrics);
+            continue;
+        }
+
+        g_variant_dict_init (&dict, metrics);
+        g_variant_unref (g_variant_ref_sink (metrics));
+        MM_BASE_MODEM_GET_CLASS (self)->add_port_metrics (self, port, &dict);
+        g_variant_builder_add_value (builder, g_variant_dict_end (&dict));
+    }
+}
+
+static void
+handle_get_metrics_auth_ready (MMBaseModem             *self,
+                               GAsyncResult            *res,
+                               HandleGetMetricsContext *ctx)
+{
+    GError          *error = NULL;
+    GVariantBuilder  builder;
+
+    if (!mm_base_modem_authorize_finish (self, res, &error)) {
+        g_dbus_method_invocation_take_error (ctx->invocation, error);
+        handle_get_metrics_context_free (ctx);
+        return;
+    }
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa{sv}"));
+    add_ports_metrics (self, &builder, self->priv->ports);
+    add_ports_metrics (self, &builder, self->priv->link_ports);
+    mm_gdbus_modem_metrics_complete_get_metrics (ctx->skeleton,
+                                                 ctx->invocation,
+                                                 g_variant_builder_end (&builder));
+    handle_get_metrics_context_free (ctx);
+}
+
+static gboolean
+handle_get_metrics (MmGdbusModemMetrics   *skeleton,
+                    GDBusMethodInvocation *invocation,
+                    MMBaseModem           *self)
+{
+    HandleGetMetricsContext *ctx;
+
+    ctx = g_slice_new (HandleGetMetricsContext);
+    ctx->invocation = g_object_ref (invocation);
+    ctx->skeleton = g_object_ref (skeleton);
+    ctx->self = g_object_ref (self);
+
+    mm_base_modem_authorize (self,
+                             invocation,
+                             MM_AUTHORIZATION_DEVICE_CONTROL,
+                             (GAsyncReadyCallback)handle_get_metrics_auth_ready,
+                             ctx);
+    return TRUE;
+}
+
 /*****************************************************************************/
 
 const gchar *
@@ -1809,9 +2109,20 @@ mm_base_modem_init (MMBaseModem *self)
                                NULL);
 
     self->priv->max_timeouts = DEFAULT_MAX_TIMEOUTS;
+    self->priv->properties_batch_window = DEFAULT_PROPERTIES_BATCH_WINDOW;
+    self->priv->poll_scheduler = mm_poll_scheduler_new (self);
 
     setup_ports_table (&self->priv->ports);
     setup_ports_table (&self->priv->link_ports);
+
+    /* The port metrics are available as soon as the modem is exported */
+    self->priv->metrics_skeleton = mm_gdbus_modem_metrics_skeleton_new ();
+    g_signal_connect (self->priv->metrics_skeleton,
+                      "handle-get-metrics",
+                      G_CALLBACK (handle_get_metrics),
+                      self);
+    mm_gdbus_object_skeleton_set_modem_metrics (MM_GDBUS_OBJECT_SKELETON (self),
+                                                self->priv->metrics_skeleton);
 }
 
 static void
@@ -1860,6 +2171,9 @@ set_property (GObject *object,
     case PROP_DATA_TTY_SUPPORTED:
         self->priv->data_tty_supported = g_value_get_boolean (value);
         break;
+    case PROP_PROPERTIES_BATCH_WINDOW:
+        self->priv->properties_batch_window = g_value_get_uint (value);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
         break;
@@ -1908,6 +2222,9 @@ get_property (GObject *object,
     case PROP_DATA_TTY_SUPPORTED:
         g_value_set_boolean (value, self->priv->data_tty_supported);
         break;
+    case PROP_PROPERTIES_BATCH_WINDOW:
+        g_value_set_uint (value, self->priv->properties_batch_window);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
         break;
@@ -1932,6 +2249,9 @@ finalize (GObject *object)
     g_strfreev (self->priv->drivers);
     g_free (self->priv->plugin);
 
+    /* Users of the scheduler may still hold a reference */
+    mm_poll_scheduler_unref (self->priv->poll_scheduler);
+
     G_OBJECT_CLASS (mm_base_modem_parent_class)->finalize (object);
 }
 
@@ -1971,6 +2291,13 @@ dispose (GObject *object)
     teardown_ports_table (self, &self->priv->link_ports);
     teardown_ports_table (self, &self->priv->ports);
 
+    properties_batch_release (self);
+
+    if (self->priv->metrics_skeleton) {
+        mm_gdbus_object_skeleton_set_modem_metrics (MM_GDBUS_OBJECT_SKELETON (self), NULL);
+        g_clear_object (&self->priv->metrics_skeleton);
+    }
+
     g_clear_object (&self->priv->connection);
 
     G_OBJECT_CLASS (mm_base_modem_parent_class)->dispose (object);
@@ -2084,6 +2411,15 @@ mm_base_modem_class_init (MMBaseModemClass *klass)
                               G_PARAM_READWRITE);
     g_object_class_install_property (object_class, PROP_DATA_TTY_SUPPORTED, properties[PROP_DATA_TTY_SUPPORTED]);
 
+    properties[PROP_PROPERTIES_BATCH_WINDOW] =
+        g_param_spec_uint (MM_BASE_MODEM_PROPERTIES_BATCH_WINDOW,
+                           "Properties batch window",
+                           "Time during which property updates in the status interfaces are "
+                           "batched together, in milliseconds. If 0, this feature is disabled.",
+                           0, G_MAXUINT, DEFAULT_PROPERTIES_BATCH_WINDOW,
+                           G_PARAM_READWRITE);
+    g_object_class_install_property (object_class, PROP_PROPERTIES_BATCH_WINDOW, properties[PROP_PROPERTIES_BATCH_WINDOW]);
+
     signals[SIGNAL_LINK_PORT_GRABBED] =
         g_signal_new (MM_BASE_MODEM_SIGNAL_LINK_PORT_GRABBED,
                       G_OBJECT_CLASS_TYPE (object_class),
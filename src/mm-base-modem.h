@@ -35,6 +35,7 @@
 #include "mm-port-serial-at.h"
 #include "mm-port-serial-qcdm.h"
 #include "mm-port-serial-gps.h"
+#include "mm-poll-scheduler.h"
 
 #if defined WITH_QMI
 #include "mm-port-qmi.h"
@@ -66,6 +67,7 @@ typedef struct _MMBaseModemPrivate MMBaseModemPrivate;
 #define MM_BASE_MODEM_REPROBE            "base-modem-reprobe"
 #define MM_BASE_MODEM_DATA_NET_SUPPORTED "base-modem-data-net-supported"
 #define MM_BASE_MODEM_DATA_TTY_SUPPORTED "base-modem-data-tty-supported"
+#define MM_BASE_MODEM_PROPERTIES_BATCH_WINDOW "base-modem-properties-batch-window"
 
 #define MM_BASE_MODEM_SIGNAL_LINK_PORT_GRABBED  "base-modem-link-port-grabbed"
 #define MM_BASE_MODEM_SIGNAL_LINK_PORT_RELEASED "base-modem-link-port-released"
@@ -120,6 +122,11 @@ struct _MMBaseModemClass {
                               GError **error);
 #endif
 
+    /* Optional metrics reported along with the ones of the given port */
+    void (* add_port_metrics) (MMBaseModem  *self,
+                               MMPort       *port,
+                               GVariantDict *dict);
+
     /* signals */
     void (* link_port_grabbed)  (MMBaseModem *self,
                                  MMPort      *link_port);
@@ -148,6 +155,7 @@ gboolean  mm_base_modem_release_link_port (MMBaseModem         *self,
 void      mm_base_modem_wait_link_port        (MMBaseModem          *self,
                                                const gchar          *subsystem,
                                                const gchar          *name,
+                                               guint                 mux_id,
                                                guint                 timeout_ms,
                                                GAsyncReadyCallback   callback,
                                                gpointer              user_data);
@@ -256,4 +264,23 @@ gboolean mm_base_modem_sync_finish    (MMBaseModem *self,
 
 void mm_base_modem_process_sim_event (MMBaseModem *self);
 
+/* Batching of property updates in the status interfaces (Modem, 3GPP, CDMA,
+ * Location, Signal, Time). Once a batch is started, all the changes done in
+ * those interfaces are emitted together when the batch window expires; an
+ * urgent change (e.g. one that must be seen by clients before a signal is
+ * emitted) must flush all the pending changes right away. */
+void mm_base_modem_batch_properties (MMBaseModem *self);
+void mm_base_modem_flush_properties (MMBaseModem *self);
+
+/* Scheduler of the periodic tasks (polling) of the modem, shared by all its
+ * interfaces and bearers so that they run in the same wakeups */
+MMPollScheduler *mm_base_modem_peek_poll_scheduler (MMBaseModem *self);
+
+/* Support of compound AT command lines (several commands joined with ';'),
+ * assumed until the first compound line either succeeds or fails. Any
+ * failed compound line disables it for good, even after a successful one. */
+gboolean mm_base_modem_at_batching_allowed (MMBaseModem *self);
+void     mm_base_modem_at_batching_report  (MMBaseModem *self,
+                                            gboolean     supported);
+
 #endif /* MM_BASE_MODEM_H */
@@ -32,6 +32,11 @@
 #include "mm-base-modem.h"
 #include "mm-log-object.h"
 #include "mm-modem-helpers.h"
+#include "mm-sim-cache.h"
+#include "mm-context.h"
+
+/* Delay before reloading the properties served from the cache */
+#define SIM_CACHE_REVALIDATE_DELAY_SECS 30
 
 static void async_initable_iface_init (GAsyncInitableIface *iface);
 static void log_object_iface_init     (MMLogObjectInterface *iface);
@@ -69,6 +74,11 @@ struct _MMBaseSimPrivate {
     /* The SIM slot number, which will be 0 always if the system
      * doesn't support multiple SIMS. */
      guint slot_number;
+
+    /* Background reload of the properties served from the cache */
+    guint         cache_revalidate_id;
+    GCancellable *cache_revalidate_cancellable;
+    gboolean      cache_invalidated;
 };
 
 static guint signals[SIGNAL_LAST] = { 0 };
@@ -1430,6 +1440,8 @@ set_preferred_networks (MMBaseSim *self,
 /*****************************************************************************/
 /* SET PREFERRED NETWORKS (DBus call handling) */
 
+static void sim_cache_store (MMBaseSim *self);
+
 typedef struct {
     MMBaseSim             *self;
     GDBusMethodInvocation *invocation;
@@ -1458,6 +1470,9 @@ handle_set_preferred_networks_ready (MMBaseSim *self,
         g_dbus_method_invocation_take_error (ctx->invocation, g_steal_pointer (&error));
     } else {
         mm_gdbus_sim_set_preferred_networks (MM_GDBUS_SIM (self), ctx->networks);
+        /* Rewrite the cache entry, so that the next initialization doesn't
+         * expose the old list */
+        sim_cache_store (self);
         mm_gdbus_sim_complete_set_preferred_networks (MM_GDBUS_SIM (self), ctx->invocation);
     }
 
@@ -2251,6 +2266,7 @@ typedef enum {
     INITIALIZATION_STEP_FIRST,
     INITIALIZATION_STEP_WAIT_READY,
     INITIALIZATION_STEP_SIM_IDENTIFIER,
+    INITIALIZATION_STEP_CACHE,
     INITIALIZATION_STEP_IMSI,
     INITIALIZATION_STEP_EID,
     INITIALIZATION_STEP_OPERATOR_ID,
@@ -2263,6 +2279,11 @@ typedef enum {
 struct _InitAsyncContext {
     InitializationStep step;
     guint sim_identifier_tries;
+    /* Properties served from the cache, nothing to load */
+    gboolean from_cache;
+    /* Reloading the properties served from the cache; previous values are
+     * kept on errors */
+    gboolean revalidate;
 };
 
 MMBaseSim *
@@ -2364,18 +2385,19 @@ init_load_preferred_networks_ready (MMBaseSim    *self,
     GError           *error = NULL;
     GList            *preferred_nets_list;
 
+    ctx = g_task_get_task_data (task);
+
     preferred_nets_list = MM_BASE_SIM_GET_CLASS (self)->load_preferred_networks_finish (self, res, &error);
-    if (error) {
+    if (error)
         mm_obj_warn (self, "couldn't load list of preferred networks: %s", error->message);
-        g_error_free (error);
-    }
 
-    mm_gdbus_sim_set_preferred_networks (MM_GDBUS_SIM (self),
-                                         mm_sim_preferred_network_list_get_variant (preferred_nets_list));
+    if (!error || !ctx->revalidate)
+        mm_gdbus_sim_set_preferred_networks (MM_GDBUS_SIM (self),
+                                             mm_sim_preferred_network_list_get_variant (preferred_nets_list));
     g_list_free_full (preferred_nets_list, (GDestroyNotify) mm_sim_preferred_network_free);
+    g_clear_error (&error);
 
     /* Go on to next step */
-    ctx = g_task_get_task_data (task);
     ctx->step++;
     interface_initialization_step (task);
 }
@@ -2391,8 +2413,10 @@ init_load_preferred_networks_ready (MMBaseSim    *self,
         GError *error = NULL;                                           \
         gchar *val;                                                     \
                                                                         \
+        ctx = g_task_get_task_data (task);                              \
         val = MM_BASE_SIM_GET_CLASS (self)->load_##NAME##_finish (self, res, &error); \
-        mm_gdbus_sim_set_##NAME (MM_GDBUS_SIM (self), val);             \
+        if (val || !ctx->revalidate)                                    \
+            mm_gdbus_sim_set_##NAME (MM_GDBUS_SIM (self), val);         \
         g_free (val);                                                   \
                                                                         \
         if (error) {                                                    \
@@ -2401,7 +2425,6 @@ init_load_preferred_networks_ready (MMBaseSim    *self,
         }                                                               \
                                                                         \
         /* Go on to next step */                                        \
-        ctx = g_task_get_task_data (task);                              \
         ctx->step++;                                                    \
         interface_initialization_step (task);                           \
     }
@@ -2411,6 +2434,128 @@ STR_REPLY_READY_FN (eid, "EID")
 STR_REPLY_READY_FN (operator_identifier, "operator identifier")
 STR_REPLY_READY_FN (operator_name, "operator name")
 
+/*****************************************************************************/
+/* SIM cache */
+
+static gboolean
+sim_cache_apply (MMBaseSim *self)
+{
+    g_autoptr(MMSimCacheEntry)  entry = NULL;
+    g_autoptr(GError)           error = NULL;
+    const gchar                *iccid;
+
+    /* Never expose the contents of a locked SIM */
+    iccid = mm_gdbus_sim_get_sim_identifier (MM_GDBUS_SIM (self));
+    if (!iccid ||
+        !self->priv->modem ||
+        mm_iface_modem_get_unlock_required (MM_IFACE_MODEM (self->priv->modem)) != MM_MODEM_LOCK_NONE)
+        return FALSE;
+
+    entry = mm_sim_cache_load (mm_context_get_test_sim_cache_dir (), iccid, &error);
+    if (!entry) {
+        if (error)
+            mm_obj_warn (self, "couldn't load SIM cache entry: %s", error->message);
+        return FALSE;
+    }
+
+    mm_obj_dbg (self, "SIM properties loaded from cache");
+    mm_gdbus_sim_set_imsi (MM_GDBUS_SIM (self), entry->imsi);
+    mm_gdbus_sim_set_eid (MM_GDBUS_SIM (self), entry->eid);
+    mm_gdbus_sim_set_operator_identifier (MM_GDBUS_SIM (self), entry->operator_identifier);
+    mm_gdbus_sim_set_operator_name (MM_GDBUS_SIM (self), entry->operator_name);
+    if (entry->emergency_numbers)
+        mm_gdbus_sim_set_emergency_numbers (MM_GDBUS_SIM (self), (const gchar *const *) entry->emergency_numbers);
+    if (entry->preferred_networks)
+        mm_gdbus_sim_set_preferred_networks (MM_GDBUS_SIM (self), entry->preferred_networks);
+    return TRUE;
+}
+
+static void
+sim_cache_store (MMBaseSim *self)
+{
+    g_autoptr(MMSimCacheEntry)  entry = NULL;
+    g_autoptr(GError)           error = NULL;
+    const gchar                *iccid;
+    GVariant                   *preferred_networks;
+
+    /* Not worth caching without the IMSI, which may have failed to load
+     * because the SIM wasn't ready yet */
+    iccid = mm_gdbus_sim_get_sim_identifier (MM_GDBUS_SIM (self));
+    if (!iccid || !mm_gdbus_sim_get_imsi (MM_GDBUS_SIM (self)) || self->priv->cache_invalidated)
+        return;
+
+    entry = mm_sim_cache_entry_new ();
+    entry->imsi = g_strdup (mm_gdbus_sim_get_imsi (MM_GDBUS_SIM (self)));
+    entry->eid = g_strdup (mm_gdbus_sim_get_eid (MM_GDBUS_SIM (self)));
+    entry->operator_identifier = g_strdup (mm_gdbus_sim_get_operator_identifier (MM_GDBUS_SIM (self)));
+    entry->operator_name = g_strdup (mm_gdbus_sim_get_operator_name (MM_GDBUS_SIM (self)));
+    entry->emergency_numbers = g_strdupv ((gchar **) mm_gdbus_sim_get_emergency_numbers (MM_GDBUS_SIM (self)));
+    preferred_networks = mm_gdbus_sim_get_preferred_networks (MM_GDBUS_SIM (self));
+    if (preferred_networks)
+        entry->preferred_networks = g_variant_ref (preferred_networks);
+
+    if (!mm_sim_cache_store (mm_context_get_test_sim_cache_dir (), iccid, entry, &error))
+        mm_obj_warn (self, "couldn't store SIM cache entry: %s", error->message);
+}
+
+static void
+sim_cache_revalidate_ready (MMBaseSim    *self,
+                            GAsyncResult *res)
+{
+    g_autoptr(GError) error = NULL;
+
+    g_clear_object (&self->priv->cache_revalidate_cancellable);
+    if (!g_task_propagate_boolean (G_TASK (res), &error))
+        mm_obj_dbg (self, "couldn't reload cached SIM properties: %s", error->message);
+}
+
+static gboolean
+sim_cache_revalidate_cb (MMBaseSim *self)
+{
+    InitAsyncContext *ctx;
+    GTask            *task;
+
+    self->priv->cache_revalidate_id = 0;
+
+    mm_obj_dbg (self, "reloading cached SIM properties...");
+    ctx = g_new0 (InitAsyncContext, 1);
+    ctx->step = INITIALIZATION_STEP_FIRST;
+    ctx->revalidate = TRUE;
+
+    g_assert (!self->priv->cache_revalidate_cancellable);
+    self->priv->cache_revalidate_cancellable = g_cancellable_new ();
+    task = g_task_new (self,
+                       self->priv->cache_revalidate_cancellable,
+                       (GAsyncReadyCallback) sim_cache_revalidate_ready,
+                       NULL);
+    g_task_set_task_data (task, ctx, g_free);
+    interface_initialization_step (task);
+    return G_SOURCE_REMOVE;
+}
+
+void
+mm_base_sim_invalidate_cache (MMBaseSim *self)
+{
+    const gchar *iccid;
+
+    if (self->priv->cache_revalidate_id) {
+        g_source_remove (self->priv->cache_revalidate_id);
+        self->priv->cache_revalidate_id = 0;
+    }
+    /* A reload in progress would store the entry again */
+    if (self->priv->cache_revalidate_cancellable)
+        g_cancellable_cancel (self->priv->cache_revalidate_cancellable);
+
+    self->priv->cache_invalidated = TRUE;
+    iccid = mm_gdbus_sim_get_sim_identifier (MM_GDBUS_SIM (self));
+    if (iccid) {
+        mm_obj_dbg (self, "SIM cache entry invalidated");
+        mm_sim_cache_remove (mm_context_get_test_sim_cache_dir (), iccid);
+    }
+}
+
+/*****************************************************************************/
+
 static void
 init_wait_sim_ready (MMBaseSim    *self,
                      GAsyncResult *res,
@@ -2448,7 +2593,8 @@ interface_initialization_step (GTask *task)
         /* Fall through */
 
     case INITIALIZATION_STEP_WAIT_READY:
-        if (MM_BASE_SIM_GET_CLASS (self)->wait_sim_ready &&
+        if (!ctx->revalidate &&
+            MM_BASE_SIM_GET_CLASS (self)->wait_sim_ready &&
             MM_BASE_SIM_GET_CLASS (self)->wait_sim_ready_finish) {
             MM_BASE_SIM_GET_CLASS (self)->wait_sim_ready (
                 self,
@@ -2475,11 +2621,19 @@ interface_initialization_step (GTask *task)
         ctx->step++;
         /* Fall through */
 
+    case INITIALIZATION_STEP_CACHE:
+        /* The properties of a known SIM are served from the cache right away,
+         * and reloaded in the background once the initialization is done */
+        if (!ctx->revalidate)
+            ctx->from_cache = sim_cache_apply (self);
+        ctx->step++;
+        /* Fall through */
+
     case INITIALIZATION_STEP_IMSI:
         /* IMSI is meant to be loaded only once during the whole
          * lifetime of the modem. Therefore, if we already have them loaded,
          * don't try to load them again. */
-        if (mm_gdbus_sim_get_imsi (MM_GDBUS_SIM (self)) == NULL &&
+        if ((ctx->revalidate || (!ctx->from_cache && mm_gdbus_sim_get_imsi (MM_GDBUS_SIM (self)) == NULL)) &&
             MM_BASE_SIM_GET_CLASS (self)->load_imsi &&
             MM_BASE_SIM_GET_CLASS (self)->load_imsi_finish) {
             MM_BASE_SIM_GET_CLASS (self)->load_imsi (
@@ -2495,7 +2649,7 @@ interface_initialization_step (GTask *task)
         /* EID is meant to be loaded only once during the whole
          * lifetime of the modem. Therefore, if we already have them loaded,
          * don't try to load them again. */
-        if (mm_gdbus_sim_get_eid (MM_GDBUS_SIM (self)) == NULL &&
+        if ((ctx->revalidate || (!ctx->from_cache && mm_gdbus_sim_get_eid (MM_GDBUS_SIM (self)) == NULL)) &&
             MM_BASE_SIM_GET_CLASS (self)->load_eid &&
             MM_BASE_SIM_GET_CLASS (self)->load_eid_finish) {
             MM_BASE_SIM_GET_CLASS (self)->load_eid (
@@ -2511,7 +2665,7 @@ interface_initialization_step (GTask *task)
         /* Operator ID is meant to be loaded only once during the whole
          * lifetime of the modem. Therefore, if we already have them loaded,
          * don't try to load them again. */
-        if (mm_gdbus_sim_get_operator_identifier (MM_GDBUS_SIM (self)) == NULL &&
+        if ((ctx->revalidate || (!ctx->from_cache && mm_gdbus_sim_get_operator_identifier (MM_GDBUS_SIM (self)) == NULL)) &&
             MM_BASE_SIM_GET_CLASS (self)->load_operator_identifier &&
             MM_BASE_SIM_GET_CLASS (self)->load_operator_identifier_finish) {
             MM_BASE_SIM_GET_CLASS (self)->load_operator_identifier (
@@ -2527,7 +2681,7 @@ interface_initialization_step (GTask *task)
         /* Operator Name is meant to be loaded only once during the whole
          * lifetime of the modem. Therefore, if we already have them loaded,
          * don't try to load them again. */
-        if (mm_gdbus_sim_get_operator_name (MM_GDBUS_SIM (self)) == NULL &&
+        if ((ctx->revalidate || (!ctx->from_cache && mm_gdbus_sim_get_operator_name (MM_GDBUS_SIM (self)) == NULL)) &&
             MM_BASE_SIM_GET_CLASS (self)->load_operator_name &&
             MM_BASE_SIM_GET_CLASS (self)->load_operator_name_finish) {
             MM_BASE_SIM_GET_CLASS (self)->load_operator_name (
@@ -2543,7 +2697,7 @@ interface_initialization_step (GTask *task)
         /* Emergency Numbers are meant to be loaded only once during the whole
          * lifetime of the modem. Therefore, if we already have them loaded,
          * don't try to load them again. */
-        if (mm_gdbus_sim_get_emergency_numbers (MM_GDBUS_SIM (self)) == NULL &&
+        if ((ctx->revalidate || (!ctx->from_cache && mm_gdbus_sim_get_emergency_numbers (MM_GDBUS_SIM (self)) == NULL)) &&
             MM_BASE_SIM_GET_CLASS (self)->load_emergency_numbers &&
             MM_BASE_SIM_GET_CLASS (self)->load_emergency_numbers_finish) {
             MM_BASE_SIM_GET_CLASS (self)->load_emergency_numbers (
@@ -2556,7 +2710,8 @@ interface_initialization_step (GTask *task)
         /* Fall through */
 
     case INITIALIZATION_STEP_PREFERRED_NETWORKS:
-        if (MM_BASE_SIM_GET_CLASS (self)->load_preferred_networks &&
+        if (!ctx->from_cache &&
+            MM_BASE_SIM_GET_CLASS (self)->load_preferred_networks &&
             MM_BASE_SIM_GET_CLASS (self)->load_preferred_networks_finish) {
             MM_BASE_SIM_GET_CLASS (self)->load_preferred_networks (
                 self,
@@ -2568,6 +2723,13 @@ interface_initialization_step (GTask *task)
         /* Fall through */
 
     case INITIALIZATION_STEP_LAST:
+        if (!ctx->from_cache)
+            sim_cache_store (self);
+        else if (!self->priv->cache_revalidate_id)
+            self->priv->cache_revalidate_id = g_timeout_add_seconds (SIM_CACHE_REVALIDATE_DELAY_SECS,
+                                                                     (GSourceFunc) sim_cache_revalidate_cb,
+                                                                     self);
+
         /* We are done without errors! */
         g_task_return_boolean (task, TRUE);
         g_object_unref (task);
@@ -2593,9 +2755,8 @@ common_init_async (GAsyncInitable *initable,
 
     self = MM_BASE_SIM (initable);
 
-    ctx = g_new (InitAsyncContext, 1);
+    ctx = g_new0 (InitAsyncContext, 1);
     ctx->step = INITIALIZATION_STEP_FIRST;
-    ctx->sim_identifier_tries = 0;
 
     task = g_task_new (self, cancellable, callback, user_data);
     g_task_set_task_data (task, ctx, g_free);
@@ -2772,6 +2933,13 @@ dispose (GObject *object)
 {
     MMBaseSim *self = MM_BASE_SIM (object);
 
+    if (self->priv->cache_revalidate_id) {
+        g_source_remove (self->priv->cache_revalidate_id);
+        self->priv->cache_revalidate_id = 0;
+    }
+    if (self->priv->cache_revalidate_cancellable)
+        g_cancellable_cancel (self->priv->cache_revalidate_cancellable);
+
     if (self->priv->connection) {
         /* If we arrived here with a valid connection, make sure we unexport
          * the object */
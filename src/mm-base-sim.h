@@ -230,4 +230,8 @@ gchar       *mm_base_sim_load_sim_identifier_finish (MMBaseSim *self,
 gboolean     mm_base_sim_is_emergency_number (MMBaseSim   *self,
                                               const gchar *number);
 
+/* Drops the cached properties of the SIM card, e.g. when the contents of
+ * the card may have changed */
+void         mm_base_sim_invalidate_cache    (MMBaseSim   *self);
+
 #endif /* MM_BASE_SIM_H */
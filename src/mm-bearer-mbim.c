@@ -32,6 +32,7 @@
 #include "mm-port-enums-types.h"
 #include "mm-bearer-mbim.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 
 G_DEFINE_TYPE (MMBearerMbim, mm_bearer_mbim, MM_TYPE_BASE_BEARER)
 
@@ -182,12 +183,12 @@ reload_stats (MMBaseBearer        *self,
 
     task = g_task_new (self, NULL, callback, user_data);
     message = (mbim_message_packet_statistics_query_new (NULL));
-    mbim_device_command (mm_port_mbim_peek_device (mbim),
-                         message,
-                         5,
-                         NULL,
-                         (GAsyncReadyCallback)packet_statistics_query_ready,
-                         task);
+    mm_port_mbim_device_command (mm_port_mbim_peek_device (mbim),
+                                 message,
+                                 5,
+                                 NULL,
+                                 (GAsyncReadyCallback)packet_statistics_query_ready,
+                                 task);
 }
 
 /*****************************************************************************/
@@ -798,6 +799,7 @@ setup_link_ready (MMPortMbim    *mbim,
     mm_base_modem_wait_link_port (modem,
                                   "net",
                                   ctx->link_name,
+                                  ctx->session_id,
                                   WAIT_LINK_PORT_TIMEOUT_MS,
                                   (GAsyncReadyCallback) wait_link_port_ready,
                                   task);
@@ -985,6 +987,7 @@ connect_context_step (GTask *task)
         /* Fall through */
 
     case CONNECT_STEP_LOAD_PROFILE_SETTINGS:
+        mm_trace_step (self, "connection", "load-profile-settings");
         if (ctx->profile_id != MM_3GPP_PROFILE_ID_UNKNOWN) {
             mm_obj_dbg (self, "loading connection settings from profile '%d'...", ctx->profile_id);
             mm_iface_modem_3gpp_profile_manager_get_profile (
@@ -998,17 +1001,19 @@ connect_context_step (GTask *task)
         /* Fall through */
 
     case CONNECT_STEP_PACKET_SERVICE:
+        mm_trace_step (self, "connection", "packet-service");
         mm_obj_dbg (self, "activating packet service...");
         message = mbim_message_packet_service_set_new (MBIM_PACKET_SERVICE_ACTION_ATTACH, NULL);
-        mbim_device_command (mm_port_mbim_peek_device (ctx->mbim),
-                             message,
-                             30,
-                             NULL,
-                             (GAsyncReadyCallback)packet_service_set_ready,
-                             task);
+        mm_port_mbim_device_command (mm_port_mbim_peek_device (ctx->mbim),
+                                     message,
+                                     30,
+                                     NULL,
+                                     (GAsyncReadyCallback)packet_service_set_ready,
+                                     task);
         return;
 
     case CONNECT_STEP_SETUP_LINK:
+        mm_trace_step (self, "connection", "setup-link");
         /* if a link prefix hint is available, it's because we should be doing
          * multiplexing */
         if (ctx->link_prefix_hint) {
@@ -1024,6 +1029,7 @@ connect_context_step (GTask *task)
         /* fall through */
 
     case CONNECT_STEP_SETUP_LINK_MASTER_UP:
+        mm_trace_step (self, "connection", "setup-link-master-up");
         /* if the connection is done through a new link, we need to ifup the master interface */
         if (ctx->link) {
             mm_obj_dbg (self, "bringing master interface %s up...", mm_port_get_device (ctx->data));
@@ -1039,6 +1045,7 @@ connect_context_step (GTask *task)
         /* fall through */
 
     case CONNECT_STEP_CHECK_DISCONNECTED:
+        mm_trace_step (self, "connection", "check-disconnected");
         mm_obj_dbg (self, "checking if session %u is disconnected...", ctx->session_id);
         message = mbim_message_connect_query_new (
                       ctx->session_id,
@@ -1048,15 +1055,16 @@ connect_context_step (GTask *task)
                       mbim_uuid_from_context_type (MBIM_CONTEXT_TYPE_INTERNET),
                       0,
                       NULL);
-        mbim_device_command (mm_port_mbim_peek_device (ctx->mbim),
-                             message,
-                             10,
-                             NULL,
-                             (GAsyncReadyCallback)check_disconnected_ready,
-                             task);
+        mm_port_mbim_device_command (mm_port_mbim_peek_device (ctx->mbim),
+                                     message,
+                                     10,
+                                     NULL,
+                                     (GAsyncReadyCallback)check_disconnected_ready,
+                                     task);
         return;
 
     case CONNECT_STEP_ENSURE_DISCONNECTED:
+        mm_trace_step (self, "connection", "ensure-disconnected");
         mm_obj_dbg (self, "ensuring session %u is disconnected...", ctx->session_id);
         message = mbim_message_connect_set_new (
                       ctx->session_id,
@@ -1069,15 +1077,16 @@ connect_context_step (GTask *task)
                       MBIM_CONTEXT_IP_TYPE_DEFAULT,
                       mbim_uuid_from_context_type (MBIM_CONTEXT_TYPE_INTERNET),
                       NULL);
-        mbim_device_command (mm_port_mbim_peek_device (ctx->mbim),
-                             message,
-                             MM_BASE_BEARER_DEFAULT_DISCONNECTION_TIMEOUT,
-                             NULL,
-                             (GAsyncReadyCallback)ensure_disconnected_ready,
-                             task);
+        mm_port_mbim_device_command (mm_port_mbim_peek_device (ctx->mbim),
+                                     message,
+                                     MM_BASE_BEARER_DEFAULT_DISCONNECTION_TIMEOUT,
+                                     NULL,
+                                     (GAsyncReadyCallback)ensure_disconnected_ready,
+                                     task);
         return;
 
     case CONNECT_STEP_CONNECT:
+        mm_trace_step (self, "connection", "connect");
         mm_obj_dbg (self, "launching %s connection in session %u...",
                     mbim_context_ip_type_get_string (ctx->requested_ip_type), ctx->session_id);
         message = mbim_message_connect_set_new (
@@ -1091,15 +1100,16 @@ connect_context_step (GTask *task)
                       ctx->requested_ip_type,
                       mbim_uuid_from_context_type (ctx->context_type),
                       NULL);
-        mbim_device_command (mm_port_mbim_peek_device (ctx->mbim),
-                             message,
-                             MM_BASE_BEARER_DEFAULT_CONNECTION_TIMEOUT,
-                             NULL,
-                             (GAsyncReadyCallback)connect_set_ready,
-                             task);
+        mm_port_mbim_device_command (mm_port_mbim_peek_device (ctx->mbim),
+                                     message,
+                                     MM_BASE_BEARER_DEFAULT_CONNECTION_TIMEOUT,
+                                     NULL,
+                                     (GAsyncReadyCallback)connect_set_ready,
+                                     task);
         return;
 
     case CONNECT_STEP_IP_CONFIGURATION:
+        mm_trace_step (self, "connection", "ip-configuration");
         mm_obj_dbg (self, "querying IP configuration...");
         message = mbim_message_ip_configuration_query_new (
                       ctx->session_id,
@@ -1118,12 +1128,12 @@ connect_context_step (GTask *task)
                       0, /* ipv4mtu */
                       0, /* ipv6mtu */
                       NULL);
-        mbim_device_command (mm_port_mbim_peek_device (ctx->mbim),
-                             message,
-                             60,
-                             NULL,
-                             (GAsyncReadyCallback)ip_configuration_query_ready,
-                             task);
+        mm_port_mbim_device_command (mm_port_mbim_peek_device (ctx->mbim),
+                                     message,
+                                     60,
+                                     NULL,
+                                     (GAsyncReadyCallback)ip_configuration_query_ready,
+                                     task);
         return;
 
     case CONNECT_STEP_LAST:
@@ -1445,12 +1455,12 @@ disconnect_context_step (GTask *task)
                       MBIM_CONTEXT_IP_TYPE_DEFAULT,
                       mbim_uuid_from_context_type (MBIM_CONTEXT_TYPE_INTERNET),
                       NULL);
-        mbim_device_command (mm_port_mbim_peek_device (ctx->mbim),
-                             message,
-                             MM_BASE_BEARER_DEFAULT_DISCONNECTION_TIMEOUT,
-                             NULL,
-                             (GAsyncReadyCallback)disconnect_set_ready,
-                             task);
+        mm_port_mbim_device_command (mm_port_mbim_peek_device (ctx->mbim),
+                                     message,
+                                     MM_BASE_BEARER_DEFAULT_DISCONNECTION_TIMEOUT,
+                                     NULL,
+                                     (GAsyncReadyCallback)disconnect_set_ready,
+                                     task);
         return;
     }
 
@@ -1627,12 +1637,12 @@ reload_connection_status (MMBaseBearer        *self,
                                               mbim_uuid_from_context_type (MBIM_CONTEXT_TYPE_INTERNET),
                                               0,
                                               NULL);
-    mbim_device_command (mm_port_mbim_peek_device (mbim),
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)reload_connection_status_ready,
-                         task);
+    mm_port_mbim_device_command (mm_port_mbim_peek_device (mbim),
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)reload_connection_status_ready,
+                                 task);
 }
 
 #endif /* WITH_SYSTEMD_SUSPEND_RESUME */
@@ -33,6 +33,7 @@
 #include "mm-modem-helpers-qmi.h"
 #include "mm-port-enums-types.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 #include "mm-modem-helpers.h"
 
 G_DEFINE_TYPE (MMBearerQmi, mm_bearer_qmi, MM_TYPE_BASE_BEARER)
@@ -49,10 +50,12 @@ struct _MMBearerQmiPrivate {
     gboolean   explicit_qmi_open;
 
     QmiClientWds *client_ipv4;
+    gboolean client_ipv4_prepared;
     guint packet_service_status_ipv4_indication_id;
     guint event_report_ipv4_indication_id;
 
     QmiClientWds *client_ipv6;
+    gboolean client_ipv6_prepared;
     guint packet_service_status_ipv6_indication_id;
     guint event_report_ipv6_indication_id;
 
@@ -171,24 +174,26 @@ reload_stats_context_step (GTask *task)
         /* fall through */
     case RELOAD_STATS_CONTEXT_STEP_IPV4:
         if (self->priv->client_ipv4) {
-            qmi_client_wds_get_packet_statistics (QMI_CLIENT_WDS (self->priv->client_ipv4),
-                                                  ctx->input,
-                                                  10,
-                                                  NULL,
-                                                  (GAsyncReadyCallback)get_packet_statistics_ready,
-                                                  task);
+            MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_get_packet_statistics,
+                                        QMI_CLIENT_WDS (self->priv->client_ipv4),
+                                        ctx->input,
+                                        10,
+                                        NULL,
+                                        (GAsyncReadyCallback)get_packet_statistics_ready,
+                                        task);
             return;
         }
         ctx->step++;
         /* fall through */
     case RELOAD_STATS_CONTEXT_STEP_IPV6:
         if (self->priv->client_ipv6) {
-            qmi_client_wds_get_packet_statistics (QMI_CLIENT_WDS (self->priv->client_ipv6),
-                                                  ctx->input,
-                                                  10,
-                                                  NULL,
-                                                  (GAsyncReadyCallback)get_packet_statistics_ready,
-                                                  task);
+            MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_get_packet_statistics,
+                                        QMI_CLIENT_WDS (self->priv->client_ipv6),
+                                        ctx->input,
+                                        10,
+                                        NULL,
+                                        (GAsyncReadyCallback)get_packet_statistics_ready,
+                                        task);
             return;
         }
         ctx->step++;
@@ -326,12 +331,13 @@ connection_status_context_step (GTask *task)
 
         case CONNECTION_STATUS_CONTEXT_STEP_IPV4:
             if (self->priv->client_ipv4) {
-                qmi_client_wds_get_packet_service_status (self->priv->client_ipv4,
-                                                          NULL,
-                                                          10,
-                                                          NULL,
-                                                          (GAsyncReadyCallback)get_packet_service_status_ready,
-                                                          task);
+                MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_get_packet_service_status,
+                                            self->priv->client_ipv4,
+                                            NULL,
+                                            10,
+                                            NULL,
+                                            (GAsyncReadyCallback)get_packet_service_status_ready,
+                                            task);
                 return;
             }
             ctx->step++;
@@ -339,12 +345,13 @@ connection_status_context_step (GTask *task)
 
         case CONNECTION_STATUS_CONTEXT_STEP_IPV6:
             if (self->priv->client_ipv6) {
-                qmi_client_wds_get_packet_service_status (self->priv->client_ipv6,
-                                                          NULL,
-                                                          10,
-                                                          NULL,
-                                                          (GAsyncReadyCallback)get_packet_service_status_ready,
-                                                          task);
+                MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_get_packet_service_status,
+                                            self->priv->client_ipv6,
+                                            NULL,
+                                            10,
+                                            NULL,
+                                            (GAsyncReadyCallback)get_packet_service_status_ready,
+                                            task);
                 return;
             }
             ctx->step++;
@@ -468,23 +475,62 @@ typedef enum {
     CONNECT_STEP_SETUP_LINK,
     CONNECT_STEP_SETUP_LINK_MASTER_UP,
     CONNECT_STEP_IP_METHOD,
-    CONNECT_STEP_IPV4,
-    CONNECT_STEP_WDS_CLIENT_IPV4,
-    CONNECT_STEP_BIND_DATA_PORT_IPV4,
-    CONNECT_STEP_IP_FAMILY_IPV4,
-    CONNECT_STEP_ENABLE_INDICATIONS_IPV4,
-    CONNECT_STEP_START_NETWORK_IPV4,
-    CONNECT_STEP_GET_CURRENT_SETTINGS_IPV4,
-    CONNECT_STEP_IPV6,
-    CONNECT_STEP_WDS_CLIENT_IPV6,
-    CONNECT_STEP_BIND_DATA_PORT_IPV6,
-    CONNECT_STEP_IP_FAMILY_IPV6,
-    CONNECT_STEP_ENABLE_INDICATIONS_IPV6,
-    CONNECT_STEP_START_NETWORK_IPV6,
-    CONNECT_STEP_GET_CURRENT_SETTINGS_IPV6,
+    CONNECT_STEP_IP_FAMILIES,
     CONNECT_STEP_LAST
 } ConnectStep;
 
+static const gchar *connect_step_str[] = {
+    [CONNECT_STEP_FIRST]                 = "first",
+    [CONNECT_STEP_LOAD_PROFILE_SETTINGS] = "load profile settings",
+    [CONNECT_STEP_OPEN_QMI_PORT]         = "open QMI port",
+    [CONNECT_STEP_SETUP_DATA_FORMAT]     = "setup data format",
+    [CONNECT_STEP_SETUP_LINK]            = "setup link",
+    [CONNECT_STEP_SETUP_LINK_MASTER_UP]  = "setup link master up",
+    [CONNECT_STEP_IP_METHOD]             = "IP method",
+    [CONNECT_STEP_IP_FAMILIES]           = "IP families",
+    [CONNECT_STEP_LAST]                  = "last",
+};
+
+/* The IPv4 and IPv6 connection setups use their own WDS clients, so they are
+ * run in parallel, each one with its own step sequence, and joined before
+ * CONNECT_STEP_LAST. */
+typedef enum {
+    CONNECT_FAMILY_STEP_FIRST,
+    CONNECT_FAMILY_STEP_WDS_CLIENT,
+    CONNECT_FAMILY_STEP_BIND_DATA_PORT,
+    CONNECT_FAMILY_STEP_IP_FAMILY,
+    CONNECT_FAMILY_STEP_ENABLE_INDICATIONS,
+    CONNECT_FAMILY_STEP_START_NETWORK,
+    CONNECT_FAMILY_STEP_GET_CURRENT_SETTINGS,
+    CONNECT_FAMILY_STEP_LAST
+} ConnectFamilyStep;
+
+static const gchar *connect_family_step_str[] = {
+    [CONNECT_FAMILY_STEP_FIRST]                = "first",
+    [CONNECT_FAMILY_STEP_WDS_CLIENT]           = "WDS client",
+    [CONNECT_FAMILY_STEP_BIND_DATA_PORT]       = "bind data port",
+    [CONNECT_FAMILY_STEP_IP_FAMILY]            = "IP family",
+    [CONNECT_FAMILY_STEP_ENABLE_INDICATIONS]   = "enable indications",
+    [CONNECT_FAMILY_STEP_START_NETWORK]        = "start network",
+    [CONNECT_FAMILY_STEP_GET_CURRENT_SETTINGS] = "get current settings",
+    [CONNECT_FAMILY_STEP_LAST]                 = "last",
+};
+
+typedef struct {
+    GTask             *task; /* not owned, outlives the family setup */
+    QmiWdsIpFamily     ip_family;
+    ConnectFamilyStep  step;
+    gint64             start_time;
+    gint64             step_start_time;
+
+    QmiClientWds *client;
+    gboolean      prepared;
+    guint         packet_service_status_indication_id;
+    guint         event_report_indication_id;
+    guint32       packet_data_handle;
+    GError       *error;
+} ConnectFamily;
+
 typedef struct {
     MMBearerQmi *self;
     MMBaseModem *modem;
@@ -509,75 +555,66 @@ typedef struct {
     gchar                         *link_name;
     MMPort                        *link;
 
+    const gchar      *step_label;
+    gint64            step_start_time;
+
     gboolean          ipv4;
-    gboolean          running_ipv4;
-    QmiClientWds     *client_ipv4;
-    guint             packet_service_status_ipv4_indication_id;
-    guint             event_report_ipv4_indication_id;
-    guint32           packet_data_handle_ipv4;
+    ConnectFamily     family_ipv4;
     MMBearerIpConfig *ipv4_config;
-    GError           *error_ipv4;
 
     gboolean          ipv6;
-    gboolean          running_ipv6;
-    QmiClientWds     *client_ipv6;
-    guint             packet_service_status_ipv6_indication_id;
-    guint             event_report_ipv6_indication_id;
-    guint32           packet_data_handle_ipv6;
+    ConnectFamily     family_ipv6;
     MMBearerIpConfig *ipv6_config;
-    GError           *error_ipv6;
+
+    guint             n_families_running;
+    GError           *family_fatal_error;
 } ConnectContext;
 
 static void
-connect_context_free (ConnectContext *ctx)
+connect_family_clear (MMBearerQmi   *self,
+                      MMPortQmi     *qmi,
+                      ConnectFamily *family)
 {
-    g_free (ctx->apn);
-    g_free (ctx->user);
-    g_free (ctx->password);
-
-    if (ctx->client_ipv4) {
-        if (ctx->packet_service_status_ipv4_indication_id) {
-            common_setup_cleanup_packet_service_status_unsolicited_events (ctx->self,
-                                                                           ctx->client_ipv4,
+    if (family->client) {
+        if (family->packet_service_status_indication_id) {
+            common_setup_cleanup_packet_service_status_unsolicited_events (self,
+                                                                           family->client,
                                                                            FALSE,
-                                                                           &ctx->packet_service_status_ipv4_indication_id);
+                                                                           &family->packet_service_status_indication_id);
         }
-        if (ctx->event_report_ipv4_indication_id) {
-            cleanup_event_report_unsolicited_events (ctx->self,
-                                                     ctx->client_ipv4,
-                                                     &ctx->event_report_ipv4_indication_id);
+        if (family->event_report_indication_id) {
+            cleanup_event_report_unsolicited_events (self,
+                                                     family->client,
+                                                     &family->event_report_indication_id);
         }
-        if (ctx->packet_data_handle_ipv4) {
+        if (family->packet_data_handle) {
             g_autoptr(QmiMessageWdsStopNetworkInput) input = NULL;
 
             input = qmi_message_wds_stop_network_input_new ();
-            qmi_message_wds_stop_network_input_set_packet_data_handle (input, ctx->packet_data_handle_ipv4, NULL);
-            qmi_client_wds_stop_network (ctx->client_ipv4, input, MM_BASE_BEARER_DEFAULT_DISCONNECTION_TIMEOUT, NULL, NULL, NULL);
+            qmi_message_wds_stop_network_input_set_packet_data_handle (input, family->packet_data_handle, NULL);
+            MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_stop_network,
+                                        family->client,
+                                        input,
+                                        MM_BASE_BEARER_DEFAULT_DISCONNECTION_TIMEOUT,
+                                        NULL,
+                                        NULL,
+                                        NULL);
         }
-        g_clear_object (&ctx->client_ipv4);
+        mm_port_qmi_release_wds_client (qmi, family->client, family->prepared);
+        g_clear_object (&family->client);
     }
+    g_clear_error (&family->error);
+}
 
-    if (ctx->client_ipv6) {
-        if (ctx->packet_service_status_ipv6_indication_id) {
-            common_setup_cleanup_packet_service_status_unsolicited_events (ctx->self,
-                                                                           ctx->client_ipv6,
-                                                                           FALSE,
-                                                                           &ctx->packet_service_status_ipv6_indication_id);
-        }
-        if (ctx->event_report_ipv6_indication_id) {
-            cleanup_event_report_unsolicited_events (ctx->self,
-                                                     ctx->client_ipv6,
-                                                     &ctx->event_report_ipv6_indication_id);
-        }
-        if (ctx->packet_data_handle_ipv6) {
-            g_autoptr(QmiMessageWdsStopNetworkInput) input = NULL;
+static void
+connect_context_free (ConnectContext *ctx)
+{
+    g_free (ctx->apn);
+    g_free (ctx->user);
+    g_free (ctx->password);
 
-            input = qmi_message_wds_stop_network_input_new ();
-            qmi_message_wds_stop_network_input_set_packet_data_handle (input, ctx->packet_data_handle_ipv6, NULL);
-            qmi_client_wds_stop_network (ctx->client_ipv6, input, MM_BASE_BEARER_DEFAULT_DISCONNECTION_TIMEOUT, NULL, NULL, NULL);
-        }
-        g_clear_object (&ctx->client_ipv6);
-    }
+    connect_family_clear (ctx->self, ctx->qmi, &ctx->family_ipv4);
+    connect_family_clear (ctx->self, ctx->qmi, &ctx->family_ipv6);
 
     if (ctx->link_name) {
         mm_port_qmi_cleanup_link (ctx->qmi, ctx->link_name, ctx->mux_id, NULL, NULL);
@@ -589,8 +626,7 @@ connect_context_free (ConnectContext *ctx)
     if (ctx->explicit_qmi_open)
         mm_port_qmi_close (ctx->qmi, NULL, NULL);
 
-    g_clear_error (&ctx->error_ipv4);
-    g_clear_error (&ctx->error_ipv6);
+    g_clear_error (&ctx->family_fatal_error);
     g_clear_object (&ctx->ipv4_config);
     g_clear_object (&ctx->ipv6_config);
 
@@ -631,6 +667,82 @@ complete_connect (GTask                 *task,
 }
 
 static void connect_context_step (GTask *task);
+static void connect_family_step  (ConnectFamily *family);
+
+static const gchar *
+connect_family_get_string (ConnectFamily *family)
+{
+    return (family->ip_family == QMI_WDS_IP_FAMILY_IPV6) ? "IPv6" : "IPv4";
+}
+
+static void
+connect_family_set_prepared (ConnectFamily *family)
+{
+    ConnectContext *ctx;
+
+    /* Clients bound to a SIO port are never reused as prepared, because the
+     * pool doesn't know about the data port they were bound to */
+    ctx = g_task_get_task_data (family->task);
+    family->prepared = (ctx->sio_port == QMI_SIO_PORT_NONE);
+}
+
+/* Steps may be skipped by falling through, so the timing of each step is
+ * tracked from the point where it begins, not from the step number */
+static void
+connect_step_begin (ConnectContext *ctx,
+                    ConnectStep     step)
+{
+    gint64 now;
+
+    now = g_get_monotonic_time ();
+    if (ctx->step_label)
+        mm_obj_dbg (ctx->self, "connection step '%s' finished in %.3lfs",
+                    ctx->step_label,
+                    (now - ctx->step_start_time) / (gdouble) G_USEC_PER_SEC);
+    ctx->step_label = connect_step_str[step];
+    ctx->step_start_time = now;
+}
+
+static void
+connect_family_step_next (ConnectFamily     *family,
+                          ConnectFamilyStep  next)
+{
+    ConnectContext *ctx;
+    gint64          now;
+
+    ctx = g_task_get_task_data (family->task);
+    now = g_get_monotonic_time ();
+    mm_obj_dbg (ctx->self, "%s connection step '%s' finished in %.3lfs",
+                connect_family_get_string (family),
+                connect_family_step_str[family->step],
+                (now - family->step_start_time) / (gdouble) G_USEC_PER_SEC);
+
+    family->step = next;
+    family->step_start_time = now;
+    connect_family_step (family);
+}
+
+/* Errors that abort the whole connection attempt. The other IP family setup
+ * may still be running, so the error is only reported once both are joined;
+ * the IPv4 error is preferred if both fail. */
+static void
+connect_family_abort (ConnectFamily *family,
+                      GError        *error)
+{
+    ConnectContext *ctx;
+
+    ctx = g_task_get_task_data (family->task);
+    mm_obj_dbg (ctx->self, "%s connection setup aborted: %s",
+                connect_family_get_string (family), error->message);
+
+    if (!ctx->family_fatal_error || family->ip_family == QMI_WDS_IP_FAMILY_IPV4) {
+        g_clear_error (&ctx->family_fatal_error);
+        ctx->family_fatal_error = error;
+    } else
+        g_error_free (error);
+
+    connect_family_step_next (family, CONNECT_FAMILY_STEP_LAST);
+}
 
 static void
 qmi_inet4_ntop (guint32 address, char *buf, const gsize buflen)
@@ -823,18 +935,17 @@ get_ipv6_config (MMBearerQmi *self,
 }
 
 static void
-get_current_settings_ready (QmiClientWds *client,
-                            GAsyncResult *res,
-                            GTask *task)
+get_current_settings_ready (QmiClientWds  *client,
+                            GAsyncResult  *res,
+                            ConnectFamily *family)
 {
     MMBearerQmi *self;
     ConnectContext *ctx;
     GError *error = NULL;
     QmiMessageWdsGetCurrentSettingsOutput *output;
 
-    self = g_task_get_source_object (task);
-    ctx  = g_task_get_task_data (task);
-    g_assert (ctx->running_ipv4 || ctx->running_ipv6);
+    self = g_task_get_source_object (family->task);
+    ctx  = g_task_get_task_data (family->task);
 
     output = qmi_client_wds_get_current_settings_finish (client, res, &error);
     if (!output || !qmi_message_wds_get_current_settings_output_get_result (output, &error)) {
@@ -845,7 +956,7 @@ get_current_settings_ready (QmiClientWds *client,
             mm_obj_warn (self, "failed to retrieve mandatory IP settings: %s", error->message);
             if (output)
                 qmi_message_wds_get_current_settings_output_unref (output);
-            complete_connect (task, NULL, error);
+            connect_family_abort (family, error);
             return;
         }
 
@@ -856,12 +967,10 @@ get_current_settings_ready (QmiClientWds *client,
         config = mm_bearer_ip_config_new ();
         mm_bearer_ip_config_set_method (config, ctx->ip_method);
 
-        if (ctx->running_ipv4)
+        if (family->ip_family == QMI_WDS_IP_FAMILY_IPV4)
             ctx->ipv4_config = config;
-        else if (ctx->running_ipv6)
-            ctx->ipv6_config = config;
         else
-            g_assert_not_reached ();
+            ctx->ipv6_config = config;
     } else {
         QmiWdsIpFamily ip_family = QMI_WDS_IP_FAMILY_UNSPECIFIED;
         guint32 mtu = 0;
@@ -908,20 +1017,15 @@ get_current_settings_ready (QmiClientWds *client,
         qmi_message_wds_get_current_settings_output_unref (output);
 
     /* Keep on */
-    ctx->step++;
-    connect_context_step (task);
+    connect_family_step_next (family, family->step + 1);
 }
 
 static void
-get_current_settings (GTask *task, QmiClientWds *client)
+get_current_settings (ConnectFamily *family)
 {
-    ConnectContext *ctx;
     QmiMessageWdsGetCurrentSettingsInput *input;
     QmiWdsGetCurrentSettingsRequestedSettings requested;
 
-    ctx = g_task_get_task_data (task);
-    g_assert (ctx->running_ipv4 || ctx->running_ipv6);
-
     requested = QMI_WDS_GET_CURRENT_SETTINGS_REQUESTED_SETTINGS_DNS_ADDRESS |
                 QMI_WDS_GET_CURRENT_SETTINGS_REQUESTED_SETTINGS_GRANTED_QOS |
                 QMI_WDS_GET_CURRENT_SETTINGS_REQUESTED_SETTINGS_IP_ADDRESS |
@@ -932,12 +1036,13 @@ get_current_settings (GTask *task, QmiClientWds *client)
 
     input = qmi_message_wds_get_current_settings_input_new ();
     qmi_message_wds_get_current_settings_input_set_requested_settings (input, requested, NULL);
-    qmi_client_wds_get_current_settings (client,
-                                         input,
-                                         10,
-                                         g_task_get_cancellable (task),
-                                         (GAsyncReadyCallback)get_current_settings_ready,
-                                         task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_get_current_settings,
+                                family->client,
+                                input,
+                                10,
+                                g_task_get_cancellable (family->task),
+                                (GAsyncReadyCallback)get_current_settings_ready,
+                                family);
     qmi_message_wds_get_current_settings_input_unref (input);
 }
 
@@ -991,20 +1096,15 @@ mobile_equipment_error_from_start_network_output (MMBearerQmi
 }
 
 static void
-start_network_ready (QmiClientWds *client,
-                     GAsyncResult *res,
-                     GTask *task)
+start_network_ready (QmiClientWds  *client,
+                     GAsyncResult  *res,
+                     ConnectFamily *family)
 {
     MMBearerQmi *self;
-    ConnectContext *ctx;
     GError *error = NULL;
     QmiMessageWdsStartNetworkOutput *output;
 
-    self = g_task_get_source_object (task);
-    ctx  = g_task_get_task_data (task);
-
-    g_assert (ctx->running_ipv4 || ctx->running_ipv6);
-    g_assert (!(ctx->running_ipv4 && ctx->running_ipv6));
+    self = g_task_get_source_object (family->task);
 
     output = qmi_client_wds_start_network_finish (client, res, &error);
     if (output && !qmi_message_wds_start_network_output_get_result (output, &error)) {
@@ -1015,10 +1115,7 @@ start_network_ready (QmiClientWds *client,
          * modem would just keep connected. */
         if (g_error_matches (error, QMI_PROTOCOL_ERROR, QMI_PROTOCOL_ERROR_NO_EFFECT)) {
             g_clear_error (&error);
-            if (ctx->running_ipv4)
-                ctx->packet_data_handle_ipv4 = GLOBAL_PACKET_DATA_HANDLE;
-            else
-                ctx->packet_data_handle_ipv6 = GLOBAL_PACKET_DATA_HANDLE;
+            family->packet_data_handle = GLOBAL_PACKET_DATA_HANDLE;
             /* Fall down to a successful connection */
         } else {
             mm_obj_info (self, "couldn't start network: %s", error->message);
@@ -1029,34 +1126,24 @@ start_network_ready (QmiClientWds *client,
         }
     }
 
-    if (error) {
-        if (ctx->running_ipv4)
-            ctx->error_ipv4 = error;
-        else
-            ctx->error_ipv6 = error;
-    } else {
-        if (ctx->running_ipv4)
-            qmi_message_wds_start_network_output_get_packet_data_handle (output, &ctx->packet_data_handle_ipv4, NULL);
-        else
-            qmi_message_wds_start_network_output_get_packet_data_handle (output, &ctx->packet_data_handle_ipv6, NULL);
-    }
+    if (error)
+        family->error = error;
+    else
+        qmi_message_wds_start_network_output_get_packet_data_handle (output, &family->packet_data_handle, NULL);
 
     if (output)
         qmi_message_wds_start_network_output_unref (output);
 
     /* Keep on */
-    ctx->step++;
-    connect_context_step (task);
+    connect_family_step_next (family, family->step + 1);
 }
 
 static QmiMessageWdsStartNetworkInput *
-build_start_network_input (ConnectContext *ctx)
+build_start_network_input (ConnectContext *ctx,
+                           QmiWdsIpFamily  ip_family)
 {
     QmiMessageWdsStartNetworkInput *input;
 
-    g_assert (ctx->running_ipv4 || ctx->running_ipv6);
-    g_assert (!(ctx->running_ipv4 && ctx->running_ipv6));
-
     input = qmi_message_wds_start_network_input_new ();
 
     /* When requesting to connect through a profile, add the profile-id setting */
@@ -1083,10 +1170,7 @@ build_start_network_input (ConnectContext *ctx)
      * family. This TLV may be newer than the Start Network command itself, so
      * we'll just allow the case where none is specified. */
     if (!ctx->no_ip_family_preference) {
-        qmi_message_wds_start_network_input_set_ip_family_preference (
-            input,
-            (ctx->running_ipv6 ? QMI_WDS_IP_FAMILY_IPV6 : QMI_WDS_IP_FAMILY_IPV4),
-            NULL);
+        qmi_message_wds_start_network_input_set_ip_family_preference (input, ip_family, NULL);
     }
 
     return input;
@@ -1212,45 +1296,22 @@ connect_enable_indications_ready (QmiClientWds *client,
 }
 
 static void
-connect_enable_indications_ipv4_ready (QmiClientWds *client,
-                                       GAsyncResult *res,
-                                       GTask *task)
+connect_enable_indications_family_ready (QmiClientWds  *client,
+                                         GAsyncResult  *res,
+                                         ConnectFamily *family)
 {
     ConnectContext *ctx;
 
-    ctx = g_task_get_task_data (task);
-    g_assert (ctx->event_report_ipv4_indication_id == 0);
+    ctx = g_task_get_task_data (family->task);
+    g_assert (family->event_report_indication_id == 0);
 
-    ctx->event_report_ipv4_indication_id =
-        connect_enable_indications_ready (client, res, ctx->self, &ctx->error_ipv4);
+    family->event_report_indication_id =
+        connect_enable_indications_ready (client, res, ctx->self, &family->error);
 
-    if (!ctx->event_report_ipv4_indication_id)
-        ctx->step = CONNECT_STEP_LAST;
+    if (!family->event_report_indication_id)
+        connect_family_step_next (family, CONNECT_FAMILY_STEP_LAST);
     else
-        ctx->step++;
-
-    connect_context_step (task);
-}
-
-static void
-connect_enable_indications_ipv6_ready (QmiClientWds *client,
-                                       GAsyncResult *res,
-                                       GTask *task)
-{
-    ConnectContext *ctx;
-
-    ctx = g_task_get_task_data (task);
-    g_assert (ctx->event_report_ipv6_indication_id == 0);
-
-    ctx->event_report_ipv6_indication_id =
-        connect_enable_indications_ready (client, res, ctx->self, &ctx->error_ipv6);
-
-    if (!ctx->event_report_ipv6_indication_id)
-        ctx->step = CONNECT_STEP_LAST;
-    else
-        ctx->step++;
-
-    connect_context_step (task);
+        connect_family_step_next (family, family->step + 1);
 }
 
 static QmiMessageWdsSetEventReportInput *
@@ -1284,12 +1345,13 @@ setup_event_report_unsolicited_events (MMBearerQmi *self,
 {
     QmiMessageWdsSetEventReportInput *input = event_report_input_new (TRUE);
 
-    qmi_client_wds_set_event_report (client,
-                                     input,
-                                     5,
-                                     cancellable,
-                                     callback,
-                                     user_data);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_set_event_report,
+                                client,
+                                input,
+                                5,
+                                cancellable,
+                                callback,
+                                user_data);
     qmi_message_wds_set_event_report_input_unref (input);
 }
 
@@ -1305,30 +1367,26 @@ cleanup_event_report_unsolicited_events (MMBearerQmi *self,
     *indication_id = 0;
 
     input = event_report_input_new (FALSE);
-    qmi_client_wds_set_event_report (client,
-                                     input,
-                                     5,
-                                     NULL,
-                                     NULL,
-                                     NULL);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_set_event_report,
+                                client,
+                                input,
+                                5,
+                                NULL,
+                                NULL,
+                                NULL);
     qmi_message_wds_set_event_report_input_unref (input);
 }
 
 static void
-set_ip_family_ready (QmiClientWds *client,
-                     GAsyncResult *res,
-                     GTask *task)
+set_ip_family_ready (QmiClientWds  *client,
+                     GAsyncResult  *res,
+                     ConnectFamily *family)
 {
     MMBearerQmi *self;
-    ConnectContext *ctx;
     GError *error = NULL;
     QmiMessageWdsSetIpFamilyOutput *output;
 
-    self = g_task_get_source_object (task);
-    ctx = g_task_get_task_data (task);
-
-    g_assert (ctx->running_ipv4 || ctx->running_ipv6);
-    g_assert (!(ctx->running_ipv4 && ctx->running_ipv6));
+    self = g_task_get_source_object (family->task);
 
     output = qmi_client_wds_set_ip_family_finish (client, res, &error);
     if (output) {
@@ -1339,99 +1397,91 @@ set_ip_family_ready (QmiClientWds *client,
     if (error) {
         mm_obj_dbg (self, "couldn't set IP family preference: %s", error->message);
         g_error_free (error);
-    }
+    } else
+        connect_family_set_prepared (family);
 
     /* Keep on */
-    ctx->step++;
-    connect_context_step (task);
+    connect_family_step_next (family, family->step + 1);
 }
 
 static void
-bind_data_port_ready (QmiClientWds *client,
-                      GAsyncResult *res,
-                      GTask        *task)
+bind_data_port_ready (QmiClientWds  *client,
+                      GAsyncResult  *res,
+                      ConnectFamily *family)
 {
-    ConnectContext                             *ctx;
     GError                                     *error = NULL;
     g_autoptr(QmiMessageWdsBindDataPortOutput)  output = NULL;
 
-    ctx  = g_task_get_task_data (task);
-
-    g_assert (ctx->running_ipv4 || ctx->running_ipv6);
-    g_assert (!(ctx->running_ipv4 && ctx->running_ipv6));
-
     output = qmi_client_wds_bind_data_port_finish (client, res, &error);
     if (!output || !qmi_message_wds_bind_data_port_output_get_result (output, &error)) {
         g_prefix_error (&error, "Couldn't bind data port: ");
-        complete_connect (task, NULL, error);
+        connect_family_abort (family, error);
         return;
     }
 
     /* Keep on */
-    ctx->step++;
-    connect_context_step (task);
+    connect_family_step_next (family, family->step + 1);
 }
 
 static void
-bind_mux_data_port_ready (QmiClientWds *client,
-                          GAsyncResult *res,
-                          GTask        *task)
+bind_mux_data_port_ready (QmiClientWds  *client,
+                          GAsyncResult  *res,
+                          ConnectFamily *family)
 {
-    ConnectContext                                *ctx;
     GError                                        *error = NULL;
     g_autoptr(QmiMessageWdsBindMuxDataPortOutput)  output = NULL;
 
-    ctx  = g_task_get_task_data (task);
-
-    g_assert (ctx->running_ipv4 || ctx->running_ipv6);
-    g_assert (!(ctx->running_ipv4 && ctx->running_ipv6));
-
     output = qmi_client_wds_bind_mux_data_port_finish (client, res, &error);
     if (!output || !qmi_message_wds_bind_mux_data_port_output_get_result (output, &error)) {
         g_prefix_error (&error, "Couldn't bind mux data port: ");
-        complete_connect (task, NULL, error);
+        connect_family_abort (family, error);
         return;
     }
 
     /* Keep on */
-    ctx->step++;
-    connect_context_step (task);
+    connect_family_step_next (family, family->step + 1);
+}
+
+static guint
+connect_family_get_wds_flag (ConnectFamily *family,
+                             guint          mux_id)
+{
+    guint flag;
+
+    flag = (family->ip_family == QMI_WDS_IP_FAMILY_IPV4) ? MM_PORT_QMI_FLAG_WDS_IPV4 : MM_PORT_QMI_FLAG_WDS_IPV6;
+    return MM_PORT_QMI_FLAG_WITH_MUX_ID (flag, mux_id);
 }
 
 static void
-qmi_port_allocate_client_ready (MMPortQmi *qmi,
-                                GAsyncResult *res,
-                                GTask *task)
+acquire_wds_client_ready (MMPortQmi     *qmi,
+                          GAsyncResult  *res,
+                          ConnectFamily *family)
 {
     ConnectContext *ctx;
     GError *error = NULL;
 
-    ctx = g_task_get_task_data (task);
-    g_assert (ctx->running_ipv4 || ctx->running_ipv6);
-    g_assert (!(ctx->running_ipv4 && ctx->running_ipv6));
+    ctx = g_task_get_task_data (family->task);
 
-    if (!mm_port_qmi_allocate_client_finish (qmi, res, &error)) {
+    family->client = mm_port_qmi_acquire_wds_client_finish (qmi, res, &family->prepared, &error);
+    if (!family->client) {
         g_prefix_error (&error, "Couldn't allocate %s client in QMI port %s: ",
-                        ctx->running_ipv4 ? "IPv4" : "IPv6",
+                        connect_family_get_string (family),
                         mm_port_get_device (MM_PORT (qmi)));
-        complete_connect (task, NULL, error);
+        connect_family_abort (family, error);
         return;
     }
 
-    if (ctx->running_ipv4)
-        ctx->client_ipv4 = QMI_CLIENT_WDS (mm_port_qmi_get_client (
-                                               qmi,
-                                               QMI_SERVICE_WDS,
-                                               MM_PORT_QMI_FLAG_WITH_MUX_ID (MM_PORT_QMI_FLAG_WDS_IPV4, ctx->mux_id)));
-    else
-        ctx->client_ipv6 = QMI_CLIENT_WDS (mm_port_qmi_get_client (
-                                               qmi,
-                                               QMI_SERVICE_WDS,
-                                               MM_PORT_QMI_FLAG_WITH_MUX_ID (MM_PORT_QMI_FLAG_WDS_IPV6, ctx->mux_id)));
+    /* Already bound to the data port and IP family, go on with the per-connection
+     * setup right away */
+    if (family->prepared) {
+        mm_obj_dbg (ctx->self, "reusing prepared %s-specific WDS client (mux id %u)",
+                    connect_family_get_string (family), ctx->mux_id);
+        connect_family_step_next (family, CONNECT_FAMILY_STEP_ENABLE_INDICATIONS);
+        return;
+    }
 
     /* Keep on */
-    ctx->step++;
-    connect_context_step (task);
+    connect_family_step_next (family, family->step + 1);
 }
 
 static void
@@ -1508,6 +1558,7 @@ setup_link_ready (MMPortQmi     *qmi,
     mm_base_modem_wait_link_port (modem,
                                   "net",
                                   ctx->link_name,
+                                  ctx->mux_id,
                                   WAIT_LINK_PORT_TIMEOUT_MS,
                                   (GAsyncReadyCallback) wait_link_port_ready,
                                   task);
@@ -1639,6 +1690,176 @@ get_profile_ready (MMIfaceModem3gppProfileManager *modem,
     connect_context_step (task);
 }
 
+static void
+connect_family_step (ConnectFamily *family)
+{
+    MMBearerQmi    *self;
+    ConnectContext *ctx;
+    GTask          *task;
+
+    task = family->task;
+    self = g_task_get_source_object (task);
+    ctx  = g_task_get_task_data (task);
+
+    /* Cancellations are reported once both IP family setups are joined */
+    if (family->step != CONNECT_FAMILY_STEP_LAST &&
+        g_cancellable_is_cancelled (g_task_get_cancellable (task))) {
+        mm_obj_dbg (self, "%s connection setup cancelled", connect_family_get_string (family));
+        family->step = CONNECT_FAMILY_STEP_LAST;
+    }
+
+    switch (family->step) {
+    case CONNECT_FAMILY_STEP_FIRST:
+        mm_obj_dbg (self, "running %s connection setup", connect_family_get_string (family));
+        family->step++;
+        /* fall through */
+
+    case CONNECT_FAMILY_STEP_WDS_CLIENT:
+        mm_obj_dbg (self, "acquiring %s-specific WDS client (mux id %u)",
+                    connect_family_get_string (family), ctx->mux_id);
+        mm_port_qmi_acquire_wds_client (ctx->qmi,
+                                        connect_family_get_wds_flag (family, ctx->mux_id),
+                                        g_task_get_cancellable (task),
+                                        (GAsyncReadyCallback)acquire_wds_client_ready,
+                                        family);
+        return;
+
+    case CONNECT_FAMILY_STEP_BIND_DATA_PORT:
+        /* If SIO port given, bind client to it */
+        if (ctx->sio_port != QMI_SIO_PORT_NONE) {
+            g_autoptr(QmiMessageWdsBindDataPortInput) input = NULL;
+
+            mm_obj_dbg (self, "binding %s client to data port: %s",
+                        connect_family_get_string (family), qmi_sio_port_get_string (ctx->sio_port));
+            input = qmi_message_wds_bind_data_port_input_new ();
+            qmi_message_wds_bind_data_port_input_set_data_port (input, ctx->sio_port, NULL);
+            MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_bind_data_port,
+                                        family->client,
+                                        input,
+                                        10,
+                                        g_task_get_cancellable (task),
+                                        (GAsyncReadyCallback)bind_data_port_ready,
+                                        family);
+            return;
+        }
+
+        /* If mux id given, bind mux data port */
+        if (ctx->mux_id != QMI_DEVICE_MUX_ID_UNBOUND) {
+            g_autoptr(QmiMessageWdsBindMuxDataPortInput) input = NULL;
+
+            mm_obj_dbg (self, "binding %s client to mux id %d",
+                        connect_family_get_string (family), ctx->mux_id);
+            input = qmi_message_wds_bind_mux_data_port_input_new ();
+            qmi_message_wds_bind_mux_data_port_input_set_endpoint_info (
+                input,
+                mm_port_qmi_get_endpoint_type (ctx->qmi),
+                mm_port_qmi_get_endpoint_interface_number (ctx->qmi),
+                NULL);
+            qmi_message_wds_bind_mux_data_port_input_set_mux_id (input, ctx->mux_id, NULL);
+
+            MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_bind_mux_data_port,
+                                        family->client,
+                                        input,
+                                        10,
+                                        g_task_get_cancellable (task),
+                                        (GAsyncReadyCallback)bind_mux_data_port_ready,
+                                        family);
+            return;
+        }
+
+        family->step++;
+        /* fall through */
+
+    case CONNECT_FAMILY_STEP_IP_FAMILY:
+        /* If client is new enough, select IP family; the IPv6 setup always
+         * requires it */
+        g_assert (family->ip_family == QMI_WDS_IP_FAMILY_IPV4 || !ctx->no_ip_family_preference);
+        if (!ctx->no_ip_family_preference) {
+            QmiMessageWdsSetIpFamilyInput *input;
+
+            mm_obj_dbg (self, "setting default IP family to: %s", connect_family_get_string (family));
+            input = qmi_message_wds_set_ip_family_input_new ();
+            qmi_message_wds_set_ip_family_input_set_preference (input, family->ip_family, NULL);
+            MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_set_ip_family,
+                                        family->client,
+                                        input,
+                                        10,
+                                        g_task_get_cancellable (task),
+                                        (GAsyncReadyCallback)set_ip_family_ready,
+                                        family);
+            qmi_message_wds_set_ip_family_input_unref (input);
+            return;
+        }
+
+        connect_family_set_prepared (family);
+        family->step++;
+        /* fall through */
+
+    case CONNECT_FAMILY_STEP_ENABLE_INDICATIONS:
+        common_setup_cleanup_packet_service_status_unsolicited_events (self,
+                                                                       family->client,
+                                                                       TRUE,
+                                                                       &family->packet_service_status_indication_id);
+        setup_event_report_unsolicited_events (self,
+                                               family->client,
+                                               g_task_get_cancellable (task),
+                                               (GAsyncReadyCallback) connect_enable_indications_family_ready,
+                                               family);
+        return;
+
+    case CONNECT_FAMILY_STEP_START_NETWORK: {
+        QmiMessageWdsStartNetworkInput *input;
+
+        mm_obj_dbg (self, "starting %s connection...", connect_family_get_string (family));
+        input = build_start_network_input (ctx, family->ip_family);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_start_network,
+                                    family->client,
+                                    input,
+                                    MM_BASE_BEARER_DEFAULT_CONNECTION_TIMEOUT,
+                                    g_task_get_cancellable (task),
+                                    (GAsyncReadyCallback)start_network_ready,
+                                    family);
+        qmi_message_wds_start_network_input_unref (input);
+        return;
+    }
+
+    case CONNECT_FAMILY_STEP_GET_CURRENT_SETTINGS:
+        /* Retrieve and print IP configuration */
+        if (family->packet_data_handle) {
+            mm_obj_dbg (self, "getting %s configuration...", connect_family_get_string (family));
+            get_current_settings (family);
+            return;
+        }
+        family->step++;
+        /* fall through */
+
+    case CONNECT_FAMILY_STEP_LAST:
+        mm_obj_dbg (self, "%s connection setup finished in %.3lfs (%s)",
+                    connect_family_get_string (family),
+                    (g_get_monotonic_time () - family->start_time) / (gdouble) G_USEC_PER_SEC,
+                    family->packet_data_handle ? "connected" : "not connected");
+
+        /* Join: keep on with the main sequence once both are done */
+        g_assert (ctx->n_families_running > 0);
+        if (--ctx->n_families_running > 0)
+            return;
+        ctx->step++;
+        connect_context_step (task);
+        return;
+
+    default:
+        g_assert_not_reached ();
+    }
+}
+
+static void
+connect_family_start (ConnectFamily *family)
+{
+    family->start_time = g_get_monotonic_time ();
+    family->step_start_time = family->start_time;
+    connect_family_step (family);
+}
+
 static void
 connect_context_step (GTask *task)
 {
@@ -1675,6 +1896,8 @@ connect_context_step (GTask *task)
         /* fall through */
 
     case CONNECT_STEP_LOAD_PROFILE_SETTINGS:
+        mm_trace_step (self, "connection", "load-profile-settings");
+        connect_step_begin (ctx, CONNECT_STEP_LOAD_PROFILE_SETTINGS);
         if (ctx->profile_id != MM_3GPP_PROFILE_ID_UNKNOWN) {
             mm_obj_dbg (self, "loading connection settings from profile '%d'...", ctx->profile_id);
             mm_iface_modem_3gpp_profile_manager_get_profile (
@@ -1688,6 +1911,8 @@ connect_context_step (GTask *task)
         /* fall through */
 
     case CONNECT_STEP_OPEN_QMI_PORT:
+        mm_trace_step (self, "connection", "open-qmi-port");
+        connect_step_begin (ctx, CONNECT_STEP_OPEN_QMI_PORT);
         g_assert (ctx->ipv4 || ctx->ipv6);
         /* If we're explicitly opening the port (e.g. using a different cdc-wdm
          * port because the primary one is already connected by a different
@@ -1708,6 +1933,8 @@ connect_context_step (GTask *task)
     case CONNECT_STEP_SETUP_DATA_FORMAT: {
         MMPortQmiSetupDataFormatAction action;
 
+        mm_trace_step (self, "connection", "setup-data-format");
+        connect_step_begin (ctx, CONNECT_STEP_SETUP_DATA_FORMAT);
         switch (ctx->multiplex) {
             case MM_BEARER_MULTIPLEX_SUPPORT_NONE:
                 action = MM_PORT_QMI_SETUP_DATA_FORMAT_ACTION_SET_DEFAULT;
@@ -1729,6 +1956,8 @@ connect_context_step (GTask *task)
     }
 
     case CONNECT_STEP_SETUP_LINK:
+        mm_trace_step (self, "connection", "setup-link");
+        connect_step_begin (ctx, CONNECT_STEP_SETUP_LINK);
         /* if muxing has been enabled in the port, we need to create a new link
          * interface. */
         if (MM_PORT_QMI_DAP_IS_SUPPORTED_QMAP (ctx->dap)) {
@@ -1743,6 +1972,8 @@ connect_context_step (GTask *task)
         /* fall through */
 
     case CONNECT_STEP_SETUP_LINK_MASTER_UP:
+        mm_trace_step (self, "connection", "setup-link-master-up");
+        connect_step_begin (ctx, CONNECT_STEP_SETUP_LINK_MASTER_UP);
         /* if the connection is done through a new link, we need to ifup the master interface */
         if (ctx->link) {
             mm_obj_dbg (self, "bringing master interface %s up...", mm_port_get_device (ctx->data));
@@ -1758,6 +1989,8 @@ connect_context_step (GTask *task)
         /* fall through */
 
     case CONNECT_STEP_IP_METHOD:
+        mm_trace_step (self, "connection", "ip-method");
+        connect_step_begin (ctx, CONNECT_STEP_IP_METHOD);
         /* Once the QMI port is open, we decide the IP method we're going
          * to request. If the LLP is raw-ip, we force Static IP, because not
          * all DHCP clients support the raw-ip interfaces; otherwise default
@@ -1771,290 +2004,45 @@ connect_context_step (GTask *task)
         ctx->step++;
         /* fall through */
 
-    case CONNECT_STEP_IPV4:
-        /* If no IPv4 setup needed, jump to IPv6 */
-        if (!ctx->ipv4) {
-            ctx->step = CONNECT_STEP_IPV6;
-            connect_context_step (task);
-            return;
-        }
-
-        /* Start IPv4 setup */
-        mm_obj_dbg (self, "running IPv4 connection setup");
-        ctx->running_ipv4 = TRUE;
-        ctx->running_ipv6 = FALSE;
-        ctx->step++;
-        /* fall through */
-
-    case CONNECT_STEP_WDS_CLIENT_IPV4: {
-        QmiClient *client;
-
-        client = mm_port_qmi_get_client (ctx->qmi,
-                                         QMI_SERVICE_WDS,
-                                         MM_PORT_QMI_FLAG_WITH_MUX_ID (MM_PORT_QMI_FLAG_WDS_IPV4, ctx->mux_id));
-        if (!client) {
-            mm_obj_dbg (self, "allocating IPv4-specific WDS client (mux id %u)", ctx->mux_id);
-            mm_port_qmi_allocate_client (ctx->qmi,
-                                         QMI_SERVICE_WDS,
-                                         MM_PORT_QMI_FLAG_WITH_MUX_ID (MM_PORT_QMI_FLAG_WDS_IPV4, ctx->mux_id),
-                                         g_task_get_cancellable (task),
-                                         (GAsyncReadyCallback)qmi_port_allocate_client_ready,
-                                         task);
-            return;
-        }
-
-        ctx->client_ipv4 = QMI_CLIENT_WDS (client);
-        ctx->step++;
-    } /* fall through */
-
-    case CONNECT_STEP_BIND_DATA_PORT_IPV4:
-        /* If SIO port given, bind client to it */
-        if (ctx->sio_port != QMI_SIO_PORT_NONE) {
-            g_autoptr(QmiMessageWdsBindDataPortInput) input = NULL;
-
-            mm_obj_dbg (self, "binding to data port: %s", qmi_sio_port_get_string (ctx->sio_port));
-            input = qmi_message_wds_bind_data_port_input_new ();
-            qmi_message_wds_bind_data_port_input_set_data_port (input, ctx->sio_port, NULL);
-            qmi_client_wds_bind_data_port (ctx->client_ipv4,
-                                           input,
-                                           10,
-                                           g_task_get_cancellable (task),
-                                           (GAsyncReadyCallback)bind_data_port_ready,
-                                           task);
-            return;
-        }
-
-        /* If mux id given, bind mux data port */
-        if (ctx->mux_id != QMI_DEVICE_MUX_ID_UNBOUND) {
-            g_autoptr(QmiMessageWdsBindMuxDataPortInput) input = NULL;
-
-            mm_obj_dbg (self, "binding to mux id %d", ctx->mux_id);
-            input = qmi_message_wds_bind_mux_data_port_input_new ();
-            qmi_message_wds_bind_mux_data_port_input_set_endpoint_info (
-                input,
-                mm_port_qmi_get_endpoint_type (ctx->qmi),
-                mm_port_qmi_get_endpoint_interface_number (ctx->qmi),
-                NULL);
-            qmi_message_wds_bind_mux_data_port_input_set_mux_id (input, ctx->mux_id, NULL);
-
-            qmi_client_wds_bind_mux_data_port (ctx->client_ipv4,
-                                               input,
-                                               10,
-                                               g_task_get_cancellable (task),
-                                               (GAsyncReadyCallback)bind_mux_data_port_ready,
-                                               task);
-            return;
-        }
-
-        ctx->step++;
-        /* fall through */
-
-    case CONNECT_STEP_IP_FAMILY_IPV4:
-        /* If client is new enough, select IP family */
-        if (!ctx->no_ip_family_preference) {
-            QmiMessageWdsSetIpFamilyInput *input;
-
-            mm_obj_dbg (self, "setting default IP family to: IPv4");
-            input = qmi_message_wds_set_ip_family_input_new ();
-            qmi_message_wds_set_ip_family_input_set_preference (input, QMI_WDS_IP_FAMILY_IPV4, NULL);
-            qmi_client_wds_set_ip_family (ctx->client_ipv4,
-                                          input,
-                                          10,
-                                          g_task_get_cancellable (task),
-                                          (GAsyncReadyCallback)set_ip_family_ready,
-                                          task);
-            qmi_message_wds_set_ip_family_input_unref (input);
-            return;
-        }
-
-        ctx->step++;
-        /* fall through */
-
-    case CONNECT_STEP_ENABLE_INDICATIONS_IPV4:
-        common_setup_cleanup_packet_service_status_unsolicited_events (ctx->self,
-                                                                       ctx->client_ipv4,
-                                                                       TRUE,
-                                                                       &ctx->packet_service_status_ipv4_indication_id);
-        setup_event_report_unsolicited_events (ctx->self,
-                                               ctx->client_ipv4,
-                                               g_task_get_cancellable (task),
-                                               (GAsyncReadyCallback) connect_enable_indications_ipv4_ready,
-                                               task);
-        return;
-
-    case CONNECT_STEP_START_NETWORK_IPV4: {
-        QmiMessageWdsStartNetworkInput *input;
-
-        mm_obj_dbg (self, "starting IPv4 connection...");
-        input = build_start_network_input (ctx);
-        qmi_client_wds_start_network (ctx->client_ipv4,
-                                      input,
-                                      MM_BASE_BEARER_DEFAULT_CONNECTION_TIMEOUT,
-                                      g_task_get_cancellable (task),
-                                      (GAsyncReadyCallback)start_network_ready,
-                                      task);
-        qmi_message_wds_start_network_input_unref (input);
-        return;
-    }
-
-    case CONNECT_STEP_GET_CURRENT_SETTINGS_IPV4:
-        /* Retrieve and print IP configuration */
-        if (ctx->packet_data_handle_ipv4) {
-            mm_obj_dbg (self, "getting IPv4 configuration...");
-            get_current_settings (task, ctx->client_ipv4);
-            return;
-        }
-        ctx->step++;
-        /* fall through */
-
-    case CONNECT_STEP_IPV6:
-        /* If no IPv6 setup needed, jump to last */
-        if (!ctx->ipv6) {
-            ctx->step = CONNECT_STEP_LAST;
-            connect_context_step (task);
-            return;
-        }
-
-        /* Start IPv6 setup */
-        mm_obj_dbg (self, "running IPv6 connection setup");
-        ctx->running_ipv4 = FALSE;
-        ctx->running_ipv6 = TRUE;
-        ctx->step++;
-        /* fall through */
-
-    case CONNECT_STEP_WDS_CLIENT_IPV6: {
-        QmiClient *client;
-
-        client = mm_port_qmi_get_client (ctx->qmi,
-                                         QMI_SERVICE_WDS,
-                                         MM_PORT_QMI_FLAG_WITH_MUX_ID (MM_PORT_QMI_FLAG_WDS_IPV6, ctx->mux_id));
-        if (!client) {
-            mm_obj_dbg (self, "allocating IPv6-specific WDS client (mux id %u)", ctx->mux_id);
-            mm_port_qmi_allocate_client (ctx->qmi,
-                                         QMI_SERVICE_WDS,
-                                         MM_PORT_QMI_FLAG_WITH_MUX_ID (MM_PORT_QMI_FLAG_WDS_IPV6, ctx->mux_id),
-                                         g_task_get_cancellable (task),
-                                         (GAsyncReadyCallback)qmi_port_allocate_client_ready,
-                                         task);
-            return;
-        }
-
-        ctx->client_ipv6 = QMI_CLIENT_WDS (client);
-        ctx->step++;
-    } /* fall through */
-
-    case CONNECT_STEP_BIND_DATA_PORT_IPV6:
-        /* If SIO port given, bind client to it */
-        if (ctx->sio_port != QMI_SIO_PORT_NONE) {
-            g_autoptr(QmiMessageWdsBindDataPortInput) input = NULL;
-
-            mm_obj_dbg (self, "binding to data port: %s", qmi_sio_port_get_string (ctx->sio_port));
-            input = qmi_message_wds_bind_data_port_input_new ();
-            qmi_message_wds_bind_data_port_input_set_data_port (input, ctx->sio_port, NULL);
-            qmi_client_wds_bind_data_port (ctx->client_ipv6,
-                                           input,
-                                           10,
-                                           g_task_get_cancellable (task),
-                                           (GAsyncReadyCallback)bind_data_port_ready,
-                                           task);
-            return;
-        }
-
-        /* If mux id given, bind mux data port */
-        if (ctx->mux_id != QMI_DEVICE_MUX_ID_UNBOUND) {
-            g_autoptr(QmiMessageWdsBindMuxDataPortInput) input = NULL;
-
-            mm_obj_dbg (self, "binding to mux id %d", ctx->mux_id);
-            input = qmi_message_wds_bind_mux_data_port_input_new ();
-            qmi_message_wds_bind_mux_data_port_input_set_endpoint_info (
-                input,
-                mm_port_qmi_get_endpoint_type (ctx->qmi),
-                mm_port_qmi_get_endpoint_interface_number (ctx->qmi),
-                NULL);
-            qmi_message_wds_bind_mux_data_port_input_set_mux_id (input, ctx->mux_id, NULL);
-
-            qmi_client_wds_bind_mux_data_port (ctx->client_ipv6,
-                                               input,
-                                               10,
-                                               g_task_get_cancellable (task),
-                                               (GAsyncReadyCallback)bind_mux_data_port_ready,
-                                               task);
-            return;
-        }
-
-        ctx->step++;
-        /* fall through */
-
-    case CONNECT_STEP_IP_FAMILY_IPV6: {
-        QmiMessageWdsSetIpFamilyInput *input;
-
-        g_assert (ctx->no_ip_family_preference == FALSE);
-
-        mm_obj_dbg (self, "setting default IP family to: IPv6");
-        input = qmi_message_wds_set_ip_family_input_new ();
-        qmi_message_wds_set_ip_family_input_set_preference (input, QMI_WDS_IP_FAMILY_IPV6, NULL);
-        qmi_client_wds_set_ip_family (ctx->client_ipv6,
-                                      input,
-                                      10,
-                                      g_task_get_cancellable (task),
-                                      (GAsyncReadyCallback)set_ip_family_ready,
-                                      task);
-        qmi_message_wds_set_ip_family_input_unref (input);
-        return;
-    }
-
-    case CONNECT_STEP_ENABLE_INDICATIONS_IPV6:
-        common_setup_cleanup_packet_service_status_unsolicited_events (ctx->self,
-                                                                       ctx->client_ipv6,
-                                                                       TRUE,
-                                                                       &ctx->packet_service_status_ipv6_indication_id);
-        setup_event_report_unsolicited_events (ctx->self,
-                                               ctx->client_ipv6,
-                                               g_task_get_cancellable (task),
-                                               (GAsyncReadyCallback) connect_enable_indications_ipv6_ready,
-                                               task);
+    case CONNECT_STEP_IP_FAMILIES:
+        mm_trace_step (self, "connection", "ip-families");
+        connect_step_begin (ctx, CONNECT_STEP_IP_FAMILIES);
+        /* Both IP family setups must be accounted for before launching any
+         * of them, so that the join only happens once both are finished */
+        g_assert (ctx->n_families_running == 0);
+        ctx->n_families_running = (ctx->ipv4 ? 1 : 0) + (ctx->ipv6 ? 1 : 0);
+        g_assert (ctx->n_families_running > 0);
+        /* The context may be gone once the last family setup is started */
+        if (ctx->ipv4 && ctx->ipv6) {
+            connect_family_start (&ctx->family_ipv4);
+            connect_family_start (&ctx->family_ipv6);
+        } else if (ctx->ipv4)
+            connect_family_start (&ctx->family_ipv4);
+        else
+            connect_family_start (&ctx->family_ipv6);
         return;
 
-    case CONNECT_STEP_START_NETWORK_IPV6: {
-        QmiMessageWdsStartNetworkInput *input;
+    case CONNECT_STEP_LAST: {
+        MMBearerConnectResult *connect_result;
 
-        mm_obj_dbg (self, "starting IPv6 connection...");
-        input = build_start_network_input (ctx);
-        qmi_client_wds_start_network (ctx->client_ipv6,
-                                      input,
-                                      MM_BASE_BEARER_DEFAULT_CONNECTION_TIMEOUT,
-                                      g_task_get_cancellable (task),
-                                      (GAsyncReadyCallback)start_network_ready,
-                                      task);
-        qmi_message_wds_start_network_input_unref (input);
-        return;
-    }
+        connect_step_begin (ctx, CONNECT_STEP_LAST);
 
-    case CONNECT_STEP_GET_CURRENT_SETTINGS_IPV6:
-        /* Retrieve and print IP configuration */
-        if (ctx->packet_data_handle_ipv6) {
-            mm_obj_dbg (self, "getting IPv6 configuration...");
-            get_current_settings (task, ctx->client_ipv6);
+        /* Errors that would have aborted the sequential setup abort the
+         * connection attempt even if the other IP family succeeded */
+        if (ctx->family_fatal_error) {
+            complete_connect (task, NULL, g_steal_pointer (&ctx->family_fatal_error));
             return;
         }
-        ctx->step++;
-        /* fall through */
-
-    case CONNECT_STEP_LAST: {
-        MMBearerConnectResult *connect_result;
 
         /* If one of IPv4 or IPv6 succeeds, we're connected */
-        if (!ctx->packet_data_handle_ipv4 && !ctx->packet_data_handle_ipv6) {
+        if (!ctx->family_ipv4.packet_data_handle && !ctx->family_ipv6.packet_data_handle) {
             GError *error;
 
             /* No connection, set error. If both set, IPv4 error preferred */
-            if (ctx->error_ipv4) {
-                error = ctx->error_ipv4;
-                ctx->error_ipv4 = NULL;
-            } else {
-                error = ctx->error_ipv6;
-                ctx->error_ipv6 = NULL;
-            }
+            if (ctx->family_ipv4.error)
+                error = g_steal_pointer (&ctx->family_ipv4.error);
+            else
+                error = g_steal_pointer (&ctx->family_ipv6.error);
 
             complete_connect (task, NULL, error);
             return;
@@ -2084,26 +2072,28 @@ connect_context_step (GTask *task)
 
         g_assert (ctx->self->priv->packet_data_handle_ipv4 == 0);
         g_assert (ctx->self->priv->client_ipv4 == NULL);
-        if (ctx->packet_data_handle_ipv4) {
-            ctx->self->priv->packet_data_handle_ipv4 = ctx->packet_data_handle_ipv4;
-            ctx->packet_data_handle_ipv4 = 0;
-            ctx->self->priv->packet_service_status_ipv4_indication_id = ctx->packet_service_status_ipv4_indication_id;
-            ctx->packet_service_status_ipv4_indication_id = 0;
-            ctx->self->priv->event_report_ipv4_indication_id = ctx->event_report_ipv4_indication_id;
-            ctx->event_report_ipv4_indication_id = 0;
-            ctx->self->priv->client_ipv4 = g_object_ref (ctx->client_ipv4);
+        if (ctx->family_ipv4.packet_data_handle) {
+            ctx->self->priv->packet_data_handle_ipv4 = ctx->family_ipv4.packet_data_handle;
+            ctx->family_ipv4.packet_data_handle = 0;
+            ctx->self->priv->packet_service_status_ipv4_indication_id = ctx->family_ipv4.packet_service_status_indication_id;
+            ctx->family_ipv4.packet_service_status_indication_id = 0;
+            ctx->self->priv->event_report_ipv4_indication_id = ctx->family_ipv4.event_report_indication_id;
+            ctx->family_ipv4.event_report_indication_id = 0;
+            ctx->self->priv->client_ipv4 = g_steal_pointer (&ctx->family_ipv4.client);
+            ctx->self->priv->client_ipv4_prepared = ctx->family_ipv4.prepared;
         }
 
         g_assert (ctx->self->priv->packet_data_handle_ipv6 == 0);
         g_assert (ctx->self->priv->client_ipv6 == NULL);
-        if (ctx->packet_data_handle_ipv6) {
-            ctx->self->priv->packet_data_handle_ipv6 = ctx->packet_data_handle_ipv6;
-            ctx->packet_data_handle_ipv6 = 0;
-            ctx->self->priv->packet_service_status_ipv6_indication_id = ctx->packet_service_status_ipv6_indication_id;
-            ctx->packet_service_status_ipv6_indication_id = 0;
-            ctx->self->priv->event_report_ipv6_indication_id = ctx->event_report_ipv6_indication_id;
-            ctx->event_report_ipv6_indication_id = 0;
-            ctx->self->priv->client_ipv6 = g_object_ref (ctx->client_ipv6);
+        if (ctx->family_ipv6.packet_data_handle) {
+            ctx->self->priv->packet_data_handle_ipv6 = ctx->family_ipv6.packet_data_handle;
+            ctx->family_ipv6.packet_data_handle = 0;
+            ctx->self->priv->packet_service_status_ipv6_indication_id = ctx->family_ipv6.packet_service_status_indication_id;
+            ctx->family_ipv6.packet_service_status_indication_id = 0;
+            ctx->self->priv->event_report_ipv6_indication_id = ctx->family_ipv6.event_report_indication_id;
+            ctx->family_ipv6.event_report_indication_id = 0;
+            ctx->self->priv->client_ipv6 = g_steal_pointer (&ctx->family_ipv6.client);
+            ctx->self->priv->client_ipv6_prepared = ctx->family_ipv6.prepared;
         }
 
         connect_result = mm_bearer_connect_result_new (ctx->link ? ctx->link : ctx->data,
@@ -2240,6 +2230,10 @@ _connect (MMBaseBearer        *_self,
     ctx->sio_port = QMI_SIO_PORT_NONE;
     ctx->step = CONNECT_STEP_FIRST;
     ctx->ip_method = MM_BEARER_IP_METHOD_UNKNOWN;
+    ctx->family_ipv4.task = task;
+    ctx->family_ipv4.ip_family = QMI_WDS_IP_FAMILY_IPV4;
+    ctx->family_ipv6.task = task;
+    ctx->family_ipv6.ip_family = QMI_WDS_IP_FAMILY_IPV6;
     g_task_set_task_data (task, ctx, (GDestroyNotify)connect_context_free);
 
     /* Grab a data port */
@@ -2354,8 +2348,13 @@ reset_bearer_connection (MMBearerQmi *self,
                 cleanup_event_report_unsolicited_events (self,
                                                          self->priv->client_ipv4,
                                                          &self->priv->event_report_ipv4_indication_id);
+            if (self->priv->qmi)
+                mm_port_qmi_release_wds_client (self->priv->qmi,
+                                                self->priv->client_ipv4,
+                                                self->priv->client_ipv4_prepared);
         }
         self->priv->packet_data_handle_ipv4 = 0;
+        self->priv->client_ipv4_prepared = FALSE;
         g_clear_object (&self->priv->client_ipv4);
     }
 
@@ -2370,8 +2369,13 @@ reset_bearer_connection (MMBearerQmi *self,
                 cleanup_event_report_unsolicited_events (self,
                                                          self->priv->client_ipv6,
                                                          &self->priv->event_report_ipv6_indication_id);
+            if (self->priv->qmi)
+                mm_port_qmi_release_wds_client (self->priv->qmi,
+                                                self->priv->client_ipv6,
+                                                self->priv->client_ipv6_prepared);
         }
         self->priv->packet_data_handle_ipv6 = 0;
+        self->priv->client_ipv6_prepared = FALSE;
         g_clear_object (&self->priv->client_ipv6);
     }
 
@@ -2484,12 +2488,13 @@ disconnect_context_step (GTask *task)
 
             ctx->running_ipv4 = TRUE;
             ctx->running_ipv6 = FALSE;
-            qmi_client_wds_stop_network (ctx->client_ipv4,
-                                         input,
-                                         MM_BASE_BEARER_DEFAULT_DISCONNECTION_TIMEOUT,
-                                         NULL,
-                                         (GAsyncReadyCallback)stop_network_ready,
-                                         task);
+            MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_stop_network,
+                                        ctx->client_ipv4,
+                                        input,
+                                        MM_BASE_BEARER_DEFAULT_DISCONNECTION_TIMEOUT,
+                                        NULL,
+                                        (GAsyncReadyCallback)stop_network_ready,
+                                        task);
             qmi_message_wds_stop_network_input_unref (input);
             return;
         }
@@ -2515,12 +2520,13 @@ disconnect_context_step (GTask *task)
 
             ctx->running_ipv4 = FALSE;
             ctx->running_ipv6 = TRUE;
-            qmi_client_wds_stop_network (ctx->client_ipv6,
-                                         input,
-                                         MM_BASE_BEARER_DEFAULT_DISCONNECTION_TIMEOUT,
-                                         NULL,
-                                         (GAsyncReadyCallback)stop_network_ready,
-                                         task);
+            MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_stop_network,
+                                        ctx->client_ipv6,
+                                        input,
+                                        MM_BASE_BEARER_DEFAULT_DISCONNECTION_TIMEOUT,
+                                        NULL,
+                                        (GAsyncReadyCallback)stop_network_ready,
+                                        task);
             qmi_message_wds_stop_network_input_unref (input);
             return;
         }
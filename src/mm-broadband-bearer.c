@@ -34,6 +34,7 @@
 #include "mm-iface-modem-cdma.h"
 #include "mm-base-modem-at.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 #include "mm-modem-helpers.h"
 #include "mm-port-enums-types.h"
 #include "mm-helper-enums-types.h"
@@ -751,6 +752,7 @@ dial_3gpp_ready (MMBroadbandBearer *self,
     if (MM_BROADBAND_BEARER_GET_CLASS (self)->get_ip_config_3gpp &&
         MM_BROADBAND_BEARER_GET_CLASS (self)->get_ip_config_3gpp_finish) {
         /* Launch specific IP config retrieval */
+        mm_trace_step (self, "connection", "ip-config");
         MM_BROADBAND_BEARER_GET_CLASS (self)->get_ip_config_3gpp (
             self,
             MM_BROADBAND_MODEM (ctx->modem),
@@ -813,6 +815,7 @@ select_profile_3gpp_ready (MMBroadbandBearer *self,
         return;
     }
 
+    mm_trace_step (self, "connection", "dial");
     MM_BROADBAND_BEARER_GET_CLASS (self)->dial_3gpp (self,
                                                      ctx->modem,
                                                      ctx->primary,
@@ -844,6 +847,7 @@ connect_3gpp (MMBroadbandBearer   *self,
     task = g_task_new (self, cancellable, callback, user_data);
     g_task_set_task_data (task, ctx, (GDestroyNotify)detailed_connect_context_free);
 
+    mm_trace_step (self, "connection", "select-profile");
     select_profile_3gpp (self,
                          ctx->modem,
                          cancellable,
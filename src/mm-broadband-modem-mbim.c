@@ -489,12 +489,12 @@ load_current_capabilities_mbim (GTask *task)
 
     mm_obj_dbg (self, "loading current capabilities...");
     message = mbim_message_device_caps_query_new (NULL);
-    mbim_device_command (ctx->device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)device_caps_query_ready,
-                         task);
+    mm_port_mbim_device_command (ctx->device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)device_caps_query_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -1224,12 +1224,12 @@ unlock_required_subscriber_ready_state_ready (MbimDevice *device,
 
         /* Query which lock is to unlock */
         message = mbim_message_pin_query_new (NULL);
-        mbim_device_command (device,
-                             message,
-                             10,
-                             NULL,
-                             (GAsyncReadyCallback)pin_query_ready,
-                             task);
+        mm_port_mbim_device_command (device,
+                                     message,
+                                     10,
+                                     NULL,
+                                     (GAsyncReadyCallback)pin_query_ready,
+                                     task);
         mbim_message_unref (message);
         goto out;
     }
@@ -1256,12 +1256,12 @@ wait_for_sim_ready (GTask *task)
 
     ctx = g_task_get_task_data (task);
     message = mbim_message_subscriber_ready_status_query_new (NULL);
-    mbim_device_command (ctx->device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)unlock_required_subscriber_ready_state_ready,
-                         task);
+    mm_port_mbim_device_command (ctx->device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)unlock_required_subscriber_ready_state_ready,
+                                 task);
     mbim_message_unref (message);
     return G_SOURCE_REMOVE;
 }
@@ -1388,12 +1388,12 @@ modem_load_unlock_retries (MMIfaceModem *self,
     task = g_task_new (self, NULL, callback, user_data);
 
     message = mbim_message_pin_query_new (NULL);
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)pin_query_unlock_retries_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)pin_query_unlock_retries_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -1454,12 +1454,12 @@ modem_load_own_numbers (MMIfaceModem *self,
     task = g_task_new (self, NULL, callback, user_data);
 
     message = mbim_message_subscriber_ready_status_query_new (NULL);
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)own_numbers_subscriber_ready_state_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)own_numbers_subscriber_ready_state_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -1531,12 +1531,12 @@ modem_load_power_state (MMIfaceModem *self,
     task = g_task_new (self, NULL, callback, user_data);
 
     message = mbim_message_radio_state_query_new (NULL);
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)radio_state_query_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)radio_state_query_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -1610,12 +1610,12 @@ modem_power_up (MMIfaceModem        *self,
     task = g_task_new (self, NULL, callback, user_data);
 
     message = mbim_message_radio_state_set_new (MBIM_RADIO_SWITCH_STATE_ON, NULL);
-    mbim_device_command (device,
-                         message,
-                         20,
-                         NULL,
-                         (GAsyncReadyCallback)radio_state_set_up_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 20,
+                                 NULL,
+                                 (GAsyncReadyCallback)radio_state_set_up_ready,
+                                 task);
 }
 
 /*****************************************************************************/
@@ -1665,12 +1665,12 @@ modem_power_down (MMIfaceModem *self,
     task = g_task_new (self, NULL, callback, user_data);
 
     message = mbim_message_radio_state_set_new (MBIM_RADIO_SWITCH_STATE_OFF, NULL);
-    mbim_device_command (device,
-                         message,
-                         20,
-                         NULL,
-                         (GAsyncReadyCallback)radio_state_set_down_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 20,
+                                 NULL,
+                                 (GAsyncReadyCallback)radio_state_set_down_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -1734,12 +1734,12 @@ modem_load_signal_quality (MMIfaceModem *self,
     task = g_task_new (self, NULL, callback, user_data);
 
     message = mbim_message_signal_state_query_new (NULL);
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)signal_state_query_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)signal_state_query_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -1839,12 +1839,12 @@ modem_reset (MMIfaceModem        *_self,
     /* This message is defined in the Intel Firmware Update service, but it
      * really is just a standard modem reboot. */
     message = mbim_message_intel_firmware_update_modem_reboot_set_new (NULL);
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)intel_firmware_update_modem_reboot_set_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)intel_firmware_update_modem_reboot_set_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -2323,12 +2323,12 @@ query_device_services (GTask *task)
     mm_obj_dbg (self, "querying device services...");
 
     message = mbim_message_device_services_query_new (NULL);
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)query_device_services_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)query_device_services_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -2641,12 +2641,12 @@ modem_3gpp_load_enabled_facility_locks (MMIfaceModem3gpp *self,
     task = g_task_new (self, NULL, callback, user_data);
 
     message = mbim_message_pin_list_query_new (NULL);
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)pin_list_query_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)pin_list_query_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -2734,12 +2734,12 @@ modem_3gpp_disable_facility_lock (MMIfaceModem3gpp *self,
                                         NULL,
                                         NULL);
 
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)disable_facility_lock_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)disable_facility_lock_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -2873,12 +2873,12 @@ modem_3gpp_load_initial_eps_bearer (MMIfaceModem3gpp    *_self,
     }
 
     message = mbim_message_ms_basic_connect_extensions_lte_attach_info_query_new (NULL);
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)lte_attach_info_query_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)lte_attach_info_query_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -3001,12 +3001,12 @@ modem_3gpp_load_initial_eps_bearer_settings (MMIfaceModem3gpp    *_self,
     }
 
     message = mbim_message_ms_basic_connect_extensions_lte_attach_configuration_query_new (NULL);
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)lte_attach_configuration_query_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)lte_attach_configuration_query_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -3134,12 +3134,12 @@ before_set_lte_attach_configuration_query_ready (MbimDevice   *device,
         g_object_unref (task);
         goto out;
     }
-    mbim_device_command (device,
-                         request,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)set_lte_attach_configuration_set_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 request,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)set_lte_attach_configuration_set_ready,
+                                 task);
     mbim_message_unref (request);
 
  out:
@@ -3176,12 +3176,12 @@ modem_3gpp_set_initial_eps_bearer_settings (MMIfaceModem3gpp    *_self,
     g_task_set_task_data (task, g_object_ref (config), g_object_unref);
 
     message = mbim_message_ms_basic_connect_extensions_lte_attach_configuration_query_new (NULL);
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)before_set_lte_attach_configuration_query_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)before_set_lte_attach_configuration_query_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -3571,12 +3571,12 @@ sms_notification_read_stored_sms (MMBroadbandModemMbim *self,
                                                MBIM_SMS_FLAG_INDEX,
                                                index,
                                                NULL);
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)alert_sms_read_query_ready,
-                         g_object_ref (self));
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)alert_sms_read_query_ready,
+                                 g_object_ref (self));
     mbim_message_unref (message);
 }
 
@@ -4025,12 +4025,12 @@ common_enable_disable_unsolicited_events (MMBroadbandModemMbim *self,
                    n_entries,
                    (const MbimEventEntry *const *)entries,
                    NULL));
-    mbim_device_command (device,
-                         request,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)subscribe_list_set_ready_cb,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 request,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)subscribe_list_set_ready_cb,
+                                 task);
     mbim_message_unref (request);
     mbim_event_entry_array_free (entries);
 }
@@ -4400,12 +4400,12 @@ register_state_query_ready (MbimDevice   *device,
 
         message = mbim_message_atds_location_query_new (NULL);
 
-        mbim_device_command (device,
-                             message,
-                             10,
-                             NULL,
-                             (GAsyncReadyCallback)atds_location_query_ready,
-                             task);
+        mm_port_mbim_device_command (device,
+                                     message,
+                                     10,
+                                     NULL,
+                                     (GAsyncReadyCallback)atds_location_query_ready,
+                                     task);
         mbim_message_unref (message);
         goto out;
     }
@@ -4437,12 +4437,12 @@ modem_3gpp_run_registration_checks (MMIfaceModem3gpp    *self,
     task = g_task_new (self, NULL, callback, user_data);
 
     message = mbim_message_register_state_query_new (NULL);
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)register_state_query_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)register_state_query_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -4558,12 +4558,12 @@ modem_3gpp_register_in_network (MMIfaceModem3gpp *self,
                        MBIM_REGISTER_ACTION_AUTOMATIC,
                        0, /* data_class, none preferred */
                        NULL));
-    mbim_device_command (device,
-                         message,
-                         60,
-                         NULL,
-                         (GAsyncReadyCallback)register_state_set_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 60,
+                                 NULL,
+                                 (GAsyncReadyCallback)register_state_set_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -4613,6 +4613,7 @@ visible_providers_query_ready (MbimDevice *device,
 
 static void
 modem_3gpp_scan_networks (MMIfaceModem3gpp *self,
+                          GCancellable *cancellable,
                           GAsyncReadyCallback callback,
                           gpointer user_data)
 {
@@ -4623,16 +4624,16 @@ modem_3gpp_scan_networks (MMIfaceModem3gpp *self,
     if (!peek_device (self, &device, callback, user_data))
         return;
 
-    task = g_task_new (self, NULL, callback, user_data);
+    task = g_task_new (self, cancellable, callback, user_data);
 
     mm_obj_dbg (self, "scanning networks...");
     message = mbim_message_visible_providers_query_new (MBIM_VISIBLE_PROVIDERS_ACTION_FULL_SCAN, NULL);
-    mbim_device_command (device,
-                         message,
-                         300,
-                         NULL,
-                         (GAsyncReadyCallback)visible_providers_query_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 300,
+                                 cancellable,
+                                 (GAsyncReadyCallback)visible_providers_query_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -4863,12 +4864,12 @@ modem_signal_load_values (MMIfaceModemSignal  *self,
 
     if (MM_BROADBAND_MODEM_MBIM (self)->priv->is_atds_signal_supported) {
         message = mbim_message_atds_signal_query_new (NULL);
-        mbim_device_command (device,
-                             message,
-                             5,
-                             NULL,
-                             (GAsyncReadyCallback)atds_signal_query_ready,
-                             task);
+        mm_port_mbim_device_command (device,
+                                     message,
+                                     5,
+                                     NULL,
+                                     (GAsyncReadyCallback)atds_signal_query_ready,
+                                     task);
         mbim_message_unref (message);
         return;
     }
@@ -5128,12 +5129,12 @@ modem_3gpp_profile_manager_list_profiles (MMIfaceModem3gppProfileManager  *self,
     mm_obj_dbg (self, "querying provisioned contexts...");
     message = mbim_message_provisioned_contexts_query_new (NULL);
 
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)profile_manager_provisioned_contexts_query_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)profile_manager_provisioned_contexts_query_ready,
+                                 task);
 }
 
 /*****************************************************************************/
@@ -5240,12 +5241,12 @@ modem_3gpp_profile_manager_store_profile (MMIfaceModem3gppProfileManager *self,
         return;
     }
 
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)profile_manager_provisioned_contexts_set_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)profile_manager_provisioned_contexts_set_ready,
+                                 task);
 }
 
 /*****************************************************************************/
@@ -5312,12 +5313,12 @@ modem_3gpp_profile_manager_delete_profile (MMIfaceModem3gppProfileManager *self,
         return;
     }
 
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)profile_manager_provisioned_contexts_reset_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)profile_manager_provisioned_contexts_reset_ready,
+                                 task);
 }
 
 /*****************************************************************************/
@@ -5768,12 +5769,12 @@ modem_3gpp_ussd_send (MMIfaceModem3gppUssd *_self,
     self->priv->pending_ussd_action = task;
     mm_iface_modem_3gpp_ussd_update_state (_self, MM_MODEM_3GPP_USSD_SESSION_STATE_ACTIVE);
 
-    mbim_device_command (device,
-                         message,
-                         100,
-                         NULL,
-                         (GAsyncReadyCallback)ussd_send_ready,
-                         g_object_ref (self)); /* Full reference! */
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 100,
+                                 NULL,
+                                 (GAsyncReadyCallback)ussd_send_ready,
+                                 g_object_ref (self)); /* Full reference! */
     mbim_message_unref (message);
 }
 
@@ -5851,12 +5852,12 @@ modem_3gpp_ussd_cancel (MMIfaceModem3gppUssd *_self,
         g_object_unref (task);
         return;
     }
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)ussd_cancel_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)ussd_cancel_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -6025,12 +6026,12 @@ load_initial_sms_parts (MMIfaceModemMessaging *self,
                                                MBIM_SMS_FLAG_ALL,
                                                0, /* message index, unused */
                                                NULL);
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)sms_read_query_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)sms_read_query_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
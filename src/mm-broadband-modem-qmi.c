@@ -42,6 +42,7 @@
 #include "mm-iface-modem-signal.h"
 #include "mm-iface-modem-oma.h"
 #include "mm-shared-qmi.h"
+#include "mm-qmi-indication-router.h"
 #include "mm-sim-qmi.h"
 #include "mm-bearer-qmi.h"
 #include "mm-sms-qmi.h"
@@ -89,8 +90,10 @@ struct _MMBroadbandModemQmiPrivate {
     /* Cached supported frequency bands; in order to handle ANY */
     GArray *supported_bands;
 
+    /* Indication listeners and registrations of all features */
+    MMQmiIndicationRouter *indication_router;
+
     /* 3GPP and CDMA share unsolicited events setup/enable/disable/cleanup */
-    gboolean unsolicited_events_enabled;
     gboolean unsolicited_events_setup;
     guint nas_event_report_indication_id;
     guint wds_event_report_indication_id;
@@ -114,7 +117,6 @@ struct _MMBroadbandModemQmiPrivate {
     /* 3GPP/CDMA registration helpers */
     gchar *current_operator_id;
     gchar *current_operator_description;
-    gboolean unsolicited_registration_events_enabled;
     gboolean unsolicited_registration_events_setup;
     guint serving_system_indication_id;
 #if defined WITH_NEWEST_QMI_COMMANDS
@@ -162,6 +164,16 @@ struct _MMBroadbandModemQmiPrivate {
     guint qmi_device_removed_id;
 };
 
+/* Names of the indications routed, also used as names of the registrations
+ * that enable them */
+#if defined WITH_NEWEST_QMI_COMMANDS
+# define SIGNAL_INDICATIONS       "signal-info"
+# define REGISTRATION_INDICATIONS "system-info"
+#else
+# define SIGNAL_INDICATIONS       "event-report"
+# define REGISTRATION_INDICATIONS "serving-system"
+#endif
+
 /*****************************************************************************/
 
 static QmiClient *
@@ -433,12 +445,13 @@ modem_load_manufacturer (MMIfaceModem *self,
         return;
 
     mm_obj_dbg (self, "loading manufacturer...");
-    qmi_client_dms_get_manufacturer (QMI_CLIENT_DMS (client),
-                                     NULL,
-                                     5,
-                                     NULL,
-                                     (GAsyncReadyCallback)dms_get_manufacturer_ready,
-                                     g_task_new (self, NULL, callback, user_data));
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_get_manufacturer,
+                                QMI_CLIENT_DMS (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)dms_get_manufacturer_ready,
+                                g_task_new (self, NULL, callback, user_data));
 }
 
 /*****************************************************************************/
@@ -493,12 +506,13 @@ modem_load_revision (MMIfaceModem *self,
         return;
 
     mm_obj_dbg (self, "loading revision...");
-    qmi_client_dms_get_revision (QMI_CLIENT_DMS (client),
-                                 NULL,
-                                 5,
-                                 NULL,
-                                 (GAsyncReadyCallback)dms_get_revision_ready,
-                                 g_task_new (self, NULL, callback, user_data));
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_get_revision,
+                                QMI_CLIENT_DMS (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)dms_get_revision_ready,
+                                g_task_new (self, NULL, callback, user_data));
 }
 
 /*****************************************************************************/
@@ -553,12 +567,13 @@ modem_load_hardware_revision (MMIfaceModem *self,
         return;
 
     mm_obj_dbg (self, "loading hardware revision...");
-    qmi_client_dms_get_hardware_revision (QMI_CLIENT_DMS (client),
-                                          NULL,
-                                          5,
-                                          NULL,
-                                          (GAsyncReadyCallback)dms_get_hardware_revision_ready,
-                                          g_task_new (self, NULL, callback, user_data));
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_get_hardware_revision,
+                                QMI_CLIENT_DMS (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)dms_get_hardware_revision_ready,
+                                g_task_new (self, NULL, callback, user_data));
 }
 
 /*****************************************************************************/
@@ -664,12 +679,13 @@ modem_load_equipment_identifier (MMIfaceModem *self,
         return;
 
     mm_obj_dbg (self, "loading equipment identifier...");
-    qmi_client_dms_get_ids (QMI_CLIENT_DMS (client),
-                            NULL,
-                            5,
-                            NULL,
-                            (GAsyncReadyCallback)dms_get_ids_ready,
-                            g_task_new (self, NULL, callback, user_data));
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_get_ids,
+                                QMI_CLIENT_DMS (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)dms_get_ids_ready,
+                                g_task_new (self, NULL, callback, user_data));
 }
 
 /*****************************************************************************/
@@ -761,12 +777,13 @@ modem_load_own_numbers (MMIfaceModem *self,
         return;
 
     mm_obj_dbg (self, "loading own numbers...");
-    qmi_client_dms_get_msisdn (QMI_CLIENT_DMS (client),
-                               NULL,
-                               5,
-                               NULL,
-                               (GAsyncReadyCallback)dms_get_msisdn_ready,
-                               g_task_new (self, NULL, callback, user_data));
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_get_msisdn,
+                                QMI_CLIENT_DMS (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)dms_get_msisdn_ready,
+                                g_task_new (self, NULL, callback, user_data));
 }
 
 /*****************************************************************************/
@@ -985,12 +1002,13 @@ load_unlock_required_context_step (GTask *task)
             }
 
             mm_obj_dbg (self, "loading unlock required (DMS)...");
-            qmi_client_dms_uim_get_pin_status (QMI_CLIENT_DMS (client),
-                                               NULL,
-                                               5,
-                                               NULL,
-                                               (GAsyncReadyCallback) dms_uim_get_pin_status_ready,
-                                               task);
+            MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_uim_get_pin_status,
+                                        QMI_CLIENT_DMS (client),
+                                        NULL,
+                                        5,
+                                        NULL,
+                                        (GAsyncReadyCallback) dms_uim_get_pin_status_ready,
+                                        task);
             return;
         }
         ctx->step++;
@@ -1009,12 +1027,13 @@ load_unlock_required_context_step (GTask *task)
         }
 
         mm_obj_dbg (self, "loading unlock required (UIM)...");
-        qmi_client_uim_get_card_status (QMI_CLIENT_UIM (client),
-                                        NULL,
-                                        5,
-                                        NULL,
-                                        (GAsyncReadyCallback) unlock_required_uim_get_card_status_ready,
-                                        task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_get_card_status,
+                                    QMI_CLIENT_UIM (client),
+                                    NULL,
+                                    5,
+                                    NULL,
+                                    (GAsyncReadyCallback) unlock_required_uim_get_card_status_ready,
+                                    task);
         return;
 
     default:
@@ -1116,12 +1135,13 @@ uim_load_unlock_retries (MMBroadbandModemQmi *self,
         return;
     }
 
-    qmi_client_uim_get_card_status (QMI_CLIENT_UIM (client),
-                                    NULL,
-                                    5,
-                                    NULL,
-                                    (GAsyncReadyCallback) unlock_retries_uim_get_card_status_ready,
-                                    task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_get_card_status,
+                                QMI_CLIENT_UIM (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback) unlock_retries_uim_get_card_status_ready,
+                                task);
 }
 
 static void
@@ -1209,12 +1229,13 @@ dms_uim_load_unlock_retries (MMBroadbandModemQmi *self,
         return;
     }
 
-    qmi_client_dms_uim_get_pin_status (QMI_CLIENT_DMS (client),
-                                       NULL,
-                                       5,
-                                       NULL,
-                                       (GAsyncReadyCallback) unlock_retries_dms_uim_get_pin_status_ready,
-                                       task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_uim_get_pin_status,
+                                QMI_CLIENT_DMS (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback) unlock_retries_dms_uim_get_pin_status_ready,
+                                task);
 }
 
 static void
@@ -1418,6 +1439,27 @@ signal_info_get_quality (MMBroadbandModemQmi *self,
     return common_signal_info_get_quality (self, cdma1x_rssi, evdo_rssi, gsm_rssi, wcdma_rssi, lte_rssi, out_quality, out_act);
 }
 
+static gboolean
+signal_info_indication_get_quality (MMBroadbandModemQmi              *self,
+                                    QmiIndicationNasSignalInfoOutput *output,
+                                    guint8                           *out_quality,
+                                    MMModemAccessTechnology          *out_act)
+{
+    gint8 cdma1x_rssi = 0;
+    gint8 evdo_rssi = 0;
+    gint8 gsm_rssi = 0;
+    gint8 wcdma_rssi = 0;
+    gint8 lte_rssi = 0;
+
+    qmi_indication_nas_signal_info_output_get_cdma_signal_strength (output, &cdma1x_rssi, NULL, NULL);
+    qmi_indication_nas_signal_info_output_get_hdr_signal_strength (output, &evdo_rssi, NULL, NULL, NULL, NULL);
+    qmi_indication_nas_signal_info_output_get_gsm_signal_strength (output, &gsm_rssi, NULL);
+    qmi_indication_nas_signal_info_output_get_wcdma_signal_strength (output, &wcdma_rssi, NULL, NULL);
+    qmi_indication_nas_signal_info_output_get_lte_signal_strength (output, &lte_rssi, NULL, NULL, NULL, NULL);
+
+    return common_signal_info_get_quality (self, cdma1x_rssi, evdo_rssi, gsm_rssi, wcdma_rssi, lte_rssi, out_quality, out_act);
+}
+
 static void
 get_signal_info_ready (QmiClientNas *client,
                        GAsyncResult *res,
@@ -1579,6 +1621,64 @@ get_signal_strength_ready (QmiClientNas *client,
 
 #endif /* WITH_NEWEST_QMI_COMMANDS */
 
+static gboolean
+event_report_indication_get_quality (MMBroadbandModemQmi               *self,
+                                     QmiIndicationNasEventReportOutput *output,
+                                     guint8                            *out_quality,
+                                     MMModemAccessTechnology           *out_act)
+{
+    gint8                signal_strength;
+    QmiNasRadioInterface signal_strength_radio_interface;
+
+    if (!qmi_indication_nas_event_report_output_get_signal_strength (
+            output,
+            &signal_strength,
+            &signal_strength_radio_interface,
+            NULL))
+        return FALSE;
+
+    if (!qmi_dbm_valid (signal_strength, signal_strength_radio_interface)) {
+        mm_obj_dbg (self, "ignoring invalid signal strength (%s): %d dBm",
+                    qmi_nas_radio_interface_get_string (signal_strength_radio_interface),
+                    signal_strength);
+        return FALSE;
+    }
+
+    /* This signal strength comes as negative dBms */
+    *out_quality = STRENGTH_TO_QUALITY (signal_strength);
+    *out_act = mm_modem_access_technology_from_qmi_radio_interface (signal_strength_radio_interface);
+
+    mm_obj_dbg (self, "signal strength indication (%s): %d dBm --> %u%%",
+                qmi_nas_radio_interface_get_string (signal_strength_radio_interface),
+                signal_strength,
+                *out_quality);
+    return TRUE;
+}
+
+/* While signal quality indications are enabled, the last one reported is
+ * as good as a new query */
+static gboolean
+load_signal_quality_from_indications (MMBroadbandModemQmi     *self,
+                                      QmiClient               *client,
+                                      guint8                  *out_quality,
+                                      MMModemAccessTechnology *out_act)
+{
+    gpointer output;
+
+    if (!mm_qmi_indication_router_is_registered (self->priv->indication_router, client, SIGNAL_INDICATIONS))
+        return FALSE;
+
+    output = mm_qmi_indication_router_peek_last (self->priv->indication_router, client, SIGNAL_INDICATIONS);
+    if (!output)
+        return FALSE;
+
+#if defined WITH_NEWEST_QMI_COMMANDS
+    return signal_info_indication_get_quality (self, output, out_quality, out_act);
+#else
+    return event_report_indication_get_quality (self, output, out_quality, out_act);
+#endif /* WITH_NEWEST_QMI_COMMANDS */
+}
+
 static void
 load_signal_quality (MMIfaceModem *self,
                      GAsyncReadyCallback callback,
@@ -1586,6 +1686,8 @@ load_signal_quality (MMIfaceModem *self,
 {
     QmiClient *client = NULL;
     GTask *task;
+    guint8 quality = 0;
+    MMModemAccessTechnology act = MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN;
 
     if (!mm_shared_qmi_ensure_client (MM_SHARED_QMI (self),
                                       QMI_SERVICE_NAS, &client,
@@ -1594,22 +1696,36 @@ load_signal_quality (MMIfaceModem *self,
 
     task = g_task_new (self, NULL, callback, user_data);
 
+    if (load_signal_quality_from_indications (MM_BROADBAND_MODEM_QMI (self), client, &quality, &act)) {
+        mm_obj_dbg (self, "signal quality loaded from last indication");
+        mm_qmi_indication_router_count_request_avoided (MM_BROADBAND_MODEM_QMI (self)->priv->indication_router);
+        mm_iface_modem_update_access_technologies (
+            MM_IFACE_MODEM (self),
+            act,
+            (MM_IFACE_MODEM_3GPP_ALL_ACCESS_TECHNOLOGIES_MASK | MM_IFACE_MODEM_CDMA_ALL_ACCESS_TECHNOLOGIES_MASK));
+        g_task_return_int (task, quality);
+        g_object_unref (task);
+        return;
+    }
+
     mm_obj_dbg (self, "loading signal quality...");
 
 #if defined WITH_NEWEST_QMI_COMMANDS
-    qmi_client_nas_get_signal_info (QMI_CLIENT_NAS (client),
-                                    NULL,
-                                    10,
-                                    NULL,
-                                    (GAsyncReadyCallback)get_signal_info_ready,
-                                    task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_get_signal_info,
+                                QMI_CLIENT_NAS (client),
+                                NULL,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback)get_signal_info_ready,
+                                task);
 #else
-    qmi_client_nas_get_signal_strength (QMI_CLIENT_NAS (client),
-                                        NULL,
-                                        10,
-                                        NULL,
-                                        (GAsyncReadyCallback)get_signal_strength_ready,
-                                        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_get_signal_strength,
+                                QMI_CLIENT_NAS (client),
+                                NULL,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback)get_signal_strength_ready,
+                                task);
 #endif /* WITH_NEWEST_QMI_COMMANDS */
 }
 
@@ -1693,12 +1809,13 @@ common_power_up_down_off (MMIfaceModem        *self,
 
     input = qmi_message_dms_set_operating_mode_input_new ();
     qmi_message_dms_set_operating_mode_input_set_mode (input, mode, NULL);
-    qmi_client_dms_set_operating_mode (QMI_CLIENT_DMS (client),
-                                       input,
-                                       20,
-                                       NULL,
-                                       (GAsyncReadyCallback)dms_set_operating_mode_ready,
-                                       task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_set_operating_mode,
+                                QMI_CLIENT_DMS (client),
+                                input,
+                                20,
+                                NULL,
+                                (GAsyncReadyCallback)dms_set_operating_mode_ready,
+                                task);
 }
 
 static void
@@ -1810,12 +1927,13 @@ load_power_state (MMIfaceModem *self,
         return;
 
     mm_obj_dbg (self, "getting device operating mode...");
-    qmi_client_dms_get_operating_mode (QMI_CLIENT_DMS (client),
-                                       NULL,
-                                       5,
-                                       NULL,
-                                       (GAsyncReadyCallback)dms_get_operating_mode_ready,
-                                       g_task_new (self, NULL, callback, user_data));
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_get_operating_mode,
+                                QMI_CLIENT_DMS (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)dms_get_operating_mode_ready,
+                                g_task_new (self, NULL, callback, user_data));
 }
 
 /*****************************************************************************/
@@ -2003,12 +2121,13 @@ get_pin_lock_status_via_get_configuration_ready (QmiClientUim *client,
     qmi_message_uim_get_configuration_output_unref (output);
 
     mm_obj_dbg (self, "Getting UIM card status to read pin lock state...");
-    qmi_client_uim_get_card_status (QMI_CLIENT_UIM (ctx->client),
-                                    NULL,
-                                    5,
-                                    NULL,
-                                    (GAsyncReadyCallback) get_sim_lock_status_via_get_card_status_ready,
-                                    task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_get_card_status,
+                                QMI_CLIENT_UIM (ctx->client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback) get_sim_lock_status_via_get_card_status_ready,
+                                task);
 }
 
 static void
@@ -2028,12 +2147,13 @@ get_facility_lock_status_via_uim (GTask *task)
          QMI_UIM_CONFIGURATION_PERSONALIZATION_STATUS,
          NULL);
 
-    qmi_client_uim_get_configuration (QMI_CLIENT_UIM (ctx->client),
-                                      input,
-                                      5,
-                                      NULL,
-                                      (GAsyncReadyCallback)get_pin_lock_status_via_get_configuration_ready,
-                                      task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_get_configuration,
+                                QMI_CLIENT_UIM (ctx->client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)get_pin_lock_status_via_get_configuration_ready,
+                                task);
     qmi_message_uim_get_configuration_input_unref (input);
 }
 
@@ -2124,12 +2244,13 @@ get_sim_lock_status_via_pin_status (GTask *task)
     mm_obj_dbg (self, "retrieving PIN status to check for enabled PIN");
     /* if the SIM is locked or not can only be queried by locking at
      * the PIN status */
-    qmi_client_dms_uim_get_pin_status (QMI_CLIENT_DMS (ctx->client),
-                                       NULL,
-                                       5,
-                                       NULL,
-                                       (GAsyncReadyCallback)get_sim_lock_status_via_pin_status_ready,
-                                       task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_uim_get_pin_status,
+                                QMI_CLIENT_DMS (ctx->client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)get_sim_lock_status_via_pin_status_ready,
+                                task);
 }
 
 static void
@@ -2207,12 +2328,13 @@ get_next_facility_lock_status_via_dms (GTask *task)
                 input,
                 mm_3gpp_facility_to_qmi_uim_facility (facility),
                 NULL);
-            qmi_client_dms_uim_get_ck_status (QMI_CLIENT_DMS (ctx->client),
-                                              input,
-                                              5,
-                                              NULL,
-                                              (GAsyncReadyCallback)dms_uim_get_ck_status_ready,
-                                              task);
+            MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_uim_get_ck_status,
+                                        QMI_CLIENT_DMS (ctx->client),
+                                        input,
+                                        5,
+                                        NULL,
+                                        (GAsyncReadyCallback)dms_uim_get_ck_status_ready,
+                                        task);
             qmi_message_dms_uim_get_ck_status_input_unref (input);
             return;
         }
@@ -2416,12 +2538,13 @@ modem_3gpp_disable_facility_lock (MMIfaceModem3gpp *self,
     ctx->remaining_attempts = DISABLE_FACILITY_LOCK_CHECK_ATTEMPTS;
     g_task_set_task_data (task, ctx, g_free);
 
-    qmi_client_uim_depersonalization (QMI_CLIENT_UIM (client),
-                                      input,
-                                      30,
-                                      NULL,
-                                      (GAsyncReadyCallback) disable_facility_lock_ready,
-                                      task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_depersonalization,
+                                QMI_CLIENT_UIM (client),
+                                input,
+                                30,
+                                NULL,
+                                (GAsyncReadyCallback) disable_facility_lock_ready,
+                                task);
     qmi_message_uim_depersonalization_input_unref (input);
 }
 
@@ -2561,6 +2684,7 @@ nas_network_scan_ready (QmiClientNas *client,
 
 static void
 modem_3gpp_scan_networks (MMIfaceModem3gpp *self,
+                          GCancellable *cancellable,
                           GAsyncReadyCallback callback,
                           gpointer user_data)
 {
@@ -2577,12 +2701,13 @@ modem_3gpp_scan_networks (MMIfaceModem3gpp *self,
         return;
 
     mm_obj_dbg (self, "scanning networks...");
-    qmi_client_nas_network_scan (QMI_CLIENT_NAS (client),
-                                 NULL,
-                                 300,
-                                 NULL,
-                                 (GAsyncReadyCallback)nas_network_scan_ready,
-                                 g_task_new (self, NULL, callback, user_data));
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_network_scan,
+                                QMI_CLIENT_NAS (client),
+                                NULL,
+                                300,
+                                cancellable,
+                                (GAsyncReadyCallback)nas_network_scan_ready,
+                                g_task_new (self, cancellable, callback, user_data));
 }
 
 /*****************************************************************************/
@@ -2720,12 +2845,13 @@ modem_3gpp_load_operator_name (MMIfaceModem3gpp    *_self,
     if (mnc_pcs_digit && mnc < 100)
         qmi_message_nas_get_plmn_name_input_set_mnc_pcs_digit_include_status (input, mnc_pcs_digit, NULL);
 
-    qmi_client_nas_get_plmn_name (QMI_CLIENT_NAS (client),
-                                  input,
-                                  5,
-                                  NULL,
-                                  (GAsyncReadyCallback)get_plmn_name_ready,
-                                  task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_get_plmn_name,
+                                QMI_CLIENT_NAS (client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)get_plmn_name_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -3568,20 +3694,44 @@ modem_3gpp_run_registration_checks (MMIfaceModem3gpp    *self,
 
     task = g_task_new (self, NULL, callback, user_data);
 
+    /* While registration indications are enabled, the last one reported is
+     * as good as a new query */
+    if (mm_qmi_indication_router_is_registered (MM_BROADBAND_MODEM_QMI (self)->priv->indication_router,
+                                                client, REGISTRATION_INDICATIONS)) {
+        gpointer output;
+
+        output = mm_qmi_indication_router_peek_last (MM_BROADBAND_MODEM_QMI (self)->priv->indication_router,
+                                                     client, REGISTRATION_INDICATIONS);
+        if (output) {
+            mm_obj_dbg (self, "registration state loaded from last indication");
+            mm_qmi_indication_router_count_request_avoided (MM_BROADBAND_MODEM_QMI (self)->priv->indication_router);
 #if defined WITH_NEWEST_QMI_COMMANDS
-    qmi_client_nas_get_system_info (QMI_CLIENT_NAS (client),
-                                    NULL,
-                                    10,
-                                    NULL,
-                                    (GAsyncReadyCallback)get_system_info_ready,
-                                    task);
+            common_process_system_info_3gpp (MM_BROADBAND_MODEM_QMI (self), NULL, output);
+#else
+            common_process_serving_system_3gpp (MM_BROADBAND_MODEM_QMI (self), NULL, output);
+#endif /* WITH_NEWEST_QMI_COMMANDS */
+            g_task_return_boolean (task, TRUE);
+            g_object_unref (task);
+            return;
+        }
+    }
+
+#if defined WITH_NEWEST_QMI_COMMANDS
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_get_system_info,
+                                QMI_CLIENT_NAS (client),
+                                NULL,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback)get_system_info_ready,
+                                task);
 #else
-    qmi_client_nas_get_serving_system (QMI_CLIENT_NAS (client),
-                                       NULL,
-                                       10,
-                                       NULL,
-                                       (GAsyncReadyCallback)get_serving_system_3gpp_ready,
-                                       task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_get_serving_system,
+                                QMI_CLIENT_NAS (client),
+                                NULL,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback)get_serving_system_3gpp_ready,
+                                task);
 #endif /* WITH_NEWEST_QMI_COMMANDS */
 }
 
@@ -3654,7 +3804,6 @@ ri_serving_system_or_system_info_ready (QmiClientNas *client,
     }
 
     /* Just ignore errors for now */
-    self->priv->unsolicited_registration_events_enabled = ctx->enable;
     g_task_return_boolean (task, TRUE);
     g_object_unref (task);
 }
@@ -3671,13 +3820,13 @@ common_enable_disable_unsolicited_registration_events_serving_system (GTask *tas
     input = qmi_message_nas_register_indications_input_new ();
     qmi_message_nas_register_indications_input_set_serving_system_events (input, ctx->enable, NULL);
     qmi_message_nas_register_indications_input_set_network_reject_information (input, ctx->enable, FALSE, NULL);
-    qmi_client_nas_register_indications (
-        ctx->client,
-        input,
-        5,
-        NULL,
-        (GAsyncReadyCallback)ri_serving_system_or_system_info_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_register_indications,
+                                ctx->client,
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)ri_serving_system_or_system_info_ready,
+                                task);
 }
 
 #else /* WITH_NEWEST_QMI_COMMANDS */
@@ -3692,24 +3841,22 @@ common_enable_disable_unsolicited_registration_events_system_info (GTask *task)
     input = qmi_message_nas_register_indications_input_new ();
     qmi_message_nas_register_indications_input_set_system_info (input, ctx->enable, NULL);
     qmi_message_nas_register_indications_input_set_network_reject_information (input, ctx->enable, FALSE, NULL);
-    qmi_client_nas_register_indications (
-        ctx->client,
-        input,
-        5,
-        NULL,
-        (GAsyncReadyCallback)ri_serving_system_or_system_info_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_register_indications,
+                                ctx->client,
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)ri_serving_system_or_system_info_ready,
+                                task);
 }
 
 #endif /* WITH_NEWEST_QMI_COMMANDS */
 
 static void
-modem_3gpp_disable_unsolicited_registration_events (MMIfaceModem3gpp    *self,
-                                                    gboolean             cs_supported,
-                                                    gboolean             ps_supported,
-                                                    gboolean             eps_supported,
-                                                    GAsyncReadyCallback  callback,
-                                                    gpointer             user_data)
+common_enable_disable_unsolicited_registration_events (MMBroadbandModemQmi *self,
+                                                       gboolean             enable,
+                                                       GAsyncReadyCallback  callback,
+                                                       gpointer             user_data)
 {
     GTask     *task;
     QmiClient *client = NULL;
@@ -3719,12 +3866,21 @@ modem_3gpp_disable_unsolicited_registration_events (MMIfaceModem3gpp    *self,
                                       callback, user_data))
         return;
 
-    task = unsolicited_registration_events_task_new (MM_BROADBAND_MODEM_QMI (self),
+    task = unsolicited_registration_events_task_new (self,
                                                      client,
-                                                     FALSE,
+                                                     enable,
                                                      callback,
                                                      user_data);
 
+    /* Only the first user enabling and the last one disabling go to the device */
+    if (!(enable ?
+          mm_qmi_indication_router_ref_registration (self->priv->indication_router, client, REGISTRATION_INDICATIONS) :
+          mm_qmi_indication_router_unref_registration (self->priv->indication_router, client, REGISTRATION_INDICATIONS))) {
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
 #if defined WITH_NEWEST_QMI_COMMANDS
     common_enable_disable_unsolicited_registration_events_system_info (task);
 #else
@@ -3732,6 +3888,20 @@ modem_3gpp_disable_unsolicited_registration_events (MMIfaceModem3gpp    *self,
 #endif /* WITH_NEWEST_QMI_COMMANDS */
 }
 
+static void
+modem_3gpp_disable_unsolicited_registration_events (MMIfaceModem3gpp    *self,
+                                                    gboolean             cs_supported,
+                                                    gboolean             ps_supported,
+                                                    gboolean             eps_supported,
+                                                    GAsyncReadyCallback  callback,
+                                                    gpointer             user_data)
+{
+    common_enable_disable_unsolicited_registration_events (MM_BROADBAND_MODEM_QMI (self),
+                                                           FALSE,
+                                                           callback,
+                                                           user_data);
+}
+
 static void
 modem_3gpp_enable_unsolicited_registration_events (MMIfaceModem3gpp    *self,
                                                    gboolean             cs_supported,
@@ -3740,25 +3910,10 @@ modem_3gpp_enable_unsolicited_registration_events (MMIfaceModem3gpp    *self,
                                                    GAsyncReadyCallback  callback,
                                                    gpointer             user_data)
 {
-    GTask     *task;
-    QmiClient *client = NULL;
-
-    if (!mm_shared_qmi_ensure_client (MM_SHARED_QMI (self),
-                                      QMI_SERVICE_NAS, &client,
-                                      callback, user_data))
-        return;
-
-    task = unsolicited_registration_events_task_new (MM_BROADBAND_MODEM_QMI (self),
-                                                     client,
-                                                     TRUE,
-                                                     callback,
-                                                     user_data);
-
-#if defined WITH_NEWEST_QMI_COMMANDS
-    common_enable_disable_unsolicited_registration_events_system_info (task);
-#else
-    common_enable_disable_unsolicited_registration_events_serving_system (task);
-#endif /* WITH_NEWEST_QMI_COMMANDS */
+    common_enable_disable_unsolicited_registration_events (MM_BROADBAND_MODEM_QMI (self),
+                                                           TRUE,
+                                                           callback,
+                                                           user_data);
 }
 
 /*****************************************************************************/
@@ -4001,12 +4156,13 @@ modem_cdma_run_registration_checks (MMIfaceModemCdma *self,
 
     /* TODO: Run Get System Info in NAS >= 1.8 */
 
-    qmi_client_nas_get_serving_system (QMI_CLIENT_NAS (client),
-                                       NULL,
-                                       10,
-                                       NULL,
-                                       (GAsyncReadyCallback)get_serving_system_cdma_ready,
-                                       g_task_new (self, NULL, callback, user_data));
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_get_serving_system,
+                                QMI_CLIENT_NAS (client),
+                                NULL,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback)get_serving_system_cdma_ready,
+                                g_task_new (self, NULL, callback, user_data));
 }
 
 /*****************************************************************************/
@@ -4078,12 +4234,13 @@ modem_cdma_load_activation_state (MMIfaceModemCdma *self,
                                       callback, user_data))
         return;
 
-    qmi_client_dms_get_activation_state (QMI_CLIENT_DMS (client),
-                                         NULL,
-                                         10,
-                                         NULL,
-                                         (GAsyncReadyCallback)get_activation_state_ready,
-                                         g_task_new (self, NULL, callback, user_data));
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_get_activation_state,
+                                QMI_CLIENT_DMS (client),
+                                NULL,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback)get_activation_state_ready,
+                                g_task_new (self, NULL, callback, user_data));
 }
 
 /*****************************************************************************/
@@ -4165,7 +4322,13 @@ cdma_activation_disable_indications (CdmaActivationContext *ctx)
     /* Disable the activation state change indications; don't worry about the result */
     input = qmi_message_dms_set_event_report_input_new ();
     qmi_message_dms_set_event_report_input_set_activation_state_reporting (input, FALSE, NULL);
-    qmi_client_dms_set_event_report (ctx->client, input, 5, NULL, NULL, NULL);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_set_event_report,
+                                ctx->client,
+                                input,
+                                5,
+                                NULL,
+                                NULL,
+                                NULL);
     qmi_message_dms_set_event_report_input_unref (input);
 }
 
@@ -4458,13 +4621,13 @@ cdma_activation_context_step (GTask *task)
             mm_obj_info (ctx->self, "activation step [1/5]: enabling indications");
             input = qmi_message_dms_set_event_report_input_new ();
             qmi_message_dms_set_event_report_input_set_activation_state_reporting (input, TRUE, NULL);
-            qmi_client_dms_set_event_report (
-                ctx->client,
-                input,
-                5,
-                NULL,
-                (GAsyncReadyCallback)ser_activation_state_ready,
-                task);
+            MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_set_event_report,
+                                        ctx->client,
+                                        input,
+                                        5,
+                                        NULL,
+                                        (GAsyncReadyCallback)ser_activation_state_ready,
+                                        task);
             qmi_message_dms_set_event_report_input_unref (input);
             return;
         }
@@ -4479,12 +4642,13 @@ cdma_activation_context_step (GTask *task)
         /* Automatic activation */
         if (ctx->input_automatic) {
             mm_obj_info (ctx->self, "activation step [2/5]: requesting automatic (OTA) activation");
-            qmi_client_dms_activate_automatic (ctx->client,
-                                               ctx->input_automatic,
-                                               10,
-                                               NULL,
-                                               (GAsyncReadyCallback)activate_automatic_ready,
-                                               task);
+            MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_activate_automatic,
+                                        ctx->client,
+                                        ctx->input_automatic,
+                                        10,
+                                        NULL,
+                                        (GAsyncReadyCallback)activate_automatic_ready,
+                                        task);
             return;
         }
 
@@ -4503,12 +4667,13 @@ cdma_activation_context_step (GTask *task)
                 NULL);
         }
 
-        qmi_client_dms_activate_manual (ctx->client,
-                                        ctx->input_manual,
-                                        10,
-                                        NULL,
-                                        (GAsyncReadyCallback)activate_manual_ready,
-                                        task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_activate_manual,
+                                    ctx->client,
+                                    ctx->input_manual,
+                                    10,
+                                    NULL,
+                                    (GAsyncReadyCallback)activate_manual_ready,
+                                    task);
         return;
 
     case CDMA_ACTIVATION_STEP_WAIT_UNTIL_FINISHED:
@@ -4523,12 +4688,13 @@ cdma_activation_context_step (GTask *task)
         g_assert (ctx->input_manual != NULL);
         ctx->n_mdn_check_retries++;
         mm_obj_info (ctx->self, "activation step [3/5]: checking MDN update (retry %u)", ctx->n_mdn_check_retries);
-        qmi_client_dms_get_msisdn (ctx->client,
-                                   NULL,
-                                   5,
-                                   NULL,
-                                   (GAsyncReadyCallback)activate_manual_get_msisdn_ready,
-                                   task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_get_msisdn,
+                                    ctx->client,
+                                    NULL,
+                                    5,
+                                    NULL,
+                                    (GAsyncReadyCallback)activate_manual_get_msisdn_ready,
+                                    task);
         return;
 
     case CDMA_ACTIVATION_STEP_RESET:
@@ -4799,13 +4965,14 @@ common_setup_cleanup_unsolicited_registration_events (MMBroadbandModemQmi *self,
     if (enable) {
         g_assert (self->priv->system_info_indication_id == 0);
         self->priv->system_info_indication_id =
-            g_signal_connect (client,
-                              "system-info",
-                              G_CALLBACK (system_info_indication_cb),
-                              self);
+            mm_qmi_indication_router_add_listener (self->priv->indication_router,
+                                                   client,
+                                                   "system-info",
+                                                   (MMQmiIndicationCallback) system_info_indication_cb,
+                                                   self);
     } else {
         g_assert (self->priv->system_info_indication_id != 0);
-        g_signal_handler_disconnect (client, self->priv->system_info_indication_id);
+        mm_qmi_indication_router_remove_listener (self->priv->indication_router, self->priv->system_info_indication_id);
         self->priv->system_info_indication_id = 0;
     }
 #else
@@ -4813,13 +4980,14 @@ common_setup_cleanup_unsolicited_registration_events (MMBroadbandModemQmi *self,
     if (enable) {
         g_assert (self->priv->serving_system_indication_id == 0);
         self->priv->serving_system_indication_id =
-            g_signal_connect (client,
-                              "serving-system",
-                              G_CALLBACK (serving_system_indication_cb),
-                              self);
+            mm_qmi_indication_router_add_listener (self->priv->indication_router,
+                                                   client,
+                                                   "serving-system",
+                                                   (MMQmiIndicationCallback) serving_system_indication_cb,
+                                                   self);
     } else {
         g_assert (self->priv->serving_system_indication_id != 0);
-        g_signal_handler_disconnect (client, self->priv->serving_system_indication_id);
+        mm_qmi_indication_router_remove_listener (self->priv->indication_router, self->priv->serving_system_indication_id);
         self->priv->serving_system_indication_id = 0;
     }
 #endif /* WITH_NEWEST_QMI_COMMANDS */
@@ -4828,13 +4996,14 @@ common_setup_cleanup_unsolicited_registration_events (MMBroadbandModemQmi *self,
     if (enable) {
         g_assert (self->priv->network_reject_indication_id == 0);
         self->priv->network_reject_indication_id =
-            g_signal_connect (client,
-                              "network-reject",
-                              G_CALLBACK (network_reject_indication_cb),
-                              self);
+            mm_qmi_indication_router_add_listener (self->priv->indication_router,
+                                                   client,
+                                                   "network-reject",
+                                                   (MMQmiIndicationCallback) network_reject_indication_cb,
+                                                   self);
     } else {
         g_assert (self->priv->network_reject_indication_id != 0);
-        g_signal_handler_disconnect (client, self->priv->network_reject_indication_id);
+        mm_qmi_indication_router_remove_listener (self->priv->indication_router, self->priv->network_reject_indication_id);
         self->priv->network_reject_indication_id = 0;
     }
 
@@ -4991,12 +5160,13 @@ common_enable_disable_unsolicited_events_data_system_status (GTask *task)
 
     input = qmi_message_wds_set_event_report_input_new ();
     qmi_message_wds_set_event_report_input_set_data_systems (input, ctx->enable, NULL);
-    qmi_client_wds_set_event_report (ctx->client_wds,
-                                     input,
-                                     5,
-                                     NULL,
-                                     (GAsyncReadyCallback)ser_data_system_status_ready,
-                                     task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_set_event_report,
+                                ctx->client_wds,
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)ser_data_system_status_ready,
+                                task);
 }
 
 #if !defined WITH_NEWEST_QMI_COMMANDS
@@ -5059,13 +5229,13 @@ common_enable_disable_unsolicited_events_signal_strength (GTask *task)
         ctx->enable,
         thresholds,
         NULL);
-    qmi_client_nas_set_event_report (
-        ctx->client_nas,
-        input,
-        5,
-        NULL,
-        (GAsyncReadyCallback)ser_signal_strength_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_set_event_report,
+                                ctx->client_nas,
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)ser_signal_strength_ready,
+                                task);
 }
 
 #else /* WITH_NEWEST_QMI_COMMANDS */
@@ -5113,13 +5283,13 @@ common_enable_disable_unsolicited_events_signal_info (GTask *task)
     ctx = g_task_get_task_data (task);
     input = qmi_message_nas_register_indications_input_new ();
     qmi_message_nas_register_indications_input_set_signal_info (input, ctx->enable, NULL);
-    qmi_client_nas_register_indications (
-        ctx->client_nas,
-        input,
-        5,
-        NULL,
-        (GAsyncReadyCallback)ri_signal_info_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_register_indications,
+                                ctx->client_nas,
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)ri_signal_info_ready,
+                                task);
 }
 
 static void
@@ -5172,13 +5342,13 @@ common_enable_disable_unsolicited_events_signal_info_config (GTask *task)
             NULL);
     }
 
-    qmi_client_nas_config_signal_info (
-        ctx->client_nas,
-        input,
-        5,
-        NULL,
-        (GAsyncReadyCallback)config_signal_info_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_config_signal_info,
+                                ctx->client_nas,
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)config_signal_info_ready,
+                                task);
 }
 
 #endif /* WITH_NEWEST_QMI_COMMANDS */
@@ -5196,15 +5366,6 @@ common_enable_disable_unsolicited_events (MMBroadbandModemQmi *self,
 
     task = g_task_new (self, NULL, callback, user_data);
 
-    if (enable == self->priv->unsolicited_events_enabled) {
-        mm_obj_dbg (self, "unsolicited events already %s; skipping",
-                    enable ? "enabled" : "disabled");
-        g_task_return_boolean (task, TRUE);
-        g_object_unref (task);
-        return;
-    }
-    self->priv->unsolicited_events_enabled = enable;
-
     client_nas = mm_shared_qmi_peek_client (MM_SHARED_QMI (self),
                                             QMI_SERVICE_NAS,
                                             MM_PORT_QMI_FLAG_DEFAULT,
@@ -5214,6 +5375,22 @@ common_enable_disable_unsolicited_events (MMBroadbandModemQmi *self,
                                             MM_PORT_QMI_FLAG_DEFAULT,
                                             NULL);
 
+    /* Both the 3GPP and CDMA interfaces enable and disable these, so only
+     * the first one enabling and the last one disabling go to the device;
+     * clients without a pending request are skipped altogether */
+    if (client_nas && !(enable ?
+                        mm_qmi_indication_router_ref_registration (self->priv->indication_router, client_nas, SIGNAL_INDICATIONS) :
+                        mm_qmi_indication_router_unref_registration (self->priv->indication_router, client_nas, SIGNAL_INDICATIONS)))
+        client_nas = NULL;
+    if (client_wds && !(enable ?
+                        mm_qmi_indication_router_ref_registration (self->priv->indication_router, client_wds, "data-systems") :
+                        mm_qmi_indication_router_unref_registration (self->priv->indication_router, client_wds, "data-systems")))
+        client_wds = NULL;
+
+    /* Report the accounting of the indications received while enabled */
+    if (!enable)
+        mm_qmi_indication_router_log_stats (self->priv->indication_router);
+
     ctx = g_new0 (EnableUnsolicitedEventsContext, 1);
     ctx->enable = enable;
     ctx->client_nas = client_nas ? QMI_CLIENT_NAS (g_object_ref (client_nas)) : NULL;
@@ -5338,35 +5515,15 @@ nas_event_report_indication_cb (QmiClientNas                      *client,
                                 QmiIndicationNasEventReportOutput *output,
                                 MMBroadbandModemQmi               *self)
 {
-    gint8 signal_strength;
-    QmiNasRadioInterface signal_strength_radio_interface;
+    guint8                  quality;
+    MMModemAccessTechnology act;
 
-    if (qmi_indication_nas_event_report_output_get_signal_strength (
-            output,
-            &signal_strength,
-            &signal_strength_radio_interface,
-            NULL)) {
-        if (qmi_dbm_valid (signal_strength, signal_strength_radio_interface)) {
-            guint8 quality;
-
-            /* This signal strength comes as negative dBms */
-            quality = STRENGTH_TO_QUALITY (signal_strength);
-
-            mm_obj_dbg (self, "signal strength indication (%s): %d dBm --> %u%%",
-                        qmi_nas_radio_interface_get_string (signal_strength_radio_interface),
-                        signal_strength,
-                        quality);
-
-            mm_iface_modem_update_signal_quality (MM_IFACE_MODEM (self), quality);
-            mm_iface_modem_update_access_technologies (
-                MM_IFACE_MODEM (self),
-                mm_modem_access_technology_from_qmi_radio_interface (signal_strength_radio_interface),
-                (MM_IFACE_MODEM_3GPP_ALL_ACCESS_TECHNOLOGIES_MASK | MM_IFACE_MODEM_CDMA_ALL_ACCESS_TECHNOLOGIES_MASK));
-        } else {
-            mm_obj_dbg (self, "ignoring invalid signal strength (%s): %d dBm",
-                        qmi_nas_radio_interface_get_string (signal_strength_radio_interface),
-                        signal_strength);
-        }
+    if (event_report_indication_get_quality (self, output, &quality, &act)) {
+        mm_iface_modem_update_signal_quality (MM_IFACE_MODEM (self), quality);
+        mm_iface_modem_update_access_technologies (
+            MM_IFACE_MODEM (self),
+            act,
+            (MM_IFACE_MODEM_3GPP_ALL_ACCESS_TECHNOLOGIES_MASK | MM_IFACE_MODEM_CDMA_ALL_ACCESS_TECHNOLOGIES_MASK));
     }
 }
 
@@ -5377,28 +5534,10 @@ nas_signal_info_indication_cb (QmiClientNas                     *client,
                                QmiIndicationNasSignalInfoOutput *output,
                                MMBroadbandModemQmi              *self)
 {
-    gint8 cdma1x_rssi = 0;
-    gint8 evdo_rssi = 0;
-    gint8 gsm_rssi = 0;
-    gint8 wcdma_rssi = 0;
-    gint8 lte_rssi = 0;
-    guint8 quality;
+    guint8                  quality;
     MMModemAccessTechnology act = MM_MODEM_ACCESS_TECHNOLOGY_UNKNOWN;
 
-    qmi_indication_nas_signal_info_output_get_cdma_signal_strength (output, &cdma1x_rssi, NULL, NULL);
-    qmi_indication_nas_signal_info_output_get_hdr_signal_strength (output, &evdo_rssi, NULL, NULL, NULL, NULL);
-    qmi_indication_nas_signal_info_output_get_gsm_signal_strength (output, &gsm_rssi, NULL);
-    qmi_indication_nas_signal_info_output_get_wcdma_signal_strength (output, &wcdma_rssi, NULL, NULL);
-    qmi_indication_nas_signal_info_output_get_lte_signal_strength (output, &lte_rssi, NULL, NULL, NULL, NULL);
-
-    if (common_signal_info_get_quality (self,
-                                        cdma1x_rssi,
-                                        evdo_rssi,
-                                        gsm_rssi,
-                                        wcdma_rssi,
-                                        lte_rssi,
-                                        &quality,
-                                        &act)) {
+    if (signal_info_indication_get_quality (self, output, &quality, &act)) {
         mm_iface_modem_update_signal_quality (MM_IFACE_MODEM (self), quality);
         mm_iface_modem_update_access_technologies (
             MM_IFACE_MODEM (self),
@@ -5444,12 +5583,13 @@ common_setup_cleanup_unsolicited_events (MMBroadbandModemQmi *self,
         if (enable) {
             g_assert (self->priv->nas_event_report_indication_id == 0);
             self->priv->nas_event_report_indication_id =
-                g_signal_connect (client_nas,
-                                  "event-report",
-                                  G_CALLBACK (nas_event_report_indication_cb),
-                                  self);
+                mm_qmi_indication_router_add_listener (self->priv->indication_router,
+                                                       client_nas,
+                                                       "event-report",
+                                                       (MMQmiIndicationCallback) nas_event_report_indication_cb,
+                                                       self);
         } else if (self->priv->nas_event_report_indication_id != 0) {
-            g_signal_handler_disconnect (client_nas, self->priv->nas_event_report_indication_id);
+            mm_qmi_indication_router_remove_listener (self->priv->indication_router, self->priv->nas_event_report_indication_id);
             self->priv->nas_event_report_indication_id = 0;
         }
 
@@ -5457,12 +5597,13 @@ common_setup_cleanup_unsolicited_events (MMBroadbandModemQmi *self,
         if (enable) {
             g_assert (self->priv->nas_signal_info_indication_id == 0);
             self->priv->nas_signal_info_indication_id =
-                g_signal_connect (client_nas,
-                                  "signal-info",
-                                  G_CALLBACK (nas_signal_info_indication_cb),
-                                  self);
+                mm_qmi_indication_router_add_listener (self->priv->indication_router,
+                                                       client_nas,
+                                                       "signal-info",
+                                                       (MMQmiIndicationCallback) nas_signal_info_indication_cb,
+                                                       self);
         } else if (self->priv->nas_signal_info_indication_id != 0) {
-            g_signal_handler_disconnect (client_nas, self->priv->nas_signal_info_indication_id);
+            mm_qmi_indication_router_remove_listener (self->priv->indication_router, self->priv->nas_signal_info_indication_id);
             self->priv->nas_signal_info_indication_id = 0;
         }
 #endif /* WITH_NEWEST_QMI_COMMANDS */
@@ -5472,12 +5613,13 @@ common_setup_cleanup_unsolicited_events (MMBroadbandModemQmi *self,
         if (enable) {
             g_assert (self->priv->wds_event_report_indication_id == 0);
             self->priv->wds_event_report_indication_id =
-                g_signal_connect (client_wds,
-                                  "event-report",
-                                  G_CALLBACK (wds_event_report_indication_cb),
-                                  self);
+                mm_qmi_indication_router_add_listener (self->priv->indication_router,
+                                                       client_wds,
+                                                       "event-report",
+                                                       (MMQmiIndicationCallback) wds_event_report_indication_cb,
+                                                       self);
         } else if (self->priv->wds_event_report_indication_id != 0) {
-            g_signal_handler_disconnect (client_wds, self->priv->wds_event_report_indication_id);
+            mm_qmi_indication_router_remove_listener (self->priv->indication_router, self->priv->wds_event_report_indication_id);
             self->priv->wds_event_report_indication_id = 0;
         }
     }
@@ -5719,12 +5861,13 @@ modem_3gpp_profile_manager_get_profile (MMIfaceModem3gppProfileManager  *self,
         QMI_WDS_PROFILE_TYPE_3GPP,
         profile_id,
         NULL);
-    qmi_client_wds_get_profile_settings (QMI_CLIENT_WDS (client),
-                                         input,
-                                         3,
-                                         NULL,
-                                         (GAsyncReadyCallback)get_profile_settings_ready,
-                                         task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_get_profile_settings,
+                                QMI_CLIENT_WDS (client),
+                                input,
+                                3,
+                                NULL,
+                                (GAsyncReadyCallback)get_profile_settings_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -5865,12 +6008,13 @@ modem_3gpp_profile_manager_list_profiles (MMIfaceModem3gppProfileManager  *self,
     input = qmi_message_wds_get_profile_list_input_new ();
     qmi_message_wds_get_profile_list_input_set_profile_type (input, QMI_WDS_PROFILE_TYPE_3GPP, NULL);
 
-    qmi_client_wds_get_profile_list (QMI_CLIENT_WDS (client),
-                                     input,
-                                     10,
-                                     NULL,
-                                     (GAsyncReadyCallback)get_profile_list_ready,
-                                     task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_get_profile_list,
+                                QMI_CLIENT_WDS (client),
+                                input,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback)get_profile_list_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -6020,12 +6164,13 @@ store_profile_run (GTask *task)
         if (!self->priv->apn_type_not_supported)
             qmi_message_wds_create_profile_input_set_apn_type_mask (input, ctx->qmi_apn_type, NULL);
 
-        qmi_client_wds_create_profile (ctx->client,
-                                       input,
-                                       10,
-                                       NULL,
-                                       (GAsyncReadyCallback)create_profile_ready,
-                                       task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_create_profile,
+                                    ctx->client,
+                                    input,
+                                    10,
+                                    NULL,
+                                    (GAsyncReadyCallback)create_profile_ready,
+                                    task);
     } else {
         g_autoptr(QmiMessageWdsModifyProfileInput) input = NULL;
 
@@ -6039,12 +6184,13 @@ store_profile_run (GTask *task)
         if (!self->priv->apn_type_not_supported)
             qmi_message_wds_modify_profile_input_set_apn_type_mask (input, ctx->qmi_apn_type, NULL);
 
-        qmi_client_wds_modify_profile (ctx->client,
-                                       input,
-                                       10,
-                                       NULL,
-                                       (GAsyncReadyCallback)modify_profile_ready,
-                                       task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_modify_profile,
+                                    ctx->client,
+                                    input,
+                                    10,
+                                    NULL,
+                                    (GAsyncReadyCallback)modify_profile_ready,
+                                    task);
     }
 }
 
@@ -6161,12 +6307,13 @@ modem_3gpp_profile_manager_delete_profile (MMIfaceModem3gppProfileManager *self,
     input = qmi_message_wds_delete_profile_input_new ();
     qmi_message_wds_delete_profile_input_set_profile_identifier (input, QMI_WDS_PROFILE_TYPE_3GPP, profile_id, NULL);
 
-    qmi_client_wds_delete_profile (QMI_CLIENT_WDS (client),
-                                   input,
-                                   10,
-                                   NULL,
-                                   (GAsyncReadyCallback)delete_profile_ready,
-                                   task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_delete_profile,
+                                QMI_CLIENT_WDS (client),
+                                input,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback)delete_profile_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -6389,12 +6536,13 @@ messaging_set_default_storage (MMIfaceModemMessaging *_self,
     qmi_message_wms_set_routes_input_set_route_list (input, routes_array, NULL);
 
     mm_obj_dbg (self, "setting default messaging routes...");
-    qmi_client_wms_set_routes (QMI_CLIENT_WMS (client),
-                               input,
-                               5,
-                               NULL,
-                               (GAsyncReadyCallback)wms_set_routes_ready,
-                               g_task_new (self, NULL, callback, user_data));
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wms_set_routes,
+                                QMI_CLIENT_WMS (client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)wms_set_routes_ready,
+                                g_task_new (self, NULL, callback, user_data));
 
     qmi_message_wms_set_routes_input_unref (input);
     g_array_unref (routes_array);
@@ -6614,12 +6762,13 @@ read_next_sms_part (GTask *task)
     else
         g_assert_not_reached ();
 
-    qmi_client_wms_raw_read (QMI_CLIENT_WMS (ctx->client),
-                             input,
-                             3,
-                             NULL,
-                             (GAsyncReadyCallback)wms_raw_read_ready,
-                             task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wms_raw_read,
+                                QMI_CLIENT_WMS (ctx->client),
+                                input,
+                                3,
+                                NULL,
+                                (GAsyncReadyCallback)wms_raw_read_ready,
+                                task);
     qmi_message_wms_raw_read_input_unref (input);
 }
 
@@ -6811,12 +6960,13 @@ load_initial_sms_parts_step (GTask *task)
             (QmiWmsMessageTagType)tag_type,
             NULL);
 
-    qmi_client_wms_list_messages (QMI_CLIENT_WMS (ctx->client),
-                                  input,
-                                  5,
-                                  NULL,
-                                  (GAsyncReadyCallback)wms_list_messages_ready,
-                                  task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wms_list_messages,
+                                QMI_CLIENT_WMS (ctx->client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)wms_list_messages_ready,
+                                task);
     qmi_message_wms_list_messages_input_unref (input);
 }
 
@@ -6975,12 +7125,13 @@ messaging_event_report_indication_cb (QmiClientNas *client,
                                                             message_protocol,
                                                             TRUE,
                                                             NULL);
-            qmi_client_wms_send_ack (QMI_CLIENT_WMS (client),
-                                     ack_input,
-                                     MM_BASE_SMS_DEFAULT_SEND_TIMEOUT,
-                                     NULL,
-                                     (GAsyncReadyCallback)wms_send_ack_ready,
-                                     g_object_ref (self));
+            MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wms_send_ack,
+                                        QMI_CLIENT_WMS (client),
+                                        ack_input,
+                                        MM_BASE_SMS_DEFAULT_SEND_TIMEOUT,
+                                        NULL,
+                                        (GAsyncReadyCallback)wms_send_ack_ready,
+                                        g_object_ref (self));
         }
 
         /* Defaults for transfer-route messages, which are not stored anywhere */
@@ -7029,12 +7180,13 @@ messaging_event_report_indication_cb (QmiClientNas *client,
             ctx->message_mode,
             NULL);
 
-        qmi_client_wms_raw_read (QMI_CLIENT_WMS (client),
-                                 input,
-                                 3,
-                                 NULL,
-                                 (GAsyncReadyCallback)wms_indication_raw_read_ready,
-                                 ctx);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wms_raw_read,
+                                    QMI_CLIENT_WMS (client),
+                                    input,
+                                    3,
+                                    NULL,
+                                    (GAsyncReadyCallback)wms_indication_raw_read_ready,
+                                    ctx);
         qmi_message_wms_raw_read_input_unref (input);
     }
 }
@@ -7066,13 +7218,14 @@ common_setup_cleanup_messaging_unsolicited_events (MMBroadbandModemQmi  *self,
     if (enable) {
         g_assert (self->priv->messaging_event_report_indication_id == 0);
         self->priv->messaging_event_report_indication_id =
-            g_signal_connect (client,
-                              "event-report",
-                              G_CALLBACK (messaging_event_report_indication_cb),
-                              self);
+            mm_qmi_indication_router_add_listener (self->priv->indication_router,
+                                                   client,
+                                                   "event-report",
+                                                   (MMQmiIndicationCallback) messaging_event_report_indication_cb,
+                                                   self);
     } else {
         g_assert (self->priv->messaging_event_report_indication_id != 0);
-        g_signal_handler_disconnect (client, self->priv->messaging_event_report_indication_id);
+        mm_qmi_indication_router_remove_listener (self->priv->indication_router, self->priv->messaging_event_report_indication_id);
         self->priv->messaging_event_report_indication_id = 0;
     }
 
@@ -7296,13 +7449,13 @@ common_enable_disable_messaging_unsolicited_events (MMBroadbandModemQmi *self,
         input,
         ctx->enable,
         NULL);
-    qmi_client_wms_set_event_report (
-        QMI_CLIENT_WMS (client),
-        input,
-        5,
-        NULL,
-        (GAsyncReadyCallback)ser_messaging_indicator_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wms_set_event_report,
+                                QMI_CLIENT_WMS (client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)ser_messaging_indicator_ready,
+                                task);
     qmi_message_wms_set_event_report_input_unref (input);
 }
 
@@ -7666,13 +7819,13 @@ oma_load_features (MMIfaceModemOma *self,
                                       callback, user_data))
         return;
 
-    qmi_client_oma_get_feature_setting (
-        QMI_CLIENT_OMA (client),
-        NULL,
-        5,
-        NULL,
-        (GAsyncReadyCallback)oma_get_feature_setting_ready,
-        g_task_new (self, NULL, callback, user_data));
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_oma_get_feature_setting,
+                                QMI_CLIENT_OMA (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)oma_get_feature_setting_ready,
+                                g_task_new (self, NULL, callback, user_data));
 }
 
 /*****************************************************************************/
@@ -7734,13 +7887,13 @@ oma_setup (MMIfaceModemOma *self,
         !!(features & MM_OMA_FEATURE_HANDS_FREE_ACTIVATION),
         NULL);
 
-    qmi_client_oma_set_feature_setting (
-        QMI_CLIENT_OMA (client),
-        input,
-        5,
-        NULL,
-        (GAsyncReadyCallback)oma_set_feature_setting_ready,
-        g_task_new (self, NULL, callback, user_data));
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_oma_set_feature_setting,
+                                QMI_CLIENT_OMA (client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)oma_set_feature_setting_ready,
+                                g_task_new (self, NULL, callback, user_data));
 
     qmi_message_oma_set_feature_setting_input_unref (input);
 }
@@ -7801,13 +7954,13 @@ oma_start_client_initiated_session (MMIfaceModemOma *self,
         mm_oma_session_type_to_qmi_oma_session_type (session_type),
         NULL);
 
-    qmi_client_oma_start_session (
-        QMI_CLIENT_OMA (client),
-        input,
-        5,
-        NULL,
-        (GAsyncReadyCallback)oma_start_session_ready,
-        g_task_new (self, NULL, callback, user_data));
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_oma_start_session,
+                                QMI_CLIENT_OMA (client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)oma_start_session_ready,
+                                g_task_new (self, NULL, callback, user_data));
 
     qmi_message_oma_start_session_input_unref (input);
 }
@@ -7864,13 +8017,13 @@ oma_accept_network_initiated_session (MMIfaceModemOma *self,
         (guint16)session_id,
         NULL);
 
-    qmi_client_oma_send_selection (
-        QMI_CLIENT_OMA (client),
-        input,
-        5,
-        NULL,
-        (GAsyncReadyCallback)oma_send_selection_ready,
-        g_task_new (self, NULL, callback, user_data));
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_oma_send_selection,
+                                QMI_CLIENT_OMA (client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)oma_send_selection_ready,
+                                g_task_new (self, NULL, callback, user_data));
 
     qmi_message_oma_send_selection_input_unref (input);
 }
@@ -7918,13 +8071,13 @@ oma_cancel_session (MMIfaceModemOma *self,
                                       callback, user_data))
         return;
 
-    qmi_client_oma_cancel_session (
-        QMI_CLIENT_OMA (client),
-        NULL,
-        5,
-        NULL,
-        (GAsyncReadyCallback)oma_cancel_session_ready,
-        g_task_new (self, NULL, callback, user_data));
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_oma_cancel_session,
+                                QMI_CLIENT_OMA (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)oma_cancel_session_ready,
+                                g_task_new (self, NULL, callback, user_data));
 }
 
 /*****************************************************************************/
@@ -8016,13 +8169,14 @@ common_setup_cleanup_oma_unsolicited_events (MMBroadbandModemQmi *self,
     if (enable) {
         g_assert (self->priv->oma_event_report_indication_id == 0);
         self->priv->oma_event_report_indication_id =
-            g_signal_connect (client,
-                              "event-report",
-                              G_CALLBACK (oma_event_report_indication_cb),
-                              self);
+            mm_qmi_indication_router_add_listener (self->priv->indication_router,
+                                                   client,
+                                                   "event-report",
+                                                   (MMQmiIndicationCallback) oma_event_report_indication_cb,
+                                                   self);
     } else {
         g_assert (self->priv->oma_event_report_indication_id != 0);
-        g_signal_handler_disconnect (client, self->priv->oma_event_report_indication_id);
+        mm_qmi_indication_router_remove_listener (self->priv->indication_router, self->priv->oma_event_report_indication_id);
         self->priv->oma_event_report_indication_id = 0;
     }
 
@@ -8138,13 +8292,13 @@ common_enable_disable_oma_unsolicited_events (MMBroadbandModemQmi *self,
         input,
         ctx->enable,
         NULL);
-    qmi_client_oma_set_event_report (
-        QMI_CLIENT_OMA (client),
-        input,
-        5,
-        NULL,
-        (GAsyncReadyCallback)ser_oma_indicator_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_oma_set_event_report,
+                                QMI_CLIENT_OMA (client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)ser_oma_indicator_ready,
+                                task);
     qmi_message_oma_set_event_report_input_unref (input);
 }
 
@@ -8411,22 +8565,24 @@ common_3gpp_ussd_setup_cleanup_unsolicited_events (MMBroadbandModemQmi *self,
     if (setup) {
         g_assert (self->priv->ussd_indication_id == 0);
         self->priv->ussd_indication_id =
-            g_signal_connect (client,
-                              "ussd",
-                              G_CALLBACK (ussd_indication_cb),
-                              self);
+            mm_qmi_indication_router_add_listener (self->priv->indication_router,
+                                                   client,
+                                                   "ussd",
+                                                   (MMQmiIndicationCallback) ussd_indication_cb,
+                                                   self);
         g_assert (self->priv->ussd_release_indication_id == 0);
         self->priv->ussd_release_indication_id =
-            g_signal_connect (client,
-                              "release-ussd",
-                              G_CALLBACK (ussd_release_indication_cb),
-                              self);
+            mm_qmi_indication_router_add_listener (self->priv->indication_router,
+                                                   client,
+                                                   "release-ussd",
+                                                   (MMQmiIndicationCallback) ussd_release_indication_cb,
+                                                   self);
     } else {
         g_assert (self->priv->ussd_indication_id != 0);
-        g_signal_handler_disconnect (client, self->priv->ussd_indication_id);
+        mm_qmi_indication_router_remove_listener (self->priv->indication_router, self->priv->ussd_indication_id);
         self->priv->ussd_indication_id = 0;
         g_assert (self->priv->ussd_release_indication_id != 0);
-        g_signal_handler_disconnect (client, self->priv->ussd_release_indication_id);
+        mm_qmi_indication_router_remove_listener (self->priv->indication_router, self->priv->ussd_release_indication_id);
         self->priv->ussd_release_indication_id = 0;
     }
 
@@ -8509,12 +8665,13 @@ common_3gpp_ussd_enable_disable_unsolicited_events (MMBroadbandModemQmi *self,
 
     input = qmi_message_voice_indication_register_input_new ();
     qmi_message_voice_indication_register_input_set_ussd_notification_events (input, enable, NULL);
-    qmi_client_voice_indication_register (QMI_CLIENT_VOICE (client),
-                                          input,
-                                          10,
-                                          NULL,
-                                          (GAsyncReadyCallback) ussd_indication_register_ready,
-                                          task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_voice_indication_register,
+                                QMI_CLIENT_VOICE (client),
+                                input,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback) ussd_indication_register_ready,
+                                task);
 }
 
 static void
@@ -8639,9 +8796,13 @@ modem_3gpp_ussd_send (MMIfaceModem3gppUssd *_self,
 
             input = qmi_message_voice_originate_ussd_input_new ();
             qmi_message_voice_originate_ussd_input_set_uss_data (input, scheme, encoded, NULL);
-            qmi_client_voice_originate_ussd (QMI_CLIENT_VOICE (client), input, 100, NULL,
-                                             (GAsyncReadyCallback) voice_originate_ussd_ready,
-                                             g_object_ref (self)); /* full reference! */
+            MM_PORT_QMI_CLIENT_REQUEST (qmi_client_voice_originate_ussd,
+                                        QMI_CLIENT_VOICE (client),
+                                        input,
+                                        100,
+                                        NULL,
+                                        (GAsyncReadyCallback) voice_originate_ussd_ready,
+                                        g_object_ref (self)); /* full reference! */
             return;
         }
         case MM_MODEM_3GPP_USSD_SESSION_STATE_USER_RESPONSE: {
@@ -8649,9 +8810,13 @@ modem_3gpp_ussd_send (MMIfaceModem3gppUssd *_self,
 
             input = qmi_message_voice_answer_ussd_input_new ();
             qmi_message_voice_answer_ussd_input_set_uss_data (input, scheme, encoded, NULL);
-            qmi_client_voice_answer_ussd (QMI_CLIENT_VOICE (client), input, 100, NULL,
-                                          (GAsyncReadyCallback) voice_answer_ussd_ready,
-                                          g_object_ref (self)); /* full reference! */
+            MM_PORT_QMI_CLIENT_REQUEST (qmi_client_voice_answer_ussd,
+                                        QMI_CLIENT_VOICE (client),
+                                        input,
+                                        100,
+                                        NULL,
+                                        (GAsyncReadyCallback) voice_answer_ussd_ready,
+                                        g_object_ref (self)); /* full reference! */
             return;
         }
         case MM_MODEM_3GPP_USSD_SESSION_STATE_UNKNOWN:
@@ -8725,9 +8890,13 @@ modem_3gpp_ussd_cancel (MMIfaceModem3gppUssd *_self,
 
     task = g_task_new (self, NULL, callback, user_data);
 
-    qmi_client_voice_cancel_ussd (QMI_CLIENT_VOICE (client), NULL, 100, NULL,
-                                  (GAsyncReadyCallback) voice_cancel_ussd_ready,
-                                  task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_voice_cancel_ussd,
+                                QMI_CLIENT_VOICE (client),
+                                NULL,
+                                100,
+                                NULL,
+                                (GAsyncReadyCallback) voice_cancel_ussd_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -8902,13 +9071,14 @@ common_voice_setup_cleanup_unsolicited_events (MMBroadbandModemQmi *self,
     if (setup) {
         g_assert (self->priv->all_call_status_indication_id == 0);
         self->priv->all_call_status_indication_id =
-            g_signal_connect (client,
-                              "all-call-status",
-                              G_CALLBACK (all_call_status_indication_cb),
-                              self);
+            mm_qmi_indication_router_add_listener (self->priv->indication_router,
+                                                   client,
+                                                   "all-call-status",
+                                                   (MMQmiIndicationCallback) all_call_status_indication_cb,
+                                                   self);
     } else {
         g_assert (self->priv->all_call_status_indication_id != 0);
-        g_signal_handler_disconnect (client, self->priv->all_call_status_indication_id);
+        mm_qmi_indication_router_remove_listener (self->priv->indication_router, self->priv->all_call_status_indication_id);
         self->priv->all_call_status_indication_id = 0;
     }
 
@@ -8991,12 +9161,13 @@ common_voice_enable_disable_unsolicited_events (MMBroadbandModemQmi *self,
 
     input = qmi_message_voice_indication_register_input_new ();
     qmi_message_voice_indication_register_input_set_call_notification_events (input, enable, NULL);
-    qmi_client_voice_indication_register (QMI_CLIENT_VOICE (client),
-                                          input,
-                                          10,
-                                          NULL,
-                                          (GAsyncReadyCallback) call_indication_register_ready,
-                                          task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_voice_indication_register,
+                                QMI_CLIENT_VOICE (client),
+                                input,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback) call_indication_register_ready,
+                                task);
 }
 
 static void
@@ -9093,12 +9264,13 @@ modem_3gpp_load_initial_eps_bearer (MMIfaceModem3gpp    *self,
         return;
 
     task = g_task_new (self, NULL, callback, user_data);
-    qmi_client_wds_get_lte_attach_parameters (QMI_CLIENT_WDS (client),
-                                              NULL,
-                                              10,
-                                              NULL,
-                                              (GAsyncReadyCallback) get_lte_attach_parameters_ready,
-                                              task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_get_lte_attach_parameters,
+                                QMI_CLIENT_WDS (client),
+                                NULL,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback) get_lte_attach_parameters_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -9450,12 +9622,13 @@ modem_3gpp_load_initial_eps_bearer_settings (MMIfaceModem3gpp    *_self,
         }
 
         mm_obj_dbg (self, "querying LTE attach PDN list...");
-        qmi_client_wds_get_lte_attach_pdn_list (QMI_CLIENT_WDS (client),
-                                                NULL,
-                                                10,
-                                                NULL,
-                                                (GAsyncReadyCallback)load_initial_eps_bearer_get_lte_attach_pdn_list_ready,
-                                                task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_get_lte_attach_pdn_list,
+                                    QMI_CLIENT_WDS (client),
+                                    NULL,
+                                    10,
+                                    NULL,
+                                    (GAsyncReadyCallback)load_initial_eps_bearer_get_lte_attach_pdn_list_ready,
+                                    task);
         return;
     }
 
@@ -9685,12 +9858,13 @@ get_next_image_info (GTask *task)
         image_id.build_id = ctx->current_pair->build_id;
         input = qmi_message_dms_get_stored_image_info_input_new ();
         qmi_message_dms_get_stored_image_info_input_set_image (input, &image_id, NULL);
-        qmi_client_dms_get_stored_image_info (ctx->client,
-                                              input,
-                                              10,
-                                              NULL,
-                                              (GAsyncReadyCallback)get_pri_image_info_ready,
-                                              task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_get_stored_image_info,
+                                    ctx->client,
+                                    input,
+                                    10,
+                                    NULL,
+                                    (GAsyncReadyCallback)get_pri_image_info_ready,
+                                    task);
         qmi_message_dms_get_stored_image_info_input_unref (input);
         return;
     }
@@ -9904,12 +10078,13 @@ firmware_list_preload (MMBroadbandModemQmi *self,
     g_task_set_task_data (task, ctx, (GDestroyNotify)firmware_list_preload_context_free);
 
     mm_obj_dbg (self, "loading firmware images...");
-    qmi_client_dms_list_stored_images (QMI_CLIENT_DMS (client),
-                                       NULL,
-                                       10,
-                                       NULL,
-                                       (GAsyncReadyCallback)list_stored_images_ready,
-                                       task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_list_stored_images,
+                                QMI_CLIENT_DMS (client),
+                                NULL,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback)list_stored_images_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -10230,13 +10405,13 @@ firmware_change_current (MMIfaceModemFirmware *_self,
     qmi_message_dms_set_firmware_preference_input_set_list (input, array, NULL);
     g_array_unref (array);
 
-    qmi_client_dms_set_firmware_preference (
-        QMI_CLIENT_DMS (client),
-        input,
-        10,
-        NULL,
-        (GAsyncReadyCallback)firmware_select_stored_image_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_set_firmware_preference,
+                                QMI_CLIENT_DMS (client),
+                                input,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback)firmware_select_stored_image_ready,
+                                task);
 
 out:
     if (modem_image_id.unique_id)
@@ -10655,12 +10830,13 @@ signal_load_values_context_step (GTask *task)
         /* Fall through */
 
     case SIGNAL_LOAD_VALUES_STEP_SIGNAL_INFO:
-        qmi_client_nas_get_signal_info (ctx->client,
-                                        NULL,
-                                        5,
-                                        NULL,
-                                        (GAsyncReadyCallback)signal_load_values_get_signal_info_ready,
-                                        task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_get_signal_info,
+                                    ctx->client,
+                                    NULL,
+                                    5,
+                                    NULL,
+                                    (GAsyncReadyCallback)signal_load_values_get_signal_info_ready,
+                                    task);
         return;
 
     case SIGNAL_LOAD_VALUES_STEP_SIGNAL_STRENGTH:
@@ -10679,12 +10855,13 @@ signal_load_values_context_step (GTask *task)
                  QMI_NAS_SIGNAL_STRENGTH_REQUEST_LTE_SNR |
                  QMI_NAS_SIGNAL_STRENGTH_REQUEST_LTE_RSRP),
                 NULL);
-            qmi_client_nas_get_signal_strength (ctx->client,
-                                                input,
-                                                5,
-                                                NULL,
-                                                (GAsyncReadyCallback)signal_load_values_get_signal_strength_ready,
-                                                task);
+            MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_get_signal_strength,
+                                        ctx->client,
+                                        input,
+                                        5,
+                                        NULL,
+                                        (GAsyncReadyCallback)signal_load_values_get_signal_strength_ready,
+                                        task);
             return;
         }
         ctx->step++;
@@ -10911,12 +11088,13 @@ wds_get_autoconnect_settings_ready (QmiClientWds *client,
     mm_obj_dbg (self, "need to explicitly disable autoconnect");
     input = qmi_message_wds_set_autoconnect_settings_input_new ();
     qmi_message_wds_set_autoconnect_settings_input_set_status (input, QMI_WDS_AUTOCONNECT_SETTING_DISABLED, NULL);
-    qmi_client_wds_set_autoconnect_settings (client,
-                                             input,
-                                             10,
-                                             NULL,
-                                             (GAsyncReadyCallback) wds_set_autoconnect_settings_ready,
-                                             task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_set_autoconnect_settings,
+                                client,
+                                input,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback) wds_set_autoconnect_settings_ready,
+                                task);
 }
 
 static void
@@ -10960,12 +11138,13 @@ parent_enabling_started_ready (MMBroadbandModem *_self,
         return;
     }
 
-    qmi_client_wds_get_autoconnect_settings (QMI_CLIENT_WDS (client),
-                                             NULL,
-                                             5,
-                                             NULL,
-                                             (GAsyncReadyCallback) wds_get_autoconnect_settings_ready,
-                                             task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wds_get_autoconnect_settings,
+                                QMI_CLIENT_WDS (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback) wds_get_autoconnect_settings_ready,
+                                task);
 }
 
 static void
@@ -11326,6 +11505,28 @@ mm_broadband_modem_qmi_new (const gchar *device,
                          NULL);
 }
 
+/*****************************************************************************/
+/* Port metrics (Base modem class) */
+
+static void
+add_port_metrics (MMBaseModem  *_self,
+                  MMPort       *port,
+                  GVariantDict *dict)
+{
+    MMBroadbandModemQmi *self = MM_BROADBAND_MODEM_QMI (_self);
+
+    MM_BASE_MODEM_CLASS (mm_broadband_modem_qmi_parent_class)->add_port_metrics (_self, port, dict);
+
+    if (MM_IS_PORT_QMI (port))
+        mm_port_qmi_add_metrics (MM_PORT_QMI (port), dict);
+
+    /* The indications are routed through the clients of the primary port */
+    if (port == MM_PORT (mm_broadband_modem_qmi_peek_port_qmi (self)))
+        mm_qmi_indication_router_add_metrics (self->priv->indication_router, dict);
+}
+
+/*****************************************************************************/
+
 static void
 mm_broadband_modem_qmi_init (MMBroadbandModemQmi *self)
 {
@@ -11333,6 +11534,7 @@ mm_broadband_modem_qmi_init (MMBroadbandModemQmi *self)
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
                                               MM_TYPE_BROADBAND_MODEM_QMI,
                                               MMBroadbandModemQmiPrivate);
+    self->priv->indication_router = mm_qmi_indication_router_new (self);
 }
 
 static void
@@ -11348,6 +11550,9 @@ finalize (GObject *object)
     if (self->priv->supported_bands)
         g_array_unref (self->priv->supported_bands);
 
+    mm_qmi_indication_router_log_stats (self->priv->indication_router);
+    mm_qmi_indication_router_free (self->priv->indication_router);
+
     G_OBJECT_CLASS (mm_broadband_modem_qmi_parent_class)->finalize (object);
 }
 
@@ -11723,6 +11928,7 @@ static void
 mm_broadband_modem_qmi_class_init (MMBroadbandModemQmiClass *klass)
 {
     GObjectClass *object_class = G_OBJECT_CLASS (klass);
+    MMBaseModemClass *base_modem_class = MM_BASE_MODEM_CLASS (klass);
     MMBroadbandModemClass *broadband_modem_class = MM_BROADBAND_MODEM_CLASS (klass);
 
     g_type_class_add_private (object_class, sizeof (MMBroadbandModemQmiPrivate));
@@ -11732,6 +11938,8 @@ mm_broadband_modem_qmi_class_init (MMBroadbandModemQmiClass *klass)
     object_class->finalize = finalize;
     object_class->dispose = dispose;
 
+    base_modem_class->add_port_metrics = add_port_metrics;
+
     broadband_modem_class->initialization_started = initialization_started;
     broadband_modem_class->initialization_started_finish = initialization_started_finish;
     broadband_modem_class->enabling_started = enabling_started;
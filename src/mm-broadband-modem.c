@@ -40,6 +40,7 @@
 #include "mm-iface-modem-messaging.h"
 #include "mm-iface-modem-voice.h"
 #include "mm-iface-modem-time.h"
+#include "mm-auth-provider.h"
 #include "mm-iface-modem-firmware.h"
 #include "mm-iface-modem-signal.h"
 #include "mm-iface-modem-oma.h"
@@ -50,6 +51,7 @@
 #include "mm-call-list.h"
 #include "mm-base-sim.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 #include "mm-modem-helpers.h"
 #include "mm-error-helpers.h"
 #include "mm-port-serial-qcdm.h"
@@ -173,6 +175,8 @@ struct _MMBroadbandModemPrivate {
     guint modem_cind_max_signal_quality;
     guint modem_cind_indicator_roaming;
     guint modem_cind_indicator_service;
+    guint modem_cind_indicator_call;
+    guint modem_cind_indicator_callsetup;
     MM3gppCmerMode modem_cmer_enable_mode;
     MM3gppCmerMode modem_cmer_disable_mode;
     MM3gppCmerInd modem_cmer_ind;
@@ -251,6 +255,7 @@ struct _MMBroadbandModemPrivate {
     /*<--- Modem Time interface --->*/
     /* Properties */
     GObject *modem_time_dbus_skeleton;
+    gboolean modem_time_ctzr_enabled;
 
     /*<--- Modem Signal interface --->*/
     /* Properties */
@@ -3111,6 +3116,13 @@ cgev_received (MMPortSerialAt   *port,
         break;
     }
 
+    /* Contexts defined or modified by the network update the profiles */
+    if (type == MM_3GPP_CGEV_NW_ACT_PRIMARY ||
+        type == MM_3GPP_CGEV_NW_ACT_SECONDARY ||
+        type == MM_3GPP_CGEV_NW_MODIFY ||
+        type == MM_3GPP_CGEV_NW_REACT)
+        mm_iface_modem_3gpp_profile_manager_invalidate_cache (MM_IFACE_MODEM_3GPP_PROFILE_MANAGER (self));
+
     g_free (str);
 }
 
@@ -3164,6 +3176,16 @@ ciev_signal_received (MMBroadbandModem *self,
                                             self->priv->modem_cind_max_signal_quality));
 }
 
+static void
+ciev_call_received (MMBroadbandModem *self,
+                    GMatchInfo       *match_info)
+{
+    /* The call indicators don't tell which call changed, so just request
+     * a call list check to find out */
+    mm_obj_dbg (self, "call indicator changed");
+    mm_iface_modem_voice_check_call_list (MM_IFACE_MODEM_VOICE (self));
+}
+
 static void
 ciev_received (MMPortSerialAt   *port,
                GMatchInfo       *match_info,
@@ -3180,11 +3202,16 @@ ciev_received (MMPortSerialAt   *port,
     if (mm_get_uint_from_str (item, &ind)) {
         if (ind == self->priv->modem_cind_indicator_signal_quality)
             ciev_signal_received (self, match_info);
+        else if (ind == self->priv->modem_cind_indicator_call ||
+                 ind == self->priv->modem_cind_indicator_callsetup)
+            ciev_call_received (self, match_info);
     }
     /* string index? */
     else {
         if (g_str_equal (item, "signal"))
             ciev_signal_received (self, match_info);
+        else if (g_str_equal (item, "call") || g_str_equal (item, "callsetup"))
+            ciev_call_received (self, match_info);
     }
 
     g_free (item);
@@ -3384,6 +3411,23 @@ cind_format_check_ready (MMBroadbandModem *self,
     } else
         self->priv->modem_cind_indicator_service = CIND_INDICATOR_INVALID;
 
+    /* Check if we support call indications */
+    r = g_hash_table_lookup (indicators, "call");
+    if (r) {
+        self->priv->modem_cind_indicator_call = mm_3gpp_cind_response_get_index (r);
+        mm_obj_dbg (self, "call indications via CIND are supported at index '%u'",
+                    self->priv->modem_cind_indicator_call);
+    } else
+        self->priv->modem_cind_indicator_call = CIND_INDICATOR_INVALID;
+
+    r = g_hash_table_lookup (indicators, "callsetup");
+    if (r) {
+        self->priv->modem_cind_indicator_callsetup = mm_3gpp_cind_response_get_index (r);
+        mm_obj_dbg (self, "call setup indications via CIND are supported at index '%u'",
+                    self->priv->modem_cind_indicator_callsetup);
+    } else
+        self->priv->modem_cind_indicator_callsetup = CIND_INDICATOR_INVALID;
+
     g_hash_table_destroy (indicators);
 
     /* Check +CMER required format */
@@ -4778,26 +4822,76 @@ modem_3gpp_scan_networks_finish (MMIfaceModem3gpp *self,
                                  GAsyncResult *res,
                                  GError **error)
 {
-    const gchar *result;
+    return g_task_propagate_pointer (G_TASK (res), error);
+}
 
-    result = mm_base_modem_at_command_finish (MM_BASE_MODEM (self), res, error);
-    if (!result)
-        return NULL;
+static void
+cops_test_ready (MMBaseModem  *self,
+                 GAsyncResult *res,
+                 GTask        *task)
+{
+    MMPortSerialAt *port;
+    const gchar    *result;
+    GError         *error = NULL;
+    GList          *info_list;
 
-    return mm_3gpp_parse_cops_test_response (result, MM_BROADBAND_MODEM (self)->priv->modem_current_charset, self, error);
+    result = mm_base_modem_at_command_full_finish (self, res, &error);
+    if (!result) {
+        /* +COPS=? is abortable: any character sent to the modem stops the
+         * scan, and the final result of the aborted command will be taken
+         * as reply to this one */
+        if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+            port = g_task_get_task_data (task);
+            mm_obj_dbg (self, "aborting network scan...");
+            mm_base_modem_at_command_full (self, port, "", 3, FALSE, FALSE, NULL, NULL, NULL);
+        }
+        g_task_return_error (task, error);
+        g_object_unref (task);
+        return;
+    }
+
+    info_list = mm_3gpp_parse_cops_test_response (result, MM_BROADBAND_MODEM (self)->priv->modem_current_charset, self, &error);
+    if (error)
+        g_task_return_error (task, error);
+    else
+        g_task_return_pointer (task, info_list, (GDestroyNotify)mm_3gpp_network_info_list_free);
+    g_object_unref (task);
 }
 
 static void
 modem_3gpp_scan_networks (MMIfaceModem3gpp *self,
+                          GCancellable *cancellable,
                           GAsyncReadyCallback callback,
                           gpointer user_data)
 {
-    mm_base_modem_at_command (MM_BASE_MODEM (self),
-                              "+COPS=?",
-                              300,
-                              FALSE,
-                              callback,
-                              user_data);
+    MMPortSerialAt *port;
+    GTask          *task;
+    GError         *error = NULL;
+
+    task = g_task_new (self, cancellable, callback, user_data);
+
+    /* The scan may take minutes, so prefer the secondary port if there is
+     * one, so that the primary one is not blocked meanwhile */
+    port = mm_base_modem_peek_port_secondary (MM_BASE_MODEM (self));
+    if (!port)
+        port = mm_base_modem_peek_best_at_port (MM_BASE_MODEM (self), &error);
+    if (!port) {
+        g_task_return_error (task, error);
+        g_object_unref (task);
+        return;
+    }
+
+    mm_obj_dbg (self, "scanning networks in port %s...", mm_port_get_device (MM_PORT (port)));
+    g_task_set_task_data (task, g_object_ref (port), g_object_unref);
+    mm_base_modem_at_command_full (MM_BASE_MODEM (self),
+                                   port,
+                                   "+COPS=?",
+                                   300,
+                                   FALSE,
+                                   FALSE,
+                                   cancellable,
+                                   (GAsyncReadyCallback)cops_test_ready,
+                                   task);
 }
 
 /*****************************************************************************/
@@ -7262,10 +7356,36 @@ modem_messaging_enable_unsolicited_events (MMIfaceModemMessaging *self,
 /*****************************************************************************/
 /* Load initial list of SMS parts (Messaging interface) */
 
+/* Number of SMS parts to take into the SMS list on each main loop
+ * iteration, when loading a full storage */
+#define SMS_PARTS_TAKE_CHUNK_SIZE 32
+
 typedef struct {
-    MMSmsStorage list_storage;
+    MMSmsStorage  list_storage;
+    /* Decoded parts pending to be taken (DecodedPart) */
+    GList        *decoded;
 } ListPartsContext;
 
+typedef struct {
+    MMSmsPart  *part;
+    MMSmsState  state;
+} DecodedPart;
+
+static void
+decoded_part_free (DecodedPart *decoded)
+{
+    if (decoded->part)
+        mm_sms_part_free (decoded->part);
+    g_slice_free (DecodedPart, decoded);
+}
+
+static void
+list_parts_context_free (ListPartsContext *ctx)
+{
+    g_list_free_full (ctx->decoded, (GDestroyNotify)decoded_part_free);
+    g_slice_free (ListPartsContext, ctx);
+}
+
 static gboolean
 modem_messaging_load_initial_sms_parts_finish (MMIfaceModemMessaging *self,
                                                GAsyncResult *res,
@@ -7445,16 +7565,99 @@ sms_state_from_index (guint index)
     }
 }
 
+static gboolean
+take_decoded_parts_cb (GTask *task)
+{
+    MMBroadbandModem *self;
+    ListPartsContext *ctx;
+    guint             i;
+
+    self = g_task_get_source_object (task);
+    ctx = g_task_get_task_data (task);
+
+    for (i = 0; ctx->decoded && i < SMS_PARTS_TAKE_CHUNK_SIZE; i++) {
+        DecodedPart *decoded;
+
+        decoded = ctx->decoded->data;
+        ctx->decoded = g_list_delete_link (ctx->decoded, ctx->decoded);
+
+        mm_iface_modem_messaging_take_part (MM_IFACE_MODEM_MESSAGING (self),
+                                            g_steal_pointer (&decoded->part),
+                                            decoded->state,
+                                            ctx->list_storage);
+        decoded_part_free (decoded);
+    }
+
+    /* Yield to the main loop until all parts are taken */
+    if (ctx->decoded)
+        return G_SOURCE_CONTINUE;
+
+    /* We consider all done */
+    g_task_return_boolean (task, TRUE);
+    g_object_unref (task);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+decode_pdu_parts_ready (MMBroadbandModem *self,
+                        GAsyncResult     *res,
+                        GTask            *task)
+{
+    ListPartsContext *ctx;
+
+    ctx = g_task_get_task_data (task);
+    ctx->decoded = g_task_propagate_pointer (G_TASK (res), NULL);
+
+    mm_obj_dbg (self, "decoded %u SMS parts from storage '%s'",
+                g_list_length (ctx->decoded),
+                mm_sms_storage_get_string (ctx->list_storage));
+    g_idle_add ((GSourceFunc)take_decoded_parts_cb, task);
+}
+
+static void
+decode_pdu_parts_thread (GTask            *decode_task,
+                         MMBroadbandModem *self,
+                         GList            *info_list,
+                         GCancellable     *cancellable)
+{
+    GList *decoded_list = NULL;
+    GList *l;
+
+    /* Note: only the PDU decoding happens in the worker thread, the parts
+     * are taken in the main thread */
+    for (l = info_list; l; l = g_list_next (l)) {
+        MM3gppPduInfo *info = l->data;
+        MMSmsPart *part;
+        GError *error = NULL;
+
+        part = mm_sms_part_3gpp_new_from_pdu (info->index, info->pdu, self, &error);
+        if (part) {
+            DecodedPart *decoded;
+
+            mm_obj_dbg (self, "correctly parsed PDU (%d)", info->index);
+            decoded = g_slice_new (DecodedPart);
+            decoded->part = part;
+            decoded->state = sms_state_from_index (info->status);
+            decoded_list = g_list_prepend (decoded_list, decoded);
+        } else {
+            /* Don't treat the error as critical */
+            mm_obj_dbg (self, "error parsing PDU (%d): %s", info->index, error->message);
+            g_error_free (error);
+        }
+    }
+
+    g_task_return_pointer (decode_task, g_list_reverse (decoded_list), NULL);
+}
+
 static void
 sms_pdu_part_list_ready (MMBroadbandModem *self,
                          GAsyncResult *res,
                          GTask *task)
 {
-    ListPartsContext *ctx;
     const gchar *response;
     GError *error = NULL;
     GList *info_list;
-    GList *l;
+    GTask *decode_task;
 
     /* Always always always unlock mem1 storage. Warned you've been. */
     mm_broadband_modem_unlock_sms_storages (self, TRUE, FALSE);
@@ -7473,31 +7676,12 @@ sms_pdu_part_list_ready (MMBroadbandModem *self,
         return;
     }
 
-    ctx = g_task_get_task_data (task);
-
-    for (l = info_list; l; l = g_list_next (l)) {
-        MM3gppPduInfo *info = l->data;
-        MMSmsPart *part;
-
-        part = mm_sms_part_3gpp_new_from_pdu (info->index, info->pdu, self, &error);
-        if (part) {
-            mm_obj_dbg (self, "correctly parsed PDU (%d)", info->index);
-            mm_iface_modem_messaging_take_part (MM_IFACE_MODEM_MESSAGING (self),
-                                                part,
-                                                sms_state_from_index (info->status),
-                                                ctx->list_storage);
-        } else {
-            /* Don't treat the error as critical */
-            mm_obj_dbg (self, "error parsing PDU (%d): %s", info->index, error->message);
-            g_clear_error (&error);
-        }
-    }
-
-    mm_3gpp_pdu_info_list_free (info_list);
-
-    /* We consider all done */
-    g_task_return_boolean (task, TRUE);
-    g_object_unref (task);
+    /* Decode all PDUs in a worker thread, the main loop shouldn't be blocked
+     * when loading a full storage */
+    decode_task = g_task_new (self, NULL, (GAsyncReadyCallback)decode_pdu_parts_ready, task);
+    g_task_set_task_data (decode_task, info_list, (GDestroyNotify)mm_3gpp_pdu_info_list_free);
+    g_task_run_in_thread (decode_task, (GTaskThreadFunc)decode_pdu_parts_thread);
+    g_object_unref (decode_task);
 }
 
 static void
@@ -7540,11 +7724,11 @@ modem_messaging_load_initial_sms_parts (MMIfaceModemMessaging *self,
     ListPartsContext *ctx;
     GTask *task;
 
-    ctx = g_new (ListPartsContext, 1);
+    ctx = g_slice_new0 (ListPartsContext);
     ctx->list_storage = storage;
 
     task = g_task_new (self, NULL, callback, user_data);
-    g_task_set_task_data (task, ctx, g_free);
+    g_task_set_task_data (task, ctx, (GDestroyNotify)list_parts_context_free);
 
     mm_obj_dbg (self, "listing SMS parts in storage '%s'", mm_sms_storage_get_string (storage));
 
@@ -8004,19 +8188,53 @@ modem_voice_cleanup_unsolicited_events (MMIfaceModemVoice *self,
 /*****************************************************************************/
 /* Enable unsolicited events (CALL indications) (Voice interface) */
 
+/* All the commands are run even if some of them fail, so the sequences can
+ * be sent as a single compound command line */
+
+static MMBaseModemAtResponseProcessorResult
+voice_unsolicited_events_response_processor (MMBaseModem   *self,
+                                             gpointer       none,
+                                             const gchar   *command,
+                                             const gchar   *response,
+                                             gboolean       last_command,
+                                             const GError  *error,
+                                             GVariant     **result,
+                                             GError       **result_error)
+{
+    if (error)
+        mm_obj_dbg (self, "couldn't run '%s' to setup voice event reporting: '%s'", command, error->message);
+
+    *result = NULL;
+    *result_error = NULL;
+    return MM_BASE_MODEM_AT_RESPONSE_PROCESSOR_RESULT_CONTINUE;
+}
+
+static const MMBaseModemAtCommand voice_unsolicited_events_enable_sequence[] = {
+    /* enable +CLIP URCs with calling line identity */
+    { "+CLIP=1", 3, FALSE, voice_unsolicited_events_response_processor, TRUE },
+    /* enable +CRING URCs instead of plain RING */
+    { "+CRC=1",  3, FALSE, voice_unsolicited_events_response_processor, TRUE },
+    /* enable +CCWA call waiting indications */
+    { "+CCWA=1", 3, FALSE, voice_unsolicited_events_response_processor, TRUE },
+    { NULL }
+};
+
+static const MMBaseModemAtCommand voice_unsolicited_events_disable_sequence[] = {
+    /* disable +CLIP URCs with calling line identity */
+    { "+CLIP=0", 3, FALSE, voice_unsolicited_events_response_processor, TRUE },
+    /* disable +CRING URCs instead of plain RING */
+    { "+CRC=0",  3, FALSE, voice_unsolicited_events_response_processor, TRUE },
+    /* disable +CCWA call waiting indications */
+    { "+CCWA=0", 3, FALSE, voice_unsolicited_events_response_processor, TRUE },
+    { NULL }
+};
+
 typedef struct {
     gboolean        enable;
     MMPortSerialAt *primary;
     MMPortSerialAt *secondary;
-    gchar          *clip_command;
-    gboolean        clip_primary_done;
-    gboolean        clip_secondary_done;
-    gchar          *crc_command;
-    gboolean        crc_primary_done;
-    gboolean        crc_secondary_done;
-    gchar          *ccwa_command;
-    gboolean        ccwa_primary_done;
-    gboolean        ccwa_secondary_done;
+    gboolean        primary_done;
+    gboolean        secondary_done;
 } VoiceUnsolicitedEventsContext;
 
 static void
@@ -8024,9 +8242,6 @@ voice_unsolicited_events_context_free (VoiceUnsolicitedEventsContext *ctx)
 {
     g_clear_object (&ctx->secondary);
     g_clear_object (&ctx->primary);
-    g_free (ctx->clip_command);
-    g_free (ctx->crc_command);
-    g_free (ctx->ccwa_command);
     g_slice_free (VoiceUnsolicitedEventsContext, ctx);
 }
 
@@ -8041,23 +8256,14 @@ modem_voice_enable_disable_unsolicited_events_finish (MMIfaceModemVoice  *self,
 static void run_voice_unsolicited_events_setup (GTask *task);
 
 static void
-voice_unsolicited_events_setup_ready (MMBroadbandModem *self,
-                                      GAsyncResult     *res,
-                                      GTask            *task)
+voice_unsolicited_events_setup_ready (MMBaseModem  *self,
+                                      GAsyncResult *res,
+                                      GTask        *task)
 {
-    VoiceUnsolicitedEventsContext *ctx;
-    GError                        *error = NULL;
-
-    ctx = g_task_get_task_data (task);
-
-    if (!mm_base_modem_at_command_finish (MM_BASE_MODEM (self), res, &error)) {
-        mm_obj_dbg (self, "couldn't %s voice event reporting: '%s'",
-                    ctx->enable ? "enable" : "disable",
-                    error->message);
-        g_error_free (error);
-    }
+    /* Errors in each command are already ignored by the response processor */
+    mm_base_modem_at_sequence_full_finish (self, res, NULL, NULL);
 
-    /* Continue on next port/command */
+    /* Continue on next port */
     run_voice_unsolicited_events_setup (task);
 }
 
@@ -8067,78 +8273,45 @@ run_voice_unsolicited_events_setup (GTask *task)
     MMBroadbandModem              *self;
     VoiceUnsolicitedEventsContext *ctx;
     MMPortSerialAt                *port = NULL;
-    const gchar                   *command = NULL;
 
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
 
-    /* CLIP on primary port */
-    if (!ctx->clip_primary_done && ctx->clip_command && ctx->primary) {
-        mm_obj_dbg (self, "%s +CLIP calling line reporting in primary port...", ctx->enable ? "enabling" : "disabling");
-        ctx->clip_primary_done = TRUE;
-        command = ctx->clip_command;
-        port = ctx->primary;
-    }
-    /* CLIP on secondary port */
-    else if (!ctx->clip_secondary_done && ctx->clip_command && ctx->secondary) {
-        mm_obj_dbg (self, "%s +CLIP calling line reporting in secondary port...", ctx->enable ? "enabling" : "disabling");
-        ctx->clip_secondary_done = TRUE;
-        command = ctx->clip_command;
-        port = ctx->secondary;
-    }
-    /* CRC on primary port */
-    else if (!ctx->crc_primary_done && ctx->crc_command && ctx->primary) {
-        mm_obj_dbg (self, "%s +CRC extended format of incoming call indications in primary port...", ctx->enable ? "enabling" : "disabling");
-        ctx->crc_primary_done = TRUE;
-        command = ctx->crc_command;
+    if (!ctx->primary_done && ctx->primary) {
+        mm_obj_dbg (self, "%s voice event reporting in primary port...", ctx->enable ? "enabling" : "disabling");
+        ctx->primary_done = TRUE;
         port = ctx->primary;
-    }
-    /* CRC on secondary port */
-    else if (!ctx->crc_secondary_done && ctx->crc_command && ctx->secondary) {
-        mm_obj_dbg (self, "%s +CRC extended format of incoming call indications in secondary port...", ctx->enable ? "enabling" : "disabling");
-        ctx->crc_secondary_done = TRUE;
-        command = ctx->crc_command;
-        port = ctx->secondary;
-    }
-    /* CCWA on primary port */
-    else if (!ctx->ccwa_primary_done && ctx->ccwa_command && ctx->primary) {
-        mm_obj_dbg (self, "%s +CCWA call waiting indications in primary port...", ctx->enable ? "enabling" : "disabling");
-        ctx->ccwa_primary_done = TRUE;
-        command = ctx->ccwa_command;
-        port = ctx->primary;
-    }
-    /* CCWA on secondary port */
-    else if (!ctx->ccwa_secondary_done && ctx->ccwa_command && ctx->secondary) {
-        mm_obj_dbg (self, "%s +CCWA call waiting indications in secondary port...", ctx->enable ? "enabling" : "disabling");
-        ctx->ccwa_secondary_done = TRUE;
-        command = ctx->ccwa_command;
+    } else if (!ctx->secondary_done && ctx->secondary) {
+        mm_obj_dbg (self, "%s voice event reporting in secondary port...", ctx->enable ? "enabling" : "disabling");
+        ctx->secondary_done = TRUE;
         port = ctx->secondary;
     }
 
     /* Enable/Disable unsolicited events in given port */
-    if (port && command) {
-        mm_base_modem_at_command_full (MM_BASE_MODEM (self),
-                                       port,
-                                       command,
-                                       3,
-                                       FALSE,
-                                       FALSE, /* raw */
-                                       NULL, /* cancellable */
-                                       (GAsyncReadyCallback)voice_unsolicited_events_setup_ready,
-                                       task);
+    if (port) {
+        mm_base_modem_at_sequence_full (MM_BASE_MODEM (self),
+                                        port,
+                                        (ctx->enable ?
+                                         voice_unsolicited_events_enable_sequence :
+                                         voice_unsolicited_events_disable_sequence),
+                                        NULL, /* response processor context */
+                                        NULL, /* response processor context free */
+                                        NULL, /* cancellable */
+                                        (GAsyncReadyCallback)voice_unsolicited_events_setup_ready,
+                                        task);
         return;
     }
 
     /* Fully done now */
     g_task_return_boolean (task, TRUE);
     g_object_unref (task);
-
 }
 
 static void
-modem_voice_enable_unsolicited_events (MMIfaceModemVoice   *self,
-                                       GAsyncReadyCallback  callback,
-                                       gpointer             user_data)
+voice_unsolicited_events_setup (MMIfaceModemVoice   *self,
+                                gboolean             enable,
+                                GAsyncReadyCallback  callback,
+                                gpointer             user_data)
 {
     VoiceUnsolicitedEventsContext *ctx;
     GTask                         *task;
@@ -8146,46 +8319,28 @@ modem_voice_enable_unsolicited_events (MMIfaceModemVoice   *self,
     task = g_task_new (self, NULL, callback, user_data);
 
     ctx = g_slice_new0 (VoiceUnsolicitedEventsContext);
-    ctx->enable = TRUE;
+    ctx->enable = enable;
     ctx->primary = mm_base_modem_get_port_primary (MM_BASE_MODEM (self));
     ctx->secondary = mm_base_modem_get_port_secondary (MM_BASE_MODEM (self));
-
-    /* enable +CLIP URCs with calling line identity */
-    ctx->clip_command = g_strdup ("+CLIP=1");
-    /* enable +CRING URCs instead of plain RING */
-    ctx->crc_command = g_strdup ("+CRC=1");
-    /* enable +CCWA call waiting indications */
-    ctx->ccwa_command = g_strdup ("+CCWA=1");
-
     g_task_set_task_data (task, ctx, (GDestroyNotify) voice_unsolicited_events_context_free);
 
     run_voice_unsolicited_events_setup (task);
 }
 
+static void
+modem_voice_enable_unsolicited_events (MMIfaceModemVoice   *self,
+                                       GAsyncReadyCallback  callback,
+                                       gpointer             user_data)
+{
+    voice_unsolicited_events_setup (self, TRUE, callback, user_data);
+}
+
 static void
 modem_voice_disable_unsolicited_events (MMIfaceModemVoice   *self,
                                         GAsyncReadyCallback  callback,
                                         gpointer             user_data)
 {
-    VoiceUnsolicitedEventsContext *ctx;
-    GTask                         *task;
-
-    task = g_task_new (self, NULL, callback, user_data);
-
-    ctx = g_slice_new0 (VoiceUnsolicitedEventsContext);
-    ctx->primary = mm_base_modem_get_port_primary (MM_BASE_MODEM (self));
-    ctx->secondary = mm_base_modem_get_port_secondary (MM_BASE_MODEM (self));
-
-    /* disable +CLIP URCs with calling line identity */
-    ctx->clip_command = g_strdup ("+CLIP=0");
-    /* disable +CRING URCs instead of plain RING */
-    ctx->crc_command = g_strdup ("+CRC=0");
-    /* disable +CCWA call waiting indications */
-    ctx->ccwa_command = g_strdup ("+CCWA=0");
-
-    g_task_set_task_data (task, ctx, (GDestroyNotify) voice_unsolicited_events_context_free);
-
-    run_voice_unsolicited_events_setup (task);
+    voice_unsolicited_events_setup (self, FALSE, callback, user_data);
 }
 
 /*****************************************************************************/
@@ -10004,8 +10159,8 @@ modem_time_load_network_timezone (MMIfaceModemTime *self,
 /* Check support (Time interface) */
 
 static const MMBaseModemAtCommand time_check_sequence[] = {
-    { "+CTZU=1",  3, TRUE, mm_base_modem_response_processor_no_result_continue },
-    { "+CCLK?",   3, TRUE, mm_base_modem_response_processor_string },
+    { "+CTZU=1",  3, TRUE, mm_base_modem_response_processor_no_result_continue, TRUE },
+    { "+CCLK?",   3, TRUE, mm_base_modem_response_processor_string,             TRUE },
     { NULL }
 };
 
@@ -10030,6 +10185,184 @@ modem_time_check_support (MMIfaceModemTime *self,
                                user_data);
 }
 
+/*****************************************************************************/
+/* Setup/Cleanup unsolicited events (Time interface) */
+
+static void
+ctzv_ctze_received (MMPortSerialAt   *port,
+                    GMatchInfo       *match_info,
+                    MMBroadbandModem *self)
+{
+    g_autoptr(MMNetworkTimezone) tz = NULL;
+    g_autoptr(GError)            error = NULL;
+
+    tz = mm_parse_ctzv_ctze_urc (match_info, &error);
+    if (!tz) {
+        mm_obj_dbg (self, "couldn't process time zone URC: %s", error->message);
+        return;
+    }
+
+    mm_obj_dbg (self, "time zone reported by the network: %d minutes", mm_network_timezone_get_offset (tz));
+    mm_iface_modem_time_update_network_timezone (MM_IFACE_MODEM_TIME (self), tz);
+}
+
+static gboolean
+modem_time_setup_cleanup_unsolicited_events_finish (MMIfaceModemTime  *self,
+                                                    GAsyncResult      *res,
+                                                    GError           **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+static void
+set_time_unsolicited_events_handlers (MMIfaceModemTime    *self,
+                                      gboolean             enable,
+                                      GAsyncReadyCallback  callback,
+                                      gpointer             user_data)
+{
+    MMPortSerialAt    *ports[2];
+    g_autoptr(GRegex)  ctzv_regex = NULL;
+    g_autoptr(GRegex)  ctze_regex = NULL;
+    guint              i;
+    GTask             *task;
+
+    ctzv_regex = mm_3gpp_ctzv_regex_get ();
+    ctze_regex = mm_3gpp_ctze_regex_get ();
+    ports[0] = mm_base_modem_peek_port_primary (MM_BASE_MODEM (self));
+    ports[1] = mm_base_modem_peek_port_secondary (MM_BASE_MODEM (self));
+
+    for (i = 0; i < G_N_ELEMENTS (ports); i++) {
+        if (!ports[i])
+            continue;
+
+        mm_obj_dbg (self, "%s time zone unsolicited events handlers in %s",
+                    enable ? "setting" : "removing",
+                    mm_port_get_device (MM_PORT (ports[i])));
+        mm_port_serial_at_add_unsolicited_msg_handler (
+            ports[i],
+            ctzv_regex,
+            enable ? (MMPortSerialAtUnsolicitedMsgFn) ctzv_ctze_received : NULL,
+            enable ? self : NULL,
+            NULL);
+        mm_port_serial_at_add_unsolicited_msg_handler (
+            ports[i],
+            ctze_regex,
+            enable ? (MMPortSerialAtUnsolicitedMsgFn) ctzv_ctze_received : NULL,
+            enable ? self : NULL,
+            NULL);
+    }
+
+    task = g_task_new (self, NULL, callback, user_data);
+    g_task_return_boolean (task, TRUE);
+    g_object_unref (task);
+}
+
+static void
+modem_time_setup_unsolicited_events (MMIfaceModemTime    *self,
+                                     GAsyncReadyCallback  callback,
+                                     gpointer             user_data)
+{
+    set_time_unsolicited_events_handlers (self, TRUE, callback, user_data);
+}
+
+static void
+modem_time_cleanup_unsolicited_events (MMIfaceModemTime    *self,
+                                       GAsyncReadyCallback  callback,
+                                       gpointer             user_data)
+{
+    set_time_unsolicited_events_handlers (self, FALSE, callback, user_data);
+}
+
+/*****************************************************************************/
+/* Enable/Disable unsolicited events (Time interface) */
+
+static const MMBaseModemAtCommand time_unsolicited_enable_sequence[] = {
+    /* Prefer +CTZE, which includes the daylight saving adjustment */
+    { "+CTZR=2", 3, FALSE, mm_base_modem_response_processor_continue_on_error },
+    { "+CTZR=1", 3, FALSE, mm_base_modem_response_processor_no_result         },
+    { NULL }
+};
+
+static gboolean
+modem_time_enable_unsolicited_events_finish (MMIfaceModemTime  *self,
+                                             GAsyncResult      *res,
+                                             GError           **error)
+{
+    GError *inner_error = NULL;
+
+    /* No result expected on success */
+    mm_base_modem_at_sequence_finish (MM_BASE_MODEM (self), res, NULL, &inner_error);
+    if (inner_error) {
+        g_propagate_error (error, inner_error);
+        return FALSE;
+    }
+
+    /* Only disable +CTZR later on if it was really enabled */
+    MM_BROADBAND_MODEM (self)->priv->modem_time_ctzr_enabled = TRUE;
+    return TRUE;
+}
+
+static void
+modem_time_enable_unsolicited_events (MMIfaceModemTime    *self,
+                                      GAsyncReadyCallback  callback,
+                                      gpointer             user_data)
+{
+    mm_base_modem_at_sequence (MM_BASE_MODEM (self),
+                               time_unsolicited_enable_sequence,
+                               NULL, /* response_processor_context */
+                               NULL, /* response_processor_context_free */
+                               callback,
+                               user_data);
+}
+
+static gboolean
+modem_time_disable_unsolicited_events_finish (MMIfaceModemTime  *self,
+                                              GAsyncResult      *res,
+                                              GError           **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+static void
+ctzr_disable_ready (MMBaseModem  *self,
+                    GAsyncResult *res,
+                    GTask        *task)
+{
+    g_autoptr(GError) error = NULL;
+
+    /* Failing to disable the URCs is not fatal, they're just ignored */
+    if (!mm_base_modem_at_command_finish (self, res, &error))
+        mm_obj_dbg (self, "couldn't disable time zone URCs: %s", error->message);
+
+    g_task_return_boolean (task, TRUE);
+    g_object_unref (task);
+}
+
+static void
+modem_time_disable_unsolicited_events (MMIfaceModemTime    *self,
+                                       GAsyncReadyCallback  callback,
+                                       gpointer             user_data)
+{
+    MMBroadbandModem *broadband = MM_BROADBAND_MODEM (self);
+    GTask            *task;
+
+    task = g_task_new (self, NULL, callback, user_data);
+
+    if (!broadband->priv->modem_time_ctzr_enabled) {
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    broadband->priv->modem_time_ctzr_enabled = FALSE;
+    mm_base_modem_at_command (MM_BASE_MODEM (self),
+                              "+CTZR=0",
+                              3,
+                              FALSE,
+                              (GAsyncReadyCallback)ctzr_disable_ready,
+                              task);
+}
+
 /*****************************************************************************/
 /* Check support (Signal interface) */
 
@@ -11541,6 +11874,7 @@ enabling_context_free (EnablingContext *ctx)
                                      MM_MODEM_STATE_CHANGE_REASON_UNKNOWN);
     }
 
+    mm_trace_end (ctx->self, "enabling", NULL);
     g_object_unref (ctx->self);
     g_free (ctx);
 }
@@ -11685,6 +12019,7 @@ enabling_step (GTask *task)
         /* fall through */
 
     case ENABLING_STEP_WAIT_FOR_FINAL_STATE:
+        mm_trace_step (ctx->self, "enabling", "wait-for-final-state");
         mm_iface_modem_wait_for_final_state (MM_IFACE_MODEM (ctx->self),
                                              MM_MODEM_STATE_UNKNOWN, /* just any */
                                              (GAsyncReadyCallback)enabling_wait_for_final_state_ready,
@@ -11692,6 +12027,7 @@ enabling_step (GTask *task)
         return;
 
     case ENABLING_STEP_STARTED:
+        mm_trace_step (ctx->self, "enabling", "started");
         if (MM_BROADBAND_MODEM_GET_CLASS (ctx->self)->enabling_started &&
             MM_BROADBAND_MODEM_GET_CLASS (ctx->self)->enabling_started_finish) {
             MM_BROADBAND_MODEM_GET_CLASS (ctx->self)->enabling_started (ctx->self,
@@ -11703,6 +12039,7 @@ enabling_step (GTask *task)
         /* fall through */
 
     case ENABLING_STEP_IFACE_MODEM:
+        mm_trace_step (ctx->self, "enabling", "iface-modem");
         /* From now on, the failure to enable one of the mandatory interfaces
          * will trigger the implicit disabling process */
 
@@ -11715,6 +12052,7 @@ enabling_step (GTask *task)
         return;
 
     case ENABLING_STEP_IFACE_3GPP:
+        mm_trace_step (ctx->self, "enabling", "iface-3gpp");
         if (ctx->self->priv->modem_3gpp_dbus_skeleton) {
             mm_obj_dbg (ctx->self, "modem has 3GPP capabilities, enabling the Modem 3GPP interface...");
             /* Enabling the Modem 3GPP interface */
@@ -11728,6 +12066,7 @@ enabling_step (GTask *task)
         /* fall through */
 
     case ENABLING_STEP_IFACE_3GPP_PROFILE_MANAGER:
+        mm_trace_step (ctx->self, "enabling", "iface-3gpp-profile-manager");
         if (ctx->self->priv->modem_3gpp_profile_manager_dbus_skeleton) {
             mm_obj_dbg (ctx->self, "modem has 3GPP profile management capabilities, enabling the Modem 3GPP Profile Manager interface...");
             mm_iface_modem_3gpp_profile_manager_enable (MM_IFACE_MODEM_3GPP_PROFILE_MANAGER (ctx->self),
@@ -11739,6 +12078,7 @@ enabling_step (GTask *task)
         /* fall through */
 
     case ENABLING_STEP_IFACE_3GPP_USSD:
+        mm_trace_step (ctx->self, "enabling", "iface-3gpp-ussd");
         if (ctx->self->priv->modem_3gpp_ussd_dbus_skeleton) {
             mm_obj_dbg (ctx->self, "modem has 3GPP/USSD capabilities, enabling the Modem 3GPP/USSD interface...");
             mm_iface_modem_3gpp_ussd_enable (MM_IFACE_MODEM_3GPP_USSD (ctx->self),
@@ -11750,6 +12090,7 @@ enabling_step (GTask *task)
         /* fall through */
 
     case ENABLING_STEP_IFACE_CDMA:
+        mm_trace_step (ctx->self, "enabling", "iface-cdma");
         if (ctx->self->priv->modem_cdma_dbus_skeleton) {
             mm_obj_dbg (ctx->self, "modem has CDMA capabilities, enabling the Modem CDMA interface...");
             /* Enabling the Modem CDMA interface */
@@ -11763,6 +12104,7 @@ enabling_step (GTask *task)
         /* fall through */
 
     case ENABLING_STEP_IFACE_LOCATION:
+        mm_trace_step (ctx->self, "enabling", "iface-location");
         if (ctx->self->priv->modem_location_dbus_skeleton) {
             mm_obj_dbg (ctx->self, "modem has location capabilities, enabling the Location interface...");
             /* Enabling the Modem Location interface */
@@ -11776,6 +12118,7 @@ enabling_step (GTask *task)
         /* fall through */
 
     case ENABLING_STEP_IFACE_MESSAGING:
+        mm_trace_step (ctx->self, "enabling", "iface-messaging");
         if (ctx->self->priv->modem_messaging_dbus_skeleton) {
             mm_obj_dbg (ctx->self, "modem has messaging capabilities, enabling the Messaging interface...");
             /* Enabling the Modem Messaging interface */
@@ -11789,6 +12132,7 @@ enabling_step (GTask *task)
         /* fall through */
 
     case ENABLING_STEP_IFACE_TIME:
+        mm_trace_step (ctx->self, "enabling", "iface-time");
         if (ctx->self->priv->modem_time_dbus_skeleton) {
             mm_obj_dbg (ctx->self, "modem has time capabilities, enabling the Time interface...");
             /* Enabling the Modem Time interface */
@@ -11802,6 +12146,7 @@ enabling_step (GTask *task)
        /* fall through */
 
     case ENABLING_STEP_IFACE_SIGNAL:
+        mm_trace_step (ctx->self, "enabling", "iface-signal");
         if (ctx->self->priv->modem_signal_dbus_skeleton) {
             mm_obj_dbg (ctx->self, "modem has extended signal reporting capabilities, enabling the Signal interface...");
             /* Enabling the Modem Signal interface */
@@ -11815,6 +12160,7 @@ enabling_step (GTask *task)
        /* fall through */
 
     case ENABLING_STEP_IFACE_OMA:
+        mm_trace_step (ctx->self, "enabling", "iface-oma");
         if (ctx->self->priv->modem_oma_dbus_skeleton) {
             mm_obj_dbg (ctx->self, "modem has OMA capabilities, enabling the OMA interface...");
             /* Enabling the Modem Oma interface */
@@ -11828,6 +12174,7 @@ enabling_step (GTask *task)
        /* fall through */
 
     case ENABLING_STEP_IFACE_VOICE:
+        mm_trace_step (ctx->self, "enabling", "iface-voice");
         if (ctx->self->priv->modem_voice_dbus_skeleton) {
             mm_obj_dbg (ctx->self, "modem has voice capabilities, enabling the Voice interface...");
             /* Enabling the Modem Voice interface */
@@ -11841,10 +12188,12 @@ enabling_step (GTask *task)
        /* fall through */
 
     case ENABLING_STEP_IFACE_FIRMWARE:
+        mm_trace_step (ctx->self, "enabling", "iface-firmware");
         ctx->step++;
        /* fall through */
 
     case ENABLING_STEP_IFACE_SIMPLE:
+        mm_trace_step (ctx->self, "enabling", "iface-simple");
         ctx->step++;
        /* fall through */
 
@@ -11913,6 +12262,7 @@ enable (MMBaseModem *self,
         ctx->step = ENABLING_STEP_FIRST;
 
         g_task_set_task_data (task, ctx, (GDestroyNotify)enabling_context_free);
+        mm_trace_begin (self, "enabling", NULL);
 
         enabling_step (task);
         return;
@@ -12190,6 +12540,7 @@ initialize_context_free (InitializeContext *ctx)
         g_error_free (error);
     }
 
+    mm_trace_end (ctx->self, "initialization", NULL);
     g_object_unref (ctx->self);
     g_free (ctx);
 }
@@ -12360,12 +12711,14 @@ initialize_step (GTask *task)
        /* fall through */
 
     case INITIALIZE_STEP_SETUP_PORTS:
+        mm_trace_step (ctx->self, "initialization", "setup-ports");
         if (MM_BROADBAND_MODEM_GET_CLASS (ctx->self)->setup_ports)
             MM_BROADBAND_MODEM_GET_CLASS (ctx->self)->setup_ports (ctx->self);
         ctx->step++;
        /* fall through */
 
     case INITIALIZE_STEP_STARTED:
+        mm_trace_step (ctx->self, "initialization", "started");
         if (MM_BROADBAND_MODEM_GET_CLASS (ctx->self)->initialization_started &&
             MM_BROADBAND_MODEM_GET_CLASS (ctx->self)->initialization_started_finish) {
             MM_BROADBAND_MODEM_GET_CLASS (ctx->self)->initialization_started (ctx->self,
@@ -12377,6 +12730,7 @@ initialize_step (GTask *task)
        /* fall through */
 
     case INITIALIZE_STEP_SETUP_SIMPLE_STATUS:
+        mm_trace_step (ctx->self, "initialization", "setup-simple-status");
         /* Simple status must be created before any interface initialization,
          * so that interfaces add and bind the properties they want to export.
          */
@@ -12386,6 +12740,7 @@ initialize_step (GTask *task)
        /* fall through */
 
     case INITIALIZE_STEP_IFACE_MODEM:
+        mm_trace_step (ctx->self, "initialization", "iface-modem");
         /* Initialize the Modem interface */
         mm_iface_modem_initialize (MM_IFACE_MODEM (ctx->self),
                                    g_task_get_cancellable (task),
@@ -12394,6 +12749,7 @@ initialize_step (GTask *task)
         return;
 
     case INITIALIZE_STEP_IFACE_3GPP:
+        mm_trace_step (ctx->self, "initialization", "iface-3gpp");
         if (mm_iface_modem_is_3gpp (MM_IFACE_MODEM (ctx->self))) {
             /* Initialize the 3GPP interface */
             mm_iface_modem_3gpp_initialize (MM_IFACE_MODEM_3GPP (ctx->self),
@@ -12418,6 +12774,7 @@ initialize_step (GTask *task)
        /* fall through */
 
     case INITIALIZE_STEP_IFACE_3GPP_PROFILE_MANAGER:
+        mm_trace_step (ctx->self, "initialization", "iface-3gpp-profile-manager");
         if (mm_iface_modem_is_3gpp (MM_IFACE_MODEM (ctx->self))) {
             /* Initialize the 3GPP Profile Manager interface */
             mm_iface_modem_3gpp_profile_manager_initialize (MM_IFACE_MODEM_3GPP_PROFILE_MANAGER (ctx->self),
@@ -12429,6 +12786,7 @@ initialize_step (GTask *task)
        /* fall through */
 
     case INITIALIZE_STEP_IFACE_3GPP_USSD:
+        mm_trace_step (ctx->self, "initialization", "iface-3gpp-ussd");
         if (mm_iface_modem_is_3gpp (MM_IFACE_MODEM (ctx->self))) {
             /* Initialize the 3GPP/USSD interface */
             mm_iface_modem_3gpp_ussd_initialize (MM_IFACE_MODEM_3GPP_USSD (ctx->self),
@@ -12440,6 +12798,7 @@ initialize_step (GTask *task)
        /* fall through */
 
     case INITIALIZE_STEP_IFACE_CDMA:
+        mm_trace_step (ctx->self, "initialization", "iface-cdma");
         if (mm_iface_modem_is_cdma (MM_IFACE_MODEM (ctx->self))) {
             /* Initialize the CDMA interface */
             mm_iface_modem_cdma_initialize (MM_IFACE_MODEM_CDMA (ctx->self),
@@ -12452,6 +12811,7 @@ initialize_step (GTask *task)
        /* fall through */
 
     case INITIALIZE_STEP_IFACE_LOCATION:
+        mm_trace_step (ctx->self, "initialization", "iface-location");
         /* Initialize the Location interface */
         mm_iface_modem_location_initialize (MM_IFACE_MODEM_LOCATION (ctx->self),
                                             g_task_get_cancellable (task),
@@ -12460,6 +12820,7 @@ initialize_step (GTask *task)
         return;
 
     case INITIALIZE_STEP_IFACE_MESSAGING:
+        mm_trace_step (ctx->self, "initialization", "iface-messaging");
         /* Initialize the Messaging interface */
         mm_iface_modem_messaging_initialize (MM_IFACE_MODEM_MESSAGING (ctx->self),
                                              g_task_get_cancellable (task),
@@ -12468,6 +12829,7 @@ initialize_step (GTask *task)
         return;
 
     case INITIALIZE_STEP_IFACE_TIME:
+        mm_trace_step (ctx->self, "initialization", "iface-time");
         /* Initialize the Time interface */
         mm_iface_modem_time_initialize (MM_IFACE_MODEM_TIME (ctx->self),
                                         g_task_get_cancellable (task),
@@ -12476,6 +12838,7 @@ initialize_step (GTask *task)
         return;
 
     case INITIALIZE_STEP_IFACE_SIGNAL:
+        mm_trace_step (ctx->self, "initialization", "iface-signal");
         /* Initialize the Signal interface */
         mm_iface_modem_signal_initialize (MM_IFACE_MODEM_SIGNAL (ctx->self),
                                           g_task_get_cancellable (task),
@@ -12484,6 +12847,7 @@ initialize_step (GTask *task)
         return;
 
     case INITIALIZE_STEP_IFACE_OMA:
+        mm_trace_step (ctx->self, "initialization", "iface-oma");
         /* Initialize the Oma interface */
         mm_iface_modem_oma_initialize (MM_IFACE_MODEM_OMA (ctx->self),
                                        g_task_get_cancellable (task),
@@ -12498,6 +12862,7 @@ initialize_step (GTask *task)
        /* fall through */
 
     case INITIALIZE_STEP_IFACE_VOICE:
+        mm_trace_step (ctx->self, "initialization", "iface-voice");
         /* Initialize the Voice interface */
         mm_iface_modem_voice_initialize (MM_IFACE_MODEM_VOICE (ctx->self),
                                          g_task_get_cancellable (task),
@@ -12506,6 +12871,7 @@ initialize_step (GTask *task)
         return;
 
     case INITIALIZE_STEP_IFACE_FIRMWARE:
+        mm_trace_step (ctx->self, "initialization", "iface-firmware");
         /* Initialize the Firmware interface */
         mm_iface_modem_firmware_initialize (MM_IFACE_MODEM_FIRMWARE (ctx->self),
                                             g_task_get_cancellable (task),
@@ -12514,6 +12880,7 @@ initialize_step (GTask *task)
         return;
 
     case INITIALIZE_STEP_SIM_HOT_SWAP:
+        mm_trace_step (ctx->self, "initialization", "sim-hot-swap");
         /* Create the SIM hot swap ports context only if not already done before
          * (we may be re-running the initialization step after SIM-PIN unlock) */
         if (!ctx->self->priv->sim_hot_swap_ports_ctx) {
@@ -12553,6 +12920,7 @@ initialize_step (GTask *task)
        /* fall through */
 
     case INITIALIZE_STEP_IFACE_SIMPLE:
+        mm_trace_step (ctx->self, "initialization", "iface-simple");
         if (ctx->self->priv->modem_state != MM_MODEM_STATE_FAILED)
             mm_iface_modem_simple_initialize (MM_IFACE_MODEM_SIMPLE (ctx->self));
         ctx->step++;
@@ -12684,6 +13052,7 @@ initialize (MMBaseModem *self,
         ctx->step = INITIALIZE_STEP_FIRST;
 
         g_task_set_task_data (task, ctx, (GDestroyNotify)initialize_context_free);
+        mm_trace_begin (self, "initialization", NULL);
 
         /* Set as being initialized, even if we were locked before */
         mm_iface_modem_update_state (MM_IFACE_MODEM (self),
@@ -12772,6 +13141,7 @@ mm_broadband_modem_sim_hot_swap_detected (MMBroadbandModem *self)
         self->priv->sim_hot_swap_ports_ctx = NULL;
     }
 
+    mm_iface_modem_invalidate_sim_cache (MM_IFACE_MODEM (self));
     mm_base_modem_process_sim_event (MM_BASE_MODEM (self));
 }
 
@@ -12796,6 +13166,49 @@ mm_broadband_modem_new (const gchar *device,
                          NULL);
 }
 
+/*****************************************************************************/
+/* Port metrics (Base modem class) */
+
+static MMPort *
+peek_main_control_port (MMBaseModem *self)
+{
+    MMPort *port;
+    GList  *ports;
+
+    port = MM_PORT (mm_base_modem_peek_port_primary (self));
+    if (port)
+        return port;
+
+    /* No AT primary port, use the first QMI or MBIM port instead */
+    ports = mm_base_modem_find_ports (self, MM_PORT_SUBSYS_UNKNOWN, MM_PORT_TYPE_QMI);
+    if (!ports)
+        ports = mm_base_modem_find_ports (self, MM_PORT_SUBSYS_UNKNOWN, MM_PORT_TYPE_MBIM);
+    if (!ports)
+        return NULL;
+
+    /* The modem holds its own reference on the port */
+    port = MM_PORT (ports->data);
+    g_list_free_full (ports, g_object_unref);
+    return port;
+}
+
+static void
+add_port_metrics (MMBaseModem  *_self,
+                  MMPort       *port,
+                  GVariantDict *dict)
+{
+    MMBroadbandModem *self = MM_BROADBAND_MODEM (_self);
+
+    /* Modem-wide and daemon-wide counters are reported in the main control
+     * port only */
+    if (port != peek_main_control_port (_self))
+        return;
+
+    mm_auth_provider_add_metrics (mm_auth_provider_get (), dict);
+    if (self->priv->modem_time_dbus_skeleton)
+        mm_iface_modem_time_add_metrics (MM_IFACE_MODEM_TIME (self), dict);
+}
+
 static void
 set_property (GObject *object,
               guint prop_id,
@@ -13507,6 +13920,14 @@ iface_modem_time_init (MMIfaceModemTime *iface)
     iface->load_network_time_finish = modem_time_load_network_time_finish;
     iface->load_network_timezone = modem_time_load_network_timezone;
     iface->load_network_timezone_finish = modem_time_load_network_timezone_finish;
+    iface->setup_unsolicited_events = modem_time_setup_unsolicited_events;
+    iface->setup_unsolicited_events_finish = modem_time_setup_cleanup_unsolicited_events_finish;
+    iface->cleanup_unsolicited_events = modem_time_cleanup_unsolicited_events;
+    iface->cleanup_unsolicited_events_finish = modem_time_setup_cleanup_unsolicited_events_finish;
+    iface->enable_unsolicited_events = modem_time_enable_unsolicited_events;
+    iface->enable_unsolicited_events_finish = modem_time_enable_unsolicited_events_finish;
+    iface->disable_unsolicited_events = modem_time_disable_unsolicited_events;
+    iface->disable_unsolicited_events_finish = modem_time_disable_unsolicited_events_finish;
 }
 
 static void
@@ -13548,6 +13969,7 @@ mm_broadband_modem_class_init (MMBroadbandModemClass *klass)
     base_modem_class->enable_finish = enable_finish;
     base_modem_class->disable = disable;
     base_modem_class->disable_finish = disable_finish;
+    base_modem_class->add_port_metrics = add_port_metrics;
 
 #if defined WITH_SYSTEMD_SUSPEND_RESUME
     base_modem_class->sync = synchronize;
@@ -160,7 +160,8 @@ call_start (MMBaseCall          *self,
         NULL);
 
     mm_obj_dbg (self, "starting call");
-    qmi_client_voice_dial_call (QMI_CLIENT_VOICE (client),
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_voice_dial_call,
+                                QMI_CLIENT_VOICE (client),
                                 input,
                                 90,
                                 NULL,
@@ -240,12 +241,13 @@ call_accept (MMBaseCall          *self,
         NULL);
 
     mm_obj_dbg (self, "Accepting call with id: %u", call_id);
-    qmi_client_voice_answer_call (QMI_CLIENT_VOICE (client),
-                                  input,
-                                  5,
-                                  NULL,
-                                  (GAsyncReadyCallback) voice_answer_call_ready,
-                                  task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_voice_answer_call,
+                                QMI_CLIENT_VOICE (client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback) voice_answer_call_ready,
+                                task);
     qmi_message_voice_answer_call_input_unref (input);
 }
 
@@ -320,12 +322,13 @@ call_hangup (MMBaseCall          *self,
         NULL);
 
     mm_obj_dbg (self, "Hanging up call with id: %u", call_id);
-    qmi_client_voice_end_call (QMI_CLIENT_VOICE (client),
-                               input,
-                               5,
-                               NULL,
-                               (GAsyncReadyCallback) voice_end_call_ready,
-                               task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_voice_end_call,
+                                QMI_CLIENT_VOICE (client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback) voice_end_call_ready,
+                                task);
     qmi_message_voice_end_call_input_unref (input);
 }
 
@@ -0,0 +1,323 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <config.h>
+#include <errno.h>
+#include <string.h>
+
+#include <glib/gstdio.h>
+
+#include <ModemManager.h>
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+#include "mm-capability-cache.h"
+
+/* Bump whenever the contents change, so that old entries are ignored */
+#define CACHE_VERSION 1
+
+#define FILE_SUFFIX ".keyfile"
+
+#define GROUP_CAPABILITIES        "capabilities"
+#define KEY_VERSION               "version"
+#define KEY_EQUIPMENT_IDENTIFIER  "equipment-identifier"
+#define KEY_REVISION              "revision"
+#define KEY_MANUFACTURER          "manufacturer"
+#define KEY_MODEL                 "model"
+#define KEY_HARDWARE_REVISION     "hardware-revision"
+#define KEY_AT_COMMANDS           "at-commands"
+#define KEY_AT_REPLIES            "at-replies"
+
+/*****************************************************************************/
+
+/* Test commands whose replies only depend on the device and firmware. Others,
+ * like +CPMS=? or +CPOL=?, also depend on the SIM card or the network, and
+ * +COPS=? even triggers a network scan, so they are never cached. */
+static const gchar *cacheable_at_commands[] = {
+    "+WS46=?",
+    "+CGDCONT=?",
+    "+CSCS=?",
+    "+CNMI=?",
+    "+CMGF=?",
+    "+CUSD=?",
+    "+CLCK=?",
+    "+CFUN=?",
+    "+CIND=?",
+    "+CMER=?",
+    "+CGEREP=?",
+    "+CGCLASS=?",
+    "+CESQ=?",
+    "+CTZU=?",
+    "+CLCC=?",
+    "+IFC=?",
+    "+CRM=?",
+    "+XACT=?",
+    "+URAT=?",
+    "^SYSCFG=?",
+    "^SYSCFGEX=?",
+    "^PREFMODE=?",
+    "^SWWAN=?",
+    "#BND=?",
+};
+
+gboolean
+mm_capability_cache_is_cacheable_at_command (const gchar *command)
+{
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (cacheable_at_commands); i++) {
+        if (g_ascii_strcasecmp (command, cacheable_at_commands[i]) == 0)
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/*****************************************************************************/
+
+MMCapabilityCacheEntry *
+mm_capability_cache_entry_new (void)
+{
+    MMCapabilityCacheEntry *entry;
+
+    entry = g_slice_new0 (MMCapabilityCacheEntry);
+    entry->at_replies = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    return entry;
+}
+
+void
+mm_capability_cache_entry_free (MMCapabilityCacheEntry *entry)
+{
+    g_free (entry->manufacturer);
+    g_free (entry->model);
+    g_free (entry->hardware_revision);
+    g_hash_table_unref (entry->at_replies);
+    g_slice_free (MMCapabilityCacheEntry, entry);
+}
+
+/*****************************************************************************/
+
+static gchar *
+build_path (const gchar  *dir,
+            const gchar  *equipment_identifier,
+            const gchar  *revision,
+            GError      **error)
+{
+    g_autofree gchar *key = NULL;
+    g_autofree gchar *checksum = NULL;
+
+    if (!equipment_identifier || !equipment_identifier[0] || !revision || !revision[0]) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS,
+                     "Invalid capability cache key: '%s' '%s'",
+                     equipment_identifier ? equipment_identifier : "",
+                     revision ? revision : "");
+        return NULL;
+    }
+
+    /* Both strings come from the modem, so they are hashed instead of being
+     * used as file name; the entry itself records them */
+    key = g_strdup_printf ("%s\n%s", equipment_identifier, revision);
+    checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, key, -1);
+    return g_strdup_printf ("%s" G_DIR_SEPARATOR_S "%s" FILE_SUFFIX, dir, checksum);
+}
+
+static gchar *
+load_string (GKeyFile    *keyfile,
+             const gchar *key)
+{
+    gchar *str;
+
+    /* Unknown values are stored as empty strings */
+    str = g_key_file_get_string (keyfile, GROUP_CAPABILITIES, key, NULL);
+    if (str && !str[0])
+        g_clear_pointer (&str, g_free);
+    return str;
+}
+
+MMCapabilityCacheEntry *
+mm_capability_cache_load (const gchar  *dir,
+                          const gchar  *equipment_identifier,
+                          const gchar  *revision,
+                          GError      **error)
+{
+    g_autoptr(MMCapabilityCacheEntry)  entry = NULL;
+    g_autoptr(GKeyFile)                keyfile = NULL;
+    g_autofree gchar                  *path = NULL;
+    g_autofree gchar                  *stored_equipment_identifier = NULL;
+    g_autofree gchar                  *stored_revision = NULL;
+    g_auto(GStrv)                      at_commands = NULL;
+    g_auto(GStrv)                      at_replies = NULL;
+    gsize                              n_at_commands = 0;
+    gsize                              n_at_replies = 0;
+    gsize                              i;
+    GError                            *inner_error = NULL;
+
+    path = build_path (dir, equipment_identifier, revision, error);
+    if (!path)
+        return NULL;
+
+    keyfile = g_key_file_new ();
+    if (!g_key_file_load_from_file (keyfile, path, G_KEY_FILE_NONE, &inner_error)) {
+        if (g_error_matches (inner_error, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
+            g_error_free (inner_error);
+            return NULL;
+        }
+        g_propagate_error (error, inner_error);
+        return NULL;
+    }
+
+    if (g_key_file_get_integer (keyfile, GROUP_CAPABILITIES, KEY_VERSION, NULL) != CACHE_VERSION)
+        return NULL;
+
+    stored_equipment_identifier = load_string (keyfile, KEY_EQUIPMENT_IDENTIFIER);
+    stored_revision = load_string (keyfile, KEY_REVISION);
+    if (g_strcmp0 (stored_equipment_identifier, equipment_identifier) || g_strcmp0 (stored_revision, revision))
+        return NULL;
+
+    entry = mm_capability_cache_entry_new ();
+    entry->manufacturer = load_string (keyfile, KEY_MANUFACTURER);
+    entry->model = load_string (keyfile, KEY_MODEL);
+    entry->hardware_revision = load_string (keyfile, KEY_HARDWARE_REVISION);
+
+    if (g_key_file_has_key (keyfile, GROUP_CAPABILITIES, KEY_AT_COMMANDS, NULL)) {
+        at_commands = g_key_file_get_string_list (keyfile, GROUP_CAPABILITIES, KEY_AT_COMMANDS, &n_at_commands, NULL);
+        at_replies = g_key_file_get_string_list (keyfile, GROUP_CAPABILITIES, KEY_AT_REPLIES, &n_at_replies, NULL);
+        if (n_at_commands != n_at_replies) {
+            g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                         "Invalid AT replies in cache entry: %" G_GSIZE_FORMAT " commands but %" G_GSIZE_FORMAT " replies",
+                         n_at_commands, n_at_replies);
+            return NULL;
+        }
+        for (i = 0; i < n_at_commands; i++) {
+            if (mm_capability_cache_is_cacheable_at_command (at_commands[i]))
+                g_hash_table_insert (entry->at_replies, g_strdup (at_commands[i]), g_strdup (at_replies[i]));
+        }
+    }
+
+    return g_steal_pointer (&entry);
+}
+
+/*****************************************************************************/
+
+static void
+store_string (GKeyFile    *keyfile,
+              const gchar *key,
+              const gchar *str)
+{
+    g_key_file_set_string (keyfile, GROUP_CAPABILITIES, key, str ? str : "");
+}
+
+gboolean
+mm_capability_cache_store (const gchar                   *dir,
+                           const gchar                   *equipment_identifier,
+                           const gchar                   *revision,
+                           const MMCapabilityCacheEntry  *entry,
+                           GError                       **error)
+{
+    g_autoptr(GKeyFile)  keyfile = NULL;
+    g_autofree gchar    *path = NULL;
+    g_autoptr(GPtrArray) at_commands = NULL;
+    g_autoptr(GPtrArray) at_replies = NULL;
+    GHashTableIter       iter;
+    gpointer             command;
+    gpointer             reply;
+
+    path = build_path (dir, equipment_identifier, revision, error);
+    if (!path)
+        return FALSE;
+
+    if (g_mkdir_with_parents (dir, 0700) < 0) {
+        g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errno),
+                     "Couldn't create capability cache directory '%s': %s", dir, g_strerror (errno));
+        return FALSE;
+    }
+
+    keyfile = g_key_file_new ();
+    g_key_file_set_integer (keyfile, GROUP_CAPABILITIES, KEY_VERSION, CACHE_VERSION);
+    store_string (keyfile, KEY_EQUIPMENT_IDENTIFIER, equipment_identifier);
+    store_string (keyfile, KEY_REVISION, revision);
+    store_string (keyfile, KEY_MANUFACTURER, entry->manufacturer);
+    store_string (keyfile, KEY_MODEL, entry->model);
+    store_string (keyfile, KEY_HARDWARE_REVISION, entry->hardware_revision);
+
+    /* Commands and replies as two lists of the same length, as commands
+     * usually contain '=', which isn't valid in key names */
+    at_commands = g_ptr_array_new ();
+    at_replies = g_ptr_array_new ();
+    g_hash_table_iter_init (&iter, entry->at_replies);
+    while (g_hash_table_iter_next (&iter, &command, &reply)) {
+        if (!mm_capability_cache_is_cacheable_at_command (command))
+            continue;
+        g_ptr_array_add (at_commands, command);
+        g_ptr_array_add (at_replies, reply);
+    }
+    g_key_file_set_string_list (keyfile, GROUP_CAPABILITIES, KEY_AT_COMMANDS,
+                                (const gchar * const *) at_commands->pdata, at_commands->len);
+    g_key_file_set_string_list (keyfile, GROUP_CAPABILITIES, KEY_AT_REPLIES,
+                                (const gchar * const *) at_replies->pdata, at_replies->len);
+
+    /* Written atomically */
+    return g_key_file_save_to_file (keyfile, path, error);
+}
+
+void
+mm_capability_cache_remove (const gchar *dir,
+                            const gchar *equipment_identifier,
+                            const gchar *revision)
+{
+    g_autofree gchar *path = NULL;
+
+    path = build_path (dir, equipment_identifier, revision, NULL);
+    if (path)
+        g_unlink (path);
+}
+
+gboolean
+mm_capability_cache_clear (const gchar  *dir,
+                           GError      **error)
+{
+    GDir        *gdir;
+    const gchar *name;
+    GError      *inner_error = NULL;
+
+    gdir = g_dir_open (dir, 0, &inner_error);
+    if (!gdir) {
+        /* Nothing ever stored */
+        if (g_error_matches (inner_error, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
+            g_error_free (inner_error);
+            return TRUE;
+        }
+        g_propagate_error (error, inner_error);
+        return FALSE;
+    }
+
+    while ((name = g_dir_read_name (gdir)) != NULL) {
+        g_autofree gchar *path = NULL;
+
+        if (!g_str_has_suffix (name, FILE_SUFFIX))
+            continue;
+
+        path = g_build_filename (dir, name, NULL);
+        if (g_unlink (path) < 0 && !inner_error)
+            inner_error = g_error_new (G_FILE_ERROR, g_file_error_from_errno (errno),
+                                       "Couldn't remove capability cache entry '%s': %s", path, g_strerror (errno));
+    }
+    g_dir_close (gdir);
+
+    if (inner_error) {
+        g_propagate_error (error, inner_error);
+        return FALSE;
+    }
+    return TRUE;
+}
@@ -0,0 +1,59 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#ifndef MM_CAPABILITY_CACHE_H
+#define MM_CAPABILITY_CACHE_H
+
+#include <glib.h>
+
+/* Persistent cache of the modem capabilities that don't change for a given
+ * device and firmware, stored in a directory with one keyfile per equipment
+ * identifier and firmware revision. */
+
+typedef struct {
+    gchar      *manufacturer;
+    gchar      *model;
+    gchar      *hardware_revision;
+    /* Replies to AT test commands, command -> reply */
+    GHashTable *at_replies;
+} MMCapabilityCacheEntry;
+
+/* Whether the reply to the given AT test command (without the AT prefix) is
+ * stored; any other reply in an entry is ignored */
+gboolean mm_capability_cache_is_cacheable_at_command (const gchar *command);
+
+MMCapabilityCacheEntry *mm_capability_cache_entry_new  (void);
+void                    mm_capability_cache_entry_free (MMCapabilityCacheEntry *entry);
+
+/* Returns NULL without error if there is no entry for the device */
+MMCapabilityCacheEntry *mm_capability_cache_load   (const gchar                   *dir,
+                                                    const gchar                   *equipment_identifier,
+                                                    const gchar                   *revision,
+                                                    GError                       **error);
+gboolean                mm_capability_cache_store  (const gchar                   *dir,
+                                                    const gchar                   *equipment_identifier,
+                                                    const gchar                   *revision,
+                                                    const MMCapabilityCacheEntry  *entry,
+                                                    GError                       **error);
+void                    mm_capability_cache_remove (const gchar                   *dir,
+                                                    const gchar                   *equipment_identifier,
+                                                    const gchar                   *revision);
+/* Removes the entries of all devices */
+gboolean                mm_capability_cache_clear  (const gchar                   *dir,
+                                                    GError                       **error);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMCapabilityCacheEntry, mm_capability_cache_entry_free)
+
+#endif /* MM_CAPABILITY_CACHE_H */
@@ -130,6 +130,7 @@ static const gchar *log_file;
 static gboolean     log_journal;
 static gboolean     log_show_ts;
 static gboolean     log_rel_ts;
+static gboolean     log_trace;
 
 static const GOptionEntry log_entries[] = {
     {
@@ -159,6 +160,11 @@ static const GOptionEntry log_entries[] = {
         "Use relative timestamps (from MM start)",
         NULL
     },
+    {
+        "log-trace", 0, 0, G_OPTION_ARG_NONE, &log_trace,
+        "Record a timeline of the modem probing, initialization and connection steps",
+        NULL
+    },
     { NULL }
 };
 
@@ -206,12 +212,20 @@ mm_context_get_log_relative_timestamps (void)
     return log_rel_ts;
 }
 
+gboolean
+mm_context_get_log_trace (void)
+{
+    return log_trace;
+}
+
 /*****************************************************************************/
 /* Test context */
 
 static gboolean  test_session;
 static gboolean  test_enable;
 static gchar    *test_plugin_dir;
+static gchar    *test_capability_cache_dir;
+static gchar    *test_sim_cache_dir;
 #if defined WITH_UDEV
 static gboolean  test_no_udev;
 #endif
@@ -239,6 +253,16 @@ static const GOptionEntry test_entries[] = {
         "Path to look for plugins",
         "[PATH]"
     },
+    {
+        "test-capability-cache-dir", 0, 0, G_OPTION_ARG_FILENAME, &test_capability_cache_dir,
+        "Path to store the modem capability cache",
+        "[PATH]"
+    },
+    {
+        "test-sim-cache-dir", 0, 0, G_OPTION_ARG_FILENAME, &test_sim_cache_dir,
+        "Path to store the SIM cache",
+        "[PATH]"
+    },
 #if defined WITH_UDEV
     {
         "test-no-udev", 0, 0, G_OPTION_ARG_NONE, &test_no_udev,
@@ -300,6 +324,18 @@ mm_context_get_test_plugin_dir (void)
     return test_plugin_dir ? test_plugin_dir : PLUGINDIR;
 }
 
+const gchar *
+mm_context_get_test_capability_cache_dir (void)
+{
+    return test_capability_cache_dir ? test_capability_cache_dir : CAPABILITYCACHEDIR;
+}
+
+const gchar *
+mm_context_get_test_sim_cache_dir (void)
+{
+    return test_sim_cache_dir ? test_sim_cache_dir : SIMCACHEDIR;
+}
+
 #if defined WITH_UDEV
 gboolean
 mm_context_get_test_no_udev (void)
@@ -41,11 +41,14 @@ const gchar *mm_context_get_log_file                (void);
 gboolean     mm_context_get_log_journal             (void);
 gboolean     mm_context_get_log_timestamps          (void);
 gboolean     mm_context_get_log_relative_timestamps (void);
+gboolean     mm_context_get_log_trace               (void);
 
 /* Testing support */
 gboolean     mm_context_get_test_session           (void);
 gboolean     mm_context_get_test_enable            (void);
 const gchar *mm_context_get_test_plugin_dir        (void);
+const gchar *mm_context_get_test_capability_cache_dir (void);
+const gchar *mm_context_get_test_sim_cache_dir        (void);
 #if defined WITH_UDEV
 gboolean     mm_context_get_test_no_udev           (void);
 #endif
@@ -0,0 +1,184 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <config.h>
+
+#include "mm-device-checkpoint.h"
+
+typedef struct {
+    gchar      *subsystem;
+    gchar      *name;
+    gint        interface_number;
+    MMPortType  port_type;
+} CheckpointPort;
+
+struct _MMDeviceCheckpoint {
+    gint64    timestamp;
+    guint16   vendor;
+    guint16   product;
+    gchar    *plugin;
+    GArray   *ports;
+    gchar    *revision;
+    gchar    *iccid;
+    gboolean  enabled;
+};
+
+/*****************************************************************************/
+
+static void
+checkpoint_port_clear (CheckpointPort *port)
+{
+    g_free (port->subsystem);
+    g_free (port->name);
+}
+
+MMDeviceCheckpoint *
+mm_device_checkpoint_new (gint64       timestamp,
+                          guint16      vendor,
+                          guint16      product,
+                          const gchar *plugin,
+                          const gchar *revision,
+                          const gchar *iccid,
+                          gboolean     enabled)
+{
+    MMDeviceCheckpoint *checkpoint;
+
+    checkpoint = g_slice_new0 (MMDeviceCheckpoint);
+    checkpoint->timestamp = timestamp;
+    checkpoint->vendor = vendor;
+    checkpoint->product = product;
+    checkpoint->plugin = g_strdup (plugin);
+    checkpoint->revision = g_strdup (revision);
+    checkpoint->iccid = g_strdup (iccid);
+    checkpoint->enabled = enabled;
+    checkpoint->ports = g_array_new (FALSE, FALSE, sizeof (CheckpointPort));
+    g_array_set_clear_func (checkpoint->ports, (GDestroyNotify) checkpoint_port_clear);
+    return checkpoint;
+}
+
+void
+mm_device_checkpoint_free (MMDeviceCheckpoint *checkpoint)
+{
+    g_free (checkpoint->plugin);
+    g_array_unref (checkpoint->ports);
+    g_free (checkpoint->revision);
+    g_free (checkpoint->iccid);
+    g_slice_free (MMDeviceCheckpoint, checkpoint);
+}
+
+void
+mm_device_checkpoint_add_port (MMDeviceCheckpoint *checkpoint,
+                               const gchar        *subsystem,
+                               const gchar        *name,
+                               gint                interface_number,
+                               MMPortType          port_type)
+{
+    CheckpointPort port;
+
+    port.subsystem = g_strdup (subsystem);
+    port.name = g_strdup (name);
+    port.interface_number = interface_number;
+    port.port_type = port_type;
+    g_array_append_val (checkpoint->ports, port);
+}
+
+guint
+mm_device_checkpoint_get_n_ports (MMDeviceCheckpoint *checkpoint)
+{
+    return checkpoint->ports->len;
+}
+
+const gchar *
+mm_device_checkpoint_get_plugin (MMDeviceCheckpoint *checkpoint)
+{
+    return checkpoint->plugin;
+}
+
+/*****************************************************************************/
+
+gboolean
+mm_device_checkpoint_matches (MMDeviceCheckpoint *checkpoint,
+                              guint16             vendor,
+                              guint16             product,
+                              gint64              now)
+{
+    if (now - checkpoint->timestamp > MM_DEVICE_CHECKPOINT_MAX_AGE_SECS * G_USEC_PER_SEC)
+        return FALSE;
+
+    return (checkpoint->vendor == vendor && checkpoint->product == product);
+}
+
+gboolean
+mm_device_checkpoint_ports_found (MMDeviceCheckpoint            *checkpoint,
+                                  MMDeviceCheckpointPortFoundFn  found_fn,
+                                  gpointer                       user_data)
+{
+    guint i;
+
+    for (i = 0; i < checkpoint->ports->len; i++) {
+        CheckpointPort *port;
+
+        port = &g_array_index (checkpoint->ports, CheckpointPort, i);
+        if (!found_fn (port->subsystem, port->name, user_data))
+            return FALSE;
+    }
+    return TRUE;
+}
+
+MMPortType
+mm_device_checkpoint_lookup_port_type (MMDeviceCheckpoint *checkpoint,
+                                       const gchar        *subsystem,
+                                       const gchar        *name,
+                                       gint                interface_number)
+{
+    guint i;
+
+    for (i = 0; i < checkpoint->ports->len; i++) {
+        CheckpointPort *port;
+
+        port = &g_array_index (checkpoint->ports, CheckpointPort, i);
+        if (g_strcmp0 (port->subsystem, subsystem) == 0 &&
+            g_strcmp0 (port->name, name) == 0 &&
+            port->interface_number == interface_number)
+            return port->port_type;
+    }
+    return MM_PORT_TYPE_UNKNOWN;
+}
+
+gboolean
+mm_device_checkpoint_revalidate (MMDeviceCheckpoint  *checkpoint,
+                                 const gchar         *revision,
+                                 const gchar         *iccid,
+                                 MMModemState         state,
+                                 const gchar        **reason)
+{
+    if (!checkpoint->enabled) {
+        *reason = "not enabled before suspending";
+        return FALSE;
+    }
+    if (g_strcmp0 (revision, checkpoint->revision) != 0) {
+        *reason = "firmware revision changed";
+        return FALSE;
+    }
+    if (g_strcmp0 (iccid, checkpoint->iccid) != 0) {
+        *reason = "SIM changed";
+        return FALSE;
+    }
+    if (state != MM_MODEM_STATE_DISABLED) {
+        *reason = "not disabled";
+        return FALSE;
+    }
+    return TRUE;
+}
@@ -0,0 +1,88 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#ifndef MM_DEVICE_CHECKPOINT_H
+#define MM_DEVICE_CHECKPOINT_H
+
+#include <glib.h>
+
+#include <ModemManager.h>
+
+#include "mm-port.h"
+
+/* State of a device taken before suspending the system, used to speed up
+ * the probing and initialization of the same device after resuming.
+ *
+ * Only the ports recorded in the checkpoint are waited for after resuming;
+ * ports that the device didn't expose before suspending, and that show up
+ * after the wait has been cut short, will not be part of the modem. */
+
+typedef struct _MMDeviceCheckpoint MMDeviceCheckpoint;
+
+/* Checkpoints are only used for devices appearing right after resuming. The
+ * monotonic clock doesn't advance while suspended, so this is effectively
+ * the time since the system resumed. */
+#define MM_DEVICE_CHECKPOINT_MAX_AGE_SECS 60
+
+MMDeviceCheckpoint *mm_device_checkpoint_new        (gint64       timestamp,
+                                                     guint16      vendor,
+                                                     guint16      product,
+                                                     const gchar *plugin,
+                                                     const gchar *revision,
+                                                     const gchar *iccid,
+                                                     gboolean     enabled);
+void                mm_device_checkpoint_free       (MMDeviceCheckpoint *checkpoint);
+void                mm_device_checkpoint_add_port   (MMDeviceCheckpoint *checkpoint,
+                                                     const gchar        *subsystem,
+                                                     const gchar        *name,
+                                                     gint                interface_number,
+                                                     MMPortType          port_type);
+guint               mm_device_checkpoint_get_n_ports (MMDeviceCheckpoint *checkpoint);
+const gchar        *mm_device_checkpoint_get_plugin  (MMDeviceCheckpoint *checkpoint);
+
+/* Whether the checkpoint is still valid at the given time, and was taken
+ * for the same device */
+gboolean mm_device_checkpoint_matches (MMDeviceCheckpoint *checkpoint,
+                                       guint16             vendor,
+                                       guint16             product,
+                                       gint64              now);
+
+/* Whether all the ports in the checkpoint are found with the given method */
+typedef gboolean (* MMDeviceCheckpointPortFoundFn) (const gchar *subsystem,
+                                                    const gchar *name,
+                                                    gpointer     user_data);
+gboolean mm_device_checkpoint_ports_found (MMDeviceCheckpoint            *checkpoint,
+                                           MMDeviceCheckpointPortFoundFn  found_fn,
+                                           gpointer                       user_data);
+
+/* Type of the port as recorded in the checkpoint, MM_PORT_TYPE_UNKNOWN if
+ * the port wasn't recorded or was ignored */
+MMPortType mm_device_checkpoint_lookup_port_type (MMDeviceCheckpoint *checkpoint,
+                                                  const gchar        *subsystem,
+                                                  const gchar        *name,
+                                                  gint                interface_number);
+
+/* Whether the modem, in its current state, can be enabled right away, i.e.
+ * it was enabled before suspending and has the same firmware and SIM. If
+ * not, the reason is given. */
+gboolean mm_device_checkpoint_revalidate (MMDeviceCheckpoint  *checkpoint,
+                                          const gchar         *revision,
+                                          const gchar         *iccid,
+                                          MMModemState         state,
+                                          const gchar        **reason);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMDeviceCheckpoint, mm_device_checkpoint_free)
+
+#endif /* MM_DEVICE_CHECKPOINT_H */
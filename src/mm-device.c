@@ -25,6 +25,7 @@
 
 #include "mm-device.h"
 #include "mm-plugin.h"
+#include "mm-iface-modem.h"
 #include "mm-log-object.h"
 
 static void log_object_iface_init (MMLogObjectInterface *iface);
@@ -92,6 +93,9 @@ struct _MMDevicePrivate {
 
     /* Scheduled reprobe */
     guint reprobe_id;
+
+    /* State before suspending, if any */
+    MMDeviceCheckpoint *checkpoint;
 };
 
 /*****************************************************************************/
@@ -207,6 +211,204 @@ add_port_driver (MMDevice       *self,
     self->priv->drivers[n_items + 1] = NULL;
 }
 
+/*****************************************************************************/
+/* Suspend/resume checkpoint */
+
+static void
+checkpoint_add_ports (MMDeviceCheckpoint *checkpoint,
+                      GList              *port_probes,
+                      gboolean            ignored)
+{
+    GList *l;
+
+    for (l = port_probes; l; l = g_list_next (l)) {
+        MMPortProbe    *probe = MM_PORT_PROBE (l->data);
+        MMKernelDevice *kernel_port;
+
+        kernel_port = mm_port_probe_peek_port (probe);
+        mm_device_checkpoint_add_port (checkpoint,
+                                       mm_kernel_device_get_subsystem (kernel_port),
+                                       mm_kernel_device_get_name (kernel_port),
+                                       mm_kernel_device_get_interface_number (kernel_port),
+                                       ignored ? MM_PORT_TYPE_UNKNOWN : mm_port_probe_get_port_type (probe));
+    }
+}
+
+static void
+device_peek_modem_checkpoint_info (MMDevice      *self,
+                                   const gchar  **revision,
+                                   const gchar  **iccid,
+                                   MMModemState  *state)
+{
+    MmGdbusModem         *skeleton = NULL;
+    g_autoptr(MMBaseSim)  sim = NULL;
+
+    g_object_get (self->priv->modem,
+                  MM_IFACE_MODEM_DBUS_SKELETON, &skeleton,
+                  MM_IFACE_MODEM_SIM,           &sim,
+                  MM_IFACE_MODEM_STATE,         state,
+                  NULL);
+    /* The skeleton and SIM are owned by the modem, so the strings are valid
+     * while the modem is around */
+    if (skeleton) {
+        *revision = mm_gdbus_modem_get_revision (skeleton);
+        g_object_unref (skeleton);
+    }
+    if (sim)
+        *iccid = mm_gdbus_sim_get_sim_identifier (MM_GDBUS_SIM (sim));
+}
+
+MMDeviceCheckpoint *
+mm_device_take_checkpoint (MMDevice *self)
+{
+    MMDeviceCheckpoint *checkpoint;
+    const gchar        *revision = NULL;
+    const gchar        *iccid = NULL;
+    MMModemState        state = MM_MODEM_STATE_UNKNOWN;
+
+    /* Only fully initialized modems of real devices */
+    if (self->priv->virtual ||
+        !self->priv->modem ||
+        !mm_base_modem_get_valid (self->priv->modem) ||
+        !MM_IS_IFACE_MODEM (self->priv->modem))
+        return NULL;
+
+    device_peek_modem_checkpoint_info (self, &revision, &iccid, &state);
+    checkpoint = mm_device_checkpoint_new (g_get_monotonic_time (),
+                                           self->priv->vendor,
+                                           self->priv->product,
+                                           mm_plugin_get_name (self->priv->plugin),
+                                           revision,
+                                           iccid,
+                                           state >= MM_MODEM_STATE_ENABLED);
+    checkpoint_add_ports (checkpoint, self->priv->port_probes, FALSE);
+    checkpoint_add_ports (checkpoint, self->priv->ignored_port_probes, TRUE);
+
+    mm_obj_dbg (self, "checkpoint taken: %u ports, revision '%s', %s",
+                mm_device_checkpoint_get_n_ports (checkpoint),
+                revision ? revision : "unknown",
+                (state >= MM_MODEM_STATE_ENABLED) ? "enabled" : "not enabled");
+    return checkpoint;
+}
+
+void
+mm_device_set_checkpoint (MMDevice           *self,
+                          MMDeviceCheckpoint *checkpoint)
+{
+    g_assert (!self->priv->port_probes && !self->priv->ignored_port_probes);
+
+    g_clear_pointer (&self->priv->checkpoint, mm_device_checkpoint_free);
+    self->priv->checkpoint = checkpoint;
+    if (checkpoint)
+        mm_obj_dbg (self, "using checkpoint taken before suspending (plugin '%s', %u ports)",
+                    mm_device_checkpoint_get_plugin (checkpoint),
+                    mm_device_checkpoint_get_n_ports (checkpoint));
+}
+
+const gchar *
+mm_device_peek_checkpoint_plugin (MMDevice *self)
+{
+    return self->priv->checkpoint ? mm_device_checkpoint_get_plugin (self->priv->checkpoint) : NULL;
+}
+
+static gboolean
+checkpoint_port_found (const gchar *subsystem,
+                       const gchar *name,
+                       MMDevice    *self)
+{
+    return !!device_find_probe_with_name (self, subsystem, name);
+}
+
+gboolean
+mm_device_checkpoint_ports_grabbed (MMDevice *self)
+{
+    if (!self->priv->checkpoint)
+        return FALSE;
+
+    return mm_device_checkpoint_ports_found (self->priv->checkpoint,
+                                             (MMDeviceCheckpointPortFoundFn) checkpoint_port_found,
+                                             self);
+}
+
+/* Probing results of the QCDM, QMI and MBIM ports are restored. AT ports are
+ * always probed again, as plugins may need to run their custom init there. */
+static void
+checkpoint_restore_probe (MMDevice    *self,
+                          MMPortProbe *probe)
+{
+    MMKernelDevice *kernel_port;
+
+    kernel_port = mm_port_probe_peek_port (probe);
+    switch (mm_device_checkpoint_lookup_port_type (self->priv->checkpoint,
+                                                   mm_kernel_device_get_subsystem (kernel_port),
+                                                   mm_kernel_device_get_name (kernel_port),
+                                                   mm_kernel_device_get_interface_number (kernel_port))) {
+    case MM_PORT_TYPE_QCDM:
+        mm_port_probe_set_result_qcdm (probe, TRUE);
+        break;
+    case MM_PORT_TYPE_QMI:
+        mm_port_probe_set_result_qmi (probe, TRUE);
+        break;
+    case MM_PORT_TYPE_MBIM:
+        mm_port_probe_set_result_mbim (probe, TRUE);
+        break;
+    case MM_PORT_TYPE_UNKNOWN:
+    case MM_PORT_TYPE_NET:
+    case MM_PORT_TYPE_AT:
+    case MM_PORT_TYPE_GPS:
+    case MM_PORT_TYPE_AUDIO:
+    case MM_PORT_TYPE_IGNORED:
+    default:
+        break;
+    }
+}
+
+static void
+checkpoint_enable_ready (MMBaseModem  *modem,
+                         GAsyncResult *res,
+                         MMDevice     *self)
+{
+    g_autoptr(GError) error = NULL;
+
+    if (!mm_base_modem_enable_finish (modem, res, &error))
+        mm_obj_warn (self, "couldn't re-enable modem after resume: %s", error->message);
+    else
+        mm_obj_info (self, "modem re-enabled after resume");
+    g_object_unref (self);
+}
+
+/* If the modem is the same one (same firmware and SIM) that was enabled
+ * before suspending, enable it right away */
+static void
+checkpoint_revalidate (MMDevice *self)
+{
+    g_autoptr(MMDeviceCheckpoint)  checkpoint = NULL;
+    const gchar                   *revision = NULL;
+    const gchar                   *iccid = NULL;
+    const gchar                   *reason = NULL;
+    MMModemState                   state = MM_MODEM_STATE_UNKNOWN;
+
+    /* Checkpoint only used once */
+    checkpoint = g_steal_pointer (&self->priv->checkpoint);
+
+    if (!MM_IS_IFACE_MODEM (self->priv->modem))
+        return;
+
+    device_peek_modem_checkpoint_info (self, &revision, &iccid, &state);
+    if (!mm_device_checkpoint_revalidate (checkpoint, revision, iccid, state, &reason)) {
+        mm_obj_dbg (self, "not re-enabling modem after resume: %s (state '%s')",
+                    reason, mm_modem_state_get_string (state));
+        return;
+    }
+
+    mm_obj_info (self, "modem revalidated after resume, re-enabling...");
+    mm_base_modem_enable (self->priv->modem,
+                          (GAsyncReadyCallback) checkpoint_enable_ready,
+                          g_object_ref (self));
+}
+
+/*****************************************************************************/
+
 void
 mm_device_grab_port (MMDevice       *self,
                      MMKernelDevice *kernel_port)
@@ -246,6 +448,8 @@ mm_device_grab_port (MMDevice       *self,
 
     /* Create and store new port probe */
     probe = mm_port_probe_new (self, kernel_port);
+    if (self->priv->checkpoint)
+        checkpoint_restore_probe (self, probe);
     self->priv->port_probes = g_list_prepend (self->priv->port_probes, probe);
 
     /* Notify about the grabbed port */
@@ -433,9 +637,11 @@ modem_valid (MMBaseModem *modem,
          * It may happen that the initialization sequence fails because the
          * modem gets disconnected, and in that case we don't really need
          * to export it */
-        if (self->priv->modem)
+        if (self->priv->modem) {
             export_modem (self);
-        else
+            if (self->priv->checkpoint)
+                checkpoint_revalidate (self);
+        } else
             mm_obj_dbg (self, "not exporting modem; no longer available");
     }
 }
@@ -833,6 +1039,7 @@ dispose (GObject *object)
     self->priv->port_probes = NULL;
     g_list_free_full (self->priv->ignored_port_probes, g_object_unref);
     self->priv->ignored_port_probes = NULL;
+    g_clear_pointer (&self->priv->checkpoint, mm_device_checkpoint_free);
 
     clear_modem (self);
 
@@ -21,6 +21,7 @@
 
 #include "mm-kernel-device.h"
 #include "mm-base-modem.h"
+#include "mm-device-checkpoint.h"
 
 #define MM_TYPE_DEVICE            (mm_device_get_type ())
 #define MM_DEVICE(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), MM_TYPE_DEVICE, MMDevice))
@@ -114,6 +115,15 @@ GList           *mm_device_get_port_probe_list  (MMDevice       *self);
 gboolean         mm_device_get_hotplugged       (MMDevice       *self);
 gboolean         mm_device_get_inhibited        (MMDevice       *self);
 
+/* Returns NULL if the device has no valid modem to take a checkpoint of */
+MMDeviceCheckpoint *mm_device_take_checkpoint (MMDevice *self);
+
+/* Takes ownership of the checkpoint, must be set before grabbing any port */
+void         mm_device_set_checkpoint            (MMDevice           *self,
+                                                  MMDeviceCheckpoint *checkpoint);
+const gchar *mm_device_peek_checkpoint_plugin    (MMDevice           *self);
+gboolean     mm_device_checkpoint_ports_grabbed  (MMDevice           *self);
+
 /* For testing purposes */
 void          mm_device_virtual_grab_ports (MMDevice     *self,
                                             const gchar **ports);
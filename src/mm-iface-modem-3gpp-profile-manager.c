@@ -33,6 +33,142 @@
 static GQuark support_checked_quark;
 static GQuark supported_quark;
 
+/*****************************************************************************/
+/* Profile cache
+ *
+ * The list of profiles is loaded from the modem once, and then kept up to
+ * date with the results of the set and delete operations, so that listing
+ * profiles or selecting the best one for a connection doesn't need to query
+ * the modem every time. Any notification of profile changes done in the
+ * modem itself invalidates it. */
+
+#define PROFILE_CACHE_TAG "3gpp-profile-manager-profile-cache-tag"
+
+static GQuark profile_cache_quark;
+
+typedef struct {
+    gboolean  valid;
+    GList    *profiles;
+    /* Bumped on every change, so that the result of a list operation
+     * started before the change isn't cached */
+    guint     generation;
+} ProfileCache;
+
+static void
+profile_cache_free (ProfileCache *cache)
+{
+    mm_3gpp_profile_list_free (cache->profiles);
+    g_slice_free (ProfileCache, cache);
+}
+
+static ProfileCache *
+get_profile_cache (MMIfaceModem3gppProfileManager *self)
+{
+    ProfileCache *cache;
+
+    if (G_UNLIKELY (!profile_cache_quark))
+        profile_cache_quark = g_quark_from_static_string (PROFILE_CACHE_TAG);
+
+    cache = g_object_get_qdata (G_OBJECT (self), profile_cache_quark);
+    if (!cache) {
+        cache = g_slice_new0 (ProfileCache);
+        g_object_set_qdata_full (G_OBJECT (self), profile_cache_quark, cache, (GDestroyNotify) profile_cache_free);
+    }
+    return cache;
+}
+
+/* Users of the cached profiles may modify them, so always give copies */
+static MM3gppProfile *
+profile_dup (MM3gppProfile *profile)
+{
+    g_autoptr(GVariant) dictionary = NULL;
+
+    dictionary = mm_3gpp_profile_get_dictionary (profile);
+    return mm_3gpp_profile_new_from_dictionary (dictionary, NULL);
+}
+
+static GList *
+profile_list_dup (GList *profiles)
+{
+    GList *copy = NULL;
+    GList *l;
+
+    for (l = profiles; l; l = g_list_next (l))
+        copy = g_list_prepend (copy, profile_dup (MM_3GPP_PROFILE (l->data)));
+    return g_list_reverse (copy);
+}
+
+static gint
+profile_id_cmp (MM3gppProfile *a,
+                MM3gppProfile *b)
+{
+    return mm_3gpp_profile_get_profile_id (a) - mm_3gpp_profile_get_profile_id (b);
+}
+
+static void
+profile_cache_store (MMIfaceModem3gppProfileManager *self,
+                     GList                          *profiles,
+                     guint                           generation)
+{
+    ProfileCache *cache;
+
+    cache = get_profile_cache (self);
+    if (cache->generation != generation) {
+        mm_obj_dbg (self, "profiles changed while being listed, not caching them");
+        return;
+    }
+
+    mm_3gpp_profile_list_free (cache->profiles);
+    cache->profiles = profile_list_dup (profiles);
+    cache->valid = TRUE;
+}
+
+static void
+profile_cache_remove (MMIfaceModem3gppProfileManager *self,
+                      gint                            profile_id)
+{
+    ProfileCache *cache;
+    GList        *l;
+
+    cache = get_profile_cache (self);
+    cache->generation++;
+    for (l = cache->profiles; l; l = g_list_next (l)) {
+        if (mm_3gpp_profile_get_profile_id (MM_3GPP_PROFILE (l->data)) == profile_id) {
+            g_object_unref (l->data);
+            cache->profiles = g_list_delete_link (cache->profiles, l);
+            return;
+        }
+    }
+}
+
+static void
+profile_cache_update (MMIfaceModem3gppProfileManager *self,
+                      MM3gppProfile                  *profile)
+{
+    ProfileCache *cache;
+
+    profile_cache_remove (self, mm_3gpp_profile_get_profile_id (profile));
+
+    cache = get_profile_cache (self);
+    if (cache->valid)
+        cache->profiles = g_list_insert_sorted (cache->profiles, profile_dup (profile), (GCompareFunc) profile_id_cmp);
+}
+
+void
+mm_iface_modem_3gpp_profile_manager_invalidate_cache (MMIfaceModem3gppProfileManager *self)
+{
+    ProfileCache *cache;
+
+    cache = get_profile_cache (self);
+    cache->generation++;
+    if (!cache->valid)
+        return;
+
+    mm_obj_dbg (self, "profile cache invalidated");
+    cache->valid = FALSE;
+    g_clear_pointer (&cache->profiles, mm_3gpp_profile_list_free);
+}
+
 /*****************************************************************************/
 
 void
@@ -49,6 +185,8 @@ mm_iface_modem_3gpp_profile_manager_updated (MMIfaceModem3gppProfileManager *sel
 {
     g_autoptr(MmGdbusModem3gppProfileManagerSkeleton) skeleton = NULL;
 
+    mm_iface_modem_3gpp_profile_manager_invalidate_cache (self);
+
     g_object_get (self,
                   MM_IFACE_MODEM_3GPP_PROFILE_MANAGER_DBUS_SKELETON, &skeleton,
                   NULL);
@@ -143,12 +281,16 @@ profile_manager_get_profile_after_ready (MMIfaceModem3gppProfileManager *self,
 
     ctx->stored = mm_iface_modem_3gpp_profile_manager_get_profile_finish (self, res, &error);
     if (!ctx->stored) {
+        mm_iface_modem_3gpp_profile_manager_invalidate_cache (self);
         g_prefix_error (&error, "Couldn't validate update of profile '%d': ", ctx->profile_id);
         g_task_return_error (task, error);
         g_object_unref (task);
         return;
     }
 
+    /* The profile as read back from the modem */
+    profile_cache_update (self, ctx->stored);
+
     ctx->step++;
     set_profile_step (task);
 }
@@ -182,6 +324,8 @@ profile_manager_store_profile_ready (MMIfaceModem3gppProfileManager *self,
 
     profile_id = MM_IFACE_MODEM_3GPP_PROFILE_MANAGER_GET_INTERFACE (self)->store_profile_finish (self, res, &error);
     if (profile_id == MM_3GPP_PROFILE_ID_UNKNOWN) {
+        /* Unknown what was actually stored */
+        mm_iface_modem_3gpp_profile_manager_invalidate_cache (self);
         g_task_return_error (task, error);
         g_object_unref (task);
         return;
@@ -195,6 +339,9 @@ profile_manager_store_profile_ready (MMIfaceModem3gppProfileManager *self,
     g_assert (ctx->profile_id == profile_id);
     mm_obj_dbg (self, "stored profile with id '%d'", ctx->profile_id);
 
+    /* Not served from the cache until read back */
+    profile_cache_remove (self, ctx->profile_id);
+
     ctx->step++;
     set_profile_step (task);
 }
@@ -655,6 +802,11 @@ mm_iface_modem_3gpp_profile_manager_get_profile_finish (MMIfaceModem3gppProfileM
     return MM_3GPP_PROFILE (g_task_propagate_pointer (G_TASK (res), error));
 }
 
+static void list_profiles_full (MMIfaceModem3gppProfileManager *self,
+                                gboolean                        use_cache,
+                                GAsyncReadyCallback             callback,
+                                gpointer                        user_data);
+
 static void
 get_profile_list_ready (MMIfaceModem3gppProfileManager *self,
                         GAsyncResult                   *res,
@@ -667,7 +819,7 @@ get_profile_list_ready (MMIfaceModem3gppProfileManager *self,
 
     profile_id = GPOINTER_TO_INT (g_task_get_task_data (task));
 
-    if (!MM_IFACE_MODEM_3GPP_PROFILE_MANAGER_GET_INTERFACE (self)->list_profiles_finish (self, res, &profiles, &error)) {
+    if (!mm_iface_modem_3gpp_profile_manager_list_profiles_finish (self, res, &profiles, &error)) {
         g_task_return_error (task, error);
         g_object_unref (task);
         return;
@@ -708,10 +860,24 @@ mm_iface_modem_3gpp_profile_manager_get_profile (MMIfaceModem3gppProfileManager
                                                  GAsyncReadyCallback             callback,
                                                  gpointer                        user_data)
 {
-    GTask *task;
+    GTask        *task;
+    ProfileCache *cache;
 
     task = g_task_new (self, NULL, callback, user_data);
 
+    cache = get_profile_cache (self);
+    if (cache->valid) {
+        MM3gppProfile *profile;
+
+        profile = mm_3gpp_profile_list_find_by_profile_id (cache->profiles, profile_id, NULL);
+        if (profile) {
+            g_task_return_pointer (task, profile_dup (profile), g_object_unref);
+            g_object_unref (task);
+            g_object_unref (profile);
+            return;
+        }
+    }
+
     if (MM_IFACE_MODEM_3GPP_PROFILE_MANAGER_GET_INTERFACE (self)->get_profile &&
         MM_IFACE_MODEM_3GPP_PROFILE_MANAGER_GET_INTERFACE (self)->get_profile_finish) {
         MM_IFACE_MODEM_3GPP_PROFILE_MANAGER_GET_INTERFACE (self)->get_profile (self,
@@ -724,15 +890,17 @@ mm_iface_modem_3gpp_profile_manager_get_profile (MMIfaceModem3gppProfileManager
     /* If there is no way to query one single profile, query all and filter */
     g_task_set_task_data (task, GINT_TO_POINTER (profile_id), NULL);
 
-    mm_iface_modem_3gpp_profile_manager_list_profiles (self,
-                                                       (GAsyncReadyCallback)get_profile_list_ready,
-                                                       task);
+    list_profiles_full (self,
+                        FALSE, /* not in the cache, or it wouldn't be needed */
+                        (GAsyncReadyCallback)get_profile_list_ready,
+                        task);
 }
 
 /*****************************************************************************/
 
 typedef struct {
     GList *profiles;
+    guint  cache_generation;
 } ListProfilesContext;
 
 static void
@@ -767,25 +935,41 @@ internal_list_profiles_ready (MMIfaceModem3gppProfileManager *self,
     ListProfilesContext *ctx;
     GError              *error = NULL;
 
-    ctx = g_slice_new0 (ListProfilesContext);
-    g_task_set_task_data (task, ctx, (GDestroyNotify) list_profiles_context_free);
+    ctx = g_task_get_task_data (task);
 
     if (!MM_IFACE_MODEM_3GPP_PROFILE_MANAGER_GET_INTERFACE (self)->list_profiles_finish (self, res, &ctx->profiles, &error))
         g_task_return_error (task, error);
-    else
+    else {
+        profile_cache_store (self, ctx->profiles, ctx->cache_generation);
         g_task_return_boolean (task, TRUE);
+    }
     g_object_unref (task);
 }
 
-void
-mm_iface_modem_3gpp_profile_manager_list_profiles (MMIfaceModem3gppProfileManager *self,
-                                                   GAsyncReadyCallback             callback,
-                                                   gpointer                        user_data)
+static void
+list_profiles_full (MMIfaceModem3gppProfileManager *self,
+                    gboolean                        use_cache,
+                    GAsyncReadyCallback             callback,
+                    gpointer                        user_data)
 {
-    GTask *task;
+    GTask               *task;
+    ListProfilesContext *ctx;
+    ProfileCache        *cache;
 
     task = g_task_new (self, NULL, callback, user_data);
 
+    cache = get_profile_cache (self);
+    ctx = g_slice_new0 (ListProfilesContext);
+    ctx->cache_generation = cache->generation;
+    g_task_set_task_data (task, ctx, (GDestroyNotify) list_profiles_context_free);
+
+    if (use_cache && cache->valid) {
+        ctx->profiles = profile_list_dup (cache->profiles);
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
     /* Internal calls to the list profile logic may be performed even if the 3GPP Profile Manager
      * interface is not exposed in DBus, therefore, make sure this logic exits cleanly if there
      * is no support for listing profiles */
@@ -803,6 +987,14 @@ mm_iface_modem_3gpp_profile_manager_list_profiles (MMIfaceModem3gppProfileManage
         task);
 }
 
+void
+mm_iface_modem_3gpp_profile_manager_list_profiles (MMIfaceModem3gppProfileManager *self,
+                                                   GAsyncReadyCallback             callback,
+                                                   gpointer                        user_data)
+{
+    list_profiles_full (self, TRUE, callback, user_data);
+}
+
 /*****************************************************************************/
 
 typedef struct {
@@ -1013,6 +1205,7 @@ typedef struct {
     GDBusMethodInvocation          *invocation;
     GVariant                       *dictionary;
     MMIfaceModem3gppProfileManager *self;
+    gint                            profile_id;
 } HandleDeleteContext;
 
 static void
@@ -1032,10 +1225,14 @@ delete_profile_ready (MMIfaceModem3gppProfileManager *self,
 {
     GError *error = NULL;
 
-    if (!MM_IFACE_MODEM_3GPP_PROFILE_MANAGER_GET_INTERFACE (self)->delete_profile_finish (self, res, &error))
+    if (!MM_IFACE_MODEM_3GPP_PROFILE_MANAGER_GET_INTERFACE (self)->delete_profile_finish (self, res, &error)) {
+        /* Unknown whether it was deleted */
+        mm_iface_modem_3gpp_profile_manager_invalidate_cache (self);
         g_dbus_method_invocation_take_error (ctx->invocation, error);
-    else
+    } else {
+        profile_cache_remove (self, ctx->profile_id);
         mm_gdbus_modem3gpp_profile_manager_complete_delete (ctx->skeleton, ctx->invocation);
+    }
     handle_delete_context_free (ctx);
 }
 
@@ -1097,6 +1294,8 @@ handle_delete_auth_ready (MMBaseModem         *self,
         return;
     }
 
+    ctx->profile_id = profile_id;
+
     MM_IFACE_MODEM_3GPP_PROFILE_MANAGER_GET_INTERFACE (self)->delete_profile (
         MM_IFACE_MODEM_3GPP_PROFILE_MANAGER (self),
         profile,
@@ -1209,6 +1408,8 @@ interface_disabling_step (GTask *task)
 
     switch (ctx->step) {
     case DISABLING_STEP_FIRST:
+        /* Profile change notifications are not received while disabled */
+        mm_iface_modem_3gpp_profile_manager_invalidate_cache (self);
         ctx->step++;
         /* fall through */
 
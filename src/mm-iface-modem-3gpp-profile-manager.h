@@ -217,9 +217,14 @@ void mm_iface_modem_3gpp_profile_manager_shutdown (MMIfaceModem3gppProfileManage
 void mm_iface_modem_3gpp_profile_manager_bind_simple_status (MMIfaceModem3gppProfileManager *self,
                                                              MMSimpleStatus                 *status);
 
-/* Helper to emit the Updated signal by implementations */
+/* Helper to emit the Updated signal by implementations; it also drops the
+ * cached list of profiles */
 void mm_iface_modem_3gpp_profile_manager_updated (MMIfaceModem3gppProfileManager *self);
 
+/* Drop the cached list of profiles, when they may have changed in the modem
+ * without an explicit update notification (e.g. network initiated contexts) */
+void mm_iface_modem_3gpp_profile_manager_invalidate_cache (MMIfaceModem3gppProfileManager *self);
+
 /* Internal list profile management */
 void           mm_iface_modem_3gpp_profile_manager_get_profile          (MMIfaceModem3gppProfileManager  *self,
                                                                          gint                             profile_id,
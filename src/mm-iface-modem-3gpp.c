@@ -63,8 +63,15 @@ typedef struct {
     GCancellable                 *pending_registration_cancellable;
     gboolean                      reloading_registration_info;
     /* Registration checks */
-    guint    check_timeout_source;
-    gboolean check_running;
+    MMPollScheduler *scheduler;
+    guint            check_timeout_source;
+    gboolean         check_running;
+    guint            check_refreshed_domains;
+    /* Network scan */
+    GCancellable *scan_cancellable;
+    GList        *scan_requests;
+    GVariant     *scan_result;
+    gint64        scan_result_time;
 } Private;
 
 static void
@@ -76,7 +83,13 @@ private_free (Private *priv)
         g_object_unref (priv->pending_registration_cancellable);
     }
     if (priv->check_timeout_source)
-        g_source_remove (priv->check_timeout_source);
+        mm_poll_scheduler_remove (priv->scheduler, priv->check_timeout_source);
+    mm_poll_scheduler_unref (priv->scheduler);
+    /* No scan requests may be pending, they hold a reference to the object */
+    g_assert (!priv->scan_requests);
+    g_clear_object (&priv->scan_cancellable);
+    if (priv->scan_result)
+        g_variant_unref (priv->scan_result);
     g_slice_free (Private, priv);
 }
 
@@ -95,6 +108,7 @@ get_private (MMIfaceModem3gpp *self)
         priv->state_ps = MM_MODEM_3GPP_REGISTRATION_STATE_UNKNOWN;
         priv->state_eps = MM_MODEM_3GPP_REGISTRATION_STATE_UNKNOWN;
         priv->state_5gs = MM_MODEM_3GPP_REGISTRATION_STATE_UNKNOWN;
+        priv->scheduler = mm_poll_scheduler_ref (mm_base_modem_peek_poll_scheduler (MM_BASE_MODEM (self)));
         g_object_set_qdata_full (G_OBJECT (self), private_quark, priv, (GDestroyNotify)private_free);
     }
 
@@ -710,32 +724,102 @@ scan_networks_build_result (GList *info_list)
         g_variant_builder_close (&builder);
     }
 
-    return g_variant_ref (g_variant_builder_end (&builder));
+    return g_variant_ref_sink (g_variant_builder_end (&builder));
 }
 
+/* Results of the last scan are reused for requests received shortly after */
+#define SCAN_RESULT_MAX_AGE_SECS 60
+
 static void
-handle_scan_ready (MMIfaceModem3gpp *self,
-                   GAsyncResult *res,
-                   HandleScanContext *ctx)
+scan_networks_ready (MMIfaceModem3gpp *self,
+                     GAsyncResult     *res)
 {
-    GError *error = NULL;
-    GList *info_list;
+    Private  *priv;
+    GError   *error = NULL;
+    GList    *info_list;
+    GList    *requests;
+    GList    *l;
 
+    priv = get_private (self);
     info_list = MM_IFACE_MODEM_3GPP_GET_INTERFACE (self)->scan_networks_finish (self, res, &error);
-    if (error)
-        g_dbus_method_invocation_take_error (ctx->invocation, error);
-    else {
-        GVariant *dict_array;
+    if (!error) {
+        if (priv->scan_result)
+            g_variant_unref (priv->scan_result);
+        priv->scan_result = scan_networks_build_result (info_list);
+        priv->scan_result_time = g_get_monotonic_time ();
+    }
+    mm_3gpp_network_info_list_free (info_list);
 
-        dict_array = scan_networks_build_result (info_list);
-        mm_gdbus_modem3gpp_complete_scan (ctx->skeleton,
-                                          ctx->invocation,
-                                          dict_array);
-        g_variant_unref (dict_array);
+    g_clear_object (&priv->scan_cancellable);
+    requests = priv->scan_requests;
+    priv->scan_requests = NULL;
+
+    /* Complete all the requests received while the scan was running */
+    for (l = requests; l; l = g_list_next (l)) {
+        HandleScanContext *ctx = l->data;
+
+        if (error)
+            g_dbus_method_invocation_return_gerror (ctx->invocation, error);
+        else
+            mm_gdbus_modem3gpp_complete_scan (ctx->skeleton, ctx->invocation, priv->scan_result);
+        handle_scan_context_free (ctx);
     }
+    g_list_free (requests);
 
-    mm_3gpp_network_info_list_free (info_list);
-    handle_scan_context_free (ctx);
+    g_clear_error (&error);
+    g_object_unref (self);
+}
+
+static void
+scan_networks_cancel (MMIfaceModem3gpp *self)
+{
+    Private *priv;
+
+    priv = get_private (self);
+
+    /* The last result is no longer valid once disabled */
+    if (priv->scan_result) {
+        g_variant_unref (priv->scan_result);
+        priv->scan_result = NULL;
+    }
+
+    if (priv->scan_cancellable) {
+        mm_obj_dbg (self, "cancelling ongoing network scan...");
+        g_cancellable_cancel (priv->scan_cancellable);
+    }
+}
+
+static void
+scan_networks_run (MMIfaceModem3gpp  *self,
+                   HandleScanContext *ctx)
+{
+    Private *priv;
+
+    priv = get_private (self);
+
+    if (priv->scan_result &&
+        g_get_monotonic_time () - priv->scan_result_time < SCAN_RESULT_MAX_AGE_SECS * G_USEC_PER_SEC) {
+        mm_obj_dbg (self, "reusing results of network scan run %" G_GINT64_FORMAT "s ago",
+                    (g_get_monotonic_time () - priv->scan_result_time) / G_USEC_PER_SEC);
+        mm_gdbus_modem3gpp_complete_scan (ctx->skeleton, ctx->invocation, priv->scan_result);
+        handle_scan_context_free (ctx);
+        return;
+    }
+
+    priv->scan_requests = g_list_append (priv->scan_requests, ctx);
+
+    /* Only one scan at a time, new requests just wait for the ongoing one */
+    if (priv->scan_cancellable) {
+        mm_obj_dbg (self, "network scan already running, waiting for its results");
+        return;
+    }
+
+    priv->scan_cancellable = g_cancellable_new ();
+    MM_IFACE_MODEM_3GPP_GET_INTERFACE (self)->scan_networks (
+        self,
+        priv->scan_cancellable,
+        (GAsyncReadyCallback)scan_networks_ready,
+        g_object_ref (self));
 }
 
 static void
@@ -799,10 +883,7 @@ handle_scan_auth_ready (MMBaseModem *self,
     case MM_MODEM_STATE_DISCONNECTING:
     case MM_MODEM_STATE_CONNECTING:
     case MM_MODEM_STATE_CONNECTED:
-        MM_IFACE_MODEM_3GPP_GET_INTERFACE (self)->scan_networks (
-            MM_IFACE_MODEM_3GPP (self),
-            (GAsyncReadyCallback)handle_scan_ready,
-            ctx);
+        scan_networks_run (MM_IFACE_MODEM_3GPP (self), ctx);
         return;
 
     default:
@@ -1601,6 +1682,16 @@ mm_iface_modem_3gpp_update_location (MMIfaceModem3gpp *self,
 
 /*****************************************************************************/
 
+typedef enum {
+    REGISTRATION_DOMAIN_CS  = 1 << 0,
+    REGISTRATION_DOMAIN_PS  = 1 << 1,
+    REGISTRATION_DOMAIN_EPS = 1 << 2,
+    REGISTRATION_DOMAIN_5GS = 1 << 3,
+} RegistrationDomain;
+
+static void periodic_registration_check_refreshed (MMIfaceModem3gpp   *self,
+                                                   RegistrationDomain  domain);
+
 static void
 update_registration_reload_current_registration_info_ready (MMIfaceModem3gpp *self,
                                                             GAsyncResult     *res,
@@ -1677,6 +1768,10 @@ update_registration_state (MMIfaceModem3gpp             *self,
     if (new_state == old_state)
         return;
 
+    /* A registration change comes along with updates in operator info,
+     * access technologies, signal quality and location; emit them together */
+    mm_base_modem_batch_properties (MM_BASE_MODEM (self));
+
     if (REG_STATE_IS_REGISTERED (new_state)) {
         MMModemState modem_state;
 
@@ -1742,6 +1837,7 @@ mm_iface_modem_3gpp_update_cs_registration_state (MMIfaceModem3gpp             *
     priv = get_private (self);
     priv->state_cs = state;
     update_registration_state (self, get_consolidated_reg_state (self), TRUE);
+    periodic_registration_check_refreshed (self, REGISTRATION_DOMAIN_CS);
 }
 
 void
@@ -1761,6 +1857,7 @@ mm_iface_modem_3gpp_update_ps_registration_state (MMIfaceModem3gpp             *
     priv = get_private (self);
     priv->state_ps = state;
     update_registration_state (self, get_consolidated_reg_state (self), TRUE);
+    periodic_registration_check_refreshed (self, REGISTRATION_DOMAIN_PS);
 }
 
 void
@@ -1780,6 +1877,7 @@ mm_iface_modem_3gpp_update_eps_registration_state (MMIfaceModem3gpp
     priv = get_private (self);
     priv->state_eps = state;
     update_registration_state (self, get_consolidated_reg_state (self), TRUE);
+    periodic_registration_check_refreshed (self, REGISTRATION_DOMAIN_EPS);
 }
 
 void
@@ -1799,6 +1897,7 @@ mm_iface_modem_3gpp_update_5gs_registration_state (MMIfaceModem3gpp
     priv = get_private (self);
     priv->state_5gs = state;
     update_registration_state (self, get_consolidated_reg_state (self), TRUE);
+    periodic_registration_check_refreshed (self, REGISTRATION_DOMAIN_5GS);
 }
 
 /*****************************************************************************/
@@ -1834,6 +1933,7 @@ periodic_registration_check (MMIfaceModem3gpp *self)
     /* Only launch a new one if not one running already */
     if (!priv->check_running) {
         priv->check_running = TRUE;
+        priv->check_refreshed_domains = 0;
         mm_iface_modem_3gpp_run_registration_checks (
             self,
             (GAsyncReadyCallback)periodic_registration_checks_ready,
@@ -1853,7 +1953,7 @@ periodic_registration_check_disable (MMIfaceModem3gpp *self)
     if (!priv->check_timeout_source)
         return;
 
-    g_source_remove (priv->check_timeout_source);
+    mm_poll_scheduler_remove (priv->scheduler, priv->check_timeout_source);
     priv->check_timeout_source = 0;
 
     mm_obj_dbg (self, "periodic 3GPP registration checks disabled");
@@ -1872,9 +1972,53 @@ periodic_registration_check_enable (MMIfaceModem3gpp *self)
 
     /* Create context and keep it as object data */
     mm_obj_dbg (self, "periodic 3GPP registration checks enabled");
-    priv->check_timeout_source = g_timeout_add_seconds (REGISTRATION_CHECK_TIMEOUT_SEC,
-                                                        (GSourceFunc)periodic_registration_check,
-                                                        self);
+    priv->check_refreshed_domains = 0;
+    priv->check_timeout_source = mm_poll_scheduler_add_seconds (priv->scheduler,
+                                                                "3gpp registration check",
+                                                                REGISTRATION_CHECK_TIMEOUT_SEC,
+                                                                (GSourceFunc)periodic_registration_check,
+                                                                self);
+}
+
+static void
+periodic_registration_check_refreshed (MMIfaceModem3gpp   *self,
+                                       RegistrationDomain  domain)
+{
+    Private  *priv;
+    gboolean  is_cs_supported = FALSE;
+    gboolean  is_ps_supported = FALSE;
+    gboolean  is_eps_supported = FALSE;
+    gboolean  is_5gs_supported = FALSE;
+    guint     domains = 0;
+
+    priv = get_private (self);
+
+    /* Only updates received while the next check is scheduled */
+    if (!priv->check_timeout_source || priv->check_running)
+        return;
+
+    g_object_get (self,
+                  MM_IFACE_MODEM_3GPP_CS_NETWORK_SUPPORTED,  &is_cs_supported,
+                  MM_IFACE_MODEM_3GPP_PS_NETWORK_SUPPORTED,  &is_ps_supported,
+                  MM_IFACE_MODEM_3GPP_EPS_NETWORK_SUPPORTED, &is_eps_supported,
+                  MM_IFACE_MODEM_3GPP_5GS_NETWORK_SUPPORTED, &is_5gs_supported,
+                  NULL);
+    if (is_cs_supported)
+        domains |= REGISTRATION_DOMAIN_CS;
+    if (is_ps_supported)
+        domains |= REGISTRATION_DOMAIN_PS;
+    if (is_eps_supported)
+        domains |= REGISTRATION_DOMAIN_EPS;
+    if (is_5gs_supported)
+        domains |= REGISTRATION_DOMAIN_5GS;
+
+    /* Once all the supported domains have reported their state, the next
+     * check is useless; restart its period instead */
+    priv->check_refreshed_domains |= domain;
+    if ((priv->check_refreshed_domains & domains) == domains) {
+        mm_poll_scheduler_defer (priv->scheduler, priv->check_timeout_source);
+        priv->check_refreshed_domains = 0;
+    }
 }
 
 /*****************************************************************************/
@@ -1994,6 +2138,7 @@ static void interface_disabling_step (GTask *task);
 
 typedef enum {
     DISABLING_STEP_FIRST,
+    DISABLING_STEP_NETWORK_SCAN,
     DISABLING_STEP_INITIAL_EPS_BEARER,
     DISABLING_STEP_PERIODIC_REGISTRATION_CHECKS,
     DISABLING_STEP_DISABLE_UNSOLICITED_REGISTRATION_EVENTS,
@@ -2070,6 +2215,12 @@ interface_disabling_step (GTask *task)
         ctx->step++;
         /* fall through */
 
+    case DISABLING_STEP_NETWORK_SCAN:
+        /* Abort any ongoing network scan */
+        scan_networks_cancel (self);
+        ctx->step++;
+        /* fall through */
+
     case DISABLING_STEP_INITIAL_EPS_BEARER:
         mm_iface_modem_3gpp_update_initial_eps_bearer (self, NULL);
         ctx->step++;
@@ -209,8 +209,10 @@ struct _MMIfaceModem3gpp {
                                           GAsyncResult *res,
                                           GError **error);
 
-    /* Scan current networks, expect a GList of MMModem3gppNetworkInfo */
+    /* Scan current networks, expect a GList of MMModem3gppNetworkInfo.
+     * Cancelling should also abort the scan in the modem, if possible. */
     void (* scan_networks) (MMIfaceModem3gpp *self,
+                            GCancellable *cancellable,
                             GAsyncReadyCallback callback,
                             gpointer user_data);
     GList * (*scan_networks_finish) (MMIfaceModem3gpp *self,
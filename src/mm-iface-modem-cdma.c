@@ -1226,6 +1226,7 @@ mm_iface_modem_cdma_update_cdma1x_registration_state (MMIfaceModemCdma *self,
 /*****************************************************************************/
 
 typedef struct {
+    MMPollScheduler *scheduler;
     guint timeout_source;
     gboolean running;
 } RegistrationCheckContext;
@@ -1234,7 +1235,8 @@ static void
 registration_check_context_free (RegistrationCheckContext *ctx)
 {
     if (ctx->timeout_source)
-        g_source_remove (ctx->timeout_source);
+        mm_poll_scheduler_remove (ctx->scheduler, ctx->timeout_source);
+    mm_poll_scheduler_unref (ctx->scheduler);
     g_free (ctx);
 }
 
@@ -1307,9 +1309,12 @@ periodic_registration_check_enable (MMIfaceModemCdma *self)
     /* Create context and keep it as object data */
     mm_obj_dbg (self, "periodic CDMA registration checks enabled");
     ctx = g_new0 (RegistrationCheckContext, 1);
-    ctx->timeout_source = g_timeout_add_seconds (REGISTRATION_CHECK_TIMEOUT_SEC,
-                                                 (GSourceFunc)periodic_registration_check,
-                                                 self);
+    ctx->scheduler = mm_poll_scheduler_ref (mm_base_modem_peek_poll_scheduler (MM_BASE_MODEM (self)));
+    ctx->timeout_source = mm_poll_scheduler_add_seconds (ctx->scheduler,
+                                                         "cdma registration check",
+                                                         REGISTRATION_CHECK_TIMEOUT_SEC,
+                                                         (GSourceFunc)periodic_registration_check,
+                                                         self);
     g_object_set_qdata_full (G_OBJECT (self),
                              registration_check_context_quark,
                              ctx,
@@ -1351,11 +1356,11 @@ mm_iface_modem_cdma_update_activation_state (MMIfaceModemCdma *self,
         }
     }
 
-    /* Flush current change before signaling the state change,
-     * so that clients get the proper state already in the
-     * state-changed callback */
+    /* Flush current change (and any other batched one) before signaling
+     * the state change, so that clients get the proper state already in
+     * the state-changed callback */
     mm_gdbus_modem_cdma_set_activation_state (skeleton, activation_state);
-    g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (skeleton));
+    mm_base_modem_flush_properties (MM_BASE_MODEM (self));
     /* We don't know what changed, so just return an empty dictionary for now */
     mm_gdbus_modem_cdma_emit_activation_state_changed (skeleton,
                                                        activation_state,
@@ -357,13 +357,15 @@ notify_3gpp_location_update (MMIfaceModemLocation *self,
 
     /* We only update the property if we are supposed to signal
      * location */
-    if (mm_gdbus_modem_location_get_signals_location (skeleton))
+    if (mm_gdbus_modem_location_get_signals_location (skeleton)) {
+        mm_base_modem_batch_properties (MM_BASE_MODEM (self));
         mm_gdbus_modem_location_set_location (
             skeleton,
             build_location_dictionary (mm_gdbus_modem_location_get_location (skeleton),
                                        location_3gpp,
                                        NULL, NULL,
                                        NULL));
+    }
 }
 
 void
@@ -25,10 +25,12 @@
 #define SUPPORT_CHECKED_TAG "messaging-support-checked-tag"
 #define SUPPORTED_TAG       "messaging-supported-tag"
 #define STORAGE_CONTEXT_TAG "messaging-storage-context-tag"
+#define MESSAGES_CONTEXT_TAG "messaging-messages-context-tag"
 
 static GQuark support_checked_quark;
 static GQuark supported_quark;
 static GQuark storage_context_quark;
+static GQuark messages_context_quark;
 
 /*****************************************************************************/
 
@@ -487,17 +489,139 @@ mm_iface_modem_messaging_is_storage_supported_for_receiving (MMIfaceModemMessagi
 
 /*****************************************************************************/
 
+/* While the initial SMS parts are being loaded, updates of the Messages
+ * property are deferred to an idle, so that the burst of messages found in
+ * storage ends up in a single property update. The Added signals of those
+ * messages are queued and emitted right after the property update, so that
+ * clients always find the new message in the Messages property when they
+ * get the signal. */
+
+typedef struct {
+    gchar    *path;
+    gboolean  received;
+} PendingAdded;
+
+static void
+pending_added_free (PendingAdded *pending)
+{
+    g_free (pending->path);
+    g_slice_free (PendingAdded, pending);
+}
+
+typedef struct {
+    MmGdbusModemMessaging *skeleton;
+    MMSmsList             *list;
+    guint                  update_id;
+    gboolean               loading_initial;
+    GQueue                 pending_added;
+} MessagesContext;
+
+static void
+messages_context_free (MessagesContext *ctx)
+{
+    if (ctx->update_id)
+        g_source_remove (ctx->update_id);
+    g_clear_object (&ctx->list);
+    g_queue_clear_full (&ctx->pending_added, (GDestroyNotify)pending_added_free);
+    g_slice_free (MessagesContext, ctx);
+}
+
+static MessagesContext *
+get_messages_context (MmGdbusModemMessaging *skeleton)
+{
+    MessagesContext *ctx;
+
+    if (G_UNLIKELY (!messages_context_quark))
+        messages_context_quark = (g_quark_from_static_string (
+                                      MESSAGES_CONTEXT_TAG));
+
+    ctx = g_object_get_qdata (G_OBJECT (skeleton), messages_context_quark);
+    if (!ctx) {
+        /* Create context and keep it as object data */
+        ctx = g_slice_new0 (MessagesContext);
+        ctx->skeleton = skeleton;
+
+        g_object_set_qdata_full (
+            G_OBJECT (skeleton),
+            messages_context_quark,
+            ctx,
+            (GDestroyNotify)messages_context_free);
+    }
+
+    return ctx;
+}
+
 static void
 update_message_list (MmGdbusModemMessaging *skeleton,
                      MMSmsList *list)
 {
+    MessagesContext *ctx;
+    PendingAdded *pending;
     gchar **paths;
 
+    /* Any pending deferred update is no longer needed */
+    ctx = get_messages_context (skeleton);
+    if (ctx->update_id) {
+        g_source_remove (ctx->update_id);
+        ctx->update_id = 0;
+    }
+    g_clear_object (&ctx->list);
+
     paths = mm_sms_list_get_paths (list);
     mm_gdbus_modem_messaging_set_messages (skeleton, (const gchar *const *)paths);
     g_strfreev (paths);
 
     g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (skeleton));
+
+    /* Announce the messages added since the last update */
+    while ((pending = g_queue_pop_head (&ctx->pending_added)) != NULL) {
+        mm_gdbus_modem_messaging_emit_added (skeleton, pending->path, pending->received);
+        pending_added_free (pending);
+    }
+}
+
+static gboolean
+deferred_update_message_list_cb (MessagesContext *ctx)
+{
+    g_autoptr(MMSmsList) list = NULL;
+
+    ctx->update_id = 0;
+    list = g_steal_pointer (&ctx->list);
+    update_message_list (ctx->skeleton, list);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+deferred_update_message_list (MmGdbusModemMessaging *skeleton,
+                              MMSmsList *list)
+{
+    MessagesContext *ctx;
+
+    ctx = get_messages_context (skeleton);
+    if (ctx->list != list) {
+        g_clear_object (&ctx->list);
+        ctx->list = g_object_ref (list);
+    }
+    if (!ctx->update_id)
+        ctx->update_id = g_idle_add ((GSourceFunc)deferred_update_message_list_cb, ctx);
+}
+
+static void
+set_loading_initial (MmGdbusModemMessaging *skeleton,
+                     gboolean loading_initial)
+{
+    MessagesContext *ctx;
+
+    ctx = get_messages_context (skeleton);
+    ctx->loading_initial = loading_initial;
+
+    /* Flush right away once all initial messages are loaded */
+    if (!loading_initial && ctx->update_id) {
+        g_autoptr(MMSmsList) list = NULL;
+
+        list = g_object_ref (ctx->list);
+        update_message_list (skeleton, list);
+    }
 }
 
 static void
@@ -506,8 +630,20 @@ sms_added (MMSmsList             *list,
            gboolean               received,
            MmGdbusModemMessaging *skeleton)
 {
-    update_message_list (skeleton, list);
-    mm_gdbus_modem_messaging_emit_added (skeleton, sms_path, received);
+    MessagesContext *ctx;
+    PendingAdded *pending;
+
+    ctx = get_messages_context (skeleton);
+
+    pending = g_slice_new (PendingAdded);
+    pending->path = g_strdup (sms_path);
+    pending->received = received;
+    g_queue_push_tail (&ctx->pending_added, pending);
+
+    if (ctx->loading_initial)
+        deferred_update_message_list (skeleton, list);
+    else
+        update_message_list (skeleton, list);
 }
 
 static void
@@ -814,6 +950,8 @@ load_initial_sms_parts_from_storages (GTask *task)
     }
 
     if (all_loaded) {
+        set_loading_initial (ctx->skeleton, FALSE);
+
         /* Go on with next step */
         ctx->step++;
         interface_enabling_step (task);
@@ -1001,6 +1139,7 @@ interface_enabling_step (GTask *task)
         /* Allow loading the initial list of SMS parts */
         if (MM_IFACE_MODEM_MESSAGING_GET_INTERFACE (self)->load_initial_sms_parts &&
             MM_IFACE_MODEM_MESSAGING_GET_INTERFACE (self)->load_initial_sms_parts_finish) {
+            set_loading_initial (ctx->skeleton, TRUE);
             load_initial_sms_parts_from_storages (task);
             return;
         }
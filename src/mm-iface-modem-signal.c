@@ -40,6 +40,7 @@ mm_iface_modem_signal_bind_simple_status (MMIfaceModemSignal *self,
 /*****************************************************************************/
 
 typedef struct {
+    MMPollScheduler *scheduler;
     guint rate;
     guint timeout_source;
 } RefreshContext;
@@ -48,7 +49,8 @@ static void
 refresh_context_free (RefreshContext *ctx)
 {
     if (ctx->timeout_source)
-        g_source_remove (ctx->timeout_source);
+        mm_poll_scheduler_remove (ctx->scheduler, ctx->timeout_source);
+    mm_poll_scheduler_unref (ctx->scheduler);
     g_slice_free (RefreshContext, ctx);
 }
 
@@ -113,6 +115,9 @@ load_values_ready (MMIfaceModemSignal *self,
         return;
     }
 
+    /* All values are emitted together with any other status change */
+    mm_base_modem_batch_properties (MM_BASE_MODEM (self));
+
     if (cdma)
         dict_cdma = mm_signal_get_dictionary (cdma);
     mm_gdbus_modem_signal_set_cdma (MM_GDBUS_MODEM_SIGNAL (skeleton), dict_cdma);
@@ -136,9 +141,6 @@ load_values_ready (MMIfaceModemSignal *self,
     if (nr5g)
         dict_nr5g = mm_signal_get_dictionary (nr5g);
     mm_gdbus_modem_signal_set_nr5g (MM_GDBUS_MODEM_SIGNAL (skeleton), dict_nr5g);
-
-    /* Flush right away */
-    g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (skeleton));
 }
 
 static gboolean
@@ -212,6 +214,7 @@ setup_refresh_context (MMIfaceModemSignal *self,
     ctx = g_object_get_qdata (G_OBJECT (self), refresh_context_quark);
     if (!ctx) {
         ctx = g_slice_new0 (RefreshContext);
+        ctx->scheduler = mm_poll_scheduler_ref (mm_base_modem_peek_poll_scheduler (MM_BASE_MODEM (self)));
         g_object_set_qdata_full (G_OBJECT (self),
                                  refresh_context_quark,
                                  ctx,
@@ -228,8 +231,12 @@ setup_refresh_context (MMIfaceModemSignal *self,
     mm_obj_dbg (self, "extended signal information reporting enabled (rate: %u seconds)", new_rate);
     ctx->rate = new_rate;
     if (ctx->timeout_source)
-        g_source_remove (ctx->timeout_source);
-    ctx->timeout_source = g_timeout_add_seconds (ctx->rate, (GSourceFunc) refresh_context_cb, self);
+        mm_poll_scheduler_remove (ctx->scheduler, ctx->timeout_source);
+    ctx->timeout_source = mm_poll_scheduler_add_seconds (ctx->scheduler,
+                                                         "extended signal",
+                                                         ctx->rate,
+                                                         (GSourceFunc) refresh_context_cb,
+                                                         self);
 
     /* Also launch right away */
     refresh_context_cb (self);
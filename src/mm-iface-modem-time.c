@@ -19,15 +19,19 @@
 
 #include "mm-iface-modem.h"
 #include "mm-iface-modem-time.h"
+#include "mm-base-modem.h"
 #include "mm-log-object.h"
+#include "mm-network-timezone-fallback.h"
 
-#define SUPPORT_CHECKED_TAG          "time-support-checked-tag"
-#define SUPPORTED_TAG                "time-supported-tag"
-#define NETWORK_TIMEZONE_CONTEXT_TAG "time-network-timezone-context"
+#define SUPPORT_CHECKED_TAG           "time-support-checked-tag"
+#define SUPPORTED_TAG                 "time-supported-tag"
+#define NETWORK_TIMEZONE_CONTEXT_TAG  "time-network-timezone-context"
+#define NETWORK_TIMEZONE_FALLBACK_TAG "time-network-timezone-fallback"
 
 static GQuark support_checked_quark;
 static GQuark supported_quark;
 static GQuark network_timezone_context_quark;
+static GQuark network_timezone_fallback_quark;
 
 /*****************************************************************************/
 
@@ -140,20 +144,9 @@ handle_get_network_time (MmGdbusModemTime      *skeleton,
 /*****************************************************************************/
 /* Network timezone loading */
 
-/*
- * As soon as we're registered in a network, we try to check timezone
- * information up to NETWORK_TIMEZONE_POLL_RETRIES times. As soon as one of
- * the retries succeeds, we stop polling as we don't expect the timezone
- * information to change while registered in the same network.
- */
-#define NETWORK_TIMEZONE_POLL_INTERVAL_SEC 5
-#define NETWORK_TIMEZONE_POLL_RETRIES 6
-
 typedef struct {
     gulong state_changed_id;
     MMModemState state;
-    guint network_timezone_poll_id;
-    guint network_timezone_poll_retries;
 } NetworkTimezoneContext;
 
 static void
@@ -162,12 +155,54 @@ network_timezone_context_free (NetworkTimezoneContext *ctx)
     /* Note: no need to remove signal connection here, we have already done it
      * in stop_network_timezone() when the logic is disabled (or will be done
      * automatically when the last modem object reference is dropped) */
-    if (ctx->network_timezone_poll_id)
-        g_source_remove (ctx->network_timezone_poll_id);
     g_free (ctx);
 }
 
-static gboolean network_timezone_poll_cb (MMIfaceModemTime *self);
+static NetworkTimezoneContext *
+peek_network_timezone_context (MMIfaceModemTime *self)
+{
+    if (!network_timezone_context_quark)
+        return NULL;
+    return (NetworkTimezoneContext *) g_object_get_qdata (G_OBJECT (self), network_timezone_context_quark);
+}
+
+static void network_timezone_query (MMIfaceModemTime *self);
+
+/* Kept for the whole lifetime of the modem, so that the stats are kept
+ * across enable and disable */
+static MMNetworkTimezoneFallback *
+get_network_timezone_fallback (MMIfaceModemTime *self)
+{
+    MMNetworkTimezoneFallback *fallback;
+
+    if (G_UNLIKELY (!network_timezone_fallback_quark))
+        network_timezone_fallback_quark = g_quark_from_static_string (NETWORK_TIMEZONE_FALLBACK_TAG);
+
+    fallback = g_object_get_qdata (G_OBJECT (self), network_timezone_fallback_quark);
+    if (!fallback) {
+        fallback = mm_network_timezone_fallback_new (mm_base_modem_peek_poll_scheduler (MM_BASE_MODEM (self)),
+                                                     self,
+                                                     (MMNetworkTimezoneFallbackQueryFn)network_timezone_query,
+                                                     self);
+        g_object_set_qdata_full (G_OBJECT (self),
+                                 network_timezone_fallback_quark,
+                                 fallback,
+                                 (GDestroyNotify)mm_network_timezone_fallback_free);
+    }
+    return fallback;
+}
+
+void
+mm_iface_modem_time_add_metrics (MMIfaceModemTime *self,
+                                 GVariantDict     *dict)
+{
+    MMNetworkTimezoneFallback *fallback;
+
+    fallback = get_network_timezone_fallback (self);
+    g_variant_dict_insert (dict, "network-timezone-reported",        "u", mm_network_timezone_fallback_get_n_reported (fallback));
+    g_variant_dict_insert (dict, "network-timezone-queries",         "u", mm_network_timezone_fallback_get_n_queries (fallback));
+    g_variant_dict_insert (dict, "network-timezone-queries-avoided", "u", mm_network_timezone_fallback_get_n_queries_avoided (fallback));
+}
 
 static void
 update_network_timezone_dictionary (MMIfaceModemTime *self,
@@ -200,77 +235,31 @@ load_network_timezone_ready (MMIfaceModemTime *self,
     /* Finish the async operation */
     tz = MM_IFACE_MODEM_TIME_GET_INTERFACE (self)->load_network_timezone_finish (self, res, &error);
     if (!tz) {
-        NetworkTimezoneContext *ctx;
-
-        mm_obj_dbg (self, "couldn't load network timezone: %s", error->message);
-
-        /* Note: may be NULL if the polling has been removed while processing the async operation */
-        ctx = (NetworkTimezoneContext *) g_object_get_qdata (G_OBJECT (self), network_timezone_context_quark);
-        if (!ctx)
-            return;
-
-        /* Retry? */
-        ctx->network_timezone_poll_retries--;
-
-        /* If no more retries, we don't do anything else */
-        if (ctx->network_timezone_poll_retries == 0 ||
-            !g_error_matches (error, MM_CORE_ERROR, MM_CORE_ERROR_RETRY)) {
-            mm_obj_warn (self, "couldn't load network timezone from the current network");
-            return;
-        }
-
-        /* Otherwise, relaunch timeout to query a bit later */
-        ctx->network_timezone_poll_id = g_timeout_add_seconds (NETWORK_TIMEZONE_POLL_INTERVAL_SEC,
-                                                               (GSourceFunc)network_timezone_poll_cb,
-                                                               self);
+        /* Not retried, we'll rely on the network reporting it later */
+        if (g_error_matches (error, MM_CORE_ERROR, MM_CORE_ERROR_RETRY))
+            mm_obj_dbg (self, "network timezone not available yet");
+        else
+            mm_obj_warn (self, "couldn't load network timezone from the current network: %s", error->message);
         return;
     }
 
     /* Got final result properly, update the property in the skeleton */
     update_network_timezone_dictionary (self, tz);
     g_object_unref (tz);
+
+    /* A known timezone avoids further queries on re-registration, unless
+     * the logic was disabled in the meantime */
+    if (peek_network_timezone_context (self))
+        mm_network_timezone_fallback_queried (get_network_timezone_fallback (self), g_get_monotonic_time ());
 }
 
-static gboolean
-network_timezone_poll_cb (MMIfaceModemTime *self)
+static void
+network_timezone_query (MMIfaceModemTime *self)
 {
-    NetworkTimezoneContext *ctx;
-
-    ctx = (NetworkTimezoneContext *) g_object_get_qdata (G_OBJECT (self), network_timezone_context_quark);
-    ctx->network_timezone_poll_id = 0;
-
     MM_IFACE_MODEM_TIME_GET_INTERFACE (self)->load_network_timezone (
         self,
         (GAsyncReadyCallback)load_network_timezone_ready,
         NULL);
-
-    return G_SOURCE_REMOVE;
-}
-
-static void
-start_network_timezone_poll (MMIfaceModemTime *self)
-{
-    NetworkTimezoneContext *ctx;
-
-    ctx = (NetworkTimezoneContext *) g_object_get_qdata (G_OBJECT (self), network_timezone_context_quark);
-
-    mm_obj_dbg (self, "network timezone polling started");
-    ctx->network_timezone_poll_retries = NETWORK_TIMEZONE_POLL_RETRIES;
-    ctx->network_timezone_poll_id = g_timeout_add_seconds (NETWORK_TIMEZONE_POLL_INTERVAL_SEC, (GSourceFunc)network_timezone_poll_cb, self);
-}
-
-static void
-stop_network_timezone_poll (MMIfaceModemTime *self)
-{
-    NetworkTimezoneContext *ctx;
-
-    ctx = (NetworkTimezoneContext *) g_object_get_qdata (G_OBJECT (self), network_timezone_context_quark);
-
-    if (ctx->network_timezone_poll_id) {
-        mm_obj_dbg (self, "network timezone polling stopped");
-        g_source_remove (ctx->network_timezone_poll_id);
-        ctx->network_timezone_poll_id = 0;
-    }
 }
 
 static void
@@ -279,20 +268,20 @@ network_timezone_state_changed (MMIfaceModemTime *self)
     NetworkTimezoneContext *ctx;
     MMModemState old_state;
 
-    ctx = (NetworkTimezoneContext *) g_object_get_qdata (G_OBJECT (self), network_timezone_context_quark);
+    ctx = peek_network_timezone_context (self);
     old_state = ctx->state;
 
     g_object_get (self, MM_IFACE_MODEM_STATE, &ctx->state, NULL);
 
-    /* If going from unregistered to registered, start polling */
+    /* If going from unregistered to registered, schedule the fallback query */
     if (ctx->state >= MM_MODEM_STATE_REGISTERED && old_state < MM_MODEM_STATE_REGISTERED) {
-        start_network_timezone_poll (self);
+        mm_network_timezone_fallback_registered (get_network_timezone_fallback (self), g_get_monotonic_time ());
         return;
     }
 
-    /* If going from registered to unregistered, stop polling */
+    /* If going from registered to unregistered, cancel it */
     if (ctx->state < MM_MODEM_STATE_REGISTERED && old_state >= MM_MODEM_STATE_REGISTERED) {
-        stop_network_timezone_poll (self);
+        mm_network_timezone_fallback_unregistered (get_network_timezone_fallback (self));
         return;
     }
 }
@@ -302,8 +291,17 @@ stop_network_timezone (MMIfaceModemTime *self)
 {
     NetworkTimezoneContext *ctx;
 
-    ctx = (NetworkTimezoneContext *) g_object_get_qdata (G_OBJECT (self), network_timezone_context_quark);
+    ctx = peek_network_timezone_context (self);
     if (ctx) {
+        MMNetworkTimezoneFallback *fallback;
+
+        fallback = get_network_timezone_fallback (self);
+        mm_obj_dbg (self, "network timezone: %u updates reported by the network, %u queries run, %u queries avoided",
+                    mm_network_timezone_fallback_get_n_reported (fallback),
+                    mm_network_timezone_fallback_get_n_queries (fallback),
+                    mm_network_timezone_fallback_get_n_queries_avoided (fallback));
+        mm_network_timezone_fallback_reset (fallback);
+
         /* Remove signal connection and then trigger context free */
         if (ctx->state_changed_id) {
             g_signal_handler_disconnect (self, ctx->state_changed_id);
@@ -337,8 +335,8 @@ start_network_timezone (MMIfaceModemTime *self)
                              ctx,
                              (GDestroyNotify)network_timezone_context_free);
 
-    /* Want to get notified when modem state changes to enable/disable
-     * the polling logic. This signal is connected as long as the network timezone
+    /* Want to get notified when modem state changes to schedule/cancel
+     * the fallback query. This signal is connected as long as the network timezone
      * logic is enabled. */
     g_object_get (self, MM_IFACE_MODEM_STATE, &ctx->state, NULL);
     ctx->state_changed_id = g_signal_connect (self,
@@ -346,9 +344,9 @@ start_network_timezone (MMIfaceModemTime *self)
                                               G_CALLBACK (network_timezone_state_changed),
                                               NULL);
 
-    /* If we're registered already, start timezone poll */
+    /* If we're registered already, schedule the fallback query */
     if (ctx->state >= MM_MODEM_STATE_REGISTERED)
-        start_network_timezone_poll (self);
+        mm_network_timezone_fallback_registered (get_network_timezone_fallback (self), g_get_monotonic_time ());
 }
 
 /*****************************************************************************/
@@ -390,6 +388,12 @@ mm_iface_modem_time_update_network_timezone (MMIfaceModemTime  *self,
         g_variant_unref (dictionary);
 
     g_object_unref (skeleton);
+
+    /* Only accounted while the logic is enabled */
+    if (peek_network_timezone_context (self))
+        mm_network_timezone_fallback_reported (get_network_timezone_fallback (self), g_get_monotonic_time ());
+}
+    }
 }
 
 /*****************************************************************************/
@@ -50,9 +50,9 @@ struct _MMIfaceModemTime {
                                           GAsyncResult *res,
                                           GError **error);
 
-    /* Loading of the network timezone property. This method may return
-     * MM_CORE_ERROR_RETRY if the timezone cannot yet be loaded, so that
-     * the interface retries later. */
+    /* Loading of the network timezone property, only used as fallback when
+     * the network doesn't report it after registration. This method may
+     * return MM_CORE_ERROR_RETRY if the timezone cannot yet be loaded. */
     void (* load_network_timezone) (MMIfaceModemTime *self,
                                     GAsyncReadyCallback callback,
                                     gpointer user_data);
@@ -142,10 +142,16 @@ void mm_iface_modem_time_bind_simple_status (MMIfaceModemTime *self,
                                              MMSimpleStatus *status);
 
 /* Implementations of the unsolicited events handling should call this method
- * to notify about the updated time */
+ * to notify about the updated time. Reporting the timezone this way avoids
+ * the fallback query after registration. */
 void mm_iface_modem_time_update_network_time     (MMIfaceModemTime  *self,
                                                   const gchar       *network_time);
 void mm_iface_modem_time_update_network_timezone (MMIfaceModemTime  *self,
                                                   MMNetworkTimezone *tz);
 
+/* Adds the network timezone counters (updates reported by the network,
+ * fallback queries run and avoided) to a metrics dictionary */
+void mm_iface_modem_time_add_metrics (MMIfaceModemTime *self,
+                                      GVariantDict     *dict);
+
 #endif /* MM_IFACE_MODEM_TIME_H */
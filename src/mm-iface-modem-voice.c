@@ -29,6 +29,8 @@
 static GQuark call_list_polling_context_quark;
 static GQuark in_call_event_context_quark;
 
+static void call_list_polling_report_urc_update (MMIfaceModemVoice *self);
+
 /*****************************************************************************/
 
 void
@@ -345,16 +347,25 @@ mm_iface_modem_voice_report_call (MMIfaceModemVoice *self,
     mm_call_list_foreach (list, (MMCallListForeachFunc)report_call_foreach, &ctx);
 
     /* If call info matched with an existing one, the context call info would have been reseted */
-    if (!ctx.call_info)
+    if (!ctx.call_info) {
+        /* Only indexed reports are call state update URCs (e.g. ^ORIG, ^CONN,
+         * ^CEND); the generic ones (RING, +CRING, +CLIP, NO CARRIER...) are
+         * reported by every modem, even those that don't report outgoing
+         * call progress at all. */
+        if (call_info->index)
+            call_list_polling_report_urc_update (self);
         goto out;
+    }
 
     /* If call info didn't match with any known call, it may be because we're being
-     * reported a NEW incoming call. If that's not the case, we'll ignore the report. */
+     * reported a NEW incoming call. If that's not the case, we'll ignore the report,
+     * and check the call list to find out what it was about. */
     if ((call_info->direction != MM_CALL_DIRECTION_INCOMING) ||
         ((call_info->state != MM_CALL_STATE_WAITING) && (call_info->state != MM_CALL_STATE_RINGING_IN))) {
         mm_obj_dbg (self, "unhandled call state update reported: direction: %s, state %s",
                     mm_call_direction_get_string (call_info->direction),
                     mm_call_state_get_string (call_info->state));
+        mm_iface_modem_voice_check_call_list (self);
         goto out;
     }
 
@@ -434,9 +445,9 @@ report_all_calls_foreach (MMBaseCall                   *call,
     mm_base_call_change_state (call, MM_CALL_STATE_TERMINATED, MM_CALL_STATE_REASON_UNKNOWN);
 }
 
-void
-mm_iface_modem_voice_report_all_calls (MMIfaceModemVoice *self,
-                                       GList             *call_info_list)
+static void
+report_all_calls (MMIfaceModemVoice *self,
+                  GList             *call_info_list)
 {
     ReportAllCallsForeachContext  ctx = { 0 };
     MMCallList                   *list = NULL;
@@ -528,6 +539,17 @@ mm_iface_modem_voice_report_all_calls (MMIfaceModemVoice *self,
     g_object_unref (list);
 }
 
+void
+mm_iface_modem_voice_report_all_calls (MMIfaceModemVoice *self,
+                                       GList             *call_info_list)
+{
+    report_all_calls (self, call_info_list);
+
+    /* Full call list reports from outside of the polling logic come from
+     * call state update URCs (e.g. ^SLCC, +CLCC) or indications */
+    call_list_polling_report_urc_update (self);
+}
+
 /*****************************************************************************/
 /* Incoming DTMF reception, not associated to a specific call */
 
@@ -2355,20 +2377,46 @@ setup_in_call_event_handling (MMCallList        *call_list,
  * Any time we add a new call to the list, we'll setup polling if it's not
  * already running, and the polling logic itself will decide when the polling
  * should stop.
+ *
+ * Once the modem has shown that it reports call state updates with URCs
+ * (i.e. an indexed URC updated a known call, or a full call list was
+ * reported), the periodic polling is no longer needed: the call list is only
+ * checked if no URC is received in a long time while a call is being
+ * established, or when explicitly requested because the URCs received were
+ * ambiguous (e.g. an update for an unknown call, or a call indicator change
+ * without call details). The generic RING/+CRING/+CLIP reports don't count,
+ * and whatever was learnt is forgotten when a new call is added while there
+ * are no other ongoing calls, as the new call may be of a type (e.g.
+ * outgoing) that the modem doesn't report with URCs.
  */
 
-#define CALL_LIST_POLLING_TIMEOUT_SECS 2
+#define CALL_LIST_POLLING_TIMEOUT_SECS     2
+#define CALL_LIST_POLLING_URC_TIMEOUT_SECS 30
 
 typedef struct {
+    MMPollScheduler *scheduler;
     guint    polling_id;
+    guint    check_id;
     gboolean polling_ongoing;
+    /* Whether the call list can be loaded and checked at all */
+    gboolean enabled;
+    /* Whether the modem reports call state updates with URCs */
+    gboolean urc_updates;
+    /* Whether an explicit check was requested */
+    gboolean check_requested;
+    /* Counters */
+    guint    n_polls;
+    guint    n_polls_avoided;
 } CallListPollingContext;
 
 static void
 call_list_polling_context_free (CallListPollingContext *ctx)
 {
     if (ctx->polling_id)
-        g_source_remove (ctx->polling_id);
+        mm_poll_scheduler_remove (ctx->scheduler, ctx->polling_id);
+    if (ctx->check_id)
+        g_source_remove (ctx->check_id);
+    mm_poll_scheduler_unref (ctx->scheduler);
     g_slice_free (CallListPollingContext, ctx);
 }
 
@@ -2385,6 +2433,7 @@ get_call_list_polling_context (MMIfaceModemVoice *self)
     if (!ctx) {
         /* Create context and keep it as object data */
         ctx = g_slice_new0 (CallListPollingContext);
+        ctx->scheduler = mm_poll_scheduler_ref (mm_base_modem_peek_poll_scheduler (MM_BASE_MODEM (self)));
 
         g_object_set_qdata_full (
             G_OBJECT (self),
@@ -2398,6 +2447,68 @@ get_call_list_polling_context (MMIfaceModemVoice *self)
 
 static gboolean call_list_poll (MMIfaceModemVoice *self);
 
+static void
+call_list_polling_schedule (MMIfaceModemVoice      *self,
+                            CallListPollingContext *ctx)
+{
+    if (ctx->polling_id)
+        mm_poll_scheduler_remove (ctx->scheduler, ctx->polling_id);
+    ctx->polling_id = mm_poll_scheduler_add_seconds (ctx->scheduler,
+                                                     "call list",
+                                                     ctx->urc_updates ?
+                                                     CALL_LIST_POLLING_URC_TIMEOUT_SECS :
+                                                     CALL_LIST_POLLING_TIMEOUT_SECS,
+                                                     (GSourceFunc) call_list_poll,
+                                                     self);
+}
+
+static gboolean
+call_list_check_cb (MMIfaceModemVoice *self)
+{
+    CallListPollingContext *ctx;
+
+    ctx = get_call_list_polling_context (self);
+    ctx->check_id = 0;
+
+    /* The scheduled poll is replaced by this one */
+    if (ctx->polling_id) {
+        mm_poll_scheduler_remove (ctx->scheduler, ctx->polling_id);
+        ctx->polling_id = 0;
+    }
+    return call_list_poll (self);
+}
+
+static void
+call_list_check_now (MMIfaceModemVoice      *self,
+                     CallListPollingContext *ctx)
+{
+    if (!ctx->check_id)
+        ctx->check_id = g_idle_add ((GSourceFunc) call_list_check_cb, self);
+}
+
+static void
+call_list_polling_report_urc_update (MMIfaceModemVoice *self)
+{
+    CallListPollingContext *ctx;
+
+    ctx = get_call_list_polling_context (self);
+    if (!ctx->enabled)
+        return;
+
+    if (!ctx->urc_updates) {
+        mm_obj_dbg (self, "call state updates reported via URCs: periodic call list polling no longer required");
+        ctx->urc_updates = TRUE;
+    }
+
+    /* The URC makes the scheduled check unnecessary; just make sure we don't
+     * end up without updates for too long if the call is still being
+     * established. */
+    if (ctx->polling_id && !ctx->check_requested) {
+        ctx->n_polls_avoided++;
+        call_list_polling_schedule (self, ctx);
+    }
+}
+
 static void
 load_call_list_ready (MMIfaceModemVoice *self,
                       GAsyncResult      *res)
@@ -2415,17 +2526,22 @@ load_call_list_ready (MMIfaceModemVoice *self,
         g_error_free (error);
     } else {
         /* Always report the list even if NULL (it would mean no ongoing calls) */
-        mm_iface_modem_voice_report_all_calls (self, call_info_list);
+        report_all_calls (self, call_info_list);
         mm_3gpp_call_info_list_free (call_info_list);
     }
 
+    /* if a new check was requested while we were loading the list, run it
+     * right away, as the list we got may be outdated already */
+    if (ctx->check_requested) {
+        call_list_check_now (self, ctx);
+        return;
+    }
+
     /* setup the polling again, but only if it hasn't been done already while
      * we reported calls (e.g. a new incoming call may have been detected that
      * also triggers the poll setup) */
-    if (!ctx->polling_id)
-        ctx->polling_id = g_timeout_add_seconds (CALL_LIST_POLLING_TIMEOUT_SECS,
-                                                 (GSourceFunc) call_list_poll,
-                                                 self);
+    if (!ctx->polling_id && !ctx->check_id)
+        call_list_polling_schedule (self, ctx);
 }
 
 static void
@@ -2471,35 +2587,80 @@ call_list_poll (MMIfaceModemVoice *self)
 
     mm_call_list_foreach (list, (MMCallListForeachFunc) call_list_foreach_count_establishing, &n_calls_establishing);
 
-    /* If there is at least ONE call being established, we need the call list */
-    if (n_calls_establishing > 0) {
-        mm_obj_dbg (self, "%u calls being established: call list polling required", n_calls_establishing);
+    /* If there is at least ONE call being established, or if explicitly
+     * requested, we need the call list */
+    if (n_calls_establishing > 0 || ctx->check_requested) {
+        if (ctx->check_requested)
+            mm_obj_dbg (self, "call list check requested");
+        else
+            mm_obj_dbg (self, "%u calls being established: call list polling required", n_calls_establishing);
+        ctx->check_requested = FALSE;
         ctx->polling_ongoing = TRUE;
+        ctx->n_polls++;
         g_assert (MM_IFACE_MODEM_VOICE_GET_INTERFACE (self)->load_call_list);
         MM_IFACE_MODEM_VOICE_GET_INTERFACE (self)->load_call_list (self,
                                                                    (GAsyncReadyCallback)load_call_list_ready,
                                                                    NULL);
     } else
-        mm_obj_dbg (self, "no calls being established: call list polling stopped");
+        mm_obj_dbg (self, "no calls being established: call list polling stopped "
+                    "(%u polls run, %u polls avoided by URCs)",
+                    ctx->n_polls, ctx->n_polls_avoided);
 
 out:
     g_clear_object (&list);
     return G_SOURCE_REMOVE;
 }
 
+static void
+call_list_foreach_count_ongoing (MMBaseCall *call,
+                                 gpointer    user_data)
+{
+    guint *n_calls_ongoing = (guint *)user_data;
+
+    if (mm_base_call_get_state (call) != MM_CALL_STATE_TERMINATED)
+        *n_calls_ongoing = *n_calls_ongoing + 1;
+}
+
 static void
 setup_call_list_polling (MMCallList        *call_list,
                          const gchar       *call_path_added,
                          MMIfaceModemVoice *self)
 {
     CallListPollingContext *ctx;
+    guint                   n_calls_ongoing = 0;
 
     ctx = get_call_list_polling_context (self);
 
-    if (!ctx->polling_id && !ctx->polling_ongoing)
-        ctx->polling_id = g_timeout_add_seconds (CALL_LIST_POLLING_TIMEOUT_SECS,
-                                                 (GSourceFunc) call_list_poll,
-                                                 self);
+    /* The added call is the only ongoing one: start over */
+    mm_call_list_foreach (call_list, (MMCallListForeachFunc) call_list_foreach_count_ongoing, &n_calls_ongoing);
+    if (ctx->urc_updates && n_calls_ongoing <= 1) {
+        mm_obj_dbg (self, "no other ongoing calls: call list polling required until call state URCs are seen");
+        ctx->urc_updates = FALSE;
+        if (ctx->polling_id)
+            call_list_polling_schedule (self, ctx);
+    }
+
+    if (!ctx->polling_id && !ctx->check_id && !ctx->polling_ongoing)
+        call_list_polling_schedule (self, ctx);
+}
+
+void
+mm_iface_modem_voice_check_call_list (MMIfaceModemVoice *self)
+{
+    CallListPollingContext *ctx;
+
+    ctx = get_call_list_polling_context (self);
+    if (!ctx->enabled || ctx->check_requested)
+        return;
+
+    /* A single check is run, even if requested multiple times before it
+     * starts; if a check is already ongoing, a new one will be run right
+     * after it. */
+    ctx->check_requested = TRUE;
+    if (ctx->polling_ongoing)
+        return;
+
+    call_list_check_now (self, ctx);
 }
 
 /*****************************************************************************/
@@ -2985,6 +3146,7 @@ interface_initialization_step (GTask *task)
             g_object_get (self,
                           MM_IFACE_MODEM_VOICE_PERIODIC_CALL_LIST_CHECK_DISABLED, &periodic_call_list_check_disabled,
                           NULL);
+            get_call_list_polling_context (self)->enabled = !periodic_call_list_check_disabled;
             if (!periodic_call_list_check_disabled) {
                 mm_obj_dbg (self, "periodic call list polling will be used if supported");
                 g_signal_connect (list,
@@ -239,6 +239,10 @@ void mm_iface_modem_voice_report_call (MMIfaceModemVoice *self,
 void mm_iface_modem_voice_report_all_calls (MMIfaceModemVoice *self,
                                             GList             *call_info_list);
 
+/* Request a single check of the call list, e.g. when the call state
+ * updates received are ambiguous */
+void mm_iface_modem_voice_check_call_list (MMIfaceModemVoice *self);
+
 /* Report an incoming DTMF received */
 void mm_iface_modem_voice_received_dtmf (MMIfaceModemVoice *self,
                                          guint              index,
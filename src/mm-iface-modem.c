@@ -27,7 +27,10 @@
 #include "mm-bearer-list.h"
 #include "mm-private-boxed-types.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 #include "mm-context.h"
+#include "mm-step-scheduler.h"
+#include "mm-capability-cache.h"
 #if defined WITH_QMI
 # include "mm-broadband-modem-qmi.h"
 #endif
@@ -41,15 +44,33 @@
 #define SIGNAL_CHECK_INITIAL_TIMEOUT_SEC  3
 #define SIGNAL_CHECK_TIMEOUT_SEC          30
 
+#define CAPABILITY_CACHE_REFRESH_DELAY_SECS 30
+
 #define STATE_UPDATE_CONTEXT_TAG          "state-update-context-tag"
 #define SIGNAL_QUALITY_UPDATE_CONTEXT_TAG "signal-quality-update-context-tag"
 #define SIGNAL_CHECK_CONTEXT_TAG          "signal-check-context-tag"
 #define RESTART_INITIALIZE_IDLE_TAG       "restart-initialize-tag"
+#define CAPABILITY_CACHE_CONTEXT_TAG      "capability-cache-context-tag"
 
 static GQuark state_update_context_quark;
 static GQuark signal_quality_update_context_quark;
 static GQuark signal_check_context_quark;
 static GQuark restart_initialize_idle_quark;
+static GQuark capability_cache_context_quark;
+
+/*****************************************************************************/
+
+void
+mm_iface_modem_invalidate_sim_cache (MMIfaceModem *self)
+{
+    g_autoptr(MMBaseSim) sim = NULL;
+
+    g_object_get (self,
+                  MM_IFACE_MODEM_SIM, &sim,
+                  NULL);
+    if (sim)
+        mm_base_sim_invalidate_cache (sim);
+}
 
 /*****************************************************************************/
 
@@ -596,7 +617,7 @@ bearer_list_updated (MMBearerList *bearer_list,
     mm_gdbus_modem_set_bearers (skeleton, (const gchar *const *)paths);
     g_strfreev (paths);
 
-    g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (skeleton));
+    mm_base_modem_flush_properties (MM_BASE_MODEM (self));
     g_object_unref (skeleton);
 }
 
@@ -1233,6 +1254,10 @@ handle_set_primary_sim_slot (MmGdbusModem          *skeleton,
 
 /*****************************************************************************/
 
+static void periodic_signal_check_refreshed (MMIfaceModem *self,
+                                             gboolean      signal_quality,
+                                             gboolean      access_technologies);
+
 void
 mm_iface_modem_update_access_technologies (MMIfaceModem *self,
                                            MMModemAccessTechnology new_access_tech,
@@ -1261,6 +1286,7 @@ mm_iface_modem_update_access_technologies (MMIfaceModem *self,
         gchar *old_access_tech_string;
         gchar *new_access_tech_string;
 
+        mm_base_modem_batch_properties (MM_BASE_MODEM (self));
         mm_gdbus_modem_set_access_technologies (skeleton, built_access_tech);
 
         /* Log */
@@ -1274,6 +1300,8 @@ mm_iface_modem_update_access_technologies (MMIfaceModem *self,
     }
 
     g_object_unref (skeleton);
+
+    periodic_signal_check_refreshed (self, FALSE, TRUE);
 }
 
 /*****************************************************************************/
@@ -1366,6 +1394,7 @@ update_signal_quality (MMIfaceModem *self,
      * The only exception being if 'expire' is FALSE; in that case we assume
      * the value won't expire and therefore can be considered obsolete
      * already. */
+    mm_base_modem_batch_properties (MM_BASE_MODEM (self));
     mm_gdbus_modem_set_signal_quality (skeleton,
                                        g_variant_new ("(ub)",
                                                       signal_quality,
@@ -1394,6 +1423,7 @@ mm_iface_modem_update_signal_quality (MMIfaceModem *self,
                                       guint signal_quality)
 {
     update_signal_quality (self, signal_quality, TRUE);
+    periodic_signal_check_refreshed (self, TRUE, FALSE);
 }
 
 /*****************************************************************************/
@@ -1408,8 +1438,14 @@ typedef enum {
 } SignalCheckStep;
 
 typedef struct {
-    gboolean enabled;
-    guint    timeout_source;
+    gboolean         enabled;
+    MMPollScheduler *scheduler;
+    guint            timeout_source;
+
+    /* Values received by other means (e.g. unsolicited messages) while the
+     * next check is scheduled */
+    gboolean signal_quality_refreshed;
+    gboolean access_technologies_refreshed;
 
     /* We first attempt an initial loading, and once it's done we
      * setup polling */
@@ -1436,7 +1472,8 @@ static void
 signal_check_context_free (SignalCheckContext *ctx)
 {
     if (ctx->timeout_source)
-        g_source_remove (ctx->timeout_source);
+        mm_poll_scheduler_remove (ctx->scheduler, ctx->timeout_source);
+    mm_poll_scheduler_unref (ctx->scheduler);
     g_slice_free (SignalCheckContext, ctx);
 }
 
@@ -1454,6 +1491,7 @@ get_signal_check_context (MMIfaceModem *self)
         /* Create context and attach it to the object */
         ctx = g_slice_new0 (SignalCheckContext);
         ctx->running_step = SIGNAL_CHECK_STEP_NONE;
+        ctx->scheduler = mm_poll_scheduler_ref (mm_base_modem_peek_poll_scheduler (MM_BASE_MODEM (self)));
 
         /* Initially assume supported if load_access_technologies() is
          * implemented. If the plugin reports an UNSUPPORTED error we'll clear
@@ -1481,6 +1519,35 @@ get_signal_check_context (MMIfaceModem *self)
     return ctx;
 }
 
+static void
+periodic_signal_check_refreshed (MMIfaceModem *self,
+                                 gboolean      signal_quality,
+                                 gboolean      access_technologies)
+{
+    SignalCheckContext *ctx;
+
+    if (G_UNLIKELY (!signal_check_context_quark))
+        return;
+
+    ctx = g_object_get_qdata (G_OBJECT (self), signal_check_context_quark);
+    if (!ctx || !ctx->timeout_source || !ctx->initial_check_done)
+        return;
+
+    ctx->signal_quality_refreshed      |= signal_quality;
+    ctx->access_technologies_refreshed |= access_technologies;
+
+    /* Once all the polled values have been received, the next check is
+     * useless; restart its period instead */
+    if ((ctx->signal_quality_refreshed ||
+         !ctx->signal_quality_polling_supported || ctx->signal_quality_polling_disabled) &&
+        (ctx->access_technologies_refreshed ||
+         !ctx->access_technology_polling_supported || ctx->access_technology_polling_disabled)) {
+        mm_poll_scheduler_defer (ctx->scheduler, ctx->timeout_source);
+        ctx->signal_quality_refreshed      = FALSE;
+        ctx->access_technologies_refreshed = FALSE;
+    }
+}
+
 static void     periodic_signal_check_disable (MMIfaceModem *self,
                                                gboolean      clear);
 static gboolean periodic_signal_check_cb      (MMIfaceModem *self);
@@ -1630,9 +1697,13 @@ periodic_signal_check_step (MMIfaceModem *self)
 
         mm_obj_dbg (self, "periodic signal quality and access technology checks scheduled");
         g_assert (!ctx->timeout_source);
-        ctx->timeout_source = g_timeout_add_seconds (ctx->initial_check_done ? SIGNAL_CHECK_TIMEOUT_SEC : SIGNAL_CHECK_INITIAL_TIMEOUT_SEC,
-                                                     (GSourceFunc) periodic_signal_check_cb,
-                                                     self);
+        ctx->signal_quality_refreshed      = FALSE;
+        ctx->access_technologies_refreshed = FALSE;
+        ctx->timeout_source = mm_poll_scheduler_add_seconds (ctx->scheduler,
+                                                             "signal check",
+                                                             ctx->initial_check_done ? SIGNAL_CHECK_TIMEOUT_SEC : SIGNAL_CHECK_INITIAL_TIMEOUT_SEC,
+                                                             (GSourceFunc) periodic_signal_check_cb,
+                                                             self);
         return;
 
     default:
@@ -1685,7 +1756,7 @@ mm_iface_modem_refresh_signal (MMIfaceModem *self)
     /* Remove the scheduled timeout as we're going to refresh
      * right away */
     if (ctx->timeout_source) {
-        g_source_remove (ctx->timeout_source);
+        mm_poll_scheduler_remove (ctx->scheduler, ctx->timeout_source);
         ctx->timeout_source = 0;
     }
 
@@ -1718,7 +1789,7 @@ periodic_signal_check_disable (MMIfaceModem *self,
 
     /* Remove scheduled timeout */
     if (ctx->timeout_source) {
-        g_source_remove (ctx->timeout_source);
+        mm_poll_scheduler_remove (ctx->scheduler, ctx->timeout_source);
         ctx->timeout_source = 0;
     }
 
@@ -1823,10 +1894,10 @@ __iface_modem_update_state_internal (MMIfaceModem *self,
             if (failed_reason != mm_gdbus_modem_get_state_failed_reason (skeleton))
                 mm_gdbus_modem_set_state_failed_reason (skeleton, failed_reason);
 
-            /* Flush current change before signaling the state change,
-             * so that clients get the proper state already in the
-             * state-changed callback */
-            g_dbus_interface_skeleton_flush (G_DBUS_INTERFACE_SKELETON (skeleton));
+            /* Flush current change (and any other batched one) before
+             * signaling the state change, so that clients get the proper
+             * state already in the state-changed callback */
+            mm_base_modem_flush_properties (MM_BASE_MODEM (self));
             mm_gdbus_modem_emit_state_changed (skeleton,
                                                old_state,
                                                new_state,
@@ -4120,6 +4191,7 @@ enabling_set_power_state_ready (MMIfaceModem *self,
     GError *error = NULL;
 
     if (!mm_iface_modem_set_power_state_finish (self, res, &error)) {
+        mm_trace_end (self, "modem-enabling", NULL);
         g_task_return_error (task, error);
         g_object_unref (task);
         return;
@@ -4160,6 +4232,7 @@ setup_flow_control_ready (MMIfaceModem *self,
 
     MM_IFACE_MODEM_GET_INTERFACE (self)->setup_flow_control_finish (self, res, &error);
     if (error) {
+        mm_trace_end (self, "modem-enabling", NULL);
         g_task_return_error (task, error);
         g_object_unref (task);
         return;
@@ -4186,21 +4259,23 @@ interface_enabling_step (GTask *task)
     MMIfaceModem *self;
     EnablingContext *ctx;
 
+    self = g_task_get_source_object (task);
+    ctx = g_task_get_task_data (task);
+
     /* Don't run new steps if we're cancelled */
     if (g_task_return_error_if_cancelled (task)) {
+        mm_trace_end (self, "modem-enabling", NULL);
         g_object_unref (task);
         return;
     }
 
-    self = g_task_get_source_object (task);
-    ctx = g_task_get_task_data (task);
-
     switch (ctx->step) {
     case ENABLING_STEP_FIRST:
         ctx->step++;
         /* fall-through */
 
     case ENABLING_STEP_SET_POWER_STATE:
+        mm_trace_step (self, "modem-enabling", "set-power-state");
         mm_iface_modem_set_power_state (self,
                                         MM_MODEM_POWER_STATE_ON,
                                         (GAsyncReadyCallback)enabling_set_power_state_ready,
@@ -4208,6 +4283,7 @@ interface_enabling_step (GTask *task)
         return;
 
     case ENABLING_STEP_CHECK_FOR_SIM_SWAP:
+        mm_trace_step (self, "modem-enabling", "check-for-sim-swap");
         if (MM_IFACE_MODEM_GET_INTERFACE (self)->check_for_sim_swap &&
             MM_IFACE_MODEM_GET_INTERFACE (self)->check_for_sim_swap_finish) {
             MM_IFACE_MODEM_GET_INTERFACE (self)->check_for_sim_swap (
@@ -4221,6 +4297,7 @@ interface_enabling_step (GTask *task)
         /* fall-through */
 
     case ENABLING_STEP_FLOW_CONTROL:
+        mm_trace_step (self, "modem-enabling", "flow-control");
         if (MM_IFACE_MODEM_GET_INTERFACE (self)->setup_flow_control &&
             MM_IFACE_MODEM_GET_INTERFACE (self)->setup_flow_control_finish) {
             MM_IFACE_MODEM_GET_INTERFACE (self)->setup_flow_control (
@@ -4234,6 +4311,7 @@ interface_enabling_step (GTask *task)
 
     case ENABLING_STEP_LAST:
         /* We are done without errors! */
+        mm_trace_end (self, "modem-enabling", NULL);
         g_task_return_boolean (task, TRUE);
         g_object_unref (task);
         return;
@@ -4257,6 +4335,8 @@ mm_iface_modem_enable (MMIfaceModem *self,
     ctx = g_new0 (EnablingContext, 1);
     ctx->step = ENABLING_STEP_FIRST;
 
+    mm_trace_begin (self, "modem-enabling", NULL);
+
     task = g_task_new (self, cancellable, callback, user_data);
     g_task_set_task_data (task, ctx, (GDestroyNotify)enabling_context_free);
 
@@ -4268,6 +4348,7 @@ mm_iface_modem_enable (MMIfaceModem *self,
                                  MM_CORE_ERROR,
                                  MM_CORE_ERROR_FAILED,
                                  "Couldn't get interface skeleton");
+        mm_trace_end (self, "modem-enabling", NULL);
         g_object_unref (task);
         return;
     }
@@ -4472,6 +4553,378 @@ mm_iface_modem_sync (MMIfaceModem        *self,
 
 #endif
 
+/*****************************************************************************/
+/* Capability cache */
+
+/* The capabilities that only depend on the device and its firmware are stored
+ * on disk, keyed by equipment identifier and firmware revision, so that the
+ * next time the same modem shows up they don't need to be queried again.
+ * Only loads without side effects in the modem objects are skipped; the
+ * replies to AT test commands are instead given back to the primary port, so
+ * that the plugins still parse them as usual. */
+
+typedef struct {
+    MMIfaceModem           *self;
+    gchar                  *equipment_identifier;
+    gchar                  *revision;
+    /* Entry the capabilities were loaded from, if any */
+    MMCapabilityCacheEntry *entry;
+    guint                   refresh_id;
+    gboolean                refreshed;
+} CapabilityCacheContext;
+
+static void
+capability_cache_context_free (CapabilityCacheContext *ctx)
+{
+    if (ctx->refresh_id)
+        g_source_remove (ctx->refresh_id);
+    g_clear_pointer (&ctx->entry, mm_capability_cache_entry_free);
+    g_free (ctx->equipment_identifier);
+    g_free (ctx->revision);
+    g_slice_free (CapabilityCacheContext, ctx);
+}
+
+static void
+capability_cache_apply (MMIfaceModem *self,
+                        MmGdbusModem *skeleton)
+{
+    CapabilityCacheContext *ctx;
+    MMPortSerialAt         *primary;
+    g_autoptr(GError)       error = NULL;
+    GHashTableIter          iter;
+    gpointer                command;
+    gpointer                reply;
+
+    if (G_UNLIKELY (!capability_cache_context_quark))
+        capability_cache_context_quark = g_quark_from_static_string (CAPABILITY_CACHE_CONTEXT_TAG);
+
+    /* Already done in a previous initialization of the same modem */
+    if (g_object_get_qdata (G_OBJECT (self), capability_cache_context_quark))
+        return;
+
+    if (!mm_gdbus_modem_get_equipment_identifier (skeleton) || !mm_gdbus_modem_get_revision (skeleton)) {
+        mm_obj_dbg (self, "capability cache not used: unknown equipment identifier or revision");
+        return;
+    }
+
+    ctx = g_slice_new0 (CapabilityCacheContext);
+    ctx->self = self;
+    ctx->equipment_identifier = g_strdup (mm_gdbus_modem_get_equipment_identifier (skeleton));
+    ctx->revision = g_strdup (mm_gdbus_modem_get_revision (skeleton));
+    g_object_set_qdata_full (G_OBJECT (self),
+                             capability_cache_context_quark,
+                             ctx,
+                             (GDestroyNotify)capability_cache_context_free);
+
+    ctx->entry = mm_capability_cache_load (mm_context_get_test_capability_cache_dir (),
+                                           ctx->equipment_identifier,
+                                           ctx->revision,
+                                           &error);
+    if (!ctx->entry) {
+        if (error)
+            mm_obj_warn (self, "couldn't load capability cache entry: %s", error->message);
+        return;
+    }
+
+    mm_obj_dbg (self, "capabilities loaded from cache");
+    mm_gdbus_modem_set_manufacturer (skeleton, ctx->entry->manufacturer);
+    mm_gdbus_modem_set_model (skeleton, ctx->entry->model);
+    mm_gdbus_modem_set_hardware_revision (skeleton, ctx->entry->hardware_revision);
+
+    primary = mm_base_modem_peek_port_primary (MM_BASE_MODEM (self));
+    if (primary) {
+        g_hash_table_iter_init (&iter, ctx->entry->at_replies);
+        while (g_hash_table_iter_next (&iter, &command, &reply))
+            mm_port_serial_at_set_cached_reply (primary, command, reply);
+    }
+}
+
+static void
+capability_cache_store (MMIfaceModem *self,
+                        const gchar  *equipment_identifier,
+                        const gchar  *revision)
+{
+    g_autoptr(MMCapabilityCacheEntry)  entry = NULL;
+    g_autoptr(MmGdbusModemSkeleton)    skeleton = NULL;
+    g_autoptr(GError)                  error = NULL;
+    MMPortSerialAt                    *primary;
+
+    g_object_get (self,
+                  MM_IFACE_MODEM_DBUS_SKELETON, &skeleton,
+                  NULL);
+    if (!skeleton)
+        return;
+
+    entry = mm_capability_cache_entry_new ();
+    entry->manufacturer = g_strdup (mm_gdbus_modem_get_manufacturer (MM_GDBUS_MODEM (skeleton)));
+    entry->model = g_strdup (mm_gdbus_modem_get_model (MM_GDBUS_MODEM (skeleton)));
+    entry->hardware_revision = g_strdup (mm_gdbus_modem_get_hardware_revision (MM_GDBUS_MODEM (skeleton)));
+
+    primary = mm_base_modem_peek_port_primary (MM_BASE_MODEM (self));
+    if (primary) {
+        g_hash_table_unref (entry->at_replies);
+        entry->at_replies = mm_port_serial_at_get_cached_test_replies (primary);
+    }
+
+    if (!mm_capability_cache_store (mm_context_get_test_capability_cache_dir (),
+                                    equipment_identifier,
+                                    revision,
+                                    entry,
+                                    &error))
+        mm_obj_warn (self, "couldn't store capability cache entry: %s", error->message);
+}
+
+/* Verification of the cached capabilities, reloading them once the modem is
+ * usable */
+
+typedef enum {
+    CAPABILITY_CACHE_VERIFY_STEP_FIRST,
+    CAPABILITY_CACHE_VERIFY_STEP_MANUFACTURER,
+    CAPABILITY_CACHE_VERIFY_STEP_MODEL,
+    CAPABILITY_CACHE_VERIFY_STEP_HARDWARE_REVISION,
+    CAPABILITY_CACHE_VERIFY_STEP_AT_REPLIES,
+    CAPABILITY_CACHE_VERIFY_STEP_LAST,
+} CapabilityCacheVerifyStep;
+
+typedef struct {
+    CapabilityCacheVerifyStep  step;
+    MMCapabilityCacheEntry    *entry;
+    gchar                     *equipment_identifier;
+    gchar                     *revision;
+    MMPortSerialAt            *port;
+    GList                     *commands;
+    gchar                     *command;
+    gboolean                   outdated;
+} CapabilityCacheVerifyContext;
+
+static void
+capability_cache_verify_context_free (CapabilityCacheVerifyContext *ctx)
+{
+    g_list_free (ctx->commands);
+    g_clear_object (&ctx->port);
+    mm_capability_cache_entry_free (ctx->entry);
+    g_free (ctx->equipment_identifier);
+    g_free (ctx->revision);
+    g_slice_free (CapabilityCacheVerifyContext, ctx);
+}
+
+static void capability_cache_verify_step (GTask *task);
+
+#undef VERIFY_STR_READY_FN
+#define VERIFY_STR_READY_FN(NAME,DISPLAY)                               \
+    static void                                                         \
+    capability_cache_verify_##NAME##_ready (MMIfaceModem *self,         \
+                                            GAsyncResult *res,          \
+                                            GTask        *task)         \
+    {                                                                   \
+        CapabilityCacheVerifyContext *ctx;                              \
+        g_autoptr(GError)             error = NULL;                     \
+        g_autofree gchar             *val = NULL;                       \
+                                                                        \
+        ctx = g_task_get_task_data (task);                              \
+                                                                        \
+        /* On a reload error the cached value is kept */                \
+        val = MM_IFACE_MODEM_GET_INTERFACE (self)->load_##NAME##_finish (self, res, &error); \
+        if (!val)                                                       \
+            mm_obj_dbg (self, "couldn't reload %s: %s", DISPLAY,        \
+                        error ? error->message : "unknown error");      \
+        else if (g_strcmp0 (val, ctx->entry->NAME) != 0) {              \
+            mm_obj_dbg (self, "cached %s '%s' is outdated: '%s'", DISPLAY, \
+                        ctx->entry->NAME ? ctx->entry->NAME : "", val); \
+            ctx->outdated = TRUE;                                       \
+        }                                                               \
+                                                                        \
+        /* Go on to next step */                                        \
+        ctx->step++;                                                    \
+        capability_cache_verify_step (task);                            \
+    }
+
+VERIFY_STR_READY_FN (manufacturer,      "manufacturer")
+VERIFY_STR_READY_FN (model,             "model")
+VERIFY_STR_READY_FN (hardware_revision, "hardware revision")
+
+static void
+capability_cache_verify_at_reply_ready (MMBaseModem  *self,
+                                        GAsyncResult *res,
+                                        GTask        *task)
+{
+    CapabilityCacheVerifyContext *ctx;
+    g_autoptr(GError)             error = NULL;
+    const gchar                  *cached;
+    const gchar                  *response;
+
+    ctx = g_task_get_task_data (task);
+    cached = g_hash_table_lookup (ctx->entry->at_replies, ctx->command);
+
+    /* The command was sent without allowing the cached reply, which also
+     * removed it from the port, so give back either the new one or, on
+     * error, the cached one */
+    response = mm_base_modem_at_command_full_finish (self, res, &error);
+    if (!response) {
+        mm_obj_dbg (self, "couldn't reload reply to '%s': %s", ctx->command, error->message);
+        mm_port_serial_at_set_cached_reply (ctx->port, ctx->command, cached);
+    } else {
+        if (g_strcmp0 (response, cached) != 0) {
+            mm_obj_dbg (self, "cached reply to '%s' is outdated", ctx->command);
+            ctx->outdated = TRUE;
+        }
+        mm_port_serial_at_set_cached_reply (ctx->port, ctx->command, response);
+    }
+
+    /* Go on with the next command */
+    capability_cache_verify_step (task);
+}
+
+static void
+capability_cache_verify_step (GTask *task)
+{
+    MMIfaceModem                 *self;
+    CapabilityCacheVerifyContext *ctx;
+
+    self = g_task_get_source_object (task);
+    ctx = g_task_get_task_data (task);
+
+    switch (ctx->step) {
+    case CAPABILITY_CACHE_VERIFY_STEP_FIRST:
+        ctx->step++;
+        /* fall-through */
+
+    case CAPABILITY_CACHE_VERIFY_STEP_MANUFACTURER:
+        if (MM_IFACE_MODEM_GET_INTERFACE (self)->load_manufacturer &&
+            MM_IFACE_MODEM_GET_INTERFACE (self)->load_manufacturer_finish) {
+            MM_IFACE_MODEM_GET_INTERFACE (self)->load_manufacturer (
+                self,
+                (GAsyncReadyCallback)capability_cache_verify_manufacturer_ready,
+                task);
+            return;
+        }
+        ctx->step++;
+        /* fall-through */
+
+    case CAPABILITY_CACHE_VERIFY_STEP_MODEL:
+        if (MM_IFACE_MODEM_GET_INTERFACE (self)->load_model &&
+            MM_IFACE_MODEM_GET_INTERFACE (self)->load_model_finish) {
+            MM_IFACE_MODEM_GET_INTERFACE (self)->load_model (
+                self,
+                (GAsyncReadyCallback)capability_cache_verify_model_ready,
+                task);
+            return;
+        }
+        ctx->step++;
+        /* fall-through */
+
+    case CAPABILITY_CACHE_VERIFY_STEP_HARDWARE_REVISION:
+        if (MM_IFACE_MODEM_GET_INTERFACE (self)->load_hardware_revision &&
+            MM_IFACE_MODEM_GET_INTERFACE (self)->load_hardware_revision_finish) {
+            MM_IFACE_MODEM_GET_INTERFACE (self)->load_hardware_revision (
+                self,
+                (GAsyncReadyCallback)capability_cache_verify_hardware_revision_ready,
+                task);
+            return;
+        }
+        ctx->step++;
+        /* fall-through */
+
+    case CAPABILITY_CACHE_VERIFY_STEP_AT_REPLIES:
+        /* Test commands are sent to the port that got the cached replies */
+        if (ctx->port && ctx->commands) {
+            ctx->command = ctx->commands->data;
+            ctx->commands = g_list_delete_link (ctx->commands, ctx->commands);
+            mm_base_modem_at_command_full (MM_BASE_MODEM (self),
+                                           ctx->port,
+                                           ctx->command,
+                                           3,
+                                           FALSE, /* not cached */
+                                           FALSE, /* raw */
+                                           NULL,
+                                           (GAsyncReadyCallback)capability_cache_verify_at_reply_ready,
+                                           task);
+            return;
+        }
+        ctx->step++;
+        /* fall-through */
+
+    case CAPABILITY_CACHE_VERIFY_STEP_LAST:
+        /* An outdated entry is just removed, so that the next time the modem
+         * is initialized everything is loaded from the device */
+        if (ctx->outdated) {
+            mm_obj_warn (self, "cached capabilities are outdated, cache entry removed");
+            mm_capability_cache_remove (mm_context_get_test_capability_cache_dir (),
+                                        ctx->equipment_identifier,
+                                        ctx->revision);
+        } else {
+            mm_obj_dbg (self, "cached capabilities verified");
+            capability_cache_store (self, ctx->equipment_identifier, ctx->revision);
+        }
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+
+    default:
+        break;
+    }
+
+    g_assert_not_reached ();
+}
+
+static void
+capability_cache_verify_ready (MMIfaceModem *self,
+                               GAsyncResult *res)
+{
+    g_task_propagate_boolean (G_TASK (res), NULL);
+}
+
+static gboolean
+capability_cache_refresh_cb (CapabilityCacheContext *ctx)
+{
+    CapabilityCacheVerifyContext *verify_ctx;
+    GTask                        *task;
+
+    ctx->refresh_id = 0;
+    ctx->refreshed = TRUE;
+
+    /* Capabilities loaded from the device were already stored; store them
+     * again to include the replies to the test commands that the plugins sent
+     * after the initialization */
+    if (!ctx->entry) {
+        capability_cache_store (ctx->self, ctx->equipment_identifier, ctx->revision);
+        return G_SOURCE_REMOVE;
+    }
+
+    mm_obj_dbg (ctx->self, "verifying cached capabilities...");
+    verify_ctx = g_slice_new0 (CapabilityCacheVerifyContext);
+    verify_ctx->step = CAPABILITY_CACHE_VERIFY_STEP_FIRST;
+    verify_ctx->entry = g_steal_pointer (&ctx->entry);
+    verify_ctx->equipment_identifier = g_strdup (ctx->equipment_identifier);
+    verify_ctx->revision = g_strdup (ctx->revision);
+    verify_ctx->port = mm_base_modem_get_port_primary (MM_BASE_MODEM (ctx->self));
+    verify_ctx->commands = g_hash_table_get_keys (verify_ctx->entry->at_replies);
+
+    task = g_task_new (ctx->self, NULL, (GAsyncReadyCallback)capability_cache_verify_ready, NULL);
+    g_task_set_task_data (task, verify_ctx, (GDestroyNotify)capability_cache_verify_context_free);
+    capability_cache_verify_step (task);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+capability_cache_initialization_done (MMIfaceModem *self)
+{
+    CapabilityCacheContext *ctx;
+
+    if (G_UNLIKELY (!capability_cache_context_quark))
+        return;
+
+    ctx = g_object_get_qdata (G_OBJECT (self), capability_cache_context_quark);
+    if (!ctx || ctx->refresh_id || ctx->refreshed)
+        return;
+
+    if (!ctx->entry)
+        capability_cache_store (self, ctx->equipment_identifier, ctx->revision);
+    ctx->refresh_id = g_timeout_add_seconds (CAPABILITY_CACHE_REFRESH_DELAY_SECS,
+                                             (GSourceFunc)capability_cache_refresh_cb,
+                                             ctx);
+}
+
 /*****************************************************************************/
 /* MODEM INITIALIZATION */
 
@@ -4484,17 +4937,11 @@ typedef enum {
     INITIALIZATION_STEP_SUPPORTED_CAPABILITIES,
     INITIALIZATION_STEP_SUPPORTED_CHARSETS,
     INITIALIZATION_STEP_CHARSET,
+    INITIALIZATION_STEP_CAPABILITY_CACHE_EQUIPMENT_ID,
+    INITIALIZATION_STEP_CAPABILITY_CACHE_REVISION,
+    INITIALIZATION_STEP_CAPABILITY_CACHE,
     INITIALIZATION_STEP_BEARERS,
-    INITIALIZATION_STEP_MANUFACTURER,
-    INITIALIZATION_STEP_MODEL,
-    INITIALIZATION_STEP_REVISION,
-    INITIALIZATION_STEP_CARRIER_CONFIG,
-    INITIALIZATION_STEP_HARDWARE_REVISION,
-    INITIALIZATION_STEP_EQUIPMENT_ID,
-    INITIALIZATION_STEP_DEVICE_ID,
-    INITIALIZATION_STEP_SUPPORTED_MODES,
-    INITIALIZATION_STEP_SUPPORTED_BANDS,
-    INITIALIZATION_STEP_SUPPORTED_IP_FAMILIES,
+    INITIALIZATION_STEP_LOADS,
     INITIALIZATION_STEP_POWER_STATE,
     INITIALIZATION_STEP_SIM_HOT_SWAP,
     INITIALIZATION_STEP_SIM_SLOTS,
@@ -4507,24 +4954,46 @@ typedef enum {
     INITIALIZATION_STEP_LAST
 } InitializationStep;
 
+/* Independent loads, run by a step scheduler in INITIALIZATION_STEP_LOADS */
+typedef enum {
+    INITIALIZATION_LOAD_MANUFACTURER,
+    INITIALIZATION_LOAD_MODEL,
+    INITIALIZATION_LOAD_REVISION,
+    INITIALIZATION_LOAD_CARRIER_CONFIG,
+    INITIALIZATION_LOAD_HARDWARE_REVISION,
+    INITIALIZATION_LOAD_EQUIPMENT_ID,
+    INITIALIZATION_LOAD_DEVICE_ID,
+    INITIALIZATION_LOAD_SUPPORTED_MODES,
+    INITIALIZATION_LOAD_SUPPORTED_BANDS,
+    INITIALIZATION_LOAD_SUPPORTED_IP_FAMILIES,
+} InitializationLoad;
+
+/* Maximum number of loads in flight when the modem is controlled with QMI or
+ * MBIM, as those protocols multiplex requests. With AT ports, the loads are
+ * run one after the other. */
+#define INITIALIZATION_MAX_CONCURRENT_LOADS 4
+
 struct _InitializationContext {
     InitializationStep step;
     MmGdbusModem *skeleton;
     MMModemCharset supported_charsets;
     const MMModemCharset *current_charset;
     GError *fatal_error;
+    MMStepScheduler *loads;
+    gulong loads_cancelled_id;
 };
 
 static void
 initialization_context_free (InitializationContext *ctx)
 {
     g_assert (ctx->fatal_error == NULL);
+    g_assert (ctx->loads == NULL);
     g_object_unref (ctx->skeleton);
     g_free (ctx);
 }
 
 #undef STR_REPLY_READY_FN
-#define STR_REPLY_READY_FN(NAME,DISPLAY)                                \
+#define STR_REPLY_READY_FN(NAME,DISPLAY,LOAD)                           \
     static void                                                         \
     load_##NAME##_ready (MMIfaceModem *self,                            \
                          GAsyncResult *res,                             \
@@ -4545,9 +5014,8 @@ initialization_context_free (InitializationContext *ctx)
             g_error_free (error);                                       \
         }                                                               \
                                                                         \
-        /* Go on to next step */                                        \
-        ctx->step++;                                                    \
-        interface_initialization_step (task);                           \
+        /* Go on with the remaining loads */                            \
+        mm_step_scheduler_step_done (ctx->loads, LOAD);                 \
     }
 
 #undef UINT_REPLY_READY_FN
@@ -4719,12 +5187,44 @@ load_supported_capabilities_ready (MMIfaceModem *self,
     interface_initialization_step (task);
 }
 
-STR_REPLY_READY_FN (manufacturer, "manufacturer")
-STR_REPLY_READY_FN (model, "model")
-STR_REPLY_READY_FN (revision, "revision")
-STR_REPLY_READY_FN (hardware_revision, "hardware revision")
-STR_REPLY_READY_FN (equipment_identifier, "equipment identifier")
-STR_REPLY_READY_FN (device_identifier, "device identifier")
+STR_REPLY_READY_FN (manufacturer,         "manufacturer",         INITIALIZATION_LOAD_MANUFACTURER)
+STR_REPLY_READY_FN (model,                "model",                INITIALIZATION_LOAD_MODEL)
+STR_REPLY_READY_FN (revision,             "revision",             INITIALIZATION_LOAD_REVISION)
+STR_REPLY_READY_FN (hardware_revision,    "hardware revision",    INITIALIZATION_LOAD_HARDWARE_REVISION)
+STR_REPLY_READY_FN (equipment_identifier, "equipment identifier", INITIALIZATION_LOAD_EQUIPMENT_ID)
+STR_REPLY_READY_FN (device_identifier,    "device identifier",    INITIALIZATION_LOAD_DEVICE_ID)
+
+/* The capability cache key is loaded before the rest of identifiers, so its
+ * loads go on with the next step instead of the load scheduler */
+#undef CAPABILITY_CACHE_KEY_READY_FN
+#define CAPABILITY_CACHE_KEY_READY_FN(NAME,DISPLAY)                     \
+    static void                                                         \
+    capability_cache_load_##NAME##_ready (MMIfaceModem *self,           \
+                                          GAsyncResult *res,            \
+                                          GTask *task)                  \
+    {                                                                   \
+        InitializationContext *ctx;                                     \
+        GError *error = NULL;                                           \
+        gchar *val;                                                     \
+                                                                        \
+        ctx = g_task_get_task_data (task);                              \
+                                                                        \
+        val = MM_IFACE_MODEM_GET_INTERFACE (self)->load_##NAME##_finish (self, res, &error); \
+        mm_gdbus_modem_set_##NAME (ctx->skeleton, val);                 \
+        g_free (val);                                                   \
+                                                                        \
+        if (error) {                                                    \
+            mm_obj_warn (self, "couldn't load %s: %s", DISPLAY, error->message); \
+            g_error_free (error);                                       \
+        }                                                               \
+                                                                        \
+        /* Go on to next step */                                        \
+        ctx->step++;                                                    \
+        interface_initialization_step (task);                           \
+    }
+
+CAPABILITY_CACHE_KEY_READY_FN (equipment_identifier, "equipment identifier")
+CAPABILITY_CACHE_KEY_READY_FN (revision,             "revision")
 
 static void
 load_supported_charsets_ready (MMIfaceModem *self,
@@ -4795,9 +5295,8 @@ load_supported_modes_ready (MMIfaceModem *self,
         g_error_free (error);
     }
 
-    /* Go on to next step */
-    ctx->step++;
-    interface_initialization_step (task);
+    /* Go on with the remaining loads */
+    mm_step_scheduler_step_done (ctx->loads, INITIALIZATION_LOAD_SUPPORTED_MODES);
 }
 
 static void
@@ -4824,9 +5323,8 @@ load_supported_bands_ready (MMIfaceModem *self,
         g_error_free (error);
     }
 
-    /* Go on to next step */
-    ctx->step++;
-    interface_initialization_step (task);
+    /* Go on with the remaining loads */
+    mm_step_scheduler_step_done (ctx->loads, INITIALIZATION_LOAD_SUPPORTED_BANDS);
 }
 
 static void
@@ -4850,9 +5348,8 @@ load_supported_ip_families_ready (MMIfaceModem *self,
         g_error_free (error);
     }
 
-    /* Go on to next step */
-    ctx->step++;
-    interface_initialization_step (task);
+    /* Go on with the remaining loads */
+    mm_step_scheduler_step_done (ctx->loads, INITIALIZATION_LOAD_SUPPORTED_IP_FAMILIES);
 }
 
 UINT_REPLY_READY_FN (power_state, "power state")
@@ -5076,9 +5573,8 @@ load_carrier_config_ready (MMIfaceModem *self,
         g_free (revision);
     }
 
-    /* Go on to next step */
-    ctx->step++;
-    interface_initialization_step (task);
+    /* Go on with the remaining loads */
+    mm_step_scheduler_step_done (ctx->loads, INITIALIZATION_LOAD_CARRIER_CONFIG);
 }
 
 void
@@ -5192,6 +5688,259 @@ load_current_bands_ready (MMIfaceModem *self,
     interface_initialization_step (task);
 }
 
+/* Identifiers are meant to be loaded only once during the whole lifetime of
+ * the modem. Therefore, if we already have them loaded, don't try to load
+ * them again. */
+#undef STR_LOAD_FN
+#define STR_LOAD_FN(NAME)                                               \
+    static void                                                         \
+    initialization_load_##NAME (MMStepScheduler *loads,                 \
+                                guint            load,                  \
+                                GTask           *task)                  \
+    {                                                                   \
+        MMIfaceModem          *self;                                    \
+        InitializationContext *ctx;                                     \
+                                                                        \
+        self = g_task_get_source_object (task);                         \
+        ctx = g_task_get_task_data (task);                              \
+                                                                        \
+        if (mm_gdbus_modem_get_##NAME (ctx->skeleton) == NULL &&        \
+            MM_IFACE_MODEM_GET_INTERFACE (self)->load_##NAME &&         \
+            MM_IFACE_MODEM_GET_INTERFACE (self)->load_##NAME##_finish) { \
+            MM_IFACE_MODEM_GET_INTERFACE (self)->load_##NAME (          \
+                self,                                                   \
+                (GAsyncReadyCallback)load_##NAME##_ready,               \
+                task);                                                  \
+            return;                                                     \
+        }                                                               \
+        mm_step_scheduler_step_done (loads, load);                      \
+    }
+
+STR_LOAD_FN (manufacturer)
+STR_LOAD_FN (model)
+STR_LOAD_FN (revision)
+STR_LOAD_FN (hardware_revision)
+STR_LOAD_FN (equipment_identifier)
+STR_LOAD_FN (device_identifier)
+
+static void
+initialization_load_carrier_config (MMStepScheduler *loads,
+                                    guint            load,
+                                    GTask           *task)
+{
+    MMIfaceModem          *self;
+    InitializationContext *ctx;
+
+    self = g_task_get_source_object (task);
+    ctx = g_task_get_task_data (task);
+
+    /* Current carrier config is meant to be loaded only once during the whole
+     * lifetime of the modem. Therefore, if we already have them loaded,
+     * don't try to load them again. */
+    if (mm_gdbus_modem_get_carrier_configuration (ctx->skeleton) == NULL &&
+        MM_IFACE_MODEM_GET_INTERFACE (self)->load_carrier_config &&
+        MM_IFACE_MODEM_GET_INTERFACE (self)->load_carrier_config_finish) {
+        MM_IFACE_MODEM_GET_INTERFACE (self)->load_carrier_config (self,
+                                                                  (GAsyncReadyCallback)load_carrier_config_ready,
+                                                                  task);
+        return;
+    }
+    mm_step_scheduler_step_done (loads, load);
+}
+
+static void
+initialization_load_supported_modes (MMStepScheduler *loads,
+                                     guint            load,
+                                     GTask           *task)
+{
+    MMIfaceModem          *self;
+    InitializationContext *ctx;
+
+    self = g_task_get_source_object (task);
+    ctx = g_task_get_task_data (task);
+
+    if (MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_modes != NULL &&
+        MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_modes_finish != NULL) {
+        GArray *supported_modes;
+        MMModemModeCombination *mode = NULL;
+
+        supported_modes = (mm_common_mode_combinations_variant_to_garray (
+                               mm_gdbus_modem_get_supported_modes (ctx->skeleton)));
+
+        /* Supported modes are meant to be loaded only once during the whole
+         * lifetime of the modem. Therefore, if we already have them loaded,
+         * don't try to load them again. */
+        if (supported_modes->len == 1)
+            mode = &g_array_index (supported_modes, MMModemModeCombination, 0);
+        if (supported_modes->len == 0 ||
+            (mode && mode->allowed == MM_MODEM_MODE_ANY && mode->preferred == MM_MODEM_MODE_NONE)) {
+            MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_modes (
+                self,
+                (GAsyncReadyCallback)load_supported_modes_ready,
+                task);
+            g_array_unref (supported_modes);
+            return;
+        }
+
+        g_array_unref (supported_modes);
+    }
+    mm_step_scheduler_step_done (loads, load);
+}
+
+static void
+initialization_load_supported_bands (MMStepScheduler *loads,
+                                     guint            load,
+                                     GTask           *task)
+{
+    MMIfaceModem          *self;
+    InitializationContext *ctx;
+    GArray                *supported_bands;
+
+    self = g_task_get_source_object (task);
+    ctx = g_task_get_task_data (task);
+
+    supported_bands = (mm_common_bands_variant_to_garray (
+                           mm_gdbus_modem_get_supported_bands (ctx->skeleton)));
+
+    /* Supported bands are meant to be loaded only once during the whole
+     * lifetime of the modem. Therefore, if we already have them loaded,
+     * don't try to load them again. */
+    if (supported_bands->len == 0 ||
+        g_array_index (supported_bands, MMModemBand, 0)  == MM_MODEM_BAND_UNKNOWN) {
+        if (MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_bands &&
+            MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_bands_finish) {
+            MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_bands (
+                self,
+                (GAsyncReadyCallback)load_supported_bands_ready,
+                task);
+            g_array_unref (supported_bands);
+            return;
+        }
+
+        /* Loading supported bands not implemented, default to UNKNOWN */
+        mm_gdbus_modem_set_supported_bands (ctx->skeleton, mm_common_build_bands_unknown ());
+        mm_gdbus_modem_set_current_bands (ctx->skeleton, mm_common_build_bands_unknown ());
+    }
+    g_array_unref (supported_bands);
+
+    mm_step_scheduler_step_done (loads, load);
+}
+
+static void
+initialization_load_supported_ip_families (MMStepScheduler *loads,
+                                           guint            load,
+                                           GTask           *task)
+{
+    MMIfaceModem          *self;
+    InitializationContext *ctx;
+
+    self = g_task_get_source_object (task);
+    ctx = g_task_get_task_data (task);
+
+    /* Supported ip_families are meant to be loaded only once during the whole
+     * lifetime of the modem. Therefore, if we already have them loaded,
+     * don't try to load them again. */
+    if (MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_ip_families != NULL &&
+        MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_ip_families_finish != NULL &&
+        mm_gdbus_modem_get_supported_ip_families (ctx->skeleton) == MM_BEARER_IP_FAMILY_NONE) {
+        MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_ip_families (
+            self,
+            (GAsyncReadyCallback)load_supported_ip_families_ready,
+            task);
+        return;
+    }
+    mm_step_scheduler_step_done (loads, load);
+}
+
+static guint
+initialization_get_max_concurrent_loads (MMIfaceModem *self)
+{
+    GList *ports;
+    guint  max_concurrent_loads = 1;
+
+    ports = mm_base_modem_find_ports (MM_BASE_MODEM (self), MM_PORT_SUBSYS_UNKNOWN, MM_PORT_TYPE_QMI);
+    if (!ports)
+        ports = mm_base_modem_find_ports (MM_BASE_MODEM (self), MM_PORT_SUBSYS_UNKNOWN, MM_PORT_TYPE_MBIM);
+    if (ports)
+        max_concurrent_loads = INITIALIZATION_MAX_CONCURRENT_LOADS;
+    g_list_free_full (ports, g_object_unref);
+
+    return max_concurrent_loads;
+}
+
+static void
+initialization_loads_done (MMStepScheduler *loads,
+                           GTask           *task)
+{
+    InitializationContext *ctx;
+
+    ctx = g_task_get_task_data (task);
+    if (ctx->loads_cancelled_id) {
+        g_cancellable_disconnect (g_task_get_cancellable (task), ctx->loads_cancelled_id);
+        ctx->loads_cancelled_id = 0;
+    }
+    g_clear_pointer (&ctx->loads, mm_step_scheduler_free);
+
+    /* Go on to next step; if cancelled, the task is completed there */
+    ctx->step++;
+    interface_initialization_step (task);
+}
+
+static void
+initialization_loads_cancelled (GCancellable    *cancellable,
+                                MMStepScheduler *loads)
+{
+    /* No new loads are started, the ones in flight are waited for */
+    mm_step_scheduler_abort (loads);
+}
+
+static void
+initialization_run_loads (GTask *task)
+{
+    MMIfaceModem          *self;
+    InitializationContext *ctx;
+
+    self = g_task_get_source_object (task);
+    ctx = g_task_get_task_data (task);
+
+    g_assert (!ctx->loads);
+    ctx->loads = mm_step_scheduler_new (self, "initialization loads", initialization_get_max_concurrent_loads (self));
+
+#define ADD_LOAD(LOAD,NAME,FN)                                          \
+    mm_step_scheduler_add_step (ctx->loads, LOAD, NAME, (MMStepSchedulerStepFunc)FN, task)
+
+    ADD_LOAD (INITIALIZATION_LOAD_MANUFACTURER,          "manufacturer",          initialization_load_manufacturer);
+    ADD_LOAD (INITIALIZATION_LOAD_MODEL,                 "model",                 initialization_load_model);
+    ADD_LOAD (INITIALIZATION_LOAD_REVISION,              "revision",              initialization_load_revision);
+    ADD_LOAD (INITIALIZATION_LOAD_CARRIER_CONFIG,        "carrier config",        initialization_load_carrier_config);
+    ADD_LOAD (INITIALIZATION_LOAD_HARDWARE_REVISION,     "hardware revision",     initialization_load_hardware_revision);
+    ADD_LOAD (INITIALIZATION_LOAD_EQUIPMENT_ID,          "equipment identifier",  initialization_load_equipment_identifier);
+    ADD_LOAD (INITIALIZATION_LOAD_DEVICE_ID,             "device identifier",     initialization_load_device_identifier);
+    ADD_LOAD (INITIALIZATION_LOAD_SUPPORTED_MODES,       "supported modes",       initialization_load_supported_modes);
+    ADD_LOAD (INITIALIZATION_LOAD_SUPPORTED_BANDS,       "supported bands",       initialization_load_supported_bands);
+    ADD_LOAD (INITIALIZATION_LOAD_SUPPORTED_IP_FAMILIES, "supported IP families", initialization_load_supported_ip_families);
+
+#undef ADD_LOAD
+
+    /* The device identifier is built from the other identifiers */
+    mm_step_scheduler_add_dependency (ctx->loads, INITIALIZATION_LOAD_DEVICE_ID, INITIALIZATION_LOAD_MANUFACTURER);
+    mm_step_scheduler_add_dependency (ctx->loads, INITIALIZATION_LOAD_DEVICE_ID, INITIALIZATION_LOAD_MODEL);
+    mm_step_scheduler_add_dependency (ctx->loads, INITIALIZATION_LOAD_DEVICE_ID, INITIALIZATION_LOAD_REVISION);
+    mm_step_scheduler_add_dependency (ctx->loads, INITIALIZATION_LOAD_DEVICE_ID, INITIALIZATION_LOAD_EQUIPMENT_ID);
+
+    /* Supported modes and bands may be filtered based on the model */
+    mm_step_scheduler_add_dependency (ctx->loads, INITIALIZATION_LOAD_SUPPORTED_MODES, INITIALIZATION_LOAD_MODEL);
+    mm_step_scheduler_add_dependency (ctx->loads, INITIALIZATION_LOAD_SUPPORTED_BANDS, INITIALIZATION_LOAD_MODEL);
+
+    if (g_task_get_cancellable (task))
+        ctx->loads_cancelled_id = g_cancellable_connect (g_task_get_cancellable (task),
+                                                         G_CALLBACK (initialization_loads_cancelled),
+                                                         ctx->loads,
+                                                         NULL);
+
+    mm_step_scheduler_run (ctx->loads, (MMStepSchedulerDoneFunc)initialization_loads_done, task);
+}
+
 static void
 interface_initialization_step (GTask *task)
 {
@@ -5208,6 +5957,7 @@ interface_initialization_step (GTask *task)
             g_error_free (ctx->fatal_error);
             ctx->fatal_error = NULL;
         }
+        mm_trace_end (self, "modem-initialization", NULL);
         g_object_unref (task);
         return;
     }
@@ -5275,6 +6025,7 @@ interface_initialization_step (GTask *task)
         /* fall-through */
 
     case INITIALIZATION_STEP_CURRENT_CAPABILITIES:
+        mm_trace_step (self, "modem-initialization", "current-capabilities");
         /* Current capabilities may change during runtime, i.e. if new firmware reloaded; but we'll
          * try to handle that by making sure the capabilities are cleared when the new firmware is
          * reloaded. So if we're asked to re-initialize, if we already have current capabilities loaded,
@@ -5294,6 +6045,7 @@ interface_initialization_step (GTask *task)
     case INITIALIZATION_STEP_SUPPORTED_CAPABILITIES: {
         GArray *supported_capabilities;
 
+        mm_trace_step (self, "modem-initialization", "supported-capabilities");
         supported_capabilities = (mm_common_capability_combinations_variant_to_garray (
                                       mm_gdbus_modem_get_supported_capabilities (ctx->skeleton)));
 
@@ -5329,6 +6081,7 @@ interface_initialization_step (GTask *task)
     } /* fall-through */
 
     case INITIALIZATION_STEP_SUPPORTED_CHARSETS:
+        mm_trace_step (self, "modem-initialization", "supported-charsets");
         if (MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_charsets &&
             MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_charsets_finish) {
             MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_charsets (
@@ -5341,6 +6094,7 @@ interface_initialization_step (GTask *task)
         /* fall-through */
 
     case INITIALIZATION_STEP_CHARSET:
+        mm_trace_step (self, "modem-initialization", "charset");
         /* Only try to set charsets if we were able to load supported ones */
         if (ctx->supported_charsets > 0 &&
             MM_IFACE_MODEM_GET_INTERFACE (self)->setup_charset &&
@@ -5376,9 +6130,43 @@ interface_initialization_step (GTask *task)
         ctx->step++;
         /* fall-through */
 
+    case INITIALIZATION_STEP_CAPABILITY_CACHE_EQUIPMENT_ID:
+        mm_trace_step (self, "modem-initialization", "capability-cache");
+        if (mm_gdbus_modem_get_equipment_identifier (ctx->skeleton) == NULL &&
+            MM_IFACE_MODEM_GET_INTERFACE (self)->load_equipment_identifier &&
+            MM_IFACE_MODEM_GET_INTERFACE (self)->load_equipment_identifier_finish) {
+            MM_IFACE_MODEM_GET_INTERFACE (self)->load_equipment_identifier (
+                self,
+                (GAsyncReadyCallback)capability_cache_load_equipment_identifier_ready,
+                task);
+            return;
+        }
+        ctx->step++;
+        /* fall-through */
+
+    case INITIALIZATION_STEP_CAPABILITY_CACHE_REVISION:
+        if (mm_gdbus_modem_get_revision (ctx->skeleton) == NULL &&
+            MM_IFACE_MODEM_GET_INTERFACE (self)->load_revision &&
+            MM_IFACE_MODEM_GET_INTERFACE (self)->load_revision_finish) {
+            MM_IFACE_MODEM_GET_INTERFACE (self)->load_revision (
+                self,
+                (GAsyncReadyCallback)capability_cache_load_revision_ready,
+                task);
+            return;
+        }
+        ctx->step++;
+        /* fall-through */
+
+    case INITIALIZATION_STEP_CAPABILITY_CACHE:
+        /* Values found in the cache are not loaded again afterwards */
+        capability_cache_apply (self, ctx->skeleton);
+        ctx->step++;
+        /* fall-through */
+
     case INITIALIZATION_STEP_BEARERS: {
         g_autoptr(MMBearerList) list = NULL;
 
+        mm_trace_step (self, "modem-initialization", "bearers");
         /* Bearers setup is meant to be loaded only once during the whole
          * lifetime of the modem, so check if it exists; and if it doesn't,
          * create it right away. */
@@ -5412,193 +6200,13 @@ interface_initialization_step (GTask *task)
         ctx->step++;
     } /* fall-through */
 
-    case INITIALIZATION_STEP_MANUFACTURER:
-        /* Manufacturer is meant to be loaded only once during the whole
-         * lifetime of the modem. Therefore, if we already have them loaded,
-         * don't try to load them again. */
-        if (mm_gdbus_modem_get_manufacturer (ctx->skeleton) == NULL &&
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_manufacturer &&
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_manufacturer_finish) {
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_manufacturer (
-                self,
-                (GAsyncReadyCallback)load_manufacturer_ready,
-                task);
-            return;
-        }
-        ctx->step++;
-        /* fall-through */
-
-    case INITIALIZATION_STEP_MODEL:
-        /* Model is meant to be loaded only once during the whole
-         * lifetime of the modem. Therefore, if we already have them loaded,
-         * don't try to load them again. */
-        if (mm_gdbus_modem_get_model (ctx->skeleton) == NULL &&
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_model &&
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_model_finish) {
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_model (
-                self,
-                (GAsyncReadyCallback)load_model_ready,
-                task);
-            return;
-        }
-        ctx->step++;
-        /* fall-through */
-
-    case INITIALIZATION_STEP_REVISION:
-        /* Revision is meant to be loaded only once during the whole
-         * lifetime of the modem. Therefore, if we already have them loaded,
-         * don't try to load them again. */
-        if (mm_gdbus_modem_get_revision (ctx->skeleton) == NULL &&
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_revision &&
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_revision_finish) {
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_revision (
-                self,
-                (GAsyncReadyCallback)load_revision_ready,
-                task);
-            return;
-        }
-        ctx->step++;
-        /* fall-through */
-
-    case INITIALIZATION_STEP_CARRIER_CONFIG:
-        /* Current carrier config is meant to be loaded only once during the whole
-         * lifetime of the modem. Therefore, if we already have them loaded,
-         * don't try to load them again. */
-        if (mm_gdbus_modem_get_carrier_configuration (ctx->skeleton) == NULL &&
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_carrier_config &&
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_carrier_config_finish) {
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_carrier_config (self,
-                                                                      (GAsyncReadyCallback)load_carrier_config_ready,
-                                                                      task);
-            return;
-        }
-        ctx->step++;
-        /* fall-through */
-
-    case INITIALIZATION_STEP_HARDWARE_REVISION:
-        /* HardwareRevision is meant to be loaded only once during the whole
-         * lifetime of the modem. Therefore, if we already have them loaded,
-         * don't try to load them again. */
-        if (mm_gdbus_modem_get_hardware_revision (ctx->skeleton) == NULL &&
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_hardware_revision &&
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_hardware_revision_finish) {
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_hardware_revision (
-                self,
-                (GAsyncReadyCallback)load_hardware_revision_ready,
-                task);
-            return;
-        }
-        ctx->step++;
-        /* fall-through */
-
-    case INITIALIZATION_STEP_EQUIPMENT_ID:
-        /* Equipment ID is meant to be loaded only once during the whole
-         * lifetime of the modem. Therefore, if we already have them loaded,
-         * don't try to load them again. */
-        if (mm_gdbus_modem_get_equipment_identifier (ctx->skeleton) == NULL &&
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_equipment_identifier &&
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_equipment_identifier_finish) {
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_equipment_identifier (
-                self,
-                (GAsyncReadyCallback)load_equipment_identifier_ready,
-                task);
-            return;
-        }
-        ctx->step++;
-        /* fall-through */
-
-    case INITIALIZATION_STEP_DEVICE_ID:
-        /* Device ID is meant to be loaded only once during the whole
-         * lifetime of the modem. Therefore, if we already have them loaded,
-         * don't try to load them again. */
-        if (mm_gdbus_modem_get_device_identifier (ctx->skeleton) == NULL &&
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_device_identifier &&
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_device_identifier_finish) {
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_device_identifier (
-                self,
-                (GAsyncReadyCallback)load_device_identifier_ready,
-                task);
-            return;
-        }
-        ctx->step++;
-        /* fall-through */
-
-    case INITIALIZATION_STEP_SUPPORTED_MODES:
-        if (MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_modes != NULL &&
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_modes_finish != NULL) {
-            GArray *supported_modes;
-            MMModemModeCombination *mode = NULL;
-
-            supported_modes = (mm_common_mode_combinations_variant_to_garray (
-                                   mm_gdbus_modem_get_supported_modes (ctx->skeleton)));
-
-            /* Supported modes are meant to be loaded only once during the whole
-             * lifetime of the modem. Therefore, if we already have them loaded,
-             * don't try to load them again. */
-            if (supported_modes->len == 1)
-                mode = &g_array_index (supported_modes, MMModemModeCombination, 0);
-            if (supported_modes->len == 0 ||
-                (mode && mode->allowed == MM_MODEM_MODE_ANY && mode->preferred == MM_MODEM_MODE_NONE)) {
-                MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_modes (
-                    self,
-                    (GAsyncReadyCallback)load_supported_modes_ready,
-                    task);
-                g_array_unref (supported_modes);
-                return;
-            }
-
-            g_array_unref (supported_modes);
-        }
-        ctx->step++;
-        /* fall-through */
-
-    case INITIALIZATION_STEP_SUPPORTED_BANDS: {
-        GArray *supported_bands;
-
-        supported_bands = (mm_common_bands_variant_to_garray (
-                               mm_gdbus_modem_get_supported_bands (ctx->skeleton)));
-
-        /* Supported bands are meant to be loaded only once during the whole
-         * lifetime of the modem. Therefore, if we already have them loaded,
-         * don't try to load them again. */
-        if (supported_bands->len == 0 ||
-            g_array_index (supported_bands, MMModemBand, 0)  == MM_MODEM_BAND_UNKNOWN) {
-            if (MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_bands &&
-                MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_bands_finish) {
-                MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_bands (
-                    self,
-                    (GAsyncReadyCallback)load_supported_bands_ready,
-                    task);
-                g_array_unref (supported_bands);
-                return;
-            }
-
-            /* Loading supported bands not implemented, default to UNKNOWN */
-            mm_gdbus_modem_set_supported_bands (ctx->skeleton, mm_common_build_bands_unknown ());
-            mm_gdbus_modem_set_current_bands (ctx->skeleton, mm_common_build_bands_unknown ());
-        }
-        g_array_unref (supported_bands);
-
-        ctx->step++;
-    } /* fall-through */
-
-    case INITIALIZATION_STEP_SUPPORTED_IP_FAMILIES:
-        /* Supported ip_families are meant to be loaded only once during the whole
-         * lifetime of the modem. Therefore, if we already have them loaded,
-         * don't try to load them again. */
-        if (MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_ip_families != NULL &&
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_ip_families_finish != NULL &&
-            mm_gdbus_modem_get_supported_ip_families (ctx->skeleton) == MM_BEARER_IP_FAMILY_NONE) {
-            MM_IFACE_MODEM_GET_INTERFACE (self)->load_supported_ip_families (
-                self,
-                (GAsyncReadyCallback)load_supported_ip_families_ready,
-                task);
-            return;
-        }
-        ctx->step++;
-        /* fall-through */
+    case INITIALIZATION_STEP_LOADS:
+        mm_trace_step (self, "modem-initialization", "loads");
+        initialization_run_loads (task);
+        return;
 
     case INITIALIZATION_STEP_POWER_STATE:
+        mm_trace_step (self, "modem-initialization", "power-state");
         /* Initial power state is meant to be loaded only once. Therefore, if we
          * already have it loaded, don't try to load it again. */
         if (mm_gdbus_modem_get_power_state (ctx->skeleton) == MM_MODEM_POWER_STATE_UNKNOWN) {
@@ -5620,6 +6228,7 @@ interface_initialization_step (GTask *task)
     case INITIALIZATION_STEP_SIM_HOT_SWAP: {
         gboolean sim_hot_swap_configured = FALSE;
 
+        mm_trace_step (self, "modem-initialization", "sim-hot-swap");
         g_object_get (self,
                       MM_IFACE_MODEM_SIM_HOT_SWAP_CONFIGURED, &sim_hot_swap_configured,
                       NULL);
@@ -5636,6 +6245,7 @@ interface_initialization_step (GTask *task)
     } /* fall-through */
 
         case INITIALIZATION_STEP_SIM_SLOTS:
+        mm_trace_step (self, "modem-initialization", "sim-slots");
         /* If the modem doesn't need any SIM (not implemented by plugin, or not
          * needed in CDMA-only modems), or if we don't know how to query
          * for SIM slots */
@@ -5652,6 +6262,7 @@ interface_initialization_step (GTask *task)
         /* fall-through */
 
     case INITIALIZATION_STEP_UNLOCK_REQUIRED:
+        mm_trace_step (self, "modem-initialization", "unlock-required");
         /* Only check unlock required if we were previously not unlocked */
         if (mm_gdbus_modem_get_unlock_required (ctx->skeleton) != MM_MODEM_LOCK_NONE) {
             mm_iface_modem_update_lock_info (self,
@@ -5664,6 +6275,7 @@ interface_initialization_step (GTask *task)
         /* fall-through */
 
     case INITIALIZATION_STEP_SIM:
+        mm_trace_step (self, "modem-initialization", "sim");
         /* If the modem doesn't need any SIM (not implemented by plugin, or not
          * needed in CDMA-only modems) */
         if (!mm_iface_modem_is_cdma_only (self) &&
@@ -5696,6 +6308,7 @@ interface_initialization_step (GTask *task)
         /* fall-through */
 
     case INITIALIZATION_STEP_SETUP_CARRIER_CONFIG:
+        mm_trace_step (self, "modem-initialization", "setup-carrier-config");
         /* Setup and perform automatic carrier config switching as soon as the
          * SIM initialization has been performed, only applicable if there is
          * actually a SIM found with a valid IMSI read */
@@ -5739,6 +6352,7 @@ interface_initialization_step (GTask *task)
         /* fall-through */
 
     case INITIALIZATION_STEP_OWN_NUMBERS:
+        mm_trace_step (self, "modem-initialization", "own-numbers");
         /* Own numbers is meant to be loaded only once during the whole
          * lifetime of the modem. Therefore, if we already have them loaded,
          * don't try to load them again. */
@@ -5759,6 +6373,7 @@ interface_initialization_step (GTask *task)
         MMModemMode preferred = MM_MODEM_MODE_NONE;
         GVariant *aux;
 
+        mm_trace_step (self, "modem-initialization", "current-modes");
         aux = mm_gdbus_modem_get_current_modes (ctx->skeleton);
         if (aux)
             g_variant_get (aux, "(uu)", &allowed, &preferred);
@@ -5798,6 +6413,7 @@ interface_initialization_step (GTask *task)
     case INITIALIZATION_STEP_CURRENT_BANDS: {
         GArray *current;
 
+        mm_trace_step (self, "modem-initialization", "current-bands");
         current = (mm_common_bands_variant_to_garray (
                        mm_gdbus_modem_get_current_bands (ctx->skeleton)));
 
@@ -5848,11 +6464,14 @@ interface_initialization_step (GTask *task)
             mm_gdbus_object_skeleton_set_modem (MM_GDBUS_OBJECT_SKELETON (self),
                                                 MM_GDBUS_MODEM (ctx->skeleton));
 
+        mm_trace_end (self, "modem-initialization", NULL);
         if (ctx->fatal_error) {
             g_task_return_error (task, ctx->fatal_error);
             ctx->fatal_error = NULL;
-        } else
+        } else {
+            capability_cache_initialization_done (self);
             g_task_return_boolean (task, TRUE);
+        }
 
         g_object_unref (task);
         return;
@@ -5934,6 +6553,7 @@ mm_iface_modem_initialize (MMIfaceModem *self,
     task = g_task_new (self, NULL, callback, user_data);
     g_task_set_task_data (task, ctx, (GDestroyNotify)initialization_context_free);
 
+    mm_trace_begin (self, "modem-initialization", NULL);
     interface_initialization_step (task);
 }
 
@@ -5958,6 +6578,12 @@ mm_iface_modem_shutdown (MMIfaceModem *self)
                             restart_initialize_idle_quark,
                             NULL);
 
+    /* Remove capability cache context and its pending refresh, if any */
+    if (G_LIKELY (capability_cache_context_quark))
+        g_object_set_qdata (G_OBJECT (self),
+                            capability_cache_context_quark,
+                            NULL);
+
     /* Remove SIM object */
     g_object_set (self,
                   MM_IFACE_MODEM_SIM, NULL,
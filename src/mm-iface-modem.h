@@ -609,6 +609,10 @@ gboolean mm_iface_modem_check_for_sim_swap_finish (MMIfaceModem *self,
                                                    GAsyncResult *res,
                                                    GError **error);
 
+/* Drop the cached properties of the current SIM, whose contents may have
+ * changed (e.g. SIM refresh or hot swap) */
+void     mm_iface_modem_invalidate_sim_cache      (MMIfaceModem *self);
+
 void mm_iface_modem_modify_sim (MMIfaceModem *self,
                                 guint slot_index,
                                 MMBaseSim *new_sim);
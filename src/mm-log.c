@@ -75,8 +75,15 @@ static const LogDesc level_descs[] = {
     { 0, NULL }
 };
 
-static GString *msgbuf = NULL;
-static gsize msgbuf_once = 0;
+/* Logging may also happen from worker threads, so each thread gets its own
+ * message buffer */
+static void
+msgbuf_free (GString *msgbuf)
+{
+    g_string_free (msgbuf, TRUE);
+}
+
+static GPrivate msgbuf_private = G_PRIVATE_INIT ((GDestroyNotify) msgbuf_free);
 
 static int
 mm_to_syslog_priority (MMLogLevel level)
@@ -217,13 +224,15 @@ _mm_log (gpointer     obj,
 {
     va_list args;
     GTimeVal tv;
+    GString *msgbuf;
 
     if (!(log_level & level))
         return;
 
-    if (g_once_init_enter (&msgbuf_once)) {
+    msgbuf = g_private_get (&msgbuf_private);
+    if (!msgbuf) {
         msgbuf = g_string_sized_new (512);
-        g_once_init_leave (&msgbuf_once, 1);
+        g_private_set (&msgbuf_private, msgbuf);
     } else
         g_string_truncate (msgbuf, 0);
 
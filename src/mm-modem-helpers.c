@@ -132,6 +132,62 @@ mm_split_string_groups (const gchar *str)
 
 /*****************************************************************************/
 
+GStrv
+mm_split_compound_at_response (const gchar         *response,
+                               const gchar * const *commands,
+                               GError             **error)
+{
+    g_auto(GStrv)        split = NULL;
+    g_autoptr(GPtrArray) lines = NULL;
+    g_autoptr(GPtrArray) responses = NULL;
+    guint                line = 0;
+    guint                i;
+
+    /* Non-empty lines of the whole response */
+    split = g_strsplit (response ? response : "", "\n", -1);
+    lines = g_ptr_array_new ();
+    for (i = 0; split[i]; i++) {
+        g_strstrip (split[i]);
+        if (split[i][0])
+            g_ptr_array_add (lines, split[i]);
+    }
+
+    responses = g_ptr_array_new_with_free_func (g_free);
+    for (i = 0; commands[i]; i++) {
+        g_autofree gchar *prefix = NULL;
+        GString          *str;
+
+        /* Replies of the command are prefixed with the command name */
+        prefix = g_strdup_printf ("%.*s:", (gint) strcspn (commands[i], "=?"), commands[i]);
+        str = g_string_new (NULL);
+        while (line < lines->len &&
+               !g_ascii_strncasecmp (g_ptr_array_index (lines, line), prefix, strlen (prefix))) {
+            if (str->len)
+                g_string_append (str, "\r\n");
+            g_string_append (str, g_ptr_array_index (lines, line++));
+        }
+
+        /* Except for execution commands like +CGMI, which reply a single line
+         * without prefix */
+        if (!str->len && !strpbrk (commands[i], "=?") && line < lines->len)
+            g_string_append (str, g_ptr_array_index (lines, line++));
+
+        g_ptr_array_add (responses, g_string_free (str, FALSE));
+    }
+
+    if (line < lines->len) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                     "Couldn't match reply line '%s' to any command",
+                     (const gchar *) g_ptr_array_index (lines, line));
+        return NULL;
+    }
+
+    g_ptr_array_add (responses, NULL);
+    return (GStrv) g_ptr_array_free (g_steal_pointer (&responses), FALSE);
+}
+
+/*****************************************************************************/
+
 static int uint_compare_func (gconstpointer a, gconstpointer b)
 {
    return (*(guint *)a - *(guint *)b);
@@ -919,6 +975,28 @@ mm_3gpp_cusd_regex_get (void)
 
 /*************************************************************************/
 
+GRegex *
+mm_3gpp_ctzv_regex_get (void)
+{
+    /* +CTZV: <tz> (AT+CTZR=1) */
+    return g_regex_new ("\\r\\n\\+CTZV:\\s*\"?([\\-\\+]?\\d+)\"?\\r\\n",
+                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                        0,
+                        NULL);
+}
+
+GRegex *
+mm_3gpp_ctze_regex_get (void)
+{
+    /* +CTZE: <tz>,<dst>[,<time>] (AT+CTZR=2) */
+    return g_regex_new ("\\r\\n\\+CTZE:\\s*\"?([\\-\\+]?\\d+)\"?,(\\d+)(?:,[^\\r\\n]*)?\\r\\n",
+                        G_REGEX_RAW | G_REGEX_OPTIMIZE,
+                        0,
+                        NULL);
+}
+
+/*************************************************************************/
+
 GRegex *
 mm_3gpp_cmti_regex_get (void)
 {
@@ -5095,6 +5173,37 @@ mm_parse_cclk_response (const char *response,
     return ret;
 }
 
+/*****************************************************************************/
+/* +CTZV/+CTZE URC parser */
+
+MMNetworkTimezone *
+mm_parse_ctzv_ctze_urc (GMatchInfo  *match_info,
+                        GError     **error)
+{
+    MMNetworkTimezone *tz;
+    gint               offset = 0;
+    guint              dst = 0;
+
+    /* Timezone offset given in 15 minute intervals */
+    if (!mm_get_int_from_match_info (match_info, 1, &offset)) {
+        g_set_error_literal (error,
+                             MM_CORE_ERROR,
+                             MM_CORE_ERROR_FAILED,
+                             "Failed to parse timezone in +CTZV/+CTZE URC");
+        return NULL;
+    }
+
+    tz = mm_network_timezone_new ();
+    mm_network_timezone_set_offset (tz, offset * 15);
+
+    /* The daylight saving adjustment is only given in +CTZE, in hours */
+    if (g_match_info_get_match_count (match_info) >= 3 &&
+        mm_get_uint_from_match_info (match_info, 2, &dst))
+        mm_network_timezone_set_dst_offset (tz, dst * 60);
+
+    return tz;
+}
+
 /*****************************************************************************/
 /* +CSIM response parser */
 #define MM_MIN_SIM_RETRY_HEX 0x63C0
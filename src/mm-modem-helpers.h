@@ -50,6 +50,12 @@ const gchar *mm_strip_tag    (const gchar *str,
 
 gchar **mm_split_string_groups (const gchar *str);
 
+/* Splits the response to a compound command line (commands given without
+ * the AT prefix, sent joined with ';') into the responses to each command */
+GStrv mm_split_compound_at_response (const gchar         *response,
+                                     const gchar * const *commands,
+                                     GError             **error);
+
 GArray *mm_parse_uint_list (const gchar  *str,
                             GError      **error);
 
@@ -143,6 +149,8 @@ GRegex    *mm_3gpp_cgev_regex_get (void);
 GRegex    *mm_3gpp_cusd_regex_get (void);
 GRegex    *mm_3gpp_cmti_regex_get (void);
 GRegex    *mm_3gpp_cds_regex_get (void);
+GRegex    *mm_3gpp_ctzv_regex_get (void);
+GRegex    *mm_3gpp_ctze_regex_get (void);
 
 /* AT+WS46=? response parser: returns array of MMModemMode values */
 GArray *mm_3gpp_parse_ws46_test_response (const gchar  *response,
@@ -534,6 +542,10 @@ gboolean mm_parse_cclk_response (const gchar *response,
                                  MMNetworkTimezone **tzp,
                                  GError **error);
 
+/* +CTZV/+CTZE URC parser, given a match of the 3GPP regexes */
+MMNetworkTimezone *mm_parse_ctzv_ctze_urc (GMatchInfo  *match_info,
+                                           GError     **error);
+
 /* +CSIM response parser */
 gint mm_parse_csim_response (const gchar *response,
                                    GError **error);
@@ -17,8 +17,10 @@
  * Copyright (C) 2021 Aleksander Morgado <aleksander@aleksander.es>
  */
 
+#include <errno.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
+#include <linux/if_link.h>
 #include <net/if.h>
 #include <sys/socket.h>
 #include <sys/types.h>
@@ -37,9 +39,23 @@ struct _MMNetlink {
     /* Netlink socket */
     GSocket *socket;
     GSource *source;
+    /* Port id assigned by the kernel to the socket, 0 until known */
+    guint32  port_id;
     /* Netlink state */
     guint       current_sequence_id;
     GHashTable *transactions;
+    /* Ongoing link dump, and pending link stats requests served by it */
+    gpointer    link_dump;
+    gboolean    link_dump_again;
+    GList      *link_stats_tasks;
+    /* Link state cache, kept up to date with RTMGRP_LINK notifications */
+    gboolean    links_subscribed;
+    GHashTable *links;
+    gboolean    links_synced;
+    /* Pending link appearance waits */
+    GList      *link_waits;
+    /* Fake objects get messages injected instead of read from a socket */
+    gboolean    fake;
 };
 
 struct _MMNetlinkClass {
@@ -51,6 +67,14 @@ static void log_object_iface_init (MMLogObjectInterface *iface);
 G_DEFINE_TYPE_EXTENDED (MMNetlink, mm_netlink, G_TYPE_OBJECT, 0,
                         G_IMPLEMENT_INTERFACE (MM_TYPE_LOG_OBJECT, log_object_iface_init))
 
+enum {
+    PROP_0,
+    PROP_FAKE,
+    PROP_LAST
+};
+
+static GParamSpec *properties[PROP_LAST];
+
 
 /*****************************************************************************/
 /*
@@ -162,6 +186,23 @@ netlink_message_new_setlink (guint    ifindex,
     return msg;
 }
 
+static NetlinkMessage *
+netlink_message_new_getlink_dump (void)
+{
+    NetlinkMessage *msg;
+    NetlinkHeader  *hdr;
+
+    msg = netlink_message_new (0, RTM_GETLINK);
+    hdr = netlink_message_header (msg);
+
+    /* A dump request reports all links in the system in a single transaction,
+     * ACK is implicit in the NLMSG_DONE message */
+    hdr->msghdr.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    hdr->ifreq.ifi_change = 0;
+
+    return msg;
+}
+
 static void
 netlink_message_free (NetlinkMessage *msg)
 {
@@ -169,88 +210,390 @@ netlink_message_free (NetlinkMessage *msg)
 }
 
 /*****************************************************************************/
-/* Netlink transactions */
+/* Link state cache */
+
+enum {
+    SIGNAL_LINK_UPDATED,
+    SIGNAL_LINK_REMOVED,
+    SIGNAL_LAST
+};
+
+static guint signals[SIGNAL_LAST];
+
+static void
+link_info_free (MMNetlinkLinkInfo *info)
+{
+    g_free (info->ifname);
+    g_slice_free (MMNetlinkLinkInfo, info);
+}
+
+/* Only rmnet links report the mux id they were created with */
+static guint
+link_info_parse_mux_id (struct rtattr *linkinfo)
+{
+    struct rtattr    *attr;
+    gint              attr_len;
+    struct rtattr    *data = NULL;
+    g_autofree gchar *kind = NULL;
+
+    attr_len = RTA_PAYLOAD (linkinfo);
+    for (attr = RTA_DATA (linkinfo); RTA_OK (attr, attr_len); attr = RTA_NEXT (attr, attr_len)) {
+        if (attr->rta_type == IFLA_INFO_KIND && !kind)
+            kind = g_strndup ((const gchar *) RTA_DATA (attr), RTA_PAYLOAD (attr));
+        else if (attr->rta_type == IFLA_INFO_DATA)
+            data = attr;
+    }
+
+    if (!data || g_strcmp0 (kind, "rmnet") != 0)
+        return 0;
+
+    attr_len = RTA_PAYLOAD (data);
+    for (attr = RTA_DATA (data); RTA_OK (attr, attr_len); attr = RTA_NEXT (attr, attr_len)) {
+        if (attr->rta_type == IFLA_RMNET_MUX_ID && RTA_PAYLOAD (attr) >= sizeof (guint16)) {
+            guint16 mux_id;
+
+            memcpy (&mux_id, RTA_DATA (attr), sizeof (mux_id));
+            return mux_id;
+        }
+    }
+    return 0;
+}
+
+static MMNetlinkLinkInfo *
+link_info_new_from_message (struct nlmsghdr *hdr,
+                            gboolean        *has_stats)
+{
+    struct ifinfomsg  *ifinfo;
+    struct rtattr     *attr;
+    gint               attr_len;
+    MMNetlinkLinkInfo *info;
+
+    if (hdr->nlmsg_len < NLMSG_LENGTH (sizeof (struct ifinfomsg)))
+        return NULL;
+
+    ifinfo = NLMSG_DATA (hdr);
+
+    info = g_slice_new0 (MMNetlinkLinkInfo);
+    info->ifindex = ifinfo->ifi_index;
+    info->flags = ifinfo->ifi_flags;
+    info->stats.ifindex = ifinfo->ifi_index;
+
+    attr_len = IFLA_PAYLOAD (hdr);
+    for (attr = IFLA_RTA (ifinfo); RTA_OK (attr, attr_len); attr = RTA_NEXT (attr, attr_len)) {
+        switch (attr->rta_type) {
+        case IFLA_IFNAME:
+            if (!info->ifname && RTA_PAYLOAD (attr) > 0)
+                info->ifname = g_strndup ((const gchar *) RTA_DATA (attr), MIN (RTA_PAYLOAD (attr), IFNAMSIZ));
+            break;
+        case IFLA_MTU:
+            if (RTA_PAYLOAD (attr) >= sizeof (guint32)) {
+                guint32 mtu;
+
+                memcpy (&mtu, RTA_DATA (attr), sizeof (mtu));
+                info->mtu = mtu;
+            }
+            break;
+        case IFLA_STATS64:
+            if (RTA_PAYLOAD (attr) >= sizeof (struct rtnl_link_stats64)) {
+                struct rtnl_link_stats64 stats64;
+
+                /* the attribute payload may not be 64bit aligned */
+                memcpy (&stats64, RTA_DATA (attr), sizeof (stats64));
+                info->stats.rx_bytes = stats64.rx_bytes;
+                info->stats.tx_bytes = stats64.tx_bytes;
+                info->stats.rx_packets = stats64.rx_packets;
+                info->stats.tx_packets = stats64.tx_packets;
+                if (has_stats)
+                    *has_stats = TRUE;
+            }
+            break;
+        case IFLA_LINKINFO:
+            info->mux_id = link_info_parse_mux_id (attr);
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (!info->ifname) {
+        link_info_free (info);
+        return NULL;
+    }
+
+    return info;
+}
+
+static void link_waits_process (MMNetlink               *self,
+                                const MMNetlinkLinkInfo *info);
+
+static void
+links_update (MMNetlink       *self,
+              struct nlmsghdr *hdr)
+{
+    MMNetlinkLinkInfo *info;
+    MMNetlinkLinkInfo *existing;
+    gboolean           changed;
+
+    info = link_info_new_from_message (hdr, NULL);
+    if (!info)
+        return;
+
+    /* Stats-only updates are not notified */
+    existing = g_hash_table_lookup (self->links, GUINT_TO_POINTER (info->ifindex));
+    changed = (!existing ||
+               existing->flags != info->flags ||
+               existing->mtu != info->mtu ||
+               existing->mux_id != info->mux_id ||
+               g_strcmp0 (existing->ifname, info->ifname) != 0);
+
+    g_hash_table_replace (self->links, GUINT_TO_POINTER (info->ifindex), info);
+
+    if (changed) {
+        g_signal_emit (self, signals[SIGNAL_LINK_UPDATED], 0, info->ifindex, info->ifname);
+        link_waits_process (self, info);
+    }
+}
+
+static void
+links_remove (MMNetlink       *self,
+              struct nlmsghdr *hdr)
+{
+    struct ifinfomsg  *ifinfo;
+    MMNetlinkLinkInfo *info;
+
+    if (hdr->nlmsg_len < NLMSG_LENGTH (sizeof (struct ifinfomsg)))
+        return;
+
+    ifinfo = NLMSG_DATA (hdr);
+    info = g_hash_table_lookup (self->links, GUINT_TO_POINTER (ifinfo->ifi_index));
+    if (!info)
+        return;
+    g_hash_table_steal (self->links, GUINT_TO_POINTER (ifinfo->ifi_index));
+
+    g_signal_emit (self, signals[SIGNAL_LINK_REMOVED], 0, info->ifindex, info->ifname);
+    link_info_free (info);
+}
+
+const MMNetlinkLinkInfo *
+mm_netlink_peek_link_info (MMNetlink *self,
+                           guint      ifindex)
+{
+    if (!self->links_synced)
+        return NULL;
+    return g_hash_table_lookup (self->links, GUINT_TO_POINTER (ifindex));
+}
+
+const MMNetlinkLinkInfo *
+mm_netlink_peek_link_info_by_name (MMNetlink   *self,
+                                   const gchar *ifname)
+{
+    GHashTableIter     iter;
+    MMNetlinkLinkInfo *info;
+
+    if (!self->links_synced)
+        return NULL;
+
+    g_hash_table_iter_init (&iter, self->links);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &info)) {
+        if (g_strcmp0 (info->ifname, ifname) == 0)
+            return info;
+    }
+    return NULL;
+}
+
+gboolean
+mm_netlink_is_link_cache_synced (MMNetlink *self)
+{
+    return self->links_synced;
+}
+
+/*****************************************************************************/
+/* Link appearance waits */
 
 typedef struct {
-    MMNetlink *self;
-    guint32    sequence_id;
-    GSource   *timeout_source;
-    GTask     *completion_task;
-} Transaction;
+    gchar   *ifname;
+    guint    mux_id;
+    GSource *timeout_source;
+} WaitLinkContext;
 
-static gboolean
-transaction_timed_out (Transaction *tr)
+static void
+wait_link_context_free (WaitLinkContext *ctx)
 {
-    GTask *task;
-    guint32 sequence_id;
+    g_assert (!ctx->timeout_source);
+    g_free (ctx->ifname);
+    g_slice_free (WaitLinkContext, ctx);
+}
 
-    task = g_steal_pointer (&tr->completion_task);
-    sequence_id = tr->sequence_id;
+guint
+mm_netlink_wait_link_finish (MMNetlink     *self,
+                             GAsyncResult  *res,
+                             GError       **error)
+{
+    gssize ifindex;
 
-    g_hash_table_remove (tr->self->transactions,
-                         GUINT_TO_POINTER (tr->sequence_id));
+    ifindex = g_task_propagate_int (G_TASK (res), error);
+    return (ifindex > 0 ? (guint) ifindex : 0);
+}
 
-    g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_TIMED_OUT,
-                             "Netlink message with sequence ID %u timed out",
-                             sequence_id);
+static gboolean
+link_wait_matches (MMNetlink               *self,
+                   WaitLinkContext         *ctx,
+                   const MMNetlinkLinkInfo *info)
+{
+    if (g_strcmp0 (ctx->ifname, info->ifname) != 0)
+        return FALSE;
 
-    g_object_unref (task);
-    return G_SOURCE_REMOVE;
+    /* The mux id is not known for all link types; when it is, it must match,
+     * so that a stale link with the same name is not taken as the new one */
+    if (ctx->mux_id && info->mux_id && ctx->mux_id != info->mux_id) {
+        mm_obj_dbg (self, "link %s found with unexpected mux id %u (expected %u)",
+                    info->ifname, info->mux_id, ctx->mux_id);
+        return FALSE;
+    }
+    return TRUE;
 }
 
 static void
-transaction_complete_with_error (Transaction *tr,
-                                 GError      *error)
+link_wait_complete (MMNetlink *self,
+                    GTask     *task,
+                    guint      ifindex,
+                    GError    *error)
 {
-    GTask *task;
+    WaitLinkContext *ctx;
 
-    task = g_steal_pointer (&tr->completion_task);
+    ctx = g_task_get_task_data (task);
 
-    g_hash_table_remove (tr->self->transactions,
-                         GUINT_TO_POINTER (tr->sequence_id));
+    self->link_waits = g_list_remove (self->link_waits, task);
+    g_source_destroy (ctx->timeout_source);
+    g_clear_pointer (&ctx->timeout_source, g_source_unref);
 
-    g_task_return_error (task, error);
+    if (error)
+        g_task_return_error (task, error);
+    else
+        g_task_return_int (task, ifindex);
     g_object_unref (task);
 }
 
 static void
-transaction_complete (Transaction *tr,
-                      gint         saved_errno)
+link_waits_process (MMNetlink               *self,
+                    const MMNetlinkLinkInfo *info)
 {
-    GTask *task;
-    guint32 sequence_id;
+    GList *l;
+    GList *matched = NULL;
 
-    task = g_steal_pointer (&tr->completion_task);
-    sequence_id = tr->sequence_id;
+    /* Completions may trigger new waits, so don't process the list in place */
+    for (l = self->link_waits; l; l = g_list_next (l)) {
+        if (link_wait_matches (self, g_task_get_task_data (G_TASK (l->data)), info))
+            matched = g_list_prepend (matched, l->data);
+    }
 
-    g_hash_table_remove (tr->self->transactions,
-                         GUINT_TO_POINTER (tr->sequence_id));
+    for (l = matched; l; l = g_list_next (l)) {
+        mm_obj_dbg (self, "link %s appeared (ifindex %u)", info->ifname, info->ifindex);
+        link_wait_complete (self, G_TASK (l->data), info->ifindex, NULL);
+    }
+    g_list_free (matched);
+}
 
-    if (!saved_errno) {
-        g_task_return_boolean (task, TRUE);
-    } else {
-        g_task_return_new_error (task, G_IO_ERROR, g_io_error_from_errno (saved_errno),
-                                 "Netlink message with transaction %u failed",
-                                 sequence_id);
+static gboolean
+wait_link_timed_out (GTask *task)
+{
+    MMNetlink       *self;
+    WaitLinkContext *ctx;
+
+    self = g_task_get_source_object (task);
+    ctx  = g_task_get_task_data (task);
+
+    link_wait_complete (self,
+                        task,
+                        0,
+                        g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_NOT_FOUND,
+                                     "Timed out waiting for link %s", ctx->ifname));
+    return G_SOURCE_REMOVE;
+}
+
+void
+mm_netlink_wait_link (MMNetlink           *self,
+                      const gchar         *ifname,
+                      guint                mux_id,
+                      guint                timeout_ms,
+                      GAsyncReadyCallback  callback,
+                      gpointer             user_data)
+{
+    GTask                   *task;
+    WaitLinkContext         *ctx;
+    const MMNetlinkLinkInfo *info;
+
+    task = g_task_new (self, NULL, callback, user_data);
+
+    if (!self->links_subscribed) {
+        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_UNSUPPORTED,
+                                 "link notifications not available");
+        g_object_unref (task);
+        return;
     }
 
-    g_object_unref (task);
+    ctx = g_slice_new0 (WaitLinkContext);
+    ctx->ifname = g_strdup (ifname);
+    ctx->mux_id = mux_id;
+    g_task_set_task_data (task, ctx, (GDestroyNotify) wait_link_context_free);
+
+    /* The link may already be known */
+    info = mm_netlink_peek_link_info_by_name (self, ifname);
+    if (info && link_wait_matches (self, ctx, info)) {
+        g_task_return_int (task, info->ifindex);
+        g_object_unref (task);
+        return;
+    }
+
+    ctx->timeout_source = g_timeout_source_new (timeout_ms);
+    g_source_set_callback (ctx->timeout_source, (GSourceFunc) wait_link_timed_out, task, NULL);
+    g_source_attach (ctx->timeout_source, g_main_context_get_thread_default ());
+
+    /* The task is owned by the list of pending waits */
+    self->link_waits = g_list_append (self->link_waits, task);
 }
 
+/*****************************************************************************/
+/* Netlink transactions */
+
+typedef struct _RunBatchContext RunBatchContext;
+
+typedef struct {
+    MMNetlink       *self;
+    guint32          sequence_id;
+    /* Either part of a batch, or the link dump transaction */
+    RunBatchContext *batch;
+    GSource         *timeout_source;
+    GHashTable      *link_stats;
+} Transaction;
+
+struct _RunBatchContext {
+    MMNetlink *self;
+    GTask     *task;
+    guint32    first_sequence_id;
+    guint      n_messages;
+    guint      n_pending;
+    GError    *error;
+    GSource   *timeout_source;
+};
+
+static void link_dump_start (MMNetlink *self);
+
 static void
 transaction_free (Transaction *tr)
 {
-    g_assert (tr->completion_task == NULL);
-    g_source_destroy (tr->timeout_source);
-    g_source_unref (tr->timeout_source);
+    if (tr->timeout_source) {
+        g_source_destroy (tr->timeout_source);
+        g_source_unref (tr->timeout_source);
+    }
+    if (tr->link_stats)
+        g_hash_table_unref (tr->link_stats);
     g_slice_free (Transaction, tr);
 }
 
 static Transaction *
 transaction_new (MMNetlink      *self,
-                 NetlinkMessage *msg,
-                 guint           timeout,
-                 GTask          *task)
+                 NetlinkMessage *msg)
 {
     Transaction *tr;
 
@@ -258,16 +601,6 @@ transaction_new (MMNetlink      *self,
     tr->self = self;
     tr->sequence_id = ++self->current_sequence_id;
     netlink_message_header (msg)->msghdr.nlmsg_seq = tr->sequence_id;
-    if (timeout) {
-        tr->timeout_source = g_timeout_source_new_seconds (timeout);
-        g_source_set_callback (tr->timeout_source,
-                               (GSourceFunc) transaction_timed_out,
-                               tr,
-                               NULL);
-        g_source_attach (tr->timeout_source,
-                         g_main_context_get_thread_default ());
-    }
-    tr->completion_task = g_object_ref (task);
 
     g_hash_table_insert (self->transactions,
                          GUINT_TO_POINTER (tr->sequence_id),
@@ -275,6 +608,274 @@ transaction_new (MMNetlink      *self,
     return tr;
 }
 
+static void
+link_stats_tasks_complete (MMNetlink    *self,
+                           GHashTable   *link_stats,
+                           const GError *error)
+{
+    GList *tasks;
+    GList *l;
+
+    tasks = g_steal_pointer (&self->link_stats_tasks);
+    for (l = tasks; l; l = g_list_next (l)) {
+        GTask *task = G_TASK (l->data);
+
+        if (error)
+            g_task_return_error (task, g_error_copy (error));
+        else
+            g_task_return_pointer (task, g_hash_table_ref (link_stats), (GDestroyNotify) g_hash_table_unref);
+        g_object_unref (task);
+    }
+    g_list_free (tasks);
+}
+
+static void
+link_dump_complete (Transaction *tr,
+                    GError      *error)
+{
+    MMNetlink  *self;
+    GHashTable *link_stats;
+
+    self = tr->self;
+    g_assert (self->link_dump == tr);
+    self->link_dump = NULL;
+
+    link_stats = g_hash_table_ref (tr->link_stats);
+    g_hash_table_remove (self->transactions, GUINT_TO_POINTER (tr->sequence_id));
+
+    if (error)
+        mm_obj_dbg (self, "link dump failed: %s", error->message);
+    else if (!self->link_dump_again) {
+        if (!self->links_synced)
+            mm_obj_dbg (self, "link cache synced: %u links", g_hash_table_size (self->links));
+        self->links_synced = TRUE;
+    }
+
+    link_stats_tasks_complete (self, link_stats, error);
+    g_hash_table_unref (link_stats);
+    g_clear_error (&error);
+
+    if (self->link_dump_again) {
+        self->link_dump_again = FALSE;
+        g_hash_table_remove_all (self->links);
+        link_dump_start (self);
+    }
+}
+
+static void
+run_batch_context_complete (RunBatchContext *ctx)
+{
+    if (ctx->error)
+        g_task_return_error (ctx->task, ctx->error);
+    else
+        g_task_return_boolean (ctx->task, TRUE);
+    g_object_unref (ctx->task);
+
+    g_source_destroy (ctx->timeout_source);
+    g_source_unref (ctx->timeout_source);
+    g_slice_free (RunBatchContext, ctx);
+}
+
+static void
+batch_transaction_complete (Transaction *tr,
+                            GError      *error)
+{
+    RunBatchContext *ctx;
+
+    ctx = tr->batch;
+    g_hash_table_remove (tr->self->transactions, GUINT_TO_POINTER (tr->sequence_id));
+
+    /* The first error found is the one reported */
+    if (error) {
+        if (!ctx->error)
+            ctx->error = error;
+        else
+            g_error_free (error);
+    }
+
+    g_assert (ctx->n_pending > 0);
+    if (--ctx->n_pending == 0)
+        run_batch_context_complete (ctx);
+}
+
+static void
+transaction_complete_with_error (Transaction *tr,
+                                 GError      *error)
+{
+    if (tr->batch)
+        batch_transaction_complete (tr, error);
+    else
+        link_dump_complete (tr, error);
+}
+
+static void
+transaction_complete (Transaction *tr,
+                      gint         saved_errno)
+{
+    transaction_complete_with_error (tr,
+                                     saved_errno ?
+                                     g_error_new (G_IO_ERROR, g_io_error_from_errno (saved_errno),
+                                                  "Netlink message with transaction %u failed",
+                                                  tr->sequence_id) :
+                                     NULL);
+}
+
+static gboolean
+netlink_send (MMNetlink     *self,
+              GByteArray    *buffer,
+              GCancellable  *cancellable,
+              GError       **error)
+{
+    gssize bytes_sent;
+
+    bytes_sent = g_socket_send (self->socket,
+                                (const gchar *) buffer->data,
+                                buffer->len,
+                                cancellable,
+                                error);
+    return (bytes_sent >= 0);
+}
+
+/*****************************************************************************/
+/* Batches */
+
+struct _MMNetlinkBatch {
+    GPtrArray *messages;
+};
+
+MMNetlinkBatch *
+mm_netlink_batch_new (void)
+{
+    MMNetlinkBatch *batch;
+
+    batch = g_slice_new0 (MMNetlinkBatch);
+    batch->messages = g_ptr_array_new_with_free_func ((GDestroyNotify) netlink_message_free);
+    return batch;
+}
+
+void
+mm_netlink_batch_free (MMNetlinkBatch *batch)
+{
+    g_ptr_array_unref (batch->messages);
+    g_slice_free (MMNetlinkBatch, batch);
+}
+
+void
+mm_netlink_batch_add_setlink (MMNetlinkBatch *batch,
+                              guint           ifindex,
+                              gboolean        up,
+                              guint           mtu)
+{
+    g_ptr_array_add (batch->messages, netlink_message_new_setlink (ifindex, up, mtu));
+}
+
+gboolean
+mm_netlink_run_batch_finish (MMNetlink     *self,
+                             GAsyncResult  *res,
+                             GError       **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+static gboolean
+run_batch_timed_out (RunBatchContext *ctx)
+{
+    guint i;
+
+    /* The context is gone as soon as the last pending transaction completes */
+    for (i = 0; i < ctx->n_messages; i++) {
+        Transaction *tr;
+        gboolean     last;
+
+        tr = g_hash_table_lookup (ctx->self->transactions,
+                                  GUINT_TO_POINTER (ctx->first_sequence_id + i));
+        if (!tr || tr->batch != ctx)
+            continue;
+
+        last = (ctx->n_pending == 1);
+        batch_transaction_complete (tr,
+                                    g_error_new (G_IO_ERROR, G_IO_ERROR_TIMED_OUT,
+                                                 "Netlink message with sequence ID %u timed out",
+                                                 tr->sequence_id));
+        if (last)
+            break;
+    }
+    return G_SOURCE_REMOVE;
+}
+
+void
+mm_netlink_run_batch (MMNetlink           *self,
+                      MMNetlinkBatch      *batch,
+                      GCancellable        *cancellable,
+                      GAsyncReadyCallback  callback,
+                      gpointer             user_data)
+{
+    RunBatchContext      *ctx;
+    GTask                *task;
+    g_autoptr(GByteArray) buffer = NULL;
+    GError               *error = NULL;
+    guint                 i;
+
+    task = g_task_new (self, cancellable, callback, user_data);
+
+    if (!self->socket) {
+        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                                 "netlink support not available");
+        g_object_unref (task);
+        return;
+    }
+
+    if (!batch->messages->len) {
+        g_task_return_boolean (task, TRUE);
+        g_object_unref (task);
+        return;
+    }
+
+    /* The task ownership is transferred to the context, which is completed
+     * once all transactions in the batch have been acknowledged */
+    ctx = g_slice_new0 (RunBatchContext);
+    ctx->self = self;
+    ctx->task = task;
+    ctx->n_messages = batch->messages->len;
+    ctx->timeout_source = g_timeout_source_new_seconds (5);
+    g_source_set_callback (ctx->timeout_source, (GSourceFunc) run_batch_timed_out, ctx, NULL);
+    g_source_attach (ctx->timeout_source, g_main_context_get_thread_default ());
+
+    /* All messages are sent in a single datagram, and the replies are matched
+     * to each of them by sequence id */
+    buffer = g_byte_array_new ();
+    for (i = 0; i < batch->messages->len; i++) {
+        NetlinkMessage *msg;
+        Transaction    *tr;
+
+        msg = g_ptr_array_index (batch->messages, i);
+        tr = transaction_new (self, msg);
+        tr->batch = ctx;
+        if (i == 0)
+            ctx->first_sequence_id = tr->sequence_id;
+        ctx->n_pending++;
+
+        g_byte_array_set_size (buffer, NLMSG_ALIGN (buffer->len));
+        g_byte_array_append (buffer, msg->data, msg->len);
+    }
+
+    if (!netlink_send (self, buffer, cancellable, &error)) {
+        /* Completes the context with the last transaction */
+        for (i = 0; i < ctx->n_messages; i++) {
+            Transaction *tr;
+            gboolean     last;
+
+            tr = g_hash_table_lookup (self->transactions, GUINT_TO_POINTER (ctx->first_sequence_id + i));
+            g_assert (tr && tr->batch == ctx);
+            last = (ctx->n_pending == 1);
+            batch_transaction_complete (tr, g_error_copy (error));
+            if (last)
+                break;
+        }
+        g_error_free (error);
+    }
+}
+
 /*****************************************************************************/
 
 gboolean
@@ -282,7 +883,7 @@ mm_netlink_setlink_finish (MMNetlink     *self,
                            GAsyncResult  *res,
                            GError       **error)
 {
-    return g_task_propagate_boolean (G_TASK (res), error);
+    return mm_netlink_run_batch_finish (self, res, error);
 }
 
 void
@@ -294,12 +895,82 @@ mm_netlink_setlink (MMNetlink           *self,
                     GAsyncReadyCallback  callback,
                     gpointer             user_data)
 {
-    GTask          *task;
+    g_autoptr(MMNetlinkBatch) batch = NULL;
+
+    batch = mm_netlink_batch_new ();
+    mm_netlink_batch_add_setlink (batch, ifindex, up, mtu);
+    mm_netlink_run_batch (self, batch, cancellable, callback, user_data);
+}
+
+/*****************************************************************************/
+
+static gboolean
+link_dump_timed_out (Transaction *tr)
+{
+    /* The timeout source is destroyed along with the transaction */
+    link_dump_complete (tr,
+                        g_error_new (G_IO_ERROR, G_IO_ERROR_TIMED_OUT,
+                                     "Netlink message with sequence ID %u timed out",
+                                     tr->sequence_id));
+    return G_SOURCE_REMOVE;
+}
+
+static void
+link_dump_start (MMNetlink *self)
+{
     NetlinkMessage *msg;
     Transaction    *tr;
-    gssize          bytes_sent;
     GError         *error = NULL;
 
+    g_assert (!self->link_dump);
+
+    msg = netlink_message_new_getlink_dump ();
+
+    /* The completion is reported to all link stats tasks pending, and
+     * the link cache is updated with each link reported */
+    tr = transaction_new (self, msg);
+    tr->link_stats = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    tr->timeout_source = g_timeout_source_new_seconds (5);
+    g_source_set_callback (tr->timeout_source, (GSourceFunc) link_dump_timed_out, tr, NULL);
+    g_source_attach (tr->timeout_source, g_main_context_get_thread_default ());
+    self->link_dump = tr;
+
+    if (!netlink_send (self, msg, NULL, &error))
+        link_dump_complete (tr, error);
+    netlink_message_free (msg);
+}
+
+static void
+links_resync (MMNetlink *self)
+{
+    self->links_synced = FALSE;
+
+    /* The ongoing dump may have missed updates, so request a new one */
+    if (self->link_dump) {
+        self->link_dump_again = TRUE;
+        return;
+    }
+
+    g_hash_table_remove_all (self->links);
+    link_dump_start (self);
+}
+
+GHashTable *
+mm_netlink_get_link_stats_finish (MMNetlink     *self,
+                                  GAsyncResult  *res,
+                                  GError       **error)
+{
+    return g_task_propagate_pointer (G_TASK (res), error);
+}
+
+void
+mm_netlink_get_link_stats (MMNetlink           *self,
+                           GCancellable        *cancellable,
+                           GAsyncReadyCallback  callback,
+                           gpointer             user_data)
+{
+    GTask *task;
+
     task = g_task_new (self, cancellable, callback, user_data);
 
     if (!self->socket) {
@@ -309,36 +980,114 @@ mm_netlink_setlink (MMNetlink           *self,
         return;
     }
 
-    msg = netlink_message_new_setlink (ifindex, up, mtu);
-
-    /* The task ownership is transferred to the transaction. */
-    tr = transaction_new (self, msg, 5, task);
+    /* If there is already a dump ongoing, this request will be completed
+     * with the same results. This allows serving the stats requests of all
+     * connected bearers with a single kernel round trip. */
+    self->link_stats_tasks = g_list_append (self->link_stats_tasks, task);
+    if (!self->link_dump)
+        link_dump_start (self);
+}
 
-    bytes_sent = g_socket_send (self->socket,
-                                (const gchar *) msg->data,
-                                msg->len,
-                                cancellable,
-                                &error);
-    netlink_message_free (msg);
+static void
+transaction_add_link_stats (Transaction     *tr,
+                            struct nlmsghdr *hdr)
+{
+    MMNetlinkLinkInfo  *info;
+    MMNetlinkLinkStats *link_stats;
+    gboolean            has_stats = FALSE;
 
-    if (bytes_sent < 0)
-        transaction_complete_with_error (tr, error);
+    info = link_info_new_from_message (hdr, &has_stats);
+    if (!info)
+        return;
 
-    g_object_unref (task);
+    /* Links without stats are not accounted by the kernel, ignore them */
+    if (has_stats) {
+        link_stats = g_new (MMNetlinkLinkStats, 1);
+        *link_stats = info->stats;
+        g_hash_table_replace (tr->link_stats, g_steal_pointer (&info->ifname), link_stats);
+    }
+    link_info_free (info);
 }
 
 /*****************************************************************************/
 
+/* Link dumps are sent by the kernel in multipart messages of up to 32KB */
+#define NETLINK_RECEIVE_BUFFER_SIZE 32768
+
+/* Link notifications may come in bursts, e.g. when several mux links are
+ * created at once, so make sure the socket can hold them */
+#define NETLINK_SOCKET_RECEIVE_BUFFER_SIZE (256 * 1024)
+
+static guint32
+socket_peek_port_id (MMNetlink *self)
+{
+    struct sockaddr_nl addr;
+    socklen_t          addr_len = sizeof (addr);
+
+    /* Assigned when binding or, if that failed, when sending the first
+     * message */
+    if (!self->port_id && self->socket &&
+        getsockname (g_socket_get_fd (self->socket), (struct sockaddr *) &addr, &addr_len) == 0)
+        self->port_id = addr.nl_pid;
+    return self->port_id;
+}
+
+static void
+netlink_process_buffer (MMNetlink *self,
+                        gchar     *buf,
+                        guint      buffer_len)
+{
+    struct nlmsghdr *hdr;
+
+    for (hdr = (struct nlmsghdr *) buf; NLMSG_OK (hdr, buffer_len);
+         hdr = NLMSG_NEXT (hdr, buffer_len)) {
+        Transaction     *tr;
+        struct nlmsgerr *err;
+
+        /* Both link dump results and RTMGRP_LINK notifications update
+         * the link cache */
+        if (hdr->nlmsg_type == RTM_NEWLINK)
+            links_update (self, hdr);
+        else if (hdr->nlmsg_type == RTM_DELLINK)
+            links_remove (self, hdr);
+
+        /* Notifications triggered by other processes carry their own port
+         * id and sequence id, which may collide with ours; only the messages
+         * addressed to our socket may complete transactions */
+        if (hdr->nlmsg_pid != socket_peek_port_id (self))
+            continue;
+
+        tr = g_hash_table_lookup (self->transactions,
+                                  GUINT_TO_POINTER (hdr->nlmsg_seq));
+        if (!tr)
+            continue;
+
+        switch (hdr->nlmsg_type) {
+        case RTM_NEWLINK:
+            if (tr->link_stats)
+                transaction_add_link_stats (tr, hdr);
+            break;
+        case NLMSG_DONE:
+            transaction_complete (tr, 0);
+            break;
+        case NLMSG_ERROR:
+            err = NLMSG_DATA (hdr);
+            transaction_complete (tr, -err->error);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
 static gboolean
 netlink_message_cb (GSocket      *socket,
                     GIOCondition  condition,
                     MMNetlink    *self)
 {
     g_autoptr(GError) error = NULL;
-    gchar             buf[512];
+    gchar             buf[NETLINK_RECEIVE_BUFFER_SIZE];
     gssize            bytes_received;
-    guint             buffer_len;
-    struct nlmsghdr  *hdr;
 
     if (condition & G_IO_HUP || condition & G_IO_ERR) {
         mm_obj_warn (self, "socket connection closed");
@@ -347,27 +1096,19 @@ netlink_message_cb (GSocket      *socket,
 
     bytes_received = g_socket_receive (socket, buf, sizeof (buf), NULL, &error);
     if (bytes_received < 0) {
+        if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK))
+            return G_SOURCE_CONTINUE;
+        /* ENOBUFS: notifications were lost, the socket is still usable */
+        if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_NO_SPACE)) {
+            mm_obj_dbg (self, "link notifications lost: resyncing link cache");
+            links_resync (self);
+            return G_SOURCE_CONTINUE;
+        }
         mm_obj_warn (self, "socket i/o failure: %s", error->message);
         return G_SOURCE_REMOVE;
     }
 
-    buffer_len = (guint) bytes_received;
-    for (hdr = (struct nlmsghdr *) buf; NLMSG_OK (hdr, buffer_len);
-         NLMSG_NEXT (hdr, buffer_len)) {
-        Transaction     *tr;
-        struct nlmsgerr *err;
-
-        if (hdr->nlmsg_type != NLMSG_ERROR)
-            continue;
-
-        tr = g_hash_table_lookup (self->transactions,
-                                  GUINT_TO_POINTER (hdr->nlmsg_seq));
-        if (!tr)
-            continue;
-
-        err = NLMSG_DATA (buf);
-        transaction_complete (tr, err->error);
-    }
+    netlink_process_buffer (self, buf, (guint) bytes_received);
     return G_SOURCE_CONTINUE;
 }
 
@@ -375,7 +1116,12 @@ static gboolean
 setup_netlink_socket (MMNetlink  *self,
                       GError    **error)
 {
-    gint socket_fd;
+    gint               socket_fd;
+    gint               rcvbuf = NETLINK_SOCKET_RECEIVE_BUFFER_SIZE;
+    struct sockaddr_nl addr = {
+        .nl_family = AF_NETLINK,
+        .nl_groups = RTMGRP_LINK,
+    };
 
     socket_fd = socket (AF_NETLINK, SOCK_DGRAM, NETLINK_ROUTE);
     if (socket_fd < 0) {
@@ -384,6 +1130,16 @@ setup_netlink_socket (MMNetlink  *self,
         return FALSE;
     }
 
+    /* Subscribe to link notifications, used to keep the link cache up to date.
+     * Not fatal, the link cache will just never be available. */
+    if (bind (socket_fd, (struct sockaddr *) &addr, sizeof (addr)) < 0)
+        mm_obj_warn (self, "couldn't subscribe to link notifications: %s", g_strerror (errno));
+    else
+        self->links_subscribed = TRUE;
+
+    if (setsockopt (socket_fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof (rcvbuf)) < 0)
+        mm_obj_dbg (self, "couldn't increase socket receive buffer size: %s", g_strerror (errno));
+
     self->socket = g_socket_new_from_fd (socket_fd, error);
     if (!self->socket) {
         close (socket_fd);
@@ -412,21 +1168,104 @@ log_object_build_id (MMLogObject *_self)
 
 /********************************************************************/
 
+void
+mm_netlink_fake_receive (MMNetlink     *self,
+                         gconstpointer  data,
+                         gsize          len)
+{
+    g_autofree gchar *buf = NULL;
+
+    g_assert (self->fake);
+
+    /* Processed from a copy, as the parser walks the buffer in place */
+    buf = g_memdup (data, len);
+    netlink_process_buffer (self, buf, (guint) len);
+}
+
+MMNetlink *
+mm_netlink_new_fake (void)
+{
+    return MM_NETLINK (g_object_new (MM_TYPE_NETLINK,
+                                     "fake", TRUE,
+                                     NULL));
+}
+
+/*****************************************************************************/
+
 static void
-mm_netlink_init (MMNetlink *self)
+set_property (GObject      *object,
+              guint         prop_id,
+              const GValue *value,
+              GParamSpec   *pspec)
 {
-    g_autoptr(GError) error = NULL;
+    MMNetlink *self = MM_NETLINK (object);
 
-    if (!setup_netlink_socket (self, &error)) {
-        mm_obj_warn (self, "couldn't setup netlink socket: %s", error->message);
-        return;
+    switch (prop_id) {
+    case PROP_FAKE:
+        self->fake = g_value_get_boolean (value);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+        break;
+    }
+}
+
+static void
+get_property (GObject    *object,
+              guint       prop_id,
+              GValue     *value,
+              GParamSpec *pspec)
+{
+    MMNetlink *self = MM_NETLINK (object);
+
+    switch (prop_id) {
+    case PROP_FAKE:
+        g_value_set_boolean (value, self->fake);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+        break;
     }
+}
 
+static void
+mm_netlink_init (MMNetlink *self)
+{
     self->current_sequence_id = 0;
     self->transactions = g_hash_table_new_full (g_direct_hash,
                                                 g_direct_equal,
                                                 NULL,
                                                 (GDestroyNotify) transaction_free);
+    self->links = g_hash_table_new_full (g_direct_hash,
+                                         g_direct_equal,
+                                         NULL,
+                                         (GDestroyNotify) link_info_free);
+}
+
+static void
+constructed (GObject *object)
+{
+    MMNetlink         *self = MM_NETLINK (object);
+    g_autoptr(GError)  error = NULL;
+
+    G_OBJECT_CLASS (mm_netlink_parent_class)->constructed (object);
+
+    /* Fake objects get all link notifications injected, starting with an
+     * empty link cache */
+    if (self->fake) {
+        self->links_subscribed = TRUE;
+        self->links_synced = TRUE;
+        return;
+    }
+
+    if (!setup_netlink_socket (self, &error)) {
+        mm_obj_warn (self, "couldn't setup netlink socket: %s", error->message);
+        return;
+    }
+
+    /* Initial link cache contents */
+    if (self->links_subscribed)
+        link_dump_start (self);
 }
 
 static void
@@ -434,9 +1273,18 @@ dispose (GObject *object)
 {
     MMNetlink *self = MM_NETLINK (object);
 
-    g_assert (g_hash_table_size (self->transactions) == 0);
+    g_assert (!self->link_stats_tasks);
+    g_assert (!self->link_waits);
+
+    /* Only the link cache dump may still be ongoing */
+    if (self->link_dump) {
+        g_hash_table_remove (self->transactions, GUINT_TO_POINTER (((Transaction *) self->link_dump)->sequence_id));
+        self->link_dump = NULL;
+    }
+    g_assert (!self->transactions || g_hash_table_size (self->transactions) == 0);
 
     g_clear_pointer (&self->transactions, g_hash_table_unref);
+    g_clear_pointer (&self->links, g_hash_table_unref);
     if (self->source)
         g_source_destroy (self->source);
     g_clear_pointer (&self->source, g_source_unref);
@@ -456,7 +1304,34 @@ mm_netlink_class_init (MMNetlinkClass *klass)
 {
     GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
-    object_class->dispose = dispose;
+    object_class->constructed  = constructed;
+    object_class->get_property = get_property;
+    object_class->set_property = set_property;
+    object_class->dispose      = dispose;
+
+    properties[PROP_FAKE] =
+        g_param_spec_boolean ("fake",
+                              "Fake",
+                              "Whether messages are injected instead of read from a netlink socket",
+                              FALSE,
+                              G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY);
+    g_object_class_install_property (object_class, PROP_FAKE, properties[PROP_FAKE]);
+
+    signals[SIGNAL_LINK_UPDATED] =
+        g_signal_new (MM_NETLINK_SIGNAL_LINK_UPDATED,
+                      G_OBJECT_CLASS_TYPE (object_class),
+                      G_SIGNAL_RUN_FIRST,
+                      0, NULL, NULL,
+                      g_cclosure_marshal_generic,
+                      G_TYPE_NONE, 2, G_TYPE_UINT, G_TYPE_STRING);
+
+    signals[SIGNAL_LINK_REMOVED] =
+        g_signal_new (MM_NETLINK_SIGNAL_LINK_REMOVED,
+                      G_OBJECT_CLASS_TYPE (object_class),
+                      G_SIGNAL_RUN_FIRST,
+                      0, NULL, NULL,
+                      g_cclosure_marshal_generic,
+                      G_TYPE_NONE, 2, G_TYPE_UINT, G_TYPE_STRING);
 }
 
 MM_DEFINE_SINGLETON_GETTER (MMNetlink, mm_netlink_get, MM_TYPE_NETLINK);
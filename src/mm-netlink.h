@@ -32,12 +32,39 @@ G_BEGIN_DECLS
 #define MM_IS_NETLINK(o)        (G_TYPE_CHECK_INSTANCE_TYPE ((o), MM_TYPE_NETLINK))
 #define MM_IS_NETLINK_CLASS(k)  (G_TYPE_CHECK_CLASS_TYPE ((k), MM_TYPE_NETLINK))
 
+#define MM_NETLINK_SIGNAL_LINK_UPDATED "link-updated"
+#define MM_NETLINK_SIGNAL_LINK_REMOVED "link-removed"
+
 typedef struct _MMNetlink         MMNetlink;
 typedef struct _MMNetlinkClass    MMNetlinkClass;
 
 GType      mm_netlink_get_type     (void) G_GNUC_CONST;
 MMNetlink *mm_netlink_get          (void);
 
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMNetlink, g_object_unref)
+
+/* Several requests sent to the kernel in a single message, each one matched
+ * to its own reply; the operation fails if any of them fails */
+typedef struct _MMNetlinkBatch MMNetlinkBatch;
+
+MMNetlinkBatch *mm_netlink_batch_new         (void);
+void            mm_netlink_batch_free        (MMNetlinkBatch *batch);
+void            mm_netlink_batch_add_setlink (MMNetlinkBatch *batch,
+                                              guint           ifindex,
+                                              gboolean        up,
+                                              guint           mtu);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMNetlinkBatch, mm_netlink_batch_free)
+
+void     mm_netlink_run_batch        (MMNetlink           *self,
+                                      MMNetlinkBatch      *batch,
+                                      GCancellable        *cancellable,
+                                      GAsyncReadyCallback  callback,
+                                      gpointer             user_data);
+gboolean mm_netlink_run_batch_finish (MMNetlink            *self,
+                                      GAsyncResult         *res,
+                                      GError              **error);
+
 void     mm_netlink_setlink        (MMNetlink           *self,
                                     guint                ifindex,
                                     gboolean             up,
@@ -49,6 +76,66 @@ gboolean mm_netlink_setlink_finish (MMNetlink            *self,
                                     GAsyncResult         *res,
                                     GError              **error);
 
+/* Traffic counters of a given link, as accounted by the kernel */
+typedef struct {
+    guint   ifindex;
+    guint64 rx_bytes;
+    guint64 tx_bytes;
+    guint64 rx_packets;
+    guint64 tx_packets;
+} MMNetlinkLinkStats;
+
+/* State of a given link, as last reported by the kernel */
+typedef struct {
+    guint               ifindex;
+    gchar              *ifname;
+    guint               flags;
+    guint               mtu;
+    guint               mux_id; /* 0 if unknown */
+    MMNetlinkLinkStats  stats;
+} MMNetlinkLinkInfo;
+
+/* The link cache is kept up to date with kernel link notifications; lookups
+ * return NULL while the cache isn't synced, so callers must be ready to
+ * fall back to querying the kernel themselves. The "link-updated" and
+ * "link-removed" signals report changes in the cache, other than stats. */
+gboolean                 mm_netlink_is_link_cache_synced   (MMNetlink   *self);
+const MMNetlinkLinkInfo *mm_netlink_peek_link_info         (MMNetlink   *self,
+                                                            guint        ifindex);
+const MMNetlinkLinkInfo *mm_netlink_peek_link_info_by_name (MMNetlink   *self,
+                                                            const gchar *ifname);
+
+/* Waits until a link with the given name is known by the kernel, returning
+ * its ifindex. If a mux id is given and the link reports one, both must
+ * match. Fails right away if link notifications aren't available. */
+void  mm_netlink_wait_link        (MMNetlink            *self,
+                                   const gchar          *ifname,
+                                   guint                 mux_id,
+                                   guint                 timeout_ms,
+                                   GAsyncReadyCallback   callback,
+                                   gpointer              user_data);
+guint mm_netlink_wait_link_finish (MMNetlink            *self,
+                                   GAsyncResult         *res,
+                                   GError              **error);
+
+/* Returns a hash table of interface names (gchar *) and MMNetlinkLinkStats,
+ * including all links known by the kernel. Requests issued while a previous
+ * one is still ongoing are completed with the same results. */
+void        mm_netlink_get_link_stats        (MMNetlink            *self,
+                                              GCancellable         *cancellable,
+                                              GAsyncReadyCallback   callback,
+                                              gpointer              user_data);
+GHashTable *mm_netlink_get_link_stats_finish (MMNetlink            *self,
+                                              GAsyncResult         *res,
+                                              GError              **error);
+
+/* For testing purposes: a netlink object without socket, which processes the
+ * given messages as if they had been received from the kernel */
+MMNetlink *mm_netlink_new_fake     (void);
+void       mm_netlink_fake_receive (MMNetlink     *self,
+                                    gconstpointer  data,
+                                    gsize          len);
+
 G_END_DECLS
 
 #endif  /* MM_MODEM_HELPERS_NETLINK_H */
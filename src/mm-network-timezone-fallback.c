@@ -0,0 +1,161 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <config.h>
+
+#include "mm-network-timezone-fallback.h"
+#include "mm-log.h"
+
+struct _MMNetworkTimezoneFallback {
+    MMPollScheduler                  *scheduler;
+    gpointer                          log_object;
+    MMNetworkTimezoneFallbackQueryFn  query_fn;
+    gpointer                          user_data;
+    guint                             query_id;
+    /* Monotonic time of the last report or successful query, 0 if none */
+    gint64                            updated;
+    /* Stats */
+    guint                             n_reported;
+    guint                             n_queries;
+    guint                             n_queries_avoided;
+};
+
+/*****************************************************************************/
+
+MMNetworkTimezoneFallback *
+mm_network_timezone_fallback_new (MMPollScheduler                  *scheduler,
+                                  gpointer                          log_object,
+                                  MMNetworkTimezoneFallbackQueryFn  query_fn,
+                                  gpointer                          user_data)
+{
+    MMNetworkTimezoneFallback *self;
+
+    self = g_slice_new0 (MMNetworkTimezoneFallback);
+    self->scheduler = mm_poll_scheduler_ref (scheduler);
+    self->log_object = log_object;
+    self->query_fn = query_fn;
+    self->user_data = user_data;
+    return self;
+}
+
+void
+mm_network_timezone_fallback_free (MMNetworkTimezoneFallback *self)
+{
+    if (self->query_id)
+        mm_poll_scheduler_remove (self->scheduler, self->query_id);
+    mm_poll_scheduler_unref (self->scheduler);
+    g_slice_free (MMNetworkTimezoneFallback, self);
+}
+
+/*****************************************************************************/
+
+static gboolean
+query_cb (MMNetworkTimezoneFallback *self)
+{
+    self->query_id = 0;
+    self->n_queries++;
+
+    mm_obj_dbg (self->log_object, "network timezone not reported by the network, querying it");
+    self->query_fn (self->user_data);
+    return G_SOURCE_REMOVE;
+}
+
+void
+mm_network_timezone_fallback_registered (MMNetworkTimezoneFallback *self,
+                                         gint64                     now)
+{
+    if (self->query_id)
+        return;
+
+    /* Registration flapping shouldn't trigger new queries as long as the
+     * timezone is known and recent enough */
+    if (self->updated &&
+        (now - self->updated) < (MM_NETWORK_TIMEZONE_FALLBACK_MAX_AGE_SECS * G_USEC_PER_SEC)) {
+        self->n_queries_avoided++;
+        mm_obj_dbg (self->log_object, "network timezone recently updated, not querying it");
+        return;
+    }
+
+    mm_obj_dbg (self->log_object, "network timezone query scheduled in %us", MM_NETWORK_TIMEZONE_FALLBACK_DELAY_SECS);
+    self->query_id = mm_poll_scheduler_add_seconds (self->scheduler,
+                                                    "network timezone",
+                                                    MM_NETWORK_TIMEZONE_FALLBACK_DELAY_SECS,
+                                                    (GSourceFunc) query_cb,
+                                                    self);
+}
+
+void
+mm_network_timezone_fallback_unregistered (MMNetworkTimezoneFallback *self)
+{
+    if (self->query_id) {
+        mm_obj_dbg (self->log_object, "network timezone query cancelled");
+        mm_poll_scheduler_remove (self->scheduler, self->query_id);
+        self->query_id = 0;
+    }
+}
+
+void
+mm_network_timezone_fallback_reported (MMNetworkTimezoneFallback *self,
+                                       gint64                     now)
+{
+    self->n_reported++;
+    self->updated = now;
+
+    /* No need to query it if the network already reported it */
+    if (self->query_id) {
+        self->n_queries_avoided++;
+        mm_network_timezone_fallback_unregistered (self);
+    }
+}
+
+void
+mm_network_timezone_fallback_queried (MMNetworkTimezoneFallback *self,
+                                      gint64                     now)
+{
+    self->updated = now;
+}
+
+void
+mm_network_timezone_fallback_reset (MMNetworkTimezoneFallback *self)
+{
+    mm_network_timezone_fallback_unregistered (self);
+    self->updated = 0;
+}
+
+gboolean
+mm_network_timezone_fallback_is_scheduled (MMNetworkTimezoneFallback *self)
+{
+    return !!self->query_id;
+}
+
+/*****************************************************************************/
+
+guint
+mm_network_timezone_fallback_get_n_reported (MMNetworkTimezoneFallback *self)
+{
+    return self->n_reported;
+}
+
+guint
+mm_network_timezone_fallback_get_n_queries (MMNetworkTimezoneFallback *self)
+{
+    return self->n_queries;
+}
+
+guint
+mm_network_timezone_fallback_get_n_queries_avoided (MMNetworkTimezoneFallback *self)
+{
+    return self->n_queries_avoided;
+}
@@ -0,0 +1,70 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#ifndef MM_NETWORK_TIMEZONE_FALLBACK_H
+#define MM_NETWORK_TIMEZONE_FALLBACK_H
+
+#include <glib.h>
+
+#include "mm-poll-scheduler.h"
+
+/* Fallback query of the network timezone.
+ *
+ * Network timezone updates are expected to be reported by the network itself
+ * (e.g. NITZ based URCs or indications). As a fallback for modems that don't
+ * report them, a single query is run MM_NETWORK_TIMEZONE_FALLBACK_DELAY_SECS
+ * after getting registered, unless the network reports the timezone in the
+ * meantime, or it was already reported or queried less than
+ * MM_NETWORK_TIMEZONE_FALLBACK_MAX_AGE_SECS ago.
+ *
+ * Times are given in microseconds of the monotonic clock. */
+
+#define MM_NETWORK_TIMEZONE_FALLBACK_DELAY_SECS   15
+#define MM_NETWORK_TIMEZONE_FALLBACK_MAX_AGE_SECS 600
+
+typedef struct _MMNetworkTimezoneFallback MMNetworkTimezoneFallback;
+
+typedef void (* MMNetworkTimezoneFallbackQueryFn) (gpointer user_data);
+
+MMNetworkTimezoneFallback *mm_network_timezone_fallback_new  (MMPollScheduler                  *scheduler,
+                                                              gpointer                          log_object,
+                                                              MMNetworkTimezoneFallbackQueryFn  query_fn,
+                                                              gpointer                          user_data);
+void                       mm_network_timezone_fallback_free (MMNetworkTimezoneFallback        *self);
+
+/* Registration changes: schedule or cancel the query */
+void mm_network_timezone_fallback_registered   (MMNetworkTimezoneFallback *self,
+                                                gint64                     now);
+void mm_network_timezone_fallback_unregistered (MMNetworkTimezoneFallback *self);
+
+/* Timezone reported by the network, or successfully queried */
+void mm_network_timezone_fallback_reported (MMNetworkTimezoneFallback *self,
+                                            gint64                     now);
+void mm_network_timezone_fallback_queried  (MMNetworkTimezoneFallback *self,
+                                            gint64                     now);
+
+/* Cancels the query and forgets when the timezone was last known, e.g. when
+ * the modem is disabled. The statistics are kept. */
+void mm_network_timezone_fallback_reset (MMNetworkTimezoneFallback *self);
+
+gboolean mm_network_timezone_fallback_is_scheduled (MMNetworkTimezoneFallback *self);
+
+guint mm_network_timezone_fallback_get_n_reported        (MMNetworkTimezoneFallback *self);
+guint mm_network_timezone_fallback_get_n_queries         (MMNetworkTimezoneFallback *self);
+guint mm_network_timezone_fallback_get_n_queries_avoided (MMNetworkTimezoneFallback *self);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMNetworkTimezoneFallback, mm_network_timezone_fallback_free)
+
+#endif /* MM_NETWORK_TIMEZONE_FALLBACK_H */
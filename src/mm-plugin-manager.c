@@ -30,6 +30,7 @@
 #include "mm-shared.h"
 #include "mm-utils.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 
 #define SHARED_PREFIX "libmm-shared"
 #define PLUGIN_PREFIX "libmm-plugin"
@@ -280,6 +281,7 @@ port_context_complete (PortContext *port_context)
     self = g_task_get_source_object (task);
     mm_obj_dbg (self, "task %s: finished in '%lf' seconds",
                 port_context->name, g_timer_elapsed (port_context->timer, NULL));
+    mm_trace_end (port_context->port, "port-context", NULL);
 
     if (!port_context->best_plugin)
         g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_UNSUPPORTED, "Unsupported");
@@ -439,6 +441,7 @@ port_context_defer (PortContext *port_context)
         port_context->current = g_list_find (port_context->current, port_context->suggested_plugin);
     } else
         mm_obj_dbg (self, "task %s: deferring support check", port_context->name);
+    mm_trace_step (port_context->port, "port-context", "deferred");
 
     /* Schedule checking support.
      *
@@ -482,6 +485,7 @@ port_context_defer_until_suggested (PortContext *port_context,
      * of a given device is finished without finding a best plugin, this task
      * will get finished reporting unsupported. */
     mm_obj_dbg (self, "task %s: deferring support check until result suggested", port_context->name);
+    mm_trace_step (port_context->port, "port-context", "deferred-until-suggested");
     port_context->defer_until_suggested = TRUE;
 }
 
@@ -556,6 +560,7 @@ port_context_next (PortContext *port_context)
     plugin = MM_PLUGIN (port_context->current->data);
     mm_obj_dbg (self, "task %s: checking with plugin '%s'",
                 port_context->name, mm_plugin_get_name (plugin));
+    mm_trace_step (port_context->port, "port-context", mm_plugin_get_name (plugin));
     mm_plugin_supports_port (plugin,
                              port_context->device,
                              port_context->port,
@@ -677,6 +682,7 @@ port_context_run (MMPluginManager     *self,
     port_context->task = g_task_new (self, port_context->cancellable, callback, user_data);
 
     mm_obj_dbg (self, "task %s: started", port_context->name);
+    mm_trace_begin (port_context->port, "port-context", NULL);
 
     /* Go probe with the first plugin */
     port_context_next (port_context);
@@ -868,6 +874,7 @@ device_context_complete (DeviceContext *device_context)
     if (device_context->min_probing_time_id) {
         mm_obj_dbg (self, "task %s: all port probings completed, but not reached min probing time yet",
                     device_context->name);
+        mm_trace_step (device_context->device, "device-context", "min-probing-time");
         return;
     }
 
@@ -876,6 +883,7 @@ device_context_complete (DeviceContext *device_context)
     if (device_context->extra_probing_time_id) {
         mm_obj_dbg (self, "task %s: all port probings completed, but not reached extra probing time yet",
                     device_context->name);
+        mm_trace_step (device_context->device, "device-context", "extra-probing-time");
         return;
     }
 
@@ -887,6 +895,7 @@ device_context_complete (DeviceContext *device_context)
     /* Log about the time required to complete the checks */
     mm_obj_dbg (self, "task %s: finished in '%lf' seconds",
                 device_context->name, g_timer_elapsed (device_context->timer, NULL));
+    mm_trace_end (device_context->device, "device-context", NULL);
 
     /* Remove signal handlers */
     if (device_context->grabbed_id) {
@@ -1176,6 +1185,17 @@ device_context_run_port_context (DeviceContext *device_context,
      * unless it is the generic plugin */
     if (device_context->best_plugin && !mm_plugin_is_generic (device_context->best_plugin))
         suggested = device_context->best_plugin;
+    /* Otherwise, try first with the one used before suspending, if any */
+    else if (!device_context->best_plugin) {
+        const gchar *checkpoint_plugin;
+
+        checkpoint_plugin = mm_device_peek_checkpoint_plugin (device_context->device);
+        if (checkpoint_plugin) {
+            suggested = mm_plugin_manager_peek_plugin (self, checkpoint_plugin);
+            if (suggested && (mm_plugin_is_generic (suggested) || !g_list_find (plugins, suggested)))
+                suggested = NULL;
+        }
+    }
 
     port_context_run (self,
                       port_context,
@@ -1200,6 +1220,7 @@ device_context_min_wait_time_elapsed (DeviceContext *device_context)
 
     device_context->min_wait_time_id = 0;
     mm_obj_dbg (self, "task %s: min wait time elapsed", device_context->name);
+    mm_trace_step (device_context->device, "device-context", "probing");
 
     /* Move list of port contexts out of the wait list */
     g_assert (!device_context->port_contexts);
@@ -1258,6 +1279,45 @@ device_context_port_released (DeviceContext  *device_context,
                 device_context->name, mm_kernel_device_get_name (port));
 }
 
+/* If the device was checkpointed before suspending and all the ports it had
+ * back then are already grabbed, don't wait for more ports to appear. Note
+ * that if the device exposes new ports after resuming (e.g. a different USB
+ * configuration), the ones not recorded in the checkpoint that appear after
+ * the wait has been cut short will be missing in the modem. */
+static void
+device_context_check_checkpoint_ports (DeviceContext *device_context)
+{
+    MMPluginManager *self;
+
+    if (!mm_device_checkpoint_ports_grabbed (device_context->device))
+        return;
+
+    if (!device_context->min_wait_time_id &&
+        !device_context->min_probing_time_id &&
+        !device_context->extra_probing_time_id)
+        return;
+
+    self = MM_PLUGIN_MANAGER (device_context->self);
+    mm_obj_dbg (self, "task %s: all ports in checkpoint grabbed, not waiting any longer",
+                device_context->name);
+
+    if (device_context->min_probing_time_id) {
+        g_source_remove (device_context->min_probing_time_id);
+        device_context->min_probing_time_id = 0;
+    }
+    if (device_context->extra_probing_time_id) {
+        g_source_remove (device_context->extra_probing_time_id);
+        device_context->extra_probing_time_id = 0;
+    }
+    if (device_context->min_wait_time_id) {
+        g_source_remove (device_context->min_wait_time_id);
+        device_context_min_wait_time_elapsed (device_context);
+    }
+
+    /* Wakeup the device context logic, the probings may be already finished */
+    device_context_continue (device_context);
+}
+
 static void
 device_context_port_grabbed (DeviceContext  *device_context,
                              MMKernelDevice *port)
@@ -1309,6 +1369,7 @@ device_context_port_grabbed (DeviceContext  *device_context,
                     port_context->name);
         /* Store the port reference in the list within the device */
         device_context->wait_port_contexts = g_list_prepend (device_context->wait_port_contexts, port_context);
+        device_context_check_checkpoint_ports (device_context);
         return;
     }
 
@@ -1318,6 +1379,7 @@ device_context_port_grabbed (DeviceContext  *device_context,
     /* If the port has been grabbed after the min wait timeout expired, launch
      * probing directly */
     device_context_run_port_context (device_context, port_context);
+    device_context_check_checkpoint_ports (device_context);
 }
 
 static gboolean
@@ -1401,6 +1463,8 @@ device_context_run (MMPluginManager     *self,
     device_context->min_wait_time_id = g_timeout_add (MIN_WAIT_TIME_MSECS,
                                                       (GSourceFunc) device_context_min_wait_time_elapsed,
                                                       device_context);
+    mm_trace_begin (device_context->device, "device-context", NULL);
+    mm_trace_step (device_context->device, "device-context", "min-wait-time");
 
     /* Set the initial probing timeout. We force the probing time of the device to
      * be at least this amount of time, so that the kernel has enough time to
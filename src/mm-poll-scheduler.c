@@ -0,0 +1,357 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <config.h>
+#include <stdlib.h>
+
+#include "mm-poll-scheduler.h"
+#include "mm-log.h"
+
+/* The shared source is a seconds timeout, which may fire a bit before or
+ * after the requested time; tasks due within this margin run in the same
+ * wakeup */
+#define DISPATCH_MARGIN_USECS G_USEC_PER_SEC
+
+typedef struct {
+    guint        id;
+    gchar       *name;
+    gint64       period;
+    GSourceFunc  func;
+    gpointer     user_data;
+    /* Monotonic time, 0 while the task is running */
+    gint64       deadline;
+} Task;
+
+struct _MMPollScheduler {
+    gint                  ref_count;
+    gpointer              log_object;
+    guint                 next_id;
+    /* Task id -> Task */
+    GHashTable           *tasks;
+    guint                 source_id;
+    gint64                source_deadline;
+    /* Clock, replaceable in tests */
+    MMPollSchedulerClock  clock;
+    gpointer              clock_user_data;
+    /* Stats */
+    guint                 n_wakeups;
+    guint                 n_runs;
+    guint                 n_deferred;
+};
+
+/*****************************************************************************/
+
+static gint64
+get_time (MMPollScheduler *self)
+{
+    return (self->clock ? self->clock (self->clock_user_data) : g_get_monotonic_time ());
+}
+
+/*****************************************************************************/
+
+static void
+task_free (Task *task)
+{
+    g_free (task->name);
+    g_slice_free (Task, task);
+}
+
+static gint64
+task_get_slack (Task *task)
+{
+    return MIN (task->period / 4, MM_POLL_SCHEDULER_MAX_SLACK_SECS * G_USEC_PER_SEC);
+}
+
+/* Sets the deadline one period from now, aligned to the latest deadline of
+ * the other scheduled tasks within the slack of the task */
+static void
+task_arm (MMPollScheduler *self,
+          Task            *task)
+{
+    GHashTableIter iter;
+    Task          *other;
+    gint64         deadline;
+    gint64         aligned = 0;
+
+    deadline = get_time (self) + task->period;
+
+    g_hash_table_iter_init (&iter, self->tasks);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&other)) {
+        if (other == task || !other->deadline)
+            continue;
+        if (other->deadline <= deadline &&
+            other->deadline >= deadline - task_get_slack (task) &&
+            other->deadline > aligned)
+            aligned = other->deadline;
+    }
+
+    task->deadline = aligned ? aligned : deadline;
+}
+
+/*****************************************************************************/
+
+static gboolean dispatch_cb (MMPollScheduler *self);
+
+gint64
+mm_poll_scheduler_get_next_deadline (MMPollScheduler *self)
+{
+    GHashTableIter iter;
+    Task          *task;
+    gint64         next_deadline = 0;
+
+    g_hash_table_iter_init (&iter, self->tasks);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&task)) {
+        if (task->deadline && (!next_deadline || task->deadline < next_deadline))
+            next_deadline = task->deadline;
+    }
+    return next_deadline;
+}
+
+static void
+update_source (MMPollScheduler *self)
+{
+    gint64 next_deadline;
+    gint64 remaining;
+
+    next_deadline = mm_poll_scheduler_get_next_deadline (self);
+
+    if (self->source_id && self->source_deadline == next_deadline)
+        return;
+
+    if (self->source_id) {
+        g_source_remove (self->source_id);
+        self->source_id = 0;
+    }
+
+    self->source_deadline = next_deadline;
+    if (!next_deadline)
+        return;
+
+    remaining = MAX (next_deadline - get_time (self), 0);
+    self->source_id = g_timeout_add_seconds ((guint) ((remaining + G_USEC_PER_SEC - 1) / G_USEC_PER_SEC),
+                                             (GSourceFunc) dispatch_cb,
+                                             self);
+}
+
+static gint
+task_id_cmp (gconstpointer a,
+             gconstpointer b)
+{
+    return (gint) *(const guint *)a - (gint) *(const guint *)b;
+}
+
+static void
+dispatch (MMPollScheduler *self)
+{
+    g_autoptr(GArray)   due = NULL;
+    g_autoptr(GString)  names = NULL;
+    GHashTableIter      iter;
+    Task               *task;
+    gint64              now;
+    guint               i;
+
+    /* Tasks may unref the scheduler */
+    mm_poll_scheduler_ref (self);
+
+    now = get_time (self);
+    due = g_array_new (FALSE, FALSE, sizeof (guint));
+    g_hash_table_iter_init (&iter, self->tasks);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&task)) {
+        if (task->deadline && task->deadline <= now + DISPATCH_MARGIN_USECS) {
+            task->deadline = 0;
+            g_array_append_val (due, task->id);
+        }
+    }
+
+    if (due->len) {
+        /* Run in the same order the tasks were added */
+        g_array_sort (due, task_id_cmp);
+
+        self->n_wakeups++;
+        names = g_string_new (NULL);
+        for (i = 0; i < due->len; i++) {
+            task = g_hash_table_lookup (self->tasks, &g_array_index (due, guint, i));
+            g_string_append_printf (names, "%s%s", i ? ", " : "", task->name);
+        }
+        mm_obj_dbg (self->log_object, "running %u periodic tasks: %s", due->len, names->str);
+    }
+
+    for (i = 0; i < due->len; i++) {
+        guint    task_id;
+        gboolean keep;
+
+        /* Removed by a previous task */
+        task_id = g_array_index (due, guint, i);
+        task = g_hash_table_lookup (self->tasks, &task_id);
+        if (!task)
+            continue;
+
+        self->n_runs++;
+        keep = task->func (task->user_data);
+
+        /* The task may have removed itself */
+        task = g_hash_table_lookup (self->tasks, &task_id);
+        if (!task)
+            continue;
+
+        if (keep)
+            task_arm (self, task);
+        else
+            g_hash_table_remove (self->tasks, &task_id);
+    }
+
+    update_source (self);
+    mm_poll_scheduler_unref (self);
+}
+
+static gboolean
+dispatch_cb (MMPollScheduler *self)
+{
+    self->source_id = 0;
+    self->source_deadline = 0;
+    dispatch (self);
+    return G_SOURCE_REMOVE;
+}
+
+void
+mm_poll_scheduler_dispatch (MMPollScheduler *self)
+{
+    if (self->source_id) {
+        g_source_remove (self->source_id);
+        self->source_id = 0;
+        self->source_deadline = 0;
+    }
+    dispatch (self);
+}
+
+void
+mm_poll_scheduler_set_clock (MMPollScheduler      *self,
+                             MMPollSchedulerClock  clock,
+                             gpointer              user_data)
+{
+    /* Only before any task is added, deadlines aren't converted */
+    g_return_if_fail (!g_hash_table_size (self->tasks));
+
+    self->clock = clock;
+    self->clock_user_data = user_data;
+}
+
+/*****************************************************************************/
+
+guint
+mm_poll_scheduler_add_seconds (MMPollScheduler *self,
+                               const gchar     *name,
+                               guint            period_secs,
+                               GSourceFunc      func,
+                               gpointer         user_data)
+{
+    Task *task;
+
+    g_assert (func);
+
+    task = g_slice_new0 (Task);
+    /* Skip 0 on wrap around, it is never a valid id */
+    task->id = ++self->next_id ? self->next_id : ++self->next_id;
+    task->name = g_strdup (name);
+    task->period = (gint64) period_secs * G_USEC_PER_SEC;
+    task->func = func;
+    task->user_data = user_data;
+    g_hash_table_insert (self->tasks, &task->id, task);
+
+    task_arm (self, task);
+    update_source (self);
+    return task->id;
+}
+
+void
+mm_poll_scheduler_remove (MMPollScheduler *self,
+                          guint            task_id)
+{
+    g_return_if_fail (task_id > 0);
+
+    if (!g_hash_table_remove (self->tasks, &task_id))
+        g_warn_if_reached ();
+    else
+        update_source (self);
+}
+
+void
+mm_poll_scheduler_defer (MMPollScheduler *self,
+                         guint            task_id)
+{
+    Task *task;
+
+    task = g_hash_table_lookup (self->tasks, &task_id);
+    if (!task || !task->deadline)
+        return;
+
+    self->n_deferred++;
+    task_arm (self, task);
+    update_source (self);
+}
+
+guint
+mm_poll_scheduler_get_n_wakeups (MMPollScheduler *self)
+{
+    return self->n_wakeups;
+}
+
+guint
+mm_poll_scheduler_get_n_runs (MMPollScheduler *self)
+{
+    return self->n_runs;
+}
+
+guint
+mm_poll_scheduler_get_n_deferred (MMPollScheduler *self)
+{
+    return self->n_deferred;
+}
+
+/*****************************************************************************/
+
+MMPollScheduler *
+mm_poll_scheduler_new (gpointer log_object)
+{
+    MMPollScheduler *self;
+
+    self = g_slice_new0 (MMPollScheduler);
+    self->ref_count = 1;
+    self->log_object = log_object;
+    self->tasks = g_hash_table_new_full (g_int_hash,
+                                         g_int_equal,
+                                         NULL,
+                                         (GDestroyNotify) task_free);
+    return self;
+}
+
+MMPollScheduler *
+mm_poll_scheduler_ref (MMPollScheduler *self)
+{
+    g_atomic_int_inc (&self->ref_count);
+    return self;
+}
+
+void
+mm_poll_scheduler_unref (MMPollScheduler *self)
+{
+    if (!g_atomic_int_dec_and_test (&self->ref_count))
+        return;
+
+    if (self->source_id)
+        g_source_remove (self->source_id);
+    g_hash_table_unref (self->tasks);
+    g_slice_free (MMPollScheduler, self);
+}
@@ -0,0 +1,74 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#ifndef MM_POLL_SCHEDULER_H
+#define MM_POLL_SCHEDULER_H
+
+#include <glib.h>
+
+/* Scheduler of the periodic tasks of a modem.
+ *
+ * Tasks are added as timeouts in seconds, with the same semantics as
+ * g_timeout_add_seconds(): the function is called once the period elapses,
+ * and it is called again after another period only if it returns
+ * G_SOURCE_CONTINUE.
+ *
+ * All tasks share a single timeout source. When a task is scheduled, its
+ * deadline is moved earlier to match the one of another scheduled task if
+ * they are close enough (up to a quarter of the period, and never more than
+ * MM_POLL_SCHEDULER_MAX_SLACK_SECS), so that tasks end up running together
+ * in the same wakeup instead of each one waking up the system on its own.
+ *
+ * When the data a task polls for is received by other means (e.g. in an
+ * unsolicited message), mm_poll_scheduler_defer() restarts the task period
+ * so that the poll is skipped. */
+
+#define MM_POLL_SCHEDULER_MAX_SLACK_SECS 5
+
+typedef struct _MMPollScheduler MMPollScheduler;
+
+MMPollScheduler *mm_poll_scheduler_new   (gpointer         log_object);
+MMPollScheduler *mm_poll_scheduler_ref   (MMPollScheduler *self);
+void             mm_poll_scheduler_unref (MMPollScheduler *self);
+
+/* Returns the id of the task, never 0 */
+guint mm_poll_scheduler_add_seconds (MMPollScheduler *self,
+                                     const gchar     *name,
+                                     guint            period_secs,
+                                     GSourceFunc      func,
+                                     gpointer         user_data);
+void  mm_poll_scheduler_remove      (MMPollScheduler *self,
+                                     guint            task_id);
+void  mm_poll_scheduler_defer       (MMPollScheduler *self,
+                                     guint            task_id);
+
+guint mm_poll_scheduler_get_n_wakeups  (MMPollScheduler *self);
+guint mm_poll_scheduler_get_n_runs     (MMPollScheduler *self);
+guint mm_poll_scheduler_get_n_deferred (MMPollScheduler *self);
+
+/* For testing purposes: replaces the monotonic clock (in microseconds) used
+ * to compute the task deadlines, so that the due tasks can be run with
+ * mm_poll_scheduler_dispatch() without waiting for the timeout source. */
+typedef gint64 (* MMPollSchedulerClock) (gpointer user_data);
+
+void   mm_poll_scheduler_set_clock         (MMPollScheduler      *self,
+                                            MMPollSchedulerClock  clock,
+                                            gpointer              user_data);
+gint64 mm_poll_scheduler_get_next_deadline (MMPollScheduler      *self);
+void   mm_poll_scheduler_dispatch          (MMPollScheduler      *self);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMPollScheduler, mm_poll_scheduler_unref)
+
+#endif /* MM_POLL_SCHEDULER_H */
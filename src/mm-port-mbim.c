@@ -34,6 +34,8 @@ G_DEFINE_TYPE (MMPortMbim, mm_port_mbim, MM_TYPE_PORT)
 struct _MMPortMbimPrivate {
     gboolean    in_progress;
     MbimDevice *mbim_device;
+    /* Start of the transaction in the open sequence, for the port metrics */
+    gint64      open_metrics_start_time;
 #if defined WITH_QMI && QMI_MBIM_QMUX_SUPPORTED
     gboolean    qmi_supported;
     QmiDevice  *qmi_device;
@@ -41,6 +43,59 @@ struct _MMPortMbimPrivate {
 #endif
 };
 
+/*****************************************************************************/
+/* Metrics of the transactions run by the port itself; commands sent by the
+ * users of the MBIM device are accounted with mm_port_mbim_device_command(). */
+
+void
+mm_port_mbim_device_command (MbimDevice          *device,
+                             MbimMessage         *message,
+                             guint                timeout_secs,
+                             GCancellable        *cancellable,
+                             GAsyncReadyCallback  callback,
+                             gpointer             user_data)
+{
+    MbimService  service;
+    guint        cid;
+    const gchar *service_str;
+    const gchar *cid_str;
+    gchar       *command;
+
+    service = mbim_message_command_get_service (message);
+    service_str = mbim_service_lookup_name (service);
+    cid = mbim_message_command_get_cid (message);
+    cid_str = mbim_cid_get_printable (service, cid);
+    if (cid_str)
+        command = g_strdup_printf ("%s/%s", service_str ? service_str : "unknown", cid_str);
+    else
+        command = g_strdup_printf ("%s/%u", service_str ? service_str : "unknown", cid);
+
+    mbim_device_command (device,
+                         message,
+                         timeout_secs,
+                         cancellable,
+                         (GAsyncReadyCallback) mm_port_request_ready,
+                         mm_port_request_new (device, command, callback, user_data));
+}
+
+static void
+port_mbim_record_metrics (MMPortMbim   *self,
+                          const gchar  *command,
+                          gint64        start_time,
+                          const GError *error)
+{
+    MMPortMetricsResult result;
+
+    if (g_error_matches (error, MBIM_CORE_ERROR, MBIM_CORE_ERROR_TIMEOUT))
+        result = MM_PORT_METRICS_RESULT_TIMEOUT;
+    else if (error)
+        result = MM_PORT_METRICS_RESULT_ERROR;
+    else
+        result = MM_PORT_METRICS_RESULT_SUCCESS;
+
+    mm_port_metrics_request_completed (mm_port_peek_metrics (MM_PORT (self)), command, start_time, result);
+}
+
 /*****************************************************************************/
 
 #if defined WITH_QMI && QMI_MBIM_QMUX_SUPPORTED
@@ -445,6 +500,7 @@ qmi_device_new_ready (GObject      *unused,
         g_object_unref (task);
         return;
     }
+    mm_port_track_requests (MM_PORT (self), self->priv->qmi_device);
 
     /* Try to open using QMI over MBIM */
     mm_obj_dbg (self, "trying to open QMI over MBIM device...");
@@ -474,6 +530,7 @@ mbim_query_device_services_ready (MbimDevice   *device,
     self = g_task_get_source_object (task);
 
     response = mbim_device_command_finish (device, res, &error);
+    port_mbim_record_metrics (self, "device-services", self->priv->open_metrics_start_time, error);
     if (response &&
         mbim_message_response_get_result (response, MBIM_MESSAGE_TYPE_COMMAND_DONE, &error) &&
         mbim_message_device_services_response_parse (
@@ -531,6 +588,7 @@ mbim_query_device_services (GTask *task)
     self = g_task_get_source_object (task);
 
     message = mbim_message_device_services_query_new (NULL);
+    self->priv->open_metrics_start_time = mm_port_metrics_request_started (mm_port_peek_metrics (MM_PORT (self)));
     mbim_device_command (self->priv->mbim_device,
                          message,
                          10,
@@ -553,6 +611,7 @@ mbim_device_open_ready (MbimDevice   *mbim_device,
     self = g_task_get_source_object (task);
 
     if (!mbim_device_open_full_finish (mbim_device, res, &error)) {
+        port_mbim_record_metrics (self, "open", self->priv->open_metrics_start_time, error);
         g_clear_object (&self->priv->mbim_device);
         self->priv->in_progress = FALSE;
         g_task_return_error (task, error);
@@ -560,6 +619,7 @@ mbim_device_open_ready (MbimDevice   *mbim_device,
         return;
     }
 
+    port_mbim_record_metrics (self, "open", self->priv->open_metrics_start_time, NULL);
     mm_obj_dbg (self, "MBIM device is now open");
 
 #if defined WITH_QMI && QMI_MBIM_QMUX_SUPPORTED
@@ -589,8 +649,10 @@ mbim_device_new_ready (GObject      *unused,
         g_object_unref (task);
         return;
     }
+    mm_port_track_requests (MM_PORT (self), self->priv->mbim_device);
 
     /* Now open the MBIM device */
+    self->priv->open_metrics_start_time = mm_port_metrics_request_started (mm_port_peek_metrics (MM_PORT (self)));
     mbim_device_open_full (self->priv->mbim_device,
                            MBIM_DEVICE_OPEN_FLAGS_PROXY,
                            45,
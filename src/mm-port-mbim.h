@@ -92,6 +92,16 @@ gboolean   mm_port_mbim_allocate_qmi_client_finish (MMPortMbim           *self,
 
 MbimDevice *mm_port_mbim_peek_device (MMPortMbim *self);
 
+/* Same as mbim_device_command(), but also accounting the command in the
+ * metrics of the port owning the MBIM device under the service and command
+ * name (e.g. "basic-connect/signal-state"). */
+void mm_port_mbim_device_command (MbimDevice          *device,
+                                  MbimMessage         *message,
+                                  guint                timeout_secs,
+                                  GCancellable        *cancellable,
+                                  GAsyncReadyCallback  callback,
+                                  gpointer             user_data);
+
 void   mm_port_mbim_setup_link        (MMPortMbim            *self,
                                        MMPort                *data,
                                        const gchar           *link_prefix_hint,
@@ -0,0 +1,202 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <config.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mm-port-metrics.h"
+
+typedef struct {
+    guint64 requests;
+    guint64 errors;
+    guint64 timeouts;
+    /* Milliseconds */
+    guint64 latency_total;
+    guint   latency_max;
+    guint64 latency_histogram[MM_PORT_METRICS_N_BUCKETS];
+} CommandMetrics;
+
+struct _MMPortMetrics {
+    guint       in_flight;
+    guint       max_in_flight;
+    guint64     requests;
+    guint64     errors;
+    guint64     timeouts;
+    /* Command name -> CommandMetrics */
+    GHashTable *commands;
+};
+
+/*****************************************************************************/
+
+static void
+command_metrics_free (CommandMetrics *metrics)
+{
+    g_slice_free (CommandMetrics, metrics);
+}
+
+static CommandMetrics *
+ensure_command_metrics (MMPortMetrics *self,
+                        const gchar   *command)
+{
+    CommandMetrics *metrics;
+
+    metrics = g_hash_table_lookup (self->commands, command);
+    if (metrics)
+        return metrics;
+
+    if (g_hash_table_size (self->commands) >= MM_PORT_METRICS_MAX_COMMANDS) {
+        command = MM_PORT_METRICS_OTHER_COMMAND;
+        metrics = g_hash_table_lookup (self->commands, command);
+        if (metrics)
+            return metrics;
+    }
+
+    metrics = g_slice_new0 (CommandMetrics);
+    g_hash_table_insert (self->commands, g_strdup (command), metrics);
+    return metrics;
+}
+
+gint64
+mm_port_metrics_request_started (MMPortMetrics *self)
+{
+    self->in_flight++;
+    if (self->in_flight > self->max_in_flight)
+        self->max_in_flight = self->in_flight;
+    return g_get_monotonic_time ();
+}
+
+void
+mm_port_metrics_request_completed (MMPortMetrics       *self,
+                                   const gchar         *command,
+                                   gint64               start_time,
+                                   MMPortMetricsResult  result)
+{
+    CommandMetrics *metrics;
+    guint           latency;
+    guint           bucket;
+
+    g_return_if_fail (self->in_flight > 0);
+    self->in_flight--;
+
+    metrics = ensure_command_metrics (self, command);
+
+    self->requests++;
+    metrics->requests++;
+    if (result == MM_PORT_METRICS_RESULT_ERROR) {
+        self->errors++;
+        metrics->errors++;
+    } else if (result == MM_PORT_METRICS_RESULT_TIMEOUT) {
+        self->timeouts++;
+        metrics->timeouts++;
+    }
+
+    latency = (guint) MIN ((g_get_monotonic_time () - start_time) / 1000, G_MAXUINT);
+    metrics->latency_total += latency;
+    metrics->latency_max = MAX (metrics->latency_max, latency);
+
+    /* 0-1ms in bucket 0, 2-3ms in bucket 1, 4-7ms in bucket 2... */
+    bucket = MIN (g_bit_storage (latency) - 1, MM_PORT_METRICS_N_BUCKETS - 1);
+    metrics->latency_histogram[bucket]++;
+}
+
+guint
+mm_port_metrics_get_in_flight (MMPortMetrics *self)
+{
+    return self->in_flight;
+}
+
+/*****************************************************************************/
+
+static GVariant *
+command_metrics_build_dictionary (const gchar    *command,
+                                  CommandMetrics *metrics)
+{
+    GVariantBuilder builder;
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+    g_variant_builder_add (&builder, "{sv}", "command",       g_variant_new_string (command));
+    g_variant_builder_add (&builder, "{sv}", "requests",      g_variant_new_uint64 (metrics->requests));
+    g_variant_builder_add (&builder, "{sv}", "errors",        g_variant_new_uint64 (metrics->errors));
+    g_variant_builder_add (&builder, "{sv}", "timeouts",      g_variant_new_uint64 (metrics->timeouts));
+    g_variant_builder_add (&builder, "{sv}", "latency-total", g_variant_new_uint64 (metrics->latency_total));
+    g_variant_builder_add (&builder, "{sv}", "latency-max",   g_variant_new_uint32 (metrics->latency_max));
+    g_variant_builder_add (&builder, "{sv}", "latency-histogram",
+                           g_variant_new_fixed_array (G_VARIANT_TYPE_UINT64,
+                                                      metrics->latency_histogram,
+                                                      MM_PORT_METRICS_N_BUCKETS,
+                                                      sizeof (guint64)));
+    return g_variant_builder_end (&builder);
+}
+
+static gint
+command_name_cmp (gconstpointer a,
+                  gconstpointer b)
+{
+    return strcmp (*(const gchar **) a, *(const gchar **) b);
+}
+
+GVariant *
+mm_port_metrics_build_dictionary (MMPortMetrics *self,
+                                  const gchar   *port_name)
+{
+    GVariantBuilder      builder;
+    GVariantBuilder      commands_builder;
+    g_autofree gpointer *commands = NULL;
+    guint                n_commands;
+    guint                i;
+
+    /* Commands sorted by name, so that the output is stable */
+    commands = g_hash_table_get_keys_as_array (self->commands, &n_commands);
+    qsort (commands, n_commands, sizeof (gpointer), command_name_cmp);
+
+    g_variant_builder_init (&commands_builder, G_VARIANT_TYPE ("aa{sv}"));
+    for (i = 0; i < n_commands; i++)
+        g_variant_builder_add_value (&commands_builder,
+                                     command_metrics_build_dictionary (commands[i],
+                                                                       g_hash_table_lookup (self->commands, commands[i])));
+
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+    g_variant_builder_add (&builder, "{sv}", "port",          g_variant_new_string (port_name));
+    g_variant_builder_add (&builder, "{sv}", "in-flight",     g_variant_new_uint32 (self->in_flight));
+    g_variant_builder_add (&builder, "{sv}", "max-in-flight", g_variant_new_uint32 (self->max_in_flight));
+    g_variant_builder_add (&builder, "{sv}", "requests",      g_variant_new_uint64 (self->requests));
+    g_variant_builder_add (&builder, "{sv}", "errors",        g_variant_new_uint64 (self->errors));
+    g_variant_builder_add (&builder, "{sv}", "timeouts",      g_variant_new_uint64 (self->timeouts));
+    g_variant_builder_add (&builder, "{sv}", "commands",      g_variant_builder_end (&commands_builder));
+    return g_variant_builder_end (&builder);
+}
+
+/*****************************************************************************/
+
+MMPortMetrics *
+mm_port_metrics_new (void)
+{
+    MMPortMetrics *self;
+
+    self = g_slice_new0 (MMPortMetrics);
+    self->commands = g_hash_table_new_full (g_str_hash,
+                                            g_str_equal,
+                                            g_free,
+                                            (GDestroyNotify) command_metrics_free);
+    return self;
+}
+
+void
+mm_port_metrics_free (MMPortMetrics *self)
+{
+    g_hash_table_unref (self->commands);
+    g_slice_free (MMPortMetrics, self);
+}
@@ -0,0 +1,64 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#ifndef MM_PORT_METRICS_H
+#define MM_PORT_METRICS_H
+
+#include <glib.h>
+
+/* Control-plane request metrics of a given port.
+ *
+ * Each request is accounted under a command name given by the port (e.g. the
+ * AT command without arguments), with counters of errors and timeouts and a
+ * histogram of latencies: bucket N counts the requests that took less than
+ * 2^(N+1) milliseconds, and the last one also all the slower ones.
+ *
+ * Recording a request is just a couple of counter updates; the dictionary
+ * with all the values is only built when explicitly requested. */
+
+#define MM_PORT_METRICS_N_BUCKETS 16
+
+/* Requests with other command names are accounted together once this many
+ * different ones have been seen */
+#define MM_PORT_METRICS_MAX_COMMANDS 128
+#define MM_PORT_METRICS_OTHER_COMMAND "other"
+
+typedef enum {
+    MM_PORT_METRICS_RESULT_SUCCESS,
+    MM_PORT_METRICS_RESULT_ERROR,
+    MM_PORT_METRICS_RESULT_TIMEOUT,
+} MMPortMetricsResult;
+
+typedef struct _MMPortMetrics MMPortMetrics;
+
+MMPortMetrics *mm_port_metrics_new  (void);
+void           mm_port_metrics_free (MMPortMetrics *self);
+
+/* Returns the start time to give when the request is completed */
+gint64 mm_port_metrics_request_started   (MMPortMetrics       *self);
+void   mm_port_metrics_request_completed (MMPortMetrics       *self,
+                                          const gchar         *command,
+                                          gint64               start_time,
+                                          MMPortMetricsResult  result);
+
+guint  mm_port_metrics_get_in_flight     (MMPortMetrics       *self);
+
+/* Returns a floating a{sv} dictionary */
+GVariant *mm_port_metrics_build_dictionary (MMPortMetrics *self,
+                                            const gchar   *port_name);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMPortMetrics, mm_port_metrics_free)
+
+#endif /* MM_PORT_METRICS_H */
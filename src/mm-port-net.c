@@ -32,7 +32,10 @@ static void
 ensure_ifindex (MMPortNet *self)
 {
     if (!self->priv->ifindex) {
-        self->priv->ifindex = if_nametoindex (mm_port_get_device (MM_PORT (self)));
+        const MMNetlinkLinkInfo *info;
+
+        info = mm_netlink_peek_link_info_by_name (mm_netlink_get (), mm_port_get_device (MM_PORT (self)));
+        self->priv->ifindex = info ? info->ifindex : if_nametoindex (mm_port_get_device (MM_PORT (self)));
         if (!self->priv->ifindex)
             mm_obj_warn (self, "couldn't get interface index");
         else
@@ -86,6 +89,9 @@ mm_port_net_link_setup (MMPortNet            *self,
         return;
     }
 
+    /* Always sent, even if the link cache reports the link already in the
+     * requested state: the cache may have missed notifications, and the
+     * operation is idempotent anyway */
     mm_netlink_setlink (mm_netlink_get (), /* singleton */
                         self->priv->ifindex,
                         up,
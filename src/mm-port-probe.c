@@ -28,6 +28,7 @@
 
 #include "mm-port-probe.h"
 #include "mm-log-object.h"
+#include "mm-trace.h"
 #include "mm-port-serial-at.h"
 #include "mm-port-serial.h"
 #include "mm-serial-parsers.h"
@@ -126,6 +127,7 @@ port_probe_task_return_error_if_cancelled (MMPortProbe *self)
     self->priv->task = NULL;
 
     if (g_task_return_error_if_cancelled (task)) {
+        mm_trace_end (self, "port-probe", NULL);
         g_object_unref (task);
         return TRUE;
     }
@@ -142,6 +144,7 @@ port_probe_task_return_error (MMPortProbe *self,
 
     task = self->priv->task;
     self->priv->task = NULL;
+    mm_trace_end (self, "port-probe", NULL);
     g_task_return_error (task, error);
     g_object_unref (task);
 }
@@ -154,6 +157,7 @@ port_probe_task_return_boolean (MMPortProbe *self,
 
     task = self->priv->task;
     self->priv->task = NULL;
+    mm_trace_end (self, "port-probe", NULL);
     g_task_return_boolean (task, result);
     g_object_unref (task);
 }
@@ -497,6 +501,7 @@ wdm_probe_qmi (MMPortProbe *self)
 #if defined WITH_QMI
     /* Create a port and try to open it */
     mm_obj_dbg (self, "probing QMI...");
+    mm_trace_step (self, "port-probe", "qmi");
 
 #if defined WITH_QRTR
     if (MM_IS_KERNEL_DEVICE_QRTR (self->priv->port)) {
@@ -586,6 +591,7 @@ wdm_probe_mbim (MMPortProbe *self)
 
 #if defined WITH_MBIM
     mm_obj_dbg (self, "probing MBIM...");
+    mm_trace_step (self, "port-probe", "mbim");
 
     /* Create a port and try to open it */
     ctx->mbim_port = mm_port_mbim_new (mm_kernel_device_get_name (self->priv->port),
@@ -757,6 +763,7 @@ serial_probe_qcdm (MMPortProbe *self)
         return G_SOURCE_REMOVE;
 
     mm_obj_dbg (self, "probing QCDM...");
+    mm_trace_step (self, "port-probe", "qcdm");
 
     /* If open, close the AT port */
     if (ctx->serial) {
@@ -1138,6 +1145,20 @@ at_custom_init_ready (MMPortProbe *self,
 
 /***************************************************************/
 
+static const gchar *
+serial_probe_at_step_name (PortProbeRunContext *ctx)
+{
+    if (ctx->at_result_processor == serial_probe_at_vendor_result_processor)
+        return "at-vendor";
+    if (ctx->at_result_processor == serial_probe_at_product_result_processor)
+        return "at-product";
+    if (ctx->at_result_processor == serial_probe_at_icera_result_processor)
+        return "at-icera";
+    if (ctx->at_result_processor == serial_probe_at_xmm_result_processor)
+        return "at-xmm";
+    return "at";
+}
+
 static void
 serial_probe_schedule (MMPortProbe *self)
 {
@@ -1158,6 +1179,7 @@ serial_probe_schedule (MMPortProbe *self)
         ctx->at_custom_init &&
         ctx->at_custom_init_finish &&
         MM_IS_PORT_SERIAL_AT (ctx->serial)) {
+        mm_trace_step (self, "port-probe", "at-custom-init");
         ctx->at_custom_init (self,
                              MM_PORT_SERIAL_AT (ctx->serial),
                              ctx->at_probing_cancellable,
@@ -1215,6 +1237,7 @@ serial_probe_schedule (MMPortProbe *self)
     /* If a next AT group detected, go for it */
     if (ctx->at_result_processor &&
         ctx->at_commands) {
+        mm_trace_step (self, "port-probe", serial_probe_at_step_name (ctx));
         ctx->source_id = g_idle_add ((GSourceFunc) serial_probe_at, self);
         return;
     }
@@ -1440,6 +1463,7 @@ mm_port_probe_run (MMPortProbe                *self,
     /* Shouldn't schedule more than one probing at a time */
     g_assert (self->priv->task == NULL);
     self->priv->task = g_task_new (self, cancellable, callback, user_data);
+    mm_trace_begin (self, "port-probe", NULL);
 
     /* Task context */
     ctx = g_slice_new0 (PortProbeRunContext);
@@ -17,6 +17,7 @@
 #include <config.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <libqmi-glib.h>
 
@@ -31,6 +32,13 @@
 
 #define DEFAULT_LINK_PREALLOCATED_AMOUNT 4
 
+/* Hard limit on the number of QMI clients (and therefore client ids) that may
+ * be allocated through the same port */
+#define MAX_ALLOCATED_CLIENTS 32
+
+/* Maximum number of idle WDS clients kept in the pool */
+#define WDS_CLIENT_POOL_MAX_IDLE 4
+
 G_DEFINE_TYPE (MMPortQmi, mm_port_qmi, MM_TYPE_PORT)
 
 #if defined WITH_QRTR
@@ -49,12 +57,17 @@ typedef struct {
     QmiService  service;
     QmiClient  *client;
     guint       flag;
+    /* WDS client pool */
+    gboolean    pooled;
+    gboolean    in_use;
+    gboolean    prepared;
 } ServiceInfo;
 
 struct _MMPortQmiPrivate {
     gboolean   in_progress;
     QmiDevice *qmi_device;
     GList     *services;
+    guint      n_clients_allocating;
     gchar     *net_driver;
 #if defined WITH_QRTR
     QrtrNode  *node;
@@ -75,6 +88,9 @@ struct _MMPortQmiPrivate {
     MMPort   *preallocated_links_master;
     GArray   *preallocated_links;
     GList    *preallocated_links_setup_pending;
+    /* WDS client pool metrics */
+    guint     wds_client_pool_hits;
+    guint     wds_client_pool_misses;
 };
 
 /*****************************************************************************/
@@ -90,6 +106,10 @@ lookup_client (MMPortQmi  *self,
     for (l = self->priv->services; l; l = g_list_next (l)) {
         ServiceInfo *info = l->data;
 
+        /* Pooled clients are only managed through acquire/release */
+        if (info->pooled)
+            continue;
+
         if (info->service == service && info->flag == flag) {
             QmiClient *found;
 
@@ -208,9 +228,80 @@ mm_port_qmi_release_client (MMPortQmi     *self,
 }
 
 /*****************************************************************************/
+/* Metrics of the transactions run by the port itself; requests sent by the
+ * clients are accounted with MM_PORT_QMI_CLIENT_REQUEST(). */
+
+MMPortRequest *
+mm_port_qmi_request_new (QmiClient           *client,
+                         const gchar         *method,
+                         GAsyncReadyCallback  callback,
+                         gpointer             user_data)
+{
+    const gchar *service;
+    gchar       *message;
+
+    /* e.g. "qmi_client_nas_get_signal_info" is accounted as
+     * "nas/get-signal-info" */
+    service = qmi_service_get_string (qmi_client_get_service (client));
+    if (g_str_has_prefix (method, "qmi_client_"))
+        method += strlen ("qmi_client_");
+    if (service && g_str_has_prefix (method, service) && method[strlen (service)] == '_')
+        method += strlen (service) + 1;
+    message = g_strdelimit (g_strdup_printf ("%s/%s", service ? service : "unknown", method), "_", '-');
+
+    return mm_port_request_new (qmi_client_peek_device (client), message, callback, user_data);
+}
+
+static void
+port_qmi_record_metrics (MMPortQmi    *self,
+                         const gchar  *command,
+                         gint64        start_time,
+                         const GError *error)
+{
+    MMPortMetricsResult result;
+
+    if (g_error_matches (error, QMI_CORE_ERROR, QMI_CORE_ERROR_TIMEOUT))
+        result = MM_PORT_METRICS_RESULT_TIMEOUT;
+    else if (error)
+        result = MM_PORT_METRICS_RESULT_ERROR;
+    else
+        result = MM_PORT_METRICS_RESULT_SUCCESS;
+
+    mm_port_metrics_request_completed (mm_port_peek_metrics (MM_PORT (self)), command, start_time, result);
+}
+
+static void
+port_qmi_record_allocate_client_metrics (MMPortQmi    *self,
+                                         QmiService    service,
+                                         gint64        start_time,
+                                         const GError *error)
+{
+    g_autofree gchar *command = NULL;
+
+    command = g_strdup_printf ("allocate-client/%s", qmi_service_get_string (service));
+    port_qmi_record_metrics (self, command, start_time, error);
+}
+
+/*****************************************************************************/
+
+static gboolean
+check_client_limit (MMPortQmi  *self,
+                    GError    **error)
+{
+    guint n_clients;
+
+    n_clients = g_list_length (self->priv->services) + self->priv->n_clients_allocating;
+    if (n_clients >= MAX_ALLOCATED_CLIENTS) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_TOO_MANY,
+                     "Too many QMI clients allocated (%u)", n_clients);
+        return FALSE;
+    }
+    return TRUE;
+}
 
 typedef struct {
     ServiceInfo *info;
+    gint64       metrics_start_time;
 } AllocateClientContext;
 
 static void
@@ -242,7 +333,12 @@ allocate_client_ready (QmiDevice *qmi_device,
 
     self = g_task_get_source_object (task);
     ctx = g_task_get_task_data (task);
+
+    g_assert (self->priv->n_clients_allocating > 0);
+    self->priv->n_clients_allocating--;
+
     ctx->info->client = qmi_device_allocate_client_finish (qmi_device, res, &error);
+    port_qmi_record_allocate_client_metrics (self, ctx->info->service, ctx->metrics_start_time, error);
     if (!ctx->info->client) {
         g_prefix_error (&error,
                         "Couldn't create client for service '%s': ",
@@ -268,6 +364,7 @@ mm_port_qmi_allocate_client (MMPortQmi           *self,
 {
     AllocateClientContext *ctx;
     GTask *task;
+    GError *error = NULL;
 
     task = g_task_new (self, cancellable, callback, user_data);
 
@@ -286,12 +383,20 @@ mm_port_qmi_allocate_client (MMPortQmi           *self,
         return;
     }
 
+    if (!check_client_limit (self, &error)) {
+        g_task_return_error (task, error);
+        g_object_unref (task);
+        return;
+    }
+
     ctx = g_new0 (AllocateClientContext, 1);
     ctx->info = g_new0 (ServiceInfo, 1);
     ctx->info->service = service;
     ctx->info->flag = flag;
     g_task_set_task_data (task, ctx, (GDestroyNotify)allocate_client_context_free);
 
+    self->priv->n_clients_allocating++;
+    ctx->metrics_start_time = mm_port_metrics_request_started (mm_port_peek_metrics (MM_PORT (self)));
     qmi_device_allocate_client (self->priv->qmi_device,
                                 service,
                                 QMI_CID_NONE,
@@ -301,6 +406,253 @@ mm_port_qmi_allocate_client (MMPortQmi           *self,
                                 task);
 }
 
+/*****************************************************************************/
+/* WDS client pool
+ *
+ * Data connections use their own WDS clients, one per IP family and mux id.
+ * Instead of allocating and setting them up in every connection attempt, the
+ * clients are returned to the pool on disconnection and kept around (up to a
+ * limit) so that they can be reused right away, including the data port
+ * binding and IP family setup already done on them.
+ */
+
+static void
+release_pooled_wds_client (MMPortQmi   *self,
+                           ServiceInfo *info)
+{
+    g_assert (info->pooled && !info->in_use);
+
+    self->priv->services = g_list_remove (self->priv->services, info);
+    mm_obj_dbg (self, "releasing pooled WDS client (flag 0x%x)...", info->flag);
+    if (self->priv->qmi_device)
+        qmi_device_release_client (self->priv->qmi_device,
+                                   info->client,
+                                   QMI_DEVICE_RELEASE_CLIENT_FLAGS_RELEASE_CID,
+                                   3, NULL, NULL, NULL);
+    g_object_unref (info->client);
+    g_free (info);
+}
+
+static ServiceInfo *
+lookup_idle_pooled_wds_client (MMPortQmi *self,
+                               gboolean   match_flag,
+                               guint      flag)
+{
+    GList       *l;
+    ServiceInfo *found = NULL;
+
+    /* Clients are prepended on release, so the last one found is the one
+     * idle for the longest time */
+    for (l = self->priv->services; l; l = g_list_next (l)) {
+        ServiceInfo *info = l->data;
+
+        if (!info->pooled || info->in_use)
+            continue;
+        if (match_flag) {
+            if (info->flag == flag)
+                return info;
+        } else if (info->flag != flag)
+            found = info;
+    }
+
+    return found;
+}
+
+static void
+trim_wds_client_pool (MMPortQmi *self)
+{
+    GList *l;
+    GList *to_release = NULL;
+    guint  n_idle = 0;
+
+    for (l = self->priv->services; l; l = g_list_next (l)) {
+        ServiceInfo *info = l->data;
+
+        if (info->pooled && !info->in_use && (++n_idle > WDS_CLIENT_POOL_MAX_IDLE))
+            to_release = g_list_prepend (to_release, info);
+    }
+
+    for (l = to_release; l; l = g_list_next (l))
+        release_pooled_wds_client (self, l->data);
+    g_list_free (to_release);
+}
+
+typedef struct {
+    guint    flag;
+    gboolean prepared;
+    gint64   metrics_start_time;
+} AcquireWdsClientContext;
+
+static void
+acquire_wds_client_context_free (AcquireWdsClientContext *ctx)
+{
+    g_slice_free (AcquireWdsClientContext, ctx);
+}
+
+QmiClientWds *
+mm_port_qmi_acquire_wds_client_finish (MMPortQmi     *self,
+                                       GAsyncResult  *res,
+                                       gboolean      *prepared,
+                                       GError       **error)
+{
+    QmiClientWds *client;
+
+    client = g_task_propagate_pointer (G_TASK (res), error);
+    if (client && prepared)
+        *prepared = ((AcquireWdsClientContext *) g_task_get_task_data (G_TASK (res)))->prepared;
+    return client;
+}
+
+static void
+acquire_wds_client_ready (QmiDevice    *qmi_device,
+                          GAsyncResult *res,
+                          GTask        *task)
+{
+    MMPortQmi               *self;
+    AcquireWdsClientContext *ctx;
+    ServiceInfo             *info;
+    QmiClient               *client;
+    GError                  *error = NULL;
+
+    self = g_task_get_source_object (task);
+    ctx = g_task_get_task_data (task);
+
+    g_assert (self->priv->n_clients_allocating > 0);
+    self->priv->n_clients_allocating--;
+
+    client = qmi_device_allocate_client_finish (qmi_device, res, &error);
+    port_qmi_record_allocate_client_metrics (self, QMI_SERVICE_WDS, ctx->metrics_start_time, error);
+    if (!client) {
+        g_prefix_error (&error, "Couldn't create client for service '%s': ",
+                        qmi_service_get_string (QMI_SERVICE_WDS));
+        g_task_return_error (task, error);
+        g_object_unref (task);
+        return;
+    }
+
+    info = g_new0 (ServiceInfo, 1);
+    info->service = QMI_SERVICE_WDS;
+    info->client = client;
+    info->flag = ctx->flag;
+    info->pooled = TRUE;
+    info->in_use = TRUE;
+    self->priv->services = g_list_prepend (self->priv->services, info);
+
+    /* A newly allocated client is never prepared */
+    ctx->prepared = FALSE;
+    g_task_return_pointer (task, g_object_ref (client), g_object_unref);
+    g_object_unref (task);
+}
+
+void
+mm_port_qmi_acquire_wds_client (MMPortQmi           *self,
+                                guint                flag,
+                                GCancellable        *cancellable,
+                                GAsyncReadyCallback  callback,
+                                gpointer             user_data)
+{
+    AcquireWdsClientContext *ctx;
+    ServiceInfo             *info;
+    GTask                   *task;
+    GError                  *error = NULL;
+
+    task = g_task_new (self, cancellable, callback, user_data);
+    /* Once allocated, the client must always be given to the caller, who
+     * is responsible for releasing it back to the pool */
+    g_task_set_check_cancellable (task, FALSE);
+
+    ctx = g_slice_new0 (AcquireWdsClientContext);
+    ctx->flag = flag;
+    g_task_set_task_data (task, ctx, (GDestroyNotify) acquire_wds_client_context_free);
+
+    if (!mm_port_qmi_is_open (self)) {
+        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_WRONG_STATE,
+                                 "Port is closed");
+        g_object_unref (task);
+        return;
+    }
+
+    info = lookup_idle_pooled_wds_client (self, TRUE, flag);
+    if (info) {
+        self->priv->wds_client_pool_hits++;
+        mm_obj_dbg (self, "reusing pooled WDS client (flag 0x%x, %s) [pool hits %u, misses %u]",
+                    flag, info->prepared ? "prepared" : "not prepared",
+                    self->priv->wds_client_pool_hits, self->priv->wds_client_pool_misses);
+        info->in_use = TRUE;
+        ctx->prepared = info->prepared;
+        g_task_return_pointer (task, g_object_ref (info->client), g_object_unref);
+        g_object_unref (task);
+        return;
+    }
+
+    self->priv->wds_client_pool_misses++;
+    mm_obj_dbg (self, "allocating new WDS client (flag 0x%x) [pool hits %u, misses %u]",
+                flag, self->priv->wds_client_pool_hits, self->priv->wds_client_pool_misses);
+
+    /* When running out of client ids, drop idle clients prepared for other
+     * IP families or mux ids first */
+    while (!check_client_limit (self, NULL)) {
+        info = lookup_idle_pooled_wds_client (self, FALSE, flag);
+        if (!info)
+            break;
+        release_pooled_wds_client (self, info);
+    }
+
+    if (!check_client_limit (self, &error)) {
+        g_task_return_error (task, error);
+        g_object_unref (task);
+        return;
+    }
+
+    self->priv->n_clients_allocating++;
+    ctx->metrics_start_time = mm_port_metrics_request_started (mm_port_peek_metrics (MM_PORT (self)));
+    qmi_device_allocate_client (self->priv->qmi_device,
+                                QMI_SERVICE_WDS,
+                                QMI_CID_NONE,
+                                10,
+                                cancellable,
+                                (GAsyncReadyCallback)acquire_wds_client_ready,
+                                task);
+}
+
+void
+mm_port_qmi_release_wds_client (MMPortQmi    *self,
+                                QmiClientWds *client,
+                                gboolean      prepared)
+{
+    GList *l;
+
+    for (l = self->priv->services; l; l = g_list_next (l)) {
+        ServiceInfo *info = l->data;
+
+        if (!info->pooled || info->client != QMI_CLIENT (client))
+            continue;
+
+        g_assert (info->in_use);
+        info->in_use = FALSE;
+        info->prepared = prepared;
+
+        /* Most recently released clients first */
+        self->priv->services = g_list_delete_link (self->priv->services, l);
+        self->priv->services = g_list_prepend (self->priv->services, info);
+        mm_obj_dbg (self, "WDS client (flag 0x%x) back in the pool", info->flag);
+        trim_wds_client_pool (self);
+        return;
+    }
+
+    /* Not found, e.g. if the port was closed in the meantime */
+}
+
+void
+mm_port_qmi_add_metrics (MMPortQmi    *self,
+                         GVariantDict *dict)
+{
+    g_variant_dict_insert (dict, "qmi-wds-client-pool-hits",   "u", self->priv->wds_client_pool_hits);
+    g_variant_dict_insert (dict, "qmi-wds-client-pool-misses", "u", self->priv->wds_client_pool_misses);
+    g_variant_dict_insert (dict, "qmi-clients",     "u", g_list_length (self->priv->services) + self->priv->n_clients_allocating);
+    g_variant_dict_insert (dict, "qmi-max-clients", "u", MAX_ALLOCATED_CLIENTS);
+}
+
 /*****************************************************************************/
 
 typedef struct {
@@ -1411,12 +1763,13 @@ sync_wda_data_format (GTask *task)
     if (ctx->use_endpoint)
         qmi_message_wda_set_data_format_input_set_endpoint_info (input, self->priv->endpoint_type, self->priv->endpoint_interface_number, NULL);
 
-    qmi_client_wda_set_data_format (QMI_CLIENT_WDA (ctx->wda),
-                                    input,
-                                    10,
-                                    g_task_get_cancellable (task),
-                                    (GAsyncReadyCallback) set_data_format_ready,
-                                    task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wda_set_data_format,
+                                QMI_CLIENT_WDA (ctx->wda),
+                                input,
+                                10,
+                                g_task_get_cancellable (task),
+                                (GAsyncReadyCallback) set_data_format_ready,
+                                task);
 }
 
 static gboolean
@@ -1656,12 +2009,13 @@ internal_setup_data_format_context_step (GTask *task)
                                                                              self->priv->endpoint_interface_number,
                                                                              NULL);
                 }
-                qmi_client_wda_get_data_format (QMI_CLIENT_WDA (ctx->wda),
-                                                input,
-                                                10,
-                                                g_task_get_cancellable (task),
-                                                (GAsyncReadyCallback) get_data_format_ready,
-                                                task);
+                MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wda_get_data_format,
+                                            QMI_CLIENT_WDA (ctx->wda),
+                                            input,
+                                            10,
+                                            g_task_get_cancellable (task),
+                                            (GAsyncReadyCallback) get_data_format_ready,
+                                            task);
                 return;
             }
             ctx->step++;
@@ -1975,6 +2329,7 @@ typedef struct {
     PortOpenStep             step;
     gboolean                 set_data_format;
     MMPortQmiKernelDataMode  kernel_data_modes;
+    gint64                   metrics_start_time;
 } PortOpenContext;
 
 static void
@@ -2140,9 +2495,12 @@ qmi_device_new_ready (GObject *unused,
     if (!ctx->device)
         /* Error creating the device */
         ctx->step = PORT_OPEN_STEP_LAST;
-    else
+    else {
+        /* Requests sent during the open sequence are also accounted */
+        mm_port_track_requests (MM_PORT (g_task_get_source_object (task)), ctx->device);
         /* Go on to next step */
         ctx->step++;
+    }
     port_open_step (task);
 }
 
@@ -2188,6 +2546,7 @@ port_open_step (GTask *task)
          * for whatever reason, we should clear this flag. We do this by ensuring
          * that all callbacks go through the LAST step for completing. */
         self->priv->in_progress = TRUE;
+        ctx->metrics_start_time = mm_port_metrics_request_started (mm_port_peek_metrics (MM_PORT (self)));
 
 #if defined WITH_QRTR
         if (self->priv->node) {
@@ -2278,9 +2637,10 @@ port_open_step (GTask *task)
         else if (ctx->kernel_data_modes & MM_PORT_QMI_KERNEL_DATA_MODE_802_3)
             open_flags |= QMI_DEVICE_OPEN_FLAGS_NET_802_3;
         else {
-            g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
-                                     "Unexpected kernel data mode: cannot setup using CTL");
-            g_object_unref (task);
+            ctx->error = g_error_new (MM_CORE_ERROR, MM_CORE_ERROR_FAILED,
+                                      "Unexpected kernel data mode: cannot setup using CTL");
+            ctx->step = PORT_OPEN_STEP_LAST;
+            port_open_step (task);
             return;
         }
 
@@ -2297,6 +2657,8 @@ port_open_step (GTask *task)
     }
 
     case PORT_OPEN_STEP_LAST:
+        port_qmi_record_metrics (self, "open", ctx->metrics_start_time, ctx->error);
+
         if (ctx->error) {
             mm_obj_dbg (self, "QMI port open operation failed: %s", ctx->error->message);
 
@@ -2319,6 +2681,7 @@ port_open_step (GTask *task)
         g_assert (ctx->device);
         g_assert (!self->priv->qmi_device);
         self->priv->qmi_device = g_object_ref (ctx->device);
+        mm_port_track_requests (MM_PORT (self), self->priv->qmi_device);
         self->priv->in_progress = FALSE;
         g_task_return_boolean (task, TRUE);
         g_object_unref (task);
@@ -114,6 +114,27 @@ void     mm_port_qmi_release_client         (MMPortQmi  *self,
                                              QmiService  service,
                                              guint       flag);
 
+/* WDS clients for data connections are managed in a pool, so that they
+ * can be reused across connection attempts. A client is 'prepared' when it
+ * was already bound to the data port and IP family given by the flag. */
+void          mm_port_qmi_acquire_wds_client        (MMPortQmi            *self,
+                                                     guint                 flag,
+                                                     GCancellable         *cancellable,
+                                                     GAsyncReadyCallback   callback,
+                                                     gpointer              user_data);
+QmiClientWds *mm_port_qmi_acquire_wds_client_finish (MMPortQmi            *self,
+                                                     GAsyncResult         *res,
+                                                     gboolean             *prepared,
+                                                     GError              **error);
+void          mm_port_qmi_release_wds_client        (MMPortQmi            *self,
+                                                     QmiClientWds         *client,
+                                                     gboolean              prepared);
+
+/* Adds the WDS client pool counters and the number of allocated client ids
+ * to the metrics dictionary of the port */
+void          mm_port_qmi_add_metrics               (MMPortQmi            *self,
+                                                     GVariantDict         *dict);
+
 QmiClient *mm_port_qmi_peek_client (MMPortQmi  *self,
                                     QmiService  service,
                                     guint       flag);
@@ -123,6 +144,22 @@ QmiClient *mm_port_qmi_get_client  (MMPortQmi  *self,
 
 QmiDevice *mm_port_qmi_peek_device (MMPortQmi *self);
 
+/* Sends a request with the given QMI client method, accounting it in the
+ * metrics of the port owning the QMI device under the service and message
+ * name (e.g. "nas/get-signal-info"). */
+#define MM_PORT_QMI_CLIENT_REQUEST(METHOD, CLIENT, INPUT, TIMEOUT, CANCELLABLE, CALLBACK, USER_DATA) \
+    METHOD (CLIENT, INPUT, TIMEOUT, CANCELLABLE,                                                 \
+            (GAsyncReadyCallback) mm_port_request_ready,                                        \
+            mm_port_qmi_request_new (QMI_CLIENT (CLIENT),                                       \
+                                     #METHOD,                                                   \
+                                     (GAsyncReadyCallback) (CALLBACK),                          \
+                                     (USER_DATA)))
+
+MMPortRequest *mm_port_qmi_request_new (QmiClient           *client,
+                                        const gchar         *method,
+                                        GAsyncReadyCallback  callback,
+                                        gpointer             user_data);
+
 QmiDataEndpointType mm_port_qmi_get_endpoint_type             (MMPortQmi *self);
 guint               mm_port_qmi_get_endpoint_interface_number (MMPortQmi *self);
 
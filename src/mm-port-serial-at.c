@@ -434,6 +434,64 @@ mm_port_serial_at_command (MMPortSerialAt *self,
     g_byte_array_unref (buf);
 }
 
+GHashTable *
+mm_port_serial_at_get_cached_test_replies (MMPortSerialAt *self)
+{
+    GHashTable     *replies;
+    GHashTableIter  iter;
+    gpointer        key;
+    gpointer        value;
+
+    g_return_val_if_fail (MM_IS_PORT_SERIAL_AT (self), NULL);
+
+    replies = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    g_hash_table_iter_init (&iter, mm_port_serial_peek_reply_cache (MM_PORT_SERIAL (self)));
+    while (g_hash_table_iter_next (&iter, &key, &value)) {
+        const GByteArray *command_buf = key;
+        const GByteArray *reply_buf = value;
+        g_autofree gchar *command = NULL;
+        g_autofree gchar *reply = NULL;
+
+        command = g_strndup ((const gchar *) command_buf->data, command_buf->len);
+        reply = g_strndup ((const gchar *) reply_buf->data, reply_buf->len);
+
+        /* Skip the AT prefix and the trailing CR/LF added when sending */
+        g_strchomp (command);
+        if (!g_str_has_prefix (command, "AT") ||
+            !g_str_has_suffix (command, "=?") ||
+            !g_utf8_validate (command, -1, NULL) ||
+            !g_utf8_validate (reply, reply_buf->len, NULL))
+            continue;
+
+        g_hash_table_insert (replies, g_strdup (command + 2), g_steal_pointer (&reply));
+    }
+    return replies;
+}
+
+void
+mm_port_serial_at_set_cached_reply (MMPortSerialAt *self,
+                                    const gchar    *command,
+                                    const gchar    *reply)
+{
+    g_autoptr(GByteArray) command_buf = NULL;
+    g_autoptr(GByteArray) reply_buf = NULL;
+
+    g_return_if_fail (MM_IS_PORT_SERIAL_AT (self));
+    g_return_if_fail (command != NULL);
+
+    /* Same key as when sending the command */
+    command_buf = at_command_to_byte_array (command,
+                                            FALSE,
+                                            (mm_port_get_subsys (MM_PORT (self)) == MM_PORT_SUBSYS_TTY ?
+                                             self->priv->send_lf :
+                                             TRUE));
+    if (reply) {
+        reply_buf = g_byte_array_sized_new (strlen (reply));
+        g_byte_array_append (reply_buf, (const guint8 *) reply, strlen (reply));
+    }
+    mm_port_serial_set_cached_reply (MM_PORT_SERIAL (self), command_buf, reply_buf);
+}
+
 static void
 debug_log (MMPortSerial *self,
            const gchar  *prefix,
@@ -112,6 +112,14 @@ const gchar *mm_port_serial_at_command_finish (MMPortSerialAt *self,
                                                GAsyncResult *res,
                                                GError **error);
 
+/* Replies to test commands ("=?") in the port reply cache, as a new table of
+ * command -> reply strings, with the commands given without the AT prefix */
+GHashTable  *mm_port_serial_at_get_cached_test_replies (MMPortSerialAt *self);
+/* Sets the reply served to the command when sent with allow_cached */
+void         mm_port_serial_at_set_cached_reply        (MMPortSerialAt *self,
+                                                        const gchar *command,
+                                                        const gchar *reply);
+
 /*
  * Convert a string into a quoted and escaped string. Returns a new
  * allocated string. Follows ITU V.250 5.4.2.2 "String constants".
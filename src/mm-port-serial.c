@@ -42,9 +42,6 @@ static void     port_serial_schedule_queue_process (MMPortSerial *self,
                                                     guint timeout_ms);
 static void     port_serial_close_force            (MMPortSerial *self);
 static void     port_serial_reopen_cancel          (MMPortSerial *self);
-static void     port_serial_set_cached_reply       (MMPortSerial *self,
-                                                    const GByteArray *command,
-                                                    const GByteArray *response);
 
 G_DEFINE_TYPE (MMPortSerial, mm_port_serial, MM_TYPE_PORT)
 
@@ -130,8 +127,45 @@ typedef struct {
     guint32 idx;
     gboolean started;
     gboolean done;
+
+    /* When the command was queued, for the port metrics */
+    gint64 metrics_start_time;
 } CommandContext;
 
+/* Command name used in the port metrics: the AT command up to its arguments,
+ * or the command code for binary protocols */
+static gchar *
+command_metrics_name (MMPortSerial     *self,
+                      const GByteArray *command)
+{
+    gsize len;
+
+    if (!command->len)
+        return g_strdup ("");
+
+    if (mm_port_get_port_type (MM_PORT (self)) != MM_PORT_TYPE_AT)
+        return g_strdup_printf ("0x%02X", command->data[0]);
+
+    for (len = 0; len < command->len && len < 32; len++) {
+        if (strchr ("=?\r\n", command->data[len]) || !g_ascii_isprint (command->data[len]))
+            break;
+    }
+    return g_ascii_strup ((const gchar *) command->data, len);
+}
+
+static void
+command_context_record_metrics (CommandContext      *ctx,
+                                MMPortMetricsResult  result)
+{
+    g_autofree gchar *name = NULL;
+
+    name = command_metrics_name (ctx->self, ctx->command);
+    mm_port_metrics_request_completed (mm_port_peek_metrics (MM_PORT (ctx->self)),
+                                       name,
+                                       ctx->metrics_start_time,
+                                       result);
+}
+
 static void
 command_context_complete_and_free (CommandContext *ctx, gboolean idle)
 {
@@ -202,7 +236,10 @@ mm_port_serial_command (MMPortSerial *self,
 
     /* Clear the cached value for this command if not asking for cached value */
     if (!allow_cached)
-        port_serial_set_cached_reply (self, ctx->command, NULL);
+        mm_port_serial_set_cached_reply (self, ctx->command, NULL);
+
+    /* Latencies include the time spent in the queue, as seen by the caller */
+    ctx->metrics_start_time = mm_port_metrics_request_started (mm_port_peek_metrics (MM_PORT (self)));
 
     /* If requested to run next, push to the head of the queue so that it really is
      * the next one sent */
@@ -661,10 +698,10 @@ port_serial_process_command (MMPortSerial *self,
     return TRUE;
 }
 
-static void
-port_serial_set_cached_reply (MMPortSerial *self,
-                              const GByteArray *command,
-                              const GByteArray *response)
+void
+mm_port_serial_set_cached_reply (MMPortSerial *self,
+                                 const GByteArray *command,
+                                 const GByteArray *response)
 {
     g_return_if_fail (self != NULL);
     g_return_if_fail (MM_IS_PORT_SERIAL (self));
@@ -688,6 +725,14 @@ port_serial_get_cached_reply (MMPortSerial *self,
     return (const GByteArray *)g_hash_table_lookup (self->priv->reply_cache, command);
 }
 
+GHashTable *
+mm_port_serial_peek_reply_cache (MMPortSerial *self)
+{
+    g_return_val_if_fail (MM_IS_PORT_SERIAL (self), NULL);
+
+    return self->priv->reply_cache;
+}
+
 static void
 port_serial_schedule_queue_process (MMPortSerial *self, guint timeout_ms)
 {
@@ -739,12 +784,17 @@ port_serial_got_response (MMPortSerial *self,
 
         ctx = (CommandContext *) g_queue_pop_head (self->priv->queue);
         if (ctx) {
+            command_context_record_metrics (ctx,
+                                            g_error_matches (error, MM_SERIAL_ERROR, MM_SERIAL_ERROR_RESPONSE_TIMEOUT) ?
+                                            MM_PORT_METRICS_RESULT_TIMEOUT :
+                                            (error ? MM_PORT_METRICS_RESULT_ERROR : MM_PORT_METRICS_RESULT_SUCCESS));
+
             /* Complete the command context with the appropriate result */
             if (error)
                 g_simple_async_result_set_from_error (ctx->result, error);
             else {
                 if (ctx->allow_cached)
-                    port_serial_set_cached_reply (self, ctx->command, parsed_response);
+                    mm_port_serial_set_cached_reply (self, ctx->command, parsed_response);
                 g_simple_async_result_set_op_res_gpointer (ctx->result,
                                                            g_byte_array_ref (parsed_response),
                                                            (GDestroyNotify) g_byte_array_unref);
@@ -1447,6 +1497,7 @@ _close_internal (MMPortSerial *self, gboolean force)
                                          MM_SERIAL_ERROR,
                                          MM_SERIAL_ERROR_SEND_FAILED,
                                          "Serial port is now closed");
+        command_context_record_metrics (ctx, MM_PORT_METRICS_RESULT_ERROR);
         command_context_complete_and_free (ctx, TRUE);
     }
     g_queue_clear (self->priv->queue);
@@ -153,6 +153,13 @@ GByteArray *mm_port_serial_command_finish (MMPortSerial *self,
                                            GAsyncResult *res,
                                            GError **error);
 
+/* Replies to the commands sent with allow_cached, keyed by the command as
+ * sent. A NULL response removes the cached one. */
+GHashTable *mm_port_serial_peek_reply_cache (MMPortSerial *self);
+void        mm_port_serial_set_cached_reply (MMPortSerial *self,
+                                             const GByteArray *command,
+                                             const GByteArray *response);
+
 gboolean mm_port_serial_set_flow_control (MMPortSerial   *self,
                                           MMFlowControl   flow_control,
                                           GError        **error);
@@ -43,6 +43,7 @@ struct _MMPortPrivate {
     MMPortType ptype;
     gboolean connected;
     MMKernelDevice *kernel_device;
+    MMPortMetrics *metrics;
 };
 
 /*****************************************************************************/
@@ -96,6 +97,128 @@ mm_port_set_connected (MMPort *self, gboolean connected)
     }
 }
 
+void
+mm_port_update_kernel_device (MMPort         *self,
+                              MMKernelDevice *kernel_device)
+{
+    g_return_if_fail (MM_IS_PORT (self));
+    g_return_if_fail (MM_IS_KERNEL_DEVICE (kernel_device));
+
+    /* The kernel device property is only set once when the port is grabbed,
+     * but a port may be grabbed before its kernel device event is processed
+     * (e.g. a link reported via netlink before udev), in which case the
+     * kernel device must be replaced with the complete one */
+    if (self->priv->kernel_device == kernel_device)
+        return;
+
+    g_clear_object (&self->priv->kernel_device);
+    self->priv->kernel_device = g_object_ref (kernel_device);
+    g_object_notify (G_OBJECT (self), MM_PORT_KERNEL_DEVICE);
+}
+
+/*****************************************************************************/
+/* Requests sent through a device object owned by the port
+ *
+ * The QMI and MBIM requests go straight to the libqmi/libmbim device objects,
+ * so the device is tagged with a weak reference to the port and the request
+ * callbacks are wrapped, so that the requests are accounted in the metrics of
+ * the port when they complete.
+ */
+
+static GQuark request_port_quark;
+
+struct _MMPortRequest {
+    MMPort              *port;
+    gchar               *command;
+    gint64               start_time;
+    GAsyncReadyCallback  callback;
+    gpointer             user_data;
+};
+
+static void
+request_port_weak_ref_free (GWeakRef *weak_ref)
+{
+    g_weak_ref_clear (weak_ref);
+    g_slice_free (GWeakRef, weak_ref);
+}
+
+void
+mm_port_track_requests (MMPort   *self,
+                        gpointer  device)
+{
+    GWeakRef *weak_ref;
+
+    g_return_if_fail (MM_IS_PORT (self));
+    g_return_if_fail (G_IS_OBJECT (device));
+
+    if (G_UNLIKELY (!request_port_quark))
+        request_port_quark = g_quark_from_static_string ("mm-port-request-port");
+
+    weak_ref = g_slice_new0 (GWeakRef);
+    g_weak_ref_init (weak_ref, self);
+    g_object_set_qdata_full (G_OBJECT (device),
+                             request_port_quark,
+                             weak_ref,
+                             (GDestroyNotify) request_port_weak_ref_free);
+}
+
+MMPortRequest *
+mm_port_request_new (gpointer             device,
+                     gchar               *command,
+                     GAsyncReadyCallback  callback,
+                     gpointer             user_data)
+{
+    MMPortRequest *request;
+    GWeakRef      *weak_ref = NULL;
+
+    request = g_slice_new0 (MMPortRequest);
+    request->command = command;
+    request->callback = callback;
+    request->user_data = user_data;
+
+    /* Requests sent through devices not owned by a port aren't accounted */
+    if (request_port_quark && device)
+        weak_ref = g_object_get_qdata (G_OBJECT (device), request_port_quark);
+    if (weak_ref)
+        request->port = g_weak_ref_get (weak_ref);
+    if (request->port)
+        request->start_time = mm_port_metrics_request_started (request->port->priv->metrics);
+
+    return request;
+}
+
+void
+mm_port_request_ready (GObject       *source,
+                       GAsyncResult  *res,
+                       MMPortRequest *request)
+{
+    if (request->port) {
+        MMPortMetricsResult result;
+
+        /* The result can't be inspected without consuming it, so only
+         * whether the operation failed is known; errors reported in the
+         * response itself are not accounted as errors here. */
+        if (G_IS_TASK (res) && g_task_had_error (G_TASK (res)))
+            result = MM_PORT_METRICS_RESULT_ERROR;
+        else
+            result = MM_PORT_METRICS_RESULT_SUCCESS;
+
+        mm_port_metrics_request_completed (request->port->priv->metrics,
+                                           request->command,
+                                           request->start_time,
+                                           result);
+        g_object_unref (request->port);
+    }
+
+    if (request->callback)
+        request->callback (source, res, request->user_data);
+
+    g_free (request->command);
+    g_slice_free (MMPortRequest, request);
+}
+
+/*****************************************************************************/
+
 MMKernelDevice *
 mm_port_peek_kernel_device (MMPort *self)
 {
@@ -104,6 +227,14 @@ mm_port_peek_kernel_device (MMPort *self)
     return self->priv->kernel_device;
 }
 
+MMPortMetrics *
+mm_port_peek_metrics (MMPort *self)
+{
+    g_return_val_if_fail (MM_IS_PORT (self), NULL);
+
+    return self->priv->metrics;
+}
+
 /*****************************************************************************/
 
 static gchar *
@@ -123,6 +254,7 @@ static void
 mm_port_init (MMPort *self)
 {
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self, MM_TYPE_PORT, MMPortPrivate);
+    self->priv->metrics = mm_port_metrics_new ();
 }
 
 static void
@@ -194,6 +326,7 @@ finalize (GObject *object)
     MMPort *self = MM_PORT (object);
 
     g_free (self->priv->device);
+    mm_port_metrics_free (self->priv->metrics);
 
     G_OBJECT_CLASS (mm_port_parent_class)->finalize (object);
 }
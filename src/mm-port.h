@@ -19,8 +19,10 @@
 #include <config.h>
 #include <glib.h>
 #include <glib-object.h>
+#include <gio/gio.h>
 
 #include "mm-kernel-device.h"
+#include "mm-port-metrics.h"
 
 typedef enum { /*< underscore_name=mm_port_subsys >*/
     MM_PORT_SUBSYS_UNKNOWN = 0x0,
@@ -82,5 +84,25 @@ MMPortType      mm_port_get_port_type      (MMPort *self);
 gboolean        mm_port_get_connected      (MMPort *self);
 void            mm_port_set_connected      (MMPort *self, gboolean connected);
 MMKernelDevice *mm_port_peek_kernel_device (MMPort *self);
+void            mm_port_update_kernel_device (MMPort         *self,
+                                              MMKernelDevice *kernel_device);
+MMPortMetrics  *mm_port_peek_metrics       (MMPort *self);
+
+/* Accounting in the port metrics of the requests sent through a device
+ * object (e.g. a QmiDevice or MbimDevice) owned by the port. The request
+ * callback and user data are given to mm_port_request_new(), and the request
+ * is sent with mm_port_request_ready() as callback and the new request as
+ * user data. The command name is taken by the request. */
+typedef struct _MMPortRequest MMPortRequest;
+
+void           mm_port_track_requests (MMPort              *self,
+                                       gpointer             device);
+MMPortRequest *mm_port_request_new    (gpointer             device,
+                                       gchar               *command,
+                                       GAsyncReadyCallback  callback,
+                                       gpointer             user_data);
+void           mm_port_request_ready  (GObject             *source,
+                                       GAsyncResult        *res,
+                                       MMPortRequest       *request);
 
 #endif /* MM_PORT_H */
@@ -0,0 +1,558 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <config.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mm-qmi-indication-router.h"
+#include "mm-log.h"
+
+typedef struct _Subscription Subscription;
+
+typedef struct {
+    guint                    id;
+    Subscription            *subscription;
+    MMQmiIndicationCallback  callback;
+    gpointer                 user_data;
+    /* Listeners removed while dispatching are freed afterwards */
+    gboolean                 removed;
+} Listener;
+
+struct _Subscription {
+    MMQmiIndicationRouter *router;
+    GObject               *client;
+    gchar                 *indication;
+    gulong                 handler_id;
+    /* G_TYPE_NONE if the output can't be cached */
+    GType                  output_type;
+    gpointer               last_output;
+    guint64                n_received;
+    /* Listeners, in the order they were added */
+    GList                 *listeners;
+    gboolean               dispatching;
+};
+
+/* Counters kept by indication or registration name, which outlive the
+ * subscriptions and registrations they account */
+typedef struct {
+    guint64 received;
+    guint64 dispatched;
+} IndicationCounters;
+
+typedef struct {
+    guint64 sent;
+    guint64 skipped;
+} RegistrationCounters;
+
+struct _MMQmiIndicationRouter {
+    gpointer    log_object;
+    guint       next_listener_id;
+    GList      *subscriptions;
+    /* Listener id -> Listener */
+    GHashTable *listeners;
+    /* Client -> (registration name -> reference count); a reference to the
+     * client is kept while it has any registration enabled */
+    GHashTable *registrations;
+    /* Indication name -> IndicationCounters */
+    GHashTable *indication_counters;
+    /* Registration name -> RegistrationCounters */
+    GHashTable *registration_counters;
+    /* Accounting */
+    gint64      start_time;
+    guint64     indications;
+    guint64     registrations_sent;
+    guint64     registrations_skipped;
+    guint64     requests_avoided;
+};
+
+/*****************************************************************************/
+
+static IndicationCounters *
+peek_indication_counters (MMQmiIndicationRouter *self,
+                          const gchar           *indication)
+{
+    IndicationCounters *counters;
+
+    counters = g_hash_table_lookup (self->indication_counters, indication);
+    if (!counters) {
+        counters = g_slice_new0 (IndicationCounters);
+        g_hash_table_insert (self->indication_counters, g_strdup (indication), counters);
+    }
+    return counters;
+}
+
+static RegistrationCounters *
+peek_registration_counters (MMQmiIndicationRouter *self,
+                            const gchar           *registration)
+{
+    RegistrationCounters *counters;
+
+    counters = g_hash_table_lookup (self->registration_counters, registration);
+    if (!counters) {
+        counters = g_slice_new0 (RegistrationCounters);
+        g_hash_table_insert (self->registration_counters, g_strdup (registration), counters);
+    }
+    return counters;
+}
+
+static void
+indication_counters_free (IndicationCounters *counters)
+{
+    g_slice_free (IndicationCounters, counters);
+}
+
+static void
+registration_counters_free (RegistrationCounters *counters)
+{
+    g_slice_free (RegistrationCounters, counters);
+}
+
+/*****************************************************************************/
+
+static void
+subscription_free (Subscription *sub)
+{
+    g_assert (!sub->listeners);
+    g_assert (!sub->dispatching);
+
+    if (sub->handler_id)
+        g_signal_handler_disconnect (sub->client, sub->handler_id);
+    if (sub->last_output)
+        g_boxed_free (sub->output_type, sub->last_output);
+    g_object_unref (sub->client);
+    g_free (sub->indication);
+    g_slice_free (Subscription, sub);
+}
+
+static Subscription *
+find_subscription (MMQmiIndicationRouter *self,
+                   gpointer               client,
+                   const gchar           *indication)
+{
+    GList *l;
+
+    for (l = self->subscriptions; l; l = g_list_next (l)) {
+        Subscription *sub = l->data;
+
+        if (sub->client == client && g_str_equal (sub->indication, indication))
+            return sub;
+    }
+    return NULL;
+}
+
+/* Frees the listeners removed during the last dispatch, and the subscription
+ * itself if no listener is left */
+static void
+subscription_purge (MMQmiIndicationRouter *self,
+                    Subscription          *sub)
+{
+    GList *l;
+    GList *next;
+
+    for (l = sub->listeners; l; l = next) {
+        Listener *listener = l->data;
+
+        next = g_list_next (l);
+        if (listener->removed) {
+            sub->listeners = g_list_delete_link (sub->listeners, l);
+            g_slice_free (Listener, listener);
+        }
+    }
+
+    if (sub->listeners)
+        return;
+
+    mm_obj_dbg (self->log_object, "stopped routing '%s' indications (%" G_GUINT64_FORMAT " received)",
+                sub->indication, sub->n_received);
+    self->subscriptions = g_list_remove (self->subscriptions, sub);
+    subscription_free (sub);
+}
+
+static void
+indication_cb (GObject      *client,
+               gpointer      output,
+               Subscription *sub)
+{
+    MMQmiIndicationRouter *self;
+    IndicationCounters    *counters;
+    GList                 *l;
+
+    self = sub->router;
+    self->indications++;
+    sub->n_received++;
+    counters = peek_indication_counters (self, sub->indication);
+    counters->received++;
+
+    if (sub->output_type != G_TYPE_NONE) {
+        if (sub->last_output)
+            g_boxed_free (sub->output_type, sub->last_output);
+        sub->last_output = g_boxed_copy (sub->output_type, output);
+    }
+
+    sub->dispatching = TRUE;
+    for (l = sub->listeners; l; l = g_list_next (l)) {
+        Listener *listener = l->data;
+
+        if (!listener->removed) {
+            counters->dispatched++;
+            listener->callback (client, output, listener->user_data);
+        }
+    }
+    sub->dispatching = FALSE;
+
+    subscription_purge (self, sub);
+}
+
+static Subscription *
+subscription_new (MMQmiIndicationRouter *self,
+                  gpointer               client,
+                  const gchar           *indication)
+{
+    Subscription *sub;
+    guint         signal_id;
+    GSignalQuery  query;
+
+    signal_id = g_signal_lookup (indication, G_OBJECT_TYPE (client));
+    if (!signal_id) {
+        mm_obj_warn (self->log_object, "unknown indication '%s' in %s",
+                     indication, G_OBJECT_TYPE_NAME (client));
+        return NULL;
+    }
+
+    sub = g_slice_new0 (Subscription);
+    sub->router = self;
+    sub->client = g_object_ref (client);
+    sub->indication = g_strdup (indication);
+    sub->output_type = G_TYPE_NONE;
+
+    g_signal_query (signal_id, &query);
+    if (query.n_params == 1) {
+        GType output_type;
+
+        output_type = query.param_types[0] & ~G_SIGNAL_TYPE_STATIC_SCOPE;
+        if (G_TYPE_IS_BOXED (output_type))
+            sub->output_type = output_type;
+    }
+
+    sub->handler_id = g_signal_connect (client,
+                                        indication,
+                                        G_CALLBACK (indication_cb),
+                                        sub);
+
+    mm_obj_dbg (self->log_object, "started routing '%s' indications", indication);
+    self->subscriptions = g_list_prepend (self->subscriptions, sub);
+    return sub;
+}
+
+/*****************************************************************************/
+
+guint
+mm_qmi_indication_router_add_listener (MMQmiIndicationRouter   *self,
+                                       gpointer                 client,
+                                       const gchar             *indication,
+                                       MMQmiIndicationCallback  callback,
+                                       gpointer                 user_data)
+{
+    Subscription *sub;
+    Listener     *listener;
+
+    g_return_val_if_fail (G_IS_OBJECT (client), 0);
+
+    sub = find_subscription (self, client, indication);
+    if (!sub) {
+        sub = subscription_new (self, client, indication);
+        if (!sub)
+            return 0;
+    }
+
+    listener = g_slice_new0 (Listener);
+    listener->id = ++self->next_listener_id;
+    listener->subscription = sub;
+    listener->callback = callback;
+    listener->user_data = user_data;
+
+    sub->listeners = g_list_append (sub->listeners, listener);
+    g_hash_table_insert (self->listeners, GUINT_TO_POINTER (listener->id), listener);
+    return listener->id;
+}
+
+void
+mm_qmi_indication_router_remove_listener (MMQmiIndicationRouter *self,
+                                          guint                  listener_id)
+{
+    Listener     *listener;
+    Subscription *sub;
+
+    listener = g_hash_table_lookup (self->listeners, GUINT_TO_POINTER (listener_id));
+    g_return_if_fail (listener != NULL);
+    g_hash_table_remove (self->listeners, GUINT_TO_POINTER (listener_id));
+
+    sub = listener->subscription;
+    listener->removed = TRUE;
+    if (!sub->dispatching)
+        subscription_purge (self, sub);
+}
+
+gpointer
+mm_qmi_indication_router_peek_last (MMQmiIndicationRouter *self,
+                                    gpointer               client,
+                                    const gchar           *indication)
+{
+    Subscription *sub;
+
+    sub = find_subscription (self, client, indication);
+    return (sub ? sub->last_output : NULL);
+}
+
+/*****************************************************************************/
+
+static guint
+registration_get_refcount (MMQmiIndicationRouter *self,
+                           gpointer               client,
+                           const gchar           *registration)
+{
+    GHashTable *client_registrations;
+
+    client_registrations = g_hash_table_lookup (self->registrations, client);
+    if (!client_registrations)
+        return 0;
+    return GPOINTER_TO_UINT (g_hash_table_lookup (client_registrations, registration));
+}
+
+gboolean
+mm_qmi_indication_router_is_registered (MMQmiIndicationRouter *self,
+                                        gpointer               client,
+                                        const gchar           *registration)
+{
+    return (registration_get_refcount (self, client, registration) > 0);
+}
+
+gboolean
+mm_qmi_indication_router_ref_registration (MMQmiIndicationRouter *self,
+                                           gpointer               client,
+                                           const gchar           *registration)
+{
+    GHashTable           *client_registrations;
+    RegistrationCounters *counters;
+    guint                 refcount;
+
+    g_return_val_if_fail (G_IS_OBJECT (client), FALSE);
+
+    client_registrations = g_hash_table_lookup (self->registrations, client);
+    if (!client_registrations) {
+        client_registrations = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+        g_hash_table_insert (self->registrations, g_object_ref (client), client_registrations);
+    }
+
+    refcount = GPOINTER_TO_UINT (g_hash_table_lookup (client_registrations, registration)) + 1;
+    g_hash_table_replace (client_registrations, g_strdup (registration), GUINT_TO_POINTER (refcount));
+
+    counters = peek_registration_counters (self, registration);
+    if (refcount > 1) {
+        mm_obj_dbg (self->log_object, "'%s' registration already enabled (%u users)", registration, refcount);
+        self->registrations_skipped++;
+        counters->skipped++;
+        return FALSE;
+    }
+
+    self->registrations_sent++;
+    counters->sent++;
+    return TRUE;
+}
+
+gboolean
+mm_qmi_indication_router_unref_registration (MMQmiIndicationRouter *self,
+                                             gpointer               client,
+                                             const gchar           *registration)
+{
+    GHashTable           *client_registrations;
+    RegistrationCounters *counters;
+    guint                 refcount;
+
+    counters = peek_registration_counters (self, registration);
+
+    refcount = registration_get_refcount (self, client, registration);
+    if (!refcount) {
+        mm_obj_dbg (self->log_object, "'%s' registration not enabled", registration);
+        self->registrations_skipped++;
+        counters->skipped++;
+        return FALSE;
+    }
+
+    client_registrations = g_hash_table_lookup (self->registrations, client);
+    if (--refcount > 0) {
+        mm_obj_dbg (self->log_object, "'%s' registration still in use (%u users)", registration, refcount);
+        g_hash_table_replace (client_registrations, g_strdup (registration), GUINT_TO_POINTER (refcount));
+        self->registrations_skipped++;
+        counters->skipped++;
+        return FALSE;
+    }
+
+    g_hash_table_remove (client_registrations, registration);
+    if (!g_hash_table_size (client_registrations))
+        g_hash_table_remove (self->registrations, client);
+    self->registrations_sent++;
+    counters->sent++;
+    return TRUE;
+}
+
+/*****************************************************************************/
+
+void
+mm_qmi_indication_router_count_request_avoided (MMQmiIndicationRouter *self)
+{
+    self->requests_avoided++;
+}
+
+void
+mm_qmi_indication_router_get_stats (MMQmiIndicationRouter      *self,
+                                    MMQmiIndicationRouterStats *stats)
+{
+    stats->indications = self->indications;
+    stats->registrations_sent = self->registrations_sent;
+    stats->registrations_skipped = self->registrations_skipped;
+    stats->requests_avoided = self->requests_avoided;
+    stats->elapsed = (g_get_monotonic_time () - self->start_time) / (gdouble) G_USEC_PER_SEC;
+}
+
+void
+mm_qmi_indication_router_log_stats (MMQmiIndicationRouter *self)
+{
+    MMQmiIndicationRouterStats stats;
+    gdouble                    hours;
+
+    mm_qmi_indication_router_get_stats (self, &stats);
+
+    /* Rates are given per hour, but not extrapolated from short periods */
+    hours = MAX (stats.elapsed / 3600.0, 1.0);
+    mm_obj_dbg (self->log_object,
+                "QMI indication routing: %" G_GUINT64_FORMAT " indications (%.1lf/h), "
+                "%" G_GUINT64_FORMAT " registration requests sent, %" G_GUINT64_FORMAT " skipped, "
+                "%" G_GUINT64_FORMAT " requests served from cache (%.1lf/h)",
+                stats.indications, stats.indications / hours,
+                stats.registrations_sent, stats.registrations_skipped,
+                stats.requests_avoided, stats.requests_avoided / hours);
+}
+
+static gint
+name_cmp (gconstpointer a,
+          gconstpointer b)
+{
+    return strcmp (*(const gchar **) a, *(const gchar **) b);
+}
+
+static guint
+count_registration_users (MMQmiIndicationRouter *self,
+                          const gchar           *registration)
+{
+    GHashTableIter  iter;
+    GHashTable     *client_registrations;
+    guint           users = 0;
+
+    g_hash_table_iter_init (&iter, self->registrations);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &client_registrations))
+        users += GPOINTER_TO_UINT (g_hash_table_lookup (client_registrations, registration));
+    return users;
+}
+
+void
+mm_qmi_indication_router_add_metrics (MMQmiIndicationRouter *self,
+                                      GVariantDict          *dict)
+{
+    GVariantBuilder      builder;
+    g_autofree gpointer *names = NULL;
+    guint                n_names;
+    guint                i;
+
+    /* Entries sorted by name, so that the output is stable */
+    names = g_hash_table_get_keys_as_array (self->indication_counters, &n_names);
+    qsort (names, n_names, sizeof (gpointer), name_cmp);
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa{sv}"));
+    for (i = 0; i < n_names; i++) {
+        IndicationCounters *counters;
+        GVariantBuilder     entry;
+
+        counters = g_hash_table_lookup (self->indication_counters, names[i]);
+        g_variant_builder_init (&entry, G_VARIANT_TYPE ("a{sv}"));
+        g_variant_builder_add (&entry, "{sv}", "indication", g_variant_new_string (names[i]));
+        g_variant_builder_add (&entry, "{sv}", "received",   g_variant_new_uint64 (counters->received));
+        g_variant_builder_add (&entry, "{sv}", "dispatched", g_variant_new_uint64 (counters->dispatched));
+        g_variant_builder_add_value (&builder, g_variant_builder_end (&entry));
+    }
+    g_variant_dict_insert_value (dict, "qmi-indications", g_variant_builder_end (&builder));
+    g_clear_pointer (&names, g_free);
+
+    names = g_hash_table_get_keys_as_array (self->registration_counters, &n_names);
+    qsort (names, n_names, sizeof (gpointer), name_cmp);
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("aa{sv}"));
+    for (i = 0; i < n_names; i++) {
+        RegistrationCounters *counters;
+        GVariantBuilder       entry;
+
+        counters = g_hash_table_lookup (self->registration_counters, names[i]);
+        g_variant_builder_init (&entry, G_VARIANT_TYPE ("a{sv}"));
+        g_variant_builder_add (&entry, "{sv}", "registration", g_variant_new_string (names[i]));
+        g_variant_builder_add (&entry, "{sv}", "users",        g_variant_new_uint32 (count_registration_users (self, names[i])));
+        g_variant_builder_add (&entry, "{sv}", "sent",         g_variant_new_uint64 (counters->sent));
+        g_variant_builder_add (&entry, "{sv}", "skipped",      g_variant_new_uint64 (counters->skipped));
+        g_variant_builder_add_value (&builder, g_variant_builder_end (&entry));
+    }
+    g_variant_dict_insert_value (dict, "qmi-registrations", g_variant_builder_end (&builder));
+
+    g_variant_dict_insert_value (dict, "qmi-requests-avoided", g_variant_new_uint64 (self->requests_avoided));
+}
+
+/*****************************************************************************/
+
+MMQmiIndicationRouter *
+mm_qmi_indication_router_new (gpointer log_object)
+{
+    MMQmiIndicationRouter *self;
+
+    self = g_slice_new0 (MMQmiIndicationRouter);
+    self->log_object = log_object;
+    self->listeners = g_hash_table_new (g_direct_hash, g_direct_equal);
+    self->registrations = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+                                                 (GDestroyNotify) g_object_unref,
+                                                 (GDestroyNotify) g_hash_table_unref);
+    self->indication_counters = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                       g_free, (GDestroyNotify) indication_counters_free);
+    self->registration_counters = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                         g_free, (GDestroyNotify) registration_counters_free);
+    self->start_time = g_get_monotonic_time ();
+    return self;
+}
+
+void
+mm_qmi_indication_router_free (MMQmiIndicationRouter *self)
+{
+    GHashTableIter  iter;
+    Listener       *listener;
+
+    /* Listeners still around are dropped along with the router */
+    g_hash_table_iter_init (&iter, self->listeners);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &listener)) {
+        listener->subscription->listeners = g_list_remove (listener->subscription->listeners, listener);
+        g_slice_free (Listener, listener);
+    }
+    g_hash_table_unref (self->listeners);
+
+    g_list_free_full (self->subscriptions, (GDestroyNotify) subscription_free);
+    g_hash_table_unref (self->registrations);
+    g_hash_table_unref (self->indication_counters);
+    g_hash_table_unref (self->registration_counters);
+    g_slice_free (MMQmiIndicationRouter, self);
+}
@@ -0,0 +1,94 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#ifndef MM_QMI_INDICATION_ROUTER_H
+#define MM_QMI_INDICATION_ROUTER_H
+
+#include <glib-object.h>
+
+/* Per-modem router of QMI indications.
+ *
+ * A single signal handler is connected for each client and indication,
+ * regardless of how many listeners there are, and the last output received
+ * for each of them is kept, so that features can read the latest state
+ * reported by the device instead of issuing a new request. The cached
+ * output is dropped when the last listener is removed, as from then on
+ * nobody tracks whether it is up to date.
+ *
+ * Registrations (e.g. "Register Indications" or "Set Event Report" requests)
+ * are reference counted per client and name, so that the request is only sent by the
+ * first user enabling it and by the last user disabling it.
+ *
+ * Clients are given as plain GObjects, and indications as signal names;
+ * the indication signals are expected to have a single boxed argument. */
+
+typedef struct _MMQmiIndicationRouter MMQmiIndicationRouter;
+
+typedef void (* MMQmiIndicationCallback) (GObject  *client,
+                                          gpointer  output,
+                                          gpointer  user_data);
+
+MMQmiIndicationRouter *mm_qmi_indication_router_new  (gpointer               log_object);
+void                   mm_qmi_indication_router_free (MMQmiIndicationRouter *self);
+
+guint    mm_qmi_indication_router_add_listener    (MMQmiIndicationRouter   *self,
+                                                   gpointer                 client,
+                                                   const gchar             *indication,
+                                                   MMQmiIndicationCallback  callback,
+                                                   gpointer                 user_data);
+void     mm_qmi_indication_router_remove_listener (MMQmiIndicationRouter   *self,
+                                                   guint                    listener_id);
+
+/* Returns the last output received for the given indication, only while
+ * there are listeners for it */
+gpointer mm_qmi_indication_router_peek_last       (MMQmiIndicationRouter   *self,
+                                                   gpointer                 client,
+                                                   const gchar             *indication);
+
+gboolean mm_qmi_indication_router_is_registered      (MMQmiIndicationRouter *self,
+                                                      gpointer               client,
+                                                      const gchar           *registration);
+/* Both return TRUE if the caller must send the request to the device */
+gboolean mm_qmi_indication_router_ref_registration   (MMQmiIndicationRouter *self,
+                                                      gpointer               client,
+                                                      const gchar           *registration);
+gboolean mm_qmi_indication_router_unref_registration (MMQmiIndicationRouter *self,
+                                                      gpointer               client,
+                                                      const gchar           *registration);
+
+/* Accounting of requests avoided by using the cached outputs */
+void     mm_qmi_indication_router_count_request_avoided (MMQmiIndicationRouter *self);
+
+typedef struct {
+    guint64 indications;
+    guint64 registrations_sent;
+    guint64 registrations_skipped;
+    guint64 requests_avoided;
+    /* Time since the router was created, in seconds */
+    gdouble elapsed;
+} MMQmiIndicationRouterStats;
+
+void     mm_qmi_indication_router_get_stats (MMQmiIndicationRouter      *self,
+                                             MMQmiIndicationRouterStats *stats);
+void     mm_qmi_indication_router_log_stats (MMQmiIndicationRouter      *self);
+
+/* Adds the per-indication and per-registration counters to the metrics
+ * dictionary of a port */
+void     mm_qmi_indication_router_add_metrics (MMQmiIndicationRouter *self,
+                                               GVariantDict          *dict);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMQmiIndicationRouter, mm_qmi_indication_router_free)
+
+#endif /* MM_QMI_INDICATION_ROUTER_H */
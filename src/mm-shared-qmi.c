@@ -388,13 +388,13 @@ register_in_network_inr (GTask        *task,
             NULL);
     }
 
-    qmi_client_nas_initiate_network_register (
-        QMI_CLIENT_NAS (client),
-        input,
-        120,
-        cancellable,
-        (GAsyncReadyCallback)initiate_network_register_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_initiate_network_register,
+                                QMI_CLIENT_NAS (client),
+                                input,
+                                120,
+                                cancellable,
+                                (GAsyncReadyCallback)initiate_network_register_ready,
+                                task);
 
     qmi_message_nas_initiate_network_register_input_unref (input);
 }
@@ -452,13 +452,13 @@ register_in_network_sssp (GTask        *task,
             NULL
         );
 
-    qmi_client_nas_set_system_selection_preference (
-        QMI_CLIENT_NAS (client),
-        input,
-        120,
-        cancellable,
-        (GAsyncReadyCallback)set_system_selection_preference_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_set_system_selection_preference,
+                                QMI_CLIENT_NAS (client),
+                                input,
+                                120,
+                                cancellable,
+                                (GAsyncReadyCallback)set_system_selection_preference_ready,
+                                task);
 
     qmi_message_nas_set_system_selection_preference_input_unref (input);
 }
@@ -624,13 +624,13 @@ set_current_capabilities_technology_preference (GTask *task)
     input = qmi_message_nas_set_technology_preference_input_new ();
     qmi_message_nas_set_technology_preference_input_set_current (input, pref, QMI_NAS_PREFERENCE_DURATION_PERMANENT, NULL);
 
-    qmi_client_nas_set_technology_preference (
-        ctx->client,
-        input,
-        5,
-        NULL,
-        (GAsyncReadyCallback)set_current_capabilities_set_technology_preference_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_set_technology_preference,
+                                ctx->client,
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)set_current_capabilities_set_technology_preference_ready,
+                                task);
     qmi_message_nas_set_technology_preference_input_unref (input);
 }
 
@@ -689,13 +689,13 @@ set_current_capabilities_system_selection_preference (GTask *task)
     qmi_message_nas_set_system_selection_preference_input_set_mode_preference (input, pref, NULL);
     qmi_message_nas_set_system_selection_preference_input_set_change_duration (input, QMI_NAS_CHANGE_DURATION_PERMANENT, NULL);
 
-    qmi_client_nas_set_system_selection_preference (
-        ctx->client,
-        input,
-        5,
-        NULL,
-        (GAsyncReadyCallback)set_current_capabilities_set_system_selection_preference_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_set_system_selection_preference,
+                                ctx->client,
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)set_current_capabilities_set_system_selection_preference_ready,
+                                task);
     qmi_message_nas_set_system_selection_preference_input_unref (input);
 }
 
@@ -1000,24 +1000,33 @@ load_current_capabilities_step (GTask *task)
         /* fall-through */
 
     case LOAD_CURRENT_CAPABILITIES_STEP_NAS_SYSTEM_SELECTION_PREFERENCE:
-        qmi_client_nas_get_system_selection_preference (
-            ctx->nas_client, NULL, 5, NULL,
-            (GAsyncReadyCallback)load_current_capabilities_get_system_selection_preference_ready,
-            task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_get_system_selection_preference,
+                                    ctx->nas_client,
+                                    NULL,
+                                    5,
+                                    NULL,
+                                    (GAsyncReadyCallback)load_current_capabilities_get_system_selection_preference_ready,
+                                    task);
         return;
 
     case LOAD_CURRENT_CAPABILITIES_STEP_NAS_TECHNOLOGY_PREFERENCE:
-        qmi_client_nas_get_technology_preference (
-            ctx->nas_client, NULL, 5, NULL,
-            (GAsyncReadyCallback)load_current_capabilities_get_technology_preference_ready,
-            task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_get_technology_preference,
+                                    ctx->nas_client,
+                                    NULL,
+                                    5,
+                                    NULL,
+                                    (GAsyncReadyCallback)load_current_capabilities_get_technology_preference_ready,
+                                    task);
         return;
 
     case LOAD_CURRENT_CAPABILITIES_STEP_DMS_GET_CAPABILITIES:
-        qmi_client_dms_get_capabilities (
-            ctx->dms_client, NULL, 5, NULL,
-            (GAsyncReadyCallback)load_current_capabilities_get_capabilities_ready,
-            task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_get_capabilities,
+                                    ctx->dms_client,
+                                    NULL,
+                                    5,
+                                    NULL,
+                                    (GAsyncReadyCallback)load_current_capabilities_get_capabilities_ready,
+                                    task);
         return;
 
     case LOAD_CURRENT_CAPABILITIES_STEP_LAST:
@@ -1224,12 +1233,13 @@ mm_shared_qmi_load_model (MMIfaceModem *self,
         return;
 
     mm_obj_dbg (self, "loading model...");
-    qmi_client_dms_get_model (QMI_CLIENT_DMS (client),
-                              NULL,
-                              5,
-                              NULL,
-                              (GAsyncReadyCallback)dms_get_model_ready,
-                              g_task_new (self, NULL, callback, user_data));
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_get_model,
+                                QMI_CLIENT_DMS (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)dms_get_model_ready,
+                                g_task_new (self, NULL, callback, user_data));
 }
 
 /*****************************************************************************/
@@ -1317,13 +1327,13 @@ set_current_modes_technology_preference (GTask *task)
     input = qmi_message_nas_set_technology_preference_input_new ();
     qmi_message_nas_set_technology_preference_input_set_current (input, pref, QMI_NAS_PREFERENCE_DURATION_PERMANENT, NULL);
 
-    qmi_client_nas_set_technology_preference (
-        ctx->client,
-        input,
-        5,
-        NULL, /* cancellable */
-        (GAsyncReadyCallback)set_current_modes_technology_preference_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_set_technology_preference,
+                                ctx->client,
+                                input,
+                                5,
+                                NULL,
+                                /* cancellable */ (GAsyncReadyCallback)set_current_modes_technology_preference_ready,
+                                task);
     qmi_message_nas_set_technology_preference_input_unref (input);
 }
 
@@ -1392,13 +1402,13 @@ set_current_modes_system_selection_preference (GTask *task)
                                                      mm_iface_modem_is_3gpp (self));
     qmi_message_nas_set_system_selection_preference_input_set_mode_preference (input, pref, NULL);
 
-    qmi_client_nas_set_system_selection_preference (
-        ctx->client,
-        input,
-        5,
-        NULL, /* cancellable */
-        (GAsyncReadyCallback)set_current_modes_system_selection_preference_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_set_system_selection_preference,
+                                ctx->client,
+                                input,
+                                5,
+                                NULL,
+                                /* cancellable */ (GAsyncReadyCallback)set_current_modes_system_selection_preference_ready,
+                                task);
     qmi_message_nas_set_system_selection_preference_input_unref (input);
 }
 
@@ -1546,13 +1556,13 @@ load_current_modes_technology_preference (GTask *task)
 
     ctx = g_task_get_task_data (task);
 
-    qmi_client_nas_get_technology_preference (
-        ctx->client,
-        NULL, /* no input */
-        5,
-        NULL, /* cancellable */
-        (GAsyncReadyCallback)get_technology_preference_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_get_technology_preference,
+                                ctx->client,
+                                NULL,
+                                /* no input */ 5,
+                                NULL,
+                                /* cancellable */ (GAsyncReadyCallback)get_technology_preference_ready,
+                                task);
 }
 
 static void
@@ -1652,13 +1662,13 @@ load_current_modes_system_selection_preference (GTask *task)
     LoadCurrentModesContext *ctx;
 
     ctx = g_task_get_task_data (task);
-    qmi_client_nas_get_system_selection_preference (
-        ctx->client,
-        NULL, /* no input */
-        5,
-        NULL, /* cancellable */
-        (GAsyncReadyCallback)load_current_modes_system_selection_preference_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_get_system_selection_preference,
+                                ctx->client,
+                                NULL,
+                                /* no input */ 5,
+                                NULL,
+                                /* cancellable */ (GAsyncReadyCallback)load_current_modes_system_selection_preference_ready,
+                                task);
 }
 
 void
@@ -1905,12 +1915,13 @@ mm_shared_qmi_load_supported_bands (MMIfaceModem        *self,
 
     task = g_task_new (self, NULL, callback, user_data);
 
-    qmi_client_dms_get_band_capabilities (QMI_CLIENT_DMS (client),
-                                          NULL,
-                                          5,
-                                          NULL,
-                                          (GAsyncReadyCallback)dms_get_band_capabilities_ready,
-                                          task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_get_band_capabilities,
+                                QMI_CLIENT_DMS (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)dms_get_band_capabilities_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -2009,13 +2020,13 @@ mm_shared_qmi_load_current_bands (MMIfaceModem        *self,
 
     task = g_task_new (self, NULL, callback, user_data);
 
-    qmi_client_nas_get_system_selection_preference (
-        QMI_CLIENT_NAS (client),
-        NULL, /* no input */
-        5,
-        NULL, /* cancellable */
-        (GAsyncReadyCallback)load_bands_get_system_selection_preference_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_get_system_selection_preference,
+                                QMI_CLIENT_NAS (client),
+                                NULL,
+                                /* no input */ 5,
+                                NULL,
+                                /* cancellable */ (GAsyncReadyCallback)load_bands_get_system_selection_preference_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -2106,13 +2117,13 @@ mm_shared_qmi_set_current_bands (MMIfaceModem        *self,
     }
     qmi_message_nas_set_system_selection_preference_input_set_change_duration (input, QMI_NAS_CHANGE_DURATION_PERMANENT, NULL);
 
-    qmi_client_nas_set_system_selection_preference (
-        QMI_CLIENT_NAS (client),
-        input,
-        5,
-        NULL, /* cancellable */
-        (GAsyncReadyCallback)bands_set_system_selection_preference_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_set_system_selection_preference,
+                                QMI_CLIENT_NAS (client),
+                                input,
+                                5,
+                                NULL,
+                                /* cancellable */ (GAsyncReadyCallback)bands_set_system_selection_preference_ready,
+                                task);
     qmi_message_nas_set_system_selection_preference_input_unref (input);
 }
 
@@ -2181,12 +2192,13 @@ reset_set_operating_mode_offline_ready (QmiClientDms *client,
      * modem object should get disposed. */
     input = qmi_message_dms_set_operating_mode_input_new ();
     qmi_message_dms_set_operating_mode_input_set_mode (input, QMI_DMS_OPERATING_MODE_RESET, NULL);
-    qmi_client_dms_set_operating_mode (client,
-                                       input,
-                                       20,
-                                       NULL,
-                                       (GAsyncReadyCallback)reset_set_operating_mode_reset_ready,
-                                       task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_set_operating_mode,
+                                client,
+                                input,
+                                20,
+                                NULL,
+                                (GAsyncReadyCallback)reset_set_operating_mode_reset_ready,
+                                task);
     qmi_message_dms_set_operating_mode_input_unref (input);
 }
 
@@ -2209,12 +2221,13 @@ mm_shared_qmi_reset (MMIfaceModem        *self,
     /* Now, go into offline mode */
     input = qmi_message_dms_set_operating_mode_input_new ();
     qmi_message_dms_set_operating_mode_input_set_mode (input, QMI_DMS_OPERATING_MODE_OFFLINE, NULL);
-    qmi_client_dms_set_operating_mode (QMI_CLIENT_DMS (client),
-                                       input,
-                                       20,
-                                       NULL,
-                                       (GAsyncReadyCallback)reset_set_operating_mode_offline_ready,
-                                       task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_set_operating_mode,
+                                QMI_CLIENT_DMS (client),
+                                input,
+                                20,
+                                NULL,
+                                (GAsyncReadyCallback)reset_set_operating_mode_offline_ready,
+                                task);
     qmi_message_dms_set_operating_mode_input_unref (input);
 }
 
@@ -2283,12 +2296,13 @@ mm_shared_qmi_factory_reset (MMIfaceModem        *self,
     }
 
     mm_obj_dbg (self, "performing a factory reset...");
-    qmi_client_dms_restore_factory_defaults (QMI_CLIENT_DMS (client),
-                                             input,
-                                             10,
-                                             NULL,
-                                             (GAsyncReadyCallback)dms_restore_factory_defaults_ready,
-                                             task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_restore_factory_defaults,
+                                QMI_CLIENT_DMS (client),
+                                input,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback)dms_restore_factory_defaults_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -2706,12 +2720,13 @@ setup_carrier_config_step (GTask *task)
         input = qmi_message_pdc_set_selected_config_input_new ();
         qmi_message_pdc_set_selected_config_input_set_type_with_id (input, &type_and_id, NULL);
         qmi_message_pdc_set_selected_config_input_set_token (input, ctx->token++, NULL);
-        qmi_client_pdc_set_selected_config (ctx->client,
-                                            input,
-                                            10,
-                                            NULL,
-                                            (GAsyncReadyCallback)set_selected_config_ready,
-                                            task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_pdc_set_selected_config,
+                                    ctx->client,
+                                    input,
+                                    10,
+                                    NULL,
+                                    (GAsyncReadyCallback)set_selected_config_ready,
+                                    task);
         qmi_message_pdc_set_selected_config_input_unref (input);
         return;
     }
@@ -2725,12 +2740,13 @@ setup_carrier_config_step (GTask *task)
         input = qmi_message_pdc_activate_config_input_new ();
         qmi_message_pdc_activate_config_input_set_config_type (input, requested_config->config_type, NULL);
         qmi_message_pdc_activate_config_input_set_token (input, ctx->token++, NULL);
-        qmi_client_pdc_activate_config (ctx->client,
-                                        input,
-                                        10,
-                                        NULL,
-                                        (GAsyncReadyCallback) activate_config_ready,
-                                        task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_pdc_activate_config,
+                                    ctx->client,
+                                    input,
+                                    10,
+                                    NULL,
+                                    (GAsyncReadyCallback) activate_config_ready,
+                                    task);
         qmi_message_pdc_activate_config_input_unref (input);
         return;
     }
@@ -3146,7 +3162,13 @@ list_configs_indication (QmiClientPdc                      *client,
         type_with_id.id = current_info->id;
         qmi_message_pdc_get_config_info_input_set_type_with_id (input, &type_with_id, NULL);
         qmi_message_pdc_get_config_info_input_set_token (input, current_info->token, NULL);
-        qmi_client_pdc_get_config_info (ctx->client, input, 10, NULL, NULL, NULL); /* ignore response! */
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_pdc_get_config_info,
+                                    ctx->client,
+                                    input,
+                                    10,
+                                    NULL,
+                                    NULL,
+                                    NULL); /* ignore response! */
         qmi_message_pdc_get_config_info_input_unref (input);
     }
 }
@@ -3200,12 +3222,13 @@ load_carrier_config_step (GTask *task)
         input = qmi_message_pdc_list_configs_input_new ();
         qmi_message_pdc_list_configs_input_set_config_type (input, QMI_PDC_CONFIGURATION_TYPE_SOFTWARE, NULL);
         qmi_message_pdc_list_configs_input_set_token (input, ctx->token++, NULL);
-        qmi_client_pdc_list_configs (ctx->client,
-                                     input,
-                                     5,
-                                     NULL,
-                                     (GAsyncReadyCallback)list_configs_ready,
-                                     task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_pdc_list_configs,
+                                    ctx->client,
+                                    input,
+                                    5,
+                                    NULL,
+                                    (GAsyncReadyCallback)list_configs_ready,
+                                    task);
         qmi_message_pdc_list_configs_input_unref (input);
         return;
     }
@@ -3216,12 +3239,13 @@ load_carrier_config_step (GTask *task)
         input = qmi_message_pdc_get_selected_config_input_new ();
         qmi_message_pdc_get_selected_config_input_set_config_type (input, QMI_PDC_CONFIGURATION_TYPE_SOFTWARE, NULL);
         qmi_message_pdc_get_selected_config_input_set_token (input, ctx->token++, NULL);
-        qmi_client_pdc_get_selected_config (ctx->client,
-                                            input,
-                                            5,
-                                            NULL,
-                                            (GAsyncReadyCallback)get_selected_config_ready,
-                                            task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_pdc_get_selected_config,
+                                    ctx->client,
+                                    input,
+                                    5,
+                                    NULL,
+                                    (GAsyncReadyCallback)get_selected_config_ready,
+                                    task);
         qmi_message_pdc_get_selected_config_input_unref (input);
         return;
     }
@@ -3463,12 +3487,13 @@ mm_shared_qmi_load_sim_slots (MMIfaceModem        *self,
     ctx->client_uim = QMI_CLIENT_UIM (g_object_ref (client));
     g_task_set_task_data (task, ctx, (GDestroyNotify) load_sim_slots_context_free);
 
-    qmi_client_uim_get_slot_status (ctx->client_uim,
-                                    NULL,
-                                    10,
-                                    NULL,
-                                    (GAsyncReadyCallback) uim_get_slot_status_ready,
-                                    task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_get_slot_status,
+                                ctx->client_uim,
+                                NULL,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback) uim_get_slot_status_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -3565,7 +3590,8 @@ uim_switch_get_slot_status_ready (QmiClientUim *client,
     input = qmi_message_uim_switch_slot_input_new ();
     qmi_message_uim_switch_slot_input_set_logical_slot (input, (guint8) active_logical_id, NULL);
     qmi_message_uim_switch_slot_input_set_physical_slot (input, slot_number, NULL);
-    qmi_client_uim_switch_slot (client,
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_switch_slot,
+                                client,
                                 input,
                                 10,
                                 NULL,
@@ -3590,12 +3616,13 @@ mm_shared_qmi_set_primary_sim_slot (MMIfaceModem        *self,
     task = g_task_new (self, NULL, callback, user_data);
     g_task_set_task_data (task, GUINT_TO_POINTER (sim_slot), NULL);
 
-    qmi_client_uim_get_slot_status (QMI_CLIENT_UIM (client),
-                                    NULL,
-                                    10,
-                                    NULL,
-                                    (GAsyncReadyCallback) uim_switch_get_slot_status_ready,
-                                    task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_get_slot_status,
+                                QMI_CLIENT_UIM (client),
+                                NULL,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback) uim_switch_get_slot_status_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -3631,13 +3658,13 @@ uim_refresh_complete (QmiClientUim      *client,
         TRUE,
         NULL);
 
-    qmi_client_uim_refresh_complete (
-        client,
-        refresh_complete_input,
-        10,
-        NULL,
-        NULL,
-        NULL);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_refresh_complete,
+                                client,
+                                refresh_complete_input,
+                                10,
+                                NULL,
+                                NULL,
+                                NULL);
     g_array_unref (dummy_aid);
 }
 
@@ -3703,6 +3730,8 @@ uim_refresh_indication_cb (QmiClientUim                  *client,
      * we start a timer at 'start' stage and if it expires, the SIM change
      * check is triggered anyway. */
     if (stage == QMI_UIM_REFRESH_STAGE_START) {
+        /* Whatever the mode, SIM files may be updated */
+        mm_iface_modem_invalidate_sim_cache (MM_IFACE_MODEM (self));
         if (mode == QMI_UIM_REFRESH_MODE_RESET) {
             if (!priv->uim_refresh_start_timeout_id)
                 priv->uim_refresh_start_timeout_id = g_timeout_add_seconds (REFRESH_START_TIMEOUT_SECS,
@@ -3952,12 +3981,13 @@ uim_refresh_register_iccid_change (GTask *task)
                                                         dummy_aid,
                                                         NULL);
 
-    qmi_client_uim_refresh_register (QMI_CLIENT_UIM (priv->uim_client),
-                                     refresh_register_input,
-                                     10,
-                                     NULL,
-                                     (GAsyncReadyCallback) uim_refresh_register_iccid_change_ready,
-                                     task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_refresh_register,
+                                QMI_CLIENT_UIM (priv->uim_client),
+                                refresh_register_input,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback) uim_refresh_register_iccid_change_ready,
+                                task);
 }
 
 /* Refresh registration and event handling.
@@ -4033,12 +4063,13 @@ uim_slot_status_not_supported (GTask *task)
                                                             dummy_aid,
                                                             NULL);
 
-    qmi_client_uim_refresh_register_all (QMI_CLIENT_UIM (priv->uim_client),
-                                         refresh_register_all_input,
-                                         10,
-                                         NULL,
-                                         (GAsyncReadyCallback) uim_refresh_register_all_ready,
-                                         task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_refresh_register_all,
+                                QMI_CLIENT_UIM (priv->uim_client),
+                                refresh_register_all_input,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback) uim_refresh_register_all_ready,
+                                task);
 }
 
 static void
@@ -4106,12 +4137,13 @@ uim_register_events_ready (QmiClientUim *client,
         /* Successful registration does not mean that the modem actually sends
          * physical slot status indications; invoke Get Slot Status to find out if
          * the modem really supports slot status. */
-        qmi_client_uim_get_slot_status (client,
-                                        NULL,
-                                        10,
-                                        NULL,
-                                        (GAsyncReadyCallback) uim_check_get_slot_status_ready,
-                                        task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_get_slot_status,
+                                    client,
+                                    NULL,
+                                    10,
+                                    NULL,
+                                    (GAsyncReadyCallback) uim_check_get_slot_status_ready,
+                                    task);
         return;
     }
 
@@ -4145,12 +4177,13 @@ mm_shared_qmi_setup_sim_hot_swap (MMIfaceModem        *self,
     qmi_message_uim_register_events_input_set_event_registration_mask (register_events_input,
                                                                        QMI_UIM_EVENT_REGISTRATION_FLAG_PHYSICAL_SLOT_STATUS,
                                                                        NULL);
-    qmi_client_uim_register_events (QMI_CLIENT_UIM (priv->uim_client),
-                                    register_events_input,
-                                    10,
-                                    NULL,
-                                    (GAsyncReadyCallback) uim_register_events_ready,
-                                    task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_register_events,
+                                QMI_CLIENT_UIM (priv->uim_client),
+                                register_events_input,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback) uim_register_events_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -4195,12 +4228,13 @@ mm_shared_qmi_fcc_unlock (MMIfaceModem        *self,
 
     task = g_task_new (self, NULL, callback, user_data);
 
-    qmi_client_dms_set_fcc_authentication (QMI_CLIENT_DMS (client),
-                                           NULL,
-                                           5,
-                                           NULL,
-                                           (GAsyncReadyCallback)dms_set_fcc_authentication_ready,
-                                           task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_set_fcc_authentication,
+                                QMI_CLIENT_DMS (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)dms_set_fcc_authentication_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -4302,13 +4336,13 @@ pds_set_supl_server (GTask *task)
         g_array_unref (url);
     }
 
-    qmi_client_pds_set_agps_config (
-        QMI_CLIENT_PDS (ctx->client),
-        input,
-        10,
-        NULL, /* cancellable */
-        (GAsyncReadyCallback)pds_set_agps_config_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_pds_set_agps_config,
+                                QMI_CLIENT_PDS (ctx->client),
+                                input,
+                                10,
+                                NULL,
+                                /* cancellable */ (GAsyncReadyCallback)pds_set_agps_config_ready,
+                                task);
     qmi_message_pds_set_agps_config_input_unref (input);
 }
 
@@ -4413,13 +4447,13 @@ loc_set_supl_server (GTask *task)
     else
         qmi_message_loc_set_server_input_set_url (input, ctx->supl, NULL);
 
-    qmi_client_loc_set_server (
-        QMI_CLIENT_LOC (ctx->client),
-        input,
-        10,
-        NULL, /* cancellable */
-        (GAsyncReadyCallback)loc_set_server_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_loc_set_server,
+                                QMI_CLIENT_LOC (ctx->client),
+                                input,
+                                10,
+                                NULL,
+                                /* cancellable */ (GAsyncReadyCallback)loc_set_server_ready,
+                                task);
     qmi_message_loc_set_server_input_unref (input);
 }
 
@@ -4583,13 +4617,13 @@ pds_load_supl_server (GTask *task)
     else if (mm_iface_modem_is_cdma (MM_IFACE_MODEM (self)))
         qmi_message_pds_get_agps_config_input_set_network_mode (input, QMI_PDS_NETWORK_MODE_CDMA, NULL);
 
-    qmi_client_pds_get_agps_config (
-        QMI_CLIENT_PDS (ctx->client),
-        input,
-        10,
-        NULL, /* cancellable */
-        (GAsyncReadyCallback)pds_get_agps_config_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_pds_get_agps_config,
+                                QMI_CLIENT_PDS (ctx->client),
+                                input,
+                                10,
+                                NULL,
+                                /* cancellable */ (GAsyncReadyCallback)pds_get_agps_config_ready,
+                                task);
     qmi_message_pds_get_agps_config_input_unref (input);
 }
 
@@ -4735,13 +4769,13 @@ loc_load_supl_server (GTask *task)
         (QMI_LOC_SERVER_ADDRESS_TYPE_IPV4 | QMI_LOC_SERVER_ADDRESS_TYPE_URL),
         NULL);
 
-    qmi_client_loc_get_server (
-        QMI_CLIENT_LOC (ctx->client),
-        input,
-        10,
-        NULL, /* cancellable */
-        (GAsyncReadyCallback)loc_get_server_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_loc_get_server,
+                                QMI_CLIENT_LOC (ctx->client),
+                                input,
+                                10,
+                                NULL,
+                                /* cancellable */ (GAsyncReadyCallback)loc_get_server_ready,
+                                task);
     qmi_message_loc_get_server_input_unref (input);
 }
 
@@ -4904,13 +4938,13 @@ stop_gps_engine (MMSharedQmi         *self,
 
         input = qmi_message_pds_set_gps_service_state_input_new ();
         qmi_message_pds_set_gps_service_state_input_set_state (input, FALSE, NULL);
-        qmi_client_pds_set_gps_service_state (
-            QMI_CLIENT_PDS (priv->pds_client),
-            input,
-            10,
-            NULL, /* cancellable */
-            (GAsyncReadyCallback)pds_gps_service_state_stop_ready,
-            task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_pds_set_gps_service_state,
+                                    QMI_CLIENT_PDS (priv->pds_client),
+                                    input,
+                                    10,
+                                    NULL,
+                                    /* cancellable */ (GAsyncReadyCallback)pds_gps_service_state_stop_ready,
+                                    task);
         qmi_message_pds_set_gps_service_state_input_unref (input);
         return;
     }
@@ -4920,12 +4954,13 @@ stop_gps_engine (MMSharedQmi         *self,
 
         input = qmi_message_loc_stop_input_new ();
         qmi_message_loc_stop_input_set_session_id (input, DEFAULT_LOC_SESSION_ID, NULL);
-        qmi_client_loc_stop (QMI_CLIENT_LOC (priv->loc_client),
-                             input,
-                             10,
-                             NULL,
-                             (GAsyncReadyCallback) loc_stop_ready,
-                             task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_loc_stop,
+                                    QMI_CLIENT_LOC (priv->loc_client),
+                                    input,
+                                    10,
+                                    NULL,
+                                    (GAsyncReadyCallback) loc_stop_ready,
+                                    task);
         qmi_message_loc_stop_input_unref (input);
         return;
     }
@@ -5117,12 +5152,13 @@ loc_get_nmea_types_indication_cb (QmiClientLoc                       *client,
 
     input = qmi_message_loc_set_nmea_types_input_new ();
     qmi_message_loc_set_nmea_types_input_set_nmea_types (input, (nmea_types_mask | desired_nmea_types_mask), NULL);
-    qmi_client_loc_set_nmea_types (ctx->client,
-                                   input,
-                                   10,
-                                   NULL,
-                                   (GAsyncReadyCallback)loc_set_nmea_types_ready,
-                                   task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_loc_set_nmea_types,
+                                ctx->client,
+                                input,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback)loc_set_nmea_types_ready,
+                                task);
 }
 
 static void
@@ -5188,12 +5224,13 @@ setup_required_nmea_traces (MMSharedQmi         *self,
         ctx->client = QMI_CLIENT_LOC (g_object_ref (client));
         g_task_set_task_data (task, ctx, (GDestroyNotify)setup_required_nmea_traces_context_free);
 
-        qmi_client_loc_get_nmea_types (ctx->client,
-                                       NULL,
-                                       10,
-                                       NULL,
-                                       (GAsyncReadyCallback)loc_get_nmea_types_ready,
-                                       task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_loc_get_nmea_types,
+                                    ctx->client,
+                                    NULL,
+                                    10,
+                                    NULL,
+                                    (GAsyncReadyCallback)loc_get_nmea_types_ready,
+                                    task);
         return;
     }
 
@@ -5290,13 +5327,13 @@ pds_auto_tracking_state_start_ready (QmiClientPds *client,
     /* Only gather standard NMEA traces */
     input = qmi_message_pds_set_event_report_input_new ();
     qmi_message_pds_set_event_report_input_set_nmea_position_reporting (input, TRUE, NULL);
-    qmi_client_pds_set_event_report (
-        client,
-        input,
-        5,
-        NULL,
-        (GAsyncReadyCallback)pds_ser_location_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_pds_set_event_report,
+                                client,
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)pds_ser_location_ready,
+                                task);
     qmi_message_pds_set_event_report_input_unref (input);
 }
 
@@ -5333,13 +5370,13 @@ pds_gps_service_state_start_ready (QmiClientPds *client,
     /* Enable auto-tracking for a continuous fix */
     input = qmi_message_pds_set_auto_tracking_state_input_new ();
     qmi_message_pds_set_auto_tracking_state_input_set_state (input, TRUE, NULL);
-    qmi_client_pds_set_auto_tracking_state (
-        client,
-        input,
-        10,
-        NULL, /* cancellable */
-        (GAsyncReadyCallback)pds_auto_tracking_state_start_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_pds_set_auto_tracking_state,
+                                client,
+                                input,
+                                10,
+                                NULL,
+                                /* cancellable */ (GAsyncReadyCallback)pds_auto_tracking_state_start_ready,
+                                task);
     qmi_message_pds_set_auto_tracking_state_input_unref (input);
 }
 
@@ -5417,12 +5454,13 @@ loc_start_ready (QmiClientLoc *client,
     input = qmi_message_loc_register_events_input_new ();
     qmi_message_loc_register_events_input_set_event_registration_mask (
         input, QMI_LOC_EVENT_REGISTRATION_FLAG_NMEA, NULL);
-    qmi_client_loc_register_events (client,
-                                    input,
-                                    10,
-                                    NULL,
-                                    (GAsyncReadyCallback) loc_register_events_ready,
-                                    task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_loc_register_events,
+                                client,
+                                input,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback) loc_register_events_ready,
+                                task);
     qmi_message_loc_register_events_input_unref (input);
 }
 
@@ -5446,13 +5484,13 @@ start_gps_engine (MMSharedQmi         *self,
 
         input = qmi_message_pds_set_gps_service_state_input_new ();
         qmi_message_pds_set_gps_service_state_input_set_state (input, TRUE, NULL);
-        qmi_client_pds_set_gps_service_state (
-            QMI_CLIENT_PDS (client),
-            input,
-            10,
-            NULL, /* cancellable */
-            (GAsyncReadyCallback)pds_gps_service_state_start_ready,
-            task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_pds_set_gps_service_state,
+                                    QMI_CLIENT_PDS (client),
+                                    input,
+                                    10,
+                                    NULL,
+                                    /* cancellable */ (GAsyncReadyCallback)pds_gps_service_state_start_ready,
+                                    task);
         qmi_message_pds_set_gps_service_state_input_unref (input);
         return;
     }
@@ -5470,12 +5508,13 @@ start_gps_engine (MMSharedQmi         *self,
         qmi_message_loc_start_input_set_intermediate_report_state (input, QMI_LOC_INTERMEDIATE_REPORT_STATE_DISABLE, NULL);
         qmi_message_loc_start_input_set_minimum_interval_between_position_reports (input, 1000, NULL);
         qmi_message_loc_start_input_set_fix_recurrence_type (input, QMI_LOC_FIX_RECURRENCE_TYPE_REQUEST_PERIODIC_FIXES, NULL);
-        qmi_client_loc_start (QMI_CLIENT_LOC (client),
-                              input,
-                              10,
-                              NULL,
-                              (GAsyncReadyCallback) loc_start_ready,
-                              task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_loc_start,
+                                    QMI_CLIENT_LOC (client),
+                                    input,
+                                    10,
+                                    NULL,
+                                    (GAsyncReadyCallback) loc_start_ready,
+                                    task);
         qmi_message_loc_start_input_unref (input);
         return;
     }
@@ -5654,13 +5693,13 @@ pds_get_default_tracking_session_ready (QmiClientPds *client,
         interval,
         accuracy_threshold,
         NULL);
-    qmi_client_pds_set_default_tracking_session (
-        client,
-        input,
-        10,
-        NULL, /* cancellable */
-        (GAsyncReadyCallback)pds_set_default_tracking_session_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_pds_set_default_tracking_session,
+                                client,
+                                input,
+                                10,
+                                NULL,
+                                /* cancellable */ (GAsyncReadyCallback)pds_set_default_tracking_session_ready,
+                                task);
     qmi_message_pds_set_default_tracking_session_input_unref (input);
 }
 
@@ -5833,13 +5872,13 @@ loc_location_get_operation_mode_indication_cb (QmiClientLoc
 
     input = qmi_message_loc_set_operation_mode_input_new ();
     qmi_message_loc_set_operation_mode_input_set_operation_mode (input, mode, NULL);
-    qmi_client_loc_set_operation_mode (
-        QMI_CLIENT_LOC (ctx->client),
-        input,
-        10,
-        NULL, /* cancellable */
-        (GAsyncReadyCallback)loc_set_operation_mode_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_loc_set_operation_mode,
+                                QMI_CLIENT_LOC (ctx->client),
+                                input,
+                                10,
+                                NULL,
+                                /* cancellable */ (GAsyncReadyCallback)loc_set_operation_mode_ready,
+                                task);
     qmi_message_loc_set_operation_mode_input_unref (input);
 }
 
@@ -5905,13 +5944,13 @@ set_gps_operation_mode (MMSharedQmi         *self,
                                         NULL);
     if (client) {
         ctx->client = g_object_ref (client);
-        qmi_client_pds_get_default_tracking_session (
-            QMI_CLIENT_PDS (ctx->client),
-            NULL,
-            10,
-            NULL, /* cancellable */
-            (GAsyncReadyCallback)pds_get_default_tracking_session_ready,
-            task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_pds_get_default_tracking_session,
+                                    QMI_CLIENT_PDS (ctx->client),
+                                    NULL,
+                                    10,
+                                    NULL,
+                                    /* cancellable */ (GAsyncReadyCallback)pds_get_default_tracking_session_ready,
+                                    task);
         return;
     }
 
@@ -5922,13 +5961,13 @@ set_gps_operation_mode (MMSharedQmi         *self,
                                         NULL);
     if (client) {
         ctx->client = g_object_ref (client);
-        qmi_client_loc_get_operation_mode (
-            QMI_CLIENT_LOC (ctx->client),
-            NULL,
-            10,
-            NULL, /* cancellable */
-            (GAsyncReadyCallback)loc_get_operation_mode_ready,
-            task);
+        MM_PORT_QMI_CLIENT_REQUEST (qmi_client_loc_get_operation_mode,
+                                    QMI_CLIENT_LOC (ctx->client),
+                                    NULL,
+                                    10,
+                                    NULL,
+                                    /* cancellable */ (GAsyncReadyCallback)loc_get_operation_mode_ready,
+                                    task);
         return;
     }
 
@@ -6492,12 +6531,13 @@ mm_shared_qmi_location_load_supported_assistance_data (MMIfaceModemLocation  *se
     ctx->client = QMI_CLIENT_LOC (g_object_ref (client));
     g_task_set_task_data (task, ctx, (GDestroyNotify)load_supported_assistance_data_context_free);
 
-    qmi_client_loc_get_predicted_orbits_data_source (ctx->client,
-                                                     NULL,
-                                                     10,
-                                                     NULL,
-                                                     (GAsyncReadyCallback)loc_location_get_predicted_orbits_data_source_ready,
-                                                     task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_loc_get_predicted_orbits_data_source,
+                                ctx->client,
+                                NULL,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback)loc_location_get_predicted_orbits_data_source_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -6669,12 +6709,13 @@ inject_xtra_data_next (GTask *task)
 
     mm_obj_info (self, "injecting xtra data: %" G_GSIZE_FORMAT " bytes (%u/%u)",
                  count, (guint) ctx->n_part, (guint) ctx->total_parts);
-    qmi_client_loc_inject_xtra_data (ctx->client,
-                                     input,
-                                     10,
-                                     NULL,
-                                     (GAsyncReadyCallback) inject_xtra_data_ready,
-                                     task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_loc_inject_xtra_data,
+                                ctx->client,
+                                input,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback) inject_xtra_data_ready,
+                                task);
 
     qmi_message_loc_inject_xtra_data_input_unref (input);
 }
@@ -6822,12 +6863,13 @@ inject_assistance_data_next (GTask *task)
 
     mm_obj_info (self, "injecting predicted orbits data: %" G_GSIZE_FORMAT " bytes (%u/%u)",
                  count, (guint) ctx->n_part, (guint) ctx->total_parts);
-    qmi_client_loc_inject_predicted_orbits_data (ctx->client,
-                                                 input,
-                                                 10,
-                                                 NULL,
-                                                 (GAsyncReadyCallback) inject_predicted_orbits_data_ready,
-                                                 task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_loc_inject_predicted_orbits_data,
+                                ctx->client,
+                                input,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback) inject_predicted_orbits_data_ready,
+                                task);
 
     qmi_message_loc_inject_predicted_orbits_data_input_unref (input);
 }
@@ -0,0 +1,203 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <config.h>
+#include <errno.h>
+#include <string.h>
+
+#include <glib/gstdio.h>
+
+#include <ModemManager.h>
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+#include "mm-sim-cache.h"
+
+/* Bump whenever the contents change, so that old entries are ignored */
+#define CACHE_VERSION 1
+
+#define GROUP_SIM                "sim"
+#define KEY_VERSION              "version"
+#define KEY_IMSI                 "imsi"
+#define KEY_EID                  "eid"
+#define KEY_OPERATOR_IDENTIFIER  "operator-identifier"
+#define KEY_OPERATOR_NAME        "operator-name"
+#define KEY_EMERGENCY_NUMBERS    "emergency-numbers"
+#define KEY_PREFERRED_NETWORKS   "preferred-networks"
+
+/*****************************************************************************/
+
+MMSimCacheEntry *
+mm_sim_cache_entry_new (void)
+{
+    return g_slice_new0 (MMSimCacheEntry);
+}
+
+void
+mm_sim_cache_entry_free (MMSimCacheEntry *entry)
+{
+    g_free (entry->imsi);
+    g_free (entry->eid);
+    g_free (entry->operator_identifier);
+    g_free (entry->operator_name);
+    g_strfreev (entry->emergency_numbers);
+    if (entry->preferred_networks)
+        g_variant_unref (entry->preferred_networks);
+    g_slice_free (MMSimCacheEntry, entry);
+}
+
+/*****************************************************************************/
+
+static gchar *
+build_path (const gchar  *dir,
+            const gchar  *iccid,
+            GError      **error)
+{
+    const gchar *p;
+
+    /* The ICCID is used as file name, so make sure it is just that */
+    for (p = iccid; p && *p; p++) {
+        if (!g_ascii_isxdigit (*p))
+            break;
+    }
+    if (!iccid || !iccid[0] || *p) {
+        g_set_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS,
+                     "Invalid ICCID: '%s'", iccid ? iccid : "");
+        return NULL;
+    }
+
+    return g_strdup_printf ("%s" G_DIR_SEPARATOR_S "%s.keyfile", dir, iccid);
+}
+
+static gchar *
+load_string (GKeyFile    *keyfile,
+             const gchar *key)
+{
+    gchar *str;
+
+    /* Unknown values are stored as empty strings */
+    str = g_key_file_get_string (keyfile, GROUP_SIM, key, NULL);
+    if (str && !str[0])
+        g_clear_pointer (&str, g_free);
+    return str;
+}
+
+MMSimCacheEntry *
+mm_sim_cache_load (const gchar  *dir,
+                   const gchar  *iccid,
+                   GError      **error)
+{
+    g_autoptr(MMSimCacheEntry)  entry = NULL;
+    g_autoptr(GKeyFile)         keyfile = NULL;
+    g_autofree gchar           *path = NULL;
+    g_autofree gchar           *preferred_networks = NULL;
+    GError                     *inner_error = NULL;
+
+    path = build_path (dir, iccid, error);
+    if (!path)
+        return NULL;
+
+    keyfile = g_key_file_new ();
+    if (!g_key_file_load_from_file (keyfile, path, G_KEY_FILE_NONE, &inner_error)) {
+        if (g_error_matches (inner_error, G_FILE_ERROR, G_FILE_ERROR_NOENT)) {
+            g_error_free (inner_error);
+            return NULL;
+        }
+        g_propagate_error (error, inner_error);
+        return NULL;
+    }
+
+    if (g_key_file_get_integer (keyfile, GROUP_SIM, KEY_VERSION, NULL) != CACHE_VERSION)
+        return NULL;
+
+    entry = mm_sim_cache_entry_new ();
+    entry->imsi = load_string (keyfile, KEY_IMSI);
+    entry->eid = load_string (keyfile, KEY_EID);
+    entry->operator_identifier = load_string (keyfile, KEY_OPERATOR_IDENTIFIER);
+    entry->operator_name = load_string (keyfile, KEY_OPERATOR_NAME);
+    if (g_key_file_has_key (keyfile, GROUP_SIM, KEY_EMERGENCY_NUMBERS, NULL))
+        entry->emergency_numbers = g_key_file_get_string_list (keyfile, GROUP_SIM, KEY_EMERGENCY_NUMBERS, NULL, NULL);
+
+    preferred_networks = load_string (keyfile, KEY_PREFERRED_NETWORKS);
+    if (preferred_networks) {
+        entry->preferred_networks = g_variant_parse (G_VARIANT_TYPE ("a(su)"), preferred_networks, NULL, NULL, &inner_error);
+        if (!entry->preferred_networks) {
+            g_propagate_prefixed_error (error, inner_error, "Invalid preferred networks in cache entry: ");
+            return NULL;
+        }
+        g_variant_ref_sink (entry->preferred_networks);
+    }
+
+    return g_steal_pointer (&entry);
+}
+
+/*****************************************************************************/
+
+static void
+store_string (GKeyFile    *keyfile,
+              const gchar *key,
+              const gchar *str)
+{
+    g_key_file_set_string (keyfile, GROUP_SIM, key, str ? str : "");
+}
+
+gboolean
+mm_sim_cache_store (const gchar            *dir,
+                    const gchar            *iccid,
+                    const MMSimCacheEntry  *entry,
+                    GError                **error)
+{
+    g_autoptr(GKeyFile)  keyfile = NULL;
+    g_autofree gchar    *path = NULL;
+    g_autofree gchar    *preferred_networks = NULL;
+
+    path = build_path (dir, iccid, error);
+    if (!path)
+        return FALSE;
+
+    if (g_mkdir_with_parents (dir, 0700) < 0) {
+        g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (errno),
+                     "Couldn't create SIM cache directory '%s': %s", dir, g_strerror (errno));
+        return FALSE;
+    }
+
+    keyfile = g_key_file_new ();
+    g_key_file_set_integer (keyfile, GROUP_SIM, KEY_VERSION, CACHE_VERSION);
+    store_string (keyfile, KEY_IMSI, entry->imsi);
+    store_string (keyfile, KEY_EID, entry->eid);
+    store_string (keyfile, KEY_OPERATOR_IDENTIFIER, entry->operator_identifier);
+    store_string (keyfile, KEY_OPERATOR_NAME, entry->operator_name);
+    if (entry->emergency_numbers)
+        g_key_file_set_string_list (keyfile, GROUP_SIM, KEY_EMERGENCY_NUMBERS,
+                                    (const gchar * const *) entry->emergency_numbers,
+                                    g_strv_length (entry->emergency_numbers));
+    if (entry->preferred_networks)
+        preferred_networks = g_variant_print (entry->preferred_networks, FALSE);
+    store_string (keyfile, KEY_PREFERRED_NETWORKS, preferred_networks);
+
+    /* Written atomically */
+    return g_key_file_save_to_file (keyfile, path, error);
+}
+
+void
+mm_sim_cache_remove (const gchar *dir,
+                     const gchar *iccid)
+{
+    g_autofree gchar *path = NULL;
+
+    path = build_path (dir, iccid, NULL);
+    if (path)
+        g_unlink (path);
+}
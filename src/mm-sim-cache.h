@@ -0,0 +1,50 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#ifndef MM_SIM_CACHE_H
+#define MM_SIM_CACHE_H
+
+#include <glib.h>
+
+/* Persistent cache of the SIM card properties that don't change for a given
+ * card, stored in a directory with one keyfile per ICCID. */
+
+typedef struct {
+    gchar    *imsi;
+    gchar    *eid;
+    gchar    *operator_identifier;
+    gchar    *operator_name;
+    GStrv     emergency_numbers;
+    /* a(su), as in the PreferredNetworks property */
+    GVariant *preferred_networks;
+} MMSimCacheEntry;
+
+MMSimCacheEntry *mm_sim_cache_entry_new  (void);
+void             mm_sim_cache_entry_free (MMSimCacheEntry *entry);
+
+/* Returns NULL without error if there is no entry for the ICCID */
+MMSimCacheEntry *mm_sim_cache_load   (const gchar            *dir,
+                                      const gchar            *iccid,
+                                      GError                **error);
+gboolean         mm_sim_cache_store  (const gchar            *dir,
+                                      const gchar            *iccid,
+                                      const MMSimCacheEntry  *entry,
+                                      GError                **error);
+void             mm_sim_cache_remove (const gchar            *dir,
+                                      const gchar            *iccid);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMSimCacheEntry, mm_sim_cache_entry_free)
+
+#endif /* MM_SIM_CACHE_H */
@@ -123,12 +123,12 @@ load_sim_identifier (MMBaseSim *self,
     task = g_task_new (self, NULL, callback, user_data);
 
     message = mbim_message_subscriber_ready_status_query_new (NULL);
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)simid_subscriber_ready_state_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)simid_subscriber_ready_state_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -188,12 +188,12 @@ load_imsi (MMBaseSim *self,
     task = g_task_new (self, NULL, callback, user_data);
 
     message = mbim_message_subscriber_ready_status_query_new (NULL);
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)imsi_subscriber_ready_state_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)imsi_subscriber_ready_state_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -249,12 +249,12 @@ load_operator_identifier (MMBaseSim *self,
     task = g_task_new (self, NULL, callback, user_data);
 
     message = mbim_message_home_provider_query_new (NULL);
-    mbim_device_command (device,
-                         message,
-                         30,
-                         NULL,
-                         (GAsyncReadyCallback)load_operator_identifier_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 30,
+                                 NULL,
+                                 (GAsyncReadyCallback)load_operator_identifier_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -310,12 +310,12 @@ load_operator_name (MMBaseSim *self,
     task = g_task_new (self, NULL, callback, user_data);
 
     message = mbim_message_home_provider_query_new (NULL);
-    mbim_device_command (device,
-                         message,
-                         30,
-                         NULL,
-                         (GAsyncReadyCallback)load_operator_name_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 30,
+                                 NULL,
+                                 (GAsyncReadyCallback)load_operator_name_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -405,12 +405,12 @@ send_pin (MMBaseSim *self,
         return;
     }
 
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)pin_set_enter_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)pin_set_enter_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -501,12 +501,12 @@ send_puk (MMBaseSim *self,
         return;
     }
 
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)puk_set_enter_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)puk_set_enter_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -579,12 +579,12 @@ enable_pin (MMBaseSim *self,
         return;
     }
 
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)pin_set_enable_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)pin_set_enable_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -657,12 +657,12 @@ change_pin (MMBaseSim *self,
         return;
     }
 
-    mbim_device_command (device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)pin_set_change_ready,
-                         task);
+    mm_port_mbim_device_command (device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)pin_set_change_ready,
+                                 task);
     mbim_message_unref (message);
 }
 
@@ -177,12 +177,13 @@ sim_ready_check (GTask *task)
     }
 
     mm_obj_dbg (self, "checking SIM readiness");
-    qmi_client_uim_get_card_status (QMI_CLIENT_UIM (ctx->client_uim),
-                                    NULL,
-                                    5,
-                                    NULL,
-                                    (GAsyncReadyCallback) uim_get_card_status_ready,
-                                    task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_get_card_status,
+                                QMI_CLIENT_UIM (ctx->client_uim),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback) uim_get_card_status_ready,
+                                task);
 }
 
 static void
@@ -312,12 +313,13 @@ uim_read (MMSimQmi            *self,
                                                                  NULL);
     g_array_unref (file_path_bytes);
 
-    qmi_client_uim_read_transparent (QMI_CLIENT_UIM (client),
-                                     input,
-                                     10,
-                                     NULL,
-                                     (GAsyncReadyCallback)uim_read_ready,
-                                     task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_read_transparent,
+                                QMI_CLIENT_UIM (client),
+                                input,
+                                10,
+                                NULL,
+                                (GAsyncReadyCallback)uim_read_ready,
+                                task);
     qmi_message_uim_read_transparent_input_unref (input);
 }
 
@@ -412,12 +414,13 @@ dms_uim_get_iccid (MMSimQmi *self,
                             QMI_SERVICE_DMS, &client))
         return;
 
-    qmi_client_dms_uim_get_iccid (QMI_CLIENT_DMS (client),
-                                  NULL,
-                                  5,
-                                  NULL,
-                                  (GAsyncReadyCallback)dms_uim_get_iccid_ready,
-                                  task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_uim_get_iccid,
+                                QMI_CLIENT_DMS (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)dms_uim_get_iccid_ready,
+                                task);
 }
 
 static void
@@ -538,12 +541,13 @@ dms_uim_get_imsi (MMSimQmi *self,
                             QMI_SERVICE_DMS, &client))
         return;
 
-    qmi_client_dms_uim_get_imsi (QMI_CLIENT_DMS (client),
-                                 NULL,
-                                 5,
-                                 NULL,
-                                 (GAsyncReadyCallback)dms_uim_get_imsi_ready,
-                                 task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_uim_get_imsi,
+                                QMI_CLIENT_DMS (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)dms_uim_get_imsi_ready,
+                                task);
 }
 
 static void
@@ -675,12 +679,13 @@ load_operator_identifier (MMBaseSim           *self,
         return;
 
     mm_obj_dbg (self, "loading SIM operator identifier...");
-    qmi_client_nas_get_home_network (QMI_CLIENT_NAS (client),
-                                     NULL,
-                                     5,
-                                     NULL,
-                                     (GAsyncReadyCallback)load_operator_identifier_ready,
-                                     task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_get_home_network,
+                                QMI_CLIENT_NAS (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)load_operator_identifier_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -724,12 +729,13 @@ load_operator_name (MMBaseSim           *self,
         return;
 
     mm_obj_dbg (self, "loading SIM operator name...");
-    qmi_client_nas_get_home_network (QMI_CLIENT_NAS (client),
-                                     NULL,
-                                     5,
-                                     NULL,
-                                     (GAsyncReadyCallback)load_operator_name_ready,
-                                     task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_get_home_network,
+                                QMI_CLIENT_NAS (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)load_operator_name_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -835,12 +841,13 @@ load_preferred_networks (MMBaseSim           *self,
         return;
 
     mm_obj_dbg (self, "loading preferred network list...");
-    qmi_client_nas_get_preferred_networks (QMI_CLIENT_NAS (client),
-                                           NULL,
-                                           5,
-                                           NULL,
-                                           (GAsyncReadyCallback)load_preferred_networks_ready,
-                                           task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_get_preferred_networks,
+                                QMI_CLIENT_NAS (client),
+                                NULL,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)load_preferred_networks_ready,
+                                task);
 }
 
 /*****************************************************************************/
@@ -1045,12 +1052,13 @@ set_preferred_networks (MMBaseSim *self,
     /* Always clear any pre-existing networks */
     qmi_message_nas_set_preferred_networks_input_set_clear_previous_preferred_networks (input, TRUE, NULL);
 
-    qmi_client_nas_set_preferred_networks (QMI_CLIENT_NAS (client),
-                                           input,
-                                           5,
-                                           NULL,
-                                           (GAsyncReadyCallback)set_preferred_networks_ready,
-                                           task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_nas_set_preferred_networks,
+                                QMI_CLIENT_NAS (client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)set_preferred_networks_ready,
+                                task);
 
     qmi_message_nas_set_preferred_networks_input_unref (input);
     g_array_unref (preferred_nets_array);
@@ -1144,12 +1152,13 @@ uim_verify_pin (MMSimQmi *self,
         aid,
         NULL);
     g_array_unref (aid);
-    qmi_client_uim_verify_pin (QMI_CLIENT_UIM (client),
-                               input,
-                               5,
-                               NULL,
-                               (GAsyncReadyCallback) uim_verify_pin_ready,
-                               task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_verify_pin,
+                                QMI_CLIENT_UIM (client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback) uim_verify_pin_ready,
+                                task);
     qmi_message_uim_verify_pin_input_unref (input);
 }
 
@@ -1199,12 +1208,13 @@ dms_uim_verify_pin (MMSimQmi *self,
         QMI_DMS_UIM_PIN_ID_PIN,
         g_task_get_task_data (task),
         NULL);
-    qmi_client_dms_uim_verify_pin (QMI_CLIENT_DMS (client),
-                                   input,
-                                   5,
-                                   NULL,
-                                   (GAsyncReadyCallback) dms_uim_verify_pin_ready,
-                                   task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_uim_verify_pin,
+                                QMI_CLIENT_DMS (client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback) dms_uim_verify_pin_ready,
+                                task);
     qmi_message_dms_uim_verify_pin_input_unref (input);
 }
 
@@ -1306,7 +1316,8 @@ uim_unblock_pin (MMSimQmi *self,
         aid,
         NULL);
     g_array_unref (aid);
-    qmi_client_uim_unblock_pin (QMI_CLIENT_UIM (client),
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_unblock_pin,
+                                QMI_CLIENT_UIM (client),
                                 input,
                                 5,
                                 NULL,
@@ -1364,12 +1375,13 @@ dms_uim_unblock_pin (MMSimQmi *self,
         ctx->puk,
         ctx->new_pin,
         NULL);
-    qmi_client_dms_uim_unblock_pin (QMI_CLIENT_DMS (client),
-                                    input,
-                                    5,
-                                    NULL,
-                                    (GAsyncReadyCallback)dms_uim_unblock_pin_ready,
-                                    task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_uim_unblock_pin,
+                                QMI_CLIENT_DMS (client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)dms_uim_unblock_pin_ready,
+                                task);
     qmi_message_dms_uim_unblock_pin_input_unref (input);
 }
 
@@ -1476,12 +1488,13 @@ uim_change_pin (MMSimQmi *self,
         aid,
         NULL);
     g_array_unref (aid);
-    qmi_client_uim_change_pin (QMI_CLIENT_UIM (client),
-                               input,
-                               5,
-                               NULL,
-                               (GAsyncReadyCallback) uim_change_pin_ready,
-                               task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_change_pin,
+                                QMI_CLIENT_UIM (client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback) uim_change_pin_ready,
+                                task);
     qmi_message_uim_change_pin_input_unref (input);
 }
 
@@ -1534,12 +1547,13 @@ dms_uim_change_pin (MMSimQmi *self,
         ctx->old_pin,
         ctx->new_pin,
         NULL);
-    qmi_client_dms_uim_change_pin (QMI_CLIENT_DMS (client),
-                                   input,
-                                   5,
-                                   NULL,
-                                   (GAsyncReadyCallback) dms_uim_change_pin_ready,
-                                   task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_uim_change_pin,
+                                QMI_CLIENT_DMS (client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback) dms_uim_change_pin_ready,
+                                task);
     qmi_message_dms_uim_change_pin_input_unref (input);
 }
 
@@ -1645,12 +1659,13 @@ uim_enable_pin (MMSimQmi *self,
         aid,
         NULL);
     g_array_unref (aid);
-    qmi_client_uim_set_pin_protection (QMI_CLIENT_UIM (client),
-                                       input,
-                                       5,
-                                       NULL,
-                                       (GAsyncReadyCallback)uim_set_pin_protection_ready,
-                                       task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_uim_set_pin_protection,
+                                QMI_CLIENT_UIM (client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)uim_set_pin_protection_ready,
+                                task);
     qmi_message_uim_set_pin_protection_input_unref (input);
 }
 
@@ -1703,12 +1718,13 @@ dms_uim_enable_pin (MMSimQmi *self,
         ctx->enabled,
         ctx->pin,
         NULL);
-    qmi_client_dms_uim_set_pin_protection (QMI_CLIENT_DMS (client),
-                                           input,
-                                           5,
-                                           NULL,
-                                           (GAsyncReadyCallback)dms_uim_set_pin_protection_ready,
-                                           task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_dms_uim_set_pin_protection,
+                                QMI_CLIENT_DMS (client),
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)dms_uim_set_pin_protection_ready,
+                                task);
     qmi_message_dms_uim_set_pin_protection_input_unref (input);
 }
 
@@ -0,0 +1,236 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <config.h>
+
+#include "mm-sms-index.h"
+
+typedef struct {
+    gchar    *key;
+    gpointer  owner;
+    gint64    expiration;
+    GList    *link;
+} PendingMultipart;
+
+struct _MMSmsIndex {
+    /* (storage, index) (gint64 *) -> owner */
+    GHashTable *parts;
+    /* Pending multipart reassemblies, in creation order */
+    GQueue      pending;
+    /* number/reference/max (gchar *) -> PendingMultipart */
+    GHashTable *pending_by_key;
+    /* owner -> PendingMultipart */
+    GHashTable *pending_by_owner;
+    guint       max_pending;
+    /* Timeout of each pending reassembly, in microseconds */
+    gint64      pending_timeout;
+};
+
+/*****************************************************************************/
+
+static gint64
+part_key (MMSmsStorage storage,
+          guint        index)
+{
+    return (((gint64) storage) << 32) | index;
+}
+
+void
+mm_sms_index_add_part (MMSmsIndex   *self,
+                       MMSmsStorage  storage,
+                       guint         index,
+                       gpointer      owner)
+{
+    gint64 *key;
+
+    key = g_new (gint64, 1);
+    *key = part_key (storage, index);
+    g_hash_table_replace (self->parts, key, owner);
+}
+
+gpointer
+mm_sms_index_lookup_part (MMSmsIndex   *self,
+                          MMSmsStorage  storage,
+                          guint         index)
+{
+    gint64 key;
+
+    key = part_key (storage, index);
+    return g_hash_table_lookup (self->parts, &key);
+}
+
+void
+mm_sms_index_remove_part (MMSmsIndex   *self,
+                          MMSmsStorage  storage,
+                          guint         index,
+                          gpointer      owner)
+{
+    gint64 key;
+
+    /* Only remove the entry if it is still owned by the given owner */
+    key = part_key (storage, index);
+    if (g_hash_table_lookup (self->parts, &key) == owner)
+        g_hash_table_remove (self->parts, &key);
+}
+
+guint
+mm_sms_index_get_n_parts (MMSmsIndex *self)
+{
+    return g_hash_table_size (self->parts);
+}
+
+/*****************************************************************************/
+
+static gchar *
+multipart_key (const gchar *number,
+               guint        reference,
+               guint        max_parts)
+{
+    return g_strdup_printf ("%s/%u/%u", number ? number : "", reference, max_parts);
+}
+
+static void
+pending_multipart_remove (MMSmsIndex       *self,
+                          PendingMultipart *pending)
+{
+    g_queue_delete_link (&self->pending, pending->link);
+    g_hash_table_remove (self->pending_by_owner, pending->owner);
+    g_hash_table_remove (self->pending_by_key, pending->key);
+    g_free (pending->key);
+    g_slice_free (PendingMultipart, pending);
+}
+
+static void
+pending_multipart_expire (MMSmsIndex *self,
+                          gint64      now)
+{
+    PendingMultipart *pending;
+
+    /* All pending reassemblies have the same timeout, so the ones expiring
+     * first are always at the head of the queue */
+    while ((pending = g_queue_peek_head (&self->pending)) != NULL && now >= pending->expiration)
+        pending_multipart_remove (self, pending);
+}
+
+gpointer
+mm_sms_index_add_multipart (MMSmsIndex  *self,
+                            const gchar *number,
+                            guint        reference,
+                            guint        max_parts,
+                            gpointer     owner,
+                            gint64       now)
+{
+    PendingMultipart *pending;
+    gpointer          evicted = NULL;
+
+    pending_multipart_expire (self, now);
+
+    /* The owner may only be pending once */
+    pending = g_hash_table_lookup (self->pending_by_owner, owner);
+    if (pending)
+        pending_multipart_remove (self, pending);
+
+    pending = g_slice_new0 (PendingMultipart);
+    pending->key = multipart_key (number, reference, max_parts);
+    pending->owner = owner;
+    pending->expiration = now + self->pending_timeout;
+
+    /* A newer reassembly with the same key replaces the older one */
+    if (g_hash_table_contains (self->pending_by_key, pending->key))
+        pending_multipart_remove (self, g_hash_table_lookup (self->pending_by_key, pending->key));
+
+    /* Make room for the new one, evicting the oldest */
+    if (g_queue_get_length (&self->pending) >= self->max_pending) {
+        PendingMultipart *oldest;
+
+        oldest = g_queue_peek_head (&self->pending);
+        evicted = oldest->owner;
+        pending_multipart_remove (self, oldest);
+    }
+
+    g_queue_push_tail (&self->pending, pending);
+    pending->link = g_queue_peek_tail_link (&self->pending);
+    g_hash_table_insert (self->pending_by_key, pending->key, pending);
+    g_hash_table_insert (self->pending_by_owner, owner, pending);
+
+    return evicted;
+}
+
+gpointer
+mm_sms_index_lookup_multipart (MMSmsIndex  *self,
+                               const gchar *number,
+                               guint        reference,
+                               guint        max_parts,
+                               gint64       now)
+{
+    g_autofree gchar *key = NULL;
+    PendingMultipart *pending;
+
+    pending_multipart_expire (self, now);
+
+    key = multipart_key (number, reference, max_parts);
+    pending = g_hash_table_lookup (self->pending_by_key, key);
+    return pending ? pending->owner : NULL;
+}
+
+void
+mm_sms_index_remove_multipart (MMSmsIndex *self,
+                               gpointer    owner)
+{
+    PendingMultipart *pending;
+
+    pending = g_hash_table_lookup (self->pending_by_owner, owner);
+    if (pending)
+        pending_multipart_remove (self, pending);
+}
+
+guint
+mm_sms_index_get_n_pending (MMSmsIndex *self)
+{
+    return g_queue_get_length (&self->pending);
+}
+
+/*****************************************************************************/
+
+MMSmsIndex *
+mm_sms_index_new (guint max_pending,
+                  guint pending_timeout_secs)
+{
+    MMSmsIndex *self;
+
+    g_assert (max_pending > 0);
+
+    self = g_slice_new0 (MMSmsIndex);
+    self->parts = g_hash_table_new_full (g_int64_hash, g_int64_equal, g_free, NULL);
+    g_queue_init (&self->pending);
+    self->pending_by_key = g_hash_table_new (g_str_hash, g_str_equal);
+    self->pending_by_owner = g_hash_table_new (g_direct_hash, g_direct_equal);
+    self->max_pending = max_pending;
+    self->pending_timeout = (gint64) pending_timeout_secs * G_USEC_PER_SEC;
+    return self;
+}
+
+void
+mm_sms_index_free (MMSmsIndex *self)
+{
+    PendingMultipart *pending;
+
+    while ((pending = g_queue_peek_head (&self->pending)) != NULL)
+        pending_multipart_remove (self, pending);
+    g_hash_table_unref (self->pending_by_owner);
+    g_hash_table_unref (self->pending_by_key);
+    g_hash_table_unref (self->parts);
+    g_slice_free (MMSmsIndex, self);
+}
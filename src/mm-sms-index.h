@@ -0,0 +1,74 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#ifndef MM_SMS_INDEX_H
+#define MM_SMS_INDEX_H
+
+#include <glib.h>
+
+#include <ModemManager.h>
+
+/* Lookup index for the SMS list. Owners are opaque pointers (the SMS
+ * objects), not owned by the index.
+ *
+ * Stored parts are indexed by storage and index, so that duplicate parts
+ * are detected without walking the list.
+ *
+ * Multipart messages still being reassembled are indexed by number,
+ * concatenation reference and number of parts. Only a bounded number of
+ * pending reassemblies is kept, and each of them expires after the given
+ * timeout, so that a recycled reference never ends up merged into a stale
+ * message. Timestamps are given by the caller, in monotonic time
+ * microseconds. */
+
+typedef struct _MMSmsIndex MMSmsIndex;
+
+MMSmsIndex *mm_sms_index_new                (guint         max_pending,
+                                             guint         pending_timeout_secs);
+void        mm_sms_index_free               (MMSmsIndex   *self);
+
+void        mm_sms_index_add_part           (MMSmsIndex   *self,
+                                             MMSmsStorage  storage,
+                                             guint         index,
+                                             gpointer      owner);
+gpointer    mm_sms_index_lookup_part        (MMSmsIndex   *self,
+                                             MMSmsStorage  storage,
+                                             guint         index);
+void        mm_sms_index_remove_part        (MMSmsIndex   *self,
+                                             MMSmsStorage  storage,
+                                             guint         index,
+                                             gpointer      owner);
+
+/* Returns the owner evicted to make room for the new one, if any */
+gpointer    mm_sms_index_add_multipart      (MMSmsIndex   *self,
+                                             const gchar  *number,
+                                             guint         reference,
+                                             guint         max_parts,
+                                             gpointer      owner,
+                                             gint64        now);
+gpointer    mm_sms_index_lookup_multipart   (MMSmsIndex   *self,
+                                             const gchar  *number,
+                                             guint         reference,
+                                             guint         max_parts,
+                                             gint64        now);
+void        mm_sms_index_remove_multipart   (MMSmsIndex   *self,
+                                             gpointer      owner);
+
+guint       mm_sms_index_get_n_parts        (MMSmsIndex   *self);
+guint       mm_sms_index_get_n_pending      (MMSmsIndex   *self);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMSmsIndex, mm_sms_index_free)
+
+#endif /* MM_SMS_INDEX_H */
@@ -27,8 +27,16 @@
 #include "mm-iface-modem-messaging.h"
 #include "mm-sms-list.h"
 #include "mm-base-sms.h"
+#include "mm-sms-index.h"
 #include "mm-log-object.h"
 
+/* Multipart messages still being reassembled are only kept in the index
+ * for a limited time, and only up to a given number of them, so that
+ * recycled concatenation references don't end up merged into stale
+ * messages. */
+#define MULTIPART_PENDING_MAX          1024
+#define MULTIPART_PENDING_TIMEOUT_SECS (24 * 60 * 60)
+
 static void log_object_iface_init (MMLogObjectInterface *iface);
 
 G_DEFINE_TYPE_EXTENDED (MMSmsList, mm_sms_list, G_TYPE_OBJECT, 0,
@@ -53,10 +61,58 @@ struct _MMSmsListPrivate {
     MMBaseModem *modem;
     /* List of sms objects */
     GList *list;
+    /* Lookup index of received/stored parts and pending multiparts */
+    MMSmsIndex *index;
+    /* Locally created sms objects, not in the index as their parts may
+     * get stored at any time */
+    GList *local_list;
 };
 
 /*****************************************************************************/
 
+static void
+index_parts (MMSmsList *self,
+             MMBaseSms *sms)
+{
+    MMSmsStorage  storage;
+    GList        *l;
+
+    storage = mm_base_sms_get_storage (sms);
+    if (storage == MM_SMS_STORAGE_UNKNOWN)
+        return;
+
+    for (l = mm_base_sms_get_parts (sms); l; l = g_list_next (l)) {
+        guint index;
+
+        index = mm_sms_part_get_index ((MMSmsPart *)l->data);
+        if (index != SMS_PART_INVALID_INDEX)
+            mm_sms_index_add_part (self->priv->index, storage, index, sms);
+    }
+}
+
+static void
+unindex_sms (MMSmsList *self,
+             MMBaseSms *sms)
+{
+    MMSmsStorage  storage;
+    GList        *l;
+
+    mm_sms_index_remove_multipart (self->priv->index, sms);
+    self->priv->local_list = g_list_remove (self->priv->local_list, sms);
+
+    storage = mm_base_sms_get_storage (sms);
+    if (storage == MM_SMS_STORAGE_UNKNOWN)
+        return;
+
+    for (l = mm_base_sms_get_parts (sms); l; l = g_list_next (l))
+        mm_sms_index_remove_part (self->priv->index,
+                                  storage,
+                                  mm_sms_part_get_index ((MMSmsPart *)l->data),
+                                  sms);
+}
+
+/*****************************************************************************/
+
 gboolean
 mm_sms_list_has_local_multipart_reference (MMSmsList *self,
                                            const gchar *number,
@@ -155,6 +211,7 @@ delete_ready (MMBaseSms *sms,
                             path,
                             (GCompareFunc)cmp_sms_by_path);
     if (l) {
+        unindex_sms (self, MM_BASE_SMS (l->data));
         g_object_unref (MM_BASE_SMS (l->data));
         self->priv->list = g_list_delete_link (self->priv->list, l);
     }
@@ -212,6 +269,7 @@ mm_sms_list_add_sms (MMSmsList *self,
                      MMBaseSms *sms)
 {
     self->priv->list = g_list_prepend (self->priv->list, g_object_ref (sms));
+    self->priv->local_list = g_list_prepend (self->priv->local_list, sms);
     g_signal_emit (self, signals[SIGNAL_ADDED], 0,
                    mm_base_sms_get_path (sms),
                    FALSE);
@@ -219,16 +277,6 @@ mm_sms_list_add_sms (MMSmsList *self,
 
 /*****************************************************************************/
 
-static guint
-cmp_sms_by_concat_reference (MMBaseSms *sms,
-                             gpointer user_data)
-{
-    if (!mm_base_sms_is_multipart (sms))
-        return -1;
-
-    return (GPOINTER_TO_UINT (user_data) - mm_base_sms_get_multipart_reference (sms));
-}
-
 typedef struct {
     guint part_index;
     MMSmsStorage storage;
@@ -260,6 +308,7 @@ take_singlepart (MMSmsList *self,
         return FALSE;
 
     self->priv->list = g_list_prepend (self->priv->list, sms);
+    index_parts (self, sms);
     g_signal_emit (self, signals[SIGNAL_ADDED], 0,
                    mm_base_sms_get_path (sms),
                    state == MM_SMS_STATE_RECEIVED);
@@ -273,18 +322,35 @@ take_multipart (MMSmsList *self,
                 MMSmsStorage storage,
                 GError **error)
 {
-    GList *l;
     MMBaseSms *sms;
+    MMBaseSms *evicted;
     guint concat_reference;
+    guint concat_max;
+    guint index;
+    gint64 now;
 
     concat_reference = mm_sms_part_get_concat_reference (part);
-    l = g_list_find_custom (self->priv->list,
-                            GUINT_TO_POINTER (concat_reference),
-                            (GCompareFunc)cmp_sms_by_concat_reference);
-    if (l) {
+    concat_max = mm_sms_part_get_concat_max (part);
+    index = mm_sms_part_get_index (part);
+    now = g_get_monotonic_time ();
+
+    sms = mm_sms_index_lookup_multipart (self->priv->index,
+                                         mm_sms_part_get_number (part),
+                                         concat_reference,
+                                         concat_max,
+                                         now);
+    if (sms) {
         /* Try to take the part */
         mm_obj_dbg (self, "found existing multipart SMS object with reference '%u': adding new part", concat_reference);
-        return mm_base_sms_multipart_take_part (MM_BASE_SMS (l->data), part, error);
+        if (!mm_base_sms_multipart_take_part (sms, part, error))
+            return FALSE;
+
+        if (index != SMS_PART_INVALID_INDEX && storage != MM_SMS_STORAGE_UNKNOWN)
+            mm_sms_index_add_part (self->priv->index, storage, index, sms);
+        /* No longer pending once all parts are received */
+        if (mm_base_sms_multipart_is_complete (sms))
+            mm_sms_index_remove_multipart (self->priv->index, sms);
+        return TRUE;
     }
 
     /* Create new Multipart */
@@ -299,9 +365,21 @@ take_multipart (MMSmsList *self,
         return FALSE;
 
     mm_obj_dbg (self, "creating new multipart SMS object: need to receive %u parts with reference '%u'",
-                mm_sms_part_get_concat_max (part),
+                concat_max,
                 concat_reference);
     self->priv->list = g_list_prepend (self->priv->list, sms);
+    index_parts (self, sms);
+    if (!mm_base_sms_multipart_is_complete (sms)) {
+        evicted = mm_sms_index_add_multipart (self->priv->index,
+                                              mm_sms_part_get_number (part),
+                                              concat_reference,
+                                              concat_max,
+                                              sms,
+                                              now);
+        if (evicted)
+            mm_obj_dbg (self, "too many multipart SMS objects pending: oldest one with reference '%u' won't take new parts",
+                        mm_base_sms_get_multipart_reference (evicted));
+    }
     g_signal_emit (self, signals[SIGNAL_ADDED], 0,
                    mm_base_sms_get_path (sms),
                    (state == MM_SMS_STATE_RECEIVED ||
@@ -321,10 +399,14 @@ mm_sms_list_has_part (MMSmsList *self,
         index == SMS_PART_INVALID_INDEX)
         return FALSE;
 
+    if (mm_sms_index_lookup_part (self->priv->index, storage, index))
+        return TRUE;
+
+    /* Locally created messages may have been stored after being added */
     ctx.part_index = index;
     ctx.storage = storage;
 
-    return !!g_list_find_custom (self->priv->list,
+    return !!g_list_find_custom (self->priv->local_list,
                                  &ctx,
                                  (GCompareFunc)cmp_sms_by_part_index_and_storage);
 }
@@ -443,6 +525,8 @@ mm_sms_list_init (MMSmsList *self)
     self->priv = G_TYPE_INSTANCE_GET_PRIVATE (self,
                                               MM_TYPE_SMS_LIST,
                                               MMSmsListPrivate);
+    self->priv->index = mm_sms_index_new (MULTIPART_PENDING_MAX,
+                                          MULTIPART_PENDING_TIMEOUT_SECS);
 }
 
 static void
@@ -451,6 +535,8 @@ dispose (GObject *object)
     MMSmsList *self = MM_SMS_LIST (object);
 
     g_clear_object (&self->priv->modem);
+    g_clear_pointer (&self->priv->index, mm_sms_index_free);
+    g_clear_pointer (&self->priv->local_list, g_list_free);
     g_list_free_full (self->priv->list, g_object_unref);
     self->priv->list = NULL;
 
@@ -173,12 +173,12 @@ sms_send_next_part (GTask *task)
                                              &send_record,
                                              NULL,
                                              NULL);
-    mbim_device_command (ctx->device,
-                         message,
-                         MM_BASE_SMS_DEFAULT_SEND_TIMEOUT,
-                         NULL,
-                         (GAsyncReadyCallback)sms_send_set_ready,
-                         task);
+    mm_port_mbim_device_command (ctx->device,
+                                 message,
+                                 MM_BASE_SMS_DEFAULT_SEND_TIMEOUT,
+                                 NULL,
+                                 (GAsyncReadyCallback)sms_send_set_ready,
+                                 task);
     mbim_message_unref (message);
     g_free (pdu);
 }
@@ -302,12 +302,12 @@ delete_next_part (GTask *task)
     message = mbim_message_sms_delete_set_new (MBIM_SMS_FLAG_INDEX,
                                                (guint32)mm_sms_part_get_index ((MMSmsPart *)ctx->current->data),
                                                NULL);
-    mbim_device_command (ctx->device,
-                         message,
-                         10,
-                         NULL,
-                         (GAsyncReadyCallback)sms_delete_set_ready,
-                         task);
+    mm_port_mbim_device_command (ctx->device,
+                                 message,
+                                 10,
+                                 NULL,
+                                 (GAsyncReadyCallback)sms_delete_set_ready,
+                                 task);
     mbim_message_unref (message);
 
 }
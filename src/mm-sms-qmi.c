@@ -248,12 +248,13 @@ sms_store_next_part (GTask *task)
          QMI_WMS_MESSAGE_FORMAT_CDMA),
         array,
         NULL);
-    qmi_client_wms_raw_write (ctx->client,
-                              input,
-                              5,
-                              NULL,
-                              (GAsyncReadyCallback)store_ready,
-                              task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wms_raw_write,
+                                ctx->client,
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)store_ready,
+                                task);
     qmi_message_wms_raw_write_input_unref (input);
     g_array_unref (array);
 }
@@ -435,12 +436,13 @@ sms_send_generic (GTask *task)
         array,
         NULL);
 
-    qmi_client_wms_raw_send (ctx->client,
-                             input,
-                             MM_BASE_SMS_DEFAULT_SEND_TIMEOUT,
-                             NULL,
-                             (GAsyncReadyCallback)send_generic_ready,
-                             task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wms_raw_send,
+                                ctx->client,
+                                input,
+                                MM_BASE_SMS_DEFAULT_SEND_TIMEOUT,
+                                NULL,
+                                (GAsyncReadyCallback)send_generic_ready,
+                                task);
     qmi_message_wms_raw_send_input_unref (input);
     g_array_unref (array);
 }
@@ -562,13 +564,13 @@ sms_send_from_storage (GTask *task)
          QMI_WMS_MESSAGE_MODE_CDMA),
         NULL);
 
-    qmi_client_wms_send_from_memory_storage (
-        ctx->client,
-        input,
-        MM_BASE_SMS_DEFAULT_SEND_TIMEOUT,
-        NULL,
-        (GAsyncReadyCallback)send_from_storage_ready,
-        task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wms_send_from_memory_storage,
+                                ctx->client,
+                                input,
+                                MM_BASE_SMS_DEFAULT_SEND_TIMEOUT,
+                                NULL,
+                                (GAsyncReadyCallback)send_from_storage_ready,
+                                task);
     qmi_message_wms_send_from_memory_storage_input_unref (input);
 }
 
@@ -744,12 +746,13 @@ delete_next_part (GTask *task)
          QMI_WMS_MESSAGE_MODE_GSM_WCDMA:
          QMI_WMS_MESSAGE_MODE_CDMA),
         NULL);
-    qmi_client_wms_delete (ctx->client,
-                           input,
-                           5,
-                           NULL,
-                           (GAsyncReadyCallback)delete_part_ready,
-                           task);
+    MM_PORT_QMI_CLIENT_REQUEST (qmi_client_wms_delete,
+                                ctx->client,
+                                input,
+                                5,
+                                NULL,
+                                (GAsyncReadyCallback)delete_part_ready,
+                                task);
     qmi_message_wms_delete_input_unref (input);
 }
 
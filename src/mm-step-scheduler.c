@@ -0,0 +1,276 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <config.h>
+
+#include "mm-step-scheduler.h"
+#include "mm-log.h"
+
+typedef enum {
+    STEP_STATE_PENDING,
+    STEP_STATE_RUNNING,
+    STEP_STATE_DONE,
+} StepState;
+
+typedef struct {
+    guint                    id;
+    gchar                   *name;
+    MMStepSchedulerStepFunc  func;
+    gpointer                 user_data;
+    GArray                  *dependencies;
+    StepState                state;
+    gint64                   start_time;
+} Step;
+
+struct _MMStepScheduler {
+    gpointer                 log_object;
+    gchar                   *name;
+    guint                    max_in_flight;
+    /* Steps, in the order they were added */
+    GPtrArray               *steps;
+    guint                    n_in_flight;
+    guint                    max_reached_in_flight;
+    gboolean                 aborted;
+    gboolean                 dispatching;
+    gboolean                 redispatch;
+    /* Sum of the time spent in all steps, in microseconds */
+    gint64                   steps_time;
+    gint64                   start_time;
+    MMStepSchedulerDoneFunc  done;
+    gpointer                 done_user_data;
+};
+
+static void
+step_free (Step *step)
+{
+    g_array_unref (step->dependencies);
+    g_free (step->name);
+    g_slice_free (Step, step);
+}
+
+static Step *
+find_step (MMStepScheduler *self,
+           guint            step_id)
+{
+    guint i;
+
+    for (i = 0; i < self->steps->len; i++) {
+        Step *step;
+
+        step = g_ptr_array_index (self->steps, i);
+        if (step->id == step_id)
+            return step;
+    }
+    return NULL;
+}
+
+static gboolean
+step_is_ready (MMStepScheduler *self,
+               Step            *step)
+{
+    guint i;
+
+    for (i = 0; i < step->dependencies->len; i++) {
+        Step *dependency;
+
+        dependency = find_step (self, g_array_index (step->dependencies, guint, i));
+        if (dependency->state != STEP_STATE_DONE)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/*****************************************************************************/
+
+static void
+dispatch (MMStepScheduler *self)
+{
+    gboolean pending = FALSE;
+    guint    i;
+
+    /* Steps may finish right away from within their own step function, so
+     * avoid recursing */
+    if (self->dispatching) {
+        self->redispatch = TRUE;
+        return;
+    }
+
+    self->dispatching = TRUE;
+    do {
+        self->redispatch = FALSE;
+        pending = FALSE;
+
+        for (i = 0; i < self->steps->len; i++) {
+            Step *step;
+
+            step = g_ptr_array_index (self->steps, i);
+            if (step->state != STEP_STATE_PENDING)
+                continue;
+            pending = TRUE;
+
+            if (self->aborted || self->n_in_flight >= self->max_in_flight)
+                break;
+            if (!step_is_ready (self, step))
+                continue;
+
+            step->state = STEP_STATE_RUNNING;
+            step->start_time = g_get_monotonic_time ();
+            self->n_in_flight++;
+            self->max_reached_in_flight = MAX (self->max_reached_in_flight, self->n_in_flight);
+            step->func (self, step->id, step->user_data);
+        }
+    } while (self->redispatch);
+    self->dispatching = FALSE;
+
+    if (self->n_in_flight > 0 || (pending && !self->aborted))
+        return;
+
+    mm_obj_dbg (self->log_object, "%s: %s in %.3lfs (%.3lfs running steps)",
+                self->name,
+                self->aborted ? "aborted" : "all steps finished",
+                (g_get_monotonic_time () - self->start_time) / (gdouble) G_USEC_PER_SEC,
+                self->steps_time / (gdouble) G_USEC_PER_SEC);
+
+    /* Note: the scheduler may be freed by the done callback */
+    g_assert (self->done);
+    self->done (self, self->done_user_data);
+}
+
+void
+mm_step_scheduler_step_done (MMStepScheduler *self,
+                             guint            step_id)
+{
+    Step   *step;
+    gint64  elapsed;
+
+    step = find_step (self, step_id);
+    g_assert (step);
+    g_assert (step->state == STEP_STATE_RUNNING);
+
+    step->state = STEP_STATE_DONE;
+    g_assert (self->n_in_flight > 0);
+    self->n_in_flight--;
+
+    elapsed = g_get_monotonic_time () - step->start_time;
+    self->steps_time += elapsed;
+    mm_obj_dbg (self->log_object, "%s: step '%s' finished in %.3lfs",
+                self->name, step->name, elapsed / (gdouble) G_USEC_PER_SEC);
+
+    dispatch (self);
+}
+
+void
+mm_step_scheduler_run (MMStepScheduler         *self,
+                       MMStepSchedulerDoneFunc  done,
+                       gpointer                 user_data)
+{
+    g_assert (!self->done);
+
+    self->done = done;
+    self->done_user_data = user_data;
+    self->start_time = g_get_monotonic_time ();
+
+    mm_obj_dbg (self->log_object, "%s: running %u steps (up to %u in flight)",
+                self->name, self->steps->len, self->max_in_flight);
+    dispatch (self);
+}
+
+void
+mm_step_scheduler_abort (MMStepScheduler *self)
+{
+    /* No new steps are started, the ones in flight are waited for */
+    self->aborted = TRUE;
+}
+
+guint
+mm_step_scheduler_get_max_reached_in_flight (MMStepScheduler *self)
+{
+    return self->max_reached_in_flight;
+}
+
+/*****************************************************************************/
+
+void
+mm_step_scheduler_add_step (MMStepScheduler         *self,
+                            guint                    step_id,
+                            const gchar             *step_name,
+                            MMStepSchedulerStepFunc  func,
+                            gpointer                 user_data)
+{
+    Step *step;
+
+    g_assert (!self->done);
+    g_assert (!find_step (self, step_id));
+
+    step = g_slice_new0 (Step);
+    step->id = step_id;
+    step->name = g_strdup (step_name);
+    step->func = func;
+    step->user_data = user_data;
+    step->dependencies = g_array_new (FALSE, FALSE, sizeof (guint));
+    step->state = STEP_STATE_PENDING;
+    g_ptr_array_add (self->steps, step);
+}
+
+void
+mm_step_scheduler_add_dependency (MMStepScheduler *self,
+                                  guint            step_id,
+                                  guint            dependency_id)
+{
+    Step *step;
+    Step *dependency;
+    guint i;
+
+    step = find_step (self, step_id);
+    dependency = find_step (self, dependency_id);
+    g_assert (step && dependency);
+
+    /* Requiring dependencies to be added first ensures there are no cycles */
+    for (i = 0; i < self->steps->len && g_ptr_array_index (self->steps, i) != step; i++) {
+        if (g_ptr_array_index (self->steps, i) == dependency)
+            break;
+    }
+    g_assert (g_ptr_array_index (self->steps, i) == dependency);
+
+    g_array_append_val (step->dependencies, dependency_id);
+}
+
+MMStepScheduler *
+mm_step_scheduler_new (gpointer     log_object,
+                       const gchar *name,
+                       guint        max_in_flight)
+{
+    MMStepScheduler *self;
+
+    g_assert (max_in_flight > 0);
+
+    self = g_slice_new0 (MMStepScheduler);
+    self->log_object = log_object;
+    self->name = g_strdup (name);
+    self->max_in_flight = max_in_flight;
+    self->steps = g_ptr_array_new_with_free_func ((GDestroyNotify)step_free);
+    return self;
+}
+
+void
+mm_step_scheduler_free (MMStepScheduler *self)
+{
+    /* Must not be freed with steps in flight */
+    g_assert (self->n_in_flight == 0);
+
+    g_ptr_array_unref (self->steps);
+    g_free (self->name);
+    g_slice_free (MMStepScheduler, self);
+}
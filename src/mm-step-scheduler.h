@@ -0,0 +1,67 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#ifndef MM_STEP_SCHEDULER_H
+#define MM_STEP_SCHEDULER_H
+
+#include <glib.h>
+
+/* Scheduler of asynchronous steps with dependencies among them.
+ *
+ * Each step is started as soon as all its dependencies have finished, with
+ * up to a maximum number of steps in flight at the same time. A maximum of
+ * 1 runs the steps one after the other, in the order they were added.
+ *
+ * Each step function must report its completion with
+ * mm_step_scheduler_step_done(), either right away or once the operation
+ * it started finishes. Once all steps are done (or once the ones in flight
+ * are done after an abort), the done callback is called; the scheduler may
+ * be freed from within that callback. */
+
+typedef struct _MMStepScheduler MMStepScheduler;
+
+typedef void (* MMStepSchedulerStepFunc) (MMStepScheduler *scheduler,
+                                          guint            step_id,
+                                          gpointer         user_data);
+typedef void (* MMStepSchedulerDoneFunc) (MMStepScheduler *scheduler,
+                                          gpointer         user_data);
+
+MMStepScheduler *mm_step_scheduler_new            (gpointer                 log_object,
+                                                   const gchar             *name,
+                                                   guint                    max_in_flight);
+void             mm_step_scheduler_free           (MMStepScheduler         *self);
+
+/* Dependencies must have been added as steps before */
+void             mm_step_scheduler_add_step       (MMStepScheduler         *self,
+                                                   guint                    step_id,
+                                                   const gchar             *step_name,
+                                                   MMStepSchedulerStepFunc  func,
+                                                   gpointer                 user_data);
+void             mm_step_scheduler_add_dependency (MMStepScheduler         *self,
+                                                   guint                    step_id,
+                                                   guint                    dependency_id);
+
+void             mm_step_scheduler_run            (MMStepScheduler         *self,
+                                                   MMStepSchedulerDoneFunc  done,
+                                                   gpointer                 user_data);
+void             mm_step_scheduler_step_done      (MMStepScheduler         *self,
+                                                   guint                    step_id);
+void             mm_step_scheduler_abort          (MMStepScheduler         *self);
+
+guint            mm_step_scheduler_get_max_reached_in_flight (MMStepScheduler *self);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (MMStepScheduler, mm_step_scheduler_free)
+
+#endif /* MM_STEP_SCHEDULER_H */
@@ -0,0 +1,243 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <config.h>
+#include <unistd.h>
+
+#include "mm-trace.h"
+#include "mm-log-object.h"
+
+/* Oldest events are overwritten once the buffer is full */
+#define MAX_EVENTS 4096
+
+/* Track used for events not bound to any object */
+#define DEFAULT_TRACK_NAME "ModemManager"
+
+gboolean mm_trace_enabled;
+
+typedef struct {
+    gint64       timestamp;
+    guint        track;
+    const gchar *phase;
+    gchar       *step;
+    gboolean     begin;
+} Event;
+
+typedef struct {
+    gint64      start_time;
+    Event      *events;
+    guint64     n_events;
+    /* Track name -> track index + 1 */
+    GHashTable *tracks;
+    GPtrArray  *track_names;
+    /* "track/phase" -> step currently running, for mm_trace_step() */
+    GHashTable *open_steps;
+} Trace;
+
+static Trace *trace;
+
+/*****************************************************************************/
+
+static guint
+get_track (gpointer obj)
+{
+    const gchar *name = DEFAULT_TRACK_NAME;
+    guint        track;
+
+    if (obj && MM_IS_LOG_OBJECT (obj))
+        name = mm_log_object_get_id (MM_LOG_OBJECT (obj));
+
+    track = GPOINTER_TO_UINT (g_hash_table_lookup (trace->tracks, name));
+    if (!track) {
+        g_ptr_array_add (trace->track_names, g_strdup (name));
+        track = trace->track_names->len;
+        g_hash_table_insert (trace->tracks, g_strdup (name), GUINT_TO_POINTER (track));
+    }
+    return track - 1;
+}
+
+static void
+record (guint        track,
+        const gchar *phase,
+        const gchar *step,
+        gboolean     begin)
+{
+    Event *event;
+
+    event = &trace->events[trace->n_events++ % MAX_EVENTS];
+    g_free (event->step);
+    event->timestamp = g_get_monotonic_time () - trace->start_time;
+    event->track = track;
+    event->phase = phase;
+    event->step = g_strdup (step);
+    event->begin = begin;
+}
+
+void
+mm_trace_add_event (gpointer      obj,
+                    const gchar  *phase,
+                    const gchar  *step,
+                    MMTraceEvent  event)
+{
+    g_autofree gchar *key = NULL;
+    const gchar      *open_step;
+    guint             track;
+
+    g_assert (phase);
+
+    if (!trace)
+        return;
+
+    track = get_track (obj);
+
+    switch (event) {
+    case MM_TRACE_EVENT_BEGIN:
+        record (track, phase, step, TRUE);
+        return;
+    case MM_TRACE_EVENT_END:
+        /* Ending the phase also ends its last step, so that step machines
+         * don't need to care about it in their early exits */
+        if (!step) {
+            key = g_strdup_printf ("%u/%s", track, phase);
+            open_step = g_hash_table_lookup (trace->open_steps, key);
+            if (open_step) {
+                record (track, phase, open_step, FALSE);
+                g_hash_table_remove (trace->open_steps, key);
+            }
+        }
+        record (track, phase, step, FALSE);
+        return;
+    case MM_TRACE_EVENT_STEP:
+        key = g_strdup_printf ("%u/%s", track, phase);
+        open_step = g_hash_table_lookup (trace->open_steps, key);
+        if (open_step) {
+            if (!g_strcmp0 (open_step, step))
+                return;
+            record (track, phase, open_step, FALSE);
+        }
+        if (step) {
+            record (track, phase, step, TRUE);
+            g_hash_table_replace (trace->open_steps, g_steal_pointer (&key), g_strdup (step));
+        } else
+            g_hash_table_remove (trace->open_steps, key);
+        return;
+    default:
+        g_assert_not_reached ();
+    }
+}
+
+/*****************************************************************************/
+
+static void
+append_json_string (GString     *str,
+                    const gchar *value)
+{
+    const gchar *p;
+
+    g_string_append_c (str, '"');
+    for (p = value; *p; p++) {
+        if (*p == '"' || *p == '\\')
+            g_string_append_printf (str, "\\%c", *p);
+        else if ((guchar) *p < 0x20)
+            g_string_append_printf (str, "\\u%04x", (guint) *p);
+        else
+            g_string_append_c (str, *p);
+    }
+    g_string_append_c (str, '"');
+}
+
+gchar *
+mm_trace_build_json (void)
+{
+    GString *str;
+    guint64  first;
+    guint64  i;
+    guint    pid;
+
+    str = g_string_new ("{\"traceEvents\":[");
+    if (!trace)
+        goto out;
+
+    pid = (guint) getpid ();
+
+    /* Name tracks after the objects */
+    for (i = 0; i < trace->track_names->len; i++) {
+        if (i)
+            g_string_append_c (str, ',');
+        g_string_append_printf (str, "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":",
+                                pid, (guint) i);
+        append_json_string (str, g_ptr_array_index (trace->track_names, i));
+        g_string_append (str, "}}");
+    }
+
+    /* Spans are given as async events with the track as id, so that the
+     * steps are nested in the span of their phase */
+    first = trace->n_events > MAX_EVENTS ? trace->n_events - MAX_EVENTS : 0;
+    for (i = first; i < trace->n_events; i++) {
+        const Event *event;
+
+        event = &trace->events[i % MAX_EVENTS];
+        if (str->str[str->len - 1] != '[')
+            g_string_append_c (str, ',');
+        g_string_append (str, "\n{\"name\":");
+        append_json_string (str, event->step ? event->step : event->phase);
+        g_string_append (str, ",\"cat\":");
+        append_json_string (str, event->phase);
+        g_string_append_printf (str, ",\"ph\":\"%c\",\"id\":%u,\"pid\":%u,\"tid\":%u,\"ts\":%" G_GINT64_FORMAT "}",
+                                event->begin ? 'b' : 'e',
+                                event->track, pid, event->track,
+                                event->timestamp);
+    }
+
+out:
+    g_string_append (str, "\n]}\n");
+    return g_string_free (str, FALSE);
+}
+
+/*****************************************************************************/
+
+void
+mm_trace_setup (gboolean enabled)
+{
+    mm_trace_shutdown ();
+    if (!enabled)
+        return;
+
+    trace = g_new0 (Trace, 1);
+    trace->start_time = g_get_monotonic_time ();
+    trace->events = g_new0 (Event, MAX_EVENTS);
+    trace->tracks = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    trace->track_names = g_ptr_array_new_with_free_func (g_free);
+    trace->open_steps = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    mm_trace_enabled = TRUE;
+}
+
+void
+mm_trace_shutdown (void)
+{
+    guint i;
+
+    mm_trace_enabled = FALSE;
+    if (!trace)
+        return;
+
+    for (i = 0; i < MAX_EVENTS; i++)
+        g_free (trace->events[i].step);
+    g_free (trace->events);
+    g_hash_table_unref (trace->tracks);
+    g_ptr_array_unref (trace->track_names);
+    g_hash_table_unref (trace->open_steps);
+    g_clear_pointer (&trace, g_free);
+}
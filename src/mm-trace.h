@@ -0,0 +1,65 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#ifndef MM_TRACE_H
+#define MM_TRACE_H
+
+#include <glib.h>
+
+/* Span tracing of the modem lifecycle (probing, initialization, enabling,
+ * connection...), kept in a fixed size ring buffer and exported in the
+ * Chrome trace event format, which Perfetto and chrome://tracing load.
+ *
+ * Spans are identified by the object (its log id is used as track name),
+ * the phase and the step. The phase must be a static string; a NULL step
+ * refers to the span of the whole phase.
+ *
+ * When tracing is disabled every trace point is just a branch on
+ * mm_trace_enabled. */
+
+typedef enum {
+    MM_TRACE_EVENT_BEGIN,
+    MM_TRACE_EVENT_END,
+    MM_TRACE_EVENT_STEP,
+} MMTraceEvent;
+
+extern gboolean mm_trace_enabled;
+
+void   mm_trace_setup      (gboolean      enabled);
+void   mm_trace_shutdown   (void);
+void   mm_trace_add_event  (gpointer      obj,
+                            const gchar  *phase,
+                            const gchar  *step,
+                            MMTraceEvent  event);
+gchar *mm_trace_build_json (void);
+
+#define mm_trace_begin(obj, phase, step) G_STMT_START {                    \
+        if (G_UNLIKELY (mm_trace_enabled))                                 \
+            mm_trace_add_event (obj, phase, step, MM_TRACE_EVENT_BEGIN);   \
+    } G_STMT_END
+
+#define mm_trace_end(obj, phase, step) G_STMT_START {                      \
+        if (G_UNLIKELY (mm_trace_enabled))                                 \
+            mm_trace_add_event (obj, phase, step, MM_TRACE_EVENT_END);     \
+    } G_STMT_END
+
+/* For step machines: ends the previous step of the phase, if any, and
+ * begins the given one. A NULL step just ends the previous one. */
+#define mm_trace_step(obj, phase, step) G_STMT_START {                     \
+        if (G_UNLIKELY (mm_trace_enabled))                                 \
+            mm_trace_add_event (obj, phase, step, MM_TRACE_EVENT_STEP);    \
+    } G_STMT_END
+
+#endif /* MM_TRACE_H */
@@ -0,0 +1,580 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <glib.h>
+#include <gio/gio.h>
+#include <locale.h>
+
+#include <ModemManager.h>
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+#include "mm-auth-cache.h"
+#include "mm-auth-provider.h"
+#include "mm-log-test.h"
+
+#define TEST_TTL_SECS 30
+
+/*****************************************************************************/
+/* Cache */
+
+static void
+test_cache_hits (void)
+{
+    g_autoptr(MMAuthCache) cache = NULL;
+    gint64                 now = 1;
+    guint                  i;
+
+    cache = mm_auth_cache_new (TEST_TTL_SECS);
+    g_assert (!mm_auth_cache_lookup (cache, ":1.10", MM_AUTHORIZATION_MESSAGING, now));
+    mm_auth_cache_add (cache, ":1.10", MM_AUTHORIZATION_MESSAGING, now);
+
+    for (i = 0; i < 999; i++) {
+        now += G_USEC_PER_SEC / 100;
+        g_assert (mm_auth_cache_lookup (cache, ":1.10", MM_AUTHORIZATION_MESSAGING, now));
+    }
+
+    g_assert_cmpuint (mm_auth_cache_get_misses (cache), ==, 1);
+    g_assert_cmpuint (mm_auth_cache_get_hits (cache), ==, 999);
+    g_assert_cmpuint (mm_auth_cache_get_n_entries (cache), ==, 1);
+}
+
+static void
+test_cache_expiration (void)
+{
+    g_autoptr(MMAuthCache) cache = NULL;
+    gint64                 now = 1;
+
+    cache = mm_auth_cache_new (TEST_TTL_SECS);
+    mm_auth_cache_add (cache, ":1.10", MM_AUTHORIZATION_MESSAGING, now);
+    now += (TEST_TTL_SECS * G_USEC_PER_SEC) - 1;
+    g_assert (mm_auth_cache_lookup (cache, ":1.10", MM_AUTHORIZATION_MESSAGING, now));
+
+    /* Expired entries are removed on lookup */
+    now += 1;
+    g_assert (!mm_auth_cache_lookup (cache, ":1.10", MM_AUTHORIZATION_MESSAGING, now));
+    g_assert (!mm_auth_cache_has_sender (cache, ":1.10"));
+    g_assert_cmpuint (mm_auth_cache_get_n_entries (cache), ==, 0);
+}
+
+static void
+test_cache_disabled (void)
+{
+    g_autoptr(MMAuthCache) cache = NULL;
+
+    /* TTL 0 disables the cache */
+    cache = mm_auth_cache_new (0);
+    mm_auth_cache_add (cache, ":1.10", MM_AUTHORIZATION_MESSAGING, 1);
+    g_assert (!mm_auth_cache_lookup (cache, ":1.10", MM_AUTHORIZATION_MESSAGING, 1));
+    g_assert_cmpuint (mm_auth_cache_get_n_entries (cache), ==, 0);
+}
+
+/*****************************************************************************/
+/* Mock authority, given to the auth provider instead of the polkit one. It
+ * follows a set of sender/authorization rules, and counts the number of
+ * checks that reach it. */
+
+#define MOCK_TYPE_AUTHORITY (mock_authority_get_type ())
+G_DECLARE_FINAL_TYPE (MockAuthority, mock_authority, MOCK, AUTHORITY, GObject)
+
+struct _MockAuthority {
+    GObject     parent;
+    GHashTable *allowed;
+    guint       n_checks;
+    /* If set, checks are kept until explicitly released */
+    gboolean    hold;
+    GTask      *held;
+};
+
+G_DEFINE_TYPE (MockAuthority, mock_authority, G_TYPE_OBJECT)
+
+static void
+mock_authority_allow (MockAuthority *self,
+                      const gchar   *sender,
+                      const gchar   *authorization,
+                      gboolean       allow)
+{
+    gchar *key;
+
+    key = g_strdup_printf ("%s/%s", sender, authorization);
+    if (allow)
+        g_hash_table_add (self->allowed, key);
+    else {
+        g_hash_table_remove (self->allowed, key);
+        g_free (key);
+    }
+}
+
+static void
+mock_authority_check (GObject             *authority,
+                      const gchar         *sender,
+                      const gchar         *authorization,
+                      GCancellable        *cancellable,
+                      GAsyncReadyCallback  callback,
+                      gpointer             user_data)
+{
+    MockAuthority    *self = MOCK_AUTHORITY (authority);
+    g_autofree gchar *key = NULL;
+    GTask            *task;
+
+    self->n_checks++;
+    task = g_task_new (self, cancellable, callback, user_data);
+    key = g_strdup_printf ("%s/%s", sender, authorization);
+    if (self->hold) {
+        g_assert (!self->held);
+        g_task_set_task_data (task, g_steal_pointer (&key), g_free);
+        self->held = task;
+        return;
+    }
+    if (g_hash_table_contains (self->allowed, key))
+        g_task_return_boolean (task, TRUE);
+    else
+        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_UNAUTHORIZED,
+                                 "not authorized for '%s'", authorization);
+    g_object_unref (task);
+}
+
+static void
+mock_authority_release (MockAuthority *self)
+{
+    GTask *task;
+
+    g_assert (self->held);
+    task = g_steal_pointer (&self->held);
+    if (g_hash_table_contains (self->allowed, g_task_get_task_data (task)))
+        g_task_return_boolean (task, TRUE);
+    else
+        g_task_return_new_error (task, MM_CORE_ERROR, MM_CORE_ERROR_UNAUTHORIZED,
+                                 "not authorized");
+    g_object_unref (task);
+}
+
+static gboolean
+mock_authority_check_finish (GObject       *authority,
+                             GAsyncResult  *res,
+                             GError       **error)
+{
+    return g_task_propagate_boolean (G_TASK (res), error);
+}
+
+static void
+mock_authority_init (MockAuthority *self)
+{
+    self->allowed = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+}
+
+static void
+mock_authority_finalize (GObject *object)
+{
+    g_hash_table_unref (MOCK_AUTHORITY (object)->allowed);
+    G_OBJECT_CLASS (mock_authority_parent_class)->finalize (object);
+}
+
+static void
+mock_authority_class_init (MockAuthorityClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    object_class->finalize = mock_authority_finalize;
+
+    /* Same as in PolkitAuthority */
+    g_signal_new ("changed",
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST,
+                  0, NULL, NULL, NULL,
+                  G_TYPE_NONE, 0);
+}
+
+/*****************************************************************************/
+/* Provider, authorizing the calls to a test method exported in a private
+ * bus, so that the senders are real DBus peers */
+
+#define TEST_PATH      "/org/freedesktop/ModemManager1/Test"
+#define TEST_INTERFACE "org.freedesktop.ModemManager1.Test.Auth"
+
+static const gchar introspection_xml[] =
+    "<node>"
+    "  <interface name='" TEST_INTERFACE "'>"
+    "    <method name='Authorize'>"
+    "      <arg name='authorization' type='s' direction='in'/>"
+    "    </method>"
+    "  </interface>"
+    "</node>";
+
+typedef struct {
+    GTestDBus       *dbus;
+    GDBusConnection *server;
+    guint            registration_id;
+    MockAuthority   *authority;
+    MMAuthProvider  *provider;
+} Fixture;
+
+static void
+authorize_ready (MMAuthProvider        *provider,
+                 GAsyncResult          *res,
+                 GDBusMethodInvocation *invocation)
+{
+    GError *error = NULL;
+
+    if (!mm_auth_provider_authorize_finish (provider, res, &error))
+        g_dbus_method_invocation_take_error (invocation, error);
+    else
+        g_dbus_method_invocation_return_value (invocation, NULL);
+}
+
+static void
+method_call (GDBusConnection       *connection,
+             const gchar           *sender,
+             const gchar           *object_path,
+             const gchar           *interface_name,
+             const gchar           *method_name,
+             GVariant              *parameters,
+             GDBusMethodInvocation *invocation,
+             Fixture               *fixture)
+{
+    const gchar *authorization;
+
+    g_variant_get (parameters, "(&s)", &authorization);
+    mm_auth_provider_authorize (fixture->provider,
+                                invocation,
+                                authorization,
+                                NULL,
+                                (GAsyncReadyCallback)authorize_ready,
+                                invocation);
+}
+
+static const GDBusInterfaceVTable interface_vtable = {
+    .method_call = (GDBusInterfaceMethodCallFunc) method_call,
+};
+
+static GDBusConnection *
+fixture_connect (Fixture *fixture)
+{
+    GDBusConnection *connection;
+    GError          *error = NULL;
+
+    connection = g_dbus_connection_new_for_address_sync (g_test_dbus_get_bus_address (fixture->dbus),
+                                                         (G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+                                                          G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION),
+                                                         NULL, NULL, &error);
+    g_assert_no_error (error);
+    return connection;
+}
+
+static void
+fixture_setup (Fixture       *fixture,
+               gconstpointer  data)
+{
+    g_autoptr(GDBusNodeInfo)  node = NULL;
+    GError                   *error = NULL;
+
+    fixture->dbus = g_test_dbus_new (G_TEST_DBUS_NONE);
+    g_test_dbus_up (fixture->dbus);
+    fixture->server = fixture_connect (fixture);
+
+    fixture->authority = g_object_new (MOCK_TYPE_AUTHORITY, NULL);
+    fixture->provider = mm_auth_provider_new_with_authority (G_OBJECT (fixture->authority),
+                                                             mock_authority_check,
+                                                             mock_authority_check_finish);
+
+    node = g_dbus_node_info_new_for_xml (introspection_xml, &error);
+    g_assert_no_error (error);
+    fixture->registration_id = g_dbus_connection_register_object (fixture->server,
+                                                                  TEST_PATH,
+                                                                  node->interfaces[0],
+                                                                  &interface_vtable,
+                                                                  fixture,
+                                                                  NULL,
+                                                                  &error);
+    g_assert_no_error (error);
+}
+
+static void
+fixture_teardown (Fixture       *fixture,
+                  gconstpointer  data)
+{
+    g_dbus_connection_unregister_object (fixture->server, fixture->registration_id);
+    g_object_unref (fixture->provider);
+    g_object_unref (fixture->authority);
+    g_dbus_connection_close_sync (fixture->server, NULL, NULL);
+    g_object_unref (fixture->server);
+    g_test_dbus_down (fixture->dbus);
+    g_object_unref (fixture->dbus);
+}
+
+static void
+call_ready (GDBusConnection  *client,
+            GAsyncResult     *res,
+            GVariant        **result)
+{
+    *result = g_dbus_connection_call_finish (client, res, NULL);
+    if (!*result)
+        *result = g_variant_ref_sink (g_variant_new_boolean (FALSE));
+}
+
+static gboolean
+authorize (Fixture         *fixture,
+           GDBusConnection *client,
+           const gchar     *authorization)
+{
+    GVariant *result = NULL;
+    gboolean  authorized;
+
+    g_dbus_connection_call (client,
+                            g_dbus_connection_get_unique_name (fixture->server),
+                            TEST_PATH,
+                            TEST_INTERFACE,
+                            "Authorize",
+                            g_variant_new ("(s)", authorization),
+                            NULL,
+                            G_DBUS_CALL_FLAGS_NONE,
+                            -1,
+                            NULL,
+                            (GAsyncReadyCallback)call_ready,
+                            &result);
+    while (!result)
+        g_main_context_iteration (NULL, TRUE);
+
+    /* Errors are given as a boolean FALSE, successes as an empty tuple */
+    authorized = !g_variant_is_of_type (result, G_VARIANT_TYPE_BOOLEAN);
+    g_variant_unref (result);
+    return authorized;
+}
+
+static void
+sync_server (Fixture *fixture)
+{
+    GVariant *result;
+
+    /* Any signal sent by the bus before this reply has been received once it
+     * returns, and gets dispatched when iterating the main context */
+    result = g_dbus_connection_call_sync (fixture->server,
+                                          "org.freedesktop.DBus",
+                                          "/org/freedesktop/DBus",
+                                          "org.freedesktop.DBus",
+                                          "GetId",
+                                          NULL, NULL,
+                                          G_DBUS_CALL_FLAGS_NONE,
+                                          -1, NULL, NULL);
+    g_assert (result);
+    g_variant_unref (result);
+    while (g_main_context_iteration (NULL, FALSE));
+}
+
+static void
+test_provider_hits (Fixture       *fixture,
+                    gconstpointer  data)
+{
+    g_autoptr(GDBusConnection) client = NULL;
+    g_autoptr(GVariantDict)    dict = NULL;
+    guint64                    hits = 0;
+    guint64                    misses = 0;
+    guint                      n_entries = 0;
+    guint                      i;
+
+    client = fixture_connect (fixture);
+    mock_authority_allow (fixture->authority, g_dbus_connection_get_unique_name (client), MM_AUTHORIZATION_MESSAGING, TRUE);
+
+    for (i = 0; i < 100; i++)
+        g_assert (authorize (fixture, client, MM_AUTHORIZATION_MESSAGING));
+
+    /* A single check reached the authority */
+    g_assert_cmpuint (fixture->authority->n_checks, ==, 1);
+    g_assert_cmpuint (mm_auth_provider_get_n_cached (fixture->provider), ==, 1);
+
+    /* Same values published in the metrics */
+    dict = g_variant_dict_new (NULL);
+    mm_auth_provider_add_metrics (fixture->provider, dict);
+    g_assert (g_variant_dict_lookup (dict, "authorization-cache-hits", "t", &hits));
+    g_assert (g_variant_dict_lookup (dict, "authorization-cache-misses", "t", &misses));
+    g_assert (g_variant_dict_lookup (dict, "authorization-cache-entries", "u", &n_entries));
+    g_assert_cmpuint (hits, ==, 99);
+    g_assert_cmpuint (misses, ==, 1);
+    g_assert_cmpuint (n_entries, ==, 1);
+}
+
+static void
+test_provider_per_action (Fixture       *fixture,
+                          gconstpointer  data)
+{
+    g_autoptr(GDBusConnection) client = NULL;
+    g_autoptr(GDBusConnection) other_client = NULL;
+    const gchar               *sender;
+
+    client = fixture_connect (fixture);
+    other_client = fixture_connect (fixture);
+    sender = g_dbus_connection_get_unique_name (client);
+    mock_authority_allow (fixture->authority, sender, MM_AUTHORIZATION_MESSAGING, TRUE);
+
+    g_assert (authorize (fixture, client, MM_AUTHORIZATION_MESSAGING));
+    g_assert (authorize (fixture, client, MM_AUTHORIZATION_MESSAGING));
+    g_assert_cmpuint (fixture->authority->n_checks, ==, 1);
+
+    /* Different action, different sender: not authorized, and not cached */
+    g_assert (!authorize (fixture, client, MM_AUTHORIZATION_LOCATION));
+    g_assert (!authorize (fixture, client, MM_AUTHORIZATION_LOCATION));
+    g_assert (!authorize (fixture, other_client, MM_AUTHORIZATION_MESSAGING));
+    g_assert_cmpuint (fixture->authority->n_checks, ==, 4);
+
+    /* Once authorized, the result gets cached */
+    mock_authority_allow (fixture->authority, sender, MM_AUTHORIZATION_LOCATION, TRUE);
+    g_assert (authorize (fixture, client, MM_AUTHORIZATION_LOCATION));
+    g_assert (authorize (fixture, client, MM_AUTHORIZATION_LOCATION));
+    g_assert_cmpuint (fixture->authority->n_checks, ==, 5);
+    g_assert_cmpuint (mm_auth_provider_get_n_cached (fixture->provider), ==, 2);
+}
+
+static void
+test_provider_sender_vanished (Fixture       *fixture,
+                               gconstpointer  data)
+{
+    g_autoptr(GDBusConnection) client = NULL;
+    g_autoptr(GDBusConnection) other_client = NULL;
+
+    client = fixture_connect (fixture);
+    other_client = fixture_connect (fixture);
+    mock_authority_allow (fixture->authority, g_dbus_connection_get_unique_name (client), MM_AUTHORIZATION_MESSAGING, TRUE);
+    mock_authority_allow (fixture->authority, g_dbus_connection_get_unique_name (client), MM_AUTHORIZATION_VOICE, TRUE);
+    mock_authority_allow (fixture->authority, g_dbus_connection_get_unique_name (other_client), MM_AUTHORIZATION_MESSAGING, TRUE);
+
+    g_assert (authorize (fixture, client, MM_AUTHORIZATION_MESSAGING));
+    g_assert (authorize (fixture, client, MM_AUTHORIZATION_VOICE));
+    g_assert (authorize (fixture, other_client, MM_AUTHORIZATION_MESSAGING));
+    g_assert_cmpuint (mm_auth_provider_get_n_cached (fixture->provider), ==, 3);
+
+    /* NameOwnerChanged for the first client */
+    g_dbus_connection_close_sync (client, NULL, NULL);
+    sync_server (fixture);
+    g_assert_cmpuint (mm_auth_provider_get_n_cached (fixture->provider), ==, 1);
+
+    /* The other sender is still cached */
+    g_assert (authorize (fixture, other_client, MM_AUTHORIZATION_MESSAGING));
+    g_assert_cmpuint (fixture->authority->n_checks, ==, 3);
+}
+
+static void
+authorize_call_ready (GDBusConnection *client,
+                      GAsyncResult    *res,
+                      gboolean        *completed)
+{
+    g_autoptr(GVariant) result = NULL;
+
+    result = g_dbus_connection_call_finish (client, res, NULL);
+    *completed = TRUE;
+}
+
+static void
+test_provider_sender_vanished_during_check (Fixture       *fixture,
+                                            gconstpointer  data)
+{
+    g_autoptr(GDBusConnection) client = NULL;
+    gboolean                   completed = FALSE;
+
+    client = fixture_connect (fixture);
+    mock_authority_allow (fixture->authority, g_dbus_connection_get_unique_name (client), MM_AUTHORIZATION_MESSAGING, TRUE);
+
+    /* The sender is watched as soon as the check starts */
+    fixture->authority->hold = TRUE;
+    g_dbus_connection_call (client,
+                            g_dbus_connection_get_unique_name (fixture->server),
+                            TEST_PATH,
+                            TEST_INTERFACE,
+                            "Authorize",
+                            g_variant_new ("(s)", MM_AUTHORIZATION_MESSAGING),
+                            NULL,
+                            G_DBUS_CALL_FLAGS_NONE,
+                            -1,
+                            NULL,
+                            (GAsyncReadyCallback)authorize_call_ready,
+                            &completed);
+    while (!fixture->authority->held)
+        g_main_context_iteration (NULL, TRUE);
+    g_assert_cmpuint (mm_auth_provider_get_n_watched (fixture->provider), ==, 1);
+
+    /* The sender goes away before the check completes successfully, so
+     * nothing gets cached, and the sender is not watched any more */
+    g_dbus_connection_close_sync (client, NULL, NULL);
+    sync_server (fixture);
+    mock_authority_release (fixture->authority);
+    while (g_main_context_iteration (NULL, FALSE));
+    g_assert_cmpuint (mm_auth_provider_get_n_cached (fixture->provider), ==, 0);
+    g_assert_cmpuint (mm_auth_provider_get_n_watched (fixture->provider), ==, 0);
+}
+
+static void
+test_provider_not_authorized_unwatched (Fixture       *fixture,
+                                        gconstpointer  data)
+{
+    g_autoptr(GDBusConnection) client = NULL;
+
+    client = fixture_connect (fixture);
+
+    /* Failed checks don't keep the sender watched */
+    g_assert (!authorize (fixture, client, MM_AUTHORIZATION_MESSAGING));
+    g_assert_cmpuint (mm_auth_provider_get_n_cached (fixture->provider), ==, 0);
+    g_assert_cmpuint (mm_auth_provider_get_n_watched (fixture->provider), ==, 0);
+
+    mock_authority_allow (fixture->authority, g_dbus_connection_get_unique_name (client), MM_AUTHORIZATION_MESSAGING, TRUE);
+    g_assert (authorize (fixture, client, MM_AUTHORIZATION_MESSAGING));
+    g_assert_cmpuint (mm_auth_provider_get_n_watched (fixture->provider), ==, 1);
+}
+
+static void
+test_provider_authority_changed (Fixture       *fixture,
+                                 gconstpointer  data)
+{
+    g_autoptr(GDBusConnection) client = NULL;
+    const gchar               *sender;
+
+    client = fixture_connect (fixture);
+    sender = g_dbus_connection_get_unique_name (client);
+    mock_authority_allow (fixture->authority, sender, MM_AUTHORIZATION_MESSAGING, TRUE);
+
+    g_assert (authorize (fixture, client, MM_AUTHORIZATION_MESSAGING));
+    g_assert (authorize (fixture, client, MM_AUTHORIZATION_MESSAGING));
+    g_assert_cmpuint (fixture->authority->n_checks, ==, 1);
+
+    /* Rules changed, the cache must be flushed */
+    mock_authority_allow (fixture->authority, sender, MM_AUTHORIZATION_MESSAGING, FALSE);
+    g_signal_emit_by_name (fixture->authority, "changed");
+    g_assert_cmpuint (mm_auth_provider_get_n_cached (fixture->provider), ==, 0);
+    g_assert (!authorize (fixture, client, MM_AUTHORIZATION_MESSAGING));
+    g_assert_cmpuint (fixture->authority->n_checks, ==, 2);
+}
+
+/*****************************************************************************/
+
+#define TEST_ADD_PROVIDER(path,method)                                  \
+    g_test_add (path, Fixture, NULL, fixture_setup, method, fixture_teardown)
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/auth-cache/hits",       test_cache_hits);
+    g_test_add_func ("/MM/auth-cache/expiration", test_cache_expiration);
+    g_test_add_func ("/MM/auth-cache/disabled",   test_cache_disabled);
+
+    TEST_ADD_PROVIDER ("/MM/auth-provider/hits",              test_provider_hits);
+    TEST_ADD_PROVIDER ("/MM/auth-provider/per-action",        test_provider_per_action);
+    TEST_ADD_PROVIDER ("/MM/auth-provider/sender-vanished",   test_provider_sender_vanished);
+    TEST_ADD_PROVIDER ("/MM/auth-provider/sender-vanished-during-check", test_provider_sender_vanished_during_check);
+    TEST_ADD_PROVIDER ("/MM/auth-provider/not-authorized-unwatched",     test_provider_not_authorized_unwatched);
+    TEST_ADD_PROVIDER ("/MM/auth-provider/authority-changed", test_provider_authority_changed);
+
+    return g_test_run ();
+}
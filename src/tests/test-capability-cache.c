@@ -0,0 +1,204 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <locale.h>
+
+#include <ModemManager.h>
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+#include "mm-capability-cache.h"
+#include "mm-log-test.h"
+
+#define TEST_EQUIPMENT_IDENTIFIER "359072060003475"
+#define TEST_REVISION             "EM7455 SWI9X30C_02.24.05.06"
+
+/*****************************************************************************/
+
+static gchar *
+test_dir_new (void)
+{
+    g_autoptr(GError)  error = NULL;
+    gchar             *dir;
+
+    dir = g_dir_make_tmp ("test-capability-cache-XXXXXX", &error);
+    g_assert_no_error (error);
+    return dir;
+}
+
+static void
+test_dir_free (gchar *dir)
+{
+    g_autoptr(GError) error = NULL;
+
+    g_assert (mm_capability_cache_clear (dir, &error));
+    g_assert_no_error (error);
+    g_rmdir (dir);
+    g_free (dir);
+}
+
+/*****************************************************************************/
+
+static void
+test_store_load (void)
+{
+    g_autoptr(MMCapabilityCacheEntry)  entry = NULL;
+    g_autoptr(MMCapabilityCacheEntry)  loaded = NULL;
+    g_autoptr(GError)                  error = NULL;
+    gchar                             *dir;
+
+    dir = test_dir_new ();
+
+    entry = mm_capability_cache_entry_new ();
+    entry->manufacturer = g_strdup ("Sierra Wireless, Incorporated");
+    entry->model = g_strdup ("EM7455");
+    g_hash_table_insert (entry->at_replies, g_strdup ("+WS46=?"), g_strdup ("+WS46: (12,22,25,28,29,30,31)"));
+    g_hash_table_insert (entry->at_replies, g_strdup ("+CGDCONT=?"), g_strdup ("+CGDCONT: (1-16),\"IP\",,,(0-2),(0-4)\r\n+CGDCONT: (1-16),\"IPV6\",,,(0-2),(0-4)"));
+
+    g_assert (mm_capability_cache_store (dir, TEST_EQUIPMENT_IDENTIFIER, TEST_REVISION, entry, &error));
+    g_assert_no_error (error);
+
+    loaded = mm_capability_cache_load (dir, TEST_EQUIPMENT_IDENTIFIER, TEST_REVISION, &error);
+    g_assert_no_error (error);
+    g_assert (loaded);
+    g_assert_cmpstr (loaded->manufacturer, ==, entry->manufacturer);
+    g_assert_cmpstr (loaded->model, ==, entry->model);
+    g_assert_cmpstr (loaded->hardware_revision, ==, NULL);
+    g_assert_cmpuint (g_hash_table_size (loaded->at_replies), ==, 2);
+    g_assert_cmpstr (g_hash_table_lookup (loaded->at_replies, "+WS46=?"), ==,
+                     g_hash_table_lookup (entry->at_replies, "+WS46=?"));
+    g_assert_cmpstr (g_hash_table_lookup (loaded->at_replies, "+CGDCONT=?"), ==,
+                     g_hash_table_lookup (entry->at_replies, "+CGDCONT=?"));
+
+    test_dir_free (dir);
+}
+
+static void
+test_other_revision (void)
+{
+    g_autoptr(MMCapabilityCacheEntry)  entry = NULL;
+    g_autoptr(MMCapabilityCacheEntry)  loaded = NULL;
+    g_autoptr(GError)                  error = NULL;
+    gchar                             *dir;
+
+    dir = test_dir_new ();
+
+    entry = mm_capability_cache_entry_new ();
+    entry->model = g_strdup ("EM7455");
+    g_assert (mm_capability_cache_store (dir, TEST_EQUIPMENT_IDENTIFIER, TEST_REVISION, entry, &error));
+    g_assert_no_error (error);
+
+    /* A firmware upgrade invalidates the entry */
+    loaded = mm_capability_cache_load (dir, TEST_EQUIPMENT_IDENTIFIER, "EM7455 SWI9X30C_02.33.03.00", &error);
+    g_assert_no_error (error);
+    g_assert (!loaded);
+
+    test_dir_free (dir);
+}
+
+static void
+test_state_dependent (void)
+{
+    g_autoptr(MMCapabilityCacheEntry)  entry = NULL;
+    g_autoptr(MMCapabilityCacheEntry)  loaded = NULL;
+    g_autoptr(GError)                  error = NULL;
+    gchar                             *dir;
+
+    dir = test_dir_new ();
+
+    /* Replies depending on the SIM card or the network are not stored */
+    entry = mm_capability_cache_entry_new ();
+    g_hash_table_insert (entry->at_replies, g_strdup ("+WS46=?"), g_strdup ("+WS46: (12,22,25,28,29,30,31)"));
+    g_hash_table_insert (entry->at_replies, g_strdup ("+CPMS=?"), g_strdup ("+CPMS: (\"SM\",\"ME\"),(\"SM\",\"ME\"),(\"SM\",\"ME\")"));
+    g_hash_table_insert (entry->at_replies, g_strdup ("+CPOL=?"), g_strdup ("+CPOL: (1-100),(0-2)"));
+    g_assert (mm_capability_cache_store (dir, TEST_EQUIPMENT_IDENTIFIER, TEST_REVISION, entry, &error));
+    g_assert_no_error (error);
+
+    loaded = mm_capability_cache_load (dir, TEST_EQUIPMENT_IDENTIFIER, TEST_REVISION, &error);
+    g_assert_no_error (error);
+    g_assert (loaded);
+    g_assert_cmpuint (g_hash_table_size (loaded->at_replies), ==, 1);
+    g_assert (g_hash_table_contains (loaded->at_replies, "+WS46=?"));
+
+    test_dir_free (dir);
+}
+
+static void
+test_remove_clear (void)
+{
+    g_autoptr(MMCapabilityCacheEntry)  entry = NULL;
+    g_autoptr(MMCapabilityCacheEntry)  loaded = NULL;
+    g_autoptr(GError)                  error = NULL;
+    gchar                             *dir;
+
+    dir = test_dir_new ();
+
+    entry = mm_capability_cache_entry_new ();
+    entry->model = g_strdup ("EM7455");
+    g_assert (mm_capability_cache_store (dir, TEST_EQUIPMENT_IDENTIFIER, TEST_REVISION, entry, &error));
+    g_assert_no_error (error);
+    g_assert (mm_capability_cache_store (dir, "866758040000000", TEST_REVISION, entry, &error));
+    g_assert_no_error (error);
+
+    mm_capability_cache_remove (dir, TEST_EQUIPMENT_IDENTIFIER, TEST_REVISION);
+
+    /* A missing entry is not an error */
+    loaded = mm_capability_cache_load (dir, TEST_EQUIPMENT_IDENTIFIER, TEST_REVISION, &error);
+    g_assert_no_error (error);
+    g_assert (!loaded);
+
+    g_assert (mm_capability_cache_clear (dir, &error));
+    g_assert_no_error (error);
+    loaded = mm_capability_cache_load (dir, "866758040000000", TEST_REVISION, &error);
+    g_assert_no_error (error);
+    g_assert (!loaded);
+
+    test_dir_free (dir);
+}
+
+static void
+test_invalid_key (void)
+{
+    g_autoptr(MMCapabilityCacheEntry)  entry = NULL;
+    g_autoptr(GError)                  error = NULL;
+    gchar                             *dir;
+
+    dir = test_dir_new ();
+
+    entry = mm_capability_cache_entry_new ();
+    g_assert (!mm_capability_cache_store (dir, TEST_EQUIPMENT_IDENTIFIER, "", entry, &error));
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS);
+
+    test_dir_free (dir);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/capability-cache/store-load",     test_store_load);
+    g_test_add_func ("/MM/capability-cache/other-revision", test_other_revision);
+    g_test_add_func ("/MM/capability-cache/state-dependent", test_state_dependent);
+    g_test_add_func ("/MM/capability-cache/remove-clear",   test_remove_clear);
+    g_test_add_func ("/MM/capability-cache/invalid-key",    test_invalid_key);
+
+    return g_test_run ();
+}
@@ -0,0 +1,176 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <glib.h>
+#include <locale.h>
+
+#include <ModemManager.h>
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+#include "mm-device-checkpoint.h"
+#include "mm-log-test.h"
+
+#define TEST_VENDOR   0x2c7c
+#define TEST_PRODUCT  0x0125
+#define TEST_REVISION "EG25GGBR07A08M2G"
+#define TEST_ICCID    "8934071100276980483"
+
+/*****************************************************************************/
+
+static MMDeviceCheckpoint *
+test_checkpoint_new (gint64 timestamp)
+{
+    MMDeviceCheckpoint *checkpoint;
+
+    checkpoint = mm_device_checkpoint_new (timestamp, TEST_VENDOR, TEST_PRODUCT, "quectel",
+                                           TEST_REVISION, TEST_ICCID, TRUE);
+    mm_device_checkpoint_add_port (checkpoint, "tty",     "ttyUSB2",   2, MM_PORT_TYPE_AT);
+    mm_device_checkpoint_add_port (checkpoint, "tty",     "ttyUSB0",   0, MM_PORT_TYPE_QCDM);
+    mm_device_checkpoint_add_port (checkpoint, "usbmisc", "cdc-wdm0",  4, MM_PORT_TYPE_QMI);
+    mm_device_checkpoint_add_port (checkpoint, "net",     "wwan0",     4, MM_PORT_TYPE_NET);
+    mm_device_checkpoint_add_port (checkpoint, "tty",     "ttyUSB1",   1, MM_PORT_TYPE_UNKNOWN);
+    return checkpoint;
+}
+
+/*****************************************************************************/
+
+static void
+test_matches (void)
+{
+    g_autoptr(MMDeviceCheckpoint) checkpoint = NULL;
+    gint64                        now;
+
+    now = g_get_monotonic_time ();
+    checkpoint = test_checkpoint_new (now);
+
+    g_assert_cmpstr (mm_device_checkpoint_get_plugin (checkpoint), ==, "quectel");
+    g_assert_cmpuint (mm_device_checkpoint_get_n_ports (checkpoint), ==, 5);
+
+    g_assert (mm_device_checkpoint_matches (checkpoint, TEST_VENDOR, TEST_PRODUCT, now));
+    g_assert (mm_device_checkpoint_matches (checkpoint, TEST_VENDOR, TEST_PRODUCT,
+                                            now + MM_DEVICE_CHECKPOINT_MAX_AGE_SECS * G_USEC_PER_SEC));
+
+    /* A different device is never matched */
+    g_assert (!mm_device_checkpoint_matches (checkpoint, TEST_VENDOR, TEST_PRODUCT + 1, now));
+    g_assert (!mm_device_checkpoint_matches (checkpoint, TEST_VENDOR + 1, TEST_PRODUCT, now));
+}
+
+static void
+test_expired (void)
+{
+    g_autoptr(MMDeviceCheckpoint) checkpoint = NULL;
+    gint64                        now;
+
+    now = g_get_monotonic_time ();
+    checkpoint = test_checkpoint_new (now);
+
+    g_assert (!mm_device_checkpoint_matches (checkpoint, TEST_VENDOR, TEST_PRODUCT,
+                                             now + (MM_DEVICE_CHECKPOINT_MAX_AGE_SECS + 1) * G_USEC_PER_SEC));
+}
+
+/*****************************************************************************/
+
+static gboolean
+port_found (const gchar  *subsystem,
+            const gchar  *name,
+            const gchar **found)
+{
+    g_autofree gchar *port = NULL;
+
+    port = g_strdup_printf ("%s/%s", subsystem, name);
+    return g_strv_contains ((const gchar *const *) found, port);
+}
+
+static void
+test_ports_found (void)
+{
+    g_autoptr(MMDeviceCheckpoint) checkpoint = NULL;
+    const gchar *some[] = { "tty/ttyUSB0", "tty/ttyUSB1", "tty/ttyUSB2", NULL };
+    const gchar *all[]  = { "tty/ttyUSB0", "tty/ttyUSB1", "tty/ttyUSB2", "tty/ttyUSB3",
+                            "usbmisc/cdc-wdm0", "net/wwan0", NULL };
+
+    checkpoint = test_checkpoint_new (g_get_monotonic_time ());
+
+    g_assert (!mm_device_checkpoint_ports_found (checkpoint, (MMDeviceCheckpointPortFoundFn) port_found, some));
+
+    /* Ports not in the checkpoint (ttyUSB3) don't make any difference */
+    g_assert (mm_device_checkpoint_ports_found (checkpoint, (MMDeviceCheckpointPortFoundFn) port_found, all));
+}
+
+static void
+test_lookup_port_type (void)
+{
+    g_autoptr(MMDeviceCheckpoint) checkpoint = NULL;
+
+    checkpoint = test_checkpoint_new (g_get_monotonic_time ());
+
+    g_assert_cmpuint (mm_device_checkpoint_lookup_port_type (checkpoint, "tty",     "ttyUSB0",  0), ==, MM_PORT_TYPE_QCDM);
+    g_assert_cmpuint (mm_device_checkpoint_lookup_port_type (checkpoint, "usbmisc", "cdc-wdm0", 4), ==, MM_PORT_TYPE_QMI);
+    g_assert_cmpuint (mm_device_checkpoint_lookup_port_type (checkpoint, "tty",     "ttyUSB2",  2), ==, MM_PORT_TYPE_AT);
+
+    /* Ignored ports */
+    g_assert_cmpuint (mm_device_checkpoint_lookup_port_type (checkpoint, "tty",     "ttyUSB1",  1), ==, MM_PORT_TYPE_UNKNOWN);
+
+    /* Same name but different interface, or unknown ports */
+    g_assert_cmpuint (mm_device_checkpoint_lookup_port_type (checkpoint, "tty",     "ttyUSB0",  3), ==, MM_PORT_TYPE_UNKNOWN);
+    g_assert_cmpuint (mm_device_checkpoint_lookup_port_type (checkpoint, "usbmisc", "cdc-wdm1", 4), ==, MM_PORT_TYPE_UNKNOWN);
+    g_assert_cmpuint (mm_device_checkpoint_lookup_port_type (checkpoint, "net",     "ttyUSB0",  0), ==, MM_PORT_TYPE_UNKNOWN);
+}
+
+/*****************************************************************************/
+
+static void
+test_revalidate (void)
+{
+    g_autoptr(MMDeviceCheckpoint)  checkpoint = NULL;
+    g_autoptr(MMDeviceCheckpoint)  disabled = NULL;
+    const gchar                   *reason = NULL;
+
+    checkpoint = test_checkpoint_new (g_get_monotonic_time ());
+
+    g_assert (mm_device_checkpoint_revalidate (checkpoint, TEST_REVISION, TEST_ICCID, MM_MODEM_STATE_DISABLED, &reason));
+
+    g_assert (!mm_device_checkpoint_revalidate (checkpoint, "EG25GGBR07A08M2H", TEST_ICCID, MM_MODEM_STATE_DISABLED, &reason));
+    g_assert_cmpstr (reason, ==, "firmware revision changed");
+
+    g_assert (!mm_device_checkpoint_revalidate (checkpoint, TEST_REVISION, NULL, MM_MODEM_STATE_DISABLED, &reason));
+    g_assert_cmpstr (reason, ==, "SIM changed");
+
+    g_assert (!mm_device_checkpoint_revalidate (checkpoint, TEST_REVISION, TEST_ICCID, MM_MODEM_STATE_LOCKED, &reason));
+    g_assert_cmpstr (reason, ==, "not disabled");
+
+    disabled = mm_device_checkpoint_new (g_get_monotonic_time (), TEST_VENDOR, TEST_PRODUCT, "quectel",
+                                         TEST_REVISION, TEST_ICCID, FALSE);
+    g_assert (!mm_device_checkpoint_revalidate (disabled, TEST_REVISION, TEST_ICCID, MM_MODEM_STATE_DISABLED, &reason));
+    g_assert_cmpstr (reason, ==, "not enabled before suspending");
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/device-checkpoint/matches",          test_matches);
+    g_test_add_func ("/MM/device-checkpoint/expired",          test_expired);
+    g_test_add_func ("/MM/device-checkpoint/ports-found",      test_ports_found);
+    g_test_add_func ("/MM/device-checkpoint/lookup-port-type", test_lookup_port_type);
+    g_test_add_func ("/MM/device-checkpoint/revalidate",       test_revalidate);
+
+    return g_test_run ();
+}
@@ -3646,6 +3646,53 @@ test_cclk_response (void)
     }
 }
 
+/*****************************************************************************/
+/* Test +CTZV/+CTZE URCs */
+
+typedef struct {
+    const gchar *str;
+    gboolean     ctze;
+    gboolean     match;
+    gint32       offset;
+    gint32       dst_offset;
+} CtzTest;
+
+static const CtzTest ctz_tests[] = {
+    { "\r\n+CTZV: +08\r\n",                              FALSE, TRUE,  120,  MM_NETWORK_TIMEZONE_OFFSET_UNKNOWN },
+    { "\r\n+CTZV: \"-32\"\r\n",                          FALSE, TRUE,  -480, MM_NETWORK_TIMEZONE_OFFSET_UNKNOWN },
+    { "\r\n+CTZV: 4\r\n",                                FALSE, TRUE,  60,   MM_NETWORK_TIMEZONE_OFFSET_UNKNOWN },
+    { "\r\n+CTZV: 19/07/09,10:19:15,+08\r\n",             FALSE, FALSE, 0,    0 },
+    { "\r\n+CTZE: \"+08\",1\r\n",                         TRUE,  TRUE,  120,  60 },
+    { "\r\n+CTZE: \"-20\",0,\"2019/07/09,10:19:15\"\r\n", TRUE,  TRUE,  -300, 0 },
+    { "\r\n+CTZE: +08\r\n",                              TRUE,  FALSE, 0,    0 },
+};
+
+static void
+test_ctzv_ctze_urc (void)
+{
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (ctz_tests); i++) {
+        g_autoptr(GRegex)             r = NULL;
+        g_autoptr(GMatchInfo)         match_info = NULL;
+        g_autoptr(MMNetworkTimezone)  tz = NULL;
+        g_autoptr(GError)             error = NULL;
+
+        r = ctz_tests[i].ctze ? mm_3gpp_ctze_regex_get () : mm_3gpp_ctzv_regex_get ();
+        g_assert (r);
+
+        g_assert_cmpint (g_regex_match (r, ctz_tests[i].str, 0, &match_info), ==, ctz_tests[i].match);
+        if (!ctz_tests[i].match)
+            continue;
+
+        tz = mm_parse_ctzv_ctze_urc (match_info, &error);
+        g_assert_no_error (error);
+        g_assert (tz);
+        g_assert_cmpint (mm_network_timezone_get_offset (tz), ==, ctz_tests[i].offset);
+        g_assert_cmpint (mm_network_timezone_get_dst_offset (tz), ==, ctz_tests[i].dst_offset);
+    }
+}
+
 
 /*****************************************************************************/
 /* Test +CRSM responses */
@@ -4495,6 +4542,44 @@ test_bcd_to_string (void *f, gpointer d)
 
 /*****************************************************************************/
 
+static void
+test_compound_at_response (void *f, gpointer d)
+{
+    const gchar * const  commands[] = { "+CGMI", "+CTZU=1", "+CCLK?", "+CPMS?", NULL };
+    g_auto(GStrv)        responses = NULL;
+    g_autoptr(GError)    error = NULL;
+
+    responses = mm_split_compound_at_response ("\r\nQUALCOMM INCORPORATED\r\n"
+                                               "\r\n+CCLK: \"21/03/02,10:02:19+04\"\r\n"
+                                               "\r\n+CPMS: \"ME\",0,25,\"ME\",0,25\r\n"
+                                               "+cpms: \"SM\",1,10\r\n",
+                                               commands,
+                                               &error);
+    g_assert_no_error (error);
+    g_assert_cmpuint (g_strv_length (responses), ==, 4);
+    g_assert_cmpstr (responses[0], ==, "QUALCOMM INCORPORATED");
+    g_assert_cmpstr (responses[1], ==, "");
+    g_assert_cmpstr (responses[2], ==, "+CCLK: \"21/03/02,10:02:19+04\"");
+    g_assert_cmpstr (responses[3], ==, "+CPMS: \"ME\",0,25,\"ME\",0,25\r\n+cpms: \"SM\",1,10");
+}
+
+static void
+test_compound_at_response_unmatched (void *f, gpointer d)
+{
+    const gchar * const  commands[] = { "+CTZU=1", "+CCLK?", NULL };
+    g_auto(GStrv)        responses = NULL;
+    g_autoptr(GError)    error = NULL;
+
+    responses = mm_split_compound_at_response ("\r\n+CCLK: \"21/03/02,10:02:19+04\"\r\n"
+                                               "\r\n+CTZU: 1\r\n",
+                                               commands,
+                                               &error);
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_FAILED);
+    g_assert (!responses);
+}
+
+/*****************************************************************************/
+
 #define TESTCASE(t, d) g_test_create_case (#t, 0, d, NULL, (GTestFixtureFunc) t, NULL)
 
 int main (int argc, char **argv)
@@ -4698,6 +4783,7 @@ int main (int argc, char **argv)
     g_test_suite_add (suite, TESTCASE (test_supported_mode_filter, NULL));
 
     g_test_suite_add (suite, TESTCASE (test_cclk_response, NULL));
+    g_test_suite_add (suite, TESTCASE (test_ctzv_ctze_urc, NULL));
 
     g_test_suite_add (suite, TESTCASE (test_crsm_response, NULL));
 
@@ -4726,6 +4812,9 @@ int main (int argc, char **argv)
 
     g_test_suite_add (suite, TESTCASE (test_bcd_to_string, NULL));
 
+    g_test_suite_add (suite, TESTCASE (test_compound_at_response, NULL));
+    g_test_suite_add (suite, TESTCASE (test_compound_at_response_unmatched, NULL));
+
     result = g_test_run ();
 
     reg_test_data_free (reg_data);
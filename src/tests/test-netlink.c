@@ -0,0 +1,376 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <glib.h>
+#include <locale.h>
+#include <string.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_link.h>
+#include <net/if.h>
+
+#include <ModemManager.h>
+#include <mm-errors-types.h>
+
+#include "mm-netlink.h"
+#include "mm-port-net.h"
+#include "mm-kernel-device-generic.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+/* Fake kernel messages */
+
+static struct rtattr *
+message_append_attr (GByteArray    *msg,
+                     gushort        type,
+                     gconstpointer  value,
+                     gushort        len)
+{
+    struct rtattr *attr;
+    guint          pos;
+
+    pos = NLMSG_ALIGN (msg->len);
+    g_byte_array_set_size (msg, pos + RTA_ALIGN (RTA_LENGTH (len)));
+    memset (msg->data + pos, 0, msg->len - pos);
+
+    attr = (struct rtattr *) (msg->data + pos);
+    attr->rta_type = type;
+    attr->rta_len = RTA_LENGTH (len);
+    if (value)
+        memcpy (RTA_DATA (attr), value, len);
+    return attr;
+}
+
+/* Appends a RTM_NEWLINK or RTM_DELLINK message to the given buffer, which
+ * may already contain other messages */
+static void
+append_link_message (GByteArray  *buffer,
+                     guint16      type,
+                     guint        ifindex,
+                     const gchar *ifname,
+                     guint16      rmnet_mux_id)
+{
+    g_autoptr(GByteArray)  msg = NULL;
+    struct nlmsghdr       *hdr;
+    struct ifinfomsg      *ifinfo;
+
+    msg = g_byte_array_new ();
+    g_byte_array_set_size (msg, NLMSG_LENGTH (sizeof (struct ifinfomsg)));
+    memset (msg->data, 0, msg->len);
+
+    ifinfo = NLMSG_DATA ((struct nlmsghdr *) msg->data);
+    ifinfo->ifi_family = AF_UNSPEC;
+    ifinfo->ifi_index = ifindex;
+    ifinfo->ifi_flags = IFF_UP;
+
+    message_append_attr (msg, IFLA_IFNAME, ifname, strlen (ifname) + 1);
+
+    if (rmnet_mux_id) {
+        guint linkinfo_pos;
+        guint data_pos;
+
+        linkinfo_pos = NLMSG_ALIGN (msg->len);
+        message_append_attr (msg, IFLA_LINKINFO, NULL, 0);
+        message_append_attr (msg, IFLA_INFO_KIND, "rmnet", strlen ("rmnet") + 1);
+        data_pos = NLMSG_ALIGN (msg->len);
+        message_append_attr (msg, IFLA_INFO_DATA, NULL, 0);
+        message_append_attr (msg, IFLA_RMNET_MUX_ID, &rmnet_mux_id, sizeof (rmnet_mux_id));
+        /* Nested attributes span until the end of the message */
+        ((struct rtattr *) (msg->data + data_pos))->rta_len = msg->len - data_pos;
+        ((struct rtattr *) (msg->data + linkinfo_pos))->rta_len = msg->len - linkinfo_pos;
+    }
+
+    /* Kernel notifications have no sequence id */
+    hdr = (struct nlmsghdr *) msg->data;
+    hdr->nlmsg_len = msg->len;
+    hdr->nlmsg_type = type;
+
+    g_byte_array_set_size (buffer, NLMSG_ALIGN (buffer->len));
+    g_byte_array_append (buffer, msg->data, msg->len);
+}
+
+static void
+fake_link (MMNetlink   *netlink,
+           guint16      type,
+           guint        ifindex,
+           const gchar *ifname,
+           guint16      rmnet_mux_id)
+{
+    g_autoptr(GByteArray) buffer = NULL;
+
+    buffer = g_byte_array_new ();
+    append_link_message (buffer, type, ifindex, ifname, rmnet_mux_id);
+    mm_netlink_fake_receive (netlink, buffer->data, buffer->len);
+}
+
+/*****************************************************************************/
+
+typedef struct {
+    gboolean  completed;
+    guint     ifindex;
+    GError   *error;
+} WaitLinkResult;
+
+static void
+wait_link_ready (MMNetlink      *netlink,
+                 GAsyncResult   *res,
+                 WaitLinkResult *result)
+{
+    result->ifindex = mm_netlink_wait_link_finish (netlink, res, &result->error);
+    result->completed = TRUE;
+}
+
+static void
+run_until_completed (WaitLinkResult *result)
+{
+    while (!result->completed)
+        g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+test_wait_link_appears (void)
+{
+    g_autoptr(MMNetlink) netlink = NULL;
+    WaitLinkResult       result = { 0 };
+
+    netlink = mm_netlink_new_fake ();
+
+    mm_netlink_wait_link (netlink, "qmimux0", 0, 10000, (GAsyncReadyCallback) wait_link_ready, &result);
+    g_assert (!result.completed);
+
+    /* Other links are not taken */
+    fake_link (netlink, RTM_NEWLINK, 5, "wwan0", 0);
+    g_assert (!result.completed);
+
+    fake_link (netlink, RTM_NEWLINK, 10, "qmimux0", 0);
+    run_until_completed (&result);
+    g_assert_no_error (result.error);
+    g_assert_cmpuint (result.ifindex, ==, 10);
+}
+
+static void
+test_wait_link_already_known (void)
+{
+    g_autoptr(MMNetlink) netlink = NULL;
+    WaitLinkResult       result = { 0 };
+
+    netlink = mm_netlink_new_fake ();
+
+    fake_link (netlink, RTM_NEWLINK, 11, "qmimux1", 0);
+
+    mm_netlink_wait_link (netlink, "qmimux1", 0, 10000, (GAsyncReadyCallback) wait_link_ready, &result);
+    run_until_completed (&result);
+    g_assert_no_error (result.error);
+    g_assert_cmpuint (result.ifindex, ==, 11);
+}
+
+static void
+test_wait_link_mux_id (void)
+{
+    g_autoptr(MMNetlink) netlink = NULL;
+    WaitLinkResult       result = { 0 };
+
+    netlink = mm_netlink_new_fake ();
+
+    /* A stale link with the same name but a different mux id */
+    fake_link (netlink, RTM_NEWLINK, 12, "rmnet_data0", 1);
+
+    mm_netlink_wait_link (netlink, "rmnet_data0", 2, 10000, (GAsyncReadyCallback) wait_link_ready, &result);
+    g_assert (!result.completed);
+
+    /* Stale link removed, and the new one created */
+    fake_link (netlink, RTM_DELLINK, 12, "rmnet_data0", 1);
+    g_assert (!result.completed);
+    fake_link (netlink, RTM_NEWLINK, 13, "rmnet_data0", 2);
+    run_until_completed (&result);
+    g_assert_no_error (result.error);
+    g_assert_cmpuint (result.ifindex, ==, 13);
+    g_assert_cmpuint (mm_netlink_peek_link_info (netlink, 13)->mux_id, ==, 2);
+}
+
+static void
+test_wait_link_batched (void)
+{
+    g_autoptr(MMNetlink)  netlink = NULL;
+    g_autoptr(GByteArray) buffer = NULL;
+    WaitLinkResult        result1 = { 0 };
+    WaitLinkResult        result2 = { 0 };
+
+    netlink = mm_netlink_new_fake ();
+
+    mm_netlink_wait_link (netlink, "qmimux0", 0, 10000, (GAsyncReadyCallback) wait_link_ready, &result1);
+    mm_netlink_wait_link (netlink, "qmimux1", 0, 10000, (GAsyncReadyCallback) wait_link_ready, &result2);
+
+    /* Several links reported in the same datagram */
+    buffer = g_byte_array_new ();
+    append_link_message (buffer, RTM_NEWLINK, 20, "qmimux1", 0);
+    append_link_message (buffer, RTM_NEWLINK, 21, "qmimux0", 0);
+    mm_netlink_fake_receive (netlink, buffer->data, buffer->len);
+
+    run_until_completed (&result1);
+    run_until_completed (&result2);
+    g_assert_no_error (result1.error);
+    g_assert_no_error (result2.error);
+    g_assert_cmpuint (result1.ifindex, ==, 21);
+    g_assert_cmpuint (result2.ifindex, ==, 20);
+}
+
+static void
+test_wait_link_timeout (void)
+{
+    g_autoptr(MMNetlink) netlink = NULL;
+    WaitLinkResult       result = { 0 };
+
+    netlink = mm_netlink_new_fake ();
+
+    mm_netlink_wait_link (netlink, "qmimux0", 0, 10, (GAsyncReadyCallback) wait_link_ready, &result);
+    fake_link (netlink, RTM_NEWLINK, 5, "wwan0", 0);
+    run_until_completed (&result);
+    g_assert_error (result.error, MM_CORE_ERROR, MM_CORE_ERROR_NOT_FOUND);
+    g_assert_cmpuint (result.ifindex, ==, 0);
+    g_error_free (result.error);
+}
+
+/*****************************************************************************/
+
+static void
+link_updated_cb (MMNetlink   *netlink,
+                 guint        ifindex,
+                 const gchar *ifname,
+                 guint       *n_updated)
+{
+    (*n_updated)++;
+}
+
+static void
+test_link_cache (void)
+{
+    g_autoptr(MMNetlink)     netlink = NULL;
+    const MMNetlinkLinkInfo *info;
+    guint                    n_updated = 0;
+
+    netlink = mm_netlink_new_fake ();
+    g_assert (mm_netlink_is_link_cache_synced (netlink));
+
+    g_signal_connect (netlink, MM_NETLINK_SIGNAL_LINK_UPDATED, G_CALLBACK (link_updated_cb), &n_updated);
+
+    fake_link (netlink, RTM_NEWLINK, 7, "wwan0", 0);
+    g_assert_cmpuint (n_updated, ==, 1);
+
+    info = mm_netlink_peek_link_info_by_name (netlink, "wwan0");
+    g_assert (info);
+    g_assert_cmpuint (info->ifindex, ==, 7);
+    g_assert (info->flags & IFF_UP);
+    g_assert (mm_netlink_peek_link_info (netlink, 7) == info);
+
+    /* Same state reported again is not notified */
+    fake_link (netlink, RTM_NEWLINK, 7, "wwan0", 0);
+    g_assert_cmpuint (n_updated, ==, 1);
+
+    fake_link (netlink, RTM_DELLINK, 7, "wwan0", 0);
+    g_assert (!mm_netlink_peek_link_info (netlink, 7));
+    g_assert (!mm_netlink_peek_link_info_by_name (netlink, "wwan0"));
+}
+
+/*****************************************************************************/
+
+static MMKernelDevice *
+link_kernel_device_new (const gchar *ifname,
+                        const gchar *uid)
+{
+    g_autoptr(MMKernelEventProperties) props = NULL;
+    g_autoptr(GError)                  error = NULL;
+    MMKernelDevice                    *kernel_device;
+
+    props = mm_kernel_event_properties_new ();
+    mm_kernel_event_properties_set_action    (props, "add");
+    mm_kernel_event_properties_set_subsystem (props, "net");
+    mm_kernel_event_properties_set_name      (props, ifname);
+    if (uid)
+        mm_kernel_event_properties_set_uid (props, uid);
+    kernel_device = mm_kernel_device_generic_new_with_rules (props, NULL, &error);
+    if (!kernel_device)
+        g_debug ("couldn't create kernel device for link 'net/%s': %s", ifname, error->message);
+    return kernel_device;
+}
+
+static void
+kernel_device_notified_cb (MMPort     *port,
+                           GParamSpec *pspec,
+                           guint      *n_notified)
+{
+    (*n_notified)++;
+}
+
+/* A link port is grabbed as soon as the link is reported via netlink, and
+ * grabbed again once the kernel device event is processed */
+static void
+test_link_port_grabbed_twice (void)
+{
+    g_autoptr(MMNetlink)      netlink = NULL;
+    g_autoptr(MMKernelDevice) netlink_device = NULL;
+    g_autoptr(MMKernelDevice) udev_device = NULL;
+    g_autoptr(MMPortNet)      port = NULL;
+    guint                     n_notified = 0;
+
+    netlink = mm_netlink_new_fake ();
+    fake_link (netlink, RTM_NEWLINK, 1, "lo", 0);
+    g_assert (mm_netlink_peek_link_info_by_name (netlink, "lo"));
+
+    /* Built like the base modem does when the link is reported via netlink;
+     * a link that really exists in sysfs is required */
+    netlink_device = link_kernel_device_new ("lo", NULL);
+    if (!netlink_device) {
+        g_test_skip ("no loopback link available");
+        return;
+    }
+
+    port = mm_port_net_new ("lo");
+    g_object_set (port, MM_PORT_KERNEL_DEVICE, netlink_device, NULL);
+    g_assert (mm_port_peek_kernel_device (MM_PORT (port)) == netlink_device);
+
+    g_signal_connect (port, "notify::" MM_PORT_KERNEL_DEVICE, G_CALLBACK (kernel_device_notified_cb), &n_notified);
+
+    /* The kernel device event of the same link arrives afterwards */
+    udev_device = link_kernel_device_new ("lo", "test-uid");
+    g_assert (udev_device);
+    mm_port_update_kernel_device (MM_PORT (port), udev_device);
+    g_assert (mm_port_peek_kernel_device (MM_PORT (port)) == udev_device);
+    g_assert_cmpstr (mm_kernel_device_get_physdev_uid (mm_port_peek_kernel_device (MM_PORT (port))), ==, "test-uid");
+    g_assert_cmpuint (n_notified, ==, 1);
+
+    /* Reporting the same kernel device again is a no-op */
+    mm_port_update_kernel_device (MM_PORT (port), udev_device);
+    g_assert_cmpuint (n_notified, ==, 1);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/netlink/wait-link/appears",       test_wait_link_appears);
+    g_test_add_func ("/MM/netlink/wait-link/already-known", test_wait_link_already_known);
+    g_test_add_func ("/MM/netlink/wait-link/mux-id",        test_wait_link_mux_id);
+    g_test_add_func ("/MM/netlink/wait-link/batched",       test_wait_link_batched);
+    g_test_add_func ("/MM/netlink/wait-link/timeout",       test_wait_link_timeout);
+    g_test_add_func ("/MM/netlink/link-cache",              test_link_cache);
+    g_test_add_func ("/MM/netlink/link-port/grabbed-twice", test_link_port_grabbed_twice);
+
+    return g_test_run ();
+}
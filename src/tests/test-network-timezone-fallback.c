@@ -0,0 +1,229 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <glib.h>
+#include <locale.h>
+
+#include "mm-network-timezone-fallback.h"
+#include "mm-log-test.h"
+
+#define DELAY_USECS   (MM_NETWORK_TIMEZONE_FALLBACK_DELAY_SECS * G_USEC_PER_SEC)
+#define MAX_AGE_USECS (MM_NETWORK_TIMEZONE_FALLBACK_MAX_AGE_SECS * G_USEC_PER_SEC)
+
+/*****************************************************************************/
+
+typedef struct {
+    MMPollScheduler           *scheduler;
+    MMNetworkTimezoneFallback *fallback;
+    /* Fake monotonic clock, in microseconds */
+    gint64                     now;
+    guint                      n_queries;
+} TestContext;
+
+static gint64
+test_clock (TestContext *ctx)
+{
+    return ctx->now;
+}
+
+static void
+test_query (TestContext *ctx)
+{
+    ctx->n_queries++;
+}
+
+static TestContext *
+test_context_new (void)
+{
+    TestContext *ctx;
+
+    ctx = g_new0 (TestContext, 1);
+    ctx->scheduler = mm_poll_scheduler_new (NULL);
+    /* Never 0, which the scheduler uses as "no deadline" */
+    ctx->now = G_USEC_PER_SEC;
+    mm_poll_scheduler_set_clock (ctx->scheduler, (MMPollSchedulerClock) test_clock, ctx);
+    ctx->fallback = mm_network_timezone_fallback_new (ctx->scheduler,
+                                                      NULL,
+                                                      (MMNetworkTimezoneFallbackQueryFn) test_query,
+                                                      ctx);
+    return ctx;
+}
+
+static void
+test_context_free (TestContext *ctx)
+{
+    mm_network_timezone_fallback_free (ctx->fallback);
+    mm_poll_scheduler_unref (ctx->scheduler);
+    g_free (ctx);
+}
+
+/* Moves the clock forward, dispatching the tasks at each deadline on the
+ * way, as the timeout source would */
+static void
+advance (TestContext *ctx,
+         gint64       usecs)
+{
+    gint64 target;
+    gint64 deadline;
+
+    target = ctx->now + usecs;
+    while ((deadline = mm_poll_scheduler_get_next_deadline (ctx->scheduler)) != 0 && deadline <= target) {
+        ctx->now = MAX (ctx->now, deadline);
+        mm_poll_scheduler_dispatch (ctx->scheduler);
+    }
+    ctx->now = target;
+}
+
+/*****************************************************************************/
+
+static void
+test_query_scheduled (void)
+{
+    TestContext *ctx;
+
+    ctx = test_context_new ();
+
+    mm_network_timezone_fallback_registered (ctx->fallback, ctx->now);
+    g_assert (mm_network_timezone_fallback_is_scheduled (ctx->fallback));
+
+    advance (ctx, DELAY_USECS - G_USEC_PER_SEC);
+    g_assert_cmpuint (ctx->n_queries, ==, 0);
+    advance (ctx, G_USEC_PER_SEC);
+    g_assert_cmpuint (ctx->n_queries, ==, 1);
+
+    /* Single query, not repeated */
+    g_assert (!mm_network_timezone_fallback_is_scheduled (ctx->fallback));
+    advance (ctx, 10 * DELAY_USECS);
+    g_assert_cmpuint (ctx->n_queries, ==, 1);
+
+    g_assert_cmpuint (mm_network_timezone_fallback_get_n_queries (ctx->fallback), ==, 1);
+    g_assert_cmpuint (mm_network_timezone_fallback_get_n_queries_avoided (ctx->fallback), ==, 0);
+    test_context_free (ctx);
+}
+
+static void
+test_query_cancelled (void)
+{
+    TestContext *ctx;
+
+    ctx = test_context_new ();
+
+    mm_network_timezone_fallback_registered (ctx->fallback, ctx->now);
+    advance (ctx, G_USEC_PER_SEC);
+    mm_network_timezone_fallback_unregistered (ctx->fallback);
+    g_assert (!mm_network_timezone_fallback_is_scheduled (ctx->fallback));
+    advance (ctx, DELAY_USECS);
+    g_assert_cmpuint (ctx->n_queries, ==, 0);
+
+    /* Scheduled again from scratch when registered again */
+    mm_network_timezone_fallback_registered (ctx->fallback, ctx->now);
+    advance (ctx, DELAY_USECS);
+    g_assert_cmpuint (ctx->n_queries, ==, 1);
+
+    /* Cancelled when reset, e.g. on disable */
+    mm_network_timezone_fallback_reset (ctx->fallback);
+    mm_network_timezone_fallback_registered (ctx->fallback, ctx->now);
+    mm_network_timezone_fallback_reset (ctx->fallback);
+    advance (ctx, DELAY_USECS);
+    g_assert_cmpuint (ctx->n_queries, ==, 1);
+
+    g_assert_cmpuint (mm_network_timezone_fallback_get_n_queries_avoided (ctx->fallback), ==, 0);
+    test_context_free (ctx);
+}
+
+static void
+test_query_avoided_reported (void)
+{
+    TestContext *ctx;
+
+    ctx = test_context_new ();
+
+    /* Reported while the query is pending */
+    mm_network_timezone_fallback_registered (ctx->fallback, ctx->now);
+    advance (ctx, G_USEC_PER_SEC);
+    mm_network_timezone_fallback_reported (ctx->fallback, ctx->now);
+    g_assert (!mm_network_timezone_fallback_is_scheduled (ctx->fallback));
+    advance (ctx, DELAY_USECS);
+    g_assert_cmpuint (ctx->n_queries, ==, 0);
+    g_assert_cmpuint (mm_network_timezone_fallback_get_n_queries_avoided (ctx->fallback), ==, 1);
+
+    /* Registration flapping right after the report */
+    mm_network_timezone_fallback_unregistered (ctx->fallback);
+    mm_network_timezone_fallback_registered (ctx->fallback, ctx->now);
+    g_assert (!mm_network_timezone_fallback_is_scheduled (ctx->fallback));
+    g_assert_cmpuint (mm_network_timezone_fallback_get_n_queries_avoided (ctx->fallback), ==, 2);
+
+    /* Reports without a pending query aren't avoided queries */
+    mm_network_timezone_fallback_reported (ctx->fallback, ctx->now);
+    g_assert_cmpuint (mm_network_timezone_fallback_get_n_reported (ctx->fallback), ==, 2);
+    g_assert_cmpuint (mm_network_timezone_fallback_get_n_queries_avoided (ctx->fallback), ==, 2);
+
+    /* Once too old, queried again */
+    advance (ctx, MAX_AGE_USECS);
+    mm_network_timezone_fallback_registered (ctx->fallback, ctx->now);
+    g_assert (mm_network_timezone_fallback_is_scheduled (ctx->fallback));
+    advance (ctx, DELAY_USECS);
+    g_assert_cmpuint (ctx->n_queries, ==, 1);
+
+    test_context_free (ctx);
+}
+
+static void
+test_query_avoided_queried (void)
+{
+    TestContext *ctx;
+
+    ctx = test_context_new ();
+
+    mm_network_timezone_fallback_registered (ctx->fallback, ctx->now);
+    advance (ctx, DELAY_USECS);
+    g_assert_cmpuint (ctx->n_queries, ==, 1);
+    mm_network_timezone_fallback_queried (ctx->fallback, ctx->now);
+
+    /* Re-registration after a successful query */
+    mm_network_timezone_fallback_unregistered (ctx->fallback);
+    advance (ctx, G_USEC_PER_SEC);
+    mm_network_timezone_fallback_registered (ctx->fallback, ctx->now);
+    g_assert (!mm_network_timezone_fallback_is_scheduled (ctx->fallback));
+    g_assert_cmpuint (mm_network_timezone_fallback_get_n_queries_avoided (ctx->fallback), ==, 1);
+
+    /* Forgotten when reset, e.g. on disable */
+    mm_network_timezone_fallback_reset (ctx->fallback);
+    mm_network_timezone_fallback_registered (ctx->fallback, ctx->now);
+    g_assert (mm_network_timezone_fallback_is_scheduled (ctx->fallback));
+    advance (ctx, DELAY_USECS);
+    g_assert_cmpuint (ctx->n_queries, ==, 2);
+
+    /* Stats kept across resets */
+    g_assert_cmpuint (mm_network_timezone_fallback_get_n_queries (ctx->fallback), ==, 2);
+    g_assert_cmpuint (mm_network_timezone_fallback_get_n_queries_avoided (ctx->fallback), ==, 1);
+    test_context_free (ctx);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/network-timezone-fallback/scheduled",        test_query_scheduled);
+    g_test_add_func ("/MM/network-timezone-fallback/cancelled",        test_query_cancelled);
+    g_test_add_func ("/MM/network-timezone-fallback/avoided-reported", test_query_avoided_reported);
+    g_test_add_func ("/MM/network-timezone-fallback/avoided-queried",  test_query_avoided_queried);
+
+    return g_test_run ();
+}
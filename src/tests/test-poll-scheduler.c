@@ -0,0 +1,227 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <glib.h>
+#include <locale.h>
+#include <string.h>
+
+#include "mm-poll-scheduler.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+
+typedef struct {
+    MMPollScheduler *scheduler;
+    /* Fake monotonic clock, in microseconds */
+    gint64           now;
+    GString         *runs;
+    guint            n_repeats;
+} TestContext;
+
+typedef struct {
+    TestContext *ctx;
+    gchar        name;
+} TaskData;
+
+static gboolean
+task_cb (TaskData *data)
+{
+    g_string_append_c (data->ctx->runs, data->name);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean
+repeating_task_cb (TaskData *data)
+{
+    TestContext *ctx = data->ctx;
+
+    g_string_append_c (ctx->runs, data->name);
+    return (--ctx->n_repeats > 0) ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+static gint64
+test_clock (TestContext *ctx)
+{
+    return ctx->now;
+}
+
+static TestContext *
+test_context_new (void)
+{
+    TestContext *ctx;
+
+    ctx = g_new0 (TestContext, 1);
+    ctx->scheduler = mm_poll_scheduler_new (NULL);
+    /* Never 0, which the scheduler uses as "no deadline" */
+    ctx->now = G_USEC_PER_SEC;
+    mm_poll_scheduler_set_clock (ctx->scheduler, (MMPollSchedulerClock) test_clock, ctx);
+    ctx->runs = g_string_new (NULL);
+    return ctx;
+}
+
+static void
+test_context_free (TestContext *ctx)
+{
+    mm_poll_scheduler_unref (ctx->scheduler);
+    g_string_free (ctx->runs, TRUE);
+    g_free (ctx);
+}
+
+/* Moves the clock forward, dispatching the tasks at each deadline on the
+ * way, as the timeout source would */
+static void
+advance (TestContext *ctx,
+         gint64       usecs)
+{
+    gint64 target;
+    gint64 deadline;
+
+    target = ctx->now + usecs;
+    while ((deadline = mm_poll_scheduler_get_next_deadline (ctx->scheduler)) != 0 && deadline <= target) {
+        ctx->now = MAX (ctx->now, deadline);
+        mm_poll_scheduler_dispatch (ctx->scheduler);
+    }
+    ctx->now = target;
+}
+
+/*****************************************************************************/
+
+static void
+test_aligned (void)
+{
+    TestContext *ctx;
+    TaskData     a;
+    TaskData     b;
+
+    ctx = test_context_new ();
+    a = (TaskData) { ctx, 'A' };
+    b = (TaskData) { ctx, 'B' };
+
+    /* B is due 1s after A, within its slack: both run in the same wakeup */
+    mm_poll_scheduler_add_seconds (ctx->scheduler, "a", 4, (GSourceFunc) task_cb, &a);
+    mm_poll_scheduler_add_seconds (ctx->scheduler, "b", 5, (GSourceFunc) task_cb, &b);
+    advance (ctx, 5 * G_USEC_PER_SEC);
+
+    g_assert_cmpstr (ctx->runs->str, ==, "AB");
+    g_assert_cmpuint (mm_poll_scheduler_get_n_wakeups (ctx->scheduler), ==, 1);
+    g_assert_cmpuint (mm_poll_scheduler_get_n_runs (ctx->scheduler), ==, 2);
+    test_context_free (ctx);
+}
+
+static void
+test_not_aligned (void)
+{
+    TestContext *ctx;
+    TaskData     a;
+    TaskData     b;
+
+    ctx = test_context_new ();
+    a = (TaskData) { ctx, 'A' };
+    b = (TaskData) { ctx, 'B' };
+
+    /* B is due 3s after A, out of its slack: separate wakeups */
+    mm_poll_scheduler_add_seconds (ctx->scheduler, "b", 5, (GSourceFunc) task_cb, &b);
+    mm_poll_scheduler_add_seconds (ctx->scheduler, "a", 2, (GSourceFunc) task_cb, &a);
+    advance (ctx, 2 * G_USEC_PER_SEC);
+    g_assert_cmpstr (ctx->runs->str, ==, "A");
+    advance (ctx, 3 * G_USEC_PER_SEC);
+
+    g_assert_cmpstr (ctx->runs->str, ==, "AB");
+    g_assert_cmpuint (mm_poll_scheduler_get_n_wakeups (ctx->scheduler), ==, 2);
+    test_context_free (ctx);
+}
+
+static void
+test_repeat (void)
+{
+    TestContext *ctx;
+    TaskData     a;
+
+    ctx = test_context_new ();
+    a = (TaskData) { ctx, 'A' };
+
+    ctx->n_repeats = 3;
+    mm_poll_scheduler_add_seconds (ctx->scheduler, "a", 1, (GSourceFunc) repeating_task_cb, &a);
+    advance (ctx, 10 * G_USEC_PER_SEC);
+
+    g_assert_cmpstr (ctx->runs->str, ==, "AAA");
+    g_assert_cmpuint (mm_poll_scheduler_get_n_runs (ctx->scheduler), ==, 3);
+    g_assert_cmpint (mm_poll_scheduler_get_next_deadline (ctx->scheduler), ==, 0);
+    test_context_free (ctx);
+}
+
+static void
+test_remove (void)
+{
+    TestContext *ctx;
+    TaskData     a;
+    TaskData     b;
+    guint        id;
+
+    ctx = test_context_new ();
+    a = (TaskData) { ctx, 'A' };
+    b = (TaskData) { ctx, 'B' };
+
+    id = mm_poll_scheduler_add_seconds (ctx->scheduler, "a", 1, (GSourceFunc) task_cb, &a);
+    mm_poll_scheduler_add_seconds (ctx->scheduler, "b", 2, (GSourceFunc) task_cb, &b);
+    mm_poll_scheduler_remove (ctx->scheduler, id);
+    advance (ctx, 2 * G_USEC_PER_SEC);
+
+    g_assert_cmpstr (ctx->runs->str, ==, "B");
+    test_context_free (ctx);
+}
+
+static void
+test_defer (void)
+{
+    TestContext *ctx;
+    TaskData     a;
+    guint        id;
+
+    ctx = test_context_new ();
+    a = (TaskData) { ctx, 'A' };
+
+    /* Deferred 1s after being added, so it runs 1s later than it would */
+    id = mm_poll_scheduler_add_seconds (ctx->scheduler, "a", 2, (GSourceFunc) task_cb, &a);
+    advance (ctx, G_USEC_PER_SEC);
+    mm_poll_scheduler_defer (ctx->scheduler, id);
+
+    /* Not run yet, even if the original deadline passed */
+    advance (ctx, 3 * G_USEC_PER_SEC / 2);
+    g_assert_cmpstr (ctx->runs->str, ==, "");
+
+    advance (ctx, G_USEC_PER_SEC / 2);
+    g_assert_cmpstr (ctx->runs->str, ==, "A");
+    g_assert_cmpuint (mm_poll_scheduler_get_n_deferred (ctx->scheduler), ==, 1);
+    g_assert_cmpuint (mm_poll_scheduler_get_n_wakeups (ctx->scheduler), ==, 1);
+    test_context_free (ctx);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/poll-scheduler/aligned",     test_aligned);
+    g_test_add_func ("/MM/poll-scheduler/not-aligned", test_not_aligned);
+    g_test_add_func ("/MM/poll-scheduler/repeat",      test_repeat);
+    g_test_add_func ("/MM/poll-scheduler/remove",      test_remove);
+    g_test_add_func ("/MM/poll-scheduler/defer",       test_defer);
+
+    return g_test_run ();
+}
@@ -0,0 +1,181 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <glib.h>
+#include <locale.h>
+
+#include "mm-port-metrics.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+
+static GVariant *
+lookup_command (GVariant    *dictionary,
+                const gchar *command)
+{
+    g_autoptr(GVariant) commands = NULL;
+    GVariantIter        iter;
+    GVariant           *command_dict;
+
+    commands = g_variant_lookup_value (dictionary, "commands", G_VARIANT_TYPE ("aa{sv}"));
+    g_assert (commands);
+
+    g_variant_iter_init (&iter, commands);
+    while ((command_dict = g_variant_iter_next_value (&iter))) {
+        const gchar *name = NULL;
+
+        g_assert (g_variant_lookup (command_dict, "command", "&s", &name));
+        if (g_str_equal (name, command))
+            return command_dict;
+        g_variant_unref (command_dict);
+    }
+    return NULL;
+}
+
+static void
+test_counters (void)
+{
+    g_autoptr(MMPortMetrics) metrics = NULL;
+    g_autoptr(GVariant)      dictionary = NULL;
+    g_autoptr(GVariant)      command = NULL;
+    gint64                   start1;
+    gint64                   start2;
+    gint64                   start3;
+    const gchar             *port = NULL;
+    guint                    value32 = 0;
+    guint64                  value64 = 0;
+
+    metrics = mm_port_metrics_new ();
+
+    start1 = mm_port_metrics_request_started (metrics);
+    start2 = mm_port_metrics_request_started (metrics);
+    g_assert_cmpuint (mm_port_metrics_get_in_flight (metrics), ==, 2);
+    mm_port_metrics_request_completed (metrics, "+CSQ", start1, MM_PORT_METRICS_RESULT_SUCCESS);
+    mm_port_metrics_request_completed (metrics, "+CSQ", start2, MM_PORT_METRICS_RESULT_ERROR);
+    g_assert_cmpuint (mm_port_metrics_get_in_flight (metrics), ==, 0);
+
+    start3 = mm_port_metrics_request_started (metrics);
+    g_assert_cmpuint (mm_port_metrics_get_in_flight (metrics), ==, 1);
+    mm_port_metrics_request_completed (metrics, "+COPS", start3, MM_PORT_METRICS_RESULT_TIMEOUT);
+
+    dictionary = g_variant_ref_sink (mm_port_metrics_build_dictionary (metrics, "ttyUSB2"));
+    g_assert (g_variant_lookup (dictionary, "port", "&s", &port));
+    g_assert_cmpstr (port, ==, "ttyUSB2");
+    g_assert (g_variant_lookup (dictionary, "in-flight", "u", &value32));
+    g_assert_cmpuint (value32, ==, 0);
+    g_assert (g_variant_lookup (dictionary, "max-in-flight", "u", &value32));
+    g_assert_cmpuint (value32, ==, 2);
+    g_assert (g_variant_lookup (dictionary, "requests", "t", &value64));
+    g_assert_cmpuint (value64, ==, 3);
+    g_assert (g_variant_lookup (dictionary, "errors", "t", &value64));
+    g_assert_cmpuint (value64, ==, 1);
+    g_assert (g_variant_lookup (dictionary, "timeouts", "t", &value64));
+    g_assert_cmpuint (value64, ==, 1);
+
+    command = lookup_command (dictionary, "+CSQ");
+    g_assert (command);
+    g_assert (g_variant_lookup (command, "requests", "t", &value64));
+    g_assert_cmpuint (value64, ==, 2);
+    g_assert (g_variant_lookup (command, "errors", "t", &value64));
+    g_assert_cmpuint (value64, ==, 1);
+    g_assert (g_variant_lookup (command, "timeouts", "t", &value64));
+    g_assert_cmpuint (value64, ==, 0);
+}
+
+static void
+test_histogram (void)
+{
+    g_autoptr(MMPortMetrics) metrics = NULL;
+    g_autoptr(GVariant)      dictionary = NULL;
+    g_autoptr(GVariant)      command = NULL;
+    g_autoptr(GVariant)      histogram = NULL;
+    const guint64           *buckets;
+    gsize                    n_buckets;
+    guint                    latency_max = 0;
+    gint64                   now;
+
+    metrics = mm_port_metrics_new ();
+
+    /* Fake start times, so that the latencies are known in advance */
+    mm_port_metrics_request_started (metrics);
+    mm_port_metrics_request_started (metrics);
+    mm_port_metrics_request_started (metrics);
+    now = g_get_monotonic_time ();
+    mm_port_metrics_request_completed (metrics, "0x1F", now, MM_PORT_METRICS_RESULT_SUCCESS);
+    mm_port_metrics_request_completed (metrics, "0x1F", now - 5000 * 1000, MM_PORT_METRICS_RESULT_SUCCESS);
+    mm_port_metrics_request_completed (metrics, "0x1F", now - 1000000 * 1000, MM_PORT_METRICS_RESULT_SUCCESS);
+
+    dictionary = g_variant_ref_sink (mm_port_metrics_build_dictionary (metrics, "ttyUSB0"));
+    command = lookup_command (dictionary, "0x1F");
+    g_assert (command);
+
+    histogram = g_variant_lookup_value (command, "latency-histogram", G_VARIANT_TYPE ("at"));
+    g_assert (histogram);
+    buckets = g_variant_get_fixed_array (histogram, &n_buckets, sizeof (guint64));
+    g_assert_cmpuint (n_buckets, ==, MM_PORT_METRICS_N_BUCKETS);
+    /* 0ms, 4096-8191ms, and way over the last bucket */
+    g_assert_cmpuint (buckets[0], ==, 1);
+    g_assert_cmpuint (buckets[12], ==, 1);
+    g_assert_cmpuint (buckets[MM_PORT_METRICS_N_BUCKETS - 1], ==, 1);
+
+    g_assert (g_variant_lookup (command, "latency-max", "u", &latency_max));
+    g_assert_cmpuint (latency_max, >=, 1000000);
+}
+
+static void
+test_other_command (void)
+{
+    g_autoptr(MMPortMetrics) metrics = NULL;
+    g_autoptr(GVariant)      dictionary = NULL;
+    g_autoptr(GVariant)      commands = NULL;
+    g_autoptr(GVariant)      other = NULL;
+    guint64                  requests = 0;
+    guint                    i;
+
+    metrics = mm_port_metrics_new ();
+
+    for (i = 0; i < MM_PORT_METRICS_MAX_COMMANDS + 2; i++) {
+        g_autofree gchar *name = NULL;
+        gint64            start;
+
+        name = g_strdup_printf ("command-%03u", i);
+        start = mm_port_metrics_request_started (metrics);
+        mm_port_metrics_request_completed (metrics, name, start, MM_PORT_METRICS_RESULT_SUCCESS);
+    }
+
+    dictionary = g_variant_ref_sink (mm_port_metrics_build_dictionary (metrics, "cdc-wdm0"));
+    commands = g_variant_lookup_value (dictionary, "commands", G_VARIANT_TYPE ("aa{sv}"));
+    g_assert_cmpuint (g_variant_n_children (commands), ==, MM_PORT_METRICS_MAX_COMMANDS + 1);
+
+    other = lookup_command (dictionary, MM_PORT_METRICS_OTHER_COMMAND);
+    g_assert (other);
+    g_assert (g_variant_lookup (other, "requests", "t", &requests));
+    g_assert_cmpuint (requests, ==, 2);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/port-metrics/counters",      test_counters);
+    g_test_add_func ("/MM/port-metrics/histogram",     test_histogram);
+    g_test_add_func ("/MM/port-metrics/other-command", test_other_command);
+
+    return g_test_run ();
+}
@@ -0,0 +1,306 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <glib-object.h>
+#include <locale.h>
+#include <string.h>
+
+#include "mm-qmi-indication-router.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+/* Fake client, with an indication signal carrying a boxed output */
+
+typedef GObject      TestClient;
+typedef GObjectClass TestClientClass;
+
+static GType test_client_get_type (void);
+G_DEFINE_TYPE (TestClient, test_client, G_TYPE_OBJECT)
+
+static guint event_report_signal;
+
+static void
+test_client_init (TestClient *self)
+{
+}
+
+static void
+test_client_class_init (TestClientClass *klass)
+{
+    event_report_signal =
+        g_signal_new ("event-report",
+                      G_TYPE_FROM_CLASS (klass),
+                      G_SIGNAL_RUN_LAST,
+                      0, NULL, NULL, NULL,
+                      G_TYPE_NONE, 1, G_TYPE_BYTES);
+}
+
+static void
+emit_event_report (GObject     *client,
+                   const gchar *data)
+{
+    g_autoptr(GBytes) output = NULL;
+
+    output = g_bytes_new (data, strlen (data));
+    g_signal_emit (client, event_report_signal, 0, output);
+}
+
+/*****************************************************************************/
+
+typedef struct {
+    MMQmiIndicationRouter *router;
+    guint                  n_calls;
+    guint                  remove_on_call;
+    gchar                 *last;
+} Listener;
+
+static void
+listener_cb (GObject  *client,
+             GBytes   *output,
+             Listener *listener)
+{
+    listener->n_calls++;
+    g_free (listener->last);
+    listener->last = g_strndup (g_bytes_get_data (output, NULL), g_bytes_get_size (output));
+    if (listener->remove_on_call) {
+        mm_qmi_indication_router_remove_listener (listener->router, listener->remove_on_call);
+        listener->remove_on_call = 0;
+    }
+}
+
+static void
+test_fan_out (void)
+{
+    g_autoptr(MMQmiIndicationRouter) router = NULL;
+    g_autoptr(GObject)               client = NULL;
+    Listener                         listener1 = { 0 };
+    Listener                         listener2 = { 0 };
+    guint                            id1;
+    guint                            id2;
+    GBytes                          *last;
+
+    router = mm_qmi_indication_router_new (NULL);
+    client = g_object_new (test_client_get_type (), NULL);
+
+    id1 = mm_qmi_indication_router_add_listener (router, client, "event-report", (MMQmiIndicationCallback) listener_cb, &listener1);
+    id2 = mm_qmi_indication_router_add_listener (router, client, "event-report", (MMQmiIndicationCallback) listener_cb, &listener2);
+    g_assert_cmpuint (id1, !=, 0);
+    g_assert_cmpuint (id2, !=, 0);
+    g_assert_cmpuint (id1, !=, id2);
+
+    /* No output cached before the first indication */
+    g_assert (!mm_qmi_indication_router_peek_last (router, client, "event-report"));
+
+    emit_event_report (client, "first");
+    emit_event_report (client, "second");
+    g_assert_cmpuint (listener1.n_calls, ==, 2);
+    g_assert_cmpuint (listener2.n_calls, ==, 2);
+    g_assert_cmpstr (listener1.last, ==, "second");
+    g_assert_cmpstr (listener2.last, ==, "second");
+
+    last = mm_qmi_indication_router_peek_last (router, client, "event-report");
+    g_assert (last);
+    g_assert_cmpmem (g_bytes_get_data (last, NULL), g_bytes_get_size (last), "second", strlen ("second"));
+
+    /* The signal handler and the cached output stay until the last listener
+     * is removed */
+    mm_qmi_indication_router_remove_listener (router, id1);
+    g_assert (g_signal_has_handler_pending (client, event_report_signal, 0, FALSE));
+    g_assert (mm_qmi_indication_router_peek_last (router, client, "event-report"));
+
+    emit_event_report (client, "third");
+    g_assert_cmpuint (listener1.n_calls, ==, 2);
+    g_assert_cmpuint (listener2.n_calls, ==, 3);
+
+    mm_qmi_indication_router_remove_listener (router, id2);
+    g_assert (!g_signal_has_handler_pending (client, event_report_signal, 0, FALSE));
+    g_assert (!mm_qmi_indication_router_peek_last (router, client, "event-report"));
+
+    g_free (listener1.last);
+    g_free (listener2.last);
+}
+
+static void
+test_remove_while_dispatching (void)
+{
+    g_autoptr(MMQmiIndicationRouter) router = NULL;
+    g_autoptr(GObject)               client = NULL;
+    Listener                         listener1 = { 0 };
+    Listener                         listener2 = { 0 };
+    guint                            id1;
+
+    router = mm_qmi_indication_router_new (NULL);
+    client = g_object_new (test_client_get_type (), NULL);
+
+    /* The first listener removes the second one before it gets the
+     * indication */
+    listener1.router = router;
+    id1 = mm_qmi_indication_router_add_listener (router, client, "event-report", (MMQmiIndicationCallback) listener_cb, &listener1);
+    listener1.remove_on_call = mm_qmi_indication_router_add_listener (router, client, "event-report", (MMQmiIndicationCallback) listener_cb, &listener2);
+
+    emit_event_report (client, "first");
+    g_assert_cmpuint (listener1.n_calls, ==, 1);
+    g_assert_cmpuint (listener2.n_calls, ==, 0);
+    g_assert (g_signal_has_handler_pending (client, event_report_signal, 0, FALSE));
+
+    /* A listener removing itself, the last one, during dispatch */
+    listener1.remove_on_call = id1;
+    emit_event_report (client, "second");
+    g_assert_cmpuint (listener1.n_calls, ==, 2);
+    g_assert (!g_signal_has_handler_pending (client, event_report_signal, 0, FALSE));
+    g_assert (!mm_qmi_indication_router_peek_last (router, client, "event-report"));
+
+    g_free (listener1.last);
+}
+
+static void
+test_unknown_indication (void)
+{
+    g_autoptr(MMQmiIndicationRouter) router = NULL;
+    g_autoptr(GObject)               client = NULL;
+    Listener                         listener = { 0 };
+
+    router = mm_qmi_indication_router_new (NULL);
+    client = g_object_new (test_client_get_type (), NULL);
+
+    g_assert_cmpuint (mm_qmi_indication_router_add_listener (router, client, "unknown", (MMQmiIndicationCallback) listener_cb, &listener), ==, 0);
+}
+
+static void
+test_registrations (void)
+{
+    g_autoptr(MMQmiIndicationRouter) router = NULL;
+    g_autoptr(GObject)               client1 = NULL;
+    g_autoptr(GObject)               client2 = NULL;
+    MMQmiIndicationRouterStats       stats;
+
+    router = mm_qmi_indication_router_new (NULL);
+    client1 = g_object_new (test_client_get_type (), NULL);
+    client2 = g_object_new (test_client_get_type (), NULL);
+
+    g_assert (!mm_qmi_indication_router_is_registered (router, client1, "signal-info"));
+
+    /* Only the first one enabling sends the request */
+    g_assert (mm_qmi_indication_router_ref_registration (router, client1, "signal-info"));
+    g_assert (!mm_qmi_indication_router_ref_registration (router, client1, "signal-info"));
+    g_assert (mm_qmi_indication_router_is_registered (router, client1, "signal-info"));
+
+    /* Registrations are tracked per client and name */
+    g_assert (!mm_qmi_indication_router_is_registered (router, client2, "signal-info"));
+    g_assert (!mm_qmi_indication_router_is_registered (router, client1, "system-info"));
+    g_assert (mm_qmi_indication_router_ref_registration (router, client2, "signal-info"));
+
+    /* Only the last one disabling sends the request */
+    g_assert (!mm_qmi_indication_router_unref_registration (router, client1, "signal-info"));
+    g_assert (mm_qmi_indication_router_is_registered (router, client1, "signal-info"));
+    g_assert (mm_qmi_indication_router_unref_registration (router, client1, "signal-info"));
+    g_assert (!mm_qmi_indication_router_is_registered (router, client1, "signal-info"));
+
+    /* Unbalanced disabling is ignored */
+    g_assert (!mm_qmi_indication_router_unref_registration (router, client1, "signal-info"));
+
+    mm_qmi_indication_router_get_stats (router, &stats);
+    g_assert_cmpuint (stats.registrations_sent, ==, 3);
+    g_assert_cmpuint (stats.registrations_skipped, ==, 3);
+    g_assert_cmpuint (stats.indications, ==, 0);
+}
+
+static void
+test_metrics (void)
+{
+    g_autoptr(MMQmiIndicationRouter) router = NULL;
+    g_autoptr(GObject)               client1 = NULL;
+    g_autoptr(GObject)               client2 = NULL;
+    g_autoptr(GVariant)              metrics = NULL;
+    g_autoptr(GVariant)              indications = NULL;
+    g_autoptr(GVariant)              registrations = NULL;
+    g_autoptr(GVariant)              entry = NULL;
+    Listener                         listener1 = { 0 };
+    Listener                         listener2 = { 0 };
+    GVariantDict                     dict;
+    const gchar                     *name;
+    guint64                          value64;
+    guint32                          value32;
+    guint                            id;
+
+    router = mm_qmi_indication_router_new (NULL);
+    client1 = g_object_new (test_client_get_type (), NULL);
+    client2 = g_object_new (test_client_get_type (), NULL);
+
+    id = mm_qmi_indication_router_add_listener (router, client1, "event-report", (MMQmiIndicationCallback) listener_cb, &listener1);
+    mm_qmi_indication_router_add_listener (router, client1, "event-report", (MMQmiIndicationCallback) listener_cb, &listener2);
+    emit_event_report (client1, "first");
+    mm_qmi_indication_router_remove_listener (router, id);
+    emit_event_report (client1, "second");
+
+    g_assert (mm_qmi_indication_router_ref_registration (router, client1, "signal-info"));
+    g_assert (!mm_qmi_indication_router_ref_registration (router, client1, "signal-info"));
+    g_assert (mm_qmi_indication_router_ref_registration (router, client2, "signal-info"));
+    mm_qmi_indication_router_count_request_avoided (router);
+
+    g_variant_dict_init (&dict, NULL);
+    mm_qmi_indication_router_add_metrics (router, &dict);
+    metrics = g_variant_ref_sink (g_variant_dict_end (&dict));
+
+    /* Counters are kept by indication name */
+    indications = g_variant_lookup_value (metrics, "qmi-indications", G_VARIANT_TYPE ("aa{sv}"));
+    g_assert (indications);
+    g_assert_cmpuint (g_variant_n_children (indications), ==, 1);
+    entry = g_variant_get_child_value (indications, 0);
+    g_assert (g_variant_lookup (entry, "indication", "&s", &name));
+    g_assert_cmpstr (name, ==, "event-report");
+    g_assert (g_variant_lookup (entry, "received", "t", &value64));
+    g_assert_cmpuint (value64, ==, 2);
+    g_assert (g_variant_lookup (entry, "dispatched", "t", &value64));
+    g_assert_cmpuint (value64, ==, 3);
+    g_clear_pointer (&entry, g_variant_unref);
+
+    /* And by registration name, with the users of all clients */
+    registrations = g_variant_lookup_value (metrics, "qmi-registrations", G_VARIANT_TYPE ("aa{sv}"));
+    g_assert (registrations);
+    g_assert_cmpuint (g_variant_n_children (registrations), ==, 1);
+    entry = g_variant_get_child_value (registrations, 0);
+    g_assert (g_variant_lookup (entry, "registration", "&s", &name));
+    g_assert_cmpstr (name, ==, "signal-info");
+    g_assert (g_variant_lookup (entry, "users", "u", &value32));
+    g_assert_cmpuint (value32, ==, 3);
+    g_assert (g_variant_lookup (entry, "sent", "t", &value64));
+    g_assert_cmpuint (value64, ==, 2);
+    g_assert (g_variant_lookup (entry, "skipped", "t", &value64));
+    g_assert_cmpuint (value64, ==, 1);
+
+    g_assert (g_variant_lookup (metrics, "qmi-requests-avoided", "t", &value64));
+    g_assert_cmpuint (value64, ==, 1);
+
+    g_free (listener1.last);
+    g_free (listener2.last);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/qmi-indication-router/fan-out",                 test_fan_out);
+    g_test_add_func ("/MM/qmi-indication-router/remove-while-dispatching", test_remove_while_dispatching);
+    g_test_add_func ("/MM/qmi-indication-router/unknown-indication",      test_unknown_indication);
+    g_test_add_func ("/MM/qmi-indication-router/registrations",           test_registrations);
+    g_test_add_func ("/MM/qmi-indication-router/metrics",                 test_metrics);
+
+    return g_test_run ();
+}
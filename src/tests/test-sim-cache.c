@@ -0,0 +1,147 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <locale.h>
+
+#include <ModemManager.h>
+#define _LIBMM_INSIDE_MM
+#include <libmm-glib.h>
+
+#include "mm-sim-cache.h"
+#include "mm-log-test.h"
+
+#define TEST_ICCID "8934071100276980483"
+
+/*****************************************************************************/
+
+static gchar *
+test_dir_new (void)
+{
+    g_autoptr(GError)  error = NULL;
+    gchar             *dir;
+
+    dir = g_dir_make_tmp ("test-sim-cache-XXXXXX", &error);
+    g_assert_no_error (error);
+    return dir;
+}
+
+static void
+test_dir_free (gchar *dir)
+{
+    g_autofree gchar *path = NULL;
+
+    path = g_build_filename (dir, TEST_ICCID ".keyfile", NULL);
+    g_unlink (path);
+    g_rmdir (dir);
+    g_free (dir);
+}
+
+/*****************************************************************************/
+
+static void
+test_store_load (void)
+{
+    g_autoptr(MMSimCacheEntry)  entry = NULL;
+    g_autoptr(MMSimCacheEntry)  loaded = NULL;
+    g_autoptr(GError)           error = NULL;
+    const gchar                *emergency_numbers[] = { "112", "911", NULL };
+    gchar                      *dir;
+
+    dir = test_dir_new ();
+
+    entry = mm_sim_cache_entry_new ();
+    entry->imsi = g_strdup ("214070123456789");
+    entry->operator_identifier = g_strdup ("21407");
+    entry->operator_name = g_strdup ("Movistar");
+    entry->emergency_numbers = g_strdupv ((gchar **) emergency_numbers);
+    entry->preferred_networks = g_variant_ref_sink (g_variant_new_parsed ("[('21401', uint32 3), ('21403', 1)]"));
+
+    g_assert (mm_sim_cache_store (dir, TEST_ICCID, entry, &error));
+    g_assert_no_error (error);
+
+    loaded = mm_sim_cache_load (dir, TEST_ICCID, &error);
+    g_assert_no_error (error);
+    g_assert (loaded);
+    g_assert_cmpstr (loaded->imsi, ==, entry->imsi);
+    g_assert_cmpstr (loaded->eid, ==, NULL);
+    g_assert_cmpstr (loaded->operator_identifier, ==, entry->operator_identifier);
+    g_assert_cmpstr (loaded->operator_name, ==, entry->operator_name);
+    g_assert (loaded->emergency_numbers);
+    g_assert_cmpuint (g_strv_length (loaded->emergency_numbers), ==, 2);
+    g_assert_cmpstr (loaded->emergency_numbers[0], ==, "112");
+    g_assert_cmpstr (loaded->emergency_numbers[1], ==, "911");
+    g_assert (loaded->preferred_networks);
+    g_assert (g_variant_equal (loaded->preferred_networks, entry->preferred_networks));
+
+    test_dir_free (dir);
+}
+
+static void
+test_remove (void)
+{
+    g_autoptr(MMSimCacheEntry)  entry = NULL;
+    g_autoptr(MMSimCacheEntry)  loaded = NULL;
+    g_autoptr(GError)           error = NULL;
+    gchar                      *dir;
+
+    dir = test_dir_new ();
+
+    entry = mm_sim_cache_entry_new ();
+    entry->imsi = g_strdup ("214070123456789");
+    g_assert (mm_sim_cache_store (dir, TEST_ICCID, entry, &error));
+    g_assert_no_error (error);
+
+    mm_sim_cache_remove (dir, TEST_ICCID);
+
+    /* A missing entry is not an error */
+    loaded = mm_sim_cache_load (dir, TEST_ICCID, &error);
+    g_assert_no_error (error);
+    g_assert (!loaded);
+
+    test_dir_free (dir);
+}
+
+static void
+test_invalid_iccid (void)
+{
+    g_autoptr(MMSimCacheEntry)  entry = NULL;
+    g_autoptr(GError)           error = NULL;
+    gchar                      *dir;
+
+    dir = test_dir_new ();
+
+    entry = mm_sim_cache_entry_new ();
+    g_assert (!mm_sim_cache_store (dir, "../" TEST_ICCID, entry, &error));
+    g_assert_error (error, MM_CORE_ERROR, MM_CORE_ERROR_INVALID_ARGS);
+
+    test_dir_free (dir);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/sim-cache/store-load",   test_store_load);
+    g_test_add_func ("/MM/sim-cache/remove",       test_remove);
+    g_test_add_func ("/MM/sim-cache/invalid-iccid", test_invalid_iccid);
+
+    return g_test_run ();
+}
@@ -0,0 +1,311 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <glib.h>
+#include <locale.h>
+
+#include "mm-sms-index.h"
+#include "mm-log-test.h"
+
+#define TEST_MAX_PENDING   4
+#define TEST_TIMEOUT_SECS 60
+
+/*****************************************************************************/
+
+static void
+test_parts (void)
+{
+    g_autoptr(MMSmsIndex) index = NULL;
+    gint owner1;
+    gint owner2;
+
+    index = mm_sms_index_new (TEST_MAX_PENDING, TEST_TIMEOUT_SECS);
+
+    mm_sms_index_add_part (index, MM_SMS_STORAGE_SM, 1, &owner1);
+    mm_sms_index_add_part (index, MM_SMS_STORAGE_SM, 2, &owner1);
+    mm_sms_index_add_part (index, MM_SMS_STORAGE_ME, 1, &owner2);
+    g_assert_cmpuint (mm_sms_index_get_n_parts (index), ==, 3);
+
+    g_assert (mm_sms_index_lookup_part (index, MM_SMS_STORAGE_SM, 1) == &owner1);
+    g_assert (mm_sms_index_lookup_part (index, MM_SMS_STORAGE_SM, 2) == &owner1);
+    g_assert (mm_sms_index_lookup_part (index, MM_SMS_STORAGE_ME, 1) == &owner2);
+    g_assert (mm_sms_index_lookup_part (index, MM_SMS_STORAGE_ME, 2) == NULL);
+    g_assert (mm_sms_index_lookup_part (index, MM_SMS_STORAGE_MT, 1) == NULL);
+
+    /* Removal of an entry not owned is ignored */
+    mm_sms_index_remove_part (index, MM_SMS_STORAGE_SM, 1, &owner2);
+    g_assert (mm_sms_index_lookup_part (index, MM_SMS_STORAGE_SM, 1) == &owner1);
+
+    mm_sms_index_remove_part (index, MM_SMS_STORAGE_SM, 1, &owner1);
+    g_assert (mm_sms_index_lookup_part (index, MM_SMS_STORAGE_SM, 1) == NULL);
+    g_assert_cmpuint (mm_sms_index_get_n_parts (index), ==, 2);
+}
+
+/*****************************************************************************/
+
+static void
+test_multipart_key (void)
+{
+    g_autoptr(MMSmsIndex) index = NULL;
+    gint owner;
+
+    index = mm_sms_index_new (TEST_MAX_PENDING, TEST_TIMEOUT_SECS);
+
+    g_assert (mm_sms_index_add_multipart (index, "+34600000001", 10, 3, &owner, 0) == NULL);
+    g_assert (mm_sms_index_lookup_multipart (index, "+34600000001", 10, 3, 0) == &owner);
+
+    /* Number, reference and number of parts must all match */
+    g_assert (mm_sms_index_lookup_multipart (index, "+34600000002", 10, 3, 0) == NULL);
+    g_assert (mm_sms_index_lookup_multipart (index, "+34600000001", 11, 3, 0) == NULL);
+    g_assert (mm_sms_index_lookup_multipart (index, "+34600000001", 10, 2, 0) == NULL);
+
+    mm_sms_index_remove_multipart (index, &owner);
+    g_assert (mm_sms_index_lookup_multipart (index, "+34600000001", 10, 3, 0) == NULL);
+    g_assert_cmpuint (mm_sms_index_get_n_pending (index), ==, 0);
+}
+
+static void
+test_multipart_expiry (void)
+{
+    g_autoptr(MMSmsIndex) index = NULL;
+    gint owner1;
+    gint owner2;
+    gint64 now = 0;
+
+    index = mm_sms_index_new (TEST_MAX_PENDING, TEST_TIMEOUT_SECS);
+
+    mm_sms_index_add_multipart (index, "+34600000001", 1, 2, &owner1, now);
+    now += (TEST_TIMEOUT_SECS / 2) * G_USEC_PER_SEC;
+    mm_sms_index_add_multipart (index, "+34600000001", 2, 2, &owner2, now);
+    g_assert_cmpuint (mm_sms_index_get_n_pending (index), ==, 2);
+
+    /* First one expires */
+    now += (TEST_TIMEOUT_SECS / 2) * G_USEC_PER_SEC;
+    g_assert (mm_sms_index_lookup_multipart (index, "+34600000001", 1, 2, now) == NULL);
+    g_assert (mm_sms_index_lookup_multipart (index, "+34600000001", 2, 2, now) == &owner2);
+    g_assert_cmpuint (mm_sms_index_get_n_pending (index), ==, 1);
+
+    /* Second one expires */
+    now += (TEST_TIMEOUT_SECS / 2) * G_USEC_PER_SEC;
+    g_assert (mm_sms_index_lookup_multipart (index, "+34600000001", 2, 2, now) == NULL);
+    g_assert_cmpuint (mm_sms_index_get_n_pending (index), ==, 0);
+}
+
+static void
+test_multipart_bounded (void)
+{
+    g_autoptr(MMSmsIndex) index = NULL;
+    gint owners[TEST_MAX_PENDING + 1];
+    guint i;
+
+    index = mm_sms_index_new (TEST_MAX_PENDING, TEST_TIMEOUT_SECS);
+
+    for (i = 0; i < TEST_MAX_PENDING; i++)
+        g_assert (mm_sms_index_add_multipart (index, "+34600000001", i, 2, &owners[i], 0) == NULL);
+    g_assert_cmpuint (mm_sms_index_get_n_pending (index), ==, TEST_MAX_PENDING);
+
+    /* Oldest one is evicted */
+    g_assert (mm_sms_index_add_multipart (index, "+34600000001", i, 2, &owners[i], 0) == &owners[0]);
+    g_assert_cmpuint (mm_sms_index_get_n_pending (index), ==, TEST_MAX_PENDING);
+    g_assert (mm_sms_index_lookup_multipart (index, "+34600000001", 0, 2, 0) == NULL);
+    for (i = 1; i <= TEST_MAX_PENDING; i++)
+        g_assert (mm_sms_index_lookup_multipart (index, "+34600000001", i, 2, 0) == &owners[i]);
+
+    /* A newer reassembly with the same key replaces the older one */
+    g_assert (mm_sms_index_add_multipart (index, "+34600000001", 1, 2, &owners[0], 0) == NULL);
+    g_assert (mm_sms_index_lookup_multipart (index, "+34600000001", 1, 2, 0) == &owners[0]);
+    g_assert_cmpuint (mm_sms_index_get_n_pending (index), ==, TEST_MAX_PENDING);
+}
+
+/*****************************************************************************/
+/* Load benchmark: thousands of stored parts of multipart messages, loaded in
+ * random order, the same way the SMS list does it on a bulk +CMGL load. */
+
+#define BENCHMARK_N_MESSAGES   2000
+#define BENCHMARK_MAX_PARTS       4
+#define BENCHMARK_N_NUMBERS      50
+#define BENCHMARK_MAX_PENDING  1024
+
+typedef struct {
+    gchar *number;
+    guint  reference;
+    guint  max_parts;
+    guint  n_parts;
+} BenchmarkMessage;
+
+typedef struct {
+    BenchmarkMessage *message;
+    guint             index;
+} BenchmarkPart;
+
+static guint
+benchmark_load_indexed (BenchmarkPart *parts,
+                        guint          n_parts)
+{
+    g_autoptr(MMSmsIndex) index = NULL;
+    guint i;
+    guint n_complete = 0;
+
+    index = mm_sms_index_new (BENCHMARK_MAX_PENDING, TEST_TIMEOUT_SECS);
+
+    for (i = 0; i < n_parts; i++) {
+        BenchmarkMessage *message;
+
+        g_assert (!mm_sms_index_lookup_part (index, MM_SMS_STORAGE_SM, parts[i].index));
+
+        message = mm_sms_index_lookup_multipart (index,
+                                                 parts[i].message->number,
+                                                 parts[i].message->reference,
+                                                 parts[i].message->max_parts,
+                                                 0);
+        if (!message) {
+            message = parts[i].message;
+            g_assert_cmpuint (message->n_parts, ==, 0);
+            mm_sms_index_add_multipart (index,
+                                        message->number,
+                                        message->reference,
+                                        message->max_parts,
+                                        message,
+                                        0);
+        }
+        g_assert (message == parts[i].message);
+
+        mm_sms_index_add_part (index, MM_SMS_STORAGE_SM, parts[i].index, message);
+        if (++message->n_parts == message->max_parts) {
+            mm_sms_index_remove_multipart (index, message);
+            n_complete++;
+        }
+    }
+
+    g_assert_cmpuint (mm_sms_index_get_n_parts (index), ==, n_parts);
+    g_assert_cmpuint (mm_sms_index_get_n_pending (index), ==, 0);
+    return n_complete;
+}
+
+/* Reference implementation, walking the list of messages and their parts */
+static guint
+benchmark_load_linear (BenchmarkPart *parts,
+                       guint          n_parts)
+{
+    GList *messages = NULL;
+    GList *stored = NULL;
+    guint  i;
+    guint  n_complete = 0;
+
+    for (i = 0; i < n_parts; i++) {
+        BenchmarkMessage *message = NULL;
+        GList            *l;
+
+        for (l = stored; l; l = g_list_next (l))
+            g_assert_cmpuint (((BenchmarkPart *)l->data)->index, !=, parts[i].index);
+
+        for (l = messages; l; l = g_list_next (l)) {
+            BenchmarkMessage *iter = l->data;
+
+            if (iter->reference == parts[i].message->reference &&
+                iter->max_parts == parts[i].message->max_parts &&
+                g_str_equal (iter->number, parts[i].message->number)) {
+                message = iter;
+                break;
+            }
+        }
+        if (!message) {
+            message = parts[i].message;
+            messages = g_list_prepend (messages, message);
+        }
+
+        stored = g_list_prepend (stored, &parts[i]);
+        if (++message->n_parts == message->max_parts)
+            n_complete++;
+    }
+
+    g_list_free (messages);
+    g_list_free (stored);
+    return n_complete;
+}
+
+static void
+test_load_benchmark (void)
+{
+    BenchmarkMessage *messages;
+    BenchmarkPart    *parts;
+    guint             n_parts = 0;
+    guint             i;
+    guint             j;
+    gdouble           elapsed;
+
+    messages = g_new0 (BenchmarkMessage, BENCHMARK_N_MESSAGES);
+    parts = g_new0 (BenchmarkPart, BENCHMARK_N_MESSAGES * BENCHMARK_MAX_PARTS);
+
+    for (i = 0; i < BENCHMARK_N_MESSAGES; i++) {
+        messages[i].number = g_strdup_printf ("+34600%06u", i % BENCHMARK_N_NUMBERS);
+        messages[i].reference = i;
+        messages[i].max_parts = g_test_rand_int_range (2, BENCHMARK_MAX_PARTS + 1);
+        for (j = 0; j < messages[i].max_parts; j++) {
+            parts[n_parts].message = &messages[i];
+            parts[n_parts].index = n_parts;
+            n_parts++;
+        }
+    }
+
+    /* Random arrival order */
+    for (i = n_parts - 1; i > 0; i--) {
+        BenchmarkPart tmp;
+
+        j = g_test_rand_int_range (0, i + 1);
+        tmp = parts[i];
+        parts[i] = parts[j];
+        parts[j] = tmp;
+    }
+
+    g_test_timer_start ();
+    g_assert_cmpuint (benchmark_load_indexed (parts, n_parts), ==, BENCHMARK_N_MESSAGES);
+    elapsed = g_test_timer_elapsed ();
+    g_test_minimized_result (elapsed, "indexed load of %u parts: %.3lfs", n_parts, elapsed);
+
+    /* The reference implementation is quadratic, only run it when
+     * explicitly requested */
+    if (g_test_perf ()) {
+        for (i = 0; i < BENCHMARK_N_MESSAGES; i++)
+            messages[i].n_parts = 0;
+
+        g_test_timer_start ();
+        g_assert_cmpuint (benchmark_load_linear (parts, n_parts), ==, BENCHMARK_N_MESSAGES);
+        elapsed = g_test_timer_elapsed ();
+        g_test_minimized_result (elapsed, "linear load of %u parts: %.3lfs", n_parts, elapsed);
+    }
+
+    for (i = 0; i < BENCHMARK_N_MESSAGES; i++)
+        g_free (messages[i].number);
+    g_free (messages);
+    g_free (parts);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/sms-index/parts",              test_parts);
+    g_test_add_func ("/MM/sms-index/multipart-key",      test_multipart_key);
+    g_test_add_func ("/MM/sms-index/multipart-expiry",   test_multipart_expiry);
+    g_test_add_func ("/MM/sms-index/multipart-bounded",  test_multipart_bounded);
+    g_test_add_func ("/MM/sms-index/load-benchmark",     test_load_benchmark);
+
+    return g_test_run ();
+}
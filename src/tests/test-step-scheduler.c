@@ -0,0 +1,237 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <glib.h>
+#include <locale.h>
+#include <string.h>
+
+#include "mm-step-scheduler.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+
+typedef struct {
+    MMStepScheduler *scheduler;
+    GMainLoop       *loop;
+    GString         *started;
+    GString         *finished;
+    gboolean         sync;
+    gboolean         abort_after_first;
+    gboolean         done;
+} TestContext;
+
+typedef struct {
+    TestContext *ctx;
+    guint        step_id;
+} StepData;
+
+static const gchar *step_names = "ABCDEF";
+
+static gboolean
+step_finish_cb (StepData *data)
+{
+    TestContext *ctx;
+    guint        step_id;
+
+    ctx = data->ctx;
+    step_id = data->step_id;
+    g_free (data);
+
+    g_string_append_c (ctx->finished, step_names[step_id]);
+    if (ctx->abort_after_first)
+        mm_step_scheduler_abort (ctx->scheduler);
+    mm_step_scheduler_step_done (ctx->scheduler, step_id);
+    return G_SOURCE_REMOVE;
+}
+
+static void
+step_func (MMStepScheduler *scheduler,
+           guint            step_id,
+           TestContext     *ctx)
+{
+    StepData *data;
+
+    g_string_append_c (ctx->started, step_names[step_id]);
+
+    if (ctx->sync) {
+        g_string_append_c (ctx->finished, step_names[step_id]);
+        mm_step_scheduler_step_done (scheduler, step_id);
+        return;
+    }
+
+    /* Complete asynchronously, with decreasing delays, so that steps started
+     * later may finish earlier */
+    data = g_new0 (StepData, 1);
+    data->ctx = ctx;
+    data->step_id = step_id;
+    g_timeout_add (10 * (strlen (step_names) - step_id), (GSourceFunc)step_finish_cb, data);
+}
+
+static void
+scheduler_done (MMStepScheduler *scheduler,
+                TestContext     *ctx)
+{
+    g_assert (!ctx->done);
+    ctx->done = TRUE;
+    if (ctx->loop)
+        g_main_loop_quit (ctx->loop);
+}
+
+static TestContext *
+test_context_new (guint max_in_flight)
+{
+    TestContext *ctx;
+    guint        i;
+
+    ctx = g_new0 (TestContext, 1);
+    ctx->scheduler = mm_step_scheduler_new (NULL, "test", max_in_flight);
+    ctx->started = g_string_new (NULL);
+    ctx->finished = g_string_new (NULL);
+    for (i = 0; i < strlen (step_names); i++) {
+        gchar name[2] = { step_names[i], '\0' };
+
+        mm_step_scheduler_add_step (ctx->scheduler, i, name, (MMStepSchedulerStepFunc)step_func, ctx);
+    }
+    return ctx;
+}
+
+static void
+test_context_run (TestContext *ctx)
+{
+    mm_step_scheduler_run (ctx->scheduler, (MMStepSchedulerDoneFunc)scheduler_done, ctx);
+    if (!ctx->done) {
+        ctx->loop = g_main_loop_new (NULL, FALSE);
+        g_main_loop_run (ctx->loop);
+        g_main_loop_unref (ctx->loop);
+    }
+    g_assert (ctx->done);
+}
+
+static void
+test_context_free (TestContext *ctx)
+{
+    mm_step_scheduler_free (ctx->scheduler);
+    g_string_free (ctx->started, TRUE);
+    g_string_free (ctx->finished, TRUE);
+    g_free (ctx);
+}
+
+/*****************************************************************************/
+
+static void
+test_sequential (void)
+{
+    TestContext *ctx;
+
+    ctx = test_context_new (1);
+    test_context_run (ctx);
+    g_assert_cmpstr (ctx->started->str, ==, "ABCDEF");
+    g_assert_cmpstr (ctx->finished->str, ==, "ABCDEF");
+    g_assert_cmpuint (mm_step_scheduler_get_max_reached_in_flight (ctx->scheduler), ==, 1);
+    test_context_free (ctx);
+}
+
+static void
+test_sync (void)
+{
+    TestContext *ctx;
+
+    ctx = test_context_new (3);
+    ctx->sync = TRUE;
+    test_context_run (ctx);
+    g_assert_cmpstr (ctx->started->str, ==, "ABCDEF");
+    g_assert_cmpstr (ctx->finished->str, ==, "ABCDEF");
+    test_context_free (ctx);
+}
+
+static void
+test_concurrent (void)
+{
+    TestContext *ctx;
+
+    ctx = test_context_new (6);
+    test_context_run (ctx);
+    g_assert_cmpstr (ctx->started->str, ==, "ABCDEF");
+    /* Later steps finish earlier */
+    g_assert_cmpstr (ctx->finished->str, ==, "FEDCBA");
+    g_assert_cmpuint (mm_step_scheduler_get_max_reached_in_flight (ctx->scheduler), ==, 6);
+    test_context_free (ctx);
+}
+
+static void
+test_concurrent_limit (void)
+{
+    TestContext *ctx;
+
+    ctx = test_context_new (2);
+    test_context_run (ctx);
+    g_assert_cmpuint (ctx->started->len, ==, 6);
+    g_assert_cmpuint (ctx->finished->len, ==, 6);
+    g_assert_cmpuint (mm_step_scheduler_get_max_reached_in_flight (ctx->scheduler), ==, 2);
+    test_context_free (ctx);
+}
+
+static void
+test_dependencies (void)
+{
+    TestContext *ctx;
+
+    ctx = test_context_new (6);
+    /* C after A, E after C and D, F after E */
+    mm_step_scheduler_add_dependency (ctx->scheduler, 2, 0);
+    mm_step_scheduler_add_dependency (ctx->scheduler, 4, 2);
+    mm_step_scheduler_add_dependency (ctx->scheduler, 4, 3);
+    mm_step_scheduler_add_dependency (ctx->scheduler, 5, 4);
+    test_context_run (ctx);
+
+    /* A, B and D start right away; D finishes first, then B, then A, which
+     * lets C start, then E and then F */
+    g_assert_cmpstr (ctx->started->str, ==, "ABDCEF");
+    g_assert_cmpstr (ctx->finished->str, ==, "DBACEF");
+    test_context_free (ctx);
+}
+
+static void
+test_abort (void)
+{
+    TestContext *ctx;
+
+    ctx = test_context_new (2);
+    ctx->abort_after_first = TRUE;
+    test_context_run (ctx);
+
+    /* A and B started, B finished first, no more started after the abort */
+    g_assert_cmpstr (ctx->started->str, ==, "AB");
+    g_assert_cmpstr (ctx->finished->str, ==, "BA");
+    test_context_free (ctx);
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/step-scheduler/sequential",       test_sequential);
+    g_test_add_func ("/MM/step-scheduler/sync",             test_sync);
+    g_test_add_func ("/MM/step-scheduler/concurrent",       test_concurrent);
+    g_test_add_func ("/MM/step-scheduler/concurrent-limit", test_concurrent_limit);
+    g_test_add_func ("/MM/step-scheduler/dependencies",     test_dependencies);
+    g_test_add_func ("/MM/step-scheduler/abort",            test_abort);
+
+    return g_test_run ();
+}
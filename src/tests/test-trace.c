@@ -0,0 +1,156 @@
+/* -*- Mode: C; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details:
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ */
+
+#include <glib.h>
+#include <locale.h>
+#include <string.h>
+
+#include "mm-trace.h"
+#include "mm-log-test.h"
+
+/*****************************************************************************/
+
+static guint
+count_substrings (const gchar *str,
+                  const gchar *substr)
+{
+    const gchar *p;
+    guint        n = 0;
+
+    for (p = strstr (str, substr); p; p = strstr (p + 1, substr))
+        n++;
+    return n;
+}
+
+static gchar *
+build_json (void)
+{
+    gchar *json;
+
+    json = mm_trace_build_json ();
+    g_assert (g_str_has_prefix (json, "{\"traceEvents\":["));
+    g_assert (g_str_has_suffix (json, "]}\n"));
+    return json;
+}
+
+/*****************************************************************************/
+
+static void
+test_disabled (void)
+{
+    g_autofree gchar *json = NULL;
+
+    mm_trace_setup (FALSE);
+    mm_trace_begin (NULL, "phase", NULL);
+    mm_trace_end (NULL, "phase", NULL);
+
+    json = build_json ();
+    g_assert_cmpuint (count_substrings (json, "\"ph\":"), ==, 0);
+}
+
+static void
+test_spans (void)
+{
+    g_autofree gchar *json = NULL;
+
+    mm_trace_setup (TRUE);
+    mm_trace_begin (NULL, "phase", NULL);
+    mm_trace_begin (NULL, "phase", "explicit");
+    mm_trace_end (NULL, "phase", "explicit");
+    mm_trace_end (NULL, "phase", NULL);
+
+    json = build_json ();
+    g_assert_cmpuint (count_substrings (json, "\"ph\":\"M\""), ==, 1);
+    g_assert_cmpuint (count_substrings (json, "\"ph\":\"b\""), ==, 2);
+    g_assert_cmpuint (count_substrings (json, "\"ph\":\"e\""), ==, 2);
+    g_assert_cmpuint (count_substrings (json, "\"name\":\"explicit\",\"cat\":\"phase\""), ==, 2);
+    mm_trace_shutdown ();
+}
+
+static void
+test_steps (void)
+{
+    g_autofree gchar *json = NULL;
+
+    mm_trace_setup (TRUE);
+    mm_trace_begin (NULL, "phase", NULL);
+    mm_trace_step (NULL, "phase", "one");
+    /* Same step again is a no-op */
+    mm_trace_step (NULL, "phase", "one");
+    mm_trace_step (NULL, "phase", "two");
+    /* Ending the phase ends the last step */
+    mm_trace_end (NULL, "phase", NULL);
+
+    json = build_json ();
+    g_assert_cmpuint (count_substrings (json, "\"name\":\"one\""), ==, 2);
+    g_assert_cmpuint (count_substrings (json, "\"name\":\"two\""), ==, 2);
+    g_assert_cmpuint (count_substrings (json, "\"ph\":\"b\""), ==, 3);
+    g_assert_cmpuint (count_substrings (json, "\"ph\":\"e\""), ==, 3);
+    /* Last step ends before its phase */
+    g_assert (strstr (json, "\"name\":\"two\",\"cat\":\"phase\",\"ph\":\"e\"") <
+              strstr (json, "\"name\":\"phase\",\"cat\":\"phase\",\"ph\":\"e\""));
+    mm_trace_shutdown ();
+}
+
+static void
+test_wrap (void)
+{
+    g_autofree gchar *json = NULL;
+    guint             i;
+
+    mm_trace_setup (TRUE);
+    mm_trace_begin (NULL, "first", NULL);
+    for (i = 0; i < 5000; i++) {
+        mm_trace_begin (NULL, "phase", NULL);
+        mm_trace_end (NULL, "phase", NULL);
+    }
+
+    /* Oldest events dropped */
+    json = build_json ();
+    g_assert (!strstr (json, "\"first\""));
+    g_assert_cmpuint (count_substrings (json, "\"ph\":\"b\"") + count_substrings (json, "\"ph\":\"e\""), ==, 4096);
+    mm_trace_shutdown ();
+}
+
+static void
+test_escape (void)
+{
+    g_autofree gchar *json = NULL;
+
+    mm_trace_setup (TRUE);
+    mm_trace_begin (NULL, "phase", "a \"quoted\\\" \n step");
+    mm_trace_end (NULL, "phase", "a \"quoted\\\" \n step");
+
+    json = build_json ();
+    g_assert_cmpuint (count_substrings (json, "\"name\":\"a \\\"quoted\\\\\\\" \\u000a step\""), ==, 2);
+    mm_trace_shutdown ();
+}
+
+/*****************************************************************************/
+
+int main (int argc, char **argv)
+{
+    setlocale (LC_ALL, "");
+
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/MM/trace/disabled", test_disabled);
+    g_test_add_func ("/MM/trace/spans",    test_spans);
+    g_test_add_func ("/MM/trace/steps",    test_steps);
+    g_test_add_func ("/MM/trace/wrap",     test_wrap);
+    g_test_add_func ("/MM/trace/escape",   test_escape);
+
+    return g_test_run ();
+}